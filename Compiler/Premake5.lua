@@ -13,8 +13,19 @@ project "CompilerCore"
 		"%{SourceDir.Compiler}" .. "/**.h",
 
 		"%{IncludeDir.Compiler}" .. "/**.h",
+
+		"%{SourceDir.Compiler}" .. "/**.lexdesc",
 	}
 
 	includedirs {
 		"%{IncludeDir.Compiler}",
 	}
+
+	-- Generated lexers are checked in so the file list above is complete on a
+	-- fresh checkout, the prebuild step regenerates them from their descriptions
+	dependson { "LexerGen" }
+
+	prebuildcommands
+	{
+		'"%{wks.location}/bin/' .. outputdir .. '/LexerGen/LexerGen" "%{SourceDir.Compiler}/parser/lexer/lang/LexerCLanguage.lexdesc" "%{SourceDir.Compiler}/parser/lexer/lang/LexerCLanguageGenerated.c"',
+	}
@@ -0,0 +1,756 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef IR_H
+#define IR_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserCore.h"
+#include "parser/Results.h"
+
+#include <stdbool.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(IRModule)
+PARSER_CORE_DEFINE_HANDLE(IRFunction)
+
+/**
+ * @brief Index of an instruction in its function, IR_VALUE_NONE for no value
+ *
+ * @description Every instruction is a value, those without a result have
+ *              type IR_TYPE_VOID.
+ */
+typedef uint32_t IRValueId;
+
+/**
+ * @brief Index of a basic block in its function, IR_BLOCK_NONE for no block
+ */
+typedef uint32_t IRBlockId;
+
+/**
+ * @brief Index of a function or data object in its module
+ */
+typedef uint32_t IRGlobalId;
+
+#define IR_VALUE_NONE                   0u
+#define IR_BLOCK_NONE                   0u
+#define IR_GLOBAL_NONE                  0u
+#define IR_BLOCK_ENTRY                  1u      // Created with the function, has no predecessors
+
+#define IR_PAGE_INSTRUCTIONS            1024u   // Instruction records per arena page
+#define IR_POINTER_SIZE                 8u
+
+typedef enum IRType {
+    IR_TYPE_VOID = 0,
+    IR_TYPE_I1,                         // Comparison results
+    IR_TYPE_I8,
+    IR_TYPE_I16,
+    IR_TYPE_I32,
+    IR_TYPE_I64,
+    IR_TYPE_PTR,
+    IR_TYPE_F32,
+    IR_TYPE_F64,
+
+    IR_TYPE_COUNT
+} IRType;
+
+/*
+ * Integer opcodes carry the signedness, values do not. Operands are listed
+ * in the order of IRInstruction.operands.
+ */
+typedef enum IROpcode {
+    IR_OP_NOP = 0,                      // Removed instruction
+
+    // ===== Values =====
+    IR_OP_CONST,                        // low bits, high bits; in no block
+    IR_OP_UNDEF,                        // in no block
+    IR_OP_PARAM,                        // index
+    IR_OP_GLOBAL,                       // IRGlobalId, the address of a function or data object
+    IR_OP_PHI,                          // list: one value per predecessor, in predecessor order
+
+    // ===== Arithmetic =====
+    IR_OP_ADD,
+    IR_OP_SUB,
+    IR_OP_MUL,
+    IR_OP_SMULH,                        // High half of the double width product
+    IR_OP_UMULH,
+    IR_OP_SDIV,
+    IR_OP_UDIV,
+    IR_OP_SREM,
+    IR_OP_UREM,
+    IR_OP_AND,
+    IR_OP_OR,
+    IR_OP_XOR,
+    IR_OP_SHL,
+    IR_OP_LSHR,
+    IR_OP_ASHR,
+    IR_OP_NEG,
+    IR_OP_NOT,
+    IR_OP_FADD,
+    IR_OP_FSUB,
+    IR_OP_FMUL,
+    IR_OP_FDIV,
+    IR_OP_FNEG,
+
+    // ===== Comparison, IR_TYPE_I1 results =====
+    IR_OP_EQ,
+    IR_OP_NE,
+    IR_OP_SLT,
+    IR_OP_SLE,
+    IR_OP_SGT,
+    IR_OP_SGE,
+    IR_OP_ULT,
+    IR_OP_ULE,
+    IR_OP_UGT,
+    IR_OP_UGE,
+    IR_OP_FEQ,
+    IR_OP_FNE,
+    IR_OP_FLT,
+    IR_OP_FLE,
+    IR_OP_FGT,
+    IR_OP_FGE,
+
+    // ===== Conversion =====
+    IR_OP_SEXT,
+    IR_OP_ZEXT,
+    IR_OP_TRUNC,
+    IR_OP_FPEXT,
+    IR_OP_FPTRUNC,
+    IR_OP_SITOFP,
+    IR_OP_UITOFP,
+    IR_OP_FPTOSI,
+    IR_OP_FPTOUI,
+    IR_OP_PTRTOINT,
+    IR_OP_INTTOPTR,
+    IR_OP_SELECT,                       // condition, true value, false value
+
+    // ===== Memory =====
+    IR_OP_ALLOCA,                       // size, alignment; stack slot of the function
+    IR_OP_LOAD,                         // address
+    IR_OP_STORE,                        // address, value
+    IR_OP_PTRADD,                       // base, byte offset (IR_TYPE_I64)
+    IR_OP_MEMCOPY,                      // destination, source, size
+    IR_OP_MEMZERO,                      // destination, size
+    IR_OP_CALL,                         // callee, list: arguments
+
+    // ===== Terminators =====
+    IR_OP_BR,                           // target block
+    IR_OP_CONDBR,                       // condition, true block, false block
+    IR_OP_SWITCH,                       // value, default block, list: (low bits, high bits, block) per case
+    IR_OP_RET,                          // value, IR_VALUE_NONE in a void function
+    IR_OP_UNREACHABLE,
+
+    IR_OP_COUNT
+} IROpcode;
+
+typedef enum IROperandKind {
+    IR_OPERAND_NONE = 0,
+    IR_OPERAND_VALUE,                   // IRValueId, may be IR_VALUE_NONE
+    IR_OPERAND_BLOCK,                   // IRBlockId
+    IR_OPERAND_IMMEDIATE,               // Plain number
+    IR_OPERAND_LIST,                    // List handle, see IRFunction_GetList
+} IROperandKind;
+
+typedef enum IROpcodeFlags {
+    IR_OPCODE_FLAG_NONE         = 0,
+    IR_OPCODE_FLAG_TERMINATOR   = 1 << 0,   // Last instruction of a block
+    IR_OPCODE_FLAG_SIDE_EFFECTS = 1 << 1,   // Kept without uses
+    IR_OPCODE_FLAG_COMMUTATIVE  = 1 << 2,
+    IR_OPCODE_FLAG_COMPARE      = 1 << 3,
+    IR_OPCODE_FLAG_LIST_CASES   = 1 << 4,   // List items are case triples, not values
+} IROpcodeFlags;
+
+/**
+ * @brief Static description of an opcode
+ */
+typedef struct IROpcodeInfo_T {
+    const char* name;
+    uint8_t operands[3];                // IROperandKind of each operand
+    uint8_t flags;                      // IROpcodeFlags
+} IROpcodeInfo;
+
+typedef enum IRInstructionFlags {
+    IR_INSTRUCTION_FLAG_NONE        = 0,
+    IR_INSTRUCTION_FLAG_VOLATILE    = 1 << 0,   // Load or store that is never merged or removed
+    IR_INSTRUCTION_FLAG_NOALIAS     = 1 << 1,   // Parameter from a restrict pointer
+    IR_INSTRUCTION_FLAG_JUMP_TABLE  = 1 << 2,   // Switch on an index known to be in range, cases 0 to n - 1 in order
+} IRInstructionFlags;
+
+/**
+ * @brief Instruction record, fixed size
+ *
+ * @description Records live in pages of the function arena and never
+ *              move. Instructions of a block are linked in order, values
+ *              in no block (constants, removed instructions) are not.
+ */
+typedef struct IRInstruction_T {
+    uint8_t opcode;                     // IROpcode
+    uint8_t type;                       // IRType of the result
+    uint16_t flags;                     // IRInstructionFlags
+    IRBlockId block;                    // IR_BLOCK_NONE for constants and removed instructions
+    IRValueId prev;                     // Order in the block
+    IRValueId next;
+    uint32_t operands[3];               // By IROpcodeInfo.operands
+    uint32_t uses;                      // Use list handle
+} IRInstruction;
+
+#define IR_CONST_BITS(instruction)      (((uint64_t)(instruction)->operands[1] << 32) | (instruction)->operands[0])
+
+/**
+ * @brief Operand slot of a use: 0 to 2 for operands, IR_USE_LIST_SLOT + i for list item i
+ */
+#define IR_USE_LIST_SLOT                3u
+
+typedef struct IRUse_T {
+    IRValueId user;
+    uint32_t slot;
+} IRUse;
+
+typedef enum IRBlockFlags {
+    IR_BLOCK_FLAG_NONE      = 0,
+    IR_BLOCK_FLAG_REMOVED   = 1 << 0,
+} IRBlockFlags;
+
+typedef struct IRBlock_T {
+    IRValueId first;                    // IR_VALUE_NONE while empty
+    IRValueId last;
+    uint32_t preds;                     // Predecessor list handle
+    uint32_t flags;                     // IRBlockFlags
+} IRBlock;
+
+typedef enum IRGlobalKind {
+    IR_GLOBAL_KIND_FUNCTION = 0,
+    IR_GLOBAL_KIND_DATA,
+} IRGlobalKind;
+
+typedef enum IRGlobalFlags {
+    IR_GLOBAL_FLAG_NONE     = 0,
+    IR_GLOBAL_FLAG_DEFINED  = 1 << 0,   // Function with a body, data with storage here
+    IR_GLOBAL_FLAG_INTERNAL = 1 << 1,   // Not visible outside the module
+    IR_GLOBAL_FLAG_CONSTANT = 1 << 2,   // Read-only data
+    IR_GLOBAL_FLAG_INLINE   = 1 << 3,   // Function declared inline, a hint to the inliner
+} IRGlobalFlags;
+
+/**
+ * @brief Function or data object of a module
+ */
+typedef struct IRGlobalInfo_T {
+    const char* name;                   // NULL for anonymous data
+    uint32_t length;
+    uint8_t kind;                       // IRGlobalKind
+    uint8_t flags;                      // IRGlobalFlags
+    uint16_t alignment;                 // Data only
+    uint32_t size;                      // Data only
+    const uint8_t* data;                // Initializer of data, NULL for zeroes
+    IRFunction function;                // Definition of a function, NULL until created
+} IRGlobalInfo;
+
+/**
+ * @brief Get the description of an opcode
+ */
+PARSER_ATTR const IROpcodeInfo* PARSER_CALL IROpcode_GetInfo(
+    IROpcode opcode);
+
+/**
+ * @brief Get the size of a type in bytes, 0 for IR_TYPE_VOID
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRType_GetSize(
+    IRType type);
+
+// ===== MODULE =====
+
+/**
+ * @brief Create a module
+ *
+ * @description A module owns its functions and the names and initializers
+ *              of its globals. Every function has an arena of its own, so
+ *              one can be dropped without touching the others.
+ *
+ * @param module[out] Pointer to the module handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `module` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the module
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateIRModule(
+    IRModule* module);
+
+PARSER_ATTR void PARSER_CALL IRModuleDestroy(
+    IRModule module);
+
+/**
+ * @brief Find a global by name
+ *
+ * @return IR_GLOBAL_NONE when the name is not declared
+ */
+PARSER_ATTR IRGlobalId PARSER_CALL IRModule_FindGlobal(
+    const IRModule module,
+    const char* name,
+    uint32_t length);
+
+/**
+ * @brief Find a global by name, declaring it when there is none
+ *
+ * @param module[in] Module handle
+ * @param name[in] Name, not NUL terminated
+ * @param length[in] Length of the name
+ * @param kind[in] IRGlobalKind of a new global
+ * @param id[out] Global id
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : The name is declared with another kind
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the module
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRModule_DeclareGlobal(
+    IRModule module,
+    const char* name,
+    uint32_t length,
+    IRGlobalKind kind,
+    IRGlobalId* id);
+
+/**
+ * @brief Define a data object
+ *
+ * @param module[in] Module handle
+ * @param global[in] Declared data global, IR_GLOBAL_NONE for a new anonymous one
+ * @param data[in] Initializer, copied, NULL for zeroes
+ * @param size[in] Size in bytes
+ * @param alignment[in] Alignment in bytes
+ * @param flags[in] IRGlobalFlags besides IR_GLOBAL_FLAG_DEFINED
+ * @param id[out] Global id
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `global` is a function or already defined
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the module
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRModule_DefineData(
+    IRModule module,
+    IRGlobalId global,
+    const void* data,
+    uint32_t size,
+    uint32_t alignment,
+    uint32_t flags,
+    IRGlobalId* id);
+
+/**
+ * @brief Set IRGlobalFlags of a global, e.g. IR_GLOBAL_FLAG_INTERNAL
+ */
+PARSER_ATTR void PARSER_CALL IRModule_SetGlobalFlags(
+    IRModule module,
+    IRGlobalId global,
+    uint32_t flags);
+
+/**
+ * @brief Get a global record, NULL for unknown ids
+ */
+PARSER_ATTR const IRGlobalInfo* PARSER_CALL IRModule_GetGlobal(
+    const IRModule module,
+    IRGlobalId global);
+
+/**
+ * @brief Get the number of globals, ids run from 1 to the count
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRModule_GetGlobalCount(
+    const IRModule module);
+
+/**
+ * @brief Create the definition of a function
+ *
+ * @description The function starts with an empty entry block,
+ *              IR_BLOCK_ENTRY.
+ *
+ * @param module[in] Module handle
+ * @param global[in] Function global without a definition
+ * @param returnType[in] IRType of the result
+ * @param params[in] IRType of every parameter
+ * @param paramCount[in] Number of parameters
+ * @param function[out] Function handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `global` is not a function, or is defined
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRModule_CreateFunction(
+    IRModule module,
+    IRGlobalId global,
+    IRType returnType,
+    const uint8_t* params,
+    uint32_t paramCount,
+    IRFunction* function);
+
+/**
+ * @brief Destroy a function definition, its global is declared again
+ */
+PARSER_ATTR void PARSER_CALL IRModule_RemoveFunction(
+    IRModule module,
+    IRFunction function);
+
+/**
+ * @brief Get the function definitions in the order they were created
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRModule_GetFunctionCount(
+    const IRModule module);
+
+PARSER_ATTR IRFunction PARSER_CALL IRModule_GetFunction(
+    const IRModule module,
+    uint32_t index);
+
+// ===== FUNCTION =====
+
+PARSER_ATTR IRModule PARSER_CALL IRFunction_GetModule(
+    const IRFunction function);
+
+PARSER_ATTR IRGlobalId PARSER_CALL IRFunction_GetGlobal(
+    const IRFunction function);
+
+PARSER_ATTR IRType PARSER_CALL IRFunction_GetReturnType(
+    const IRFunction function);
+
+PARSER_ATTR uint32_t PARSER_CALL IRFunction_GetParamCount(
+    const IRFunction function);
+
+PARSER_ATTR IRType PARSER_CALL IRFunction_GetParamType(
+    const IRFunction function,
+    uint32_t index);
+
+/**
+ * @brief Add an empty block
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the block table
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AddBlock(
+    IRFunction function,
+    IRBlockId* block);
+
+/**
+ * @brief Append an instruction to a block
+ *
+ * @description Operands are given in the order of IROpcodeInfo.operands,
+ *              unused ones are 0. Value operands gain a use. A terminator
+ *              adds its block to the predecessors of its targets.
+ *
+ * @param function[in] Function handle
+ * @param block[in] Block to append to
+ * @param opcode[in] IROpcode without a list
+ * @param type[in] IRType of the result
+ * @param a[in] First operand
+ * @param b[in] Second operand
+ * @param c[in] Third operand
+ * @param id[out] New value, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : Unknown block, or the block already ends in a terminator
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AddInstruction(
+    IRFunction function,
+    IRBlockId block,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    uint32_t c,
+    IRValueId* id);
+
+/**
+ * @brief Append an instruction with a list: PHI, CALL or SWITCH
+ *
+ * @description `a` and `b` fill the operands before the list slot.
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AddListInstruction(
+    IRFunction function,
+    IRBlockId block,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    const uint32_t* items,
+    uint32_t count,
+    IRValueId* id);
+
+/**
+ * @brief Insert an instruction without a list before another one
+ *
+ * @description For transforms, the block gains no edges: terminators
+ *              are appended with IRFunction_AddInstruction.
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_InsertInstruction(
+    IRFunction function,
+    IRValueId before,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    uint32_t c,
+    IRValueId* id);
+
+/**
+ * @brief Add a phi without operands after the phis of a block
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AddPhi(
+    IRFunction function,
+    IRBlockId block,
+    IRType type,
+    IRValueId* id);
+
+/**
+ * @brief Append a value to the list of an instruction
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AppendOperand(
+    IRFunction function,
+    IRValueId id,
+    uint32_t item);
+
+/**
+ * @brief Replace an operand, keeping the use lists
+ *
+ * @param slot[in] 0 to 2, or IR_USE_LIST_SLOT + list index
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_SetOperand(
+    IRFunction function,
+    IRValueId id,
+    uint32_t slot,
+    uint32_t operand);
+
+/**
+ * @brief Set IRInstructionFlags of an instruction, e.g. IR_INSTRUCTION_FLAG_VOLATILE
+ */
+PARSER_ATTR void PARSER_CALL IRFunction_SetInstructionFlags(
+    IRFunction function,
+    IRValueId id,
+    uint32_t flags);
+
+/**
+ * @brief Get the constant of a type with the given bits, shared by all uses
+ *
+ * @description Bits above the width of the type are ignored.
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_GetConstant(
+    IRFunction function,
+    IRType type,
+    uint64_t bits,
+    IRValueId* id);
+
+/**
+ * @brief Get the undefined value of a type, shared by all uses
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_GetUndef(
+    IRFunction function,
+    IRType type,
+    IRValueId* id);
+
+/**
+ * @brief Point every use of a value at another value
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_ReplaceAllUses(
+    IRFunction function,
+    IRValueId from,
+    IRValueId to);
+
+/**
+ * @brief Unlink an instruction and drop the uses it makes
+ *
+ * @description The record stays as IR_OP_NOP. A terminator also leaves
+ *              the predecessors of its targets, with the phi operands
+ *              for that edge.
+ */
+PARSER_ATTR void PARSER_CALL IRFunction_RemoveInstruction(
+    IRFunction function,
+    IRValueId id);
+
+/**
+ * @brief Turn the terminator of a block into a branch to one of its targets
+ *
+ * @description The edges into the other targets leave their predecessors
+ *              with the phi operands they feed. One edge into `target`
+ *              keeps its place and its phi operands.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : The block does not end in a terminator that targets `target`
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_FoldBranch(
+    IRFunction function,
+    IRBlockId block,
+    IRBlockId target);
+
+/**
+ * @brief Append a block to its only predecessor, when that ends in a branch to it
+ *
+ * @description The phis of the block are replaced by their operand and the
+ *              branch is dropped. The block is left empty, without edges,
+ *              and flagged IR_BLOCK_FLAG_REMOVED.
+ *
+ * @return false when the block has another shape, or undefined values could not be added;
+ *         the IR is valid either way
+ */
+PARSER_ATTR bool PARSER_CALL IRFunction_MergeBlock(
+    IRFunction function,
+    IRBlockId block);
+
+/**
+ * @brief Move the instructions after one into a new block
+ *
+ * @description The new block takes the terminator, and with it the edges
+ *              out of the block: the successors see it in place of the
+ *              block. The block is left without a terminator, for the
+ *              caller to append one.
+ *
+ * @param function[in] Function handle
+ * @param after[in] Instruction in a block, the last one to stay
+ * @param block[out] New block
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `after` is in no block, is a terminator, or is followed by a phi
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the block table
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_SplitBlock(
+    IRFunction function,
+    IRValueId after,
+    IRBlockId* block);
+
+/**
+ * @brief Move the edges from some predecessors of a block onto a new block that branches to it
+ *
+ * @description Every edge from the given predecessors into the block is
+ *              retargeted to the new block, which ends in a branch to the
+ *              block and comes last among its predecessors. A phi of the
+ *              block takes the operand of one moved edge as the operand of
+ *              the new edge, or a new phi in the new block of the operands
+ *              of all of them. Used to give a loop a preheader.
+ *
+ * @param function[in] Function handle
+ * @param block[in] Block the edges go into
+ * @param preds[in] Predecessors of the block whose edges move, in any order
+ * @param count[in] Number of predecessors
+ * @param newBlock[out] New block
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `preds` is empty, or has a block that is not a predecessor
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_SplitPredecessors(
+    IRFunction function,
+    IRBlockId block,
+    const IRBlockId* preds,
+    uint32_t count,
+    IRBlockId* newBlock);
+
+/**
+ * @brief Get an instruction record, NULL for unknown ids
+ */
+PARSER_ATTR const IRInstruction* PARSER_CALL IRFunction_GetInstruction(
+    const IRFunction function,
+    IRValueId id);
+
+/**
+ * @brief Get the number of instruction records, ids run from 1 to count - 1
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRFunction_GetInstructionCount(
+    const IRFunction function);
+
+/**
+ * @brief Get the items of the list of an instruction
+ *
+ * @return Items, NULL with `count` 0 for an instruction without a list
+ */
+PARSER_ATTR const uint32_t* PARSER_CALL IRFunction_GetList(
+    const IRFunction function,
+    IRValueId id,
+    uint32_t* count);
+
+/**
+ * @brief Get the uses of a value
+ */
+PARSER_ATTR const IRUse* PARSER_CALL IRFunction_GetUses(
+    const IRFunction function,
+    IRValueId id,
+    uint32_t* count);
+
+/**
+ * @brief Get a block record, NULL for unknown ids
+ */
+PARSER_ATTR const IRBlock* PARSER_CALL IRFunction_GetBlock(
+    const IRFunction function,
+    IRBlockId block);
+
+/**
+ * @brief Get the number of block records, ids run from 1 to count - 1
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRFunction_GetBlockCount(
+    const IRFunction function);
+
+/**
+ * @brief Get the predecessors of a block, in the order of the phi operands
+ */
+PARSER_ATTR const IRBlockId* PARSER_CALL IRFunction_GetPredecessors(
+    const IRFunction function,
+    IRBlockId block,
+    uint32_t* count);
+
+/**
+ * @brief Get the number of successors of a block, 0 without a terminator
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRFunction_GetSuccessorCount(
+    const IRFunction function,
+    IRBlockId block);
+
+/**
+ * @brief Get a successor of a block, the default of a switch first
+ */
+PARSER_ATTR IRBlockId PARSER_CALL IRFunction_GetSuccessor(
+    const IRFunction function,
+    IRBlockId block,
+    uint32_t index);
+
+/**
+ * @brief Renumber a function so its blocks are ranges of instruction ids
+ *
+ * @description Blocks unreachable from the entry are dropped, their edges
+ *              take the phi operands along. The other blocks are numbered
+ *              in reverse postorder, the entry stays IR_BLOCK_ENTRY.
+ *              Constants and undefined values take the lowest ids, then
+ *              the instructions of every block in order, so the
+ *              instructions of a block are the ids from IRBlock.first to
+ *              IRBlock.last. Removed records are released, and every list
+ *              is moved to a slot that just fits into one fresh pool.
+ *
+ *              All value and block ids change. Nothing may hold on to
+ *              them across the call, an IRBuilder on the function neither.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the new storage, the function is unchanged besides unreachable blocks
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_Compact(
+    IRFunction function);
+
+/**
+ * @brief Check whether the function was not changed since IRFunction_Compact
+ */
+PARSER_ATTR bool PARSER_CALL IRFunction_IsCompact(
+    const IRFunction function);
+
+typedef struct IRFunctionStats_T {
+    uint32_t instructions;          // Linked into a block
+    uint32_t values;                // Constants and undefined values
+    uint32_t records;               // Records taken, removed ones included
+    uint32_t blocks;                // Block records
+    uint32_t listWords;             // Words of the list pool taken, free slots included
+    size_t bytes;                   // Instruction pages, block table and list pool
+} IRFunctionStats;
+
+PARSER_ATTR void PARSER_CALL IRFunction_GetStats(
+    const IRFunction function,
+    IRFunctionStats* stats);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !IR_H
+// ------------------------------------------------------------------------------------------------
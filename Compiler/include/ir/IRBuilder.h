@@ -0,0 +1,172 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef IR_BUILDER_H
+#define IR_BUILDER_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "IR.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(IRBuilder)
+
+/**
+ * @brief Source variable kept in SSA form, any number chosen by the front end
+ */
+typedef uint32_t IRVariableId;
+
+typedef struct IRBuilderStats_T {
+    uint32_t phis;              // Phis created
+    uint32_t trivialPhis;       // Phis removed again, their operands were all the same value
+} IRBuilderStats;
+
+/**
+ * @brief Create an instruction builder that constructs SSA form on the fly
+ *
+ * @description Implements "Simple and Efficient Construction of Static
+ *              Single Assignment Form" (Braun et al., CC 2013): variables
+ *              are written and read per block, a read in a block without
+ *              a definition looks through the predecessors and places phis
+ *              where they meet. A block whose predecessors are not all
+ *              known yet gets incomplete phis, filled in when the block is
+ *              sealed. Phis whose operands turn out to be one value are
+ *              removed as soon as they are complete. No dominance
+ *              information is needed, so a front end can build SSA in the
+ *              same pass that parses. Reads walk the predecessors with an
+ *              explicit stack, not native recursion.
+ *
+ *              The builder starts in the entry block, which is sealed.
+ *
+ * @param function[in] Function to emit into
+ * @param builder[out] Pointer to the builder handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` or `builder` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the builder
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateIRBuilder(
+    IRFunction function,
+    IRBuilder* builder);
+
+PARSER_ATTR void PARSER_CALL IRBuilderDestroy(
+    IRBuilder builder);
+
+PARSER_ATTR IRFunction PARSER_CALL IRBuilder_GetFunction(
+    const IRBuilder builder);
+
+/**
+ * @brief Add a block, unsealed
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_AddBlock(
+    IRBuilder builder,
+    IRBlockId* block);
+
+/**
+ * @brief Continue emitting at the end of a block
+ */
+PARSER_ATTR void PARSER_CALL IRBuilder_SetBlock(
+    IRBuilder builder,
+    IRBlockId block);
+
+/**
+ * @brief Get the block being emitted into, IR_BLOCK_NONE after a terminator
+ */
+PARSER_ATTR IRBlockId PARSER_CALL IRBuilder_GetBlock(
+    const IRBuilder builder);
+
+/**
+ * @brief Append an instruction to the current block
+ *
+ * @description After a terminator there is no current block: code emitted
+ *              then is unreachable and goes to a new block without
+ *              predecessors. A terminator ends the current block.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_Emit(
+    IRBuilder builder,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    uint32_t c,
+    IRValueId* id);
+
+/**
+ * @brief Append an instruction with a list, see IRFunction_AddListInstruction
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_EmitList(
+    IRBuilder builder,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    const uint32_t* items,
+    uint32_t count,
+    IRValueId* id);
+
+/**
+ * @brief Get the constant of a type, see IRFunction_GetConstant
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_GetConstant(
+    IRBuilder builder,
+    IRType type,
+    uint64_t bits,
+    IRValueId* id);
+
+/**
+ * @brief Assign a value to a variable at the end of the current block
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_WriteVariable(
+    IRBuilder builder,
+    IRVariableId variable,
+    IRValueId value);
+
+/**
+ * @brief Get the value a variable has at the end of the current block
+ *
+ * @param builder[in] Builder handle
+ * @param variable[in] Variable
+ * @param type[in] IRType of the variable, for the phis and the undefined value
+ * @param value[out] Current value
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_ReadVariable(
+    IRBuilder builder,
+    IRVariableId variable,
+    IRType type,
+    IRValueId* value);
+
+/**
+ * @brief Declare that a block gets no more predecessors
+ *
+ * @description Completes the incomplete phis of the block.
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_SealBlock(
+    IRBuilder builder,
+    IRBlockId block);
+
+/**
+ * @brief Check whether a block is sealed
+ */
+PARSER_ATTR bool PARSER_CALL IRBuilder_IsSealed(
+    const IRBuilder builder,
+    IRBlockId block);
+
+PARSER_ATTR void PARSER_CALL IRBuilder_GetStats(
+    const IRBuilder builder,
+    IRBuilderStats* stats);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !IR_BUILDER_H
+// ------------------------------------------------------------------------------------------------
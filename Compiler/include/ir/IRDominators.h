@@ -0,0 +1,129 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef IR_DOMINATORS_H
+#define IR_DOMINATORS_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "IR.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(IRDomTree)
+
+/**
+ * @brief Build the dominator tree of a function
+ *
+ * @description Implements "A Simple, Fast Dominance Algorithm" (Cooper,
+ *              Harvey and Kennedy, 2001): blocks are numbered in reverse
+ *              postorder, and the immediate dominator of every block is
+ *              refined by intersecting the dominators of its processed
+ *              predecessors until nothing changes. A reducible graph
+ *              settles after two rounds. The tree is then numbered depth
+ *              first, so a dominance query is two comparisons.
+ *
+ *              The tree is a snapshot: it is not updated when the blocks
+ *              or edges of the function change.
+ *
+ * @param function[in] Function handle
+ * @param tree[out] Pointer to the tree handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` or `tree` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the tree
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateIRDomTree(
+    const IRFunction function,
+    IRDomTree* tree);
+
+/**
+ * @brief Build the post-dominator tree of a function
+ *
+ * @description The same algorithm on the reversed graph. Its root is a
+ *              virtual exit, IR_BLOCK_NONE, that every block without
+ *              successors leads to; blocks that cannot reach a return,
+ *              such as those of an endless loop, are unreachable in it.
+ *              All queries take IR_BLOCK_NONE as the exit.
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateIRPostDomTree(
+    const IRFunction function,
+    IRDomTree* tree);
+
+PARSER_ATTR void PARSER_CALL IRDomTreeDestroy(
+    IRDomTree tree);
+
+/**
+ * @brief Get the reachable blocks in reverse postorder, the root first
+ */
+PARSER_ATTR const IRBlockId* PARSER_CALL IRDomTree_GetOrder(
+    const IRDomTree tree,
+    uint32_t* count);
+
+/**
+ * @brief Check whether a block is reachable from the root
+ */
+PARSER_ATTR bool PARSER_CALL IRDomTree_IsReachable(
+    const IRDomTree tree,
+    IRBlockId block);
+
+/**
+ * @brief Get the immediate dominator of a block
+ *
+ * @return IR_BLOCK_NONE for the root and unreachable blocks, and for the
+ *         blocks the exit immediately post-dominates
+ */
+PARSER_ATTR IRBlockId PARSER_CALL IRDomTree_GetIdom(
+    const IRDomTree tree,
+    IRBlockId block);
+
+/**
+ * @brief Get the blocks a block immediately dominates, in reverse postorder
+ */
+PARSER_ATTR const IRBlockId* PARSER_CALL IRDomTree_GetChildren(
+    const IRDomTree tree,
+    IRBlockId block,
+    uint32_t* count);
+
+/**
+ * @brief Get the depth of a block in the tree, 0 for the root
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRDomTree_GetDepth(
+    const IRDomTree tree,
+    IRBlockId block);
+
+/**
+ * @brief Check whether every path from the root to `b` passes `a`
+ *
+ * @description A block dominates itself. Unreachable blocks dominate
+ *              nothing and are dominated by nothing.
+ */
+PARSER_ATTR bool PARSER_CALL IRDomTree_Dominates(
+    const IRDomTree tree,
+    IRBlockId a,
+    IRBlockId b);
+
+/**
+ * @brief Get the nearest block that dominates both blocks
+ *
+ * @return IR_BLOCK_NONE when either block is unreachable
+ */
+PARSER_ATTR IRBlockId PARSER_CALL IRDomTree_GetCommonDominator(
+    const IRDomTree tree,
+    IRBlockId a,
+    IRBlockId b);
+
+/**
+ * @brief Get the rounds over all blocks the last build took
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRDomTree_GetIterations(
+    const IRDomTree tree);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !IR_DOMINATORS_H
+// ------------------------------------------------------------------------------------------------
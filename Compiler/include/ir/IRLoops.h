@@ -0,0 +1,115 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef IR_LOOPS_H
+#define IR_LOOPS_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "IRDominators.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(IRLoopTree)
+
+/**
+ * @brief Loop id, loops run from 1 to IRLoopTree_GetLoopCount - 1
+ */
+typedef uint32_t IRLoopId;
+
+#define IR_LOOP_NONE                    0u
+
+/**
+ * @brief Find the natural loops of a function and how they nest
+ *
+ * @description A back edge is an edge into a block that dominates its
+ *              source. The loop of a header is the header and every block
+ *              that reaches the source of one of its back edges without
+ *              passing the header; back edges into one header make one
+ *              loop. Headers are taken innermost first, in reverse of the
+ *              reverse postorder, and the walk backwards from their back
+ *              edges jumps over the loops already found, from their
+ *              outermost header, so every block is visited once per loop
+ *              it is the direct member of. An inner loop has a lower id
+ *              than the loops around it.
+ *
+ *              Cycles entered at more than one block have no header that
+ *              dominates them and are not loops. Like the dominator tree,
+ *              the result is a snapshot of the function.
+ *
+ * @param function[in] Function handle
+ * @param domTree[in] Dominator tree of the function, see CreateIRDomTree
+ * @param tree[out] Pointer to the loop tree handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : An argument is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the tree
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateIRLoopTree(
+    const IRFunction function,
+    const IRDomTree domTree,
+    IRLoopTree* tree);
+
+PARSER_ATTR void PARSER_CALL IRLoopTreeDestroy(
+    IRLoopTree tree);
+
+/**
+ * @brief Get the number of loop records, ids run from 1 to count - 1
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRLoopTree_GetLoopCount(
+    const IRLoopTree tree);
+
+/**
+ * @brief Get the innermost loop of a block, IR_LOOP_NONE outside every loop
+ */
+PARSER_ATTR IRLoopId PARSER_CALL IRLoopTree_GetLoop(
+    const IRLoopTree tree,
+    IRBlockId block);
+
+/**
+ * @brief Get the number of loops around a block, 0 outside every loop
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRLoopTree_GetDepth(
+    const IRLoopTree tree,
+    IRBlockId block);
+
+/**
+ * @brief Get the header of a loop, the block that dominates all of it
+ */
+PARSER_ATTR IRBlockId PARSER_CALL IRLoopTree_GetHeader(
+    const IRLoopTree tree,
+    IRLoopId loop);
+
+/**
+ * @brief Get the loop immediately around a loop, IR_LOOP_NONE for an outermost one
+ */
+PARSER_ATTR IRLoopId PARSER_CALL IRLoopTree_GetParent(
+    const IRLoopTree tree,
+    IRLoopId loop);
+
+/**
+ * @brief Get the blocks of a loop, inner loops included, in reverse postorder
+ *
+ * @description The header comes first.
+ */
+PARSER_ATTR const IRBlockId* PARSER_CALL IRLoopTree_GetBlocks(
+    const IRLoopTree tree,
+    IRLoopId loop,
+    uint32_t* count);
+
+/**
+ * @brief Check whether a block is in a loop or one of its inner loops
+ */
+PARSER_ATTR bool PARSER_CALL IRLoopTree_Contains(
+    const IRLoopTree tree,
+    IRLoopId loop,
+    IRBlockId block);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !IR_LOOPS_H
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,324 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef IR_PASSES_H
+#define IR_PASSES_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "IR.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+/*
+ * Transforms of a function in SSA form. Every pass leaves the function
+ * compact, see IRFunction_Compact, so the value and block ids a caller
+ * held before the pass are stale after it.
+ */
+
+/**
+ * @brief What the passes changed
+ *
+ * @description Passes add to the counters, so one struct can collect a
+ *              pipeline over a whole module.
+ */
+typedef struct IRPassStats_T {
+    uint32_t instructionsRemoved;       // Instructions no longer in a block
+    uint32_t blocksRemoved;
+    uint32_t valuesFolded;              // Instructions replaced by a constant
+    uint32_t branchesFolded;            // Conditional branches and switches turned into branches
+    uint32_t valuesMerged;              // Instructions replaced by an equal value that dominates them
+    uint32_t loadsRemoved;              // Loads replaced by what an earlier load or store found in memory
+    uint32_t callsInlined;              // Calls replaced by the body of the callee
+    uint32_t functionsRemoved;          // Internal functions nothing referred to after inlining
+    uint32_t valuesHoisted;             // Loop invariant instructions moved to the preheader
+    uint32_t inductionsReduced;         // Values of an induction variable turned into one of their own
+    uint32_t divisionsLowered;          // Divisions and remainders by a constant turned into multiplies and shifts
+    uint32_t switchesLowered;           // Switches turned into jump tables, bit tests and search trees
+} IRPassStats;
+
+/**
+ * @brief Sparse conditional constant propagation
+ *
+ * @description Implements "Constant Propagation with Conditional Branches"
+ *              (Wegman and Zadeck, 1991). Every value starts unknown and
+ *              only moves down the lattice unknown, constant, varying;
+ *              a block is only looked at once an edge into it is found
+ *              executable, and a phi only meets the operands of executable
+ *              edges. A worklist of blocks reached for the first time and
+ *              one of instructions whose operands changed drive the
+ *              analysis, so every instruction is visited a bounded number
+ *              of times instead of once per round over the function.
+ *
+ *              Values found constant are replaced by the constant, branches
+ *              on a constant become plain branches, and blocks no
+ *              executable edge reaches are dropped. A branch on a value
+ *              that is never defined takes its first target. Loads, calls
+ *              and parameters always vary, volatile accesses are kept.
+ *
+ * @param function[in] Function handle
+ * @param stats[in,out] Counters to add to, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the lattice, or grow the function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_PropagateConstants(
+    IRFunction function,
+    IRPassStats* stats);
+
+/**
+ * @brief Aggressive dead code elimination
+ *
+ * @description Everything is dead until shown live. Stores, calls,
+ *              returns and volatile loads are live from the start; a live
+ *              instruction makes its operands live, a live phi the branches
+ *              into its block, and a live block the branches it is control
+ *              dependent on, found from the post-dominator tree. What stays
+ *              dead is removed, cycles of phis included, and a dead
+ *              conditional branch or switch becomes a branch to one of its
+ *              targets, so the blocks it decided between can go as well.
+ *              Last, every block is merged into its predecessor when that
+ *              is the only one and branches straight into it.
+ *
+ *              Loops are kept: the branches of back edges, and of blocks
+ *              that never reach a return, are live from the start, as the
+ *              pass cannot tell an empty loop from one that never ends.
+ *
+ * @param function[in] Function handle
+ * @param stats[in,out] Counters to add to, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the analysis
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_EliminateDeadCode(
+    IRFunction function,
+    IRPassStats* stats);
+
+/**
+ * @brief Global value numbering and redundant load elimination
+ *
+ * @description Walks the dominator tree in preorder with a scoped hash
+ *              table, so an instruction is looked up among the ones that
+ *              dominate it. Arithmetic, comparisons, conversions, address
+ *              computations and phis of one block that compute the same
+ *              from the same operands are merged into the first, operands
+ *              of commutative opcodes in either order. A phi of one value
+ *              becomes that value.
+ *
+ *              A load is replaced by the value an earlier load read from,
+ *              or a store wrote to, the same address with the same type,
+ *              when no write in between may reach it. Memory is only
+ *              carried into a block with a single predecessor. A pointer
+ *              is traced to a stack slot, a global or a parameter flagged
+ *              IR_INSTRUCTION_FLAG_NOALIAS, through address arithmetic,
+ *              phis and selects. Writes to another object, or another
+ *              range of the same, do not clobber; a pointer of unknown
+ *              origin may reach anything but a stack slot whose address is
+ *              never let out, and a restrict parameter whose address is
+ *              never let out. Calls clobber every object but those slots.
+ *
+ *              Volatile loads and stores are never merged, removed, or
+ *              used to replace another access.
+ *
+ * @param function[in] Function handle
+ * @param stats[in,out] Counters to add to, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the tables, or the dominator tree
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_NumberValues(
+    IRFunction function,
+    IRPassStats* stats);
+
+/**
+ * @brief Loop invariant code motion and induction variable strength reduction
+ *
+ * @description Loops are found from the dominator tree, see
+ *              CreateIRLoopTree, and taken innermost first. Every loop is
+ *              given a preheader first: a block that is the only way into
+ *              the header from outside and only branches there, split off
+ *              the edges into the header when there is none.
+ *
+ *              Instructions whose operands are all defined outside the loop
+ *              move to the preheader, in the order they were in, so an
+ *              invariant is computed once per entry into the loop and moves
+ *              on from there when the loop around is done. Only
+ *              instructions that cannot trap move, as the loop may not run:
+ *              arithmetic, comparisons, conversions, selects and address
+ *              computations, and divisions by a constant other than 0 and
+ *              -1. Loads stay.
+ *
+ *              A basic induction variable is a phi of the header that adds
+ *              a constant to itself on the one back edge. A multiply or left
+ *              shift of one by an invariant, and what adds invariants to
+ *              that, address computations included, are linear in the
+ *              iteration; such a value used by anything else gets a phi of
+ *              its own that starts at its value for the first iteration and
+ *              adds the step on the back edge, so `a[i]` becomes a pointer
+ *              that moves on by the element size. The extension of a
+ *              narrower variable to the offset width is only looked through
+ *              when the exit test in the header shows it cannot wrap.
+ *
+ * @param function[in] Function handle
+ * @param stats[in,out] Counters to add to, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the loop tree, or grow the function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_OptimizeLoops(
+    IRFunction function,
+    IRPassStats* stats);
+
+/**
+ * @brief Lower integer divisions and remainders by a constant
+ *
+ * @description For targets without a divider, where a division is a
+ *              library loop over the bits. Implements "Division by
+ *              Invariant Integers using Multiplication" (Granlund and
+ *              Montgomery, 1994): a division by a power of two becomes a
+ *              shift, with a bias for negative dividends when signed; any
+ *              other divisor becomes the high half of a multiply by a magic
+ *              number and shifts, IR_OP_SMULH or IR_OP_UMULH. A remainder
+ *              is the dividend less the quotient times the divisor, a mask
+ *              for an unsigned power of two. Divisions by 0 stay as they
+ *              are.
+ *
+ * @param function[in] Function handle
+ * @param stats[in,out] Counters to add to, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_LowerDivisions(
+    IRFunction function,
+    IRPassStats* stats);
+
+#define IR_SWITCH_DEFAULT_SIZE_WEIGHT   1u
+#define IR_SWITCH_DEFAULT_CYCLES_WEIGHT 1u
+#define IR_SWITCH_DEFAULT_ENTRY_SIZE    4u      // A code address
+#define IR_SWITCH_DEFAULT_MASK_WIDTH    32u
+
+typedef struct IRSwitchConfig_T {
+    uint32_t sizeWeight;                // Cost of a byte of code, 0 for the default
+    uint32_t cyclesWeight;              // Cost of a cycle on the way to a case, 0 for the default
+    uint32_t entrySize;                 // Bytes of a jump table entry, 0 for the default
+    uint32_t maskWidth;                 // Bits of the widest mask a bit test may use, 0 for the default
+} IRSwitchConfig;
+
+/**
+ * @brief Lower switches to jump tables, bit tests and balanced search trees
+ *
+ * @description The cases of a switch are sorted by signed value, runs of
+ *              neighbours with one target merged into ranges, and the
+ *              ranges split into clusters by dynamic programming so the
+ *              sum of their costs is least. A cluster is a single range,
+ *              compared against its bounds; a jump table over a dense run,
+ *              whose entries cost `entrySize` each; or, for a run narrower
+ *              than `maskWidth` going to at most three targets, a one
+ *              shifted by the value and tested against a mask per target.
+ *              A cost weighs the bytes of the code against the cycles on
+ *              the way through it, so density decides between a table and
+ *              compares without a fixed threshold.
+ *
+ *              The clusters become the leaves of a search tree balanced on
+ *              their count, its nodes a signed compare against the low end
+ *              of a cluster. A leaf leaves out the bounds checks the path
+ *              to it already made. A jump table is a switch flagged
+ *              IR_INSTRUCTION_FLAG_JUMP_TABLE on the value less the low
+ *              end, behind a bounds check, with a case per entry and the
+ *              gaps going to the default; a back end puts the entries in
+ *              read-only memory and does no checks of its own. Such
+ *              switches are left as they are on a later run.
+ *
+ * @param function[in] Function handle
+ * @param config[in] Cost model, NULL for the defaults
+ * @param stats[in,out] Counters to add to, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the clusters, or grow the function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_LowerSwitches(
+    IRFunction function,
+    const IRSwitchConfig* config,
+    IRPassStats* stats);
+
+#define IR_INLINE_FREQUENCY_ONE         16u     // A call that runs once per run of its function
+#define IR_INLINE_DEFAULT_THRESHOLD     12u
+#define IR_INLINE_DEFAULT_HINT_BONUS    24u
+#define IR_INLINE_DEFAULT_GROWTH_PERCENT 10u
+
+/**
+ * @brief Get how often a call runs per run of the function it is in
+ *
+ * @description For profile data. The function is as it was before any
+ *              call in it was inlined.
+ *
+ * @return Runs times IR_INLINE_FREQUENCY_ONE, 0 for a call never seen to run
+ */
+typedef uint32_t (PARSER_PTR* PFN_IRCallFrequencyCallback)(
+    void* pUserData,
+    const IRFunction function,
+    IRValueId call);
+
+typedef struct IRInlineConfig_T {
+    uint32_t threshold;                 // Instructions a call that runs once may grow the code by, 0 for the default
+    uint32_t hintBonus;                 // Added to the threshold for callees flagged IR_GLOBAL_FLAG_INLINE, 0 for the default
+    uint32_t growthLimit;               // Instructions the module may grow by, 0 for growthPercent of its size
+    uint32_t growthPercent;             // 0 for the default
+    PFN_IRCallFrequencyCallback pfnFrequency;   // NULL to estimate from the loops around the call
+    void* pUserData;
+} IRInlineConfig;
+
+/**
+ * @brief Inline calls by a cost model made for code size
+ *
+ * @description Functions are taken bottom up over the call graph: the
+ *              strongly connected components are found with Tarjan's
+ *              algorithm and every callee is done before its callers, so a
+ *              body is inlined with its own calls already inlined. Calls
+ *              within one component, recursion, are never inlined.
+ *
+ *              A function costs its instructions besides parameters, stack
+ *              slots and returns; a call saves itself and its arguments.
+ *              When the callee is internal and this is the only reference
+ *              to it, it goes as well. A call that does not grow the code,
+ *              such as that of an accessor that only loads or stores, is
+ *              always inlined. Otherwise the growth must stay under the
+ *              threshold, raised by the hint bonus for callees declared
+ *              inline, times how often the call runs, and within what is
+ *              left of the growth budget of the module. How often a call
+ *              runs comes from the callback, or is taken as eight times per
+ *              loop around it; either is capped at eight runs. Within a
+ *              function the calls with the least growth per run go first.
+ *
+ *              Stack slots of the callee move to the entry of the caller.
+ *              Internal functions no longer referred to are removed at the
+ *              end, their globals stay declared.
+ *
+ * @param module[in] Module handle
+ * @param config[in] Cost model, NULL for the defaults
+ * @param stats[in,out] Counters to add to, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `module` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the call graph, or grow a function
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRModule_InlineFunctions(
+    IRModule module,
+    const IRInlineConfig* config,
+    IRPassStats* stats);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !IR_PASSES_H
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,177 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef IR_REG_ALLOC_H
+#define IR_REG_ALLOC_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "IRLoops.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(IRRegAlloc)
+
+#define IR_REGALLOC_MAX_REGISTERS       64u
+#define IR_REGALLOC_DEFAULT_REGISTERS   8u      // r0 to r7, the low registers of Thumb-1
+#define IR_REGALLOC_DEFAULT_REGISTER_BYTES 4u
+#define IR_REGALLOC_DEFAULT_CALLER_SAVED 0x0Full // r0 to r3 of the ARM procedure call standard
+
+/**
+ * @brief Register file of the target
+ *
+ * @description Registers are numbered from 0 and form one class, floating
+ *              point values included, as on targets without a floating
+ *              point unit. A value wider than a register takes consecutive
+ *              registers from an even one when it needs two or more, like
+ *              a register pair on AVR. For AVR: 32 registers of 1 byte,
+ *              pointers of 2, r18 to r27 and r30 to r31 caller-saved, r0
+ *              and r1 reserved as the scratch and zero registers.
+ */
+typedef struct IRRegAllocConfig_T {
+    uint32_t registerCount;             // At most IR_REGALLOC_MAX_REGISTERS, 0 for the default
+    uint32_t registerBytes;             // Bytes of a register, 0 for the default
+    uint32_t pointerBytes;              // Bytes of a pointer, 0 for `registerBytes`
+    uint64_t callerSavedMask;           // Registers a call clobbers
+    uint64_t reservedMask;              // Registers never handed out, such as a scratch register for moves
+} IRRegAllocConfig;
+
+typedef enum IRLocationKind {
+    IR_LOCATION_NONE = 0,               // Undefined value, or a phi without uses
+    IR_LOCATION_REGISTER,
+    IR_LOCATION_STACK,
+    IR_LOCATION_CONSTANT,               // Recomputed where needed: a constant, global or stack slot address
+} IRLocationKind;
+
+typedef struct IRLocation_T {
+    uint32_t kind;                      // IRLocationKind
+    uint32_t count;                     // Registers from `index` on, or bytes of the stack slot
+    uint32_t index;                     // First register, or byte offset in the spill area
+} IRLocation;
+
+/**
+ * @brief Copy of a value from one location to another
+ *
+ * @description A move from IR_LOCATION_CONSTANT recomputes the value, the
+ *              instruction that defines it for a global or stack slot
+ *              address. The registers of one move may overlap, they are
+ *              copied in the direction that keeps the source intact. A
+ *              move into a stack slot from a slot or a constant goes
+ *              through a register the back end keeps out of the ones
+ *              handed out.
+ */
+typedef struct IRMove_T {
+    IRValueId value;                    // Value copied, the operand for a move into a phi
+    IRLocation from;
+    IRLocation to;
+} IRMove;
+
+typedef struct IRRegAllocStats_T {
+    uint32_t intervals;                 // Live intervals after splitting, one per use of a constant included
+    uint32_t splits;
+    uint32_t spilledValues;             // Values given a stack slot
+    uint32_t moves;                     // Moves of every kind, spill stores and reloads included
+    uint32_t rematerialized;            // Moves from IR_LOCATION_CONSTANT
+} IRRegAllocStats;
+
+/**
+ * @brief Assign every value of a function a register or a stack slot
+ *
+ * @description Implements "Optimized Interval Splitting in a Linear Scan
+ *              Register Allocator" (Wimmer and Moessenboeck, 2005) over the
+ *              SSA form. Blocks are laid out in reverse postorder and every
+ *              instruction takes a few positions, so the live range of a
+ *              value is a list of position ranges with holes where it is
+ *              dead. Intervals are taken by start in one pass: one gets the
+ *              register that stays free the longest, is cut where that
+ *              register is taken, or takes the register of the intervals
+ *              whose remaining uses weigh least, cutting them at the
+ *              current position. A use weighs 8 to the loop depth, and a
+ *              cut in a loop moves to the header of the outermost loop
+ *              that starts after the interval, so spill code stays out of
+ *              loops. The part of an interval without a use that needs a
+ *              register goes to the stack of its value, or is recomputed
+ *              for a constant, global or stack slot address, and every use
+ *              of a constant that needs a register gets a short interval of
+ *              its own. Values that live across a call avoid the
+ *              caller-saved registers. Stack slots of values whose
+ *              lifetimes do not overlap are shared.
+ *
+ *              The work grows with the number of ranges and uses, not the
+ *              square of the function size. Moves between the intervals of
+ *              a value go where one takes over from the other, moves along
+ *              an edge, the ones of phis included, at the end of a block
+ *              with one successor or the start of a block with one
+ *              predecessor. Critical edges are split first for that, and
+ *              the function is compacted; its ids change, and it may not
+ *              change after.
+ *
+ * @param function[in] Function handle, changed as described
+ * @param config[in] Register file, NULL for the defaults
+ * @param alloc[out] Pointer to the allocation handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `function` or `alloc` is NULL, or `config` leaves no register
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the intervals, or grow the function
+ *      PARSER_ERROR_UNSUPPORTED : An instruction needs more registers at once than there are, or a phi
+ *          takes different values over two edges from one block
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateIRRegAlloc(
+    IRFunction function,
+    const IRRegAllocConfig* config,
+    IRRegAlloc* alloc);
+
+PARSER_ATTR void PARSER_CALL IRRegAllocDestroy(
+    IRRegAlloc alloc);
+
+/**
+ * @brief Get where a value is when an instruction reads it, or where the instruction writes it
+ *
+ * @param alloc[in] Allocation handle
+ * @param value[in] Value read by `at`, or `at` itself for its result
+ * @param at[in] Instruction that is not a phi, or a phi for itself
+ * @param location[out] Location, IR_LOCATION_NONE when `value` is not live there
+ */
+PARSER_ATTR void PARSER_CALL IRRegAlloc_GetLocation(
+    const IRRegAlloc alloc,
+    IRValueId value,
+    IRValueId at,
+    IRLocation* location);
+
+/**
+ * @brief Get the moves to make right before an instruction, in order
+ *
+ * @description A parallel copy of values that swap registers is broken
+ *              through the spill area, after the stack slots.
+ *
+ * @return Moves, NULL with `count` 0 without
+ */
+PARSER_ATTR const IRMove* PARSER_CALL IRRegAlloc_GetMoves(
+    const IRRegAlloc alloc,
+    IRValueId before,
+    uint32_t* count);
+
+/**
+ * @brief Get the bytes of the spill area, the stack slots and the room for swaps
+ */
+PARSER_ATTR uint32_t PARSER_CALL IRRegAlloc_GetSpillSize(
+    const IRRegAlloc alloc);
+
+/**
+ * @brief Get the registers handed out, callee-saved ones among them to save in the prologue
+ */
+PARSER_ATTR uint64_t PARSER_CALL IRRegAlloc_GetUsedRegisters(
+    const IRRegAlloc alloc);
+
+PARSER_ATTR void PARSER_CALL IRRegAlloc_GetStats(
+    const IRRegAlloc alloc,
+    IRRegAllocStats* stats);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !IR_REG_ALLOC_H
+// ------------------------------------------------------------------------------------------------
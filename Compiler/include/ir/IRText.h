@@ -0,0 +1,108 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef IR_TEXT_H
+#define IR_TEXT_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "IR.h"
+
+#include <stddef.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+/*
+ * Textual form of a module, one item per line, `;` starts a comment:
+ *
+ *   declare @puts
+ *   declare @sum internal inline
+ *   data @.3 6 align 1 internal constant x"68656c6c6f00"
+ *   define @sum(i32, ptr) -> i32 {
+ *   b1:
+ *     %1 = param i32 #0
+ *     %2 = add i32 %1, i32 -1
+ *     br void b2
+ *   b2:
+ *     %3 = phi i32 [%2 b1, %7 b4]
+ *     %4 = load volatile i32 %3
+ *     switch void %4, b3, [1 b4, -2 b5]
+ *   ...
+ *   }
+ *
+ * Every instruction is `[%N = ]opcode [flags] type operands`. Value
+ * operands are `%N`, an inline constant `type bits`, `type undef` or
+ * `none`; blocks are `bN`, immediates `#N`, the global of IR_OP_GLOBAL is
+ * `@name`. Phi operands name their predecessor. Integer constants are
+ * written signed, floating point ones as their hexadecimal bits.
+ * Anonymous data is `@.N`. All globals are listed before the first
+ * definition, so a body may use any of them.
+ *
+ * Numbers only name things within the text: values are numbered in the
+ * order they are printed, blocks in the order of their labels. A value may
+ * be used before the line that defines it.
+ */
+
+/**
+ * @brief Write a module as text
+ *
+ * @param module[in] Module handle
+ * @param text[out] NUL terminated text, release with IRText_Free
+ * @param length[out] Length without the NUL, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `module` or `text` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the text
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRModule_Print(
+    const IRModule module,
+    char** text,
+    size_t* length);
+
+/**
+ * @brief Write the definition of one function as text, see IRModule_Print
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_Print(
+    const IRFunction function,
+    char** text,
+    size_t* length);
+
+PARSER_ATTR void PARSER_CALL IRText_Free(
+    char* text);
+
+/**
+ * @brief Add the globals and functions of a text to a module
+ *
+ * @description Reading the text of a module into an empty module gives
+ *              the same globals with the same ids, and the same blocks
+ *              and instructions in the same order: printing it again
+ *              gives the same text. The predecessors of a block with phis
+ *              are in the order its first phi names them.
+ *
+ * @param module[in] Module handle
+ * @param text[in] Text, not NUL terminated
+ * @param length[in] Length of the text
+ * @param errorLine[out] Line of the first error, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `module` or `text` is NULL
+ *      PARSER_ERROR_SYNTAX_ERROR : The text is malformed, functions defined before the error are kept
+ *      PARSER_ERROR_UNCLOSED_BRACE : The text ends inside a definition
+ *      PARSER_ERROR_UNKNOWN_IDENTIFIER : A global, value or opcode or block is not known
+ *      PARSER_ERROR_REDECLARATION : A global is defined twice
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the module
+ */
+PARSER_ATTR ParserResult PARSER_CALL IRModule_Parse(
+    IRModule module,
+    const char* text,
+    size_t length,
+    uint32_t* errorLine);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !IR_TEXT_H
+// ------------------------------------------------------------------------------------------------
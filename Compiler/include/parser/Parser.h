@@ -11,123 +11,103 @@
 
 #include "ParserCore.h"
 #include "Results.h"
+#include "ParserArena.h"
+#include "ParserAST.h"
+#include "ParserInterner.h"
+#include "ParserSymbol.h"
+#include "ParserType.h"
 
 #include "lexer/Lexer.h"
 #include "lexer/Token.h"
 
+#include "ir/IR.h"
+
 // ------------------------------------------------------------------------------------------------
 // Public definitions
 // ------------------------------------------------------------------------------------------------
 
 PARSER_CORE_DEFINE_HANDLE(ASTParser)
-PARSER_CORE_DEFINE_HANDLE(ASTScope)
-PARSER_CORE_DEFINE_HANDLE(ASTSymbol)      // for symbol table entries
-PARSER_CORE_DEFINE_HANDLE(ASTType)        // for type representation
-PARSER_CORE_DEFINE_HANDLE(ASTNode)
-
-typedef enum ParserASTNodeType {
-    AST_NODE_TYPE_NONE = 0,
-
-    // ===== Declarations =====
-    AST_NODE_TYPE_TRANSLATION_UNIT,      // root of the AST (entire file)
-    AST_NODE_TYPE_FUNCTION_DECL,         // function declaration/definition
-    AST_NODE_TYPE_VARIABLE_DECL,         // variable declaration
-    AST_NODE_TYPE_PARAMETER_DECL,        // function parameter
-    AST_NODE_TYPE_STRUCT_DECL,           // struct declaration
-    AST_NODE_TYPE_UNION_DECL,            // union declaration
-    AST_NODE_TYPE_ENUM_DECL,             // enum declaration
-    AST_NODE_TYPE_TYPEDEF_DECL,          // typedef declaration
-
-    // ===== Type Specifiers =====
-    AST_NODE_TYPE_TYPE_SPECIFIER,        // int, float, char, etc.
-    AST_NODE_TYPE_POINTER_TYPE,          // pointer type (int*)
-    AST_NODE_TYPE_ARRAY_TYPE,            // array type (int[10])
-    AST_NODE_TYPE_FUNCTION_TYPE,         // function type signature
-
-    // ===== Statements =====
-    AST_NODE_TYPE_COMPOUND_STMT,         // block/scope { ... }
-    AST_NODE_TYPE_EXPRESSION_STMT,       // expression statement (x = 5;)
-    AST_NODE_TYPE_RETURN_STMT,           // return statement
-    AST_NODE_TYPE_IF_STMT,               // if statement
-    AST_NODE_TYPE_WHILE_STMT,            // while loop
-    AST_NODE_TYPE_DO_WHILE_STMT,         // do-while loop
-    AST_NODE_TYPE_FOR_STMT,              // for loop
-    AST_NODE_TYPE_SWITCH_STMT,           // switch statement
-    AST_NODE_TYPE_CASE_STMT,             // case label
-    AST_NODE_TYPE_DEFAULT_STMT,          // default label
-    AST_NODE_TYPE_BREAK_STMT,            // break statement
-    AST_NODE_TYPE_CONTINUE_STMT,         // continue statement
-    AST_NODE_TYPE_GOTO_STMT,             // goto statement
-    AST_NODE_TYPE_LABEL_STMT,            // label for goto
-
-    // ===== Expressions =====
-    AST_NODE_TYPE_BINARY_EXPR,           // binary operations (a + b, a * b, etc.)
-    AST_NODE_TYPE_UNARY_EXPR,            // unary operations (++a, -x, *ptr, &var)
-    AST_NODE_TYPE_TERNARY_EXPR,          // ternary conditional (a ? b : c)
-    AST_NODE_TYPE_CALL_EXPR,             // function call
-    AST_NODE_TYPE_CAST_EXPR,             // type cast
-    AST_NODE_TYPE_ASSIGNMENT_EXPR,       // assignment (=, +=, -=, etc.)
-    AST_NODE_TYPE_MEMBER_EXPR,           // struct/union member access (obj.member)
-    AST_NODE_TYPE_ARROW_EXPR,            // pointer member access (ptr->member)
-    AST_NODE_TYPE_ARRAY_SUBSCRIPT_EXPR,  // array subscript (arr[i])
-    AST_NODE_TYPE_SIZEOF_EXPR,           // sizeof operator
-    AST_NODE_TYPE_COMMA_EXPR,            // comma operator (a, b, c)
-
-    // ===== Literals & Identifiers =====
-    AST_NODE_TYPE_INTEGER_LITERAL,       // integer constant
-    AST_NODE_TYPE_FLOAT_LITERAL,         // floating-point constant
-    AST_NODE_TYPE_STRING_LITERAL,        // string literal
-    AST_NODE_TYPE_CHAR_LITERAL,          // character literal
-    AST_NODE_TYPE_IDENTIFIER,            // identifier reference
-
-    // ===== Initialization =====
-    AST_NODE_TYPE_INITIALIZER,           // variable initializer
-    AST_NODE_TYPE_INITIALIZER_LIST,      // initializer list { a, b, c }
-
-    // ===== Preprocessor (optional, if tracking) =====
-    AST_NODE_TYPE_MACRO_EXPANSION,       // macro expansion node
-
-    AST_NODE_TYPE_COUNT                  // total count of node types
-} ParserASTNodeType;
-
 
 // ===== Language-Specific Parsing Callbacks =====
 
 /**
  * @brief Callback to parse a primary expression (literals, identifiers, etc.)
  * 
- * @param parser The parser context
+ * @param parser[in] The parser context
+ * @param node[out] AST node representing the primary expression
  * 
- * @return AST node representing the primary expression, or NULL on error
+ * @return ParserResult representing the status code of the operation
  */
-typedef ParserResult (PARSER_PTR* PFN_ParsePrimaryExpression)(ASTParser parser, ASTNode node);
+typedef ParserResult (PARSER_PTR* PFN_ParsePrimaryExpression)(ASTParser parser, ASTNode* node);
 
 /**
  * @brief Callback to parse a declaration
  * 
- * @param parser The parser context
+ * @description A declaration can declare several names. Every declaration
+ *              node is added to the list under construction of the caller
+ *              (e.g. the translation unit), `node` is the last of them.
+ * 
+ * @param parser[in] The parser context
+ * @param node[out] Last declaration node, NULL when nothing was declared
+ *                  but a tag
  * 
- * @return AST node representing the declaration, or NULL on error
+ * @return ParserResult representing the status code of the operation
+ */
+typedef ParserResult (PARSER_PTR* PFN_ParseDeclaration)(ASTParser parser, ASTNode* node);
+
+/**
+ * @brief Callback to parse the body of a function definition
+ * 
+ * @description Called with the current token on the opening brace, either
+ *              right after the declarator or later for a skipped body.
+ * 
+ * @param parser[in] The parser context
+ * @param function[in] FUNCTION_DECL node of the definition
+ * @param node[out] AST node representing the body
+ * 
+ * @return ParserResult representing the status code of the operation
  */
-typedef ParserResult (PARSER_PTR* PFN_ParseDeclaration)(ASTParser parser, ASTNode node);
+typedef ParserResult (PARSER_PTR* PFN_ParseFunctionBody)(ASTParser parser, ASTNode function, ASTNode* node);
+
+/**
+ * @brief Callback to lower the body of a function definition straight to IR
+ * 
+ * @description Called with the current token on the opening brace instead
+ *              of PFN_ParseFunctionBody when the parser has a module.
+ *              Statements and expressions emit instructions as they are
+ *              read, no nodes are built for them. A body that uses
+ *              something the callback does not lower is given up without
+ *              recording an error, the parser then rewinds and parses it.
+ * 
+ * @param parser[in] The parser context
+ * @param function[in] FUNCTION_DECL node of the definition
+ * @param ir[out] Definition of the function in the module of the parser
+ * 
+ * @return ParserResult representing the status code of the operation
+ *      PARSER_ERROR_UNSUPPORTED : The body is left to PFN_ParseFunctionBody,
+ *                                 nothing of it is kept
+ */
+typedef ParserResult (PARSER_PTR* PFN_LowerFunctionBody)(ASTParser parser, ASTNode function, IRFunction* ir);
 
 /**
  * @brief Callback to parse a statement
  * 
- * @param parser The parser context
+ * @param parser[in] The parser context
+ * @param node[out] AST node representing the statement
  * 
- * @return AST node representing the statement, or NULL on error
+ * @return ParserResult representing the status code of the operation
  */
-typedef ParserResult (PARSER_PTR* PFN_ParseStatement)(ASTParser parser, ASTNode node);
+typedef ParserResult (PARSER_PTR* PFN_ParseStatement)(ASTParser parser, ASTNode* node);
 
 /**
  * @brief Callback to parse a type specifier
  * 
- * @param parser The parser context
+ * @param parser[in] The parser context
+ * @param node[out] AST node representing the type
  * 
- * @return AST node representing the type, or NULL on error
+ * @return ParserResult representing the status code of the operation
  */
-typedef ParserResult (PARSER_PTR* PFN_ParseTypeSpecifier)(ASTParser parser, ASTNode node);
+typedef ParserResult (PARSER_PTR* PFN_ParseTypeSpecifier)(ASTParser parser, ASTNode* node);
 
 /**
  * @brief Callback to check if current token is a valid type name
@@ -141,19 +121,23 @@ typedef bool (PARSER_PTR* PFN_IsTypeName)(ASTParser parser);
 /**
  * @brief Callback to get operator precedence for a given token
  * 
+ * @description Must not look at the lexeme, the token kind and value
+ *              identify the operator.
+ * 
  * @param token The token to check
  * 
- * @return Precedence level (higher = tighter binding)
+ * @return Precedence level (higher = tighter binding), 0 when the token
+ *         does not continue an expression
  */
 typedef uint16_t (PARSER_PTR* PFN_GetOperatorPrecedence)(LexerToken token);
 
 /**
- * @brief Callback to parse a binary operator expression
+ * @brief Callback to parse the operators binding at least as tight as `precedence`
  * 
  * @param parser[in] The parser context
- * @param left[in] Left-hand side expression
+ * @param left[in] Left-hand side expression, NULL to parse it first
  * @param precedence[in] Minimum precedence level
- * @param AST[out] node representing the binary expression, or NULL on error
+ * @param node[out] AST node representing the expression
  * 
  * @return ParserResult representing the status code of the operation
  */
@@ -161,25 +145,27 @@ typedef ParserResult (PARSER_PTR* PFN_ParseBinaryOperator)(
     ASTParser parser,
     ASTNode left,
     int precedence,
-    ASTNode node);
+    ASTNode* node);
 
 /**
  * @brief Callback to parse a unary operator expression
  * 
- * @param parser The parser context
+ * @param parser[in] The parser context
+ * @param node[out] AST node representing the unary expression
  * 
- * @return AST node representing the unary expression, or NULL on error
+ * @return ParserResult representing the status code of the operation
  */
-typedef ParserResult (PARSER_PTR* PFN_ParseUnaryOperator)(ASTParser parser);
+typedef ParserResult (PARSER_PTR* PFN_ParseUnaryOperator)(ASTParser parser, ASTNode* node);
 
 /**
  * @brief Callback to parse function parameters
  * 
- * @param parser The parser context
+ * @param parser[in] The parser context
+ * @param node[out] AST node representing parameter list
  * 
- * @return AST node representing parameter list, or NULL on error
+ * @return ParserResult representing the status code of the operation
  */
-typedef ParserResult (PARSER_PTR* PFN_ParseParameterList)(ASTParser parser);
+typedef ParserResult (PARSER_PTR* PFN_ParseParameterList)(ASTParser parser, ASTNode* node);
 
 /**
  * @brief Language-specific parsing strategy
@@ -204,19 +190,221 @@ typedef struct ParserLanguageStrategy {
 
     // Statement parsing
     PFN_ParseStatement            parseStatement;
+    PFN_ParseFunctionBody         parseFunctionBody;
+    PFN_LowerFunctionBody         lowerFunctionBody;      // Optional, see ASTParserCreateConfig.module
 
     // Optional: language-specific features
     void* userData;                                   // for language-specific state
 } ParserLanguageStrategy;
 
-// Parser initialization
+typedef struct ASTParserCreateConfig_T {
+    const ParserLanguageStrategy* strategy;
+    size_t arenaChunkSize;          // Chunk size of the translation unit arena, 0 for the default
+    bool lazyFunctionBodies;        // Skip function bodies, see ASTParser_ParseFunctionBody
+    bool keepTokens;                // Keep the tokens of the unit, see ASTParser_WriteImage
+    IRModule module;                // Lower function bodies into this module, see ASTParser_Parse
+} ASTParserCreateConfig;
+
+/**
+ * @brief Function body statistics of the current translation unit
+ */
+typedef struct ASTParserStats_T {
+    uint32_t functionDefinitions;   // Function definitions seen at file scope
+    uint32_t skippedBodies;         // Bodies only brace matched, no nodes built
+    uint32_t parsedBodies;          // Skipped bodies parsed on demand since
+    uint32_t bodyThreads;           // Threads of the last ASTParser_ParseFunctionBodies
+    uint32_t stolenBodies;          // Bodies it parsed on a thread that stole them
+    uint32_t foldedExpressions;     // Constant expressions replaced by a literal node
+    uint32_t loweredBodies;         // Bodies lowered to IR, no nodes built
+    uint32_t fallbackBodies;        // Bodies the lowering gave up on, parsed instead
+} ASTParserStats;
+
+#define AST_PARSER_MAX_BODY_THREADS     64u
+
+/**
+ * @brief Create a parser for one translation unit at a time
+ *
+ * @description Nodes, scopes, symbols and types of a translation unit are
+ *              allocated from an arena owned by the parser and released
+ *              together when the parser moves on to the next unit
+ *              (ASTParser_Init) or is destroyed.
+ *
+ * @param lexer[in] Lexer of the first translation unit
+ * @param cfg[in] Config for the parser creation
+ * @param parser[out] Pointer to the parser handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_STRATEGY : No language strategy
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the parser
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateASTParser(
+    Lexer lexer,
+    const ASTParserCreateConfig* cfg,
+    ASTParser* parser);
+
+/**
+ * @brief Destroy the parser and everything allocated for its translation unit
+ *
+ * @param parser[in] Parser handle
+ */
+PARSER_ATTR void PARSER_CALL ASTParserDestroy(
+    ASTParser parser);
+
+/**
+ * @brief Get the arena of the current translation unit
+ *
+ * @param parser[in] Parser handle
+ */
+PARSER_ATTR ParserArena PARSER_CALL ASTParser_GetArena(
+    const ASTParser parser);
+
+/**
+ * @brief Get the node tree of the current translation unit
+ *
+ * @description ASTNode handles returned by the parser are ids in this tree.
+ *
+ * @param parser[in] Parser handle
+ */
+PARSER_ATTR ASTTree PARSER_CALL ASTParser_GetTree(
+    const ASTParser parser);
+
+/**
+ * @brief Get the identifier table of the current translation unit
+ *
+ * @description Identifier nodes store their name as an id in this table.
+ *
+ * @param parser[in] Parser handle
+ */
+PARSER_ATTR ParserInterner PARSER_CALL ASTParser_GetInterner(
+    const ASTParser parser);
+
+/**
+ * @brief Get the symbol table of the current translation unit
+ *
+ * @description Identifier nodes store the symbol they resolved to.
+ *
+ * @param parser[in] Parser handle
+ */
+PARSER_ATTR ASTSymbolTable PARSER_CALL ASTParser_GetSymbolTable(
+    const ASTParser parser);
+
+/**
+ * @brief Get the type table of the current translation unit
+ *
+ * @description Type names and declared symbols refer to types by id in
+ *              this table.
+ *
+ * @param parser[in] Parser handle
+ */
+PARSER_ATTR ASTTypeTable PARSER_CALL ASTParser_GetTypeTable(
+    const ASTParser parser);
+
+// Parser initialization, starts a new translation unit and releases the
+// arena of the previous one
 PARSER_ATTR void PARSER_CALL ASTParser_Init(
     ASTParser parser,
     Lexer lexer);
 
-// Main parsing entry point
-PARSER_ATTR ASTNode PARSER_CALL ASTParser_Parse(
-    ASTParser parser);
+/**
+ * @brief Parse the translation unit
+ *
+ * @description With lazyFunctionBodies the top-level parse only records
+ *              the token range of every function body by matching braces,
+ *              the FUNCTION_DECL nodes get no body until
+ *              ASTParser_ParseFunctionBody asks for it. The lexer then
+ *              keeps every token of the unit until the parser moves on,
+ *              as it does with keepTokens.
+ *
+ *              With a module and a strategy that lowers, bodies are lowered
+ *              to IR while they are read, for builds that do not optimize:
+ *              their FUNCTION_DECL nodes get no body and
+ *              ASTParser_GetFunctionIR finds the definition. A body the
+ *              strategy cannot lower is parsed as usual. lazyFunctionBodies
+ *              is ignored then.
+ *
+ * @param parser[in] Parser handle
+ * @param node[out] TRANSLATION_UNIT node
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_STRATEGY : The strategy cannot parse declarations
+ *      Parse error : First error, see ASTParser_GetError
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_Parse(
+    ASTParser parser,
+    ASTNode* node);
+
+/**
+ * @brief Get the body of a function definition, parsing a skipped body now
+ *
+ * @description Skipped bodies are parsed at file scope as it stands at the
+ *              end of the unit, so they also see declarations that follow
+ *              the function. A body is parsed at most once.
+ *
+ * @param parser[in] Parser handle
+ * @param function[in] FUNCTION_DECL node
+ * @param body[out] Body node
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : Not a function definition
+ *      PARSER_ERROR_INVALID_STRATEGY : The strategy cannot parse function bodies
+ *      Parse error : First error in the body
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_ParseFunctionBody(
+    ASTParser parser,
+    ASTNode function,
+    ASTNode* body);
+
+/**
+ * @brief Parse every skipped function body, on several threads
+ *
+ * @description Bodies are handed out to the threads in source order and
+ *              threads that run out steal half of the bodies another one
+ *              has left. Each thread builds nodes, block scope symbols and
+ *              new types in overlays of the tables of the unit, which it
+ *              only reads. The overlays are merged back one body at a
+ *              time in source order, so ids and results do not depend on
+ *              the thread count and equal those of ASTParser_ParseFunctionBody
+ *              called for every body in order.
+ *
+ *              Parsing stops at the first body with an error: the bodies
+ *              before it are attached, the error is recorded and the rest
+ *              stay skipped.
+ *
+ * @param parser[in] Parser handle
+ * @param threadCount[in] Threads to use, 0 for one per processor
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : The translation unit was not parsed to the end
+ *      PARSER_ERROR_INVALID_STRATEGY : The strategy cannot parse function bodies
+ *      PARSER_ERROR_UNSUPPORTED : An arena is installed as g_parser_allocator_callbacks
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the threads or merge a body
+ *      Parse error : First error, in the first body that has one
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_ParseFunctionBodies(
+    ASTParser parser,
+    uint32_t threadCount);
+
+/**
+ * @brief Get the IR definition of a function whose body was lowered
+ *
+ * @param parser[in] Parser handle
+ * @param function[in] FUNCTION_DECL node
+ *
+ * @return Function handle, NULL when the body was parsed or there is none
+ */
+PARSER_ATTR IRFunction PARSER_CALL ASTParser_GetFunctionIR(
+    const ASTParser parser,
+    ASTNode function);
+
+/**
+ * @brief Get the function body statistics of the current translation unit
+ *
+ * @param parser[in] Parser handle
+ * @param stats[out] Statistics
+ */
+PARSER_ATTR void PARSER_CALL ASTParser_GetStats(
+    const ASTParser parser,
+    ASTParserStats* stats);
 
 // Utility functions
 PARSER_ATTR void PARSER_CALL ASTParser_Advance(
@@ -254,22 +442,37 @@ PARSER_ATTR ASTNode* PARSER_CALL ASTParser_ParseForStatement(
 PARSER_ATTR ASTNode* PARSER_CALL ASTParser_ParseReturnStatement(
     ASTParser* parser);
 
-// Parse expressions (by precedence)
-PARSER_ATTR ASTNode* PARSER_CALL ASTParser_ParseExpression(
-    ASTParser* parser);
-PARSER_ATTR ASTNode* PARSER_CALL ASTParser_ParseAssignmentExpression(
-    ASTParser* parser);
-PARSER_ATTR ASTNode* PARSER_CALL ASTParser_ParseConditionalExpression(
-    ASTParser* parser);
-PARSER_ATTR ASTNode* PARSER_CALL ASTParser_ParseBinaryExpression(
-    ASTParser* parser,
-    int precedence);
-PARSER_ATTR ASTNode* PARSER_CALL ASTParser_ParseUnaryExpression(
-    ASTParser* parser);
-PARSER_ATTR ASTNode* PARSER_CALL ASTParser_ParsePrimaryExpression(
-    ASTParser* parser);
-PARSER_ATTR ASTNode* PARSER_CALL ASTParser_ParsePostfixExpression(
-    ASTParser* parser);
+/**
+ * @brief Parse an expression
+ *
+ * @description Operators are parsed by the strategy in a single
+ *              precedence-climbing loop, not one call per precedence level.
+ *
+ * @param parser[in] Parser handle
+ * @param precedence[in] Minimum operator precedence, 0 for a full expression
+ *                       (e.g. C_PREC_ASSIGNMENT to stop at a comma)
+ * @param node[out] Expression node
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_STRATEGY : The strategy cannot parse expressions
+ *      PARSER_ERROR_UNEXPECTED_TOKEN : No expression at the current token
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_ParseExpression(
+    ASTParser parser,
+    int precedence,
+    ASTNode* node);
+
+/**
+ * @brief Get the first error of the current translation unit
+ *
+ * @param parser[in] Parser handle
+ * @param token[out] Token index of the error, may be NULL
+ *
+ * @return First error, PARSER_RESULT_SUCCESS when there is none
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_GetError(
+    const ASTParser parser,
+    uint32_t* token);
 
 // ------------------------------------------------------------------------------------------------
 #endif // !
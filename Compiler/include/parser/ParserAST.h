@@ -0,0 +1,467 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_AST_H
+#define PARSER_AST_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCore.h"
+#include "Results.h"
+
+#include <stdbool.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(ASTTree)
+PARSER_CORE_DEFINE_HANDLE(ASTNode)
+
+typedef enum ParserASTNodeType {
+    AST_NODE_TYPE_NONE = 0,
+
+    // ===== Declarations =====
+    AST_NODE_TYPE_TRANSLATION_UNIT,      // root of the AST (entire file)
+    AST_NODE_TYPE_FUNCTION_DECL,         // function declaration/definition
+    AST_NODE_TYPE_VARIABLE_DECL,         // variable declaration
+    AST_NODE_TYPE_PARAMETER_DECL,        // function parameter
+    AST_NODE_TYPE_STRUCT_DECL,           // struct declaration
+    AST_NODE_TYPE_UNION_DECL,            // union declaration
+    AST_NODE_TYPE_ENUM_DECL,             // enum declaration
+    AST_NODE_TYPE_TYPEDEF_DECL,          // typedef declaration
+
+    // ===== Type Specifiers =====
+    AST_NODE_TYPE_TYPE_SPECIFIER,        // int, float, char, etc.
+    AST_NODE_TYPE_POINTER_TYPE,          // pointer type (int*)
+    AST_NODE_TYPE_ARRAY_TYPE,            // array type (int[10])
+    AST_NODE_TYPE_FUNCTION_TYPE,         // function type signature
+
+    // ===== Statements =====
+    AST_NODE_TYPE_COMPOUND_STMT,         // block/scope { ... }
+    AST_NODE_TYPE_EXPRESSION_STMT,       // expression statement (x = 5;)
+    AST_NODE_TYPE_RETURN_STMT,           // return statement
+    AST_NODE_TYPE_IF_STMT,               // if statement
+    AST_NODE_TYPE_WHILE_STMT,            // while loop
+    AST_NODE_TYPE_DO_WHILE_STMT,         // do-while loop
+    AST_NODE_TYPE_FOR_STMT,              // for loop
+    AST_NODE_TYPE_SWITCH_STMT,           // switch statement
+    AST_NODE_TYPE_CASE_STMT,             // case label
+    AST_NODE_TYPE_DEFAULT_STMT,          // default label
+    AST_NODE_TYPE_BREAK_STMT,            // break statement
+    AST_NODE_TYPE_CONTINUE_STMT,         // continue statement
+    AST_NODE_TYPE_GOTO_STMT,             // goto statement
+    AST_NODE_TYPE_LABEL_STMT,            // label for goto
+
+    // ===== Expressions =====
+    AST_NODE_TYPE_BINARY_EXPR,           // binary operations (a + b, a * b, etc.)
+    AST_NODE_TYPE_UNARY_EXPR,            // unary operations (++a, -x, *ptr, &var)
+    AST_NODE_TYPE_TERNARY_EXPR,          // ternary conditional (a ? b : c)
+    AST_NODE_TYPE_CALL_EXPR,             // function call
+    AST_NODE_TYPE_CAST_EXPR,             // type cast
+    AST_NODE_TYPE_ASSIGNMENT_EXPR,       // assignment (=, +=, -=, etc.)
+    AST_NODE_TYPE_MEMBER_EXPR,           // struct/union member access (obj.member)
+    AST_NODE_TYPE_ARROW_EXPR,            // pointer member access (ptr->member)
+    AST_NODE_TYPE_ARRAY_SUBSCRIPT_EXPR,  // array subscript (arr[i])
+    AST_NODE_TYPE_SIZEOF_EXPR,           // sizeof operator
+    AST_NODE_TYPE_COMMA_EXPR,            // comma operator (a, b, c)
+
+    // ===== Literals & Identifiers =====
+    AST_NODE_TYPE_INTEGER_LITERAL,       // integer constant
+    AST_NODE_TYPE_FLOAT_LITERAL,         // floating-point constant
+    AST_NODE_TYPE_STRING_LITERAL,        // string literal
+    AST_NODE_TYPE_CHAR_LITERAL,          // character literal
+    AST_NODE_TYPE_IDENTIFIER,            // identifier reference
+
+    // ===== Initialization =====
+    AST_NODE_TYPE_INITIALIZER,           // variable initializer
+    AST_NODE_TYPE_INITIALIZER_LIST,      // initializer list { a, b, c }
+
+    // ===== Preprocessor (optional, if tracking) =====
+    AST_NODE_TYPE_MACRO_EXPANSION,       // macro expansion node
+
+    AST_NODE_TYPE_COUNT                  // total count of node types
+} ParserASTNodeType;
+
+/**
+ * @brief Index of a node in its ASTTree, AST_NODE_ID_NONE for no node
+ */
+typedef uint32_t ASTNodeId;
+
+#define AST_NODE_ID_NONE                0u
+#define AST_TREE_INITIAL_CAPACITY       256u
+
+/*
+ * Declaration nodes (variables, functions, typedefs) keep the kind of their
+ * symbol in the low byte of the subtype and the storage class of the
+ * language in the high byte.
+ */
+#define AST_DECL_SUBTYPE(kind, storage) ((uint16_t)((kind) | ((storage) << 8)))
+#define AST_DECL_SUBTYPE_KIND(subtype)  ((uint32_t)(subtype) & 0xFFu)
+#define AST_DECL_SUBTYPE_STORAGE(subtype) ((uint32_t)(subtype) >> 8)
+
+/*
+ * ASTNode handles are a view over node ids, a NULL handle is no node. The
+ * handle is only meaningful together with the tree that issued it.
+ */
+#define AST_NODE_FROM_ID(id)            ((ASTNode)(uintptr_t)(id))
+#define AST_NODE_TO_ID(node)            ((ASTNodeId)(uintptr_t)(node))
+
+/**
+ * @brief How a node type stores its children
+ */
+typedef enum ASTNodeLayout {
+    AST_NODE_LAYOUT_LEAF = 0,           // No children, data is a free payload
+    AST_NODE_LAYOUT_UNARY,              // data.lhs is the child, data.rhs a free payload
+    AST_NODE_LAYOUT_BINARY,             // data.lhs and data.rhs are the children
+    AST_NODE_LAYOUT_LIST,               // extra[data.lhs .. data.lhs + data.rhs) are the children
+    AST_NODE_LAYOUT_FIXED,              // extra[data.lhs ..) holds a fixed number of children
+} ASTNodeLayout;
+
+/**
+ * @brief What a data word holds when it is not a child
+ */
+typedef enum ASTNodePayload {
+    AST_NODE_PAYLOAD_VALUE = 0,         // Token, literal index, name, flag or count
+    AST_NODE_PAYLOAD_SYMBOL,            // ASTSymbolId
+    AST_NODE_PAYLOAD_TYPE,              // ASTTypeId
+} ASTNodePayload;
+
+/**
+ * @brief Two 32-bit words of node data, meaning depends on the layout
+ */
+typedef struct ASTNodeData_T {
+    uint32_t lhs;
+    uint32_t rhs;
+} ASTNodeData;
+
+/**
+ * @brief Read-only view of the node arrays
+ *
+ * @description All arrays are indexed by ASTNodeId - firstNode, entry 0 of
+ *              a tree is the unused none node. Traversals can scan them
+ *              directly.
+ */
+typedef struct ASTTreeView_T {
+    const uint8_t* types;               // ParserASTNodeType
+    const uint16_t* subtypes;           // Operator or specifier kind, by node type
+    const uint32_t* mainTokens;         // Token index the node is anchored at
+    const ASTNodeData* data;
+    const uint32_t* extra;              // Child lists and fixed child tuples
+    uint32_t firstNode;                 // Id of entry 0, past 0 only for overlays
+    uint32_t nodeCount;                 // Entries, the none node of a tree included
+    uint32_t extraCount;
+} ASTTreeView;
+
+/**
+ * @brief Position in an overlay, the nodes added between two marks are merged together
+ */
+typedef struct ASTTreeMark_T {
+    uint32_t node;                      // Id of the next node
+    uint32_t extra;                     // Next extra-data index
+    uint32_t patch;                     // Next write to a parent node
+} ASTTreeMark;
+
+/**
+ * @brief Where the symbols and types of merged nodes went
+ *
+ * @description Payload words in [first, end) are translated, anything else
+ *              is kept as it is.
+ */
+typedef struct ASTTreeMergeMap_T {
+    uint32_t symbolFirst;               // First symbol created together with the nodes
+    uint32_t symbolEnd;
+    uint32_t symbolTarget;              // Id of `symbolFirst` in the target symbol table
+    uint32_t typeFirst;                 // First type created together with the nodes
+    uint32_t typeEnd;
+    const uint32_t* types;              // Target id of every such type, by id - typeFirst
+} ASTTreeMergeMap;
+
+/**
+ * @brief Create an empty tree
+ *
+ * @description Nodes live in parallel arrays indexed by 32-bit ids. Node
+ *              types are packed in a byte array, children are either stored
+ *              inline in the node data or in one contiguous extra-data array.
+ *
+ * @param capacity[in] Initial node capacity, 0 for AST_TREE_INITIAL_CAPACITY
+ * @param tree[out] Pointer to the tree handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the tree
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateASTTree(
+    uint32_t capacity,
+    ASTTree* tree);
+
+/**
+ * @brief Create an overlay over a tree
+ *
+ * @description The overlay numbers its nodes after those of `parent` and
+ *              reads parent nodes through to it, so code building nodes
+ *              cannot tell the two apart. The parent is never written:
+ *              data set on a parent node is kept by the overlay and only
+ *              applied by ASTTree_Merge. Several overlays may share a
+ *              parent across threads as long as nobody adds to it.
+ *
+ * @param parent[in] Tree below the overlay
+ * @param capacity[in] Initial node capacity, 0 for AST_TREE_INITIAL_CAPACITY
+ * @param tree[out] Pointer to the overlay handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the overlay
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateASTTreeOverlay(
+    const ASTTree parent,
+    uint32_t capacity,
+    ASTTree* tree);
+
+/**
+ * @brief Destroy the tree and its arrays
+ *
+ * @param tree[in] Tree handle
+ */
+PARSER_ATTR void PARSER_CALL ASTTreeDestroy(
+    ASTTree tree);
+
+/**
+ * @brief Remove all nodes, keeping the storage
+ *
+ * @param tree[in] Tree handle
+ */
+PARSER_ATTR void PARSER_CALL ASTTree_Reset(
+    ASTTree tree);
+
+/**
+ * @brief Append a node
+ *
+ * @param tree[in] Tree handle
+ * @param type[in] Node type
+ * @param subtype[in] Operator or specifier kind
+ * @param mainToken[in] Token index the node is anchored at
+ * @param data[in] Children or payload, see ASTNodeType_GetLayout
+ * @param id[out] Id of the new node
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the node arrays
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_AddNode(
+    ASTTree tree,
+    ParserASTNodeType type,
+    uint16_t subtype,
+    uint32_t mainToken,
+    ASTNodeData data,
+    ASTNodeId* id);
+
+/**
+ * @brief Append values to the extra-data array
+ *
+ * @param tree[in] Tree handle
+ * @param values[in] Values to append
+ * @param count[in] Number of values
+ * @param start[out] Index of the first appended value
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the extra-data array
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_AddExtra(
+    ASTTree tree,
+    const uint32_t* values,
+    uint32_t count,
+    uint32_t* start);
+
+/**
+ * @brief Append a node whose children go to the extra-data array
+ *
+ * @description For AST_NODE_LAYOUT_LIST and AST_NODE_LAYOUT_FIXED types.
+ *              `count` must match ASTNodeType_GetFixedChildCount for fixed
+ *              layouts, absent children are AST_NODE_ID_NONE.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : Type does not store children in extra data
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the arrays
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_AddListNode(
+    ASTTree tree,
+    ParserASTNodeType type,
+    uint16_t subtype,
+    uint32_t mainToken,
+    const ASTNodeId* children,
+    uint32_t count,
+    ASTNodeId* id);
+
+/**
+ * @brief Remove the newest nodes, from `first` on
+ *
+ * @description For nodes that were just added and are referenced by
+ *              nothing, e.g. operands folded into a constant. Extra data
+ *              is kept.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `first` is past the last node, or a node of the parent of an overlay
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_Truncate(
+    ASTTree tree,
+    ASTNodeId first);
+
+/**
+ * @brief Replace the data of a node, for nodes added before their children
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : Unknown node
+ *      PARSER_ERROR_NO_MEMORY : An overlay could not record the write
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_SetData(
+    ASTTree tree,
+    ASTNodeId id,
+    ASTNodeData data);
+
+/**
+ * @brief Replace a child of a node, e.g. a function body parsed after its declaration
+ *
+ * @description The slot must exist, list nodes keep their child count.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : No such slot, or a list or fixed slot of a parent node
+ *      PARSER_ERROR_NO_MEMORY : An overlay could not record the write
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_SetChild(
+    ASTTree tree,
+    ASTNodeId id,
+    uint32_t index,
+    ASTNodeId child);
+
+/**
+ * @brief Get a read-only view of the node arrays
+ *
+ * @description Invalidated by any call that adds nodes or extra data.
+ *
+ * @param tree[in] Tree handle
+ * @param view[out] View of the arrays
+ */
+PARSER_ATTR void PARSER_CALL ASTTree_GetView(
+    const ASTTree tree,
+    ASTTreeView* view);
+
+/**
+ * @brief Get the current position of a tree or overlay
+ */
+PARSER_ATTR void PARSER_CALL ASTTree_GetMark(
+    const ASTTree tree,
+    ASTTreeMark* mark);
+
+/**
+ * @brief Append the nodes an overlay added between two marks to its parent
+ *
+ * @description The nodes keep their order and get the next ids of `tree`.
+ *              Children in the range follow them, children in the parent
+ *              stay, symbol and type payloads are translated by `map`.
+ *              Data the overlay set on parent nodes in the same range is
+ *              written to them. The nodes must only refer to nodes of the
+ *              range or of the parent.
+ *
+ * @param tree[in] Parent of the overlay
+ * @param overlay[in] Overlay holding the nodes
+ * @param begin[in] Mark taken before the nodes were added
+ * @param end[in] Mark taken after
+ * @param map[in] Symbols and types of the nodes in the target tables
+ * @param first[out] Id of the first merged node, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `tree` is not the parent, or the marks are out of order
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the arrays
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_Merge(
+    ASTTree tree,
+    const ASTTree overlay,
+    const ASTTreeMark* begin,
+    const ASTTreeMark* end,
+    const ASTTreeMergeMap* map,
+    ASTNodeId* first);
+
+/**
+ * @brief Get the number of node ids in use, the none node and the parent of an overlay included
+ */
+PARSER_ATTR uint32_t PARSER_CALL ASTTree_GetNodeCount(
+    const ASTTree tree);
+
+PARSER_ATTR ParserASTNodeType PARSER_CALL ASTTree_GetNodeType(
+    const ASTTree tree,
+    ASTNodeId id);
+
+PARSER_ATTR uint16_t PARSER_CALL ASTTree_GetSubtype(
+    const ASTTree tree,
+    ASTNodeId id);
+
+PARSER_ATTR uint32_t PARSER_CALL ASTTree_GetMainToken(
+    const ASTTree tree,
+    ASTNodeId id);
+
+PARSER_ATTR ASTNodeData PARSER_CALL ASTTree_GetData(
+    const ASTTree tree,
+    ASTNodeId id);
+
+/**
+ * @brief Get the number of child slots of a node, absent children included
+ */
+PARSER_ATTR uint32_t PARSER_CALL ASTTree_GetChildCount(
+    const ASTTree tree,
+    ASTNodeId id);
+
+/**
+ * @brief Get a child of a node
+ *
+ * @return Child id, AST_NODE_ID_NONE when absent or out of range
+ */
+PARSER_ATTR ASTNodeId PARSER_CALL ASTTree_GetChild(
+    const ASTTree tree,
+    ASTNodeId id,
+    uint32_t index);
+
+/**
+ * @brief Get the number of child slots of a node of a view
+ */
+PARSER_ATTR uint32_t PARSER_CALL ASTTreeView_GetChildCount(
+    const ASTTreeView* view,
+    ASTNodeId id);
+
+/**
+ * @brief Get a child of a node of a view
+ *
+ * @description For views of a tree and of an image, which need no handle.
+ *
+ * @return Child id, AST_NODE_ID_NONE when absent or out of range
+ */
+PARSER_ATTR ASTNodeId PARSER_CALL ASTTreeView_GetChild(
+    const ASTTreeView* view,
+    ASTNodeId id,
+    uint32_t index);
+
+/**
+ * @brief Get how a node type stores its children
+ */
+PARSER_ATTR ASTNodeLayout PARSER_CALL ASTNodeType_GetLayout(
+    ParserASTNodeType type);
+
+/**
+ * @brief Get the number of children of a fixed layout type, 0 otherwise
+ */
+PARSER_ATTR uint32_t PARSER_CALL ASTNodeType_GetFixedChildCount(
+    ParserASTNodeType type);
+
+/**
+ * @brief Get what a data word of a node type holds when it is not a child
+ *
+ * @param type[in] Node type
+ * @param word[in] 0 for data.lhs, 1 for data.rhs
+ */
+PARSER_ATTR ASTNodePayload PARSER_CALL ASTNodeType_GetPayload(
+    ParserASTNodeType type,
+    uint32_t word);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !PARSER_AST_H
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,177 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_ARENA_H
+#define PARSER_ARENA_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserCore.h"
+#include "parser/Results.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(ParserArena)
+
+#define PARSER_ARENA_DEFAULT_CHUNK_SIZE    (256u * 1024u)
+#define PARSER_ARENA_SIZE_CLASS_COUNT      8u
+#define PARSER_ARENA_MAX_POOLED_SIZE       256u
+
+/**
+ * @brief Allocation counters
+ *
+ * @description Kept by the default heap callbacks and by every arena, so
+ *              a parse with either can be compared.
+ */
+typedef struct ParserAllocationStats_T {
+    int64_t allocations;        // Allocation calls
+    int64_t frees;              // Free calls, no-ops on an arena unless pooled
+    int64_t bytesRequested;     // Sum of the requested sizes
+    int64_t bytesReserved;      // Bytes currently taken from the system
+    int64_t bytesPeak;          // Highest bytesReserved seen
+    int64_t chunks;             // Arena chunks, 0 for the heap
+    int64_t poolReuses;         // Pooled allocations served from a free list
+} ParserAllocationStats;
+
+typedef struct ParserArenaConfig_T {
+    size_t chunkSize;           // Bytes per chunk, 0 for PARSER_ARENA_DEFAULT_CHUNK_SIZE
+
+    // Where the chunks come from, NULL for the default heap callbacks. Must
+    // not be the callbacks of the arena itself.
+    const ParserAllocationCallbacks* parent;
+} ParserArenaConfig;
+
+/**
+ * @brief Create a region allocator
+ *
+ * @description Bump-pointer allocation out of large chunks. Individual
+ *              allocations are never freed, the whole region is released at
+ *              once by ParserArena_Reset or ParserArena_Destroy. Objects that
+ *              do die early can use the size-class pools instead.
+ *
+ * @param cfg[in] Arena configuration, may be NULL for the defaults
+ * @param arena[out] Pointer to the arena handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the arena
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserArena_Create(
+    const ParserArenaConfig* cfg,
+    ParserArena* arena);
+
+/**
+ * @brief Allocate from the region
+ *
+ * @param arena[in] Arena handle
+ * @param size[in] Size in bytes
+ * @param alignment[in] Power of two, 0 for the default alignment of 16
+ *
+ * @return Uninitialized storage, or NULL when out of memory
+ */
+PARSER_ATTR void* PARSER_CALL ParserArena_Alloc(
+    ParserArena arena,
+    size_t size,
+    size_t alignment);
+
+/**
+ * @brief Allocate from the size-class pool for `size`
+ *
+ * @description Sizes above PARSER_ARENA_MAX_POOLED_SIZE fall through to
+ *              ParserArena_Alloc.
+ *
+ * @return Uninitialized storage, or NULL when out of memory
+ */
+PARSER_ATTR void* PARSER_CALL ParserArena_AllocPooled(
+    ParserArena arena,
+    size_t size);
+
+/**
+ * @brief Return pooled storage for reuse by allocations of the same size class
+ *
+ * @param arena[in] Arena handle
+ * @param memory[in] Storage from ParserArena_AllocPooled
+ * @param size[in] Size passed to ParserArena_AllocPooled
+ */
+PARSER_ATTR void PARSER_CALL ParserArena_FreePooled(
+    ParserArena arena,
+    void* memory,
+    size_t size);
+
+/**
+ * @brief Release everything allocated from the arena
+ *
+ * @description Constant time. The chunks are kept and reused by later
+ *              allocations.
+ *
+ * @param arena[in] Arena handle
+ */
+PARSER_ATTR void PARSER_CALL ParserArena_Reset(
+    ParserArena arena);
+
+/**
+ * @brief Destroy the arena and return its chunks to the parent allocator
+ *
+ * @param arena[in] Arena handle
+ */
+PARSER_ATTR void PARSER_CALL ParserArena_Destroy(
+    ParserArena arena);
+
+/**
+ * @brief Get the allocation counters of the arena
+ *
+ * @param arena[in] Arena handle
+ * @param stats[out] Counters
+ */
+PARSER_ATTR void PARSER_CALL ParserArena_GetStats(
+    const ParserArena arena,
+    ParserAllocationStats* stats);
+
+/**
+ * @brief Get allocation callbacks that allocate from the arena
+ *
+ * @description Install them in g_parser_allocator_callbacks to route
+ *              PARSER_MALLOC into the arena. PARSER_MALLOC only goes
+ *              through the callbacks in builds with PARSER_DEBUG_ALLOCATORS,
+ *              which the Debug configuration defines. pfnFree is a counted
+ *              no-op.
+ *
+ *              An arena is not thread safe. LexerTokenizeParallel and
+ *              ASTParser_ParseFunctionBodies allocate on worker threads,
+ *              they return PARSER_ERROR_UNSUPPORTED while an arena is
+ *              installed globally.
+ *
+ * @param arena[in] Arena handle
+ * @param callbacks[out] Callbacks with the arena as user data
+ */
+PARSER_ATTR void PARSER_CALL ParserArena_GetCallbacks(
+    ParserArena arena,
+    ParserAllocationCallbacks* callbacks);
+
+/**
+ * @brief Get the default heap callbacks
+ *
+ * @description malloc/free with allocation counters. This is what
+ *              g_parser_allocator_callbacks points to initially.
+ */
+PARSER_ATTR const ParserAllocationCallbacks* PARSER_CALL ParserGetDefaultAllocationCallbacks(void);
+
+/**
+ * @brief Get the counters of the default heap callbacks
+ *
+ * @description PARSER_MALLOC reaches the default callbacks only in builds
+ *              with PARSER_DEBUG_ALLOCATORS, other builds call malloc
+ *              directly and the counters stay at zero.
+ *
+ * @param stats[out] Counters
+ */
+PARSER_ATTR void PARSER_CALL ParserGetDefaultAllocationStats(
+    ParserAllocationStats* stats);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !PARSER_ARENA_H
+// ------------------------------------------------------------------------------------------------
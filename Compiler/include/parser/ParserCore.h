@@ -59,6 +59,15 @@
 #define ML_ALIGN(n)
 #endif
 
+// Inlining macros
+#if defined(__GNUC__) || defined(__clang__)
+#define ML_FORCE_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define ML_FORCE_INLINE static __forceinline
+#else
+#define ML_FORCE_INLINE static inline
+#endif
+
 // ----------------------------------------------------------------
 // Memory Management Hooks
 // ----------------------------------------------------------------
@@ -0,0 +1,228 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_IMAGE_H
+#define PARSER_IMAGE_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "Parser.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+/*
+ * An image is the parsed translation unit as one block of memory. Every
+ * array of the tree and the tables is stored as it is in memory and found
+ * through offsets from the start of the image, never pointers, so a mapped
+ * file is used in place: opening an image checks the header and sets a few
+ * pointers, it allocates and rewrites nothing.
+ *
+ * Ids in an image are the ids of the unit it was written from. Images are
+ * native: same byte order and record layouts, the header rejects others.
+ */
+#define AST_IMAGE_MAGIC                 0x49414C4Cu     // "LLAI"
+#define AST_IMAGE_VERSION               1u
+#define AST_IMAGE_ALIGNMENT             8u              // Of the image and of every section
+
+typedef enum ASTImageSectionKind {
+    AST_IMAGE_SECTION_NODE_TYPES = 0,   // uint8_t per node
+    AST_IMAGE_SECTION_NODE_SUBTYPES,    // uint16_t per node
+    AST_IMAGE_SECTION_NODE_TOKENS,      // Main token index per node
+    AST_IMAGE_SECTION_NODE_DATA,        // ASTNodeData per node
+    AST_IMAGE_SECTION_EXTRA,            // Child lists, uint32_t
+    AST_IMAGE_SECTION_LOCATIONS,        // ASTImageLocation per node
+    AST_IMAGE_SECTION_IDENTIFIERS,      // ASTImageString per identifier id
+    AST_IMAGE_SECTION_STRINGS,          // NUL terminated text of identifiers and spellings
+    AST_IMAGE_SECTION_SPELLINGS,        // ASTImageSpelling, sorted by node
+    AST_IMAGE_SECTION_LITERALS,         // LexerLiteral per numeric literal index
+    AST_IMAGE_SECTION_SYMBOLS,          // ASTSymbolInfo per symbol id
+    AST_IMAGE_SECTION_TYPES,            // ASTTypeInfo per type id
+    AST_IMAGE_SECTION_TYPE_PARAMS,      // Parameter lists of the function types, ASTTypeId
+
+    AST_IMAGE_SECTION_COUNT
+} ASTImageSectionKind;
+
+typedef struct ASTImageSection_T {
+    uint32_t offset;                    // Bytes from the start of the image
+    uint32_t count;                     // Elements
+    uint32_t stride;                    // Bytes per element
+} ASTImageSection;
+
+typedef struct ASTImageHeader_T {
+    uint32_t magic;                     // AST_IMAGE_MAGIC
+    uint32_t version;                   // AST_IMAGE_VERSION
+    uint32_t size;                      // Bytes of the whole image
+    ASTNodeId root;                     // Node the image was written for
+    ASTImageSection sections[AST_IMAGE_SECTION_COUNT];
+} ASTImageHeader;
+
+/**
+ * @brief Source position of the main token of a node
+ */
+typedef struct ASTImageLocation_T {
+    uint32_t line;
+    uint32_t column;
+} ASTImageLocation;
+
+/**
+ * @brief Text in the string section
+ */
+typedef struct ASTImageString_T {
+    uint32_t offset;                    // Bytes from the start of the string section
+    uint32_t length;                    // Without the NUL
+} ASTImageString;
+
+/**
+ * @brief Source spelling of a literal whose value is only in its tokens
+ *
+ * @description String literals (all adjacent pieces) and character literals.
+ */
+typedef struct ASTImageSpelling_T {
+    ASTNodeId node;
+    ASTImageString text;
+} ASTImageSpelling;
+
+/**
+ * @brief Opened image, pointers into the image memory
+ */
+typedef struct ASTImage_T {
+    const ASTImageHeader* header;
+    ASTTreeView tree;                   // Node arrays, indexed by node id
+    ASTNodeId root;
+
+    const ASTImageLocation* locations;
+    const ASTImageString* identifiers;
+    uint32_t identifierCount;           // Ids, the none id included
+    const char* strings;
+    const ASTImageSpelling* spellings;
+    uint32_t spellingCount;
+    const LexerLiteral* literals;
+    uint32_t literalCount;
+    const ASTSymbolInfo* symbols;
+    uint32_t symbolCount;               // Ids, the none symbol included
+    const ASTTypeInfo* types;           // Function types: value indexes typeParams
+    uint32_t typeCount;                 // Ids, the none type included
+    const ASTTypeId* typeParams;
+    uint32_t typeParamCount;
+} ASTImage;
+
+/**
+ * @brief Write the current translation unit as an image
+ *
+ * @description The image holds the whole tree with the identifier, symbol
+ *              and type tables, plus what the nodes need from the tokens:
+ *              the location of every node, the numeric literal table and
+ *              the spelling of string and character literals. The parser
+ *              must keep its tokens (keepTokens or lazyFunctionBodies).
+ *              Bodies that are still skipped are written without a body.
+ *
+ *              Call with a NULL buffer to get the size first.
+ *
+ * @param parser[in] Parser handle
+ * @param root[in] Node to record as the root, usually the TRANSLATION_UNIT
+ * @param buffer[out] Image memory aligned to AST_IMAGE_ALIGNMENT, may be NULL
+ * @param capacity[in] Bytes of `buffer`
+ * @param size[out] Bytes of the image
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : The parser dropped its tokens, or `buffer` is too small or misaligned
+ *      PARSER_ERROR_NO_MEMORY : The image would not fit in 32-bit offsets
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_WriteImage(
+    const ASTParser parser,
+    ASTNode root,
+    void* buffer,
+    size_t capacity,
+    size_t* size);
+
+/**
+ * @brief Open an image in memory, e.g. a mapped file
+ *
+ * @description Costs the same for any image size: the header and section
+ *              bounds are checked, the contents are trusted. The memory
+ *              must stay valid and unchanged while the image is used.
+ *
+ * @param data[in] Image memory aligned to AST_IMAGE_ALIGNMENT
+ * @param size[in] Bytes available at `data`
+ * @param image[out] Opened image
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `data` or `image` is NULL
+ *      PARSER_ERROR_INVALID_FILE : Not an image of this version and layout, or truncated
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTImage_Open(
+    const void* data,
+    size_t size,
+    ASTImage* image);
+
+/**
+ * @brief Get the text of an identifier
+ *
+ * @param length[out] Length in bytes, may be NULL
+ *
+ * @return NUL terminated text, NULL for PARSER_IDENTIFIER_NONE and unknown ids
+ */
+PARSER_ATTR const char* PARSER_CALL ASTImage_GetIdentifier(
+    const ASTImage* image,
+    ParserIdentifierId id,
+    uint32_t* length);
+
+/**
+ * @brief Get the source spelling of a string or character literal node
+ *
+ * @param length[out] Length in bytes, may be NULL
+ *
+ * @return NUL terminated spelling, NULL when the node has none
+ */
+PARSER_ATTR const char* PARSER_CALL ASTImage_GetSpelling(
+    const ASTImage* image,
+    ASTNodeId node,
+    uint32_t* length);
+
+/**
+ * @brief Get the source position of a node, line and column 0 for unknown nodes
+ */
+PARSER_ATTR ASTImageLocation PARSER_CALL ASTImage_GetLocation(
+    const ASTImage* image,
+    ASTNodeId node);
+
+/**
+ * @brief Get a numeric literal by the index its node stores
+ *
+ * @description Only for literal nodes of subtype 0, folded ones hold their value.
+ */
+PARSER_ATTR const LexerLiteral* PARSER_CALL ASTImage_GetLiteral(
+    const ASTImage* image,
+    uint32_t index);
+
+/**
+ * @brief Get a symbol record, NULL for AST_SYMBOL_ID_NONE and unknown ids
+ */
+PARSER_ATTR const ASTSymbolInfo* PARSER_CALL ASTImage_GetSymbol(
+    const ASTImage* image,
+    ASTSymbolId id);
+
+/**
+ * @brief Get a type record, NULL for AST_TYPE_ID_NONE and unknown ids
+ */
+PARSER_ATTR const ASTTypeInfo* PARSER_CALL ASTImage_GetType(
+    const ASTImage* image,
+    ASTTypeId id);
+
+/**
+ * @brief Get the parameter types of a function type
+ *
+ * @return `count` type ids, or NULL when the type has no parameters
+ */
+PARSER_ATTR const ASTTypeId* PARSER_CALL ASTImage_GetTypeParams(
+    const ASTImage* image,
+    ASTTypeId id);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !PARSER_IMAGE_H
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,134 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_INTERNER_H
+#define PARSER_INTERNER_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCore.h"
+#include "Results.h"
+#include "ParserArena.h"
+
+#include <stdbool.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(ParserInterner)
+
+/**
+ * @brief Dense id of an interned identifier, PARSER_IDENTIFIER_NONE for none
+ *
+ * @description Equal spellings get equal ids, so names compare as integers.
+ */
+typedef uint32_t ParserIdentifierId;
+
+#define PARSER_IDENTIFIER_NONE          0u
+#define PARSER_INTERNER_INITIAL_SLOTS   1024u
+
+typedef enum ParserIdentifierFlags {
+    PARSER_IDENTIFIER_FLAG_NONE     = 0,
+    PARSER_IDENTIFIER_FLAG_TYPEDEF  = 1 << 0,   // The visible ordinary binding is a typedef name
+} ParserIdentifierFlags;
+
+/**
+ * @brief Interned identifier record
+ */
+typedef struct ParserIdentifier_T {
+    const char* text;           // NUL terminated copy in the interner arena
+    uint32_t length;            // Length in bytes, without the NUL
+    uint32_t hash;
+    uint32_t flags;             // ParserIdentifierFlags, kept current by the symbol table
+} ParserIdentifier;
+
+/**
+ * @brief Create an identifier interner
+ *
+ * @description Open addressing over identifier ids. The spelling of every
+ *              identifier is copied once into `arena`, which must outlive
+ *              the interner or be reset together with it.
+ *
+ * @param arena[in] Arena for the identifier text
+ * @param interner[out] Pointer to the interner handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the interner
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateParserInterner(
+    ParserArena arena,
+    ParserInterner* interner);
+
+/**
+ * @brief Get the id of an identifier, adding it on first sight
+ *
+ * @param interner[in] Interner handle
+ * @param text[in] Spelling, need not be NUL terminated
+ * @param length[in] Length in bytes
+ * @param id[out] Identifier id
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the table or copy the text
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserInterner_Intern(
+    ParserInterner interner,
+    const char* text,
+    uint32_t length,
+    ParserIdentifierId* id);
+
+/**
+ * @brief Get the id of an identifier without adding it
+ *
+ * @return Identifier id, PARSER_IDENTIFIER_NONE when it was never interned
+ */
+PARSER_ATTR ParserIdentifierId PARSER_CALL ParserInterner_Find(
+    const ParserInterner interner,
+    const char* text,
+    uint32_t length);
+
+/**
+ * @brief Get the record of an identifier
+ *
+ * @description Valid until the next ParserInterner_Intern.
+ *
+ * @return Record, or NULL for PARSER_IDENTIFIER_NONE and unknown ids
+ */
+PARSER_ATTR const ParserIdentifier* PARSER_CALL ParserInterner_Get(
+    const ParserInterner interner,
+    ParserIdentifierId id);
+
+/**
+ * @brief Set or clear flags of an identifier
+ *
+ * @param interner[in] Interner handle
+ * @param id[in] Identifier id
+ * @param flags[in] ParserIdentifierFlags to change
+ * @param set[in] Set the flags when true, clear them otherwise
+ */
+PARSER_ATTR void PARSER_CALL ParserInterner_SetFlags(
+    ParserInterner interner,
+    ParserIdentifierId id,
+    uint32_t flags,
+    bool set);
+
+PARSER_ATTR uint32_t PARSER_CALL ParserInterner_GetCount(
+    const ParserInterner interner);
+
+/**
+ * @brief Forget every identifier, keeping the table storage
+ *
+ * @description The text arena is not touched, reset it separately.
+ */
+PARSER_ATTR void PARSER_CALL ParserInterner_Reset(
+    ParserInterner interner);
+
+PARSER_ATTR void PARSER_CALL ParserInternerDestroy(
+    ParserInterner interner);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !PARSER_INTERNER_H
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,278 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_SYMBOL_H
+#define PARSER_SYMBOL_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCore.h"
+#include "Results.h"
+#include "ParserInterner.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(ASTSymbolTable)
+PARSER_CORE_DEFINE_HANDLE(ASTScope)
+PARSER_CORE_DEFINE_HANDLE(ASTSymbol)
+
+/**
+ * @brief Index of a symbol in its table, AST_SYMBOL_ID_NONE for no symbol
+ */
+typedef uint32_t ASTSymbolId;
+
+#define AST_SYMBOL_ID_NONE              0u
+#define AST_SYMBOL_TABLE_INITIAL_SLOTS  1024u
+
+/*
+ * ASTSymbol handles are a view over symbol ids, ASTScope handles over the
+ * scope depth, NULL is none for both.
+ */
+#define AST_SYMBOL_FROM_ID(id)          ((ASTSymbol)(uintptr_t)(id))
+#define AST_SYMBOL_TO_ID(symbol)        ((ASTSymbolId)(uintptr_t)(symbol))
+
+/**
+ * @brief Name spaces of C identifiers (C11 6.2.3)
+ */
+typedef enum ASTSymbolNamespace {
+    AST_NAMESPACE_ORDINARY = 0,         // Objects, functions, typedef names, enumeration constants
+    AST_NAMESPACE_TAG,                  // struct, union and enum tags, shared by all three
+    AST_NAMESPACE_LABEL,                // Labels, function scope
+    AST_NAMESPACE_MEMBER,               // Members, one name space per struct or union
+} ASTSymbolNamespace;
+
+typedef enum ASTSymbolKind {
+    AST_SYMBOL_KIND_NONE = 0,
+    AST_SYMBOL_KIND_VARIABLE,
+    AST_SYMBOL_KIND_FUNCTION,
+    AST_SYMBOL_KIND_PARAMETER,
+    AST_SYMBOL_KIND_TYPEDEF,
+    AST_SYMBOL_KIND_ENUM_CONSTANT,
+    AST_SYMBOL_KIND_STRUCT_TAG,
+    AST_SYMBOL_KIND_UNION_TAG,
+    AST_SYMBOL_KIND_ENUM_TAG,
+    AST_SYMBOL_KIND_LABEL,
+    AST_SYMBOL_KIND_MEMBER,
+} ASTSymbolKind;
+
+typedef enum ASTScopeKind {
+    AST_SCOPE_KIND_FILE = 0,
+    AST_SCOPE_KIND_FUNCTION,            // Outermost block of a function body, owns its labels
+    AST_SCOPE_KIND_BLOCK,
+    AST_SCOPE_KIND_PROTOTYPE,           // Parameter list of a function declarator
+} ASTScopeKind;
+
+/**
+ * @brief Symbol record
+ */
+typedef struct ASTSymbolInfo_T {
+    ParserIdentifierId name;
+    uint32_t node;                      // Declaring ASTNodeId
+    uint32_t type;                      // ASTTypeId of the symbol, 0 until known
+    uint32_t owner;                     // Struct or union tag of a member, 0 otherwise
+    uint32_t shadowed;                  // Binding hidden by this one, restored when its scope ends
+    uint32_t scope;                     // Depth of the declaring scope, 0 is file scope
+    uint16_t space;                     // ASTSymbolNamespace
+    uint16_t kind;                      // ASTSymbolKind
+} ASTSymbolInfo;
+
+/**
+ * @brief Create a symbol table
+ *
+ * @description One open addressing table keyed by (identifier id, name
+ *              space, owner) holds the visible binding of every name. A
+ *              declaration that hides an outer one keeps it in `shadowed`
+ *              and is recorded in the undo log of its scope, so leaving a
+ *              scope restores exactly its own declarations and never
+ *              rehashes. Members are keyed by their struct and stay bound.
+ *
+ *              With an interner, the PARSER_IDENTIFIER_FLAG_TYPEDEF bit of
+ *              every name follows its visible ordinary binding through
+ *              declarations and scope pops.
+ *
+ * @param interner[in] Interner of the names, may be NULL
+ * @param symbols[out] Pointer to the symbol table handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the table
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateASTSymbolTable(
+    ParserInterner interner,
+    ASTSymbolTable* symbols);
+
+/**
+ * @brief Create a symbol table on top of a read-only parent
+ *
+ * @description Names the overlay has not bound resolve in the parent, and
+ *              new symbols get the ids that follow the parent's. The parent
+ *              must not change while the overlay lives, so overlays on one
+ *              parent may be used from different threads. The overlay has
+ *              no interner: typedef names are told apart by looking them
+ *              up. SetType and SetNode ignore symbols of the parent.
+ *
+ * @param parent[in] Symbol table below the overlay
+ * @param symbols[out] Pointer to the overlay handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : parent or symbols is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the overlay
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateASTSymbolTableOverlay(
+    const ASTSymbolTable parent,
+    ASTSymbolTable* symbols);
+
+/**
+ * @brief Remove every scope and symbol, keeping the storage
+ *
+ * @description Typedef bits set by the table are cleared.
+ */
+PARSER_ATTR void PARSER_CALL ASTSymbolTable_Reset(
+    ASTSymbolTable symbols);
+
+PARSER_ATTR void PARSER_CALL ASTSymbolTableDestroy(
+    ASTSymbolTable symbols);
+
+/**
+ * @brief Enter a scope
+ *
+ * @param symbols[in] Symbol table handle
+ * @param kind[in] Kind of the scope
+ * @param scope[out] Handle of the new scope, may be NULL
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the scope stack
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTSymbolTable_PushScope(
+    ASTSymbolTable symbols,
+    ASTScopeKind kind,
+    ASTScope* scope);
+
+/**
+ * @brief Leave the innermost scope
+ *
+ * @description Costs time proportional to the declarations of the scope
+ *              (and the labels of a function scope).
+ *
+ * @param symbols[in] Symbol table handle
+ * @param scope[in] Handle of the innermost scope, NULL to skip the check
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `scope` is not the innermost scope
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTSymbolTable_PopScope(
+    ASTSymbolTable symbols,
+    ASTScope scope);
+
+/**
+ * @brief Get the depth of the innermost scope, 0 is file scope
+ */
+PARSER_ATTR uint32_t PARSER_CALL ASTSymbolTable_GetDepth(
+    const ASTSymbolTable symbols);
+
+/**
+ * @brief Get the kind of the innermost scope
+ */
+PARSER_ATTR ASTScopeKind PARSER_CALL ASTSymbolTable_GetScopeKind(
+    const ASTSymbolTable symbols);
+
+/**
+ * @brief Declare a name in the innermost scope
+ *
+ * @description Labels go to the enclosing function scope, members
+ *              (`owner` != 0) to the name space of their struct or union.
+ *
+ * @param symbols[in] Symbol table handle
+ * @param space[in] Name space
+ * @param name[in] Interned name
+ * @param kind[in] Kind of symbol
+ * @param owner[in] Struct or union tag symbol for members, 0 otherwise
+ * @param node[in] Declaring node
+ * @param id[out] The new symbol, or the existing one on redeclaration
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_REDECLARATION : The name is already declared in the same scope,
+ *                                   the caller decides whether that is compatible
+ *      PARSER_ERROR_INVALID_ARG : Label outside of a function scope
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the table
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTSymbolTable_Declare(
+    ASTSymbolTable symbols,
+    ASTSymbolNamespace space,
+    ParserIdentifierId name,
+    ASTSymbolKind kind,
+    ASTSymbolId owner,
+    uint32_t node,
+    ASTSymbolId* id);
+
+/**
+ * @brief Find the visible binding of a name
+ *
+ * @param symbols[in] Symbol table handle
+ * @param space[in] Name space
+ * @param name[in] Interned name
+ * @param owner[in] Struct or union tag symbol for members, 0 otherwise
+ *
+ * @return Symbol id, AST_SYMBOL_ID_NONE when the name is not visible
+ */
+PARSER_ATTR ASTSymbolId PARSER_CALL ASTSymbolTable_Lookup(
+    const ASTSymbolTable symbols,
+    ASTSymbolNamespace space,
+    ParserIdentifierId name,
+    ASTSymbolId owner);
+
+/**
+ * @brief Append a symbol record without binding its name
+ *
+ * @description Used to move symbols whose scope has already ended, e.g. the
+ *              locals of a function parsed in an overlay, into a table.
+ *
+ * @param symbols[in] Symbol table handle
+ * @param info[in] Record to append, copied as is
+ * @param id[out] Id of the new symbol
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the table
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTSymbolTable_AddRecord(
+    ASTSymbolTable symbols,
+    const ASTSymbolInfo* info,
+    ASTSymbolId* id);
+
+/**
+ * @brief Get a symbol record
+ *
+ * @description Valid until the next declaration.
+ *
+ * @return Record, or NULL for AST_SYMBOL_ID_NONE and unknown ids
+ */
+PARSER_ATTR const ASTSymbolInfo* PARSER_CALL ASTSymbolTable_GetSymbol(
+    const ASTSymbolTable symbols,
+    ASTSymbolId id);
+
+/**
+ * @brief Set the type of a symbol once its declarator is complete
+ */
+PARSER_ATTR void PARSER_CALL ASTSymbolTable_SetType(
+    ASTSymbolTable symbols,
+    ASTSymbolId id,
+    uint32_t type);
+
+/**
+ * @brief Set the declaring node of a symbol, e.g. when a tag gets its definition
+ */
+PARSER_ATTR void PARSER_CALL ASTSymbolTable_SetNode(
+    ASTSymbolTable symbols,
+    ASTSymbolId id,
+    uint32_t node);
+
+PARSER_ATTR uint32_t PARSER_CALL ASTSymbolTable_GetSymbolCount(
+    const ASTSymbolTable symbols);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !PARSER_SYMBOL_H
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,290 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_TYPE_H
+#define PARSER_TYPE_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCore.h"
+#include "Results.h"
+
+#include <stdbool.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(ASTTypeTable)
+PARSER_CORE_DEFINE_HANDLE(ASTType)
+
+/**
+ * @brief Index of a type in its table, AST_TYPE_ID_NONE for no type
+ *
+ * @description Types are hash-consed: two ids are equal exactly when the
+ *              types are identical, qualifiers included.
+ */
+typedef uint32_t ASTTypeId;
+
+#define AST_TYPE_ID_NONE                0u
+#define AST_TYPE_TABLE_INITIAL_SLOTS    1024u
+
+/*
+ * ASTType handles are a view over type ids, a NULL handle is no type.
+ */
+#define AST_TYPE_FROM_ID(id)            ((ASTType)(uintptr_t)(id))
+#define AST_TYPE_TO_ID(type)            ((ASTTypeId)(uintptr_t)(type))
+
+typedef enum ASTTypeKind {
+    AST_TYPE_KIND_NONE = 0,
+    AST_TYPE_KIND_BASIC,                // value is the language basic type
+    AST_TYPE_KIND_POINTER,              // base is the pointee
+    AST_TYPE_KIND_ARRAY,                // base is the element, value the length or size expression
+    AST_TYPE_KIND_FUNCTION,             // base is the return type, count parameters from value
+    AST_TYPE_KIND_STRUCT,               // value is the tag identity
+    AST_TYPE_KIND_UNION,
+    AST_TYPE_KIND_ENUM,
+} ASTTypeKind;
+
+typedef enum ASTTypeFlags {
+    AST_TYPE_FLAG_NONE      = 0,
+    AST_TYPE_FLAG_PROTOTYPE = 1 << 0,   // Function with a parameter type list
+    AST_TYPE_FLAG_VARIADIC  = 1 << 1,   // Function ending in `...`
+    AST_TYPE_FLAG_SIZED     = 1 << 2,   // Array whose length is a constant
+} ASTTypeFlags;
+
+/**
+ * @brief Type record
+ *
+ * @description Qualifier bits and array size kinds are the ones of the
+ *              language, the table only compares them.
+ */
+typedef struct ASTTypeInfo_T {
+    uint8_t kind;                       // ASTTypeKind
+    uint8_t qualifiers;                 // Language qualifier bits of this type
+    uint8_t arraySize;                  // Language array size kind, arrays only
+    uint8_t flags;                      // ASTTypeFlags
+    uint32_t base;                      // Pointee, element or return type
+    uint32_t value;                     // Basic type, array length, tag identity, first parameter
+    uint32_t count;                     // Parameter count of a function
+    uint32_t unqualified;               // Same type without qualifiers, itself when it has none
+    uint32_t hash;
+} ASTTypeInfo;
+
+/**
+ * @brief Create a type table
+ *
+ * @description Every distinct type is stored once. Building a type that
+ *              already exists returns its id, so repeated types cost no
+ *              memory and compare as integers.
+ *
+ * @param types[out] Pointer to the type table handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the table
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateASTTypeTable(
+    ASTTypeTable* types);
+
+/**
+ * @brief Create an overlay over a type table
+ *
+ * @description The overlay numbers its types after those of `parent`.
+ *              Requests find the types of the parent and add only new
+ *              ones, to the overlay. The parent is never written, several
+ *              overlays may share it across threads as long as nobody adds
+ *              to it.
+ *
+ * @param parent[in] Table below the overlay
+ * @param types[out] Pointer to the overlay handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the overlay
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateASTTypeTableOverlay(
+    const ASTTypeTable parent,
+    ASTTypeTable* types);
+
+/**
+ * @brief Start a range of new types
+ *
+ * @description Types added before keep their records and ids but are no
+ *              longer found, asking for one adds it again. The types of a
+ *              range therefore only depend on what was asked for since it
+ *              started, which is what lets ranges of an overlay be
+ *              imported into the parent in any order.
+ *
+ * @return Id of the first type of the range
+ */
+PARSER_ATTR ASTTypeId PARSER_CALL ASTTypeTable_BeginRange(
+    ASTTypeTable types);
+
+/**
+ * @brief Remove every type, keeping the storage
+ */
+PARSER_ATTR void PARSER_CALL ASTTypeTable_Reset(
+    ASTTypeTable types);
+
+PARSER_ATTR void PARSER_CALL ASTTypeTableDestroy(
+    ASTTypeTable types);
+
+/**
+ * @brief Get a basic (arithmetic or void) type
+ *
+ * @param types[in] Type table handle
+ * @param basic[in] Language basic type
+ * @param qualifiers[in] Qualifier bits
+ * @param id[out] Type id
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the table
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetBasic(
+    ASTTypeTable types,
+    uint32_t basic,
+    uint32_t qualifiers,
+    ASTTypeId* id);
+
+/**
+ * @brief Get a pointer type
+ *
+ * @param qualifiers[in] Qualifiers of the pointer itself
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetPointer(
+    ASTTypeTable types,
+    ASTTypeId pointee,
+    uint32_t qualifiers,
+    ASTTypeId* id);
+
+/**
+ * @brief Get an array type
+ *
+ * @description Arrays are never qualified themselves, qualifiers belong to
+ *              the element type.
+ *
+ * @param element[in] Element type
+ * @param arraySize[in] Language array size kind
+ * @param value[in] Length, or the size expression node of a variable length array
+ * @param flags[in] AST_TYPE_FLAG_SIZED when `value` is a constant length
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetArray(
+    ASTTypeTable types,
+    ASTTypeId element,
+    uint32_t arraySize,
+    uint32_t value,
+    uint32_t flags,
+    ASTTypeId* id);
+
+/**
+ * @brief Get a function type
+ *
+ * @param result[in] Return type
+ * @param params[in] Parameter types, after array and function decay
+ * @param count[in] Parameter count
+ * @param flags[in] ASTTypeFlags
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetFunction(
+    ASTTypeTable types,
+    ASTTypeId result,
+    const ASTTypeId* params,
+    uint32_t count,
+    uint32_t flags,
+    ASTTypeId* id);
+
+/**
+ * @brief Get a struct, union or enum type
+ *
+ * @description Tagged types are nominal, `tag` tells them apart: the tag
+ *              symbol for named types, any unique value for anonymous ones.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `kind` is not a tagged kind
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetTagged(
+    ASTTypeTable types,
+    ASTTypeKind kind,
+    uint32_t tag,
+    uint32_t qualifiers,
+    ASTTypeId* id);
+
+/**
+ * @brief Add qualifiers to a type
+ *
+ * @description Qualifying an array qualifies its element type.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : Unknown type
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the table
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetQualified(
+    ASTTypeTable types,
+    ASTTypeId type,
+    uint32_t qualifiers,
+    ASTTypeId* id);
+
+/**
+ * @brief Find or add a type given as a record, e.g. one of an overlay
+ *
+ * @description The base, parameter and unqualified types of the record
+ *              must already be ids of `types`. The hash is computed again.
+ *
+ * @param types[in] Type table handle
+ * @param type[in] Record of the type
+ * @param params[in] Parameter types of a function type, `count` of them
+ * @param id[out] Type id
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : No kind, or a qualified type without its unqualified type
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the table
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_Import(
+    ASTTypeTable types,
+    const ASTTypeInfo* type,
+    const ASTTypeId* params,
+    ASTTypeId* id);
+
+/**
+ * @brief Get a type record
+ *
+ * @description Valid until the next type is added.
+ *
+ * @return Record, or NULL for AST_TYPE_ID_NONE and unknown ids
+ */
+PARSER_ATTR const ASTTypeInfo* PARSER_CALL ASTTypeTable_Get(
+    const ASTTypeTable types,
+    ASTTypeId id);
+
+/**
+ * @brief Get the parameter types of a function type
+ *
+ * @return `count` type ids, or NULL when the type has no parameters
+ */
+PARSER_ATTR const ASTTypeId* PARSER_CALL ASTTypeTable_GetParams(
+    const ASTTypeTable types,
+    ASTTypeId id);
+
+PARSER_ATTR ASTTypeId PARSER_CALL ASTTypeTable_GetUnqualified(
+    const ASTTypeTable types,
+    ASTTypeId id);
+
+PARSER_ATTR uint32_t PARSER_CALL ASTTypeTable_GetTypeCount(
+    const ASTTypeTable types);
+
+/**
+ * @brief Check two types for compatibility (C11 6.2.7)
+ *
+ * @description Identical types are the same id. Otherwise pointers, arrays
+ *              whose length is not a constant on one side and functions
+ *              where one side has no prototype are compared structurally.
+ */
+PARSER_ATTR bool PARSER_CALL ASTTypeTable_AreCompatible(
+    const ASTTypeTable types,
+    ASTTypeId a,
+    ASTTypeId b);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !PARSER_TYPE_H
+// ------------------------------------------------------------------------------------------------
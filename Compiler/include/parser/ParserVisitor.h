@@ -0,0 +1,127 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_VISITOR_H
+#define PARSER_VISITOR_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCore.h"
+#include "Results.h"
+#include "ParserAST.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(ASTVisitor)
+
+#define AST_VISITOR_MAX_PASSES          32u     // Passes fused into one walk
+#define AST_VISITOR_SEGMENT_FRAMES      1024u   // Work stack frames per arena block
+
+/**
+ * @brief What the walk does after a callback
+ */
+typedef enum ASTVisitAction {
+    AST_VISIT_CONTINUE = 0,             // Visit the children of the node
+    AST_VISIT_SKIP_CHILDREN,            // Not the children, the leave callback still runs
+    AST_VISIT_STOP,                     // No more callbacks for this pass
+} ASTVisitAction;
+
+/**
+ * @brief Node callback
+ *
+ * @param userData[in] userData of the pass
+ * @param tree[in] Walked tree
+ * @param node[in] Visited node
+ * @param parent[in] Parent of the node, AST_NODE_ID_NONE for the root
+ */
+typedef ASTVisitAction (PARSER_PTR* PFN_ASTVisitNode)(void* userData, const ASTTreeView* tree, ASTNodeId node, ASTNodeId parent);
+
+/**
+ * @brief One analysis over the tree
+ *
+ * @description Callbacks are keyed on the node type, a NULL entry falls
+ *              back to the Any callback, no callback at all continues.
+ *              Leave callbacks run after the children, for every node
+ *              whose enter callback did not stop the pass.
+ */
+typedef struct ASTVisitorPass_T {
+    PFN_ASTVisitNode enter[AST_NODE_TYPE_COUNT];    // Pre-order
+    PFN_ASTVisitNode leave[AST_NODE_TYPE_COUNT];    // Post-order
+    PFN_ASTVisitNode enterAny;
+    PFN_ASTVisitNode leaveAny;
+    void* userData;
+} ASTVisitorPass;
+
+/**
+ * @brief Create a tree walker
+ *
+ * @description Walks without native recursion: the path from the root is
+ *              an explicit stack of fixed-size blocks from an arena of the
+ *              visitor, kept for later walks. Nesting depth is bounded by
+ *              memory only.
+ *
+ * @param visitor[out] Pointer to the visitor handle
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : `visitor` is NULL
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate the visitor
+ */
+PARSER_ATTR ParserResult PARSER_CALL CreateASTVisitor(
+    ASTVisitor* visitor);
+
+PARSER_ATTR void PARSER_CALL ASTVisitorDestroy(
+    ASTVisitor visitor);
+
+/**
+ * @brief Add a pass to the walk
+ *
+ * @description The pass is copied. Passes run in the order they were
+ *              added: at every node all enter callbacks, later all leave
+ *              callbacks, so several analyses share one walk. A pass that
+ *              skips or stops does not hold back the others.
+ *
+ * @param visitor[in] Visitor handle
+ * @param pass[in] Callbacks of the pass
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : AST_VISITOR_MAX_PASSES passes were already added
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTVisitor_AddPass(
+    ASTVisitor visitor,
+    const ASTVisitorPass* pass);
+
+/**
+ * @brief Remove all passes, the work stack is kept
+ */
+PARSER_ATTR void PARSER_CALL ASTVisitor_ClearPasses(
+    ASTVisitor visitor);
+
+/**
+ * @brief Walk the subtree under a node depth first, children in order
+ *
+ * @param visitor[in] Visitor handle
+ * @param tree[in] Tree or image view
+ * @param root[in] First node, AST_NODE_ID_NONE visits nothing
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the work stack, the walk stopped
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTVisitor_Walk(
+    ASTVisitor visitor,
+    const ASTTreeView* tree,
+    ASTNodeId root);
+
+/**
+ * @brief Get the deepest path of all walks, in nodes
+ */
+PARSER_ATTR uint32_t PARSER_CALL ASTVisitor_GetMaxDepth(
+    const ASTVisitor visitor);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !PARSER_VISITOR_H
+// ------------------------------------------------------------------------------------------------
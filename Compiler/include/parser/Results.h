@@ -41,6 +41,9 @@ typedef enum ParserResultFlags {
 	PARSER_ERROR_INVALID_OPERATOR_USAGE,
 	PARSER_ERROR_MISSING_SEMICOLON,
 	PARSER_ERROR_REDECLARATION,
+	PARSER_ERROR_INVALID_ESCAPE_SEQUENCE,
+	PARSER_ERROR_STATIC_ASSERTION,
+	PARSER_ERROR_UNSUPPORTED,
 
 } ParserResultFlags;
 
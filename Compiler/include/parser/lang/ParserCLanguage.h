@@ -13,6 +13,7 @@
 #include "parser/Results.h"
 
 #include "parser/Parser.h"
+#include "parser/lexer/lang/LexerCLanguage.h"
 
 // ------------------------------------------------------------------------------------------------
 // Public definitions
@@ -127,6 +128,16 @@ typedef enum ParserCTypeQualifier {
      */
     C_TYPE_QUAL_VOLATILE = PARSER_BIT(2),
 
+    /**
+     * @brief Atomic qualifier - object is accessed atomically (C11)
+     *
+     * @since C11
+     *
+     * @example
+     * _Atomic int counter;
+     */
+    C_TYPE_QUAL_ATOMIC = PARSER_BIT(3),
+
     /**
      * @brief Restrict qualifier - pointer aliasing hint for optimization (C99)
      *
@@ -157,8 +168,17 @@ typedef enum ParserCStorageClass {
 typedef enum ParserCFunctionSpecifier {
     C_FUNC_SPEC_NONE = 0x00,
     C_FUNC_SPEC_INLINE = 0x01,    // inline (C99)
+    C_FUNC_SPEC_NORETURN = 0x02,  // _Noreturn (C11)
 } ParserCFunctionSpecifier;
 
+/*
+ * Storage byte of a declaration subtype, see AST_DECL_SUBTYPE: the storage
+ * class in the low nibble, the function specifiers above it.
+ */
+#define C_DECL_STORAGE(storageClass, funcSpecs) ((uint32_t)(storageClass) | ((uint32_t)(funcSpecs) << 4))
+#define C_DECL_STORAGE_CLASS(storage)   ((uint32_t)(storage) & 0x0Fu)
+#define C_DECL_FUNC_SPECS(storage)      ((uint32_t)(storage) >> 4)
+
 // ===== C Basic Type Specifiers =====
 typedef enum ParserCTypeSpecifier {
     C_TYPE_SPEC_NONE = 0,
@@ -192,6 +212,38 @@ typedef enum ParserCTypeSpecifier {
     C_TYPE_SPEC_TYPEDEF_NAME,     // user-defined type via typedef
 } ParserCTypeSpecifier;
 
+// ===== C Basic Types (ASTTypeTable_GetBasic) =====
+typedef enum ParserCBasicType {
+    C_BASIC_TYPE_NONE = 0,
+    C_BASIC_TYPE_VOID,
+    C_BASIC_TYPE_BOOL,
+    C_BASIC_TYPE_CHAR,
+    C_BASIC_TYPE_SIGNED_CHAR,
+    C_BASIC_TYPE_UNSIGNED_CHAR,
+    C_BASIC_TYPE_SHORT,
+    C_BASIC_TYPE_UNSIGNED_SHORT,
+    C_BASIC_TYPE_INT,
+    C_BASIC_TYPE_UNSIGNED_INT,
+    C_BASIC_TYPE_LONG,
+    C_BASIC_TYPE_UNSIGNED_LONG,
+    C_BASIC_TYPE_LONG_LONG,
+    C_BASIC_TYPE_UNSIGNED_LONG_LONG,
+    C_BASIC_TYPE_FLOAT,
+    C_BASIC_TYPE_DOUBLE,
+    C_BASIC_TYPE_LONG_DOUBLE,
+    C_BASIC_TYPE_FLOAT_COMPLEX,
+    C_BASIC_TYPE_DOUBLE_COMPLEX,
+    C_BASIC_TYPE_LONG_DOUBLE_COMPLEX,
+} ParserCBasicType;
+
+/*
+ * INTEGER_LITERAL nodes of a token have subtype 0 and the literal table
+ * index in lhs. Folded integer constant expressions have the integer
+ * ParserCBasicType of their value as subtype and the value bits in lhs
+ * (low word) and rhs (high word), sign extended for signed types.
+ */
+#define C_FOLDED_LITERAL_VALUE(data)    (((uint64_t)(data).rhs << 32) | (uint64_t)(data).lhs)
+
 // ===== C Struct/Union Member Access =====
 typedef enum ParserCMemberAccessType {
     C_MEMBER_ACCESS_NONE = 0,
@@ -204,7 +256,9 @@ typedef struct ParserCDeclSpec {
     ParserCStorageClass storageClass;
     ParserCTypeQualifier typeQualifiers;  // can be ORed together
     ParserCFunctionSpecifier funcSpecs;   // can be ORed together
-    ParserCTypeSpecifier typeSpec;
+    ParserCTypeSpecifier typeSpec;        // struct, union, enum, typedef name or the last basic specifier
+    uint32_t specifiers;                  // PARSER_BIT of every ParserCTypeSpecifier seen
+    uint32_t type;                        // ASTTypeId of the specified type, qualifiers included
 } ParserCDeclSpec;
 
 // ===== C Linkage Type =====
@@ -260,11 +314,95 @@ typedef enum ParserCPrecedence {
     C_PREC_PRIMARY,               // literals, identifiers, ()
 } ParserCPrecedence;
 
-typedef ParserResult(PARSER_PTR* PFN_ParsePrimaryExpression)(ASTParser parser, ASTNode node);
+// ===== C Operator Associativity =====
+typedef enum ParserCAssociativity {
+    C_ASSOC_LEFT = 0,             // a - b - c is (a - b) - c
+    C_ASSOC_RIGHT,                // a = b = c is a = (b = c)
+} ParserCAssociativity;
+
+/**
+ * @brief Operator row of the C expression table
+ *
+ * @description Indexed by token (kind, value), the expression loop looks
+ *              up the operator after an operand in a single load.
+ */
+typedef struct ParserCOperatorInfo_T {
+    uint8_t precedence;           // ParserCPrecedence, C_PREC_NONE ends the expression
+    uint8_t associativity;        // ParserCAssociativity
+    uint8_t op;                   // ParserCBinaryOperator, ParserCUnaryOperator for postfix ++ --
+    uint8_t nodeType;             // ParserASTNodeType built for the operator
+} ParserCOperatorInfo;
+
+/**
+ * @brief Get the operator row for a token following an operand
+ *
+ * @param token[in] Token handle
+ *
+ * @return Operator row, precedence C_PREC_NONE when the token is no operator
+ */
+PARSER_ATTR const ParserCOperatorInfo* PARSER_CALL ParserCGetOperatorInfo(
+    const LexerToken token);
+
+PARSER_ATTR uint16_t PARSER_CALL ParserCGetOperatorPrecedence(
+    LexerToken token);
+
+/**
+ * @brief Get the basic type named by a combination of type specifiers
+ *
+ * @param specifiers[in] PARSER_BIT of every ParserCTypeSpecifier, two
+ *                       `long` are C_TYPE_SPEC_LONG_LONG
+ * @param basic[out] Basic type
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_SYNTAX_ERROR : Not a valid combination (C11 6.7.2)
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCGetBasicType(
+    uint32_t specifiers,
+    ParserCBasicType* basic);
+
+PARSER_ATTR bool PARSER_CALL ParserCIsTypeName(
+    ASTParser parser);
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseDeclaration(
+    ASTParser parser,
+    ASTNode* node);
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseStatement(
+    ASTParser parser,
+    ASTNode* node);
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseFunctionBody(
+    ASTParser parser,
+    ASTNode function,
+    ASTNode* node);
+
+/**
+ * @brief Lower a function body to SSA IR while it is parsed, see PFN_LowerFunctionBody
+ *
+ * @description Scalar locals whose address is never taken become SSA
+ *              variables, other locals get a stack slot. Bodies with
+ *              constructs the lowering does not cover (initializers with
+ *              designators, static locals, struct parameters, variadic
+ *              definitions, wide strings, ...) are left to the AST path.
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerFunctionBody(
+    ASTParser parser,
+    ASTNode function,
+    IRFunction* ir);
 
 PARSER_ATTR ParserResult PARSER_CALL ParserCParsePrimaryExpression(
     ASTParser parser,
-    ASTNode node);
+    ASTNode* node);
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseUnaryOperator(
+    ASTParser parser,
+    ASTNode* node);
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseBinaryOperator(
+    ASTParser parser,
+    ASTNode left,
+    int precedence,
+    ASTNode* node);
 
 // ------------------------------------------------------------------------------------------------
 #endif // !PARSER_LANGUAGE_C_H
@@ -133,6 +133,14 @@ typedef uint32_t(PARSER_PTR* PFN_LexerGetOperatorTypeCallback)(
     const char* lexeme,
     size_t length);
 
+/**
+ * @brief Scanner callbacks
+ *
+ * @description Called with the lexer cursor on the first byte of the token.
+ *              The callback consumes the token through the lexer cursor, fills
+ *              the lexer scan slot and returns it. The returned handle is only
+ *              valid until the next scanner callback.
+ */
 typedef LexerToken(PARSER_PTR* PFN_LexerParseStringLiteral)(
     Lexer lexer);
 
@@ -149,13 +157,26 @@ typedef LexerToken(PARSER_PTR* PFN_LexerParseKeyword)(
     Lexer lexer);
 
 typedef LexerToken(PARSER_PTR* PFN_LexerParseOperator)(
-    Lexer* lexer);
+    Lexer lexer);
 
 typedef LexerToken(PARSER_PTR* PFN_LexerParseLineComment)(
-    Lexer* lexer);
+    Lexer lexer);
 
 typedef LexerToken(PARSER_PTR* PFN_LexerParseBlockComment)(
-    Lexer* lexer);
+    Lexer lexer);
+
+/**
+ * @brief Scan one token without going through the per-character callbacks
+ *
+ * @description Implemented by generated lexers (see Tools/LexerGen). Must
+ *              behave exactly like the callback driven core: skip trivia up
+ *              to the chunk limit, fill @p token and advance the lexer.
+ *
+ * @return false when the chunk limit was reached before the end of the file
+ */
+typedef bool (PARSER_PTR* PFN_LexerScanToken)(
+    Lexer lexer,
+    LexerToken token);
 
 /**
  * @brief Language-specific lexer behavior
@@ -201,17 +222,68 @@ typedef struct LexerLanguageStrategy_T {
 
     PFN_LexerParseKeyword parseKeywords;
 
+    PFN_LexerParseOperator parseOperator;   // operators and punctuation (maximal munch)
+
     PFN_LexerParseLineComment parseLineComments;
     PFN_LexerParseBlockComment parseBlockComments;
 
+    // ===== Static Scanner (optional) =====
+    // When set the lexer core calls these instead of the callbacks above,
+    // the parse callbacks may then be NULL.
+    PFN_LexerScanToken scanToken;           // Trivia recording compiled out
+    PFN_LexerScanToken scanTokenTrivia;     // Records whitespace and comment trivia
+
     void* userData;
 
 } LexerLanguageStrategy;
 
+#define LEXER_LOOKAHEAD_DEFAULT_CAPACITY   64u
+#define LEXER_LOOKAHEAD_REFILL_BATCH       32u
+#define LEXER_MAX_CHECKPOINTS              32u
+
 typedef struct LexerCreateConfig_T {
     const LexerLanguageStrategy* strategy;
+    uint32_t lookaheadCapacity;     // Initial token ring size, rounded up to a power of two, 0 for the default
 } LexerCreateConfig;
 
+/**
+ * @brief Saved position in the token stream
+ *
+ * @description Checkpoints nest. Rewinding to or releasing a checkpoint also
+ *              releases every checkpoint taken after it.
+ */
+typedef struct LexerCheckpoint_T {
+    uint32_t position;          // Absolute index of the token LexerNextToken returns next
+    uint32_t depth;             // Nesting depth of the checkpoint
+} LexerCheckpoint;
+
+/**
+ * @brief Configuration for lexing a single file on multiple threads
+ *
+ * @description The file is split into chunks at newline boundaries. Every
+ *              chunk is lexed on its own thread assuming it starts outside of
+ *              any comment or literal. The chunk boundaries are validated
+ *              afterwards and only chunks that guessed wrong are lexed again.
+ */
+typedef struct LexerParallelConfig_T {
+    const LexerLanguageStrategy* strategy;
+    uint32_t threadCount;       // 0 = number of online processors
+    ParserSize minChunkSize;    // 0 = LEXER_PARALLEL_DEFAULT_MIN_CHUNK
+    bool preserveWhitespace;    // Record whitespace trivia
+    bool preserveComments;      // Record comment trivia
+} LexerParallelConfig;
+
+#define LEXER_PARALLEL_DEFAULT_MIN_CHUNK   (256u * 1024u)
+#define LEXER_PARALLEL_MAX_CHUNKS          64u
+
+/**
+ * @brief Statistics of the last parallel lexing run
+ */
+typedef struct LexerParallelStats_T {
+    uint32_t chunkCount;        // Number of chunks the file was split in
+    uint32_t relexedChunks;     // Chunks whose start state was guessed wrong
+} LexerParallelStats;
+
 /**
  * @brief Creates a new lexer with file and language strategy
  *
@@ -230,11 +302,18 @@ PARSER_ATTR ParserResult PARSER_CALL CreateLexer(
 /**
  * @brief Get next token from input stream
  *
+ * @description Tokens are scanned ahead in batches into a ring buffer. The
+ *              returned handle stays valid until the next call, unless a
+ *              lookahead or checkpoint span larger than the ring makes it
+ *              grow.
+ *
  * @param lexer[in] Lexer handle
  * @param token[out] Pointer to the returned token 
  * 
  * @return ParserResult 
  *      PARSER_RESULT_SUCCES : Fetched token
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the token ring
+ *      Lexer error : The returned token is the error token
  */
 PARSER_ATTR ParserResult PARSER_CALL LexerNextToken(
     const Lexer lexer,
@@ -244,6 +323,8 @@ PARSER_ATTR ParserResult PARSER_CALL LexerNextToken(
 /**
  * @brief Get current token without advancing
  *
+ * @description The current token is the one the next LexerNextToken returns.
+ *
  * @param lexer[in] Lexer handle
  * 
  * @return Current token
@@ -264,6 +345,118 @@ PARSER_ATTR ParserResult PARSER_CALL LexerLookAheadToken(
     const Lexer lexer,
     LexerToken* token);
 
+/**
+ * @brief Get the token `k` positions after the current token
+ *
+ * @description LexerPeekN(lexer, 0) is the current token and
+ *              LexerPeekN(lexer, 1) the lookahead token. Past the end of the
+ *              input the EOF (or error) token is repeated.
+ *
+ * @param lexer[in] Lexer handle
+ * @param k[in] Lookahead distance
+ *
+ * @return Token handle, or NULL when the token ring could not grow
+ */
+PARSER_ATTR LexerToken PARSER_CALL LexerPeekN(
+    const Lexer lexer,
+    uint32_t k);
+
+/**
+ * @brief Save the current position for backtracking
+ *
+ * @description Tokens from the checkpoint on stay in the token ring until
+ *              it is rewound to or released.
+ *
+ * @param lexer[in] Lexer handle
+ * @param checkpoint[out] Saved position
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : LEXER_MAX_CHECKPOINTS checkpoints are active
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerMark(
+    Lexer lexer,
+    LexerCheckpoint* checkpoint);
+
+/**
+ * @brief Return to a checkpoint and release it
+ *
+ * @param lexer[in] Lexer handle
+ * @param checkpoint[in] Checkpoint taken by LexerMark
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : The checkpoint was already released
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerRewind(
+    Lexer lexer,
+    const LexerCheckpoint* checkpoint);
+
+/**
+ * @brief Release a checkpoint without moving
+ *
+ * @param lexer[in] Lexer handle
+ * @param checkpoint[in] Checkpoint taken by LexerMark
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : The checkpoint was already released
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerReleaseMark(
+    Lexer lexer,
+    const LexerCheckpoint* checkpoint);
+
+/**
+ * @brief Move to any token that is still in the token ring
+ *
+ * @description Every token from the oldest active checkpoint on stays
+ *              scanned, so a parser holding a checkpoint at the start of
+ *              the input can come back to a skipped range later. The
+ *              checkpoints are kept.
+ *
+ * @param lexer[in] Lexer handle
+ * @param position[in] Absolute index of the token LexerNextToken returns next
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : The token was released or has not been scanned yet
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerSeek(
+    Lexer lexer,
+    uint32_t position);
+
+// ===== BATCH LEXING =====
+
+/**
+ * @brief Lex the remainder of the input into a token array
+ *
+ * @param lexer[in] Lexer handle
+ * @param tokens[out] Pointer to the token array handle, terminated by an EOF token
+ *
+ * @return ParserResult
+ *      PARSER_RESULT_SUCCES : Lexed the input
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerTokenize(
+    Lexer lexer,
+    LexerTokenArray* tokens);
+
+/**
+ * @brief Lex a whole file on multiple threads into a token array
+ *
+ * @description Produces exactly the same tokens as LexerTokenize on a lexer
+ *              created for the same file and strategy.
+ *
+ * @param file[in] File buffer to be lexed
+ * @param cfg[in] Parallel lexing configuration
+ * @param tokens[out] Pointer to the token array handle, terminated by an EOF token
+ * @param stats[out] Optional pointer receiving chunk statistics
+ *
+ * @return ParserResult
+ *      PARSER_RESULT_SUCCES : Lexed the file
+ *      PARSER_ERROR_UNSUPPORTED : An arena is installed as g_parser_allocator_callbacks
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerTokenizeParallel(
+    FileBuffer file,
+    const LexerParallelConfig* cfg,
+    LexerTokenArray* tokens,
+    LexerParallelStats* stats);
+
 // ===== ERROR HANDLING =====
 
 /**
@@ -313,8 +506,11 @@ PARSER_ATTR void PARSER_CALL LexerSetStrictMode(
 /**
  * @brief Enable/disable whitespace preservation
  *
+ * @description Whitespace is not emitted as tokens but recorded as trivia
+ *              ranges, see LexerTokenArray_GetLeadingTrivia and Lexer_GetTrivia.
+ *
  * @param lexer Lexer handle
- * @param preserve true to preserve whitespace tokens
+ * @param preserve true to preserve whitespace ranges
  */
 PARSER_ATTR void PARSER_CALL Lexer_SetPreserveWhitespace(
     Lexer lexer,
@@ -323,13 +519,46 @@ PARSER_ATTR void PARSER_CALL Lexer_SetPreserveWhitespace(
 /**
  * @brief Enable/disable comment preservation
  *
+ * @description Comments are not emitted as tokens but recorded as trivia
+ *              ranges, see LexerTokenArray_GetLeadingTrivia and Lexer_GetTrivia.
+ *
  * @param lexer Lexer handle
- * @param preserve true to preserve comment tokens
+ * @param preserve true to preserve comment ranges
  */
 PARSER_ATTR void PARSER_CALL Lexer_SetPreserveComments(
     Lexer lexer,
     bool preserve);
 
+/**
+ * @brief Get the trivia ranges recorded by a streaming lexer
+ *
+ * @description Token indices count the tokens scanned by this lexer. The
+ *              ranges move into the token array when LexerTokenize is used.
+ *
+ * @param lexer Lexer handle
+ * @param count[out] Number of trivia ranges
+ *
+ * @return Pointer to the ranges sorted by offset, or NULL when there are none
+ */
+PARSER_ATTR const LexerTrivia* PARSER_CALL Lexer_GetTrivia(
+    const Lexer lexer,
+    uint32_t* count);
+
+/**
+ * @brief Get the value of a numeric literal token scanned by a streaming lexer
+ *
+ * @description The values move into the token array when LexerTokenize is
+ *              used, see LexerTokenArray_GetLiteral.
+ *
+ * @param lexer Lexer handle
+ * @param token Token returned by this lexer
+ *
+ * @return Literal value, or NULL when the token is not a numeric literal
+ */
+PARSER_ATTR const LexerLiteral* PARSER_CALL Lexer_GetLiteral(
+    const Lexer lexer,
+    const LexerToken token);
+
 /**
  * @brief Set language strategy
  *
@@ -0,0 +1,49 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef LEXER_STRING_H
+#define LEXER_STRING_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserCore.h"
+#include "parser/Results.h"
+
+#include "Token.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+/**
+* @brief Encoding prefix of a string or character literal
+*/
+typedef enum LexerStringEncoding {
+	LEXER_STRING_ENCODING_NONE = 0x0000,    // "" ''
+	LEXER_STRING_ENCODING_UTF8,             // u8""
+	LEXER_STRING_ENCODING_UTF16,            // u"" u''
+	LEXER_STRING_ENCODING_UTF32,            // U"" U''
+	LEXER_STRING_ENCODING_WIDE,             // L"" L''
+} LexerStringEncoding;
+
+/**
+* @brief Decoded contents of a literal
+*
+* @description `data` points into the file buffer when the literal needed no
+* decoding, otherwise into the arena passed to the decoder. Neither is null
+* terminated.
+*/
+typedef struct LexerStringBytes_T {
+	const void* data;            // Code units
+	size_t length;               // Number of code units
+	uint32_t unitSize;           // 1 (plain, u8), 2 (u) or 4 (U, L)
+	uint32_t encoding;           // LexerStringEncoding
+	uint32_t tokenCount;         // Adjacent literal tokens that were concatenated
+} LexerStringBytes;
+
+// ------------------------------------------------------------------------------------------------
+#endif // !LEXER_STRING_H
+// ------------------------------------------------------------------------------------------------
@@ -29,6 +29,7 @@ typedef enum TokenTypeFlags {
 	TOKEN_TYPE_PREPROCESSOR,
 	TOKEN_TYPE_COMMENT,
 	TOKEN_TYPE_EOF,
+	TOKEN_TYPE_ERROR,
 } TokenTypeFlags;
 
 typedef enum TokenOperatorTypeFlags {
@@ -162,6 +163,31 @@ typedef enum TokenAssignmentOperatorFlags {
 	* @brief Assingment modulo assign operator (%=)
 	*/
 	ASSINGMENT_OPERATOR_MODULO_ASSIGN,
+
+	/**
+	* @brief Assingment bitwise and assign operator (&=)
+	*/
+	ASSINGMENT_OPERATOR_AND_ASSIGN,
+
+	/**
+	* @brief Assingment bitwise or assign operator (|=)
+	*/
+	ASSINGMENT_OPERATOR_OR_ASSIGN,
+
+	/**
+	* @brief Assingment bitwise xor assign operator (^=)
+	*/
+	ASSINGMENT_OPERATOR_XOR_ASSIGN,
+
+	/**
+	* @brief Assingment bitshift left assign operator (<<=)
+	*/
+	ASSINGMENT_OPERATOR_SHL_ASSIGN,
+
+	/**
+	* @brief Assingment bitshift right assign operator (>>=)
+	*/
+	ASSINGMENT_OPERATOR_SHR_ASSIGN,
 } TokenAssignmentOperatorFlags;
 
 typedef enum TokenBitwiseOperatorFlags {
@@ -212,6 +238,24 @@ typedef enum TokenTernaryOperatorFlags {
 	TERNARY_OPERATOR_CONDITIONAL,
 } TokenTernaryOperatorFlags;
 
+typedef enum TokenPunctuationFlags {
+	PUNCTUATION_NONE = 0x0000,
+	PUNCTUATION_LPAREN,         // (
+	PUNCTUATION_RPAREN,         // )
+	PUNCTUATION_LBRACKET,       // [
+	PUNCTUATION_RBRACKET,       // ]
+	PUNCTUATION_LBRACE,         // {
+	PUNCTUATION_RBRACE,         // }
+	PUNCTUATION_SEMICOLON,      // ;
+	PUNCTUATION_COMMA,          // ,
+	PUNCTUATION_COLON,          // :
+	PUNCTUATION_DOT,            // .
+	PUNCTUATION_ARROW,          // ->
+	PUNCTUATION_ELLIPSIS,       // ...
+	PUNCTUATION_HASH,           // #
+	PUNCTUATION_HASH_HASH,      // ##
+} TokenPunctuationFlags;
+
 typedef enum TokenLiteralTypeFlags {
 	LITERAL_TYPE_NONE = 0x0000,
 	LITERAL_TYPE_INTEGER,
@@ -223,6 +267,84 @@ typedef enum TokenLiteralTypeFlags {
 	LITERAL_TYPE_MAX_VALUE,
 } TokenLiteralTypeFlags;
 
+/**
+* @brief Value of string and character literal tokens
+*
+* @description The lexer only finds the bounds of quoted literals. Escape
+* sequences are decoded later, on request, so literals without this flag
+* can be used straight from the file buffer.
+*/
+typedef enum LexerStringFlags {
+	LEXER_STRING_NONE = 0x0000,
+	LEXER_STRING_HAS_ESCAPES = 0x0001,  // Contains escape sequences or line splices
+} LexerStringFlags;
+
+/**
+* @brief Packs an operator category and operator into a single code
+*
+* @description The code is what PFN_LexerGetOperatorTypeCallback returns,
+* the lexer unpacks it into the token kind (TokenOperatorTypeFlags) and
+* value (e.g. TokenArithmeticOperatorFlags).
+*/
+#define TOKEN_OPERATOR_CODE(type, op)	(((uint32_t)(type) << 8) | (uint32_t)(op))
+#define TOKEN_OPERATOR_CODE_TYPE(code)	((uint32_t)(code) >> 8)
+#define TOKEN_OPERATOR_CODE_OP(code)	((uint32_t)(code) & 0xFFu)
+
+PARSER_CORE_DEFINE_HANDLE(LexerTokenArray)
+
+/**
+* @brief Kind of a trivia range
+*/
+typedef enum LexerTriviaKind {
+	LEXER_TRIVIA_NONE = 0x0000,
+	LEXER_TRIVIA_WHITESPACE,     // Run of whitespace, including newlines
+	LEXER_TRIVIA_LINE_COMMENT,   // Line comment without its newline
+	LEXER_TRIVIA_BLOCK_COMMENT,  // Block comment including delimiters
+} LexerTriviaKind;
+
+/**
+* @brief Source range skipped by the lexer
+*
+* @description Trivia is kept in a side array next to the tokens instead
+* of being emitted as tokens. Every range is leading trivia of the token
+* at `tokenIndex`, ranges are sorted by offset.
+*/
+typedef struct LexerTrivia_T {
+	uint32_t offset;             // Byte offset from the start of the file
+	uint32_t length;             // Length in bytes
+	uint32_t kind;               // LexerTriviaKind
+	uint32_t tokenIndex;         // Token that follows the range
+} LexerTrivia;
+
+/**
+* @brief Suffix of a numeric literal
+*/
+typedef enum LexerLiteralSuffixFlags {
+	LITERAL_SUFFIX_NONE = 0x0000,
+	LITERAL_SUFFIX_UNSIGNED = 0x0001,   // u, U
+	LITERAL_SUFFIX_LONG = 0x0002,       // l, L
+	LITERAL_SUFFIX_LONG_LONG = 0x0004,  // ll, LL
+	LITERAL_SUFFIX_FLOAT = 0x0008,      // f, F
+} LexerLiteralSuffixFlags;
+
+/**
+* @brief Value of a numeric literal
+*
+* @description Numeric literals are converted while they are scanned. The
+* value lives in a side table and the `value` of the token is its index.
+* Floating literals are rounded to their own type (float for an f suffix,
+* double otherwise) and stored widened to double.
+*/
+typedef struct LexerLiteral_T {
+	union {
+		uint64_t integer;            // LITERAL_TYPE_INTEGER
+		double floating;             // LITERAL_TYPE_FLOAT
+	} value;
+	uint16_t type;               // TokenLiteralTypeFlags
+	uint16_t suffix;             // LexerLiteralSuffixFlags
+	uint16_t base;               // 2, 8, 10 or 16
+} LexerLiteral;
+
 
 PARSER_ATTR inline bool PARSER_CALL IsTokenKeyword(const LexerToken token);
 PARSER_ATTR inline bool PARSER_CALL IsTokenIdentifier(const LexerToken token);
@@ -249,6 +371,78 @@ PARSER_ATTR const char* PARSER_CALL TokenTypeToString(const LexerToken token);
 PARSER_ATTR const char* PARSER_CALL TokenOperatorToString(const LexerToken token);
 PARSER_ATTR const char* PARSER_CALL TokenLiteralTypeToString(const LexerToken token);
 
+// ===== TOKEN ARRAYS =====
+
+/**
+ * @brief Get the number of tokens in a token array
+ *
+ * @param tokens[in] Token array handle
+ *
+ * @return Token count, including the trailing EOF token
+ */
+PARSER_ATTR uint32_t PARSER_CALL LexerTokenArray_GetCount(
+	const LexerTokenArray tokens);
+
+/**
+ * @brief Get a token from a token array
+ *
+ * @param tokens[in] Token array handle
+ * @param index[in] Index of the token
+ *
+ * @return Token handle, valid until the array is destroyed, or NULL when out of range
+ */
+PARSER_ATTR LexerToken PARSER_CALL LexerTokenArray_GetToken(
+	const LexerTokenArray tokens,
+	uint32_t index);
+
+/**
+ * @brief Get the leading trivia of a token
+ *
+ * @description Only filled when the lexer preserved whitespace or comments.
+ *
+ * @param tokens[in] Token array handle
+ * @param index[in] Index of the token
+ * @param count[out] Number of trivia ranges in front of the token
+ *
+ * @return Pointer to the first range, or NULL when the token has no leading trivia
+ */
+PARSER_ATTR const LexerTrivia* PARSER_CALL LexerTokenArray_GetLeadingTrivia(
+	const LexerTokenArray tokens,
+	uint32_t index,
+	uint32_t* count);
+
+/**
+ * @brief Get all trivia ranges of a token array
+ *
+ * @param tokens[in] Token array handle
+ * @param count[out] Number of trivia ranges
+ *
+ * @return Pointer to the ranges sorted by offset, or NULL when there are none
+ */
+PARSER_ATTR const LexerTrivia* PARSER_CALL LexerTokenArray_GetTrivia(
+	const LexerTokenArray tokens,
+	uint32_t* count);
+
+/**
+ * @brief Get the value of a numeric literal token
+ *
+ * @param tokens[in] Token array handle
+ * @param index[in] Index of the token
+ *
+ * @return Literal value, or NULL when the token is not a numeric literal
+ */
+PARSER_ATTR const LexerLiteral* PARSER_CALL LexerTokenArray_GetLiteral(
+	const LexerTokenArray tokens,
+	uint32_t index);
+
+/**
+ * @brief Destroy a token array and release its storage
+ *
+ * @param tokens[in] Token array handle
+ */
+PARSER_ATTR void PARSER_CALL LexerTokenArray_Destroy(
+	LexerTokenArray tokens);
+
 
 // ------------------------------------------------------------------------------------------------
 #endif // !LEXER_TOKEN_H
@@ -0,0 +1,159 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef LEXER_LANGUAGE_C_H
+#define LEXER_LANGUAGE_C_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserArena.h"
+#include "parser/ParserCore.h"
+#include "parser/Results.h"
+
+#include "parser/lexer/Lexer.h"
+#include "parser/lexer/LexerString.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+extern const LexerLanguageStrategy g_CLexerLanguageStrategy;
+
+// Same language, scanned by the state machine LexerGen emits from
+// LexerCLanguage.lexdesc instead of the callbacks above
+extern const LexerLanguageStrategy g_CLexerGeneratedStrategy;
+
+// ===== C Keywords (value of TOKEN_TYPE_KEYWORD tokens) =====
+typedef enum LexerCKeyword {
+    C_KEYWORD_NONE = 0,
+
+    C_KEYWORD_AUTO,
+    C_KEYWORD_BREAK,
+    C_KEYWORD_CASE,
+    C_KEYWORD_CHAR,
+    C_KEYWORD_CONST,
+    C_KEYWORD_CONTINUE,
+    C_KEYWORD_DEFAULT,
+    C_KEYWORD_DO,
+    C_KEYWORD_DOUBLE,
+    C_KEYWORD_ELSE,
+    C_KEYWORD_ENUM,
+    C_KEYWORD_EXTERN,
+    C_KEYWORD_FLOAT,
+    C_KEYWORD_FOR,
+    C_KEYWORD_GOTO,
+    C_KEYWORD_IF,
+    C_KEYWORD_INLINE,             // C99
+    C_KEYWORD_INT,
+    C_KEYWORD_LONG,
+    C_KEYWORD_REGISTER,
+    C_KEYWORD_RESTRICT,           // C99
+    C_KEYWORD_RETURN,
+    C_KEYWORD_SHORT,
+    C_KEYWORD_SIGNED,
+    C_KEYWORD_SIZEOF,
+    C_KEYWORD_STATIC,
+    C_KEYWORD_STRUCT,
+    C_KEYWORD_SWITCH,
+    C_KEYWORD_TYPEDEF,
+    C_KEYWORD_UNION,
+    C_KEYWORD_UNSIGNED,
+    C_KEYWORD_VOID,
+    C_KEYWORD_VOLATILE,
+    C_KEYWORD_WHILE,
+    C_KEYWORD_ALIGNAS,            // _Alignas (C11)
+    C_KEYWORD_ALIGNOF,            // _Alignof (C11)
+    C_KEYWORD_ATOMIC,             // _Atomic (C11)
+    C_KEYWORD_BOOL,               // _Bool (C99)
+    C_KEYWORD_COMPLEX,            // _Complex (C99)
+    C_KEYWORD_GENERIC,            // _Generic (C11)
+    C_KEYWORD_IMAGINARY,          // _Imaginary (C99)
+    C_KEYWORD_NORETURN,           // _Noreturn (C11)
+    C_KEYWORD_STATIC_ASSERT,      // _Static_assert (C11)
+    C_KEYWORD_THREAD_LOCAL,       // _Thread_local (C11)
+
+    C_KEYWORD_COUNT
+} LexerCKeyword;
+
+/**
+ * @brief Look up a C keyword
+ *
+ * @param lexeme[in] Identifier text, not necessarily null terminated
+ * @param length[in] Size of @p lexeme in bytes
+ *
+ * @return The keyword, or C_KEYWORD_NONE for plain identifiers
+ */
+PARSER_ATTR LexerCKeyword PARSER_CALL LexerCLookupKeyword(
+    const char* lexeme,
+    size_t length);
+
+/**
+ * @brief Convert the text of a C integer or floating constant
+ *
+ * @description Handles decimal, octal, hexadecimal and binary integers with
+ *              u/l/ll suffixes and decimal and hexadecimal floats with f/l
+ *              suffixes. Used by the scanners of both C strategies.
+ *
+ * @param text[in] Preprocessing number, not necessarily null terminated
+ * @param length[in] Size of @p text in bytes
+ * @param literal[out] Converted value
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_NUMBER_FORMAT : Malformed constant, bad suffix or integer overflow
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerCParseNumber(
+    const char* text,
+    size_t length,
+    LexerLiteral* literal);
+
+/**
+ * @brief Get the contents of a string or character literal
+ *
+ * @description Decodes escape sequences and concatenates the string literal
+ *              tokens that follow @p index, as translation phases 5 and 6 do.
+ *              A single literal without escapes is returned straight from the
+ *              file buffer, everything else is decoded into @p arena. Narrow
+ *              and u8 literals decode to bytes, u literals to UTF-16 and U and
+ *              L literals to UTF-32 code units.
+ *
+ * @param tokens[in] Token array handle
+ * @param index[in] Index of the first literal token
+ * @param arena[in] Arena receiving decoded contents, may be NULL when the
+ *                  literal is known not to need decoding
+ * @param bytes[out] Decoded contents
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ESCAPE_SEQUENCE : Unknown escape or value out of range
+ *      PARSER_ERROR_SYNTAX_ERROR : Adjacent literals with different encoding prefixes
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerCDecodeString(
+    const LexerTokenArray tokens,
+    uint32_t index,
+    ParserArena arena,
+    LexerStringBytes* bytes);
+
+/**
+ * @brief Get the contents of a literal the lexer has scanned, see LexerCDecodeString
+ *
+ * @description For a parser working on the token ring: the literal and the
+ *              pieces after it must not have left the ring, e.g. because a
+ *              checkpoint before them is held.
+ *
+ * @param lexer[in] Lexer handle
+ * @param position[in] Absolute index of the first literal token
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_INVALID_ARG : The token is not a literal, or no longer in the ring
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerCDecodeStringAt(
+    const Lexer lexer,
+    uint32_t position,
+    ParserArena arena,
+    LexerStringBytes* bytes);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !LEXER_LANGUAGE_C_H
+// ------------------------------------------------------------------------------------------------
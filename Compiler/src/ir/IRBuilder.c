@@ -0,0 +1,650 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRBuilder.h"
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define IR_BUILDER_INITIAL_DEFINITIONS  1024u
+
+typedef struct IRBuilderDefinition_T {
+    IRVariableId variable;
+    IRBlockId block;            // IR_BLOCK_NONE for a free slot
+    IRValueId value;
+} IRBuilderDefinition;
+
+/**
+ * @brief Phi of an unsealed block, completed when the block is sealed
+ */
+typedef struct IRBuilderPending_T {
+    IRVariableId variable;
+    IRValueId phi;
+    uint32_t next;              // Next pending phi of the block, 0 ends
+} IRBuilderPending;
+
+typedef enum IRBuilderFrameState {
+    IR_BUILDER_FRAME_START = 0,
+    IR_BUILDER_FRAME_SINGLE,    // Waiting for the value of the only predecessor
+    IR_BUILDER_FRAME_OPERANDS,  // Filling the operands of `phi`
+    IR_BUILDER_FRAME_WAIT,      // Waiting for the value of predecessor `index`
+} IRBuilderFrameState;
+
+/**
+ * @brief Block on the path of a variable read
+ */
+typedef struct IRBuilderFrame_T {
+    IRBlockId block;
+    IRValueId phi;
+    uint32_t index;             // Next predecessor
+    uint32_t state;             // IRBuilderFrameState
+} IRBuilderFrame;
+
+struct IRBuilder_T {
+    IRFunction function;
+    IRBlockId block;
+
+    // ===== Per block =====
+    uint8_t* sealed;
+    uint32_t* pendingHeads;
+    uint32_t blockCapacity;
+
+    // ===== Definitions =====
+    IRBuilderDefinition* definitions;   // Open addressing on variable and block
+    uint32_t definitionCount;
+    uint32_t definitionCapacity;
+
+    // ===== Incomplete phis =====
+    IRBuilderPending* pending;          // Record 0 is never used
+    uint32_t pendingCount;
+    uint32_t pendingCapacity;
+
+    // ===== Work =====
+    IRBuilderFrame* frames;
+    uint32_t frameCount;
+    uint32_t frameCapacity;
+    IRValueId* worklist;
+    uint32_t worklistCount;
+    uint32_t worklistCapacity;
+
+    IRBuilderStats stats;
+};
+
+/* Make room for the per-block state of every block of the function */
+static ParserResult IRBuilderTrackBlocks(IRBuilder builder)
+{
+    uint32_t blockCount = IRFunction_GetBlockCount(builder->function);
+    if (blockCount <= builder->blockCapacity)
+        return PARSER_RESULT_SUCCESS;
+
+    uint32_t newCapacity = builder->blockCapacity ? builder->blockCapacity : 64;
+    while (newCapacity < blockCount)
+        newCapacity *= 2;
+
+    uint8_t* sealed = PARSER_MALLOC(newCapacity, 0);
+    uint32_t* heads = PARSER_MALLOC(sizeof(uint32_t) * newCapacity, 0);
+    if (!sealed || !heads) {
+        if (sealed)
+            PARSER_FREE(sealed);
+        if (heads)
+            PARSER_FREE(heads);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memset(sealed, 0, newCapacity);
+    memset(heads, 0, sizeof(uint32_t) * newCapacity);
+
+    if (builder->sealed) {
+        memcpy(sealed, builder->sealed, builder->blockCapacity);
+        memcpy(heads, builder->pendingHeads, sizeof(uint32_t) * builder->blockCapacity);
+        PARSER_FREE(builder->sealed);
+        PARSER_FREE(builder->pendingHeads);
+    }
+
+    builder->sealed = sealed;
+    builder->pendingHeads = heads;
+    builder->blockCapacity = newCapacity;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static inline uint32_t IRBuilderHash(IRVariableId variable, IRBlockId block)
+{
+    uint32_t hash = variable * 0x9E3779B1u ^ block * 0x85EBCA77u;
+    return hash ^ (hash >> 15);
+}
+
+/* Follow phis that were removed as trivial to the value that replaced them */
+static IRValueId IRBuilderResolve(IRBuilder builder, IRValueId value)
+{
+    for (;;) {
+        const IRInstruction* record = IRFunctionRecord(builder->function, value);
+        if (record->opcode != IR_OP_NOP || record->operands[0] == IR_VALUE_NONE)
+            return value;
+
+        value = record->operands[0];
+    }
+}
+
+static IRValueId IRBuilderLookup(IRBuilder builder, IRVariableId variable, IRBlockId block)
+{
+    uint32_t mask = builder->definitionCapacity - 1;
+    uint32_t i = IRBuilderHash(variable, block) & mask;
+
+    for (;;) {
+        const IRBuilderDefinition* definition = &builder->definitions[i];
+        if (definition->block == IR_BLOCK_NONE)
+            return IR_VALUE_NONE;
+
+        if (definition->variable == variable && definition->block == block)
+            return IRBuilderResolve(builder, definition->value);
+
+        i = (i + 1) & mask;
+    }
+}
+
+static ParserResult IRBuilderGrowDefinitions(IRBuilder builder, uint32_t capacity)
+{
+    IRBuilderDefinition* definitions = PARSER_MALLOC(sizeof(IRBuilderDefinition) * capacity, 0);
+    if (!definitions)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(definitions, 0, sizeof(IRBuilderDefinition) * capacity);
+
+    for (uint32_t i = 0; i < builder->definitionCapacity; i++) {
+        const IRBuilderDefinition* definition = &builder->definitions[i];
+        if (definition->block == IR_BLOCK_NONE)
+            continue;
+
+        uint32_t slot = IRBuilderHash(definition->variable, definition->block) & (capacity - 1);
+        while (definitions[slot].block != IR_BLOCK_NONE)
+            slot = (slot + 1) & (capacity - 1);
+
+        definitions[slot] = *definition;
+    }
+
+    if (builder->definitions)
+        PARSER_FREE(builder->definitions);
+
+    builder->definitions = definitions;
+    builder->definitionCapacity = capacity;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRBuilderDefine(IRBuilder builder, IRVariableId variable, IRBlockId block, IRValueId value)
+{
+    uint32_t mask = builder->definitionCapacity - 1;
+    uint32_t i = IRBuilderHash(variable, block) & mask;
+
+    while (builder->definitions[i].block != IR_BLOCK_NONE) {
+        if (builder->definitions[i].variable == variable && builder->definitions[i].block == block) {
+            builder->definitions[i].value = value;
+            return PARSER_RESULT_SUCCESS;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    builder->definitions[i].variable = variable;
+    builder->definitions[i].block = block;
+    builder->definitions[i].value = value;
+
+    if (++builder->definitionCount * 2 > builder->definitionCapacity)
+        return IRBuilderGrowDefinitions(builder, builder->definitionCapacity * 2);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRBuilderNewPhi(IRBuilder builder, IRBlockId block, IRType type, IRValueId* phi)
+{
+    CHECK_PARSER_RESULT(IRFunction_AddPhi(builder->function, block, type, phi));
+    builder->stats.phis++;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRBuilderPushFrame(IRBuilder builder, IRBlockId block, uint32_t state, IRValueId phi)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&builder->frames, &builder->frameCapacity, builder->frameCount,
+        builder->frameCount + 1, sizeof(IRBuilderFrame), 64));
+
+    IRBuilderFrame* frame = &builder->frames[builder->frameCount++];
+    frame->block = block;
+    frame->phi = phi;
+    frame->index = 0;
+    frame->state = state;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/**
+ * @brief Remove `phi` if its operands are one value, then the phis that used it
+ *
+ * @param value[out] Value that stands for `phi` now
+ */
+static ParserResult IRBuilderRemoveTrivialPhi(IRBuilder builder, IRValueId phi, IRValueId* value)
+{
+    IRFunction function = builder->function;
+
+    builder->worklistCount = 0;
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&builder->worklist, &builder->worklistCapacity, 0,
+        1, sizeof(IRValueId), 64));
+    builder->worklist[builder->worklistCount++] = phi;
+
+    while (builder->worklistCount) {
+        IRValueId current = builder->worklist[--builder->worklistCount];
+        const IRInstruction* record = IRFunctionRecord(function, current);
+        if (record->opcode != IR_OP_PHI)
+            continue;
+
+        // Incomplete phis and phis still being filled are left alone
+        uint32_t predCount;
+        IRFunction_GetPredecessors(function, record->block, &predCount);
+
+        uint32_t count;
+        const uint32_t* operands = IRFunction_GetList(function, current, &count);
+        if (count != predCount)
+            continue;
+
+        IRValueId same = IR_VALUE_NONE;
+        bool trivial = true;
+        for (uint32_t i = 0; i < count; i++) {
+            if (operands[i] == same || operands[i] == current)
+                continue;
+
+            if (same != IR_VALUE_NONE) {
+                trivial = false;
+                break;
+            }
+
+            same = operands[i];
+        }
+
+        if (!trivial)
+            continue;
+
+        if (same == IR_VALUE_NONE)
+            CHECK_PARSER_RESULT(IRFunction_GetUndef(function, (IRType)record->type, &same));
+
+        // Phis using this one may become trivial in turn
+        uint32_t useCount;
+        const IRUse* uses = IRFunction_GetUses(function, current, &useCount);
+        for (uint32_t i = 0; i < useCount; i++) {
+            IRValueId user = uses[i].user;
+            if (user == current || IRFunctionRecord(function, user)->opcode != IR_OP_PHI)
+                continue;
+
+            CHECK_PARSER_RESULT(ParserArrayReserve((void**)&builder->worklist, &builder->worklistCapacity,
+                builder->worklistCount, builder->worklistCount + 1, sizeof(IRValueId), 64));
+            builder->worklist[builder->worklistCount++] = user;
+            uses = IRFunction_GetUses(function, current, &useCount);
+        }
+
+        CHECK_PARSER_RESULT(IRFunction_ReplaceAllUses(function, current, same));
+        IRFunction_RemoveInstruction(function, current);
+
+        // The removed record forwards to its replacement, definitions may still name it
+        IRFunctionRecord(function, current)->operands[0] = same;
+        builder->stats.trivialPhis++;
+    }
+
+    *value = IRBuilderResolve(builder, phi);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/**
+ * @brief Run the read frames on the stack down to `base`
+ *
+ * @param value[out] Value found by the frame at `base`
+ */
+static ParserResult IRBuilderRunFrames(IRBuilder builder, IRVariableId variable, IRType type, uint32_t base, IRValueId* value)
+{
+    IRFunction function = builder->function;
+    IRValueId result = IR_VALUE_NONE;
+
+    while (builder->frameCount > base) {
+        IRBuilderFrame* frame = &builder->frames[builder->frameCount - 1];
+        bool done = false;
+
+        if (frame->state == IR_BUILDER_FRAME_START) {
+            IRBlockId block = frame->block;
+            uint32_t predCount;
+            const IRBlockId* preds = IRFunction_GetPredecessors(function, block, &predCount);
+
+            if (!builder->sealed[block]) {
+                // Completed when the block is sealed
+                CHECK_PARSER_RESULT(IRBuilderNewPhi(builder, block, type, &result));
+                CHECK_PARSER_RESULT(ParserArrayReserve((void**)&builder->pending, &builder->pendingCapacity,
+                    builder->pendingCount, builder->pendingCount + 1, sizeof(IRBuilderPending), 64));
+
+                IRBuilderPending* pending = &builder->pending[builder->pendingCount];
+                pending->variable = variable;
+                pending->phi = result;
+                pending->next = builder->pendingHeads[block];
+                builder->pendingHeads[block] = builder->pendingCount++;
+
+                CHECK_PARSER_RESULT(IRBuilderDefine(builder, variable, block, result));
+                done = true;
+            }
+            else if (predCount == 0) {
+                // Read before any write
+                CHECK_PARSER_RESULT(IRFunction_GetUndef(function, type, &result));
+                CHECK_PARSER_RESULT(IRBuilderDefine(builder, variable, block, result));
+                done = true;
+            }
+            else if (predCount == 1 && builder->frameCount - base < builder->blockCapacity) {
+                IRValueId found = IRBuilderLookup(builder, variable, preds[0]);
+                if (found != IR_VALUE_NONE) {
+                    result = found;
+                    CHECK_PARSER_RESULT(IRBuilderDefine(builder, variable, block, result));
+                    done = true;
+                }
+                else {
+                    frame->state = IR_BUILDER_FRAME_SINGLE;
+                    CHECK_PARSER_RESULT(IRBuilderPushFrame(builder, preds[0], IR_BUILDER_FRAME_START, IR_VALUE_NONE));
+                }
+            }
+            else {
+                // The phi breaks cycles through this block
+                CHECK_PARSER_RESULT(IRBuilderNewPhi(builder, block, type, &frame->phi));
+                CHECK_PARSER_RESULT(IRBuilderDefine(builder, variable, block, frame->phi));
+                frame->state = IR_BUILDER_FRAME_OPERANDS;
+            }
+        }
+        else if (frame->state == IR_BUILDER_FRAME_OPERANDS) {
+            uint32_t predCount;
+            IRFunction_GetPredecessors(function, frame->block, &predCount);
+
+            while (frame->index < predCount) {
+                uint32_t count;
+                IRBlockId pred = IRFunction_GetPredecessors(function, frame->block, &count)[frame->index];
+
+                IRValueId found = IRBuilderLookup(builder, variable, pred);
+                if (found == IR_VALUE_NONE) {
+                    frame->state = IR_BUILDER_FRAME_WAIT;
+                    CHECK_PARSER_RESULT(IRBuilderPushFrame(builder, pred, IR_BUILDER_FRAME_START, IR_VALUE_NONE));
+                    break;
+                }
+
+                CHECK_PARSER_RESULT(IRFunction_AppendOperand(function, frame->phi, found));
+                frame->index++;
+            }
+
+            if (frame->index == predCount) {
+                CHECK_PARSER_RESULT(IRBuilderRemoveTrivialPhi(builder, frame->phi, &result));
+                done = true;
+            }
+        }
+
+        // Hand the value down to the frames waiting for it
+        while (done) {
+            builder->frameCount--;
+            if (builder->frameCount == base)
+                break;
+
+            IRBuilderFrame* parent = &builder->frames[builder->frameCount - 1];
+            if (parent->state == IR_BUILDER_FRAME_SINGLE) {
+                CHECK_PARSER_RESULT(IRBuilderDefine(builder, variable, parent->block, result));
+            }
+            else {
+                CHECK_PARSER_RESULT(IRFunction_AppendOperand(function, parent->phi, result));
+                parent->index++;
+                parent->state = IR_BUILDER_FRAME_OPERANDS;
+                done = false;
+            }
+        }
+    }
+
+    *value = result;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateIRBuilder(
+    IRFunction function,
+    IRBuilder* builder)
+{
+    if (!function || !builder)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRBuilder hdl = PARSER_MALLOC(sizeof(struct IRBuilder_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct IRBuilder_T));
+    hdl->function = function;
+    hdl->block = IR_BLOCK_ENTRY;
+    hdl->pendingCount = 1;
+
+    if (IRBuilderTrackBlocks(hdl) != PARSER_RESULT_SUCCESS ||
+        IRBuilderGrowDefinitions(hdl, IR_BUILDER_INITIAL_DEFINITIONS) != PARSER_RESULT_SUCCESS ||
+        ParserArrayReserve((void**)&hdl->pending, &hdl->pendingCapacity, 0,
+            2, sizeof(IRBuilderPending), 64) != PARSER_RESULT_SUCCESS) {
+        IRBuilderDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    hdl->sealed[IR_BLOCK_ENTRY] = 1;
+
+    *builder = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL IRBuilderDestroy(
+    IRBuilder builder)
+{
+    if (!builder)
+        return;
+
+    if (builder->sealed)
+        PARSER_FREE(builder->sealed);
+    if (builder->pendingHeads)
+        PARSER_FREE(builder->pendingHeads);
+    if (builder->definitions)
+        PARSER_FREE(builder->definitions);
+    if (builder->pending)
+        PARSER_FREE(builder->pending);
+    if (builder->frames)
+        PARSER_FREE(builder->frames);
+    if (builder->worklist)
+        PARSER_FREE(builder->worklist);
+
+    PARSER_FREE(builder);
+}
+
+PARSER_ATTR IRFunction PARSER_CALL IRBuilder_GetFunction(
+    const IRBuilder builder)
+{
+    return builder ? builder->function : NULL;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_AddBlock(
+    IRBuilder builder,
+    IRBlockId* block)
+{
+    if (!builder || !block)
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(IRFunction_AddBlock(builder->function, block));
+
+    return IRBuilderTrackBlocks(builder);
+}
+
+PARSER_ATTR void PARSER_CALL IRBuilder_SetBlock(
+    IRBuilder builder,
+    IRBlockId block)
+{
+    if (builder)
+        builder->block = block;
+}
+
+PARSER_ATTR IRBlockId PARSER_CALL IRBuilder_GetBlock(
+    const IRBuilder builder)
+{
+    return builder ? builder->block : IR_BLOCK_NONE;
+}
+
+/* Open a block for code after a terminator, nothing can reach it */
+static ParserResult IRBuilderEnsureBlock(IRBuilder builder)
+{
+    if (builder->block != IR_BLOCK_NONE)
+        return PARSER_RESULT_SUCCESS;
+
+    IRBlockId block;
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &block));
+    builder->sealed[block] = 1;
+    builder->block = block;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_Emit(
+    IRBuilder builder,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    uint32_t c,
+    IRValueId* id)
+{
+    if (!builder)
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(IRBuilderEnsureBlock(builder));
+    CHECK_PARSER_RESULT(IRFunction_AddInstruction(builder->function, builder->block, opcode, type, a, b, c, id));
+
+    if (IROpcode_GetInfo(opcode)->flags & IR_OPCODE_FLAG_TERMINATOR)
+        builder->block = IR_BLOCK_NONE;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_EmitList(
+    IRBuilder builder,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    const uint32_t* items,
+    uint32_t count,
+    IRValueId* id)
+{
+    if (!builder)
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(IRBuilderEnsureBlock(builder));
+    CHECK_PARSER_RESULT(IRFunction_AddListInstruction(builder->function, builder->block, opcode, type, a, b, items, count, id));
+
+    if (IROpcode_GetInfo(opcode)->flags & IR_OPCODE_FLAG_TERMINATOR)
+        builder->block = IR_BLOCK_NONE;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_GetConstant(
+    IRBuilder builder,
+    IRType type,
+    uint64_t bits,
+    IRValueId* id)
+{
+    if (!builder)
+        return PARSER_ERROR_INVALID_ARG;
+
+    return IRFunction_GetConstant(builder->function, type, bits, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_WriteVariable(
+    IRBuilder builder,
+    IRVariableId variable,
+    IRValueId value)
+{
+    if (!builder)
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(IRBuilderEnsureBlock(builder));
+
+    return IRBuilderDefine(builder, variable, builder->block, value);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_ReadVariable(
+    IRBuilder builder,
+    IRVariableId variable,
+    IRType type,
+    IRValueId* value)
+{
+    if (!builder || !value)
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(IRBuilderEnsureBlock(builder));
+
+    IRValueId found = IRBuilderLookup(builder, variable, builder->block);
+    if (found != IR_VALUE_NONE) {
+        *value = found;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    builder->frameCount = 0;
+    CHECK_PARSER_RESULT(IRBuilderPushFrame(builder, builder->block, IR_BUILDER_FRAME_START, IR_VALUE_NONE));
+
+    return IRBuilderRunFrames(builder, variable, type, 0, value);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRBuilder_SealBlock(
+    IRBuilder builder,
+    IRBlockId block)
+{
+    if (!builder || block == IR_BLOCK_NONE || block >= builder->blockCapacity)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (builder->sealed[block])
+        return PARSER_RESULT_SUCCESS;
+
+    for (uint32_t i = builder->pendingHeads[block]; i; i = builder->pending[i].next) {
+        IRVariableId variable = builder->pending[i].variable;
+        IRValueId phi = builder->pending[i].phi;
+        IRType type = (IRType)IRFunctionRecord(builder->function, phi)->type;
+
+        builder->frameCount = 0;
+        CHECK_PARSER_RESULT(IRBuilderPushFrame(builder, block, IR_BUILDER_FRAME_OPERANDS, phi));
+
+        IRValueId value;
+        CHECK_PARSER_RESULT(IRBuilderRunFrames(builder, variable, type, 0, &value));
+    }
+
+    builder->pendingHeads[block] = 0;
+    builder->sealed[block] = 1;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR bool PARSER_CALL IRBuilder_IsSealed(
+    const IRBuilder builder,
+    IRBlockId block)
+{
+    if (!builder || block >= builder->blockCapacity)
+        return false;
+
+    return builder->sealed[block] != 0;
+}
+
+PARSER_ATTR void PARSER_CALL IRBuilder_GetStats(
+    const IRBuilder builder,
+    IRBuilderStats* stats)
+{
+    if (builder && stats)
+        *stats = builder->stats;
+}
+
+// ------------------------------------------------------------------------------------------------
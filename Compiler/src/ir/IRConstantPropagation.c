@@ -0,0 +1,467 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRPasses.h"
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+typedef enum IRLattice {
+    IR_LATTICE_UNKNOWN = 0,             // No executable definition seen yet, or undefined
+    IR_LATTICE_CONSTANT,
+    IR_LATTICE_VARYING,
+} IRLattice;
+
+/*
+ * Tables have a slot per instruction record or per block record of the
+ * function when the pass starts. Constants made while rewriting are past
+ * the end of the value tables and are read from their records.
+ */
+typedef struct IRSccp_T {
+    IRFunction function;
+    uint32_t valueCount;
+    uint32_t blockCount;
+
+    uint64_t* bits;                     // Of values in IR_LATTICE_CONSTANT
+    uint32_t* edgeStart;                // Flags of the edges into block b are edges[edgeStart[b] ..]
+    IRValueId* values;                  // Worklist of instructions to visit again
+    IRBlockId* blocks;                  // Worklist of blocks found executable
+    uint32_t valueTop;
+    uint32_t blockTop;
+
+    uint8_t* state;                     // IRLattice
+    uint8_t* queued;                    // On the value worklist
+    uint8_t* executable;                // Per block
+    uint8_t* edges;                     // Per predecessor entry
+} IRSccp;
+
+/* Lattice value of an operand */
+static IRLattice IRSccpGet(const IRSccp* sccp, IRValueId value, uint64_t* bits)
+{
+    const IRInstruction* record = IRFunction_GetInstruction(sccp->function, value);
+    if (!record || record->opcode == IR_OP_UNDEF)
+        return IR_LATTICE_UNKNOWN;
+
+    if (record->opcode == IR_OP_CONST) {
+        *bits = IR_CONST_BITS(record);
+        return IR_LATTICE_CONSTANT;
+    }
+
+    if (value >= sccp->valueCount)
+        return IR_LATTICE_VARYING;
+
+    *bits = sccp->bits[value];
+    return (IRLattice)sccp->state[value];
+}
+
+static void IRSccpMeet(IRLattice* state, uint64_t* bits, IRLattice other, uint64_t otherBits)
+{
+    if (other == IR_LATTICE_UNKNOWN || *state == IR_LATTICE_VARYING)
+        return;
+
+    if (*state == IR_LATTICE_UNKNOWN) {
+        *state = other;
+        *bits = otherBits;
+    }
+    else if (other == IR_LATTICE_VARYING || *bits != otherBits) {
+        *state = IR_LATTICE_VARYING;
+    }
+}
+
+static void IRSccpPush(IRSccp* sccp, IRValueId id)
+{
+    if (id < sccp->valueCount && !sccp->queued[id]) {
+        sccp->queued[id] = 1;
+        sccp->values[sccp->valueTop++] = id;
+    }
+}
+
+/* Move a value down the lattice, its users are visited again when it moved */
+static void IRSccpLower(IRSccp* sccp, IRValueId id, IRLattice state, uint64_t bits)
+{
+    IRLattice current = (IRLattice)sccp->state[id];
+    if (state == IR_LATTICE_UNKNOWN || current == IR_LATTICE_VARYING)
+        return;
+
+    if (current == IR_LATTICE_CONSTANT) {
+        if (state == IR_LATTICE_CONSTANT && bits == sccp->bits[id])
+            return;
+        state = IR_LATTICE_VARYING;
+    }
+
+    sccp->state[id] = (uint8_t)state;
+    sccp->bits[id] = bits;
+
+    uint32_t count;
+    const IRUse* uses = IRFunction_GetUses(sccp->function, id, &count);
+    for (uint32_t i = 0; i < count; i++)
+        IRSccpPush(sccp, uses[i].user);
+}
+
+/* Mark the edges from `from` into `to` executable, true when one was not */
+static bool IRSccpMarkEdge(IRSccp* sccp, IRBlockId from, IRBlockId to)
+{
+    uint32_t count;
+    const IRBlockId* preds = IRFunction_GetPredecessors(sccp->function, to, &count);
+    uint8_t* edges = &sccp->edges[sccp->edgeStart[to]];
+
+    bool marked = false;
+    for (uint32_t i = 0; i < count; i++) {
+        if (preds[i] == from && !edges[i]) {
+            edges[i] = 1;
+            marked = true;
+        }
+    }
+
+    if (!marked)
+        return false;
+
+    if (!sccp->executable[to]) {
+        sccp->executable[to] = 1;
+        sccp->blocks[sccp->blockTop++] = to;
+        return true;
+    }
+
+    // Only the phis see the new edge
+    const IRBlock* block = IRFunction_GetBlock(sccp->function, to);
+    for (IRValueId phi = block->first; phi != IR_VALUE_NONE; ) {
+        const IRInstruction* record = IRFunction_GetInstruction(sccp->function, phi);
+        if (record->opcode != IR_OP_PHI)
+            break;
+
+        IRSccpPush(sccp, phi);
+        phi = record->next;
+    }
+
+    return true;
+}
+
+/* Target of a switch on a constant */
+static IRBlockId IRSccpSwitchTarget(const IRSccp* sccp, const IRInstruction* record, IRValueId id, uint64_t bits)
+{
+    const IRInstruction* value = IRFunction_GetInstruction(sccp->function, record->operands[0]);
+    uint32_t width = value->type == IR_TYPE_I1 ? 1 : IRType_GetSize((IRType)value->type) * 8;
+    uint64_t mask = width < 64 ? (1ull << width) - 1 : UINT64_MAX;
+
+    uint32_t count;
+    const uint32_t* cases = IRFunction_GetList(sccp->function, id, &count);
+    for (uint32_t i = 0; i + 2 < count; i += 3) {
+        uint64_t low = ((uint64_t)cases[i + 1] << 32) | cases[i];
+        if ((low & mask) == (bits & mask))
+            return cases[i + 2];
+    }
+
+    return record->operands[1];
+}
+
+static void IRSccpVisitBranch(IRSccp* sccp, IRValueId id, const IRInstruction* record)
+{
+    IRBlockId block = record->block;
+
+    if (record->opcode == IR_OP_BR) {
+        IRSccpMarkEdge(sccp, block, record->operands[0]);
+        return;
+    }
+
+    uint64_t bits = 0;
+    IRLattice condition = IRSccpGet(sccp, record->operands[0], &bits);
+    if (condition == IR_LATTICE_UNKNOWN)
+        return;
+
+    if (condition == IR_LATTICE_CONSTANT) {
+        IRBlockId target = record->opcode == IR_OP_CONDBR ?
+            record->operands[(bits & 1) ? 1 : 2] : IRSccpSwitchTarget(sccp, record, id, bits);
+        IRSccpMarkEdge(sccp, block, target);
+        return;
+    }
+
+    uint32_t count = IRFunction_GetSuccessorCount(sccp->function, block);
+    for (uint32_t i = 0; i < count; i++)
+        IRSccpMarkEdge(sccp, block, IRFunction_GetSuccessor(sccp->function, block, i));
+}
+
+static void IRSccpVisitPhi(IRSccp* sccp, IRValueId id, const IRInstruction* record)
+{
+    const uint8_t* edges = &sccp->edges[sccp->edgeStart[record->block]];
+
+    uint32_t count;
+    const uint32_t* items = IRFunction_GetList(sccp->function, id, &count);
+
+    IRLattice state = IR_LATTICE_UNKNOWN;
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < count && state != IR_LATTICE_VARYING; i++) {
+        if (!edges[i])
+            continue;
+
+        uint64_t operandBits = 0;
+        IRLattice operand = IRSccpGet(sccp, items[i], &operandBits);
+        IRSccpMeet(&state, &bits, operand, operandBits);
+    }
+
+    IRSccpLower(sccp, id, state, bits);
+}
+
+static void IRSccpVisit(IRSccp* sccp, IRValueId id)
+{
+    const IRInstruction* record = IRFunction_GetInstruction(sccp->function, id);
+    if (record->block == IR_BLOCK_NONE || !sccp->executable[record->block])
+        return;
+
+    IROpcode opcode = (IROpcode)record->opcode;
+    const IROpcodeInfo* info = IROpcode_GetInfo(opcode);
+
+    if (info->flags & IR_OPCODE_FLAG_TERMINATOR) {
+        if (opcode == IR_OP_BR || opcode == IR_OP_CONDBR || opcode == IR_OP_SWITCH)
+            IRSccpVisitBranch(sccp, id, record);
+        return;
+    }
+
+    if (record->type == IR_TYPE_VOID)
+        return;
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+
+    switch (opcode) {
+    case IR_OP_PHI:
+        IRSccpVisitPhi(sccp, id, record);
+        return;
+
+    case IR_OP_SELECT: {
+        IRLattice condition = IRSccpGet(sccp, record->operands[0], &a);
+        if (condition == IR_LATTICE_CONSTANT) {
+            IRLattice chosen = IRSccpGet(sccp, record->operands[(a & 1) ? 1 : 2], &b);
+            IRSccpLower(sccp, id, chosen, b);
+        }
+        else if (condition == IR_LATTICE_VARYING) {
+            IRLattice state = IR_LATTICE_UNKNOWN;
+            uint64_t bits = 0;
+            IRLattice left = IRSccpGet(sccp, record->operands[1], &a);
+            IRLattice right = IRSccpGet(sccp, record->operands[2], &b);
+            IRSccpMeet(&state, &bits, left, a);
+            IRSccpMeet(&state, &bits, right, b);
+            IRSccpLower(sccp, id, state, bits);
+        }
+        return;
+    }
+
+    case IR_OP_PARAM:
+    case IR_OP_GLOBAL:
+    case IR_OP_ALLOCA:
+    case IR_OP_LOAD:
+    case IR_OP_PTRADD:
+    case IR_OP_CALL:
+        IRSccpLower(sccp, id, IR_LATTICE_VARYING, 0);
+        return;
+
+    default:
+        break;
+    }
+
+    // Arithmetic, comparisons and conversions of one or two values
+    IRLattice left = IRSccpGet(sccp, record->operands[0], &a);
+    IRLattice right = info->operands[1] == IR_OPERAND_VALUE ?
+        IRSccpGet(sccp, record->operands[1], &b) : IR_LATTICE_CONSTANT;
+
+    if (left == IR_LATTICE_VARYING || right == IR_LATTICE_VARYING) {
+        IRSccpLower(sccp, id, IR_LATTICE_VARYING, 0);
+        return;
+    }
+
+    if (left == IR_LATTICE_UNKNOWN || right == IR_LATTICE_UNKNOWN)
+        return;
+
+    IRType operandType = (IRType)IRFunction_GetInstruction(sccp->function, record->operands[0])->type;
+
+    uint64_t bits;
+    if (IRFold(opcode, (IRType)record->type, operandType, a, b, &bits))
+        IRSccpLower(sccp, id, IR_LATTICE_CONSTANT, bits);
+    else
+        IRSccpLower(sccp, id, IR_LATTICE_VARYING, 0);
+}
+
+static void IRSccpVisitBlock(IRSccp* sccp, IRBlockId block)
+{
+    IRValueId id = IRFunction_GetBlock(sccp->function, block)->first;
+    while (id != IR_VALUE_NONE) {
+        IRSccpVisit(sccp, id);
+        id = IRFunction_GetInstruction(sccp->function, id)->next;
+    }
+}
+
+static void IRSccpDrain(IRSccp* sccp)
+{
+    while (sccp->blockTop || sccp->valueTop) {
+        if (sccp->blockTop) {
+            IRSccpVisitBlock(sccp, sccp->blocks[--sccp->blockTop]);
+            continue;
+        }
+
+        IRValueId id = sccp->values[--sccp->valueTop];
+        sccp->queued[id] = 0;
+        IRSccpVisit(sccp, id);
+    }
+}
+
+/* A branch on a value that stays unknown takes its first target, true when that found a new edge */
+static bool IRSccpResolveUnknown(IRSccp* sccp)
+{
+    bool resolved = false;
+
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < sccp->blockCount; block++) {
+        if (!sccp->executable[block])
+            continue;
+
+        IRValueId last = IRFunction_GetBlock(sccp->function, block)->last;
+        const IRInstruction* record = IRFunction_GetInstruction(sccp->function, last);
+        if (!record || (record->opcode != IR_OP_CONDBR && record->opcode != IR_OP_SWITCH))
+            continue;
+
+        uint64_t bits;
+        if (IRSccpGet(sccp, record->operands[0], &bits) == IR_LATTICE_UNKNOWN)
+            resolved |= IRSccpMarkEdge(sccp, block, IRFunction_GetSuccessor(sccp->function, block, 0));
+    }
+
+    return resolved;
+}
+
+/* Replace constant values, fold branches with one executable target */
+static ParserResult IRSccpRewrite(IRSccp* sccp, IRPassStats* stats)
+{
+    IRFunction function = sccp->function;
+
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < sccp->blockCount; block++) {
+        if (!sccp->executable[block])
+            continue;
+
+        IRValueId id = IRFunction_GetBlock(function, block)->first;
+        while (id != IR_VALUE_NONE) {
+            const IRInstruction* record = IRFunction_GetInstruction(function, id);
+            IRValueId next = record->next;
+
+            if (record->type != IR_TYPE_VOID && sccp->state[id] == IR_LATTICE_CONSTANT) {
+                IRValueId constant;
+                CHECK_PARSER_RESULT(IRFunction_GetConstant(function, (IRType)record->type, sccp->bits[id], &constant));
+                CHECK_PARSER_RESULT(IRFunction_ReplaceAllUses(function, id, constant));
+                IRFunction_RemoveInstruction(function, id);
+                stats->valuesFolded++;
+            }
+            else if (record->opcode == IR_OP_CONDBR || record->opcode == IR_OP_SWITCH) {
+                uint64_t bits = 0;
+                IRLattice condition = IRSccpGet(sccp, record->operands[0], &bits);
+                if (condition != IR_LATTICE_VARYING) {
+                    IRBlockId target = condition == IR_LATTICE_UNKNOWN ? IRFunction_GetSuccessor(function, block, 0) :
+                        record->opcode == IR_OP_CONDBR ? record->operands[(bits & 1) ? 1 : 2] :
+                        IRSccpSwitchTarget(sccp, record, id, bits);
+
+                    CHECK_PARSER_RESULT(IRFunction_FoldBranch(function, block, target));
+                    stats->branchesFolded++;
+                }
+            }
+
+            id = next;
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRSccpRun(IRSccp* sccp, IRPassStats* stats)
+{
+    sccp->executable[IR_BLOCK_ENTRY] = 1;
+    sccp->blocks[sccp->blockTop++] = IR_BLOCK_ENTRY;
+
+    do {
+        IRSccpDrain(sccp);
+    } while (IRSccpResolveUnknown(sccp));
+
+    uint32_t folded = stats->valuesFolded + stats->branchesFolded;
+    CHECK_PARSER_RESULT(IRSccpRewrite(sccp, stats));
+
+    bool dead = false;
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < sccp->blockCount && !dead; block++)
+        dead = !sccp->executable[block];
+
+    if (folded != stats->valuesFolded + stats->branchesFolded || dead || !IRFunction_IsCompact(sccp->function))
+        CHECK_PARSER_RESULT(IRFunction_Compact(sccp->function));
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_PropagateConstants(
+    IRFunction function,
+    IRPassStats* stats)
+{
+    if (!function)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRSccp sccp;
+    memset(&sccp, 0, sizeof(IRSccp));
+    sccp.function = function;
+    sccp.valueCount = IRFunction_GetInstructionCount(function);
+    sccp.blockCount = IRFunction_GetBlockCount(function);
+
+    uint32_t edgeCount = 0;
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < sccp.blockCount; block++) {
+        uint32_t count;
+        IRFunction_GetPredecessors(function, block, &count);
+        edgeCount += count;
+    }
+
+    // One allocation, the widest tables first
+    size_t values = sccp.valueCount;
+    size_t blocks = sccp.blockCount;
+    size_t size = sizeof(uint64_t) * values + sizeof(uint32_t) * (blocks + 1 + values + blocks) +
+        values * 2 + blocks + edgeCount;
+
+    uint8_t* memory = PARSER_MALLOC(size, 0);
+    if (!memory)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(memory, 0, size);
+    sccp.bits = (uint64_t*)memory;
+    sccp.edgeStart = (uint32_t*)(sccp.bits + values);
+    sccp.values = sccp.edgeStart + blocks + 1;
+    sccp.blocks = sccp.values + values;
+    sccp.state = (uint8_t*)(sccp.blocks + blocks);
+    sccp.queued = sccp.state + values;
+    sccp.executable = sccp.queued + values;
+    sccp.edges = sccp.executable + blocks;
+
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < sccp.blockCount; block++) {
+        uint32_t count;
+        IRFunction_GetPredecessors(function, block, &count);
+        sccp.edgeStart[block + 1] = sccp.edgeStart[block] + count;
+    }
+
+    IRFunctionStats before;
+    IRFunction_GetStats(function, &before);
+
+    IRPassStats local;
+    memset(&local, 0, sizeof(IRPassStats));
+
+    ParserResult result = IRSccpRun(&sccp, &local);
+
+    PARSER_FREE(memory);
+
+    if (stats) {
+        IRFunctionStats after;
+        IRFunction_GetStats(function, &after);
+
+        stats->instructionsRemoved += before.instructions - after.instructions;
+        stats->blocksRemoved += before.blocks - after.blocks;
+        stats->valuesFolded += local.valuesFolded;
+        stats->branchesFolded += local.branchesFolded;
+    }
+
+    return result;
+}
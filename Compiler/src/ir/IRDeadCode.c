@@ -0,0 +1,353 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRPasses.h"
+#include "ir/IRDominators.h"
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/*
+ * Tables have a slot per instruction record or per block record. The
+ * blocks whose branches block b is control dependent on are
+ * controls[controlStart[b] .. controlStart[b + 1]].
+ */
+typedef struct IRAdce_T {
+    IRFunction function;
+    IRDomTree post;
+    uint32_t valueCount;
+    uint32_t blockCount;
+
+    uint32_t* order;                    // Position in reverse postorder + 1, 0 for unreachable blocks
+    uint32_t* controlStart;
+    IRBlockId* controls;
+    IRValueId* worklist;
+    uint32_t worklistTop;
+
+    uint8_t* live;                      // Per value
+    uint8_t* liveBlocks;
+} IRAdce;
+
+static void IRAdceMark(IRAdce* adce, IRValueId id)
+{
+    if (id == IR_VALUE_NONE || id >= adce->valueCount || adce->live[id])
+        return;
+
+    const IRInstruction* record = IRFunction_GetInstruction(adce->function, id);
+    if (record->block == IR_BLOCK_NONE)
+        return;
+
+    adce->live[id] = 1;
+    adce->worklist[adce->worklistTop++] = id;
+}
+
+static void IRAdceMarkBranch(IRAdce* adce, IRBlockId block)
+{
+    IRAdceMark(adce, IRFunction_GetBlock(adce->function, block)->last);
+}
+
+static void IRAdceMarkBlock(IRAdce* adce, IRBlockId block)
+{
+    if (adce->liveBlocks[block])
+        return;
+
+    adce->liveBlocks[block] = 1;
+    for (uint32_t i = adce->controlStart[block]; i < adce->controlStart[block + 1]; i++)
+        IRAdceMarkBranch(adce, adce->controls[i]);
+}
+
+/* Walk up from every successor of a branching block to its immediate post-dominator, counting or filling */
+static void IRAdceControlWalk(IRAdce* adce, IRBlockId* fill)
+{
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < adce->blockCount; block++) {
+        uint32_t count = IRFunction_GetSuccessorCount(adce->function, block);
+        if (count < 2 || !adce->order[block] || !IRDomTree_IsReachable(adce->post, block))
+            continue;
+
+        IRBlockId stop = IRDomTree_GetIdom(adce->post, block);
+        for (uint32_t i = 0; i < count; i++) {
+            IRBlockId runner = IRFunction_GetSuccessor(adce->function, block, i);
+            while (runner != stop && runner != IR_BLOCK_NONE && IRDomTree_IsReachable(adce->post, runner)) {
+                if (fill)
+                    adce->controls[fill[runner]++] = block;
+                else
+                    adce->controlStart[runner + 1]++;
+
+                runner = IRDomTree_GetIdom(adce->post, runner);
+            }
+        }
+    }
+}
+
+static ParserResult IRAdceControlDependences(IRAdce* adce)
+{
+    IRAdceControlWalk(adce, NULL);
+
+    for (uint32_t block = 1; block < adce->blockCount; block++)
+        adce->controlStart[block + 1] += adce->controlStart[block];
+
+    uint32_t total = adce->controlStart[adce->blockCount];
+    adce->controls = PARSER_MALLOC(sizeof(IRBlockId) * (total ? total : 1), 0);
+    IRBlockId* fill = PARSER_MALLOC(sizeof(uint32_t) * adce->blockCount, 0);
+    if (!adce->controls || !fill) {
+        if (fill)
+            PARSER_FREE(fill);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memcpy(fill, adce->controlStart, sizeof(uint32_t) * adce->blockCount);
+    IRAdceControlWalk(adce, fill);
+    PARSER_FREE(fill);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* The branch of a block is kept when it may close a loop, or leads where no return is reached */
+static bool IRAdceKeepsBranch(const IRAdce* adce, IRBlockId block)
+{
+    if (!IRDomTree_IsReachable(adce->post, block))
+        return true;
+
+    uint32_t count = IRFunction_GetSuccessorCount(adce->function, block);
+    for (uint32_t i = 0; i < count; i++) {
+        IRBlockId successor = IRFunction_GetSuccessor(adce->function, block, i);
+        if (adce->order[successor] <= adce->order[block] || !IRDomTree_IsReachable(adce->post, successor))
+            return true;
+    }
+
+    return false;
+}
+
+static void IRAdceMarkRoots(IRAdce* adce)
+{
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < adce->blockCount; block++) {
+        if (!adce->order[block])
+            continue;
+
+        IRValueId id = IRFunction_GetBlock(adce->function, block)->first;
+        while (id != IR_VALUE_NONE) {
+            const IRInstruction* record = IRFunction_GetInstruction(adce->function, id);
+            const IROpcodeInfo* info = IROpcode_GetInfo((IROpcode)record->opcode);
+
+            if (info->flags & IR_OPCODE_FLAG_TERMINATOR) {
+                if (record->opcode == IR_OP_RET || record->opcode == IR_OP_UNREACHABLE || IRAdceKeepsBranch(adce, block))
+                    IRAdceMark(adce, id);
+            }
+            else if ((info->flags & IR_OPCODE_FLAG_SIDE_EFFECTS) || (record->flags & IR_INSTRUCTION_FLAG_VOLATILE)) {
+                IRAdceMark(adce, id);
+            }
+
+            id = record->next;
+        }
+    }
+}
+
+static void IRAdcePropagate(IRAdce* adce)
+{
+    while (adce->worklistTop) {
+        IRValueId id = adce->worklist[--adce->worklistTop];
+        const IRInstruction* record = IRFunction_GetInstruction(adce->function, id);
+        const IROpcodeInfo* info = IROpcode_GetInfo((IROpcode)record->opcode);
+
+        IRAdceMarkBlock(adce, record->block);
+
+        for (uint32_t i = 0; i < 3; i++) {
+            if (info->operands[i] == IR_OPERAND_VALUE)
+                IRAdceMark(adce, record->operands[i]);
+        }
+
+        if (record->opcode == IR_OP_PHI || record->opcode == IR_OP_CALL) {
+            uint32_t count;
+            const uint32_t* items = IRFunction_GetList(adce->function, id, &count);
+            for (uint32_t i = 0; i < count; i++)
+                IRAdceMark(adce, items[i]);
+        }
+
+        // The edges a live phi picks its operands by have to stay
+        if (record->opcode == IR_OP_PHI) {
+            uint32_t count;
+            const IRBlockId* preds = IRFunction_GetPredecessors(adce->function, record->block, &count);
+            for (uint32_t i = 0; i < count; i++)
+                IRAdceMarkBranch(adce, preds[i]);
+        }
+    }
+}
+
+/* Fold dead branches first, so no removed value is left as a condition */
+static ParserResult IRAdceSweep(IRAdce* adce, IRPassStats* stats)
+{
+    IRFunction function = adce->function;
+
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < adce->blockCount; block++) {
+        IRValueId last = IRFunction_GetBlock(function, block)->last;
+        if (!adce->order[block] || last == IR_VALUE_NONE || adce->live[last])
+            continue;
+
+        uint8_t opcode = IRFunction_GetInstruction(function, last)->opcode;
+        if (opcode != IR_OP_CONDBR && opcode != IR_OP_SWITCH)
+            continue;
+
+        // Nothing live lies between the block and its post-dominator, any target gets there
+        IRBlockId target = IRFunction_GetSuccessor(function, block, 0);
+        IRBlockId join = IRDomTree_GetIdom(adce->post, block);
+        uint32_t count = IRFunction_GetSuccessorCount(function, block);
+        for (uint32_t i = 0; i < count; i++) {
+            if (IRFunction_GetSuccessor(function, block, i) == join)
+                target = join;
+        }
+
+        CHECK_PARSER_RESULT(IRFunction_FoldBranch(function, block, target));
+        stats->branchesFolded++;
+    }
+
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < adce->blockCount; block++) {
+        if (!adce->order[block])
+            continue;
+
+        IRValueId id = IRFunction_GetBlock(function, block)->first;
+        while (id != IR_VALUE_NONE) {
+            const IRInstruction* record = IRFunction_GetInstruction(function, id);
+            IRValueId next = record->next;
+
+            if (!adce->live[id] && !(IROpcode_GetInfo((IROpcode)record->opcode)->flags & IR_OPCODE_FLAG_TERMINATOR))
+                IRFunction_RemoveInstruction(function, id);
+
+            id = next;
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Unlink the blocks a folded branch went around, their edges would keep the join from merging */
+static ParserResult IRAdceUnlinkBypassed(IRAdce* adce)
+{
+    IRBlockId* order = PARSER_MALLOC(sizeof(IRBlockId) * adce->blockCount, 0);
+    if (!order)
+        return PARSER_ERROR_NO_MEMORY;
+
+    uint32_t reachable = 0;
+    ParserResult result = IRFunctionReversePostorder(adce->function, order, &reachable);
+
+    // Block liveness is done with, it marks the blocks still reached
+    memset(adce->liveBlocks, 0, adce->blockCount);
+    for (uint32_t i = 0; i < reachable; i++)
+        adce->liveBlocks[order[i]] = 1;
+
+    PARSER_FREE(order);
+    CHECK_PARSER_RESULT(result);
+
+    // Everything but the terminator of such a block was dead and is gone already
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < adce->blockCount; block++) {
+        if (!adce->order[block] || adce->liveBlocks[block])
+            continue;
+
+        IRValueId last = IRFunction_GetBlock(adce->function, block)->last;
+        if (last != IR_VALUE_NONE)
+            IRFunction_RemoveInstruction(adce->function, last);
+        adce->order[block] = 0;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRAdceRun(IRAdce* adce, IRPassStats* stats)
+{
+    IRBlockId* order = PARSER_MALLOC(sizeof(IRBlockId) * adce->blockCount, 0);
+    if (!order)
+        return PARSER_ERROR_NO_MEMORY;
+
+    uint32_t reachable = 0;
+    ParserResult result = IRFunctionReversePostorder(adce->function, order, &reachable);
+    for (uint32_t i = 0; i < reachable; i++)
+        adce->order[order[i]] = i + 1;
+
+    PARSER_FREE(order);
+    CHECK_PARSER_RESULT(result);
+
+    CHECK_PARSER_RESULT(CreateIRPostDomTree(adce->function, &adce->post));
+    CHECK_PARSER_RESULT(IRAdceControlDependences(adce));
+
+    IRAdceMarkRoots(adce);
+    IRAdcePropagate(adce);
+
+    CHECK_PARSER_RESULT(IRAdceSweep(adce, stats));
+    CHECK_PARSER_RESULT(IRAdceUnlinkBypassed(adce));
+
+    // Ids of a compact function are in reverse postorder, so a chain folds into its head in one pass
+    for (IRBlockId block = IR_BLOCK_ENTRY + 1; block < adce->blockCount; block++) {
+        if (adce->order[block])
+            IRFunction_MergeBlock(adce->function, block);
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_EliminateDeadCode(
+    IRFunction function,
+    IRPassStats* stats)
+{
+    if (!function)
+        return PARSER_ERROR_INVALID_ARG;
+
+    // Blocks no path reaches would keep branches into live ones alive
+    if (!IRFunction_IsCompact(function))
+        CHECK_PARSER_RESULT(IRFunction_Compact(function));
+
+    IRAdce adce;
+    memset(&adce, 0, sizeof(IRAdce));
+    adce.function = function;
+    adce.valueCount = IRFunction_GetInstructionCount(function);
+    adce.blockCount = IRFunction_GetBlockCount(function);
+
+    size_t values = adce.valueCount;
+    size_t blocks = adce.blockCount;
+    size_t size = sizeof(uint32_t) * (blocks + blocks + 1 + values) + values + blocks;
+
+    uint8_t* memory = PARSER_MALLOC(size, 0);
+    if (!memory)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(memory, 0, size);
+    adce.order = (uint32_t*)memory;
+    adce.controlStart = adce.order + blocks;
+    adce.worklist = adce.controlStart + blocks + 1;
+    adce.live = (uint8_t*)(adce.worklist + values);
+    adce.liveBlocks = adce.live + values;
+
+    IRFunctionStats before;
+    IRFunction_GetStats(function, &before);
+
+    IRPassStats local;
+    memset(&local, 0, sizeof(IRPassStats));
+
+    ParserResult result = IRAdceRun(&adce, &local);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRFunction_Compact(function);
+
+    if (adce.post)
+        IRDomTreeDestroy(adce.post);
+    if (adce.controls)
+        PARSER_FREE(adce.controls);
+    PARSER_FREE(memory);
+
+    if (stats) {
+        IRFunctionStats after;
+        IRFunction_GetStats(function, &after);
+
+        stats->instructionsRemoved += before.instructions - after.instructions;
+        stats->blocksRemoved += before.blocks - after.blocks;
+        stats->branchesFolded += local.branchesFolded;
+    }
+
+    return result;
+}
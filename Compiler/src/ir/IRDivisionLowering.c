@@ -0,0 +1,357 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRPasses.h"
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define IR_DIVISION_NOT_POWER           UINT32_MAX
+
+/* Multiply-high constant of a divisor: q = mulh(x, multiplier) >> shift, with x added back when `add` */
+typedef struct IRDivisionMagic_T {
+    uint64_t multiplier;
+    uint32_t shift;
+    bool add;
+} IRDivisionMagic;
+
+/* Instructions of a lowering go in front of the division, at its width */
+typedef struct IRDivision_T {
+    IRFunction function;
+    IRValueId before;
+    IRType type;
+    uint32_t width;
+    uint64_t mask;
+} IRDivision;
+
+static uint32_t IRDivisionLog2(uint64_t value)
+{
+    if (value == 0 || (value & (value - 1)))
+        return IR_DIVISION_NOT_POWER;
+
+    uint32_t shift = 0;
+    while (value >>= 1)
+        shift++;
+
+    return shift;
+}
+
+/*
+ * "Hacker's Delight" 10-10, magicu2 at any width: the smallest p with
+ * 2^p > nc * (d - 1 - rem(2^p - 1, d)) gives M = ceil(2^p / d), which needs
+ * one bit more than the width when `add` is set. Takes d < 2^(width - 1),
+ * so the remainders fit the width when doubled.
+ */
+static void IRDivisionUnsignedMagic(uint64_t d, uint32_t width, uint64_t mask, IRDivisionMagic* magic)
+{
+    uint64_t high = 1ull << (width - 1);
+    uint64_t q = (high - 1) / d;
+    uint64_t r = (high - 1) - q * d;
+    uint64_t power = 0;
+    uint32_t p = width - 1;
+
+    magic->add = false;
+    do {
+        p++;
+        power = p == width ? 1 : power * 2;
+
+        if (r + 1 >= d - r) {
+            if (q >= high - 1)
+                magic->add = true;
+            q = (2 * q + 1) & mask;
+            r = 2 * r + 1 - d;
+        }
+        else {
+            if (q >= high)
+                magic->add = true;
+            q = (2 * q) & mask;
+            r = 2 * r + 1;
+        }
+    } while (p < 2 * width && power < d - 1 - r);
+
+    magic->multiplier = (q + 1) & mask;
+    magic->shift = p - width;
+}
+
+/*
+ * "Hacker's Delight" 10-1, magic at any width, for 2 <= |d| < 2^(width - 1)
+ * and d = -2^(width - 1). The multiplier is read as a signed value.
+ */
+static void IRDivisionSignedMagic(int64_t d, uint32_t width, uint64_t mask, IRDivisionMagic* magic)
+{
+    uint64_t high = 1ull << (width - 1);
+    uint64_t ad = (d < 0 ? 0 - (uint64_t)d : (uint64_t)d) & mask;
+    uint64_t t = high + (d < 0 ? 1 : 0);
+    uint64_t anc = t - 1 - t % ad;
+    uint64_t q1 = high / anc;
+    uint64_t r1 = high - q1 * anc;
+    uint64_t q2 = high / ad;
+    uint64_t r2 = high - q2 * ad;
+    uint64_t delta;
+    uint32_t p = width - 1;
+
+    do {
+        p++;
+        q1 = (2 * q1) & mask;
+        r1 = 2 * r1;
+        if (r1 >= anc) {
+            q1++;
+            r1 -= anc;
+        }
+
+        q2 = (2 * q2) & mask;
+        r2 = 2 * r2;
+        if (r2 >= ad) {
+            q2++;
+            r2 -= ad;
+        }
+
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    // The multiplier of a negative divisor is negated
+    magic->multiplier = (d < 0 ? 0 - (q2 + 1) : q2 + 1) & mask;
+    magic->shift = p - width;
+    magic->add = false;
+}
+
+static ParserResult IRDivisionEmit(IRDivision* division, IROpcode opcode, IRValueId a, IRValueId b, IRValueId* value)
+{
+    return IRFunction_InsertInstruction(division->function, division->before, opcode, division->type, a, b, 0, value);
+}
+
+static ParserResult IRDivisionEmitConstant(IRDivision* division, IROpcode opcode, IRValueId a, uint64_t bits,
+    IRValueId* value)
+{
+    IRValueId constant;
+    CHECK_PARSER_RESULT(IRFunction_GetConstant(division->function, division->type, bits, &constant));
+
+    return IRDivisionEmit(division, opcode, a, constant, value);
+}
+
+/* Quotient of `x` by a divisor of at least 2 */
+static ParserResult IRDivisionUnsigned(IRDivision* division, IRValueId x, uint64_t d, IRValueId* quotient)
+{
+    uint32_t shift = IRDivisionLog2(d);
+    if (shift != IR_DIVISION_NOT_POWER)
+        return IRDivisionEmitConstant(division, IR_OP_LSHR, x, shift, quotient);
+
+    // A divisor past half the range goes into the dividend at most once
+    if (d >= 1ull << (division->width - 1)) {
+        IRValueId constant;
+        IRValueId fits;
+        CHECK_PARSER_RESULT(IRFunction_GetConstant(division->function, division->type, d, &constant));
+        CHECK_PARSER_RESULT(IRFunction_InsertInstruction(division->function, division->before, IR_OP_UGE, IR_TYPE_I1,
+            x, constant, 0, &fits));
+        return IRFunction_InsertInstruction(division->function, division->before, IR_OP_ZEXT, division->type,
+            fits, 0, 0, quotient);
+    }
+
+    IRDivisionMagic magic;
+    IRDivisionUnsignedMagic(d, division->width, division->mask, &magic);
+
+    IRValueId q;
+    CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_UMULH, x, magic.multiplier, &q));
+
+    if (!magic.add) {
+        if (magic.shift)
+            return IRDivisionEmitConstant(division, IR_OP_LSHR, q, magic.shift, quotient);
+
+        *quotient = q;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    // The multiplier lost its top bit: q + (x - q) / 2 is x * M >> width without the overflow
+    IRValueId t;
+    CHECK_PARSER_RESULT(IRDivisionEmit(division, IR_OP_SUB, x, q, &t));
+    CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_LSHR, t, 1, &t));
+    CHECK_PARSER_RESULT(IRDivisionEmit(division, IR_OP_ADD, t, q, &t));
+
+    if (magic.shift > 1)
+        return IRDivisionEmitConstant(division, IR_OP_LSHR, t, magic.shift - 1, quotient);
+
+    *quotient = t;
+    return PARSER_RESULT_SUCCESS;
+}
+
+/*
+ * Quotient of `x` by the magnitude of a divisor of at least 2 in
+ * magnitude, rounded toward zero. `negate` tells whether to take the sign
+ * of the divisor after.
+ */
+static ParserResult IRDivisionSigned(IRDivision* division, IRValueId x, int64_t d, IRValueId* quotient, bool* negate)
+{
+    uint32_t width = division->width;
+    uint64_t magnitude = (d < 0 ? 0 - (uint64_t)d : (uint64_t)d) & division->mask;
+    uint32_t shift = IRDivisionLog2(magnitude);
+
+    // Negative dividends are biased by the magnitude less one, so the shift rounds toward zero
+    if (shift != IR_DIVISION_NOT_POWER) {
+        IRValueId bias;
+        CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_ASHR, x, shift - 1, &bias));
+        CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_LSHR, bias, width - shift, &bias));
+        CHECK_PARSER_RESULT(IRDivisionEmit(division, IR_OP_ADD, x, bias, &bias));
+        CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_ASHR, bias, shift, quotient));
+
+        *negate = d < 0;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    IRDivisionMagic magic;
+    IRDivisionSignedMagic(d, width, division->mask, &magic);
+
+    IRValueId q;
+    CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_SMULH, x, magic.multiplier, &q));
+
+    // A multiplier whose sign differs from the divisor wrapped, the dividend makes up for it
+    bool negativeMultiplier = (magic.multiplier >> (width - 1)) & 1;
+    if (d > 0 && negativeMultiplier)
+        CHECK_PARSER_RESULT(IRDivisionEmit(division, IR_OP_ADD, q, x, &q));
+    else if (d < 0 && !negativeMultiplier)
+        CHECK_PARSER_RESULT(IRDivisionEmit(division, IR_OP_SUB, q, x, &q));
+
+    if (magic.shift)
+        CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_ASHR, q, magic.shift, &q));
+
+    // Round toward zero: add one to a negative quotient
+    IRValueId sign;
+    CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_LSHR, q, width - 1, &sign));
+    CHECK_PARSER_RESULT(IRDivisionEmit(division, IR_OP_ADD, q, sign, quotient));
+
+    *negate = false;
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Build the value of a division or remainder by a constant, IR_VALUE_NONE to leave it */
+static ParserResult IRDivisionLower(IRDivision* division, const IRInstruction* record, uint64_t d, IRValueId* value)
+{
+    IROpcode opcode = (IROpcode)record->opcode;
+    IRValueId x = record->operands[0];
+    uint32_t width = division->width;
+    bool isSigned = opcode == IR_OP_SDIV || opcode == IR_OP_SREM;
+    bool isDivision = opcode == IR_OP_SDIV || opcode == IR_OP_UDIV;
+    int64_t sd = (int64_t)(d << (64 - width)) >> (64 - width);
+
+    *value = IR_VALUE_NONE;
+    if (d == 0)
+        return PARSER_RESULT_SUCCESS;
+
+    // By one, or minus one
+    if (d == 1 || (isSigned && sd == -1)) {
+        if (!isDivision)
+            return IRFunction_GetConstant(division->function, division->type, 0, value);
+        if (d == 1) {
+            *value = x;
+            return PARSER_RESULT_SUCCESS;
+        }
+        return IRDivisionEmit(division, IR_OP_NEG, x, 0, value);
+    }
+
+    IRValueId quotient;
+    if (!isSigned) {
+        if (!isDivision && IRDivisionLog2(d) != IR_DIVISION_NOT_POWER)
+            return IRDivisionEmitConstant(division, IR_OP_AND, x, d - 1, value);
+
+        CHECK_PARSER_RESULT(IRDivisionUnsigned(division, x, d, &quotient));
+        if (isDivision) {
+            *value = quotient;
+            return PARSER_RESULT_SUCCESS;
+        }
+    }
+    else {
+        bool negate;
+        CHECK_PARSER_RESULT(IRDivisionSigned(division, x, sd, &quotient, &negate));
+        if (isDivision && negate)
+            return IRDivisionEmit(division, IR_OP_NEG, quotient, 0, value);
+        if (isDivision) {
+            *value = quotient;
+            return PARSER_RESULT_SUCCESS;
+        }
+
+        // The remainder takes the sign of the dividend, x - x / |d| * |d| for either sign of d
+        if (negate)
+            d = (0 - d) & division->mask;
+    }
+
+    IRValueId product;
+    uint32_t shift = IRDivisionLog2(d);
+    if (shift != IR_DIVISION_NOT_POWER)
+        CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_SHL, quotient, shift, &product));
+    else
+        CHECK_PARSER_RESULT(IRDivisionEmitConstant(division, IR_OP_MUL, quotient, d, &product));
+
+    return IRDivisionEmit(division, IR_OP_SUB, x, product, value);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_LowerDivisions(
+    IRFunction function,
+    IRPassStats* stats)
+{
+    if (!function)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRFunctionStats before;
+    IRFunction_GetStats(function, &before);
+
+    IRDivision division;
+    memset(&division, 0, sizeof(IRDivision));
+    division.function = function;
+
+    ParserResult result = PARSER_RESULT_SUCCESS;
+    uint32_t lowered = 0;
+
+    uint32_t blockCount = IRFunction_GetBlockCount(function);
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < blockCount && result == PARSER_RESULT_SUCCESS; block++) {
+        IRValueId next;
+        for (IRValueId id = IRFunction_GetBlock(function, block)->first; id != IR_VALUE_NONE; id = next) {
+            const IRInstruction* record = IRFunction_GetInstruction(function, id);
+            next = record->next;
+
+            IROpcode opcode = (IROpcode)record->opcode;
+            IRType type = (IRType)record->type;
+            const IRInstruction* divisor = IRFunction_GetInstruction(function, record->operands[1]);
+            if ((opcode != IR_OP_SDIV && opcode != IR_OP_UDIV && opcode != IR_OP_SREM && opcode != IR_OP_UREM) ||
+                type < IR_TYPE_I8 || type > IR_TYPE_I64 || !divisor || divisor->opcode != IR_OP_CONST)
+                continue;
+
+            division.before = id;
+            division.type = type;
+            division.width = IRType_GetSize(type) * 8;
+            division.mask = division.width < 64 ? (1ull << division.width) - 1 : ~0ull;
+
+            IRValueId value;
+            result = IRDivisionLower(&division, record, IR_CONST_BITS(divisor) & division.mask, &value);
+            if (result == PARSER_RESULT_SUCCESS && value != IR_VALUE_NONE)
+                result = IRFunction_ReplaceAllUses(function, id, value);
+            if (result != PARSER_RESULT_SUCCESS)
+                break;
+
+            if (value != IR_VALUE_NONE) {
+                IRFunction_RemoveInstruction(function, id);
+                lowered++;
+            }
+        }
+    }
+
+    if (result == PARSER_RESULT_SUCCESS && !IRFunction_IsCompact(function))
+        result = IRFunction_Compact(function);
+
+    if (stats) {
+        IRFunctionStats after;
+        IRFunction_GetStats(function, &after);
+
+        stats->instructionsRemoved += before.instructions > after.instructions ? before.instructions - after.instructions : 0;
+        stats->divisionsLowered += lowered;
+    }
+
+    return result;
+}
@@ -0,0 +1,415 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRDominators.h"
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define IR_DOM_UNDEFINED                UINT32_MAX
+
+/*
+ * Every table has a slot per block record of the function, indexed by
+ * block id, besides `order` and `children`. A post-dominator tree is built
+ * on the reversed graph, with a virtual exit as block 0 that every block
+ * without successors leads to.
+ */
+struct IRDomTree_T {
+    bool reverse;                   // Post-dominator tree
+    uint32_t blockCount;            // Block records of the function when built
+    uint32_t count;                 // Reachable blocks
+    uint32_t iterations;
+
+    uint32_t* words;                // Backs all tables
+    IRBlockId* order;               // Reverse postorder
+    uint32_t* index;                // Position in `order` + 1, 0 for unreachable blocks
+    IRBlockId* idom;
+    uint32_t* childStart;           // Children of block b are children[childStart[b] .. childStart[b + 1]]
+    IRBlockId* children;
+    uint32_t* depth;
+    uint32_t* pre;                  // Depth first numbering of the tree
+    uint32_t* post;
+
+    IRBlockId* exits;               // Blocks without successors, post-dominator trees only
+    uint32_t exitCount;
+};
+
+/* Number of edges into a block of the graph the tree is built on */
+static uint32_t IRDomTreeInputCount(const IRDomTree tree, const IRFunction function, IRBlockId block)
+{
+    if (!tree->reverse) {
+        uint32_t count;
+        IRFunction_GetPredecessors(function, block, &count);
+        return count;
+    }
+
+    if (block == IR_BLOCK_NONE)
+        return 0;
+
+    uint32_t count = IRFunction_GetSuccessorCount(function, block);
+    return count ? count : 1;
+}
+
+static IRBlockId IRDomTreeInput(const IRDomTree tree, const IRFunction function, IRBlockId block, uint32_t index)
+{
+    if (!tree->reverse) {
+        uint32_t count;
+        return IRFunction_GetPredecessors(function, block, &count)[index];
+    }
+
+    // A block without successors leads to the exit
+    return IRFunction_GetSuccessorCount(function, block) ? IRFunction_GetSuccessor(function, block, index) : IR_BLOCK_NONE;
+}
+
+/* Number of edges out of a block of the graph the tree is built on */
+static uint32_t IRDomTreeOutputCount(const IRDomTree tree, const IRFunction function, IRBlockId block)
+{
+    if (!tree->reverse)
+        return IRFunction_GetSuccessorCount(function, block);
+
+    if (block == IR_BLOCK_NONE)
+        return tree->exitCount;
+
+    uint32_t count;
+    IRFunction_GetPredecessors(function, block, &count);
+    return count;
+}
+
+static IRBlockId IRDomTreeOutput(const IRDomTree tree, const IRFunction function, IRBlockId block, uint32_t index)
+{
+    if (!tree->reverse)
+        return IRFunction_GetSuccessor(function, block, index);
+
+    if (block == IR_BLOCK_NONE)
+        return tree->exits[index];
+
+    uint32_t count;
+    return IRFunction_GetPredecessors(function, block, &count)[index];
+}
+
+/* Reverse postorder from the root, with an explicit stack of (block, next edge) pairs */
+static void IRDomTreeOrder(IRDomTree tree, const IRFunction function, uint32_t* stack)
+{
+    IRBlockId root = tree->reverse ? IR_BLOCK_NONE : IR_BLOCK_ENTRY;
+    uint32_t depth = 1;
+    uint32_t visited = 0;
+
+    // `index` marks the blocks seen until it is filled in
+    tree->index[root] = 1;
+    stack[0] = root;
+    stack[1] = 0;
+
+    while (depth) {
+        uint32_t* top = &stack[(depth - 1) * 2];
+        if (top[1] < IRDomTreeOutputCount(tree, function, top[0])) {
+            IRBlockId next = IRDomTreeOutput(tree, function, top[0], top[1]++);
+            if (!tree->index[next]) {
+                tree->index[next] = 1;
+                stack[depth * 2] = next;
+                stack[depth * 2 + 1] = 0;
+                depth++;
+            }
+            continue;
+        }
+
+        tree->order[visited++] = top[0];
+        depth--;
+    }
+
+    for (uint32_t i = 0; i < visited / 2; i++) {
+        IRBlockId swap = tree->order[i];
+        tree->order[i] = tree->order[visited - 1 - i];
+        tree->order[visited - 1 - i] = swap;
+    }
+
+    tree->count = visited;
+    for (uint32_t i = 0; i < visited; i++)
+        tree->index[tree->order[i]] = i + 1;
+}
+
+/* Walk two fingers up the tree until they meet, positions in reverse postorder */
+static uint32_t IRDomTreeIntersect(const uint32_t* doms, uint32_t a, uint32_t b)
+{
+    while (a != b) {
+        while (a > b)
+            a = doms[a];
+        while (b > a)
+            b = doms[b];
+    }
+
+    return a;
+}
+
+/* Cooper-Harvey-Kennedy on positions in reverse postorder, `doms` has a slot per reachable block */
+static void IRDomTreeSolve(IRDomTree tree, const IRFunction function, uint32_t* doms)
+{
+    doms[0] = 0;
+    for (uint32_t i = 1; i < tree->count; i++)
+        doms[i] = IR_DOM_UNDEFINED;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        tree->iterations++;
+
+        for (uint32_t i = 1; i < tree->count; i++) {
+            IRBlockId block = tree->order[i];
+            uint32_t inputCount = IRDomTreeInputCount(tree, function, block);
+
+            uint32_t newIdom = IR_DOM_UNDEFINED;
+            for (uint32_t j = 0; j < inputCount; j++) {
+                uint32_t input = tree->index[IRDomTreeInput(tree, function, block, j)];
+                if (!input || doms[input - 1] == IR_DOM_UNDEFINED)
+                    continue;
+
+                newIdom = newIdom == IR_DOM_UNDEFINED ? input - 1 : IRDomTreeIntersect(doms, input - 1, newIdom);
+            }
+
+            if (doms[i] != newIdom) {
+                doms[i] = newIdom;
+                changed = true;
+            }
+        }
+    }
+}
+
+/* Number the tree depth first, with an explicit stack of (block, next child) pairs */
+static void IRDomTreeNumber(IRDomTree tree, uint32_t* stack)
+{
+    uint32_t counter = 0;
+    uint32_t top = 0;
+
+    stack[0] = tree->order[0];
+    stack[1] = 0;
+    tree->pre[tree->order[0]] = counter++;
+
+    for (;;) {
+        IRBlockId block = stack[top * 2];
+        uint32_t next = tree->childStart[block] + stack[top * 2 + 1];
+
+        if (next < tree->childStart[block + 1]) {
+            IRBlockId child = tree->children[next];
+            stack[top * 2 + 1]++;
+            top++;
+            stack[top * 2] = child;
+            stack[top * 2 + 1] = 0;
+            tree->pre[child] = counter++;
+            continue;
+        }
+
+        tree->post[block] = counter++;
+        if (top == 0)
+            break;
+        top--;
+    }
+}
+
+/* Build the tree of the graph or of the reversed graph */
+static ParserResult IRDomTreeBuild(const IRFunction function, bool reverse, IRDomTree* tree)
+{
+    if (!function || !tree)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRDomTree hdl = PARSER_MALLOC(sizeof(struct IRDomTree_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct IRDomTree_T));
+
+    uint32_t blockCount = IRFunction_GetBlockCount(function);
+    hdl->reverse = reverse;
+    hdl->blockCount = blockCount;
+
+    // Eight tables of a slot per block, the end of childStart and the exits
+    size_t words = (size_t)blockCount * (reverse ? 9 : 8) + 1;
+    hdl->words = PARSER_MALLOC(sizeof(uint32_t) * words, 0);
+    if (!hdl->words) {
+        PARSER_FREE(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memset(hdl->words, 0, sizeof(uint32_t) * words);
+    hdl->order = hdl->words;
+    hdl->index = hdl->order + blockCount;
+    hdl->idom = hdl->index + blockCount;
+    hdl->children = hdl->idom + blockCount;
+    hdl->depth = hdl->children + blockCount;
+    hdl->pre = hdl->depth + blockCount;
+    hdl->post = hdl->pre + blockCount;
+    hdl->childStart = hdl->post + blockCount;
+
+    if (reverse) {
+        hdl->exits = hdl->childStart + blockCount + 1;
+        for (IRBlockId block = IR_BLOCK_ENTRY; block < blockCount; block++) {
+            if (!IRFunction_GetSuccessorCount(function, block))
+                hdl->exits[hdl->exitCount++] = block;
+        }
+    }
+
+    // The order and numbering need a two word stack per block, the solver a word per block
+    uint32_t* scratch = PARSER_MALLOC(sizeof(uint32_t) * ((size_t)blockCount * 2 + 2), 0);
+    if (!scratch) {
+        IRDomTreeDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    if (blockCount > IR_BLOCK_ENTRY)
+        IRDomTreeOrder(hdl, function, scratch);
+
+    IRDomTreeSolve(hdl, function, scratch);
+
+    for (uint32_t i = 1; i < hdl->count; i++) {
+        IRBlockId block = hdl->order[i];
+        IRBlockId parent = hdl->order[scratch[i]];
+
+        hdl->idom[block] = parent;
+        hdl->depth[block] = hdl->depth[parent] + 1;
+        hdl->childStart[parent + 1]++;
+    }
+
+    // Children by parent, each list in reverse postorder
+    for (uint32_t block = 1; block < blockCount; block++)
+        hdl->childStart[block + 1] += hdl->childStart[block];
+
+    uint32_t* fill = scratch;
+    memcpy(fill, hdl->childStart, sizeof(uint32_t) * blockCount);
+    for (uint32_t i = 1; i < hdl->count; i++) {
+        IRBlockId block = hdl->order[i];
+        hdl->children[fill[hdl->idom[block]]++] = block;
+    }
+
+    if (hdl->count)
+        IRDomTreeNumber(hdl, scratch);
+
+    PARSER_FREE(scratch);
+
+    *tree = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateIRDomTree(
+    const IRFunction function,
+    IRDomTree* tree)
+{
+    return IRDomTreeBuild(function, false, tree);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL CreateIRPostDomTree(
+    const IRFunction function,
+    IRDomTree* tree)
+{
+    return IRDomTreeBuild(function, true, tree);
+}
+
+PARSER_ATTR void PARSER_CALL IRDomTreeDestroy(
+    IRDomTree tree)
+{
+    if (!tree)
+        return;
+
+    if (tree->words)
+        PARSER_FREE(tree->words);
+
+    PARSER_FREE(tree);
+}
+
+PARSER_ATTR const IRBlockId* PARSER_CALL IRDomTree_GetOrder(
+    const IRDomTree tree,
+    uint32_t* count)
+{
+    *count = tree ? tree->count : 0;
+
+    return tree ? tree->order : NULL;
+}
+
+PARSER_ATTR bool PARSER_CALL IRDomTree_IsReachable(
+    const IRDomTree tree,
+    IRBlockId block)
+{
+    return tree && block < tree->blockCount && tree->index[block] != 0;
+}
+
+PARSER_ATTR IRBlockId PARSER_CALL IRDomTree_GetIdom(
+    const IRDomTree tree,
+    IRBlockId block)
+{
+    if (!tree || block >= tree->blockCount)
+        return IR_BLOCK_NONE;
+
+    return tree->idom[block];
+}
+
+PARSER_ATTR const IRBlockId* PARSER_CALL IRDomTree_GetChildren(
+    const IRDomTree tree,
+    IRBlockId block,
+    uint32_t* count)
+{
+    *count = 0;
+
+    if (!tree || (block == IR_BLOCK_NONE && !tree->reverse) || block >= tree->blockCount)
+        return NULL;
+
+    *count = tree->childStart[block + 1] - tree->childStart[block];
+
+    return &tree->children[tree->childStart[block]];
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRDomTree_GetDepth(
+    const IRDomTree tree,
+    IRBlockId block)
+{
+    if (!tree || block >= tree->blockCount)
+        return 0;
+
+    return tree->depth[block];
+}
+
+PARSER_ATTR bool PARSER_CALL IRDomTree_Dominates(
+    const IRDomTree tree,
+    IRBlockId a,
+    IRBlockId b)
+{
+    if (!IRDomTree_IsReachable(tree, a) || !IRDomTree_IsReachable(tree, b))
+        return false;
+
+    return tree->pre[a] <= tree->pre[b] && tree->post[b] <= tree->post[a];
+}
+
+PARSER_ATTR IRBlockId PARSER_CALL IRDomTree_GetCommonDominator(
+    const IRDomTree tree,
+    IRBlockId a,
+    IRBlockId b)
+{
+    if (!IRDomTree_IsReachable(tree, a) || !IRDomTree_IsReachable(tree, b))
+        return IR_BLOCK_NONE;
+
+    while (tree->depth[a] > tree->depth[b])
+        a = tree->idom[a];
+    while (tree->depth[b] > tree->depth[a])
+        b = tree->idom[b];
+
+    while (a != b) {
+        a = tree->idom[a];
+        b = tree->idom[b];
+    }
+
+    return a;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRDomTree_GetIterations(
+    const IRDomTree tree)
+{
+    return tree ? tree->iterations : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,276 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+static inline uint32_t IRFoldWidth(IRType type)
+{
+    return type == IR_TYPE_I1 ? 1 : IRType_GetSize(type) * 8;
+}
+
+static inline uint64_t IRFoldMask(uint64_t bits, uint32_t width)
+{
+    return width < 64 ? bits & ((1ull << width) - 1) : bits;
+}
+
+static inline int64_t IRFoldSigned(uint64_t bits, uint32_t width)
+{
+    return width < 64 ? (int64_t)(bits << (64 - width)) >> (64 - width) : (int64_t)bits;
+}
+
+static inline bool IRFoldIsFloat(IRType type)
+{
+    return type == IR_TYPE_F32 || type == IR_TYPE_F64;
+}
+
+static inline double IRFoldToDouble(uint64_t bits, IRType type)
+{
+    if (type == IR_TYPE_F32) {
+        float single;
+        uint32_t word = (uint32_t)bits;
+        memcpy(&single, &word, sizeof(single));
+        return single;
+    }
+
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline uint64_t IRFoldFromDouble(double value, IRType type)
+{
+    if (type == IR_TYPE_F32) {
+        float single = (float)value;
+        uint32_t word;
+        memcpy(&word, &single, sizeof(word));
+        return word;
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/* Arithmetic of single precision values rounds after every step, as the target does */
+static uint64_t IRFoldFloat(IROpcode opcode, IRType type, uint64_t a, uint64_t b)
+{
+    if (type == IR_TYPE_F32) {
+        float x = (float)IRFoldToDouble(a, type);
+        float y = (float)IRFoldToDouble(b, type);
+        float r;
+
+        switch (opcode) {
+        case IR_OP_FADD: r = x + y; break;
+        case IR_OP_FSUB: r = x - y; break;
+        case IR_OP_FMUL: r = x * y; break;
+        case IR_OP_FDIV: r = x / y; break;
+        default: r = -x; break;
+        }
+
+        return IRFoldFromDouble(r, type);
+    }
+
+    double x = IRFoldToDouble(a, type);
+    double y = IRFoldToDouble(b, type);
+
+    switch (opcode) {
+    case IR_OP_FADD: return IRFoldFromDouble(x + y, type);
+    case IR_OP_FSUB: return IRFoldFromDouble(x - y, type);
+    case IR_OP_FMUL: return IRFoldFromDouble(x * y, type);
+    case IR_OP_FDIV: return IRFoldFromDouble(x / y, type);
+    default: return IRFoldFromDouble(-x, type);
+    }
+}
+
+static bool IRFoldCompare(IROpcode opcode, IRType operandType, uint64_t a, uint64_t b)
+{
+    uint32_t width = IRFoldWidth(operandType);
+    int64_t sa = IRFoldSigned(a, width);
+    int64_t sb = IRFoldSigned(b, width);
+    double fa = IRFoldIsFloat(operandType) ? IRFoldToDouble(a, operandType) : 0.0;
+    double fb = IRFoldIsFloat(operandType) ? IRFoldToDouble(b, operandType) : 0.0;
+
+    a = IRFoldMask(a, width);
+    b = IRFoldMask(b, width);
+
+    switch (opcode) {
+    case IR_OP_EQ:  return a == b;
+    case IR_OP_NE:  return a != b;
+    case IR_OP_SLT: return sa < sb;
+    case IR_OP_SLE: return sa <= sb;
+    case IR_OP_SGT: return sa > sb;
+    case IR_OP_SGE: return sa >= sb;
+    case IR_OP_ULT: return a < b;
+    case IR_OP_ULE: return a <= b;
+    case IR_OP_UGT: return a > b;
+    case IR_OP_UGE: return a >= b;
+    case IR_OP_FEQ: return fa == fb;
+    case IR_OP_FNE: return fa != fb;
+    case IR_OP_FLT: return fa < fb;
+    case IR_OP_FLE: return fa <= fb;
+    case IR_OP_FGT: return fa > fb;
+    default:        return fa >= fb;
+    }
+}
+
+/* High half of the product, in halves of the operands so no wider type is needed at 64 bits */
+static uint64_t IRFoldMulHigh(uint64_t a, uint64_t b, uint32_t width, bool isSigned)
+{
+    if (width <= 32) {
+        uint64_t product = isSigned ? (uint64_t)(IRFoldSigned(a, width) * IRFoldSigned(b, width)) :
+            IRFoldMask(a, width) * IRFoldMask(b, width);
+        return isSigned ? (uint64_t)((int64_t)product >> width) : product >> width;
+    }
+
+    uint64_t low = (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu);
+    uint64_t middle = (a >> 32) * (b & 0xFFFFFFFFu) + (low >> 32);
+    uint64_t other = (a & 0xFFFFFFFFu) * (b >> 32) + (middle & 0xFFFFFFFFu);
+    uint64_t high = (a >> 32) * (b >> 32) + (middle >> 32) + (other >> 32);
+
+    // The signed product takes the other operand off for every negative one
+    if (isSigned) {
+        high -= (int64_t)a < 0 ? b : 0;
+        high -= (int64_t)b < 0 ? a : 0;
+    }
+
+    return high;
+}
+
+/* Floating point to integer, false when the truncated value does not fit */
+static bool IRFoldToInteger(double value, uint32_t width, bool isSigned, uint64_t* result)
+{
+    if (value != value)
+        return false;
+
+    double limit = width == 64 ? 18446744073709551616.0 : (double)(1ull << width);
+    if (isSigned) {
+        if (value <= -limit / 2 - 1 || value >= limit / 2)
+            return false;
+        *result = (uint64_t)(int64_t)value;
+    }
+    else {
+        if (value <= -1.0 || value >= limit)
+            return false;
+        *result = (uint64_t)value;
+    }
+
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+bool IRFold(IROpcode opcode, IRType type, IRType operandType, uint64_t a, uint64_t b, uint64_t* result)
+{
+    uint32_t width = IRFoldWidth(type);
+    uint32_t from = IRFoldWidth(operandType);
+    uint64_t bits;
+
+    switch (opcode) {
+    case IR_OP_ADD: bits = a + b; break;
+    case IR_OP_SUB: bits = a - b; break;
+    case IR_OP_MUL: bits = a * b; break;
+    case IR_OP_SMULH: bits = IRFoldMulHigh(a, b, width, true); break;
+    case IR_OP_UMULH: bits = IRFoldMulHigh(a, b, width, false); break;
+    case IR_OP_AND: bits = a & b; break;
+    case IR_OP_OR:  bits = a | b; break;
+    case IR_OP_XOR: bits = a ^ b; break;
+    case IR_OP_NEG: bits = 0 - a; break;
+    case IR_OP_NOT: bits = ~a; break;
+
+    case IR_OP_SDIV:
+    case IR_OP_SREM: {
+        int64_t x = IRFoldSigned(a, width);
+        int64_t y = IRFoldSigned(b, width);
+        if (y == 0 || (y == -1 && x == IRFoldSigned(1ull << (width - 1), width)))
+            return false;
+        bits = (uint64_t)(opcode == IR_OP_SDIV ? x / y : x % y);
+        break;
+    }
+    case IR_OP_UDIV:
+    case IR_OP_UREM:
+        a = IRFoldMask(a, width);
+        b = IRFoldMask(b, width);
+        if (b == 0)
+            return false;
+        bits = opcode == IR_OP_UDIV ? a / b : a % b;
+        break;
+
+    case IR_OP_SHL:
+    case IR_OP_LSHR:
+    case IR_OP_ASHR:
+        b = IRFoldMask(b, width);
+        if (b >= width)
+            return false;
+        bits = opcode == IR_OP_SHL ? a << b :
+            opcode == IR_OP_LSHR ? IRFoldMask(a, width) >> b : (uint64_t)(IRFoldSigned(a, width) >> b);
+        break;
+
+    case IR_OP_FADD:
+    case IR_OP_FSUB:
+    case IR_OP_FMUL:
+    case IR_OP_FDIV:
+    case IR_OP_FNEG:
+        bits = IRFoldFloat(opcode, type, a, b);
+        break;
+
+    case IR_OP_EQ:
+    case IR_OP_NE:
+    case IR_OP_SLT:
+    case IR_OP_SLE:
+    case IR_OP_SGT:
+    case IR_OP_SGE:
+    case IR_OP_ULT:
+    case IR_OP_ULE:
+    case IR_OP_UGT:
+    case IR_OP_UGE:
+    case IR_OP_FEQ:
+    case IR_OP_FNE:
+    case IR_OP_FLT:
+    case IR_OP_FLE:
+    case IR_OP_FGT:
+    case IR_OP_FGE:
+        bits = IRFoldCompare(opcode, operandType, a, b);
+        break;
+
+    case IR_OP_SEXT:        bits = (uint64_t)IRFoldSigned(a, from); break;
+    case IR_OP_ZEXT:        bits = IRFoldMask(a, from); break;
+    case IR_OP_TRUNC:
+    case IR_OP_PTRTOINT:
+    case IR_OP_INTTOPTR:    bits = a; break;
+
+    case IR_OP_FPEXT:
+    case IR_OP_FPTRUNC:
+        bits = IRFoldFromDouble(IRFoldToDouble(a, operandType), type);
+        break;
+    case IR_OP_SITOFP:
+        // Rounded once, straight to the target precision
+        bits = type == IR_TYPE_F32 ? IRFoldFromDouble((float)IRFoldSigned(a, from), type) :
+            IRFoldFromDouble((double)IRFoldSigned(a, from), type);
+        break;
+    case IR_OP_UITOFP:
+        bits = type == IR_TYPE_F32 ? IRFoldFromDouble((float)IRFoldMask(a, from), type) :
+            IRFoldFromDouble((double)IRFoldMask(a, from), type);
+        break;
+    case IR_OP_FPTOSI:
+    case IR_OP_FPTOUI:
+        if (!IRFoldToInteger(IRFoldToDouble(a, operandType), width, opcode == IR_OP_FPTOSI, &bits))
+            return false;
+        break;
+
+    default:
+        return false;
+    }
+
+    *result = IRFoldMask(bits, width);
+
+    return true;
+}
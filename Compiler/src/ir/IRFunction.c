@@ -0,0 +1,1704 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define V IR_OPERAND_VALUE
+#define B IR_OPERAND_BLOCK
+#define I IR_OPERAND_IMMEDIATE
+#define L IR_OPERAND_LIST
+
+#define TERM IR_OPCODE_FLAG_TERMINATOR
+#define SIDE IR_OPCODE_FLAG_SIDE_EFFECTS
+#define COMM IR_OPCODE_FLAG_COMMUTATIVE
+#define CMP IR_OPCODE_FLAG_COMPARE
+
+static const IROpcodeInfo s_IROpcodeInfo[IR_OP_COUNT] = {
+    [IR_OP_NOP]         = { "nop",          { 0, 0, 0 }, 0 },
+    [IR_OP_CONST]       = { "const",        { I, I, 0 }, 0 },
+    [IR_OP_UNDEF]       = { "undef",        { 0, 0, 0 }, 0 },
+    [IR_OP_PARAM]       = { "param",        { I, 0, 0 }, 0 },
+    [IR_OP_GLOBAL]      = { "global",       { I, 0, 0 }, 0 },
+    [IR_OP_PHI]         = { "phi",          { L, 0, 0 }, 0 },
+
+    [IR_OP_ADD]         = { "add",          { V, V, 0 }, COMM },
+    [IR_OP_SUB]         = { "sub",          { V, V, 0 }, 0 },
+    [IR_OP_MUL]         = { "mul",          { V, V, 0 }, COMM },
+    [IR_OP_SMULH]       = { "smulh",        { V, V, 0 }, COMM },
+    [IR_OP_UMULH]       = { "umulh",        { V, V, 0 }, COMM },
+    [IR_OP_SDIV]        = { "sdiv",         { V, V, 0 }, 0 },
+    [IR_OP_UDIV]        = { "udiv",         { V, V, 0 }, 0 },
+    [IR_OP_SREM]        = { "srem",         { V, V, 0 }, 0 },
+    [IR_OP_UREM]        = { "urem",         { V, V, 0 }, 0 },
+    [IR_OP_AND]         = { "and",          { V, V, 0 }, COMM },
+    [IR_OP_OR]          = { "or",           { V, V, 0 }, COMM },
+    [IR_OP_XOR]         = { "xor",          { V, V, 0 }, COMM },
+    [IR_OP_SHL]         = { "shl",          { V, V, 0 }, 0 },
+    [IR_OP_LSHR]        = { "lshr",         { V, V, 0 }, 0 },
+    [IR_OP_ASHR]        = { "ashr",         { V, V, 0 }, 0 },
+    [IR_OP_NEG]         = { "neg",          { V, 0, 0 }, 0 },
+    [IR_OP_NOT]         = { "not",          { V, 0, 0 }, 0 },
+    [IR_OP_FADD]        = { "fadd",         { V, V, 0 }, COMM },
+    [IR_OP_FSUB]        = { "fsub",         { V, V, 0 }, 0 },
+    [IR_OP_FMUL]        = { "fmul",         { V, V, 0 }, COMM },
+    [IR_OP_FDIV]        = { "fdiv",         { V, V, 0 }, 0 },
+    [IR_OP_FNEG]        = { "fneg",         { V, 0, 0 }, 0 },
+
+    [IR_OP_EQ]          = { "eq",           { V, V, 0 }, CMP | COMM },
+    [IR_OP_NE]          = { "ne",           { V, V, 0 }, CMP | COMM },
+    [IR_OP_SLT]         = { "slt",          { V, V, 0 }, CMP },
+    [IR_OP_SLE]         = { "sle",          { V, V, 0 }, CMP },
+    [IR_OP_SGT]         = { "sgt",          { V, V, 0 }, CMP },
+    [IR_OP_SGE]         = { "sge",          { V, V, 0 }, CMP },
+    [IR_OP_ULT]         = { "ult",          { V, V, 0 }, CMP },
+    [IR_OP_ULE]         = { "ule",          { V, V, 0 }, CMP },
+    [IR_OP_UGT]         = { "ugt",          { V, V, 0 }, CMP },
+    [IR_OP_UGE]         = { "uge",          { V, V, 0 }, CMP },
+    [IR_OP_FEQ]         = { "feq",          { V, V, 0 }, CMP | COMM },
+    [IR_OP_FNE]         = { "fne",          { V, V, 0 }, CMP | COMM },
+    [IR_OP_FLT]         = { "flt",          { V, V, 0 }, CMP },
+    [IR_OP_FLE]         = { "fle",          { V, V, 0 }, CMP },
+    [IR_OP_FGT]         = { "fgt",          { V, V, 0 }, CMP },
+    [IR_OP_FGE]         = { "fge",          { V, V, 0 }, CMP },
+
+    [IR_OP_SEXT]        = { "sext",         { V, 0, 0 }, 0 },
+    [IR_OP_ZEXT]        = { "zext",         { V, 0, 0 }, 0 },
+    [IR_OP_TRUNC]       = { "trunc",        { V, 0, 0 }, 0 },
+    [IR_OP_FPEXT]       = { "fpext",        { V, 0, 0 }, 0 },
+    [IR_OP_FPTRUNC]     = { "fptrunc",      { V, 0, 0 }, 0 },
+    [IR_OP_SITOFP]      = { "sitofp",       { V, 0, 0 }, 0 },
+    [IR_OP_UITOFP]      = { "uitofp",       { V, 0, 0 }, 0 },
+    [IR_OP_FPTOSI]      = { "fptosi",       { V, 0, 0 }, 0 },
+    [IR_OP_FPTOUI]      = { "fptoui",       { V, 0, 0 }, 0 },
+    [IR_OP_PTRTOINT]    = { "ptrtoint",     { V, 0, 0 }, 0 },
+    [IR_OP_INTTOPTR]    = { "inttoptr",     { V, 0, 0 }, 0 },
+    [IR_OP_SELECT]      = { "select",       { V, V, V }, 0 },
+
+    [IR_OP_ALLOCA]      = { "alloca",       { I, I, 0 }, 0 },
+    [IR_OP_LOAD]        = { "load",         { V, 0, 0 }, 0 },
+    [IR_OP_STORE]       = { "store",        { V, V, 0 }, SIDE },
+    [IR_OP_PTRADD]      = { "ptradd",       { V, V, 0 }, 0 },
+    [IR_OP_MEMCOPY]     = { "memcopy",      { V, V, I }, SIDE },
+    [IR_OP_MEMZERO]     = { "memzero",      { V, I, 0 }, SIDE },
+    [IR_OP_CALL]        = { "call",         { V, L, 0 }, SIDE },
+
+    [IR_OP_BR]          = { "br",           { B, 0, 0 }, TERM | SIDE },
+    [IR_OP_CONDBR]      = { "condbr",       { V, B, B }, TERM | SIDE },
+    [IR_OP_SWITCH]      = { "switch",       { V, B, L }, TERM | SIDE | IR_OPCODE_FLAG_LIST_CASES },
+    [IR_OP_RET]         = { "ret",          { V, 0, 0 }, TERM | SIDE },
+    [IR_OP_UNREACHABLE] = { "unreachable",  { 0, 0, 0 }, TERM | SIDE },
+};
+
+#undef V
+#undef B
+#undef I
+#undef L
+#undef TERM
+#undef SIDE
+#undef COMM
+#undef CMP
+
+static const uint8_t s_IRTypeSizes[IR_TYPE_COUNT] = {
+    [IR_TYPE_VOID] = 0,
+    [IR_TYPE_I1] = 1,
+    [IR_TYPE_I8] = 1,
+    [IR_TYPE_I16] = 2,
+    [IR_TYPE_I32] = 4,
+    [IR_TYPE_I64] = 8,
+    [IR_TYPE_PTR] = IR_POINTER_SIZE,
+    [IR_TYPE_F32] = 4,
+    [IR_TYPE_F64] = 8,
+};
+
+static inline uint32_t IRListCapacity(const IRFunction function, uint32_t list)
+{
+    return function->pool[list + 1];
+}
+
+/* Size class of a list capacity, capacities are 2 << class */
+static uint32_t IRListClass(uint32_t capacity)
+{
+    uint32_t sizeClass = 0;
+    while ((2u << sizeClass) < capacity)
+        sizeClass++;
+
+    return sizeClass;
+}
+
+static ParserResult IRListAllocate(IRFunction function, uint32_t sizeClass, uint32_t* list)
+{
+    uint32_t capacity = 2u << sizeClass;
+
+    uint32_t handle = function->freeLists[sizeClass];
+    if (handle) {
+        function->freeLists[sizeClass] = function->pool[handle + IR_LIST_HEADER];
+    }
+    else {
+        uint32_t words = IR_LIST_HEADER + capacity;
+        if (words > UINT32_MAX - function->poolCount)
+            return PARSER_ERROR_NO_MEMORY;
+
+        CHECK_PARSER_RESULT(ParserArrayReserve((void**)&function->pool, &function->poolCapacity, function->poolCount,
+            function->poolCount + words, sizeof(uint32_t), 1));
+
+        handle = function->poolCount;
+        function->poolCount += words;
+    }
+
+    function->pool[handle] = 0;
+    function->pool[handle + 1] = capacity;
+    *list = handle;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+ParserResult IRListAppend(IRFunction function, uint32_t* list, uint32_t item)
+{
+    uint32_t handle = *list;
+
+    if (!handle) {
+        CHECK_PARSER_RESULT(IRListAllocate(function, 0, &handle));
+        *list = handle;
+    }
+    else if (IRListCount(function, handle) == IRListCapacity(function, handle)) {
+        uint32_t count = IRListCount(function, handle);
+        uint32_t moved;
+        CHECK_PARSER_RESULT(IRListAllocate(function, IRListClass(count) + 1, &moved));
+
+        memcpy(IRListItems(function, moved), IRListItems(function, handle), sizeof(uint32_t) * count);
+        function->pool[moved] = count;
+
+        IRListFree(function, handle);
+        handle = moved;
+        *list = handle;
+    }
+
+    IRListItems(function, handle)[function->pool[handle]++] = item;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+void IRListRemove(IRFunction function, uint32_t list, uint32_t index)
+{
+    uint32_t count = IRListCount(function, list);
+    if (index >= count)
+        return;
+
+    uint32_t* items = IRListItems(function, list);
+    memmove(&items[index], &items[index + 1], sizeof(uint32_t) * (count - index - 1));
+    function->pool[list]--;
+}
+
+void IRListFree(IRFunction function, uint32_t list)
+{
+    if (!list)
+        return;
+
+    uint32_t sizeClass = IRListClass(IRListCapacity(function, list));
+    function->pool[list + IR_LIST_HEADER] = function->freeLists[sizeClass];
+    function->freeLists[sizeClass] = list;
+}
+
+/* Constants and undefined values are shared too widely to keep uses */
+static inline bool IRFunctionHasUses(IRFunction function, uint32_t value)
+{
+    if (value == IR_VALUE_NONE || value >= function->instructionCount)
+        return false;
+
+    uint8_t opcode = IRFunctionRecord(function, value)->opcode;
+    return opcode != IR_OP_CONST && opcode != IR_OP_UNDEF;
+}
+
+static ParserResult IRFunctionAddUse(IRFunction function, IRValueId value, IRValueId user, uint32_t slot)
+{
+    if (!IRFunctionHasUses(function, value))
+        return PARSER_RESULT_SUCCESS;
+
+    IRInstruction* record = IRFunctionRecord(function, value);
+    CHECK_PARSER_RESULT(IRListAppend(function, &record->uses, user));
+    return IRListAppend(function, &record->uses, slot);
+}
+
+/* Drop one use, uses are unordered so the last one fills the hole */
+static void IRFunctionRemoveUse(IRFunction function, IRValueId value, IRValueId user, uint32_t slot)
+{
+    if (!IRFunctionHasUses(function, value))
+        return;
+
+    IRInstruction* record = IRFunctionRecord(function, value);
+    uint32_t count = IRListCount(function, record->uses);
+    uint32_t* items = IRListItems(function, record->uses);
+
+    for (uint32_t i = 0; i < count; i += 2) {
+        if (items[i] == user && items[i + 1] == slot) {
+            items[i] = items[count - 2];
+            items[i + 1] = items[count - 1];
+            function->pool[record->uses] -= 2;
+            return;
+        }
+    }
+}
+
+/* Move the use of `value` by list item `from` of `user` to item `to` */
+static void IRFunctionMoveUse(IRFunction function, IRValueId value, IRValueId user, uint32_t from, uint32_t to)
+{
+    if (!IRFunctionHasUses(function, value))
+        return;
+
+    IRInstruction* record = IRFunctionRecord(function, value);
+    uint32_t count = IRListCount(function, record->uses);
+    uint32_t* items = IRListItems(function, record->uses);
+
+    for (uint32_t i = 0; i < count; i += 2) {
+        if (items[i] == user && items[i + 1] == IR_USE_LIST_SLOT + from) {
+            items[i + 1] = IR_USE_LIST_SLOT + to;
+            return;
+        }
+    }
+}
+
+/* Slot of the list operand, 3 when the opcode has none */
+static uint32_t IRFunctionListSlot(IROpcode opcode)
+{
+    for (uint32_t i = 0; i < 3; i++) {
+        if (s_IROpcodeInfo[opcode].operands[i] == IR_OPERAND_LIST)
+            return i;
+    }
+
+    return 3;
+}
+
+static inline bool IRFunctionListHasValues(IROpcode opcode)
+{
+    return IRFunctionListSlot(opcode) < 3 && !(s_IROpcodeInfo[opcode].flags & IR_OPCODE_FLAG_LIST_CASES);
+}
+
+static ParserResult IRFunctionNewRecord(IRFunction function, IRValueId* id, IRInstruction** record)
+{
+    if (function->instructionCount == UINT32_MAX)
+        return PARSER_ERROR_NO_MEMORY;
+
+    if (function->instructionCount == function->pageCount * IR_PAGE_INSTRUCTIONS) {
+        CHECK_PARSER_RESULT(ParserArrayReserve((void**)&function->pages, &function->pageCapacity, function->pageCount,
+            function->pageCount + 1, sizeof(IRInstruction*), 16));
+
+        IRInstruction* page = ParserArena_Alloc(function->arena, sizeof(IRInstruction) * IR_PAGE_INSTRUCTIONS, 32);
+        if (!page)
+            return PARSER_ERROR_NO_MEMORY;
+
+        function->pages[function->pageCount++] = page;
+    }
+
+    *id = function->instructionCount++;
+    *record = IRFunctionRecord(function, *id);
+    memset(*record, 0, sizeof(IRInstruction));
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Link `id` into `block` before `before`, at the end for IR_VALUE_NONE */
+static void IRFunctionLink(IRFunction function, IRBlockId block, IRValueId id, IRValueId before)
+{
+    IRBlock* record = &function->blocks[block];
+    IRInstruction* instruction = IRFunctionRecord(function, id);
+
+    function->compact = false;
+    instruction->block = block;
+    instruction->next = before;
+
+    if (before == IR_VALUE_NONE) {
+        instruction->prev = record->last;
+        record->last = id;
+    }
+    else {
+        IRInstruction* next = IRFunctionRecord(function, before);
+        instruction->prev = next->prev;
+        next->prev = id;
+    }
+
+    if (instruction->prev == IR_VALUE_NONE)
+        record->first = id;
+    else
+        IRFunctionRecord(function, instruction->prev)->next = id;
+}
+
+static ParserResult IRFunctionSetOperands(IRFunction function, IRValueId id, const uint32_t operands[3])
+{
+    IRInstruction* record = IRFunctionRecord(function, id);
+    const IROpcodeInfo* info = &s_IROpcodeInfo[record->opcode];
+
+    for (uint32_t i = 0; i < 3; i++) {
+        record->operands[i] = operands[i];
+        if (info->operands[i] == IR_OPERAND_VALUE)
+            CHECK_PARSER_RESULT(IRFunctionAddUse(function, operands[i], id, i));
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static bool IRFunctionIsTerminated(IRFunction function, IRBlockId block)
+{
+    IRValueId last = function->blocks[block].last;
+    return last != IR_VALUE_NONE &&
+        (s_IROpcodeInfo[IRFunctionRecord(function, last)->opcode].flags & IR_OPCODE_FLAG_TERMINATOR);
+}
+
+/* Add `block` to the predecessors of every target of its terminator */
+static ParserResult IRFunctionAddEdges(IRFunction function, IRBlockId block)
+{
+    uint32_t count = IRFunction_GetSuccessorCount(function, block);
+    for (uint32_t i = 0; i < count; i++) {
+        IRBlockId target = IRFunction_GetSuccessor(function, block, i);
+        if (target == IR_BLOCK_NONE || target >= function->blockCount)
+            return PARSER_ERROR_INVALID_ARG;
+
+        CHECK_PARSER_RESULT(IRListAppend(function, &function->blocks[target].preds, block));
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Remove operand `index` from every phi of `block`, later operands move down */
+static void IRFunctionRemovePhiOperands(IRFunction function, IRBlockId block, uint32_t index)
+{
+    for (IRValueId phi = function->blocks[block].first; phi != IR_VALUE_NONE; phi = IRFunctionRecord(function, phi)->next) {
+        IRInstruction* instruction = IRFunctionRecord(function, phi);
+        if (instruction->opcode != IR_OP_PHI)
+            break;
+
+        uint32_t list = instruction->operands[0];
+        uint32_t operandCount = IRListCount(function, list);
+        if (index >= operandCount)
+            continue;
+
+        uint32_t* items = IRListItems(function, list);
+        IRFunctionRemoveUse(function, items[index], phi, IR_USE_LIST_SLOT + index);
+        for (uint32_t i = index + 1; i < operandCount; i++)
+            IRFunctionMoveUse(function, items[i], phi, i, i - 1);
+
+        IRListRemove(function, list, index);
+    }
+}
+
+/* Remove the edge from `block` into `target` with the phi operands it feeds */
+static void IRFunctionRemoveEdge(IRFunction function, IRBlockId block, IRBlockId target)
+{
+    IRBlock* record = &function->blocks[target];
+    uint32_t count = IRListCount(function, record->preds);
+    const uint32_t* preds = IRListItems(function, record->preds);
+
+    uint32_t index = 0;
+    while (index < count && preds[index] != block)
+        index++;
+
+    if (index == count)
+        return;
+
+    IRListRemove(function, record->preds, index);
+    IRFunctionRemovePhiOperands(function, target, index);
+}
+
+/* Check whether `block` is one of `blocks` */
+static bool IRFunctionIsListed(const IRBlockId* blocks, uint32_t count, IRBlockId block)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        if (blocks[i] == block)
+            return true;
+    }
+
+    return false;
+}
+
+/* Drop the uses an instruction makes and free its list */
+static void IRFunctionDropOperands(IRFunction function, IRValueId id)
+{
+    IRInstruction* record = IRFunctionRecord(function, id);
+    IROpcode opcode = (IROpcode)record->opcode;
+    const IROpcodeInfo* info = &s_IROpcodeInfo[opcode];
+
+    for (uint32_t i = 0; i < 3; i++) {
+        if (info->operands[i] == IR_OPERAND_VALUE) {
+            IRFunctionRemoveUse(function, record->operands[i], id, i);
+        }
+        else if (info->operands[i] == IR_OPERAND_LIST) {
+            uint32_t list = record->operands[i];
+            if (IRFunctionListHasValues(opcode)) {
+                uint32_t count = IRListCount(function, list);
+                for (uint32_t j = 0; j < count; j++)
+                    IRFunctionRemoveUse(function, IRListItems(function, list)[j], id, IR_USE_LIST_SLOT + j);
+            }
+
+            IRListFree(function, list);
+        }
+    }
+}
+
+static ParserResult IRFunctionGrowConstants(IRFunction function, uint32_t capacity)
+{
+    IRValueId* constants = PARSER_MALLOC(sizeof(IRValueId) * capacity, 0);
+    if (!constants)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(constants, 0, sizeof(IRValueId) * capacity);
+
+    for (uint32_t i = 0; i < function->constantCapacity; i++) {
+        IRValueId id = function->constants[i];
+        if (id == IR_VALUE_NONE)
+            continue;
+
+        const IRInstruction* record = IRFunctionRecord(function, id);
+        uint64_t bits = IR_CONST_BITS(record);
+        uint32_t slot = (uint32_t)((bits ^ record->type) * 0x9E3779B97F4A7C15ull >> 32) & (capacity - 1);
+        while (constants[slot] != IR_VALUE_NONE)
+            slot = (slot + 1) & (capacity - 1);
+
+        constants[slot] = id;
+    }
+
+    if (function->constants)
+        PARSER_FREE(function->constants);
+
+    function->constants = constants;
+    function->constantCapacity = capacity;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Copy a list to the end of a fresh pool, in the smallest slot that holds it */
+static uint32_t IRFunctionCopyList(IRFunction function, uint32_t* pool, uint32_t* poolCount, uint32_t list)
+{
+    uint32_t count = IRListCount(function, list);
+    if (!count)
+        return 0;
+
+    uint32_t handle = *poolCount;
+    uint32_t capacity = 2u << IRListClass(count);
+
+    pool[handle] = count;
+    pool[handle + 1] = capacity;
+    memcpy(&pool[handle + IR_LIST_HEADER], IRListItems(function, list), sizeof(uint32_t) * count);
+    *poolCount += IR_LIST_HEADER + capacity;
+
+    return handle;
+}
+
+/* Drop the blocks that are not in `blockMap`, values they define that are still used become undefined */
+static ParserResult IRFunctionRemoveUnreachable(IRFunction function, const IRBlockId* blockMap)
+{
+    // Terminators go first, so the phis of reachable blocks lose their operands
+    for (IRBlockId block = 1; block < function->blockCount; block++) {
+        if (!blockMap[block] && IRFunctionIsTerminated(function, block))
+            IRFunction_RemoveInstruction(function, function->blocks[block].last);
+    }
+
+    for (IRBlockId block = 1; block < function->blockCount; block++) {
+        if (blockMap[block])
+            continue;
+
+        IRValueId id;
+        while ((id = function->blocks[block].first) != IR_VALUE_NONE) {
+            IRInstruction* record = IRFunctionRecord(function, id);
+            if (IRListCount(function, record->uses)) {
+                IRValueId undef;
+                CHECK_PARSER_RESULT(IRFunction_GetUndef(function, (IRType)record->type, &undef));
+                CHECK_PARSER_RESULT(IRFunction_ReplaceAllUses(function, id, undef));
+            }
+
+            IRFunction_RemoveInstruction(function, id);
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+ParserResult IRFunctionReversePostorder(const IRFunction function, IRBlockId* order, uint32_t* count)
+{
+    uint32_t blockCount = function->blockCount;
+
+    // Path from the entry as (block, next successor) pairs, every block is pushed once
+    uint32_t* stack = PARSER_MALLOC(sizeof(uint32_t) * 2 * blockCount, 0);
+    uint8_t* seen = PARSER_MALLOC(blockCount, 0);
+    if (!stack || !seen) {
+        if (stack)
+            PARSER_FREE(stack);
+        if (seen)
+            PARSER_FREE(seen);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memset(seen, 0, blockCount);
+    seen[IR_BLOCK_ENTRY] = 1;
+    stack[0] = IR_BLOCK_ENTRY;
+    stack[1] = 0;
+
+    uint32_t depth = 1;
+    uint32_t visited = 0;
+
+    while (depth) {
+        uint32_t* top = &stack[(depth - 1) * 2];
+        if (top[1] < IRFunction_GetSuccessorCount(function, top[0])) {
+            IRBlockId successor = IRFunction_GetSuccessor(function, top[0], top[1]++);
+            if (!seen[successor]) {
+                seen[successor] = 1;
+                stack[depth * 2] = successor;
+                stack[depth * 2 + 1] = 0;
+                depth++;
+            }
+            continue;
+        }
+
+        order[visited++] = top[0];
+        depth--;
+    }
+
+    for (uint32_t i = 0; i < visited / 2; i++) {
+        IRBlockId swap = order[i];
+        order[i] = order[visited - 1 - i];
+        order[visited - 1 - i] = swap;
+    }
+
+    *count = visited;
+
+    PARSER_FREE(stack);
+    PARSER_FREE(seen);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/**
+ * @brief Move the live records, blocks and lists of a function to fresh storage in the new order
+ *
+ * @description `valueMap` and `oldIds` have a slot per record. Blocks in
+ *              `order` become 1 to `reachable`, as `blockMap` says.
+ */
+static ParserResult IRFunctionRenumber(IRFunction function, const IRBlockId* order, uint32_t reachable,
+    const IRBlockId* blockMap, IRValueId* valueMap, IRValueId* oldIds)
+{
+    memset(valueMap, 0, sizeof(IRValueId) * function->instructionCount);
+
+    // Shared values first, then the blocks one after the other
+    uint32_t count = 1;
+    for (IRValueId id = 1; id < function->instructionCount; id++) {
+        uint8_t opcode = IRFunctionRecord(function, id)->opcode;
+        if (opcode == IR_OP_CONST || opcode == IR_OP_UNDEF) {
+            valueMap[id] = count;
+            oldIds[count++] = id;
+        }
+    }
+
+    for (uint32_t i = 0; i < reachable; i++) {
+        for (IRValueId id = function->blocks[order[i]].first; id != IR_VALUE_NONE; id = IRFunctionRecord(function, id)->next) {
+            valueMap[id] = count;
+            oldIds[count++] = id;
+        }
+    }
+
+    uint32_t pageCount = (count + IR_PAGE_INSTRUCTIONS - 1) >> IR_PAGE_SHIFT;
+    uint32_t pageCapacity = pageCount > 16 ? pageCount : 16;
+    uint32_t blockCapacity = reachable + 1 > 64 ? reachable + 1 : 64;
+
+    // Every live list moves to a slot no larger than its current one
+    uint32_t poolCapacity = function->poolCount > 1024 ? function->poolCount : 1024;
+
+    ParserArenaConfig arenaConfig = { 64u * 1024u, NULL };
+    ParserArena arena = NULL;
+    IRInstruction** pages = PARSER_MALLOC(sizeof(IRInstruction*) * pageCapacity, 0);
+    IRBlock* blocks = PARSER_MALLOC(sizeof(IRBlock) * blockCapacity, 0);
+    uint32_t* pool = PARSER_MALLOC(sizeof(uint32_t) * poolCapacity, 0);
+    uint8_t* params = NULL;
+
+    bool allocated = pages && blocks && pool && ParserArena_Create(&arenaConfig, &arena) == PARSER_RESULT_SUCCESS;
+    for (uint32_t i = 0; allocated && i < pageCount; i++) {
+        pages[i] = ParserArena_Alloc(arena, sizeof(IRInstruction) * IR_PAGE_INSTRUCTIONS, 32);
+        allocated = pages[i] != NULL;
+    }
+
+    if (allocated && function->paramCount) {
+        params = ParserArena_Alloc(arena, function->paramCount, 1);
+        allocated = params != NULL;
+    }
+
+    if (!allocated) {
+        if (pages)
+            PARSER_FREE(pages);
+        if (blocks)
+            PARSER_FREE(blocks);
+        if (pool)
+            PARSER_FREE(pool);
+        if (arena)
+            ParserArena_Destroy(arena);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    uint32_t poolCount = IR_LIST_HEADER;
+    memset(pages[0], 0, sizeof(IRInstruction));
+
+    for (IRValueId id = 1; id < count; id++) {
+        const IRInstruction* old = IRFunctionRecord(function, oldIds[id]);
+        const IROpcodeInfo* info = &s_IROpcodeInfo[old->opcode];
+        IRInstruction* record = &pages[id >> IR_PAGE_SHIFT][id & (IR_PAGE_INSTRUCTIONS - 1)];
+
+        *record = *old;
+        record->block = blockMap[old->block];
+        record->prev = valueMap[old->prev];
+        record->next = valueMap[old->next];
+
+        for (uint32_t i = 0; i < 3; i++) {
+            if (info->operands[i] == IR_OPERAND_VALUE) {
+                record->operands[i] = valueMap[old->operands[i]];
+            }
+            else if (info->operands[i] == IR_OPERAND_BLOCK) {
+                record->operands[i] = blockMap[old->operands[i]];
+            }
+            else if (info->operands[i] == IR_OPERAND_LIST) {
+                uint32_t list = IRFunctionCopyList(function, pool, &poolCount, old->operands[i]);
+                uint32_t items = list ? pool[list] : 0;
+                uint32_t* item = &pool[list + IR_LIST_HEADER];
+
+                if (info->flags & IR_OPCODE_FLAG_LIST_CASES) {
+                    for (uint32_t j = 2; j < items; j += 3)
+                        item[j] = blockMap[item[j]];
+                }
+                else {
+                    for (uint32_t j = 0; j < items; j++)
+                        item[j] = valueMap[item[j]];
+                }
+
+                record->operands[i] = list;
+            }
+        }
+
+        // Uses are (user, slot) pairs
+        record->uses = IRFunctionCopyList(function, pool, &poolCount, old->uses);
+        uint32_t uses = record->uses ? pool[record->uses] : 0;
+        for (uint32_t j = 0; j < uses; j += 2)
+            pool[record->uses + IR_LIST_HEADER + j] = valueMap[pool[record->uses + IR_LIST_HEADER + j]];
+    }
+
+    memset(&blocks[0], 0, sizeof(IRBlock));
+    for (uint32_t i = 0; i < reachable; i++) {
+        const IRBlock* old = &function->blocks[order[i]];
+        IRBlock* block = &blocks[i + 1];
+
+        block->first = valueMap[old->first];
+        block->last = valueMap[old->last];
+        block->flags = old->flags;
+        block->preds = IRFunctionCopyList(function, pool, &poolCount, old->preds);
+
+        uint32_t preds = block->preds ? pool[block->preds] : 0;
+        for (uint32_t j = 0; j < preds; j++)
+            pool[block->preds + IR_LIST_HEADER + j] = blockMap[pool[block->preds + IR_LIST_HEADER + j]];
+    }
+
+    // The constant table hashes on type and bits, entries stay in their slots
+    for (uint32_t i = 0; i < function->constantCapacity; i++)
+        function->constants[i] = valueMap[function->constants[i]];
+    for (uint32_t i = 0; i < IR_TYPE_COUNT; i++)
+        function->undefs[i] = valueMap[function->undefs[i]];
+
+    if (function->paramCount)
+        memcpy(params, function->params, function->paramCount);
+
+    PARSER_FREE(function->pages);
+    PARSER_FREE(function->blocks);
+    PARSER_FREE(function->pool);
+    ParserArena_Destroy(function->arena);
+
+    function->arena = arena;
+    function->params = params;
+    function->pages = pages;
+    function->pageCount = pageCount;
+    function->pageCapacity = pageCapacity;
+    function->instructionCount = count;
+    function->blocks = blocks;
+    function->blockCount = reachable + 1;
+    function->blockCapacity = blockCapacity;
+    function->pool = pool;
+    function->poolCount = poolCount;
+    function->poolCapacity = poolCapacity;
+    memset(function->freeLists, 0, sizeof(function->freeLists));
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR const IROpcodeInfo* PARSER_CALL IROpcode_GetInfo(
+    IROpcode opcode)
+{
+    return (uint32_t)opcode < IR_OP_COUNT ? &s_IROpcodeInfo[opcode] : &s_IROpcodeInfo[IR_OP_NOP];
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRType_GetSize(
+    IRType type)
+{
+    return (uint32_t)type < IR_TYPE_COUNT ? s_IRTypeSizes[type] : 0;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRModule_CreateFunction(
+    IRModule module,
+    IRGlobalId global,
+    IRType returnType,
+    const uint8_t* params,
+    uint32_t paramCount,
+    IRFunction* function)
+{
+    if (!module || !function || (paramCount && !params) || global == IR_GLOBAL_NONE || global >= module->globalCount)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRGlobalInfo* info = &module->globals[global].info;
+    if (info->kind != IR_GLOBAL_KIND_FUNCTION || info->function)
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&module->functions, &module->functionCapacity, module->functionCount,
+        module->functionCount + 1, sizeof(IRFunction), 64));
+
+    IRFunction hdl = PARSER_MALLOC(sizeof(struct IRFunction_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct IRFunction_T));
+    hdl->module = module;
+    hdl->global = global;
+    hdl->returnType = (uint8_t)returnType;
+    hdl->paramCount = paramCount;
+    hdl->blockCount = 1;
+    hdl->blockCapacity = 64;
+    hdl->poolCount = IR_LIST_HEADER;
+    hdl->poolCapacity = 1024;
+
+    hdl->blocks = PARSER_MALLOC(sizeof(IRBlock) * hdl->blockCapacity, 0);
+    hdl->pool = PARSER_MALLOC(sizeof(uint32_t) * hdl->poolCapacity, 0);
+
+    // The arena starts small, most functions are
+    ParserArenaConfig arenaConfig = { 64u * 1024u, NULL };
+    IRValueId none;
+    IRInstruction* record;
+    IRBlockId entry;
+
+    if (!hdl->blocks || !hdl->pool ||
+        ParserArena_Create(&arenaConfig, &hdl->arena) != PARSER_RESULT_SUCCESS ||
+        IRFunctionGrowConstants(hdl, 64) != PARSER_RESULT_SUCCESS ||
+        IRFunctionNewRecord(hdl, &none, &record) != PARSER_RESULT_SUCCESS ||
+        IRFunction_AddBlock(hdl, &entry) != PARSER_RESULT_SUCCESS) {
+        module->functions[module->functionCount++] = hdl;
+        IRModule_RemoveFunction(module, hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    // Records 0 stand for IR_VALUE_NONE and IR_BLOCK_NONE
+    memset(&hdl->blocks[0], 0, sizeof(IRBlock));
+
+    if (paramCount) {
+        hdl->params = ParserArena_Alloc(hdl->arena, paramCount, 1);
+        if (!hdl->params) {
+            module->functions[module->functionCount++] = hdl;
+            IRModule_RemoveFunction(module, hdl);
+            return PARSER_ERROR_NO_MEMORY;
+        }
+
+        memcpy(hdl->params, params, paramCount);
+    }
+
+    info->function = hdl;
+    info->flags |= IR_GLOBAL_FLAG_DEFINED;
+    module->functions[module->functionCount++] = hdl;
+
+    *function = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL IRModule_RemoveFunction(
+    IRModule module,
+    IRFunction function)
+{
+    if (!module || !function)
+        return;
+
+    for (uint32_t i = 0; i < module->functionCount; i++) {
+        if (module->functions[i] != function)
+            continue;
+
+        memmove(&module->functions[i], &module->functions[i + 1], sizeof(IRFunction) * (module->functionCount - i - 1));
+        module->functionCount--;
+        break;
+    }
+
+    IRGlobalInfo* info = &module->globals[function->global].info;
+    if (info->function == function) {
+        info->function = NULL;
+        info->flags &= (uint8_t)~IR_GLOBAL_FLAG_DEFINED;
+    }
+
+    if (function->constants)
+        PARSER_FREE(function->constants);
+    if (function->pool)
+        PARSER_FREE(function->pool);
+    if (function->blocks)
+        PARSER_FREE(function->blocks);
+    if (function->pages)
+        PARSER_FREE(function->pages);
+    if (function->arena)
+        ParserArena_Destroy(function->arena);
+
+    PARSER_FREE(function);
+}
+
+PARSER_ATTR IRModule PARSER_CALL IRFunction_GetModule(
+    const IRFunction function)
+{
+    return function ? function->module : NULL;
+}
+
+PARSER_ATTR IRGlobalId PARSER_CALL IRFunction_GetGlobal(
+    const IRFunction function)
+{
+    return function ? function->global : IR_GLOBAL_NONE;
+}
+
+PARSER_ATTR IRType PARSER_CALL IRFunction_GetReturnType(
+    const IRFunction function)
+{
+    return function ? (IRType)function->returnType : IR_TYPE_VOID;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRFunction_GetParamCount(
+    const IRFunction function)
+{
+    return function ? function->paramCount : 0;
+}
+
+PARSER_ATTR IRType PARSER_CALL IRFunction_GetParamType(
+    const IRFunction function,
+    uint32_t index)
+{
+    if (!function || index >= function->paramCount)
+        return IR_TYPE_VOID;
+
+    return (IRType)function->params[index];
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AddBlock(
+    IRFunction function,
+    IRBlockId* block)
+{
+    if (!function || !block)
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&function->blocks, &function->blockCapacity, function->blockCount,
+        function->blockCount + 1, sizeof(IRBlock), 1));
+
+    *block = function->blockCount++;
+    memset(&function->blocks[*block], 0, sizeof(IRBlock));
+    function->compact = false;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AddInstruction(
+    IRFunction function,
+    IRBlockId block,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    uint32_t c,
+    IRValueId* id)
+{
+    if (!function || block == IR_BLOCK_NONE || block >= function->blockCount || (uint32_t)opcode >= IR_OP_COUNT ||
+        IRFunctionListSlot(opcode) < 3 || IRFunctionIsTerminated(function, block))
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRValueId newId;
+    IRInstruction* record;
+    CHECK_PARSER_RESULT(IRFunctionNewRecord(function, &newId, &record));
+
+    record->opcode = (uint8_t)opcode;
+    record->type = (uint8_t)type;
+    IRFunctionLink(function, block, newId, IR_VALUE_NONE);
+
+    const uint32_t operands[3] = { a, b, c };
+    CHECK_PARSER_RESULT(IRFunctionSetOperands(function, newId, operands));
+
+    if (s_IROpcodeInfo[opcode].flags & IR_OPCODE_FLAG_TERMINATOR)
+        CHECK_PARSER_RESULT(IRFunctionAddEdges(function, block));
+
+    if (id)
+        *id = newId;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AddListInstruction(
+    IRFunction function,
+    IRBlockId block,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    const uint32_t* items,
+    uint32_t count,
+    IRValueId* id)
+{
+    // Phis go to the head, even of a finished block
+    if (!function || block == IR_BLOCK_NONE || block >= function->blockCount || (uint32_t)opcode >= IR_OP_COUNT ||
+        (count && !items) || (opcode != IR_OP_PHI && IRFunctionIsTerminated(function, block)))
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint32_t listSlot = IRFunctionListSlot(opcode);
+    if (listSlot == 3)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRValueId newId;
+    IRInstruction* record;
+    CHECK_PARSER_RESULT(IRFunctionNewRecord(function, &newId, &record));
+
+    record->opcode = (uint8_t)opcode;
+    record->type = (uint8_t)type;
+
+    if (opcode == IR_OP_PHI) {
+        // Phis stay ahead of the other instructions of the block
+        IRValueId before = function->blocks[block].first;
+        while (before != IR_VALUE_NONE && IRFunctionRecord(function, before)->opcode == IR_OP_PHI)
+            before = IRFunctionRecord(function, before)->next;
+
+        IRFunctionLink(function, block, newId, before);
+    }
+    else {
+        IRFunctionLink(function, block, newId, IR_VALUE_NONE);
+    }
+
+    uint32_t operands[3] = { 0, 0, 0 };
+    const uint32_t given[2] = { a, b };
+    for (uint32_t i = 0, next = 0; i < 3; i++) {
+        if (i != listSlot && next < 2)
+            operands[i] = given[next++];
+    }
+
+    CHECK_PARSER_RESULT(IRFunctionSetOperands(function, newId, operands));
+
+    for (uint32_t i = 0; i < count; i++)
+        CHECK_PARSER_RESULT(IRFunction_AppendOperand(function, newId, items[i]));
+
+    if (s_IROpcodeInfo[opcode].flags & IR_OPCODE_FLAG_TERMINATOR)
+        CHECK_PARSER_RESULT(IRFunctionAddEdges(function, block));
+
+    if (id)
+        *id = newId;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_InsertInstruction(
+    IRFunction function,
+    IRValueId before,
+    IROpcode opcode,
+    IRType type,
+    uint32_t a,
+    uint32_t b,
+    uint32_t c,
+    IRValueId* id)
+{
+    if (!function || before == IR_VALUE_NONE || before >= function->instructionCount || (uint32_t)opcode >= IR_OP_COUNT ||
+        IRFunctionListSlot(opcode) < 3 || (s_IROpcodeInfo[opcode].flags & IR_OPCODE_FLAG_TERMINATOR))
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRBlockId block = IRFunctionRecord(function, before)->block;
+    if (block == IR_BLOCK_NONE)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRValueId newId;
+    IRInstruction* record;
+    CHECK_PARSER_RESULT(IRFunctionNewRecord(function, &newId, &record));
+
+    record->opcode = (uint8_t)opcode;
+    record->type = (uint8_t)type;
+    IRFunctionLink(function, block, newId, before);
+
+    const uint32_t operands[3] = { a, b, c };
+    CHECK_PARSER_RESULT(IRFunctionSetOperands(function, newId, operands));
+
+    if (id)
+        *id = newId;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AddPhi(
+    IRFunction function,
+    IRBlockId block,
+    IRType type,
+    IRValueId* id)
+{
+    return IRFunction_AddListInstruction(function, block, IR_OP_PHI, type, 0, 0, NULL, 0, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_AppendOperand(
+    IRFunction function,
+    IRValueId id,
+    uint32_t item)
+{
+    if (!function || id == IR_VALUE_NONE || id >= function->instructionCount)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRInstruction* record = IRFunctionRecord(function, id);
+    uint32_t listSlot = IRFunctionListSlot((IROpcode)record->opcode);
+    if (listSlot == 3)
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint32_t index = IRListCount(function, record->operands[listSlot]);
+    CHECK_PARSER_RESULT(IRListAppend(function, &record->operands[listSlot], item));
+
+    if (IRFunctionListHasValues((IROpcode)record->opcode))
+        CHECK_PARSER_RESULT(IRFunctionAddUse(function, item, id, IR_USE_LIST_SLOT + index));
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_SetOperand(
+    IRFunction function,
+    IRValueId id,
+    uint32_t slot,
+    uint32_t operand)
+{
+    if (!function || id == IR_VALUE_NONE || id >= function->instructionCount)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRInstruction* record = IRFunctionRecord(function, id);
+    IROpcode opcode = (IROpcode)record->opcode;
+
+    uint32_t* target;
+    bool isValue;
+
+    if (slot < IR_USE_LIST_SLOT) {
+        if (s_IROpcodeInfo[opcode].operands[slot] == IR_OPERAND_LIST)
+            return PARSER_ERROR_INVALID_ARG;
+
+        target = &record->operands[slot];
+        isValue = s_IROpcodeInfo[opcode].operands[slot] == IR_OPERAND_VALUE;
+    }
+    else {
+        uint32_t listSlot = IRFunctionListSlot(opcode);
+        if (listSlot == 3 || slot - IR_USE_LIST_SLOT >= IRListCount(function, record->operands[listSlot]))
+            return PARSER_ERROR_INVALID_ARG;
+
+        target = &IRListItems(function, record->operands[listSlot])[slot - IR_USE_LIST_SLOT];
+        isValue = IRFunctionListHasValues(opcode);
+    }
+
+    if (isValue)
+        IRFunctionRemoveUse(function, *target, id, slot);
+
+    // Adding the use may move the pool, the target is written first
+    *target = operand;
+
+    if (isValue)
+        CHECK_PARSER_RESULT(IRFunctionAddUse(function, operand, id, slot));
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL IRFunction_SetInstructionFlags(
+    IRFunction function,
+    IRValueId id,
+    uint32_t flags)
+{
+    if (function && id != IR_VALUE_NONE && id < function->instructionCount)
+        IRFunctionRecord(function, id)->flags |= (uint16_t)flags;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_GetConstant(
+    IRFunction function,
+    IRType type,
+    uint64_t bits,
+    IRValueId* id)
+{
+    if (!function || !id || type == IR_TYPE_VOID || (uint32_t)type >= IR_TYPE_COUNT)
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint32_t width = type == IR_TYPE_I1 ? 1 : s_IRTypeSizes[type] * 8;
+    if (width < 64)
+        bits &= (1ull << width) - 1;
+
+    uint32_t mask = function->constantCapacity - 1;
+    uint32_t slot = (uint32_t)((bits ^ type) * 0x9E3779B97F4A7C15ull >> 32) & mask;
+
+    while (function->constants[slot] != IR_VALUE_NONE) {
+        const IRInstruction* record = IRFunctionRecord(function, function->constants[slot]);
+        if (record->type == type && IR_CONST_BITS(record) == bits) {
+            *id = function->constants[slot];
+            return PARSER_RESULT_SUCCESS;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    IRValueId newId;
+    IRInstruction* record;
+    CHECK_PARSER_RESULT(IRFunctionNewRecord(function, &newId, &record));
+
+    record->opcode = IR_OP_CONST;
+    record->type = (uint8_t)type;
+    record->operands[0] = (uint32_t)bits;
+    record->operands[1] = (uint32_t)(bits >> 32);
+
+    function->constants[slot] = newId;
+    if (++function->constantCount * 2 > function->constantCapacity)
+        CHECK_PARSER_RESULT(IRFunctionGrowConstants(function, function->constantCapacity * 2));
+
+    *id = newId;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_GetUndef(
+    IRFunction function,
+    IRType type,
+    IRValueId* id)
+{
+    if (!function || !id || (uint32_t)type >= IR_TYPE_COUNT)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (function->undefs[type] == IR_VALUE_NONE) {
+        IRValueId newId;
+        IRInstruction* record;
+        CHECK_PARSER_RESULT(IRFunctionNewRecord(function, &newId, &record));
+
+        record->opcode = IR_OP_UNDEF;
+        record->type = (uint8_t)type;
+        function->undefs[type] = newId;
+    }
+
+    *id = function->undefs[type];
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_ReplaceAllUses(
+    IRFunction function,
+    IRValueId from,
+    IRValueId to)
+{
+    if (!function || from == IR_VALUE_NONE || from >= function->instructionCount || to >= function->instructionCount)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (from == to)
+        return PARSER_RESULT_SUCCESS;
+
+    uint32_t uses = IRFunctionRecord(function, from)->uses;
+    IRFunctionRecord(function, from)->uses = 0;
+
+    uint32_t count = IRListCount(function, uses);
+    for (uint32_t i = 0; i < count; i += 2) {
+        // Appending to the uses of `to` may move the pool
+        IRValueId user = IRListItems(function, uses)[i];
+        uint32_t slot = IRListItems(function, uses)[i + 1];
+        IRInstruction* record = IRFunctionRecord(function, user);
+
+        if (slot < IR_USE_LIST_SLOT)
+            record->operands[slot] = to;
+        else
+            IRListItems(function, record->operands[IRFunctionListSlot((IROpcode)record->opcode)])[slot - IR_USE_LIST_SLOT] = to;
+
+        CHECK_PARSER_RESULT(IRFunctionAddUse(function, to, user, slot));
+    }
+
+    IRListFree(function, uses);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL IRFunction_RemoveInstruction(
+    IRFunction function,
+    IRValueId id)
+{
+    if (!function || id == IR_VALUE_NONE || id >= function->instructionCount)
+        return;
+
+    IRInstruction* record = IRFunctionRecord(function, id);
+    IROpcode opcode = (IROpcode)record->opcode;
+    const IROpcodeInfo* info = &s_IROpcodeInfo[opcode];
+
+    if (opcode == IR_OP_NOP || opcode == IR_OP_CONST || opcode == IR_OP_UNDEF)
+        return;
+
+    IRBlockId block = record->block;
+
+    if (info->flags & IR_OPCODE_FLAG_TERMINATOR) {
+        uint32_t count = IRFunction_GetSuccessorCount(function, block);
+        for (uint32_t i = 0; i < count; i++)
+            IRFunctionRemoveEdge(function, block, IRFunction_GetSuccessor(function, block, i));
+    }
+
+    IRFunctionDropOperands(function, id);
+
+    // Unlink
+    IRBlock* blockRecord = &function->blocks[block];
+    function->compact = false;
+    if (record->prev == IR_VALUE_NONE)
+        blockRecord->first = record->next;
+    else
+        IRFunctionRecord(function, record->prev)->next = record->next;
+
+    if (record->next == IR_VALUE_NONE)
+        blockRecord->last = record->prev;
+    else
+        IRFunctionRecord(function, record->next)->prev = record->prev;
+
+    IRListFree(function, record->uses);
+
+    memset(record, 0, sizeof(IRInstruction));
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_FoldBranch(
+    IRFunction function,
+    IRBlockId block,
+    IRBlockId target)
+{
+    if (!function || block == IR_BLOCK_NONE || block >= function->blockCount || !IRFunctionIsTerminated(function, block))
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRValueId id = function->blocks[block].last;
+    uint32_t count = IRFunction_GetSuccessorCount(function, block);
+
+    uint32_t index = 0;
+    while (index < count && IRFunction_GetSuccessor(function, block, index) != target)
+        index++;
+
+    if (index == count)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (IRFunctionRecord(function, id)->opcode == IR_OP_BR)
+        return PARSER_RESULT_SUCCESS;
+
+    // One edge into the target stays
+    for (uint32_t i = 0; i < count; i++) {
+        if (i != index)
+            IRFunctionRemoveEdge(function, block, IRFunction_GetSuccessor(function, block, i));
+    }
+
+    IRFunctionDropOperands(function, id);
+
+    IRInstruction* record = IRFunctionRecord(function, id);
+    record->opcode = IR_OP_BR;
+    record->type = IR_TYPE_VOID;
+    record->flags = 0;
+    record->operands[0] = target;
+    record->operands[1] = 0;
+    record->operands[2] = 0;
+    function->compact = false;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR bool PARSER_CALL IRFunction_MergeBlock(
+    IRFunction function,
+    IRBlockId block)
+{
+    if (!function || block <= IR_BLOCK_ENTRY || block >= function->blockCount)
+        return false;
+
+    IRBlock* record = &function->blocks[block];
+    if (IRListCount(function, record->preds) != 1)
+        return false;
+
+    IRBlockId pred = IRListItems(function, record->preds)[0];
+    IRValueId branch = function->blocks[pred].last;
+    if (pred == block || branch == IR_VALUE_NONE || IRFunctionRecord(function, branch)->opcode != IR_OP_BR)
+        return false;
+
+    // With one predecessor every phi is its only operand
+    IRValueId id;
+    while ((id = record->first) != IR_VALUE_NONE && IRFunctionRecord(function, id)->opcode == IR_OP_PHI) {
+        IRInstruction* phi = IRFunctionRecord(function, id);
+        IRValueId value = IRListCount(function, phi->operands[0]) ? IRListItems(function, phi->operands[0])[0] : IR_VALUE_NONE;
+        if (value == id || value == IR_VALUE_NONE) {
+            if (IRFunction_GetUndef(function, (IRType)phi->type, &value) != PARSER_RESULT_SUCCESS)
+                return false;
+        }
+
+        if (IRFunction_ReplaceAllUses(function, id, value) != PARSER_RESULT_SUCCESS)
+            return false;
+
+        IRFunction_RemoveInstruction(function, id);
+    }
+
+    IRFunction_RemoveInstruction(function, branch);
+
+    // The successors see the predecessor in place of the block
+    uint32_t count = IRFunction_GetSuccessorCount(function, block);
+    for (uint32_t i = 0; i < count; i++) {
+        IRBlock* target = &function->blocks[IRFunction_GetSuccessor(function, block, i)];
+        uint32_t predCount = IRListCount(function, target->preds);
+        uint32_t* preds = IRListItems(function, target->preds);
+        for (uint32_t j = 0; j < predCount; j++) {
+            if (preds[j] == block)
+                preds[j] = pred;
+        }
+    }
+
+    IRBlock* into = &function->blocks[pred];
+    for (id = record->first; id != IR_VALUE_NONE; id = IRFunctionRecord(function, id)->next)
+        IRFunctionRecord(function, id)->block = pred;
+
+    if (record->first != IR_VALUE_NONE) {
+        IRFunctionRecord(function, record->first)->prev = into->last;
+        if (into->last == IR_VALUE_NONE)
+            into->first = record->first;
+        else
+            IRFunctionRecord(function, into->last)->next = record->first;
+        into->last = record->last;
+    }
+
+    record->first = IR_VALUE_NONE;
+    record->last = IR_VALUE_NONE;
+    record->flags |= IR_BLOCK_FLAG_REMOVED;
+    function->compact = false;
+
+    return true;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_SplitBlock(
+    IRFunction function,
+    IRValueId after,
+    IRBlockId* block)
+{
+    if (!function || !block || after == IR_VALUE_NONE || after >= function->instructionCount)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRInstruction* record = IRFunctionRecord(function, after);
+    IRValueId first = record->next;
+    if (record->block == IR_BLOCK_NONE || (s_IROpcodeInfo[record->opcode].flags & IR_OPCODE_FLAG_TERMINATOR) ||
+        (first != IR_VALUE_NONE && IRFunctionRecord(function, first)->opcode == IR_OP_PHI))
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRBlockId from = record->block;
+    IRBlockId newBlock;
+    CHECK_PARSER_RESULT(IRFunction_AddBlock(function, &newBlock));
+
+    *block = newBlock;
+    if (first == IR_VALUE_NONE)
+        return PARSER_RESULT_SUCCESS;
+
+    IRBlock* source = &function->blocks[from];
+    IRBlock* target = &function->blocks[newBlock];
+    target->first = first;
+    target->last = source->last;
+    source->last = after;
+    record->next = IR_VALUE_NONE;
+    IRFunctionRecord(function, first)->prev = IR_VALUE_NONE;
+
+    for (IRValueId id = first; id != IR_VALUE_NONE; id = IRFunctionRecord(function, id)->next)
+        IRFunctionRecord(function, id)->block = newBlock;
+
+    // The successors see the new block in place of the old one
+    uint32_t count = IRFunction_GetSuccessorCount(function, newBlock);
+    for (uint32_t i = 0; i < count; i++) {
+        IRBlock* successor = &function->blocks[IRFunction_GetSuccessor(function, newBlock, i)];
+        uint32_t predCount = IRListCount(function, successor->preds);
+        uint32_t* preds = IRListItems(function, successor->preds);
+        for (uint32_t j = 0; j < predCount; j++) {
+            if (preds[j] == from)
+                preds[j] = newBlock;
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_SplitPredecessors(
+    IRFunction function,
+    IRBlockId block,
+    const IRBlockId* preds,
+    uint32_t count,
+    IRBlockId* newBlock)
+{
+    if (!function || !newBlock || !preds || !count || block == IR_BLOCK_NONE || block >= function->blockCount)
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint32_t predCount = IRListCount(function, function->blocks[block].preds);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!IRFunctionIsListed(IRListItems(function, function->blocks[block].preds), predCount, preds[i]))
+            return PARSER_ERROR_INVALID_ARG;
+    }
+
+    IRBlockId split;
+    CHECK_PARSER_RESULT(IRFunction_AddBlock(function, &split));
+
+    // Every phi takes the operand of the new edge last, the moved ones are dropped after
+    for (IRValueId phi = function->blocks[block].first; phi != IR_VALUE_NONE; phi = IRFunctionRecord(function, phi)->next) {
+        if (IRFunctionRecord(function, phi)->opcode != IR_OP_PHI)
+            break;
+
+        IRValueId value = IR_VALUE_NONE;
+        uint32_t moved = 0;
+        for (uint32_t j = 0; j < predCount; j++) {
+            if (IRFunctionIsListed(preds, count, IRListItems(function, function->blocks[block].preds)[j])) {
+                value = IRListItems(function, IRFunctionRecord(function, phi)->operands[0])[j];
+                moved++;
+            }
+        }
+
+        if (moved > 1) {
+            CHECK_PARSER_RESULT(IRFunction_AddPhi(function, split, (IRType)IRFunctionRecord(function, phi)->type, &value));
+
+            // Appending may move the pool, the items are fetched again every time
+            for (uint32_t j = 0; j < predCount; j++) {
+                if (IRFunctionIsListed(preds, count, IRListItems(function, function->blocks[block].preds)[j]))
+                    CHECK_PARSER_RESULT(IRFunction_AppendOperand(function, value,
+                        IRListItems(function, IRFunctionRecord(function, phi)->operands[0])[j]));
+            }
+        }
+
+        CHECK_PARSER_RESULT(IRFunction_AppendOperand(function, phi, value));
+    }
+
+    for (uint32_t j = 0; j < predCount; j++) {
+        IRBlockId pred = IRListItems(function, function->blocks[block].preds)[j];
+        if (IRFunctionIsListed(preds, count, pred))
+            CHECK_PARSER_RESULT(IRListAppend(function, &function->blocks[split].preds, pred));
+    }
+
+    for (uint32_t j = predCount; j-- > 0;) {
+        if (IRFunctionIsListed(preds, count, IRListItems(function, function->blocks[block].preds)[j])) {
+            IRListRemove(function, function->blocks[block].preds, j);
+            IRFunctionRemovePhiOperands(function, block, j);
+        }
+    }
+
+    // Retarget the terminators, every edge of a listed block into the block moves
+    for (uint32_t i = 0; i < count; i++) {
+        IRInstruction* record = IRFunctionRecord(function, function->blocks[preds[i]].last);
+        const IROpcodeInfo* info = &s_IROpcodeInfo[record->opcode];
+
+        for (uint32_t slot = 0; slot < 3; slot++) {
+            if (info->operands[slot] == IR_OPERAND_BLOCK && record->operands[slot] == block)
+                record->operands[slot] = split;
+        }
+
+        if (info->flags & IR_OPCODE_FLAG_LIST_CASES) {
+            uint32_t list = record->operands[IRFunctionListSlot((IROpcode)record->opcode)];
+            uint32_t itemCount = IRListCount(function, list);
+            uint32_t* items = IRListItems(function, list);
+            for (uint32_t j = 2; j < itemCount; j += 3) {
+                if (items[j] == block)
+                    items[j] = split;
+            }
+        }
+    }
+
+    CHECK_PARSER_RESULT(IRFunction_AddInstruction(function, split, IR_OP_BR, IR_TYPE_VOID, block, 0, 0, NULL));
+    *newBlock = split;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR const IRInstruction* PARSER_CALL IRFunction_GetInstruction(
+    const IRFunction function,
+    IRValueId id)
+{
+    if (!function || id == IR_VALUE_NONE || id >= function->instructionCount)
+        return NULL;
+
+    return IRFunctionRecord(function, id);
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRFunction_GetInstructionCount(
+    const IRFunction function)
+{
+    return function ? function->instructionCount : 0;
+}
+
+PARSER_ATTR const uint32_t* PARSER_CALL IRFunction_GetList(
+    const IRFunction function,
+    IRValueId id,
+    uint32_t* count)
+{
+    *count = 0;
+
+    if (!function || id == IR_VALUE_NONE || id >= function->instructionCount)
+        return NULL;
+
+    const IRInstruction* record = IRFunctionRecord(function, id);
+    uint32_t listSlot = IRFunctionListSlot((IROpcode)record->opcode);
+    if (listSlot == 3 || !record->operands[listSlot])
+        return NULL;
+
+    *count = IRListCount(function, record->operands[listSlot]);
+
+    return IRListItems(function, record->operands[listSlot]);
+}
+
+PARSER_ATTR const IRUse* PARSER_CALL IRFunction_GetUses(
+    const IRFunction function,
+    IRValueId id,
+    uint32_t* count)
+{
+    *count = 0;
+
+    if (!function || id == IR_VALUE_NONE || id >= function->instructionCount)
+        return NULL;
+
+    uint32_t uses = IRFunctionRecord(function, id)->uses;
+    if (!uses)
+        return NULL;
+
+    *count = IRListCount(function, uses) / 2;
+
+    return (const IRUse*)IRListItems(function, uses);
+}
+
+PARSER_ATTR const IRBlock* PARSER_CALL IRFunction_GetBlock(
+    const IRFunction function,
+    IRBlockId block)
+{
+    if (!function || block == IR_BLOCK_NONE || block >= function->blockCount)
+        return NULL;
+
+    return &function->blocks[block];
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRFunction_GetBlockCount(
+    const IRFunction function)
+{
+    return function ? function->blockCount : 0;
+}
+
+PARSER_ATTR const IRBlockId* PARSER_CALL IRFunction_GetPredecessors(
+    const IRFunction function,
+    IRBlockId block,
+    uint32_t* count)
+{
+    *count = 0;
+
+    if (!function || block == IR_BLOCK_NONE || block >= function->blockCount || !function->blocks[block].preds)
+        return NULL;
+
+    *count = IRListCount(function, function->blocks[block].preds);
+
+    return IRListItems(function, function->blocks[block].preds);
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRFunction_GetSuccessorCount(
+    const IRFunction function,
+    IRBlockId block)
+{
+    if (!function || block == IR_BLOCK_NONE || block >= function->blockCount || !IRFunctionIsTerminated(function, block))
+        return 0;
+
+    const IRInstruction* record = IRFunctionRecord(function, function->blocks[block].last);
+    switch (record->opcode) {
+    case IR_OP_BR:
+        return 1;
+    case IR_OP_CONDBR:
+        return 2;
+    case IR_OP_SWITCH:
+        return 1 + IRListCount(function, record->operands[2]) / 3;
+    default:
+        return 0;
+    }
+}
+
+PARSER_ATTR IRBlockId PARSER_CALL IRFunction_GetSuccessor(
+    const IRFunction function,
+    IRBlockId block,
+    uint32_t index)
+{
+    if (index >= IRFunction_GetSuccessorCount(function, block))
+        return IR_BLOCK_NONE;
+
+    const IRInstruction* record = IRFunctionRecord(function, function->blocks[block].last);
+    switch (record->opcode) {
+    case IR_OP_BR:
+        return record->operands[0];
+    case IR_OP_CONDBR:
+        return record->operands[1 + index];
+    default:
+        return index == 0 ? record->operands[1] : IRListItems(function, record->operands[2])[(index - 1) * 3 + 2];
+    }
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_Compact(
+    IRFunction function)
+{
+    if (!function)
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint32_t blockCount = function->blockCount;
+    IRBlockId* order = PARSER_MALLOC(sizeof(IRBlockId) * blockCount * 2, 0);
+    if (!order)
+        return PARSER_ERROR_NO_MEMORY;
+
+    IRBlockId* blockMap = order + blockCount;
+    memset(blockMap, 0, sizeof(IRBlockId) * blockCount);
+
+    uint32_t reachable = 0;
+    ParserResult result = IRFunctionReversePostorder(function, order, &reachable);
+
+    for (uint32_t i = 0; i < reachable; i++)
+        blockMap[order[i]] = i + 1;
+
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRFunctionRemoveUnreachable(function, blockMap);
+
+    if (result == PARSER_RESULT_SUCCESS) {
+        // Dropping blocks may have added undefined values
+        IRValueId* valueMap = PARSER_MALLOC(sizeof(IRValueId) * function->instructionCount * 2, 0);
+        if (valueMap) {
+            result = IRFunctionRenumber(function, order, reachable, blockMap, valueMap, valueMap + function->instructionCount);
+            PARSER_FREE(valueMap);
+        }
+        else {
+            result = PARSER_ERROR_NO_MEMORY;
+        }
+    }
+
+    PARSER_FREE(order);
+
+    if (result == PARSER_RESULT_SUCCESS)
+        function->compact = true;
+
+    return result;
+}
+
+PARSER_ATTR bool PARSER_CALL IRFunction_IsCompact(
+    const IRFunction function)
+{
+    return function && function->compact;
+}
+
+PARSER_ATTR void PARSER_CALL IRFunction_GetStats(
+    const IRFunction function,
+    IRFunctionStats* stats)
+{
+    memset(stats, 0, sizeof(IRFunctionStats));
+
+    if (!function)
+        return;
+
+    for (IRValueId id = 1; id < function->instructionCount; id++) {
+        const IRInstruction* record = IRFunctionRecord(function, id);
+        if (record->opcode == IR_OP_CONST || record->opcode == IR_OP_UNDEF)
+            stats->values++;
+        else if (record->block != IR_BLOCK_NONE)
+            stats->instructions++;
+    }
+
+    stats->records = function->instructionCount - 1;
+    stats->blocks = function->blockCount - 1;
+    stats->listWords = function->poolCount;
+    stats->bytes = (size_t)function->pageCount * IR_PAGE_INSTRUCTIONS * sizeof(IRInstruction) +
+        (size_t)function->blockCapacity * sizeof(IRBlock) + (size_t)function->poolCapacity * sizeof(uint32_t);
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,839 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRPasses.h"
+#include "ir/IRLoops.h"
+#include "IRInternal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define IR_INLINE_FREQUENCY_CAP         (IR_INLINE_FREQUENCY_ONE * 8u)  // A call weighs at most eight calls
+#define IR_INLINE_LOOP_SCALE            3u                              // log2 of the iterations assumed per loop
+#define IR_INLINE_UNVISITED             UINT32_MAX
+
+/* Call of a function defined in the module */
+typedef struct IRInlineSite_T {
+    IRValueId call;
+    uint32_t callee;                    // Function index
+    uint32_t frequency;                 // Times IR_INLINE_FREQUENCY_ONE
+    int64_t growth;                     // Instructions the module grows by when inlined
+    int64_t rank;                       // Growth per execution, the lowest goes first
+    bool onlyCall;                      // The callee goes with the call, `growth` counts it as removed
+} IRInlineSite;
+
+typedef struct IRInliner_T {
+    IRModule module;
+    IRInlineConfig config;              // Defaults filled in
+    uint32_t functionCount;
+    uint32_t globalCount;
+
+    IRFunction* functions;              // As the module lists them when the pass starts
+    uint32_t* functionOf;               // Function index + 1 of a global, 0 for none
+    uint32_t* references;               // Uses of IR_OP_GLOBAL values of a global, over the module
+    uint32_t* cost;                     // Of every function
+    uint32_t* component;                // Strongly connected component of the call graph
+    uint32_t* order;                    // Functions, callees before their callers
+
+    int64_t budget;                     // Instructions the module may still grow by
+    uint32_t callsInlined;
+
+    IRInlineSite* sites;
+    uint32_t siteCapacity;
+    uint32_t* items;                    // List of the instruction being cloned
+    uint32_t itemCapacity;
+} IRInliner;
+
+/* Callee and caller of one inlined call, block `sources[i]` of the callee is cloned to `firstBlock` + i */
+typedef struct IRInlineClone_T {
+    IRInliner* inliner;
+    IRFunction caller;
+    IRFunction callee;
+    IRValueId* valueMap;
+    IRBlockId* blockMap;                // Clone of every callee block
+    IRBlockId* sources;                 // Reachable callee blocks in reverse postorder
+    uint32_t blockCount;                // Reachable callee blocks
+    IRBlockId firstBlock;
+} IRInlineClone;
+
+/* Instructions a function costs in code: parameters and stack slots take none, returns become branches that merge away */
+static uint32_t IRInlineCost(const IRFunction function)
+{
+    uint32_t cost = 0;
+    uint32_t blockCount = IRFunction_GetBlockCount(function);
+
+    for (IRBlockId block = 1; block < blockCount; block++) {
+        const IRBlock* record = IRFunction_GetBlock(function, block);
+        if (record->flags & IR_BLOCK_FLAG_REMOVED)
+            continue;
+
+        for (IRValueId id = record->first; id != IR_VALUE_NONE; id = IRFunction_GetInstruction(function, id)->next) {
+            IROpcode opcode = (IROpcode)IRFunction_GetInstruction(function, id)->opcode;
+            if (opcode != IR_OP_PARAM && opcode != IR_OP_ALLOCA && opcode != IR_OP_RET)
+                cost++;
+        }
+    }
+
+    return cost;
+}
+
+/* Add, or take away, the uses a function makes of every global */
+static void IRInlineCountReferences(IRInliner* inliner, const IRFunction function, bool add)
+{
+    uint32_t blockCount = IRFunction_GetBlockCount(function);
+
+    for (IRBlockId block = 1; block < blockCount; block++) {
+        const IRBlock* record = IRFunction_GetBlock(function, block);
+        if (record->flags & IR_BLOCK_FLAG_REMOVED)
+            continue;
+
+        for (IRValueId id = record->first; id != IR_VALUE_NONE; id = IRFunction_GetInstruction(function, id)->next) {
+            const IRInstruction* instruction = IRFunction_GetInstruction(function, id);
+            if (instruction->opcode != IR_OP_GLOBAL || instruction->operands[0] > inliner->globalCount)
+                continue;
+
+            uint32_t uses;
+            IRFunction_GetUses(function, id, &uses);
+            if (add)
+                inliner->references[instruction->operands[0]] += uses;
+            else
+                inliner->references[instruction->operands[0]] -= uses;
+        }
+    }
+}
+
+/* Function index + 1 a call goes straight to, 0 for calls through a pointer or to declarations */
+static uint32_t IRInlineCallee(const IRInliner* inliner, const IRFunction function, const IRInstruction* call)
+{
+    const IRInstruction* callee = IRFunction_GetInstruction(function, call->operands[0]);
+    if (!callee || callee->opcode != IR_OP_GLOBAL || callee->operands[0] > inliner->globalCount)
+        return 0;
+
+    return inliner->functionOf[callee->operands[0]];
+}
+
+/*
+ * Number the strongly connected components of the call graph with Tarjan's
+ * algorithm, on an explicit stack; a component is finished after every
+ * component it calls, which is the order functions are processed in
+ */
+static ParserResult IRInlineOrder(IRInliner* inliner)
+{
+    uint32_t count = inliner->functionCount;
+
+    // Direct calls as ranges of callee indices per function
+    uint32_t edgeCount = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        IRFunction function = inliner->functions[i];
+        uint32_t valueCount = IRFunction_GetInstructionCount(function);
+        for (IRValueId id = 1; id < valueCount; id++) {
+            const IRInstruction* instruction = IRFunction_GetInstruction(function, id);
+            if (instruction->opcode == IR_OP_CALL && instruction->block != IR_BLOCK_NONE &&
+                IRInlineCallee(inliner, function, instruction))
+                edgeCount++;
+        }
+    }
+
+    size_t words = (size_t)count * 6 + 1 + edgeCount;
+    uint32_t* memory = PARSER_MALLOC(sizeof(uint32_t) * words, 0);
+    if (!memory)
+        return PARSER_ERROR_NO_MEMORY;
+
+    uint32_t* edgeStart = memory;                   // count + 1
+    uint32_t* edges = edgeStart + count + 1;        // edgeCount
+    uint32_t* index = edges + edgeCount;            // Visit number, IR_INLINE_UNVISITED before
+    uint32_t* low = index + count;
+    uint32_t* stack = low + count;                  // Visited functions without a component
+    uint32_t* path = stack + count;                 // Depth first path as (function, next edge) pairs
+
+    uint32_t edge = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        edgeStart[i] = edge;
+
+        IRFunction function = inliner->functions[i];
+        uint32_t valueCount = IRFunction_GetInstructionCount(function);
+        for (IRValueId id = 1; id < valueCount; id++) {
+            const IRInstruction* instruction = IRFunction_GetInstruction(function, id);
+            uint32_t callee;
+            if (instruction->opcode == IR_OP_CALL && instruction->block != IR_BLOCK_NONE &&
+                (callee = IRInlineCallee(inliner, function, instruction)) != 0)
+                edges[edge++] = callee - 1;
+        }
+
+        index[i] = IR_INLINE_UNVISITED;
+        inliner->component[i] = IR_INLINE_UNVISITED;
+    }
+    edgeStart[count] = edge;
+
+    uint32_t visited = 0;
+    uint32_t stackTop = 0;
+    uint32_t finished = 0;
+    uint32_t components = 0;
+
+    for (uint32_t root = 0; root < count; root++) {
+        if (index[root] != IR_INLINE_UNVISITED)
+            continue;
+
+        path[0] = root;
+        path[1] = edgeStart[root];
+        index[root] = low[root] = visited++;
+        stack[stackTop++] = root;
+        uint32_t depth = 1;
+
+        while (depth) {
+            uint32_t* top = &path[(depth - 1) * 2];
+            uint32_t function = top[0];
+
+            if (top[1] < edgeStart[function + 1]) {
+                uint32_t callee = edges[top[1]++];
+                if (index[callee] == IR_INLINE_UNVISITED) {
+                    index[callee] = low[callee] = visited++;
+                    stack[stackTop++] = callee;
+                    path[depth * 2] = callee;
+                    path[depth * 2 + 1] = edgeStart[callee];
+                    depth++;
+                }
+                else if (inliner->component[callee] == IR_INLINE_UNVISITED && index[callee] < low[function]) {
+                    // Still on the stack, part of the component being built
+                    low[function] = index[callee];
+                }
+                continue;
+            }
+
+            depth--;
+            if (low[function] == index[function]) {
+                uint32_t member;
+                do {
+                    member = stack[--stackTop];
+                    inliner->component[member] = components;
+                    inliner->order[finished++] = member;
+                } while (member != function);
+                components++;
+            }
+
+            if (depth) {
+                uint32_t caller = path[(depth - 1) * 2];
+                if (low[function] < low[caller])
+                    low[caller] = low[function];
+            }
+        }
+    }
+
+    PARSER_FREE(memory);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static int IRInlineCompareSites(const void* a, const void* b)
+{
+    const IRInlineSite* siteA = (const IRInlineSite*)a;
+    const IRInlineSite* siteB = (const IRInlineSite*)b;
+
+    if (siteA->rank != siteB->rank)
+        return siteA->rank < siteB->rank ? -1 : 1;
+
+    // Program order breaks ties, so the result does not depend on qsort
+    return siteA->call < siteB->call ? -1 : (siteA->call > siteB->call ? 1 : 0);
+}
+
+/* Executions of a call per execution of its function, from the callback or the loops around it */
+static uint32_t IRInlineFrequency(const IRInliner* inliner, const IRFunction function, const IRLoopTree loops,
+    IRValueId call)
+{
+    if (inliner->config.pfnFrequency)
+        return inliner->config.pfnFrequency(inliner->config.pUserData, function, call);
+
+    uint32_t depth = IRLoopTree_GetDepth(loops, IRFunction_GetInstruction(function, call)->block);
+    if (depth * IR_INLINE_LOOP_SCALE >= 16)
+        return IR_INLINE_FREQUENCY_CAP;
+
+    uint32_t frequency = IR_INLINE_FREQUENCY_ONE << (depth * IR_INLINE_LOOP_SCALE);
+    return frequency < IR_INLINE_FREQUENCY_CAP ? frequency : IR_INLINE_FREQUENCY_CAP;
+}
+
+/* Whether a call can be replaced by the body of its callee at all */
+static bool IRInlineIsPossible(const IRFunction caller, IRValueId call, const IRFunction callee)
+{
+    const IRInstruction* instruction = IRFunction_GetInstruction(caller, call);
+    if (callee == caller || instruction->type != IRFunction_GetReturnType(callee))
+        return false;
+
+    uint32_t argCount;
+    const uint32_t* args = IRFunction_GetList(caller, call, &argCount);
+    if (argCount != IRFunction_GetParamCount(callee))
+        return false;
+
+    for (uint32_t i = 0; i < argCount; i++) {
+        if (IRFunction_GetInstruction(caller, args[i])->type != IRFunction_GetParamType(callee, i))
+            return false;
+    }
+
+    // The entry of the callee becomes an ordinary block, a branch back into it would be an edge into the call
+    uint32_t predCount;
+    IRFunction_GetPredecessors(callee, IR_BLOCK_ENTRY, &predCount);
+
+    return predCount == 0;
+}
+
+static ParserResult IRInlineReserveItems(IRInliner* inliner, uint32_t count)
+{
+    // The items of the last clone are not kept
+    return ParserArrayReserve((void**)&inliner->items, &inliner->itemCapacity, 0, count, sizeof(uint32_t), 16);
+}
+
+/* Caller value of a callee value, constants and undefined values are made on the way */
+static ParserResult IRInlineMapValue(IRInlineClone* clone, IRValueId value, IRValueId* mapped)
+{
+    if (value == IR_VALUE_NONE || clone->valueMap[value] != IR_VALUE_NONE) {
+        *mapped = value == IR_VALUE_NONE ? IR_VALUE_NONE : clone->valueMap[value];
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    const IRInstruction* instruction = IRFunction_GetInstruction(clone->callee, value);
+    if (instruction->opcode == IR_OP_CONST) {
+        CHECK_PARSER_RESULT(IRFunction_GetConstant(clone->caller, (IRType)instruction->type, IR_CONST_BITS(instruction),
+            &clone->valueMap[value]));
+    }
+    else if (instruction->opcode == IR_OP_UNDEF) {
+        CHECK_PARSER_RESULT(IRFunction_GetUndef(clone->caller, (IRType)instruction->type, &clone->valueMap[value]));
+    }
+    else {
+        // Values are cloned before their uses, besides phi operands
+        return PARSER_ERROR_INVALID_ARG;
+    }
+
+    *mapped = clone->valueMap[value];
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Clone an instruction with a list, switch cases keep their bounds and take the cloned block */
+static ParserResult IRInlineCloneList(IRInlineClone* clone, IRBlockId block, IRValueId id, IRValueId* newId)
+{
+    const IRInstruction* instruction = IRFunction_GetInstruction(clone->callee, id);
+    IROpcode opcode = (IROpcode)instruction->opcode;
+
+    uint32_t count;
+    const uint32_t* items = IRFunction_GetList(clone->callee, id, &count);
+    CHECK_PARSER_RESULT(IRInlineReserveItems(clone->inliner, count));
+
+    uint32_t* mapped = clone->inliner->items;
+    uint32_t a = 0;
+    uint32_t b = 0;
+
+    if (opcode == IR_OP_SWITCH) {
+        for (uint32_t i = 0; i < count; i++)
+            mapped[i] = i % 3 == 2 ? clone->blockMap[items[i]] : items[i];
+
+        CHECK_PARSER_RESULT(IRInlineMapValue(clone, instruction->operands[0], &a));
+        b = clone->blockMap[instruction->operands[1]];
+    }
+    else {
+        for (uint32_t i = 0; i < count; i++)
+            CHECK_PARSER_RESULT(IRInlineMapValue(clone, items[i], &mapped[i]));
+
+        CHECK_PARSER_RESULT(IRInlineMapValue(clone, instruction->operands[0], &a));
+    }
+
+    return IRFunction_AddListInstruction(clone->caller, block, opcode, (IRType)instruction->type, a, b, mapped, count,
+        newId);
+}
+
+/* Operands of every cloned phi, in the order of the predecessors its block has in the caller */
+static ParserResult IRInlinePatchPhis(IRInlineClone* clone)
+{
+    for (uint32_t i = 0; i < clone->blockCount; i++) {
+        IRBlockId source = clone->sources[i];
+        IRBlockId block = clone->firstBlock + i;
+
+        uint32_t sourcePredCount;
+        const IRBlockId* sourcePreds = IRFunction_GetPredecessors(clone->callee, source, &sourcePredCount);
+
+        for (IRValueId phi = IRFunction_GetBlock(clone->callee, source)->first; phi != IR_VALUE_NONE;
+            phi = IRFunction_GetInstruction(clone->callee, phi)->next) {
+            if (IRFunction_GetInstruction(clone->callee, phi)->opcode != IR_OP_PHI)
+                break;
+
+            uint32_t operandCount;
+            const uint32_t* operands = IRFunction_GetList(clone->callee, phi, &operandCount);
+
+            uint32_t predCount;
+            IRFunction_GetPredecessors(clone->caller, block, &predCount);
+
+            for (uint32_t k = 0; k < predCount; k++) {
+                // Appending may move the list pool of the caller
+                const IRBlockId* preds = IRFunction_GetPredecessors(clone->caller, block, &predCount);
+                IRBlockId pred = clone->sources[preds[k] - clone->firstBlock];
+
+                // The n-th edge from a block in the clone is the n-th edge from its source
+                uint32_t occurrence = 0;
+                for (uint32_t j = 0; j < k; j++)
+                    occurrence += preds[j] == preds[k];
+
+                uint32_t index = 0;
+                while (index < sourcePredCount && (sourcePreds[index] != pred || occurrence--))
+                    index++;
+
+                IRValueId value;
+                if (index < operandCount)
+                    CHECK_PARSER_RESULT(IRInlineMapValue(clone, operands[index], &value));
+                else
+                    CHECK_PARSER_RESULT(IRFunction_GetUndef(clone->caller,
+                        (IRType)IRFunction_GetInstruction(clone->callee, phi)->type, &value));
+
+                CHECK_PARSER_RESULT(IRFunction_AppendOperand(clone->caller, clone->valueMap[phi], value));
+            }
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Clone the blocks of the callee, then branch from the call into them and from every return to the rest of its block */
+static ParserResult IRInlineCloneBody(IRInlineClone* clone, IRValueId call, IRBlockId rest, IRValueId* returns,
+    uint32_t* returnCount)
+{
+    uint32_t argCount;
+    const uint32_t* args = IRFunction_GetList(clone->caller, call, &argCount);
+    IRValueId entryFirst = IRFunction_GetBlock(clone->caller, IR_BLOCK_ENTRY)->first;
+
+    for (uint32_t i = 0; i < clone->blockCount; i++) {
+        IRBlockId source = clone->sources[i];
+        IRBlockId block = clone->firstBlock + i;
+
+        for (IRValueId id = IRFunction_GetBlock(clone->callee, source)->first; id != IR_VALUE_NONE;
+            id = IRFunction_GetInstruction(clone->callee, id)->next) {
+            const IRInstruction* instruction = IRFunction_GetInstruction(clone->callee, id);
+            IROpcode opcode = (IROpcode)instruction->opcode;
+            IRType type = (IRType)instruction->type;
+            IRValueId newId = IR_VALUE_NONE;
+
+            switch (opcode) {
+            case IR_OP_PARAM:
+                // The call may move the pool, the arguments are read again
+                args = IRFunction_GetList(clone->caller, call, &argCount);
+                clone->valueMap[id] = args[instruction->operands[0]];
+                continue;
+
+            case IR_OP_ALLOCA:
+                // Stack slots stay in the frame of the caller, one per inlined call
+                CHECK_PARSER_RESULT(IRFunction_InsertInstruction(clone->caller, entryFirst, opcode, type,
+                    instruction->operands[0], instruction->operands[1], 0, &newId));
+                break;
+
+            case IR_OP_PHI:
+                CHECK_PARSER_RESULT(IRFunction_AddPhi(clone->caller, block, type, &newId));
+                break;
+
+            case IR_OP_RET:
+                returns[(*returnCount)++] = instruction->operands[0];
+                CHECK_PARSER_RESULT(IRFunction_AddInstruction(clone->caller, block, IR_OP_BR, IR_TYPE_VOID, rest, 0, 0,
+                    NULL));
+                continue;
+
+            case IR_OP_CALL:
+            case IR_OP_SWITCH:
+                CHECK_PARSER_RESULT(IRInlineCloneList(clone, block, id, &newId));
+                break;
+
+            default: {
+                const IROpcodeInfo* info = IROpcode_GetInfo(opcode);
+                uint32_t operands[3];
+                for (uint32_t j = 0; j < 3; j++) {
+                    operands[j] = instruction->operands[j];
+                    if (info->operands[j] == IR_OPERAND_VALUE)
+                        CHECK_PARSER_RESULT(IRInlineMapValue(clone, operands[j], &operands[j]));
+                    else if (info->operands[j] == IR_OPERAND_BLOCK)
+                        operands[j] = clone->blockMap[operands[j]];
+                }
+
+                CHECK_PARSER_RESULT(IRFunction_AddInstruction(clone->caller, block, opcode, type, operands[0],
+                    operands[1], operands[2], &newId));
+                break;
+            }
+            }
+
+            if (instruction->flags)
+                IRFunction_SetInstructionFlags(clone->caller, newId, instruction->flags);
+
+            clone->valueMap[id] = newId;
+        }
+    }
+
+    return IRInlinePatchPhis(clone);
+}
+
+/*
+ * Replace a call by a copy of the reachable blocks of its callee: the block
+ * of the call is split after it, returns branch to the second half and
+ * their values meet in a phi there
+ */
+static ParserResult IRInlineCall(IRInliner* inliner, IRFunction caller, IRValueId call, IRFunction callee)
+{
+    uint32_t valueCount = IRFunction_GetInstructionCount(callee);
+    uint32_t blockCount = IRFunction_GetBlockCount(callee);
+
+    size_t size = sizeof(uint32_t) * ((size_t)valueCount + (size_t)blockCount * 3);
+    uint32_t* memory = PARSER_MALLOC(size, 0);
+    if (!memory)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(memory, 0, size);
+
+    IRInlineClone clone;
+    clone.inliner = inliner;
+    clone.caller = caller;
+    clone.callee = callee;
+    clone.valueMap = memory;
+    clone.blockMap = memory + valueCount;
+    clone.sources = clone.blockMap + blockCount;
+    clone.blockCount = 0;
+    clone.firstBlock = IR_BLOCK_NONE;
+
+    IRValueId* returns = clone.sources + blockCount;     // Value of every return, in the order they branch to `rest`
+    uint32_t returnCount = 0;
+
+    IRBlockId rest = IR_BLOCK_NONE;
+    IRBlockId from = IRFunction_GetInstruction(caller, call)->block;
+
+    ParserResult result = IRFunctionReversePostorder(callee, clone.sources, &clone.blockCount);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRFunction_SplitBlock(caller, call, &rest);
+
+    for (uint32_t i = 0; i < clone.blockCount && result == PARSER_RESULT_SUCCESS; i++) {
+        IRBlockId block;
+        result = IRFunction_AddBlock(caller, &block);
+        if (i == 0)
+            clone.firstBlock = block;
+        clone.blockMap[clone.sources[i]] = block;
+    }
+
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRInlineCloneBody(&clone, call, rest, returns, &returnCount);
+
+    // The result of the call is what the returns give
+    IRValueId value = IR_VALUE_NONE;
+    IRType type = IRFunction_GetReturnType(callee);
+    if (result == PARSER_RESULT_SUCCESS && type != IR_TYPE_VOID) {
+        if (returnCount == 1) {
+            result = IRInlineMapValue(&clone, returns[0], &value);
+        }
+        else if (returnCount == 0) {
+            result = IRFunction_GetUndef(caller, type, &value);
+        }
+        else {
+            result = IRFunction_AddPhi(caller, rest, type, &value);
+            for (uint32_t i = 0; i < returnCount && result == PARSER_RESULT_SUCCESS; i++) {
+                IRValueId operand;
+                result = IRInlineMapValue(&clone, returns[i], &operand);
+                if (result == PARSER_RESULT_SUCCESS)
+                    result = IRFunction_AppendOperand(caller, value, operand);
+            }
+        }
+
+        if (result == PARSER_RESULT_SUCCESS)
+            result = IRFunction_ReplaceAllUses(caller, call, value);
+    }
+
+    if (result == PARSER_RESULT_SUCCESS) {
+        IRFunction_RemoveInstruction(caller, call);
+        result = IRFunction_AddInstruction(caller, from, IR_OP_BR, IR_TYPE_VOID, clone.firstBlock, 0, 0, NULL);
+    }
+
+    PARSER_FREE(memory);
+
+    return result;
+}
+
+/* Find the calls of a function worth inlining, the cheapest per execution first */
+static ParserResult IRInlineFindSites(IRInliner* inliner, uint32_t caller, uint32_t* siteCount)
+{
+    IRFunction function = inliner->functions[caller];
+    uint32_t valueCount = IRFunction_GetInstructionCount(function);
+    *siteCount = 0;
+
+    uint32_t callCount = 0;
+    for (IRValueId id = 1; id < valueCount; id++) {
+        const IRInstruction* instruction = IRFunction_GetInstruction(function, id);
+        if (instruction->opcode == IR_OP_CALL && instruction->block != IR_BLOCK_NONE)
+            callCount++;
+    }
+
+    if (callCount == 0)
+        return PARSER_RESULT_SUCCESS;
+
+    if (callCount > inliner->siteCapacity) {
+        IRInlineSite* sites = PARSER_MALLOC(sizeof(IRInlineSite) * callCount, 0);
+        if (!sites)
+            return PARSER_ERROR_NO_MEMORY;
+
+        if (inliner->sites)
+            PARSER_FREE(inliner->sites);
+
+        inliner->sites = sites;
+        inliner->siteCapacity = callCount;
+    }
+
+    // Loops are only needed to estimate how often a call runs
+    IRDomTree domTree = NULL;
+    IRLoopTree loops = NULL;
+    if (!inliner->config.pfnFrequency) {
+        ParserResult result = CreateIRDomTree(function, &domTree);
+        if (result == PARSER_RESULT_SUCCESS)
+            result = CreateIRLoopTree(function, domTree, &loops);
+
+        if (result != PARSER_RESULT_SUCCESS) {
+            IRDomTreeDestroy(domTree);
+            return result;
+        }
+    }
+
+    const IRInlineConfig* config = &inliner->config;
+
+    for (IRValueId id = 1; id < valueCount; id++) {
+        const IRInstruction* instruction = IRFunction_GetInstruction(function, id);
+        if (instruction->opcode != IR_OP_CALL || instruction->block == IR_BLOCK_NONE)
+            continue;
+
+        uint32_t callee = IRInlineCallee(inliner, function, instruction);
+        if (callee-- == 0 || inliner->component[callee] == inliner->component[caller] ||
+            !IRInlineIsPossible(function, id, inliner->functions[callee]))
+            continue;
+
+        // The call, its arguments and its result go, the body comes in
+        uint32_t argCount;
+        IRFunction_GetList(function, id, &argCount);
+
+        IRGlobalId global = IRFunction_GetGlobal(inliner->functions[callee]);
+        const IRGlobalInfo* info = IRModule_GetGlobal(inliner->module, global);
+
+        IRInlineSite* site = &inliner->sites[*siteCount];
+        site->call = id;
+        site->callee = callee;
+        site->frequency = IRInlineFrequency(inliner, function, loops, id);
+        site->onlyCall = (info->flags & IR_GLOBAL_FLAG_INTERNAL) && inliner->references[global] == 1;
+
+        int64_t growth = (int64_t)inliner->cost[callee] - (2 + (int64_t)argCount);
+        if (site->onlyCall)
+            growth -= inliner->cost[callee];
+        site->growth = growth;
+
+        if (growth > 0) {
+            // Growth is worth as many instructions as the call runs times the threshold
+            uint32_t weight = site->frequency < IR_INLINE_FREQUENCY_CAP ? site->frequency : IR_INLINE_FREQUENCY_CAP;
+            uint64_t threshold = config->threshold + ((info->flags & IR_GLOBAL_FLAG_INLINE) ? config->hintBonus : 0);
+            if ((uint64_t)growth * IR_INLINE_FREQUENCY_ONE > threshold * weight)
+                continue;
+
+            site->rank = growth * IR_INLINE_FREQUENCY_ONE * IR_INLINE_FREQUENCY_ONE / (weight ? weight : 1);
+        }
+        else {
+            site->rank = growth - INT32_MAX;
+        }
+
+        (*siteCount)++;
+    }
+
+    IRLoopTreeDestroy(loops);
+    IRDomTreeDestroy(domTree);
+
+    if (*siteCount > 1)
+        qsort(inliner->sites, *siteCount, sizeof(IRInlineSite), IRInlineCompareSites);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Inline the chosen calls of a function while the budget lasts */
+static ParserResult IRInlineFunction(IRInliner* inliner, uint32_t caller)
+{
+    uint32_t siteCount;
+    CHECK_PARSER_RESULT(IRInlineFindSites(inliner, caller, &siteCount));
+
+    IRFunction function = inliner->functions[caller];
+    bool changed = false;
+
+    for (uint32_t i = 0; i < siteCount; i++) {
+        const IRInlineSite* site = &inliner->sites[i];
+        IRFunction callee = inliner->functions[site->callee];
+        IRGlobalId global = IRFunction_GetGlobal(callee);
+
+        // The budget may have run out, or an earlier call copied more references to the callee in
+        int64_t growth = site->growth;
+        if (site->onlyCall && inliner->references[global] != 1)
+            growth += inliner->cost[site->callee];
+        if (growth > 0 && growth > inliner->budget)
+            continue;
+
+        CHECK_PARSER_RESULT(IRInlineCall(inliner, function, site->call, callee));
+
+        // The call goes, the uses the body makes come in
+        inliner->references[global]--;
+        IRInlineCountReferences(inliner, callee, true);
+        inliner->budget -= growth;
+        inliner->callsInlined++;
+        changed = true;
+    }
+
+    if (changed || !IRFunction_IsCompact(function))
+        CHECK_PARSER_RESULT(IRFunction_Compact(function));
+
+    inliner->cost[caller] = IRInlineCost(function);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Whether a function is internal and nothing refers to it, and so can go */
+static bool IRInlineIsUnused(const IRInliner* inliner, IRGlobalId global)
+{
+    return inliner->functionOf[global] && inliner->references[global] == 0 &&
+        (IRModule_GetGlobal(inliner->module, global)->flags & IR_GLOBAL_FLAG_INTERNAL);
+}
+
+/* Remove internal functions nothing refers to any more, and then what only they referred to */
+static ParserResult IRInlineRemoveUnused(IRInliner* inliner, uint32_t* removed)
+{
+    uint32_t count = inliner->functionCount;
+    *removed = 0;
+
+    uint32_t* stack = PARSER_MALLOC(sizeof(uint32_t) * (count + 1), 0);
+    uint8_t* dead = PARSER_MALLOC(count + 1, 0);
+    if (!stack || !dead) {
+        if (stack)
+            PARSER_FREE(stack);
+        if (dead)
+            PARSER_FREE(dead);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memset(dead, 0, count + 1);
+
+    // Counted again, the running count only ever overestimates
+    memset(inliner->references, 0, sizeof(uint32_t) * (inliner->globalCount + 1));
+    for (uint32_t i = 0; i < count; i++)
+        IRInlineCountReferences(inliner, inliner->functions[i], true);
+
+    uint32_t top = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (IRInlineIsUnused(inliner, IRFunction_GetGlobal(inliner->functions[i]))) {
+            dead[i] = 1;
+            stack[top++] = i;
+        }
+    }
+
+    while (top) {
+        IRFunction function = inliner->functions[stack[--top]];
+        IRInlineCountReferences(inliner, function, false);
+
+        // Only the globals the dead function referred to can have dropped to nothing
+        uint32_t valueCount = IRFunction_GetInstructionCount(function);
+        for (IRValueId id = 1; id < valueCount; id++) {
+            const IRInstruction* instruction = IRFunction_GetInstruction(function, id);
+            if (instruction->opcode != IR_OP_GLOBAL || instruction->block == IR_BLOCK_NONE ||
+                instruction->operands[0] > inliner->globalCount)
+                continue;
+
+            IRGlobalId global = instruction->operands[0];
+            if (IRInlineIsUnused(inliner, global) && !dead[inliner->functionOf[global] - 1]) {
+                dead[inliner->functionOf[global] - 1] = 1;
+                stack[top++] = inliner->functionOf[global] - 1;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (dead[i]) {
+            IRModule_RemoveFunction(inliner->module, inliner->functions[i]);
+            (*removed)++;
+        }
+    }
+
+    PARSER_FREE(stack);
+    PARSER_FREE(dead);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL IRModule_InlineFunctions(
+    IRModule module,
+    const IRInlineConfig* config,
+    IRPassStats* stats)
+{
+    if (!module)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRInliner inliner;
+    memset(&inliner, 0, sizeof(IRInliner));
+    inliner.module = module;
+    inliner.functionCount = IRModule_GetFunctionCount(module);
+    inliner.globalCount = IRModule_GetGlobalCount(module);
+
+    if (config)
+        inliner.config = *config;
+    if (!inliner.config.threshold)
+        inliner.config.threshold = IR_INLINE_DEFAULT_THRESHOLD;
+    if (!inliner.config.hintBonus)
+        inliner.config.hintBonus = IR_INLINE_DEFAULT_HINT_BONUS;
+    if (!inliner.config.growthPercent)
+        inliner.config.growthPercent = IR_INLINE_DEFAULT_GROWTH_PERCENT;
+
+    uint32_t count = inliner.functionCount;
+    size_t size = sizeof(IRFunction) * (count + 1) +
+        sizeof(uint32_t) * ((size_t)(inliner.globalCount + 1) * 2 + (size_t)count * 3);
+
+    uint8_t* memory = PARSER_MALLOC(size, 0);
+    if (!memory)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(memory, 0, size);
+    inliner.functions = (IRFunction*)memory;
+    inliner.functionOf = (uint32_t*)(inliner.functions + count + 1);
+    inliner.references = inliner.functionOf + inliner.globalCount + 1;
+    inliner.cost = inliner.references + inliner.globalCount + 1;
+    inliner.component = inliner.cost + count;
+    inliner.order = inliner.component + count;
+
+    uint64_t moduleCost = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        IRFunction function = IRModule_GetFunction(module, i);
+        inliner.functions[i] = function;
+        inliner.functionOf[IRFunction_GetGlobal(function)] = i + 1;
+        inliner.cost[i] = IRInlineCost(function);
+        moduleCost += inliner.cost[i];
+        IRInlineCountReferences(&inliner, function, true);
+    }
+
+    // The budget lets at least one call of threshold size in
+    inliner.budget = inliner.config.growthLimit ? (int64_t)inliner.config.growthLimit :
+        (int64_t)(moduleCost * inliner.config.growthPercent / 100);
+    if (!inliner.config.growthLimit && inliner.budget < (int64_t)inliner.config.threshold)
+        inliner.budget = inliner.config.threshold;
+
+    uint32_t removed = 0;
+    ParserResult result = IRInlineOrder(&inliner);
+    for (uint32_t i = 0; i < count && result == PARSER_RESULT_SUCCESS; i++)
+        result = IRInlineFunction(&inliner, inliner.order[i]);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRInlineRemoveUnused(&inliner, &removed);
+
+    if (stats) {
+        stats->callsInlined += inliner.callsInlined;
+        stats->functionsRemoved += removed;
+    }
+
+    if (inliner.sites)
+        PARSER_FREE(inliner.sites);
+    if (inliner.items)
+        PARSER_FREE(inliner.items);
+    PARSER_FREE(memory);
+
+    return result;
+}
@@ -0,0 +1,141 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef IR_INTERNAL_H
+#define IR_INTERNAL_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IR.h"
+#include "parser/ParserArena.h"
+
+#include "../parser/ParserArray.h"
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define IR_PAGE_SHIFT                   10u     // log2(IR_PAGE_INSTRUCTIONS)
+#define IR_LIST_HEADER                  2u      // count, capacity
+#define IR_LIST_CLASS_COUNT             24u     // Capacities 2 << class
+
+/*
+ * Lists (phi operands, call arguments, switch cases, predecessors and use
+ * lists) live in one pool of 32-bit words per function. A handle is the
+ * offset of the header; 0 is the empty list. A list that outgrows its
+ * capacity moves to a slot of twice the size, the old slot goes on the free
+ * list of its size class.
+ */
+struct IRFunction_T {
+    IRModule module;
+    IRGlobalId global;
+    ParserArena arena;              // Instruction pages and block tables
+
+    uint8_t returnType;
+    uint8_t* params;
+    uint32_t paramCount;
+
+    // ===== Instructions =====
+    IRInstruction** pages;
+    uint32_t pageCount;
+    uint32_t pageCapacity;
+    uint32_t instructionCount;      // Next id, record 0 is never used
+
+    // ===== Blocks =====
+    IRBlock* blocks;
+    uint32_t blockCount;            // Next id, record 0 is never used
+    uint32_t blockCapacity;
+
+    // ===== List pool =====
+    uint32_t* pool;
+    uint32_t poolCount;
+    uint32_t poolCapacity;
+    uint32_t freeLists[IR_LIST_CLASS_COUNT];
+
+    // ===== Constants =====
+    IRValueId* constants;           // Open addressing, on type and bits
+    uint32_t constantCount;
+    uint32_t constantCapacity;
+    IRValueId undefs[IR_TYPE_COUNT];
+
+    bool compact;                   // Blocks are id ranges, cleared by any change
+};
+
+typedef struct IRGlobal_T {
+    IRGlobalInfo info;
+    uint32_t hash;                  // Of the name
+} IRGlobal;
+
+struct IRModule_T {
+    ParserArena arena;              // Names and initializers
+
+    IRGlobal* globals;              // Record 0 is never used
+    uint32_t globalCount;
+    uint32_t globalCapacity;
+
+    uint32_t* names;                // Open addressing on the name hash
+    uint32_t nameCapacity;
+
+    IRFunction* functions;
+    uint32_t functionCount;
+    uint32_t functionCapacity;
+};
+
+static inline IRInstruction* IRFunctionRecord(IRFunction function, IRValueId id)
+{
+    return &function->pages[id >> IR_PAGE_SHIFT][id & (IR_PAGE_INSTRUCTIONS - 1)];
+}
+
+static inline uint32_t IRListCount(const IRFunction function, uint32_t list)
+{
+    return list ? function->pool[list] : 0;
+}
+
+static inline uint32_t* IRListItems(IRFunction function, uint32_t list)
+{
+    return &function->pool[list + IR_LIST_HEADER];
+}
+
+/**
+ * @brief Append an item to a list, moving it when full
+ *
+ * @param list[in,out] List handle, 0 starts a new list
+ */
+ParserResult IRListAppend(IRFunction function, uint32_t* list, uint32_t item);
+
+/**
+ * @brief Remove item `index`, later items move down one place
+ */
+void IRListRemove(IRFunction function, uint32_t list, uint32_t index);
+
+/**
+ * @brief Return a list to the pool
+ */
+void IRListFree(IRFunction function, uint32_t list);
+
+/**
+ * @brief Get the blocks reachable from the entry in reverse postorder
+ *
+ * @param order[out] One slot per block record
+ * @param count[out] Number of reachable blocks, the entry comes first
+ */
+ParserResult IRFunctionReversePostorder(const IRFunction function, IRBlockId* order, uint32_t* count);
+
+/**
+ * @brief Evaluate an instruction on constant operands
+ *
+ * @param type[in] Result type
+ * @param operandType[in] Type of the first operand, for comparisons and conversions
+ * @param result[out] Bits of the result, masked to its width
+ *
+ * @return false when the result is not defined, such as a division by zero
+ *         or a shift by the width, or the opcode does not fold
+ */
+bool IRFold(IROpcode opcode, IRType type, IRType operandType, uint64_t a, uint64_t b, uint64_t* result);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !IR_INTERNAL_H
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,771 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRPasses.h"
+#include "ir/IRLoops.h"
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define IR_LOOP_MEMO_LIMIT              32u     // Values made for one loop that are looked up to be shared
+
+typedef enum IRAffineFlags {
+    IR_AFFINE_FLAG_NONE             = 0,
+    IR_AFFINE_FLAG_LINEAR           = 1 << 0,   // start + iteration * step
+    IR_AFFINE_FLAG_SCALED           = 1 << 1,   // A multiply or shift on the way from the variable
+    IR_AFFINE_FLAG_EXTENDED         = 1 << 2,   // An extension on the way from the variable
+    IR_AFFINE_FLAG_NO_SIGNED_WRAP   = 1 << 3,   // Basic variable the exit test keeps in the signed range
+    IR_AFFINE_FLAG_NO_UNSIGNED_WRAP = 1 << 4,
+} IRAffineFlags;
+
+/* Value linear in the iteration, its value in the first one and what every back edge adds */
+typedef struct IRAffine_T {
+    IRValueId start;                    // Defined at the end of the preheader
+    IRValueId step;                     // Invariant, IR_TYPE_I64 for pointers
+    uint32_t flags;                     // IRAffineFlags
+} IRAffine;
+
+/* Instruction the pass made, or phi it made for a start and step */
+typedef struct IRLoopMemo_T {
+    uint32_t opcode;
+    uint32_t type;
+    IRValueId a;
+    IRValueId b;
+    IRValueId value;
+} IRLoopMemo;
+
+/*
+ * The affine table has a slot per instruction record, it grows with the
+ * function and is cleared over the blocks of a loop when done with it.
+ * Values made after the table was sized are never affine.
+ */
+typedef struct IRLoopOpt_T {
+    IRFunction function;
+    IRDomTree domTree;
+    IRLoopTree loops;
+    IRBlockId* scratch;                 // One slot per block record
+
+    IRAffine* affine;
+    uint32_t capacity;
+
+    IRLoopMemo emitted[IR_LOOP_MEMO_LIMIT];
+    uint32_t emittedCount;
+    IRLoopMemo reduced[IR_LOOP_MEMO_LIMIT];
+    uint32_t reducedCount;
+
+    // Current loop
+    IRLoopId loop;
+    IRBlockId header;
+    IRBlockId preheader;
+    IRBlockId latch;
+    uint32_t preheaderIndex;            // Of the edges into the header
+    uint32_t latchIndex;
+    IRValueId firstMade;                // Records from here on were made for the loop
+
+    uint32_t hoisted;
+    uint32_t inductions;
+} IRLoopOpt;
+
+static ParserResult IRLoopOptBuildTrees(IRLoopOpt* opt)
+{
+    if (opt->loops)
+        IRLoopTreeDestroy(opt->loops);
+    if (opt->domTree)
+        IRDomTreeDestroy(opt->domTree);
+    if (opt->scratch)
+        PARSER_FREE(opt->scratch);
+
+    opt->loops = NULL;
+    opt->domTree = NULL;
+    opt->scratch = PARSER_MALLOC(sizeof(IRBlockId) * IRFunction_GetBlockCount(opt->function), 0);
+    if (!opt->scratch)
+        return PARSER_ERROR_NO_MEMORY;
+
+    CHECK_PARSER_RESULT(CreateIRDomTree(opt->function, &opt->domTree));
+    return CreateIRLoopTree(opt->function, opt->domTree, &opt->loops);
+}
+
+static inline bool IRLoopOptIsInvariant(const IRLoopOpt* opt, IRValueId value)
+{
+    const IRInstruction* record = IRFunction_GetInstruction(opt->function, value);
+
+    return !record || record->block == IR_BLOCK_NONE || !IRLoopTree_Contains(opt->loops, opt->loop, record->block);
+}
+
+static inline bool IRLoopOptIsConstant(const IRLoopOpt* opt, IRValueId value, uint64_t* bits)
+{
+    const IRInstruction* record = IRFunction_GetInstruction(opt->function, value);
+    if (!record || record->opcode != IR_OP_CONST)
+        return false;
+
+    *bits = IR_CONST_BITS(record);
+    return true;
+}
+
+static inline bool IRLoopOptIsInteger(IRType type)
+{
+    return type >= IR_TYPE_I8 && type <= IR_TYPE_I64;
+}
+
+/* Outside blocks with an edge into the header, each once; the number of such edges in `edges` */
+static uint32_t IRLoopOptFindEntries(IRLoopOpt* opt, IRLoopId loop, uint32_t* edges)
+{
+    IRBlockId header = IRLoopTree_GetHeader(opt->loops, loop);
+
+    uint32_t predCount;
+    const IRBlockId* preds = IRFunction_GetPredecessors(opt->function, header, &predCount);
+
+    uint32_t count = 0;
+    *edges = 0;
+    for (uint32_t i = 0; i < predCount; i++) {
+        if (IRLoopTree_Contains(opt->loops, loop, preds[i]))
+            continue;
+
+        (*edges)++;
+
+        uint32_t j = 0;
+        while (j < count && opt->scratch[j] != preds[i])
+            j++;
+        if (j == count)
+            opt->scratch[count++] = preds[i];
+    }
+
+    return count;
+}
+
+/*
+ * Split a preheader off the edges into every header that has none, the
+ * trees are built again when the blocks changed. A new block is a
+ * predecessor of its header only, so the headers still to do see it as
+ * outside of their loop.
+ */
+static ParserResult IRLoopOptAddPreheaders(IRLoopOpt* opt)
+{
+    bool changed = false;
+
+    uint32_t loopCount = IRLoopTree_GetLoopCount(opt->loops);
+    for (IRLoopId loop = 1; loop < loopCount; loop++) {
+        uint32_t edges;
+        uint32_t count = IRLoopOptFindEntries(opt, loop, &edges);
+        if (count == 0 || (edges == 1 && IRFunction_GetSuccessorCount(opt->function, opt->scratch[0]) == 1))
+            continue;
+
+        IRBlockId preheader;
+        CHECK_PARSER_RESULT(IRFunction_SplitPredecessors(opt->function, IRLoopTree_GetHeader(opt->loops, loop),
+            opt->scratch, count, &preheader));
+        changed = true;
+    }
+
+    return changed ? IRLoopOptBuildTrees(opt) : PARSER_RESULT_SUCCESS;
+}
+
+/* Whether an instruction computes the same wherever it runs, and cannot trap when run ahead of time */
+static bool IRLoopOptIsHoistable(const IRLoopOpt* opt, const IRInstruction* record)
+{
+    IROpcode opcode = (IROpcode)record->opcode;
+    if (!((opcode >= IR_OP_ADD && opcode <= IR_OP_SELECT) || opcode == IR_OP_PTRADD || opcode == IR_OP_GLOBAL))
+        return false;
+
+    if (opcode == IR_OP_SDIV || opcode == IR_OP_UDIV || opcode == IR_OP_SREM || opcode == IR_OP_UREM) {
+        uint64_t divisor;
+        if (!IRLoopOptIsConstant(opt, record->operands[1], &divisor))
+            return false;
+
+        // The signed division of the lowest value by -1 overflows
+        uint32_t width = IRType_GetSize((IRType)record->type) * 8;
+        uint64_t ones = width < 64 ? (1ull << width) - 1 : ~0ull;
+        divisor &= ones;
+        if (divisor == 0 || ((opcode == IR_OP_SDIV || opcode == IR_OP_SREM) && divisor == ones))
+            return false;
+    }
+
+    const IROpcodeInfo* info = IROpcode_GetInfo(opcode);
+    for (uint32_t i = 0; i < 3; i++) {
+        if (info->operands[i] == IR_OPERAND_VALUE && !IRLoopOptIsInvariant(opt, record->operands[i]))
+            return false;
+    }
+
+    return true;
+}
+
+/* Move the invariant instructions of the loop to the end of the preheader, in reverse postorder */
+static ParserResult IRLoopOptHoist(IRLoopOpt* opt)
+{
+    IRValueId before = IRFunction_GetBlock(opt->function, opt->preheader)->last;
+
+    uint32_t count;
+    const IRBlockId* blocks = IRLoopTree_GetBlocks(opt->loops, opt->loop, &count);
+    for (uint32_t i = 0; i < count; i++) {
+        IRValueId next;
+        for (IRValueId id = IRFunction_GetBlock(opt->function, blocks[i])->first; id != IR_VALUE_NONE; id = next) {
+            const IRInstruction* record = IRFunction_GetInstruction(opt->function, id);
+            next = record->next;
+
+            if (!IRLoopOptIsHoistable(opt, record))
+                continue;
+
+            IRValueId copy;
+            CHECK_PARSER_RESULT(IRFunction_InsertInstruction(opt->function, before, (IROpcode)record->opcode,
+                (IRType)record->type, record->operands[0], record->operands[1], record->operands[2], &copy));
+            IRFunction_SetInstructionFlags(opt->function, copy, record->flags);
+
+            CHECK_PARSER_RESULT(IRFunction_ReplaceAllUses(opt->function, id, copy));
+            IRFunction_RemoveInstruction(opt->function, id);
+            opt->hoisted++;
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/*
+ * Find the edges into the header: from the preheader and from the one
+ * block of the loop that branches back, false for more back edges
+ */
+static bool IRLoopOptFindLatch(IRLoopOpt* opt)
+{
+    uint32_t predCount;
+    const IRBlockId* preds = IRFunction_GetPredecessors(opt->function, opt->header, &predCount);
+    if (predCount != 2)
+        return false;
+
+    opt->latchIndex = preds[0] == opt->preheader ? 1 : 0;
+    opt->preheaderIndex = 1 - opt->latchIndex;
+    opt->latch = preds[opt->latchIndex];
+
+    return preds[opt->preheaderIndex] == opt->preheader && opt->latch != opt->preheader;
+}
+
+static ParserResult IRLoopOptReserve(IRLoopOpt* opt)
+{
+    uint32_t count = IRFunction_GetInstructionCount(opt->function);
+    if (count <= opt->capacity)
+        return PARSER_RESULT_SUCCESS;
+
+    // Nothing is kept, the new records start cleared
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&opt->affine, &opt->capacity, 0, count, sizeof(IRAffine), 64));
+    memset(opt->affine, 0, sizeof(IRAffine) * opt->capacity);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static inline const IRAffine* IRLoopOptGetAffine(const IRLoopOpt* opt, IRValueId value)
+{
+    if (value >= opt->capacity || !(opt->affine[value].flags & IR_AFFINE_FLAG_LINEAR))
+        return NULL;
+
+    return &opt->affine[value];
+}
+
+/*
+ * Get the value of an instruction at the end of the preheader: folded
+ * when its operands are constants, shared when made before. IR_VALUE_NONE
+ * for a fold that is not defined.
+ */
+static ParserResult IRLoopOptEmit(IRLoopOpt* opt, IROpcode opcode, IRType type, IRValueId a, IRValueId b,
+    IRValueId* value)
+{
+    const IROpcodeInfo* info = IROpcode_GetInfo(opcode);
+
+    uint64_t x;
+    uint64_t y = 0;
+    if (opcode != IR_OP_PTRADD && IRLoopOptIsConstant(opt, a, &x) &&
+        (info->operands[1] != IR_OPERAND_VALUE || IRLoopOptIsConstant(opt, b, &y))) {
+        const IRInstruction* operand = IRFunction_GetInstruction(opt->function, a);
+
+        uint64_t bits;
+        if (!IRFold(opcode, type, (IRType)operand->type, x, y, &bits)) {
+            *value = IR_VALUE_NONE;
+            return PARSER_RESULT_SUCCESS;
+        }
+
+        return IRFunction_GetConstant(opt->function, type, bits, value);
+    }
+
+    if (info->operands[1] == IR_OPERAND_VALUE && IRLoopOptIsConstant(opt, b, &y)) {
+        bool zero = (opcode == IR_OP_ADD || opcode == IR_OP_SUB || opcode == IR_OP_PTRADD || opcode == IR_OP_SHL) && y == 0;
+        if (zero || (opcode == IR_OP_MUL && y == 1)) {
+            *value = a;
+            return PARSER_RESULT_SUCCESS;
+        }
+    }
+
+    for (uint32_t i = 0; i < opt->emittedCount; i++) {
+        const IRLoopMemo* memo = &opt->emitted[i];
+        if (memo->opcode == (uint32_t)opcode && memo->type == (uint32_t)type && memo->a == a && memo->b == b) {
+            *value = memo->value;
+            return PARSER_RESULT_SUCCESS;
+        }
+    }
+
+    IRValueId before = IRFunction_GetBlock(opt->function, opt->preheader)->last;
+    CHECK_PARSER_RESULT(IRFunction_InsertInstruction(opt->function, before, opcode, type, a, b, 0, value));
+
+    if (opt->emittedCount < IR_LOOP_MEMO_LIMIT) {
+        IRLoopMemo* memo = &opt->emitted[opt->emittedCount++];
+        memo->opcode = (uint32_t)opcode;
+        memo->type = (uint32_t)type;
+        memo->a = a;
+        memo->b = b;
+        memo->value = *value;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static IROpcode IRLoopOptSwapCompare(IROpcode opcode)
+{
+    switch (opcode) {
+    case IR_OP_SLT: return IR_OP_SGT;
+    case IR_OP_SLE: return IR_OP_SGE;
+    case IR_OP_SGT: return IR_OP_SLT;
+    case IR_OP_SGE: return IR_OP_SLE;
+    case IR_OP_ULT: return IR_OP_UGT;
+    case IR_OP_ULE: return IR_OP_UGE;
+    case IR_OP_UGT: return IR_OP_ULT;
+    case IR_OP_UGE: return IR_OP_ULE;
+    default:        return IR_OP_NOP;
+    }
+}
+
+static IROpcode IRLoopOptNegateCompare(IROpcode opcode)
+{
+    switch (opcode) {
+    case IR_OP_SLT: return IR_OP_SGE;
+    case IR_OP_SLE: return IR_OP_SGT;
+    case IR_OP_SGT: return IR_OP_SLE;
+    case IR_OP_SGE: return IR_OP_SLT;
+    case IR_OP_ULT: return IR_OP_UGE;
+    case IR_OP_ULE: return IR_OP_UGT;
+    case IR_OP_UGT: return IR_OP_ULE;
+    case IR_OP_UGE: return IR_OP_ULT;
+    default:        return IR_OP_NOP;
+    }
+}
+
+/*
+ * The header tests the variable against an invariant bound on every
+ * iteration, and only a value that passed goes around to be stepped. A
+ * step that cannot carry a value that passed past the end of the range
+ * never wraps, so the extended variable steps as well.
+ */
+static uint32_t IRLoopOptFindNoWrap(const IRLoopOpt* opt, IRValueId phi, IRType type, uint64_t stepBits)
+{
+    uint32_t width = IRType_GetSize(type) * 8;
+    if (width >= 64)
+        return IR_AFFINE_FLAG_NONE;
+
+    const IRInstruction* branch = IRFunction_GetInstruction(opt->function,
+        IRFunction_GetBlock(opt->function, opt->header)->last);
+    if (!branch || branch->opcode != IR_OP_CONDBR)
+        return IR_AFFINE_FLAG_NONE;
+
+    const IRInstruction* test = IRFunction_GetInstruction(opt->function, branch->operands[0]);
+    if (!test)
+        return IR_AFFINE_FLAG_NONE;
+
+    bool staysOnTrue = IRLoopTree_Contains(opt->loops, opt->loop, branch->operands[1]);
+    if (staysOnTrue == IRLoopTree_Contains(opt->loops, opt->loop, branch->operands[2]))
+        return IR_AFFINE_FLAG_NONE;
+
+    // As `phi op bound` that holds to stay in the loop
+    IROpcode op = (IROpcode)test->opcode;
+    IRValueId bound;
+    if (test->operands[0] == phi && IRLoopOptIsInvariant(opt, test->operands[1])) {
+        bound = test->operands[1];
+    }
+    else if (test->operands[1] == phi && IRLoopOptIsInvariant(opt, test->operands[0])) {
+        bound = test->operands[0];
+        op = IRLoopOptSwapCompare(op);
+    }
+    else {
+        return IR_AFFINE_FLAG_NONE;
+    }
+
+    if (!staysOnTrue)
+        op = IRLoopOptNegateCompare(op);
+
+    int64_t step = (int64_t)(stepBits << (64 - width)) >> (64 - width);
+    int64_t high = (int64_t)((1ull << (width - 1)) - 1);
+    int64_t low = -high - 1;
+
+    uint64_t boundBits = 0;
+    bool known = IRLoopOptIsConstant(opt, bound, &boundBits);
+    int64_t sbound = (int64_t)(boundBits << (64 - width)) >> (64 - width);
+    int64_t ubound = (int64_t)(boundBits & ((1ull << width) - 1));
+    int64_t umax = (int64_t)((1ull << width) - 1);
+
+    switch (op) {
+    case IR_OP_SLT:
+        return step > 0 && (step == 1 || (known && sbound - 1 + step <= high)) ? IR_AFFINE_FLAG_NO_SIGNED_WRAP : 0;
+    case IR_OP_SLE:
+        return step > 0 && known && sbound + step <= high ? IR_AFFINE_FLAG_NO_SIGNED_WRAP : 0;
+    case IR_OP_SGT:
+        return step < 0 && (step == -1 || (known && sbound + 1 + step >= low)) ? IR_AFFINE_FLAG_NO_SIGNED_WRAP : 0;
+    case IR_OP_SGE:
+        return step < 0 && known && sbound + step >= low ? IR_AFFINE_FLAG_NO_SIGNED_WRAP : 0;
+    case IR_OP_ULT:
+        return step > 0 && (step == 1 || (known && ubound - 1 + step <= umax)) ? IR_AFFINE_FLAG_NO_UNSIGNED_WRAP : 0;
+    case IR_OP_ULE:
+        return step > 0 && known && ubound + step <= umax ? IR_AFFINE_FLAG_NO_UNSIGNED_WRAP : 0;
+    case IR_OP_UGT:
+        return step < 0 && (step == -1 || (known && ubound + 1 + step >= 0)) ? IR_AFFINE_FLAG_NO_UNSIGNED_WRAP : 0;
+    case IR_OP_UGE:
+        return step < 0 && known && ubound + step >= 0 ? IR_AFFINE_FLAG_NO_UNSIGNED_WRAP : 0;
+    default:
+        return IR_AFFINE_FLAG_NONE;
+    }
+}
+
+/* Phis of the header that add a constant to themselves on the back edge */
+static ParserResult IRLoopOptFindBasic(IRLoopOpt* opt)
+{
+    for (IRValueId phi = IRFunction_GetBlock(opt->function, opt->header)->first; phi != IR_VALUE_NONE;) {
+        const IRInstruction* record = IRFunction_GetInstruction(opt->function, phi);
+        if (record->opcode != IR_OP_PHI)
+            break;
+
+        IRValueId current = phi;
+        phi = record->next;
+
+        IRType type = (IRType)record->type;
+        uint32_t count;
+        const uint32_t* items = IRFunction_GetList(opt->function, current, &count);
+        if (!IRLoopOptIsInteger(type) || count != 2)
+            continue;
+
+        IRValueId start = items[opt->preheaderIndex];
+        const IRInstruction* next = IRFunction_GetInstruction(opt->function, items[opt->latchIndex]);
+        if (!next)
+            continue;
+
+        // `phi + c`, `c + phi` or `phi - c`
+        IRValueId other = IR_VALUE_NONE;
+        if ((next->opcode == IR_OP_ADD || next->opcode == IR_OP_SUB) && next->operands[0] == current)
+            other = next->operands[1];
+        else if (next->opcode == IR_OP_ADD && next->operands[1] == current)
+            other = next->operands[0];
+
+        uint64_t bits;
+        if (!IRLoopOptIsConstant(opt, other, &bits))
+            continue;
+        if (next->opcode == IR_OP_SUB)
+            bits = 0 - bits;
+
+        IRValueId step;
+        CHECK_PARSER_RESULT(IRFunction_GetConstant(opt->function, type, bits, &step));
+
+        IRAffine* affine = &opt->affine[current];
+        affine->start = start;
+        affine->step = step;
+        affine->flags = IR_AFFINE_FLAG_LINEAR | IRLoopOptFindNoWrap(opt, current, type, bits);
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Find whether an instruction is linear in the iteration from the operands it has, and where it starts */
+static ParserResult IRLoopOptDerive(IRLoopOpt* opt, IRValueId id)
+{
+    const IRInstruction* record = IRFunction_GetInstruction(opt->function, id);
+    IROpcode opcode = (IROpcode)record->opcode;
+    IRType type = (IRType)record->type;
+    IRValueId a = record->operands[0];
+    IRValueId b = record->operands[1];
+
+    const IRAffine* x = IRLoopOptGetAffine(opt, a);
+    const IRAffine* y = IRLoopOptGetAffine(opt, b);
+    uint32_t wrapFlags = IR_AFFINE_FLAG_NO_SIGNED_WRAP | IR_AFFINE_FLAG_NO_UNSIGNED_WRAP;
+
+    IRAffine result;
+    memset(&result, 0, sizeof(IRAffine));
+
+    switch (opcode) {
+    case IR_OP_SEXT:
+    case IR_OP_ZEXT:
+        // Only a variable that does not wrap, a step back extends with its sign either way
+        if (!x || !(x->flags & (opcode == IR_OP_SEXT ? IR_AFFINE_FLAG_NO_SIGNED_WRAP : IR_AFFINE_FLAG_NO_UNSIGNED_WRAP)))
+            return PARSER_RESULT_SUCCESS;
+
+        CHECK_PARSER_RESULT(IRLoopOptEmit(opt, opcode, type, x->start, 0, &result.start));
+        CHECK_PARSER_RESULT(IRLoopOptEmit(opt, IR_OP_SEXT, type, x->step, 0, &result.step));
+        result.flags = IR_AFFINE_FLAG_EXTENDED;
+        break;
+
+    case IR_OP_MUL:
+    case IR_OP_SHL:
+        if (opcode == IR_OP_MUL && !x && y && IRLoopOptIsInvariant(opt, a)) {
+            x = y;
+            b = a;
+        }
+        else if (!x || !IRLoopOptIsInvariant(opt, b)) {
+            return PARSER_RESULT_SUCCESS;
+        }
+
+        CHECK_PARSER_RESULT(IRLoopOptEmit(opt, opcode, type, x->start, b, &result.start));
+        CHECK_PARSER_RESULT(IRLoopOptEmit(opt, opcode, type, x->step, b, &result.step));
+        result.flags = x->flags | IR_AFFINE_FLAG_SCALED;
+        break;
+
+    case IR_OP_ADD:
+    case IR_OP_SUB:
+    case IR_OP_PTRADD: {
+        if ((!x && !IRLoopOptIsInvariant(opt, a)) || (!y && !IRLoopOptIsInvariant(opt, b)) || (!x && !y))
+            return PARSER_RESULT_SUCCESS;
+
+        CHECK_PARSER_RESULT(IRLoopOptEmit(opt, opcode, type, x ? x->start : a, y ? y->start : b, &result.start));
+
+        // An invariant steps by nothing
+        IRType offsetType = opcode == IR_OP_PTRADD ? IR_TYPE_I64 : type;
+        if (x && y)
+            CHECK_PARSER_RESULT(IRLoopOptEmit(opt, opcode == IR_OP_SUB ? IR_OP_SUB : IR_OP_ADD, offsetType,
+                x->step, y->step, &result.step));
+        else if (x)
+            result.step = x->step;
+        else if (opcode == IR_OP_SUB)
+            CHECK_PARSER_RESULT(IRLoopOptEmit(opt, IR_OP_NEG, offsetType, y->step, 0, &result.step));
+        else
+            result.step = y->step;
+
+        result.flags = (x ? x->flags : 0) | (y ? y->flags : 0);
+        break;
+    }
+
+    default:
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    if (result.start == IR_VALUE_NONE || result.step == IR_VALUE_NONE)
+        return PARSER_RESULT_SUCCESS;
+
+    result.flags = (result.flags & ~wrapFlags) | IR_AFFINE_FLAG_LINEAR;
+    opt->affine[id] = result;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/*
+ * Whether a linear value saves work as a phi of its own: it multiplies,
+ * or it is an address that extends, and something that is not linear
+ * uses it
+ */
+static bool IRLoopOptIsWorthReducing(const IRLoopOpt* opt, IRValueId id)
+{
+    const IRAffine* affine = IRLoopOptGetAffine(opt, id);
+    const IRInstruction* record = IRFunction_GetInstruction(opt->function, id);
+    if (!affine || record->opcode == IR_OP_PHI || record->opcode == IR_OP_SEXT || record->opcode == IR_OP_ZEXT)
+        return false;
+
+    if (!(affine->flags & IR_AFFINE_FLAG_SCALED) &&
+        !(record->opcode == IR_OP_PTRADD && (affine->flags & IR_AFFINE_FLAG_EXTENDED)))
+        return false;
+
+    uint32_t count;
+    const IRUse* uses = IRFunction_GetUses(opt->function, id, &count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!IRLoopOptGetAffine(opt, uses[i].user))
+            return true;
+    }
+
+    return false;
+}
+
+/* Replace a linear value by a phi of the header, stepped at the end of the latch */
+static ParserResult IRLoopOptReduce(IRLoopOpt* opt, IRValueId id)
+{
+    const IRAffine* affine = IRLoopOptGetAffine(opt, id);
+    IRType type = (IRType)IRFunction_GetInstruction(opt->function, id)->type;
+
+    IRValueId phi = IR_VALUE_NONE;
+    for (uint32_t i = 0; i < opt->reducedCount && phi == IR_VALUE_NONE; i++) {
+        const IRLoopMemo* memo = &opt->reduced[i];
+        if (memo->type == (uint32_t)type && memo->a == affine->start && memo->b == affine->step)
+            phi = memo->value;
+    }
+
+    if (phi == IR_VALUE_NONE) {
+        CHECK_PARSER_RESULT(IRFunction_AddPhi(opt->function, opt->header, type, &phi));
+
+        IRValueId next;
+        IRValueId before = IRFunction_GetBlock(opt->function, opt->latch)->last;
+        CHECK_PARSER_RESULT(IRFunction_InsertInstruction(opt->function, before,
+            type == IR_TYPE_PTR ? IR_OP_PTRADD : IR_OP_ADD, type, phi, affine->step, 0, &next));
+
+        for (uint32_t i = 0; i < 2; i++)
+            CHECK_PARSER_RESULT(IRFunction_AppendOperand(opt->function, phi, i == opt->preheaderIndex ? affine->start : next));
+
+        if (opt->reducedCount < IR_LOOP_MEMO_LIMIT) {
+            IRLoopMemo* memo = &opt->reduced[opt->reducedCount++];
+            memo->opcode = IR_OP_PHI;
+            memo->type = (uint32_t)type;
+            memo->a = affine->start;
+            memo->b = affine->step;
+            memo->value = phi;
+        }
+    }
+
+    CHECK_PARSER_RESULT(IRFunction_ReplaceAllUses(opt->function, id, phi));
+    IRFunction_RemoveInstruction(opt->function, id);
+    memset(&opt->affine[id], 0, sizeof(IRAffine));
+    opt->inductions++;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRLoopOptReduceAll(IRLoopOpt* opt)
+{
+    CHECK_PARSER_RESULT(IRLoopOptReserve(opt));
+    opt->emittedCount = 0;
+    opt->reducedCount = 0;
+
+    CHECK_PARSER_RESULT(IRLoopOptFindBasic(opt));
+
+    // Reverse postorder, the operands of an instruction come before it
+    uint32_t count;
+    const IRBlockId* blocks = IRLoopTree_GetBlocks(opt->loops, opt->loop, &count);
+    for (uint32_t i = 0; i < count; i++) {
+        for (IRValueId id = IRFunction_GetBlock(opt->function, blocks[i])->first; id != IR_VALUE_NONE;
+            id = IRFunction_GetInstruction(opt->function, id)->next) {
+            if (id < opt->capacity)
+                CHECK_PARSER_RESULT(IRLoopOptDerive(opt, id));
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        IRValueId next;
+        for (IRValueId id = IRFunction_GetBlock(opt->function, blocks[i])->first; id != IR_VALUE_NONE; id = next) {
+            next = IRFunction_GetInstruction(opt->function, id)->next;
+            if (IRLoopOptIsWorthReducing(opt, id))
+                CHECK_PARSER_RESULT(IRLoopOptReduce(opt, id));
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Drop linear values of the loop no longer used and clear their slots, last to first so chains go */
+static void IRLoopOptCleanLoop(IRLoopOpt* opt)
+{
+    uint32_t count;
+    const IRBlockId* blocks = IRLoopTree_GetBlocks(opt->loops, opt->loop, &count);
+    for (uint32_t i = count; i-- > 0;) {
+        IRValueId prev;
+        for (IRValueId id = IRFunction_GetBlock(opt->function, blocks[i])->last; id != IR_VALUE_NONE; id = prev) {
+            const IRInstruction* record = IRFunction_GetInstruction(opt->function, id);
+            prev = record->prev;
+
+            if (id >= opt->capacity)
+                continue;
+
+            uint32_t uses;
+            IRFunction_GetUses(opt->function, id, &uses);
+            if (IRLoopOptGetAffine(opt, id) && record->opcode != IR_OP_PHI && uses == 0)
+                IRFunction_RemoveInstruction(opt->function, id);
+
+            memset(&opt->affine[id], 0, sizeof(IRAffine));
+        }
+    }
+}
+
+/* Drop what the pass made in the preheader and nothing came to use */
+static void IRLoopOptCleanPreheader(IRLoopOpt* opt)
+{
+    IRValueId prev;
+    for (IRValueId id = IRFunction_GetBlock(opt->function, opt->preheader)->last; id != IR_VALUE_NONE; id = prev) {
+        const IRInstruction* record = IRFunction_GetInstruction(opt->function, id);
+        prev = record->prev;
+
+        uint32_t uses;
+        IRFunction_GetUses(opt->function, id, &uses);
+        if (id >= opt->firstMade && uses == 0 &&
+            !(IROpcode_GetInfo((IROpcode)record->opcode)->flags & IR_OPCODE_FLAG_SIDE_EFFECTS))
+            IRFunction_RemoveInstruction(opt->function, id);
+    }
+}
+
+/* The preheader is the one outside block with an edge into the header, when that has no other */
+static IRBlockId IRLoopOptFindPreheader(IRLoopOpt* opt, IRLoopId loop)
+{
+    uint32_t edges;
+    if (IRLoopOptFindEntries(opt, loop, &edges) != 1 || edges != 1 ||
+        IRFunction_GetSuccessorCount(opt->function, opt->scratch[0]) != 1)
+        return IR_BLOCK_NONE;
+
+    return opt->scratch[0];
+}
+
+static ParserResult IRLoopOptRun(IRLoopOpt* opt)
+{
+    CHECK_PARSER_RESULT(IRLoopOptBuildTrees(opt));
+    CHECK_PARSER_RESULT(IRLoopOptAddPreheaders(opt));
+
+    // Inner loops have the lower ids, what they move out is seen by the loops around them
+    uint32_t loopCount = IRLoopTree_GetLoopCount(opt->loops);
+    for (IRLoopId loop = 1; loop < loopCount; loop++) {
+        opt->loop = loop;
+        opt->header = IRLoopTree_GetHeader(opt->loops, loop);
+        opt->preheader = IRLoopOptFindPreheader(opt, loop);
+        if (opt->preheader == IR_BLOCK_NONE)
+            continue;
+
+        opt->firstMade = IRFunction_GetInstructionCount(opt->function);
+        CHECK_PARSER_RESULT(IRLoopOptHoist(opt));
+
+        if (IRLoopOptFindLatch(opt)) {
+            CHECK_PARSER_RESULT(IRLoopOptReduceAll(opt));
+            IRLoopOptCleanLoop(opt);
+        }
+
+        IRLoopOptCleanPreheader(opt);
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_OptimizeLoops(
+    IRFunction function,
+    IRPassStats* stats)
+{
+    if (!function)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRLoopOpt opt;
+    memset(&opt, 0, sizeof(IRLoopOpt));
+    opt.function = function;
+
+    IRFunctionStats before;
+    IRFunction_GetStats(function, &before);
+
+    ParserResult result = IRLoopOptRun(&opt);
+    if (result == PARSER_RESULT_SUCCESS && !IRFunction_IsCompact(function))
+        result = IRFunction_Compact(function);
+
+    if (opt.loops)
+        IRLoopTreeDestroy(opt.loops);
+    if (opt.domTree)
+        IRDomTreeDestroy(opt.domTree);
+    if (opt.scratch)
+        PARSER_FREE(opt.scratch);
+    if (opt.affine)
+        PARSER_FREE(opt.affine);
+
+    if (stats) {
+        IRFunctionStats after;
+        IRFunction_GetStats(function, &after);
+
+        stats->instructionsRemoved += before.instructions > after.instructions ? before.instructions - after.instructions : 0;
+        stats->valuesHoisted += opt.hoisted;
+        stats->inductionsReduced += opt.inductions;
+    }
+
+    return result;
+}
@@ -0,0 +1,269 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRLoops.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/*
+ * `loopOf` has a slot per block record of the function, the loop tables a
+ * slot per loop record. Blocks of every loop, inner loops included, are one
+ * array of ranges.
+ */
+struct IRLoopTree_T {
+    uint32_t blockCount;            // Block records of the function when built
+    uint32_t loopCount;             // Next id, record 0 is never used
+
+    uint32_t* words;                // Backs the tables besides `blocks`
+    IRLoopId* loopOf;               // Innermost loop of a block
+    IRBlockId* header;
+    IRLoopId* parent;
+    uint32_t* depth;
+    uint32_t* blockStart;           // Blocks of loop l are blocks[blockStart[l] .. blockStart[l + 1]]
+    IRBlockId* blocks;
+};
+
+/* Outermost loop around `loop` found so far */
+static IRLoopId IRLoopTreeOutermost(const IRLoopTree tree, IRLoopId loop)
+{
+    while (tree->parent[loop] != IR_LOOP_NONE)
+        loop = tree->parent[loop];
+
+    return loop;
+}
+
+/*
+ * Take `block` into `loop` when the walk first meets it: a block of no loop
+ * yet becomes a member, a block of a loop found before brings in the
+ * outermost loop around it, walked on from its header
+ */
+static void IRLoopTreePush(IRLoopTree tree, IRLoopId loop, IRBlockId block, IRBlockId* stack, uint32_t* top)
+{
+    IRLoopId inner = tree->loopOf[block];
+    if (inner == IR_LOOP_NONE) {
+        tree->loopOf[block] = loop;
+        stack[(*top)++] = block;
+        return;
+    }
+
+    inner = IRLoopTreeOutermost(tree, inner);
+    if (inner == loop)
+        return;
+
+    tree->parent[inner] = loop;
+    stack[(*top)++] = tree->header[inner];
+}
+
+/* Walk backwards from the back edges into `header`, a block is pushed at most once */
+static void IRLoopTreeFind(IRLoopTree tree, const IRFunction function, const IRDomTree domTree,
+    IRBlockId header, IRBlockId* stack)
+{
+    uint32_t predCount;
+    const IRBlockId* preds = IRFunction_GetPredecessors(function, header, &predCount);
+
+    uint32_t i = 0;
+    while (i < predCount && !IRDomTree_Dominates(domTree, header, preds[i]))
+        i++;
+
+    if (i == predCount)
+        return;
+
+    IRLoopId loop = tree->loopCount++;
+    tree->header[loop] = header;
+    tree->loopOf[header] = loop;
+
+    uint32_t top = 0;
+    for (; i < predCount; i++) {
+        if (IRDomTree_Dominates(domTree, header, preds[i]))
+            IRLoopTreePush(tree, loop, preds[i], stack, &top);
+    }
+
+    while (top) {
+        IRBlockId block = stack[--top];
+
+        preds = IRFunction_GetPredecessors(function, block, &predCount);
+        for (uint32_t j = 0; j < predCount; j++) {
+            if (IRDomTree_IsReachable(domTree, preds[j]))
+                IRLoopTreePush(tree, loop, preds[j], stack, &top);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateIRLoopTree(
+    const IRFunction function,
+    const IRDomTree domTree,
+    IRLoopTree* tree)
+{
+    if (!function || !domTree || !tree)
+        return PARSER_ERROR_INVALID_ARG;
+
+    *tree = NULL;
+
+    uint32_t blockCount = IRFunction_GetBlockCount(function);
+    uint32_t reachable;
+    const IRBlockId* order = IRDomTree_GetOrder(domTree, &reachable);
+
+    IRLoopTree result = PARSER_MALLOC(sizeof(struct IRLoopTree_T), 0);
+    if (!result)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(result, 0, sizeof(struct IRLoopTree_T));
+    result->blockCount = blockCount;
+    result->loopCount = 1;
+
+    // Every reachable block heads at most one loop
+    uint32_t loopCapacity = reachable + 1;
+    size_t wordCount = (size_t)blockCount * 2 + (size_t)loopCapacity * 4 + 1;
+    result->words = PARSER_MALLOC(sizeof(uint32_t) * wordCount, 0);
+    if (!result->words) {
+        IRLoopTreeDestroy(result);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memset(result->words, 0, sizeof(uint32_t) * wordCount);
+    result->loopOf = result->words;
+    result->header = result->loopOf + blockCount;
+    result->parent = result->header + loopCapacity;
+    result->depth = result->parent + loopCapacity;
+    result->blockStart = result->depth + loopCapacity;
+    IRBlockId* stack = result->blockStart + loopCapacity + 1;
+
+    // Inner headers come later in reverse postorder, so they are found first
+    for (uint32_t i = reachable; i-- > 0;)
+        IRLoopTreeFind(result, function, domTree, order[i], stack);
+
+    for (IRLoopId loop = result->loopCount; loop-- > 1;) {
+        IRLoopId parent = result->parent[loop];
+        result->depth[loop] = parent == IR_LOOP_NONE ? 1 : result->depth[parent] + 1;
+    }
+
+    // Count, then place, every block in each loop around it
+    for (uint32_t i = 0; i < reachable; i++) {
+        for (IRLoopId loop = result->loopOf[order[i]]; loop != IR_LOOP_NONE; loop = result->parent[loop])
+            result->blockStart[loop + 1]++;
+    }
+
+    for (IRLoopId loop = 1; loop < result->loopCount; loop++)
+        result->blockStart[loop + 1] += result->blockStart[loop];
+
+    uint32_t total = result->blockStart[result->loopCount];
+    result->blocks = PARSER_MALLOC(sizeof(IRBlockId) * (total ? total : 1), 0);
+    if (!result->blocks) {
+        IRLoopTreeDestroy(result);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    // The fill moves every start up to the next one, shifted back after
+    for (uint32_t i = 0; i < reachable; i++) {
+        for (IRLoopId loop = result->loopOf[order[i]]; loop != IR_LOOP_NONE; loop = result->parent[loop])
+            result->blocks[result->blockStart[loop]++] = order[i];
+    }
+
+    for (IRLoopId loop = result->loopCount; loop-- > 1;)
+        result->blockStart[loop] = result->blockStart[loop - 1];
+
+    *tree = result;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL IRLoopTreeDestroy(
+    IRLoopTree tree)
+{
+    if (!tree)
+        return;
+
+    if (tree->blocks)
+        PARSER_FREE(tree->blocks);
+    if (tree->words)
+        PARSER_FREE(tree->words);
+
+    PARSER_FREE(tree);
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRLoopTree_GetLoopCount(
+    const IRLoopTree tree)
+{
+    return tree ? tree->loopCount : 0;
+}
+
+PARSER_ATTR IRLoopId PARSER_CALL IRLoopTree_GetLoop(
+    const IRLoopTree tree,
+    IRBlockId block)
+{
+    if (!tree || block >= tree->blockCount)
+        return IR_LOOP_NONE;
+
+    return tree->loopOf[block];
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRLoopTree_GetDepth(
+    const IRLoopTree tree,
+    IRBlockId block)
+{
+    IRLoopId loop = IRLoopTree_GetLoop(tree, block);
+
+    return loop == IR_LOOP_NONE ? 0 : tree->depth[loop];
+}
+
+PARSER_ATTR IRBlockId PARSER_CALL IRLoopTree_GetHeader(
+    const IRLoopTree tree,
+    IRLoopId loop)
+{
+    if (!tree || loop == IR_LOOP_NONE || loop >= tree->loopCount)
+        return IR_BLOCK_NONE;
+
+    return tree->header[loop];
+}
+
+PARSER_ATTR IRLoopId PARSER_CALL IRLoopTree_GetParent(
+    const IRLoopTree tree,
+    IRLoopId loop)
+{
+    if (!tree || loop == IR_LOOP_NONE || loop >= tree->loopCount)
+        return IR_LOOP_NONE;
+
+    return tree->parent[loop];
+}
+
+PARSER_ATTR const IRBlockId* PARSER_CALL IRLoopTree_GetBlocks(
+    const IRLoopTree tree,
+    IRLoopId loop,
+    uint32_t* count)
+{
+    *count = 0;
+
+    if (!tree || loop == IR_LOOP_NONE || loop >= tree->loopCount)
+        return NULL;
+
+    *count = tree->blockStart[loop + 1] - tree->blockStart[loop];
+
+    return &tree->blocks[tree->blockStart[loop]];
+}
+
+PARSER_ATTR bool PARSER_CALL IRLoopTree_Contains(
+    const IRLoopTree tree,
+    IRLoopId loop,
+    IRBlockId block)
+{
+    if (loop == IR_LOOP_NONE)
+        return false;
+
+    // Inner loops have the lower ids, the walk stops once past `loop`
+    for (IRLoopId inner = IRLoopTree_GetLoop(tree, block); inner != IR_LOOP_NONE && inner <= loop;
+        inner = tree->parent[inner]) {
+        if (inner == loop)
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,279 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define IR_MODULE_INITIAL_NAMES         256u
+
+static uint32_t IRModuleHash(const char* name, uint32_t length)
+{
+    uint32_t hash = 0x811C9DC5u;
+    for (uint32_t i = 0; i < length; i++)
+        hash = (hash ^ (uint8_t)name[i]) * 0x01000193u;
+
+    return hash;
+}
+
+/* Name slot of `name`, holding 0 when the name is not declared */
+static uint32_t* IRModuleProbe(IRModule module, const char* name, uint32_t length, uint32_t hash)
+{
+    uint32_t mask = module->nameCapacity - 1;
+    uint32_t i = hash & mask;
+
+    for (;;) {
+        uint32_t* slot = &module->names[i];
+        if (*slot == IR_GLOBAL_NONE)
+            return slot;
+
+        const IRGlobal* global = &module->globals[*slot];
+        if (global->hash == hash && global->info.length == length && memcmp(global->info.name, name, length) == 0)
+            return slot;
+
+        i = (i + 1) & mask;
+    }
+}
+
+static ParserResult IRModuleGrowNames(IRModule module, uint32_t capacity)
+{
+    uint32_t* names = PARSER_MALLOC(sizeof(uint32_t) * capacity, 0);
+    if (!names)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(names, 0, sizeof(uint32_t) * capacity);
+
+    // Anonymous data has no slot
+    for (uint32_t id = 1; id < module->globalCount; id++) {
+        if (!module->globals[id].info.name)
+            continue;
+
+        uint32_t i = module->globals[id].hash & (capacity - 1);
+        while (names[i] != IR_GLOBAL_NONE)
+            i = (i + 1) & (capacity - 1);
+
+        names[i] = id;
+    }
+
+    if (module->names)
+        PARSER_FREE(module->names);
+
+    module->names = names;
+    module->nameCapacity = capacity;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRModuleAddGlobal(IRModule module, IRGlobal** global, IRGlobalId* id)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&module->globals, &module->globalCapacity, module->globalCount,
+        module->globalCount + 1, sizeof(IRGlobal), 1));
+
+    *id = module->globalCount++;
+    *global = &module->globals[*id];
+    memset(*global, 0, sizeof(IRGlobal));
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateIRModule(
+    IRModule* module)
+{
+    if (!module)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRModule hdl = PARSER_MALLOC(sizeof(struct IRModule_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct IRModule_T));
+
+    hdl->globalCapacity = 64;
+    hdl->globalCount = 1;
+    hdl->globals = PARSER_MALLOC(sizeof(IRGlobal) * hdl->globalCapacity, 0);
+
+    if (!hdl->globals ||
+        ParserArena_Create(NULL, &hdl->arena) != PARSER_RESULT_SUCCESS ||
+        IRModuleGrowNames(hdl, IR_MODULE_INITIAL_NAMES) != PARSER_RESULT_SUCCESS) {
+        IRModuleDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memset(&hdl->globals[0], 0, sizeof(IRGlobal));
+
+    *module = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL IRModuleDestroy(
+    IRModule module)
+{
+    if (!module)
+        return;
+
+    while (module->functionCount)
+        IRModule_RemoveFunction(module, module->functions[module->functionCount - 1]);
+
+    if (module->functions)
+        PARSER_FREE(module->functions);
+    if (module->names)
+        PARSER_FREE(module->names);
+    if (module->globals)
+        PARSER_FREE(module->globals);
+    if (module->arena)
+        ParserArena_Destroy(module->arena);
+
+    PARSER_FREE(module);
+}
+
+PARSER_ATTR IRGlobalId PARSER_CALL IRModule_FindGlobal(
+    const IRModule module,
+    const char* name,
+    uint32_t length)
+{
+    if (!module || !name)
+        return IR_GLOBAL_NONE;
+
+    return *IRModuleProbe(module, name, length, IRModuleHash(name, length));
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRModule_DeclareGlobal(
+    IRModule module,
+    const char* name,
+    uint32_t length,
+    IRGlobalKind kind,
+    IRGlobalId* id)
+{
+    if (!module || !name || !id)
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint32_t hash = IRModuleHash(name, length);
+    uint32_t* slot = IRModuleProbe(module, name, length, hash);
+
+    if (*slot != IR_GLOBAL_NONE) {
+        if (module->globals[*slot].info.kind != kind)
+            return PARSER_ERROR_INVALID_ARG;
+
+        *id = *slot;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    char* text = ParserArena_Alloc(module->arena, length + 1, 1);
+    if (!text)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memcpy(text, name, length);
+    text[length] = '\0';
+
+    IRGlobal* global;
+    IRGlobalId newId;
+    CHECK_PARSER_RESULT(IRModuleAddGlobal(module, &global, &newId));
+
+    global->info.name = text;
+    global->info.length = length;
+    global->info.kind = (uint8_t)kind;
+    global->hash = hash;
+    *slot = newId;
+
+    // Keep the table at most half full
+    if (newId * 2 > module->nameCapacity)
+        CHECK_PARSER_RESULT(IRModuleGrowNames(module, module->nameCapacity * 2));
+
+    *id = newId;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRModule_DefineData(
+    IRModule module,
+    IRGlobalId global,
+    const void* data,
+    uint32_t size,
+    uint32_t alignment,
+    uint32_t flags,
+    IRGlobalId* id)
+{
+    if (!module || !id || global >= module->globalCount || alignment > UINT16_MAX)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRGlobal* record;
+    if (global == IR_GLOBAL_NONE) {
+        CHECK_PARSER_RESULT(IRModuleAddGlobal(module, &record, &global));
+        record->info.kind = IR_GLOBAL_KIND_DATA;
+    }
+    else {
+        record = &module->globals[global];
+        if (record->info.kind != IR_GLOBAL_KIND_DATA || (record->info.flags & IR_GLOBAL_FLAG_DEFINED))
+            return PARSER_ERROR_INVALID_ARG;
+    }
+
+    if (data && size) {
+        uint8_t* bytes = ParserArena_Alloc(module->arena, size, 1);
+        if (!bytes)
+            return PARSER_ERROR_NO_MEMORY;
+
+        memcpy(bytes, data, size);
+        record->info.data = bytes;
+    }
+
+    record->info.size = size;
+    record->info.alignment = (uint16_t)(alignment ? alignment : 1);
+    record->info.flags |= (uint8_t)(flags | IR_GLOBAL_FLAG_DEFINED);
+
+    *id = global;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL IRModule_SetGlobalFlags(
+    IRModule module,
+    IRGlobalId global,
+    uint32_t flags)
+{
+    if (module && global != IR_GLOBAL_NONE && global < module->globalCount)
+        module->globals[global].info.flags |= (uint8_t)flags;
+}
+
+PARSER_ATTR const IRGlobalInfo* PARSER_CALL IRModule_GetGlobal(
+    const IRModule module,
+    IRGlobalId global)
+{
+    if (!module || global == IR_GLOBAL_NONE || global >= module->globalCount)
+        return NULL;
+
+    return &module->globals[global].info;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRModule_GetGlobalCount(
+    const IRModule module)
+{
+    return module ? module->globalCount - 1 : 0;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRModule_GetFunctionCount(
+    const IRModule module)
+{
+    return module ? module->functionCount : 0;
+}
+
+PARSER_ATTR IRFunction PARSER_CALL IRModule_GetFunction(
+    const IRModule module,
+    uint32_t index)
+{
+    if (!module || index >= module->functionCount)
+        return NULL;
+
+    return module->functions[index];
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,2198 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRRegAlloc.h"
+#include "../parser/ParserArray.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/*
+ * An instruction takes four positions from its first one, q: operands are
+ * read at q + 1, a call clobbers at q + 2 and the result is written at
+ * q + 3, so an operand that dies there can hand its register on to the
+ * result. A block has a position of its own before its instructions, where
+ * its phis are written and the values live into it start. Intervals are
+ * cut at the first position of an instruction or block, where moves can
+ * go, or where a call clobbers, for a value the instruction reads that
+ * leaves its register for the stack: the store goes before the
+ * instruction, which still reads the register.
+ */
+#define IR_REGALLOC_STEP                4u
+#define IR_REGALLOC_READ                1u
+#define IR_REGALLOC_CLOBBER             2u
+#define IR_REGALLOC_WRITE               3u
+
+#define IR_REGALLOC_NONE                UINT32_MAX
+#define IR_REGALLOC_MAX_DEPTH           5u      // Loop depth beyond which a use weighs no more
+
+#define IR_REGALLOC_VALUE_CONSTANT      1u
+#define IR_REGALLOC_VALUE_PHI           2u
+
+/* Moves before one instruction, in this order */
+typedef enum IRRegAllocPhase {
+    IR_REGALLOC_PHASE_ENTRY = 0,        // Along the edge into a block with one predecessor
+    IR_REGALLOC_PHASE_SPLIT,            // From one interval of a value to the next, constants into their register
+    IR_REGALLOC_PHASE_SPILL,            // Out of the register of a value the instruction reads, once it is loaded
+    IR_REGALLOC_PHASE_EXIT,             // Along the edge out of a block with one successor
+} IRRegAllocPhase;
+
+typedef struct IRRegAllocRange_T {
+    uint32_t from;
+    uint32_t to;                        // Past the last position
+} IRRegAllocRange;
+
+typedef struct IRRegAllocUse_T {
+    uint32_t position;
+    uint32_t requiresRegister;
+    uint32_t nextRegister;              // First use of the value from this one on that requires a register
+    uint32_t weight;
+    uint64_t before;                    // Weights of the uses before this one, of every value
+} IRRegAllocUse;
+
+/*
+ * Part of the lifetime of a value, from `start` up to `end`. The intervals
+ * of a value share its ranges and uses, each one cut to its positions.
+ */
+typedef struct IRRegAllocInterval_T {
+    IRValueId value;
+    uint32_t start;
+    uint32_t end;
+    uint32_t range;                     // First range of the value that ends after `start`
+    uint32_t rangeEnd;                  // Past the last range of the value
+    uint32_t cursor;                    // First range that ends after the position of the scan
+    uint32_t use;                       // First use at or after `start`
+    uint32_t useEnd;
+    uint32_t next;                      // Next interval of the value
+    IRValueId hintValue;                // Value whose register to prefer, where it is at `hintPosition`
+    uint32_t hintPosition;
+    uint8_t kind;                       // IRLocationKind, IR_LOCATION_NONE until handled
+    uint8_t reg;
+    uint8_t count;
+    uint8_t align;
+    uint8_t bytes;
+    uint8_t rematerialize;
+} IRRegAllocInterval;
+
+/* Interval that keeps its register over a hole, until it is live again */
+typedef struct IRRegAllocInactive_T {
+    uint32_t resume;
+    uint32_t interval;
+} IRRegAllocInactive;
+
+/* Interval of a constant or undefined value for the one instruction that reads it */
+typedef struct IRRegAllocConstantUse_T {
+    IRValueId at;
+    IRValueId value;
+    uint32_t interval;
+} IRRegAllocConstantUse;
+
+typedef struct IRRegAllocLiveValue_T {
+    IRBlockId block;
+    IRValueId value;
+} IRRegAllocLiveValue;
+
+/* Move of a parallel copy, the copies ordered by instruction and phase */
+typedef struct IRRegAllocPendingMove_T {
+    IRValueId before;
+    uint32_t phase;                     // IRRegAllocPhase
+    uint32_t order;
+    IRMove move;
+} IRRegAllocPendingMove;
+
+/* From the start of the first interval of a value on the stack to the end of its last one */
+typedef struct IRRegAllocLifetime_T {
+    uint32_t start;
+    uint32_t end;
+    IRValueId value;
+    uint32_t slot;
+} IRRegAllocLifetime;
+
+typedef struct IRRegAllocLifetimeEnd_T {
+    uint32_t end;
+    uint32_t lifetime;
+} IRRegAllocLifetimeEnd;
+
+typedef struct IRRegAllocSlot_T {
+    uint32_t offset;
+    uint32_t bytes;
+    uint32_t next;                      // Next free slot of the size
+} IRRegAllocSlot;
+
+/*
+ * The tables per value have a slot per instruction record of the function,
+ * `childStart` and `moveStart` one more for the end.
+ */
+struct IRRegAlloc_T {
+    IRRegAllocConfig config;
+    uint64_t allocatable;               // Registers that are not reserved
+    uint32_t blockCount;
+    uint32_t valueCount;
+
+    uint32_t* words;                    // Backs the tables per block and value
+    uint32_t* blockStart;               // First position of a block, the end after the last one
+    uint32_t* positions;                // First position of an instruction, of its block for a phi
+    uint32_t* firstInterval;
+    uint32_t* slots;                    // Offset of the stack slot of a value
+    uint32_t* childStart;               // Intervals of a value, in order, from children[childStart[value]]
+    uint32_t* moveStart;                // Moves before an instruction, from moves[moveStart[id]]
+    uint8_t* valueFlags;
+
+    IRRegAllocRange* ranges;
+    uint32_t rangeCount;
+    uint32_t rangeCapacity;
+    IRRegAllocUse* uses;
+    uint32_t useCount;
+    uint32_t useCapacity;
+    IRRegAllocInterval* intervals;
+    uint32_t intervalCount;
+    uint32_t intervalCapacity;
+    IRRegAllocConstantUse* constantUses;    // In order of the instruction
+    uint32_t constantUseCount;
+    uint32_t constantUseCapacity;
+
+    uint32_t* children;
+    IRMove* moves;
+    uint32_t moveCount;
+    uint32_t moveCapacity;
+
+    uint32_t spillSize;
+    uint64_t usedRegisters;
+    IRRegAllocStats stats;
+};
+
+/* State while the allocation is built */
+typedef struct IRRegAllocScan_T {
+    IRRegAlloc alloc;
+    IRFunction function;
+    IRLoopTree loops;
+
+    // Per block
+    uint32_t* words;
+    IRValueId* blockFirst;              // First instruction that is not a phi
+    uint32_t* weights;                  // Weight of a use in the block
+    IRValueId* inStamps;                // Value last found live into the block
+    IRValueId* outStamps;               // Value last found live out of the block
+    IRBlockId* stack;
+    uint32_t* liveInStart;              // Values live into a block, from liveInValues[liveInStart[block]]
+    IRValueId* liveInValues;
+    uint32_t* loopEnds;                 // Per loop, past the last position of its blocks
+
+    IRRegAllocLiveValue* liveIns;
+    uint32_t liveInCount;
+    uint32_t liveInCapacity;
+    IRRegAllocRange* tempRanges;
+    uint32_t tempRangeCount;
+    uint32_t tempRangeCapacity;
+    IRRegAllocUse* tempUses;
+    uint32_t tempUseCount;
+    uint32_t tempUseCapacity;
+
+    uint32_t* calls;                    // Positions where a call clobbers, in order
+    uint32_t callCount;
+
+    // Intervals by start, the ones holding a register at the position of the scan, and by where they are live
+    // again the ones holding one over a hole there
+    uint32_t* heap;
+    uint32_t heapCount;
+    uint32_t heapCapacity;
+    uint32_t* active;
+    uint32_t activeCount;
+    uint32_t activeCapacity;
+    IRRegAllocInactive* inactive;
+    uint32_t inactiveCount;
+    uint32_t inactiveCapacity;
+    uint32_t* candidates;               // Inactive intervals live again before some position
+    uint32_t candidateCount;
+    uint32_t candidateCapacity;
+    uint32_t* walk;                     // Heap slots left to visit while gathering them
+    uint32_t walkCapacity;
+
+    IRRegAllocPendingMove* pending;
+    uint32_t pendingCount;
+    uint32_t pendingCapacity;
+    IRMove* parallel;
+    uint32_t parallelCapacity;
+} IRRegAllocScan;
+
+static inline uint32_t IRRegAllocFloor(uint32_t position)
+{
+    return position & ~(IR_REGALLOC_STEP - 1);
+}
+
+static inline uint32_t IRRegAllocMin(uint32_t a, uint32_t b)
+{
+    return a < b ? a : b;
+}
+
+static inline uint64_t IRRegAllocGroupMask(uint32_t reg, uint32_t count)
+{
+    return (count >= 64 ? UINT64_MAX : ((UINT64_C(1) << count) - 1)) << reg;
+}
+
+static inline uint32_t IRRegAllocSpillKind(const IRRegAllocInterval* interval)
+{
+    return interval->rematerialize ? IR_LOCATION_CONSTANT : IR_LOCATION_STACK;
+}
+
+static uint32_t IRRegAllocBytes(const IRRegAlloc alloc, IRType type)
+{
+    return type == IR_TYPE_PTR ? alloc->config.pointerBytes : IRType_GetSize(type);
+}
+
+/* Block whose positions hold `position` */
+static IRBlockId IRRegAllocBlockAt(const IRRegAlloc alloc, uint32_t position)
+{
+    uint32_t low = 1;
+    uint32_t high = alloc->blockCount - 1;
+    while (low < high) {
+        uint32_t middle = low + (high - low + 1) / 2;
+        if (alloc->blockStart[middle] <= position)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    return low;
+}
+
+/* First of the ranges from `low` up to `high` that ends after `position` */
+static uint32_t IRRegAllocSkipRanges(const IRRegAlloc alloc, uint32_t low, uint32_t high, uint32_t position)
+{
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (alloc->ranges[middle].to <= position)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/* First range of an interval that ends after `position` */
+static uint32_t IRRegAllocFirstRange(const IRRegAlloc alloc, const IRRegAllocInterval* interval, uint32_t position)
+{
+    return IRRegAllocSkipRanges(alloc, interval->range, interval->rangeEnd, position);
+}
+
+/* First use of an interval at or after `position` */
+static uint32_t IRRegAllocFirstUse(const IRRegAlloc alloc, const IRRegAllocInterval* interval, uint32_t position)
+{
+    uint32_t low = interval->use;
+    uint32_t high = interval->useEnd;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (alloc->uses[middle].position < position)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/* Position of the next use of an interval that requires a register, IR_REGALLOC_NONE without */
+static uint32_t IRRegAllocNextRegisterUse(const IRRegAlloc alloc, const IRRegAllocInterval* interval, uint32_t position)
+{
+    uint32_t use = IRRegAllocFirstUse(alloc, interval, position);
+    if (use == interval->useEnd || alloc->uses[use].nextRegister == IR_REGALLOC_NONE)
+        return IR_REGALLOC_NONE;
+
+    uint32_t next = alloc->uses[alloc->uses[use].nextRegister].position;
+    return next < interval->end ? next : IR_REGALLOC_NONE;
+}
+
+/* What the uses of an interval from `position` on weigh, the cost of keeping it out of a register */
+static uint64_t IRRegAllocWeight(const IRRegAlloc alloc, const IRRegAllocInterval* interval, uint32_t position)
+{
+    uint32_t first = IRRegAllocFirstUse(alloc, interval, position);
+    uint32_t last = IRRegAllocFirstUse(alloc, interval, interval->end);
+
+    // The uses end in one that belongs to no value
+    return alloc->uses[last].before - alloc->uses[first].before;
+}
+
+/* Check whether an interval is live at `position`, moving its cursor up to it */
+static bool IRRegAllocCovers(const IRRegAlloc alloc, IRRegAllocInterval* interval, uint32_t position)
+{
+    while (interval->cursor < interval->rangeEnd && alloc->ranges[interval->cursor].to <= position)
+        interval->cursor++;
+
+    if (interval->cursor == interval->rangeEnd || position < interval->start || position >= interval->end)
+        return false;
+
+    return alloc->ranges[interval->cursor].from <= position;
+}
+
+/* First position from `position` on and before `limit` where both intervals are live, IR_REGALLOC_NONE without */
+static uint32_t IRRegAllocIntersect(const IRRegAlloc alloc, const IRRegAllocInterval* a, const IRRegAllocInterval* b,
+    uint32_t position, uint32_t limit)
+{
+    uint32_t i = a->cursor;
+    uint32_t j = b->cursor;
+
+    while (i < a->rangeEnd && j < b->rangeEnd) {
+        const IRRegAllocRange* rangeA = &alloc->ranges[i];
+        const IRRegAllocRange* rangeB = &alloc->ranges[j];
+        if (rangeA->from >= IRRegAllocMin(a->end, limit) || rangeB->from >= IRRegAllocMin(b->end, limit))
+            break;
+
+        uint32_t from = rangeA->from > rangeB->from ? rangeA->from : rangeB->from;
+        from = from > a->start ? from : a->start;
+        from = from > b->start ? from : b->start;
+        from = from > position ? from : position;
+
+        uint32_t toA = IRRegAllocMin(rangeA->to, a->end);
+        uint32_t toB = IRRegAllocMin(rangeB->to, b->end);
+        if (from < IRRegAllocMin(toA, toB))
+            return from;
+
+        // The range that ends first meets nothing up to where the other one starts
+        if (toA <= toB)
+            i = IRRegAllocSkipRanges(alloc, i + 1, a->rangeEnd, rangeB->from);
+        else
+            j = IRRegAllocSkipRanges(alloc, j + 1, b->rangeEnd, rangeA->from);
+    }
+
+    return IR_REGALLOC_NONE;
+}
+
+/* First position from `position` on where a call clobbers while the interval is live */
+static uint32_t IRRegAllocFirstClobber(const IRRegAllocScan* scan, const IRRegAllocInterval* interval,
+    uint32_t position)
+{
+    const IRRegAlloc alloc = scan->alloc;
+    if (!(alloc->config.callerSavedMask & alloc->allocatable) || !scan->callCount)
+        return IR_REGALLOC_NONE;
+
+    for (uint32_t i = IRRegAllocFirstRange(alloc, interval, position); i < interval->rangeEnd; i++) {
+        uint32_t from = alloc->ranges[i].from;
+        from = from > interval->start ? from : interval->start;
+        from = from > position ? from : position;
+        uint32_t to = IRRegAllocMin(alloc->ranges[i].to, interval->end);
+        if (from >= interval->end)
+            break;
+
+        uint32_t low = 0;
+        uint32_t high = scan->callCount;
+        while (low < high) {
+            uint32_t middle = low + (high - low) / 2;
+            if (scan->calls[middle] < from)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        if (low < scan->callCount && scan->calls[low] < to)
+            return scan->calls[low];
+    }
+
+    return IR_REGALLOC_NONE;
+}
+
+/* Last interval of a value that starts at or before `position`, IR_REGALLOC_NONE without, while scanning */
+static uint32_t IRRegAllocFind(const IRRegAlloc alloc, IRValueId value, uint32_t position)
+{
+    uint32_t found = IR_REGALLOC_NONE;
+    for (uint32_t index = alloc->firstInterval[value];
+        index != IR_REGALLOC_NONE && alloc->intervals[index].start <= position;
+        index = alloc->intervals[index].next)
+        found = index;
+
+    return found;
+}
+
+/* Interval of a value that holds `position`, IR_REGALLOC_NONE outside its lifetime, once scanned */
+static uint32_t IRRegAllocLocate(const IRRegAlloc alloc, IRValueId value, uint32_t position)
+{
+    uint32_t low = alloc->childStart[value];
+    uint32_t high = alloc->childStart[value + 1];
+    if (low == high || alloc->intervals[alloc->children[low]].start > position)
+        return IR_REGALLOC_NONE;
+
+    while (high - low > 1) {
+        uint32_t middle = low + (high - low) / 2;
+        if (alloc->intervals[alloc->children[middle]].start <= position)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    uint32_t index = alloc->children[low];
+    return position < alloc->intervals[index].end ? index : IR_REGALLOC_NONE;
+}
+
+static IRLocation IRRegAllocLocation(const IRRegAlloc alloc, uint32_t index)
+{
+    IRLocation location = { IR_LOCATION_NONE, 0, 0 };
+    if (index == IR_REGALLOC_NONE)
+        return location;
+
+    const IRRegAllocInterval* interval = &alloc->intervals[index];
+    location.kind = interval->kind;
+    if (interval->kind == IR_LOCATION_REGISTER) {
+        location.count = interval->count;
+        location.index = interval->reg;
+    } else if (interval->kind == IR_LOCATION_STACK) {
+        location.count = interval->bytes;
+        location.index = alloc->slots[interval->value];
+    }
+
+    return location;
+}
+
+static inline bool IRRegAllocEarlier(const IRRegAlloc alloc, uint32_t a, uint32_t b)
+{
+    uint32_t startA = alloc->intervals[a].start;
+    uint32_t startB = alloc->intervals[b].start;
+
+    return startA != startB ? startA < startB : a < b;
+}
+
+static ParserResult IRRegAllocPush(IRRegAllocScan* scan, uint32_t index)
+{
+    IRRegAlloc alloc = scan->alloc;
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->heap, &scan->heapCapacity, scan->heapCount,
+        scan->heapCount + 1, sizeof(uint32_t), 64));
+
+    uint32_t slot = scan->heapCount++;
+    while (slot > 0) {
+        uint32_t parent = (slot - 1) / 2;
+        if (!IRRegAllocEarlier(alloc, index, scan->heap[parent]))
+            break;
+
+        scan->heap[slot] = scan->heap[parent];
+        slot = parent;
+    }
+
+    scan->heap[slot] = index;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static uint32_t IRRegAllocPop(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+    uint32_t top = scan->heap[0];
+    uint32_t last = scan->heap[--scan->heapCount];
+
+    uint32_t slot = 0;
+    for (;;) {
+        uint32_t child = slot * 2 + 1;
+        if (child >= scan->heapCount)
+            break;
+        if (child + 1 < scan->heapCount && IRRegAllocEarlier(alloc, scan->heap[child + 1], scan->heap[child]))
+            child++;
+        if (!IRRegAllocEarlier(alloc, scan->heap[child], last))
+            break;
+
+        scan->heap[slot] = scan->heap[child];
+        slot = child;
+    }
+
+    if (scan->heapCount)
+        scan->heap[slot] = last;
+
+    return top;
+}
+
+/* Set aside an interval that is not live at the position of the scan until its next range, drop it after its end */
+static ParserResult IRRegAllocSuspend(IRRegAllocScan* scan, uint32_t index)
+{
+    IRRegAlloc alloc = scan->alloc;
+    const IRRegAllocInterval* interval = &alloc->intervals[index];
+    if (interval->cursor == interval->rangeEnd || alloc->ranges[interval->cursor].from >= interval->end)
+        return PARSER_RESULT_SUCCESS;
+
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->inactive, &scan->inactiveCapacity, scan->inactiveCount,
+        scan->inactiveCount + 1, sizeof(IRRegAllocInactive), 64));
+
+    IRRegAllocInactive entry = { alloc->ranges[interval->cursor].from, index };
+    uint32_t slot = scan->inactiveCount++;
+    while (slot > 0) {
+        uint32_t parent = (slot - 1) / 2;
+        if (scan->inactive[parent].resume <= entry.resume)
+            break;
+
+        scan->inactive[slot] = scan->inactive[parent];
+        slot = parent;
+    }
+
+    scan->inactive[slot] = entry;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Take the inactive interval live again first */
+static uint32_t IRRegAllocResume(IRRegAllocScan* scan)
+{
+    uint32_t top = scan->inactive[0].interval;
+    IRRegAllocInactive last = scan->inactive[--scan->inactiveCount];
+
+    uint32_t slot = 0;
+    for (;;) {
+        uint32_t child = slot * 2 + 1;
+        if (child >= scan->inactiveCount)
+            break;
+        if (child + 1 < scan->inactiveCount && scan->inactive[child + 1].resume < scan->inactive[child].resume)
+            child++;
+        if (scan->inactive[child].resume >= last.resume)
+            break;
+
+        scan->inactive[slot] = scan->inactive[child];
+        slot = child;
+    }
+
+    if (scan->inactiveCount)
+        scan->inactive[slot] = last;
+
+    return top;
+}
+
+/* List the inactive intervals live again before `bound`, leaving the parts of the heap past it */
+static ParserResult IRRegAllocGather(IRRegAllocScan* scan, uint32_t bound)
+{
+    scan->candidateCount = 0;
+    if (!scan->inactiveCount || scan->inactive[0].resume >= bound)
+        return PARSER_RESULT_SUCCESS;
+
+    uint32_t top = 0;
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->walk, &scan->walkCapacity, top,
+        top + 1, sizeof(uint32_t), 64));
+    scan->walk[top++] = 0;
+
+    while (top) {
+        uint32_t slot = scan->walk[--top];
+        CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->candidates, &scan->candidateCapacity,
+            scan->candidateCount, scan->candidateCount + 1, sizeof(uint32_t), 64));
+        scan->candidates[scan->candidateCount++] = scan->inactive[slot].interval;
+
+        for (uint32_t child = slot * 2 + 1; child <= slot * 2 + 2 && child < scan->inactiveCount; child++) {
+            if (scan->inactive[child].resume >= bound)
+                continue;
+
+            CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->walk, &scan->walkCapacity, top,
+                top + 1, sizeof(uint32_t), 64));
+            scan->walk[top++] = child;
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Cut an interval at `position` inside it, the part from there on becomes the next interval of the value */
+static ParserResult IRRegAllocSplit(IRRegAllocScan* scan, uint32_t index, uint32_t position, uint32_t* child)
+{
+    IRRegAlloc alloc = scan->alloc;
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&alloc->intervals, &alloc->intervalCapacity, alloc->intervalCount,
+        alloc->intervalCount + 1, sizeof(IRRegAllocInterval), 64));
+
+    IRRegAllocInterval* parent = &alloc->intervals[index];
+    uint32_t first = IRRegAllocFirstRange(alloc, parent, position);
+    const IRRegAllocRange* range = &alloc->ranges[first];
+
+    uint32_t id = alloc->intervalCount++;
+    IRRegAllocInterval* split = &alloc->intervals[id];
+    *split = *parent;
+    split->start = range->from > position ? range->from : position;
+    split->range = first;
+    split->cursor = first;
+    split->use = IRRegAllocFirstUse(alloc, parent, split->start);
+    split->hintValue = parent->value;
+    split->hintPosition = split->start - 1;
+    split->kind = IR_LOCATION_NONE;
+    split->reg = 0;
+
+    // Cut in a hole, the interval ends with the range before it
+    parent->end = range->from < position ? position : alloc->ranges[first - 1].to;
+    parent->next = id;
+
+    alloc->stats.splits++;
+    *child = id;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/*
+ * Latest position after `low` and up to `high` to cut at: moved up to the
+ * header of the outermost loop around `high` that starts after `low`, so
+ * the moves go on the edge into the loop rather than into it
+ */
+static uint32_t IRRegAllocOptimalSplit(const IRRegAllocScan* scan, uint32_t low, uint32_t high)
+{
+    const IRRegAlloc alloc = scan->alloc;
+    uint32_t position = high;
+
+    IRBlockId block = IRRegAllocBlockAt(alloc, high);
+    for (IRLoopId loop = IRLoopTree_GetLoop(scan->loops, block); loop != IR_LOOP_NONE;
+        loop = IRLoopTree_GetParent(scan->loops, loop)) {
+        uint32_t header = alloc->blockStart[IRLoopTree_GetHeader(scan->loops, loop)];
+        if (header <= low)
+            break;
+
+        position = header;
+    }
+
+    return position;
+}
+
+/* Check whether an interval before this one of its value went to the stack, its slot holds the value from then on */
+static bool IRRegAllocHasSlot(const IRRegAlloc alloc, uint32_t index)
+{
+    for (uint32_t i = alloc->firstInterval[alloc->intervals[index].value]; i != index && i != IR_REGALLOC_NONE;
+        i = alloc->intervals[i].next) {
+        if (alloc->intervals[i].kind == IR_LOCATION_STACK)
+            return true;
+    }
+
+    return false;
+}
+
+/* Keep an interval that lost its register out of one up to its next use that needs one, the rest waits again */
+static ParserResult IRRegAllocSpill(IRRegAllocScan* scan, uint32_t index)
+{
+    IRRegAlloc alloc = scan->alloc;
+    IRRegAllocInterval* interval = &alloc->intervals[index];
+    uint32_t use = IRRegAllocNextRegisterUse(alloc, interval, interval->start);
+
+    interval->kind = IR_LOCATION_NONE;
+    if (use != IR_REGALLOC_NONE && IRRegAllocFloor(use) <= interval->start)
+        return IRRegAllocPush(scan, index);
+
+    interval->kind = IRRegAllocSpillKind(interval);
+    if (use == IR_REGALLOC_NONE)
+        return PARSER_RESULT_SUCCESS;
+
+    uint32_t child;
+    CHECK_PARSER_RESULT(IRRegAllocSplit(scan, index, IRRegAllocOptimalSplit(scan, interval->start,
+        IRRegAllocFloor(use)), &child));
+
+    return IRRegAllocPush(scan, child);
+}
+
+/*
+ * What the uses of an interval weigh from `position` on, with the ones from
+ * the header of each loop around it up to there again when the interval is
+ * live through the end of the loop: the next iteration reads them first
+ */
+static uint64_t IRRegAllocLoopWeight(const IRRegAllocScan* scan, const IRRegAllocInterval* interval,
+    uint32_t position)
+{
+    const IRRegAlloc alloc = scan->alloc;
+    uint64_t weight = IRRegAllocWeight(alloc, interval, position);
+
+    IRBlockId block = IRRegAllocBlockAt(alloc, position);
+    for (IRLoopId loop = IRLoopTree_GetLoop(scan->loops, block); loop != IR_LOOP_NONE;
+        loop = IRLoopTree_GetParent(scan->loops, loop)) {
+        uint32_t last = scan->loopEnds[loop] - 1;
+        if (interval->end <= last)
+            break;
+
+        uint32_t range = IRRegAllocFirstRange(alloc, interval, last);
+        if (range == interval->rangeEnd || alloc->ranges[range].from > last)
+            continue;
+
+        uint32_t header = alloc->blockStart[IRLoopTree_GetHeader(scan->loops, loop)];
+        uint32_t first = IRRegAllocFirstUse(alloc, interval, header > interval->start ? header : interval->start);
+        weight += alloc->uses[IRRegAllocFirstUse(alloc, interval, position)].before - alloc->uses[first].before;
+    }
+
+    return weight;
+}
+
+/* Register the interval should take to save a move, IR_REGALLOC_NONE without */
+static uint32_t IRRegAllocHint(const IRRegAlloc alloc, uint32_t current)
+{
+    const IRRegAllocInterval* interval = &alloc->intervals[current];
+    if (interval->hintValue == IR_VALUE_NONE)
+        return IR_REGALLOC_NONE;
+
+    uint32_t index = IRRegAllocFind(alloc, interval->hintValue, interval->hintPosition);
+    if (index == IR_REGALLOC_NONE)
+        return IR_REGALLOC_NONE;
+
+    const IRRegAllocInterval* hint = &alloc->intervals[index];
+    if (hint->kind != IR_LOCATION_REGISTER || hint->end <= interval->hintPosition)
+        return IR_REGALLOC_NONE;
+
+    return hint->reg - hint->reg % interval->align;
+}
+
+/* Position up to which every register of a group is free */
+static uint32_t IRRegAllocGroupUntil(const uint32_t* until, uint32_t reg, uint32_t count, uint32_t registerCount)
+{
+    if (reg + count > registerCount)
+        return 0;
+
+    uint32_t result = IR_REGALLOC_NONE;
+    for (uint32_t r = reg; r < reg + count; r++)
+        result = IRRegAllocMin(result, until[r]);
+
+    return result;
+}
+
+/* Give the interval the registers free the longest, cut where they are taken */
+static ParserResult IRRegAllocTryFree(IRRegAllocScan* scan, uint32_t current, bool* assigned)
+{
+    IRRegAlloc alloc = scan->alloc;
+    uint32_t registerCount = alloc->config.registerCount;
+    uint32_t freeUntil[IR_REGALLOC_MAX_REGISTERS];
+
+    *assigned = false;
+    for (uint32_t r = 0; r < registerCount; r++)
+        freeUntil[r] = (alloc->allocatable >> r) & 1 ? IR_REGALLOC_NONE : 0;
+
+    for (uint32_t i = 0; i < scan->activeCount; i++) {
+        const IRRegAllocInterval* active = &alloc->intervals[scan->active[i]];
+        for (uint32_t r = active->reg; r < active->reg + active->count; r++)
+            freeUntil[r] = 0;
+    }
+
+    IRRegAllocInterval* interval = &alloc->intervals[current];
+    CHECK_PARSER_RESULT(IRRegAllocGather(scan, interval->end));
+    for (uint32_t i = 0; i < scan->candidateCount; i++) {
+        const IRRegAllocInterval* inactive = &alloc->intervals[scan->candidates[i]];
+        // Only where it would take a register sooner
+        uint32_t limit = 0;
+        for (uint32_t r = inactive->reg; r < inactive->reg + inactive->count; r++)
+            limit = limit > freeUntil[r] ? limit : freeUntil[r];
+
+        uint32_t position = IRRegAllocIntersect(alloc, inactive, interval, interval->start, limit);
+        if (position == IR_REGALLOC_NONE)
+            continue;
+
+        for (uint32_t r = inactive->reg; r < inactive->reg + inactive->count; r++)
+            freeUntil[r] = IRRegAllocMin(freeUntil[r], position);
+    }
+
+    uint32_t clobber = IRRegAllocFirstClobber(scan, interval, interval->start);
+    if (clobber != IR_REGALLOC_NONE) {
+        for (uint32_t r = 0; r < registerCount; r++) {
+            if ((alloc->config.callerSavedMask >> r) & 1)
+                freeUntil[r] = IRRegAllocMin(freeUntil[r], clobber);
+        }
+    }
+
+    uint32_t best = IR_REGALLOC_NONE;
+    uint32_t bestUntil = 0;
+    bool hinted = false;
+    uint32_t hint = IRRegAllocHint(alloc, current);
+    if (hint != IR_REGALLOC_NONE) {
+        uint32_t until = IRRegAllocGroupUntil(freeUntil, hint, interval->count, registerCount);
+        if (until >= interval->end) {
+            best = hint;
+            bestUntil = until;
+            hinted = true;
+        }
+    }
+
+    // Otherwise the lowest of the groups free the longest
+    for (uint32_t reg = 0; !hinted && reg + interval->count <= registerCount; reg += interval->align) {
+        uint32_t until = IRRegAllocGroupUntil(freeUntil, reg, interval->count, registerCount);
+        if (until > bestUntil) {
+            best = reg;
+            bestUntil = until;
+        }
+    }
+
+    if (best == IR_REGALLOC_NONE || bestUntil <= interval->start)
+        return PARSER_RESULT_SUCCESS;
+
+    if (bestUntil < interval->end) {
+        if (IRRegAllocFloor(bestUntil) <= interval->start)
+            return PARSER_RESULT_SUCCESS;
+
+        uint32_t child;
+        CHECK_PARSER_RESULT(IRRegAllocSplit(scan, current, IRRegAllocOptimalSplit(scan, interval->start,
+            IRRegAllocFloor(bestUntil)), &child));
+        CHECK_PARSER_RESULT(IRRegAllocPush(scan, child));
+        interval = &alloc->intervals[current];
+    }
+
+    interval->kind = IR_LOCATION_REGISTER;
+    interval->reg = (uint8_t)best;
+    *assigned = true;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Check whether an interval needs its register from `position` on within its instruction */
+static bool IRRegAllocPinned(const IRRegAlloc alloc, const IRRegAllocInterval* interval, uint32_t position)
+{
+    uint32_t use = IRRegAllocNextRegisterUse(alloc, interval, position);
+
+    return use != IR_REGALLOC_NONE && use < IRRegAllocFloor(position) + IR_REGALLOC_STEP;
+}
+
+/*
+ * Where an interval that loses its register at `position` ends: after the
+ * instruction reads it, else before. When nothing read it since a loop
+ * header or the end of a hole, there instead, the moves go on the edges.
+ */
+static uint32_t IRRegAllocEvictPosition(const IRRegAllocScan* scan, const IRRegAllocInterval* interval,
+    uint32_t position)
+{
+    const IRRegAlloc alloc = scan->alloc;
+    uint32_t cut = IRRegAllocFloor(position);
+    if (position > cut + IR_REGALLOC_CLOBBER && IRRegAllocNextRegisterUse(alloc, interval, cut) < position)
+        return cut + IR_REGALLOC_CLOBBER;
+
+    uint32_t use = IRRegAllocFirstUse(alloc, interval, cut);
+    uint32_t low = use > interval->use ? alloc->uses[use - 1].position : interval->start;
+    uint32_t range = IRRegAllocFirstRange(alloc, interval, cut);
+    uint32_t earlier = IRRegAllocOptimalSplit(scan, low, cut);
+    if (earlier == cut && range < interval->rangeEnd && alloc->ranges[range].from > low)
+        earlier = IRRegAllocMin(alloc->ranges[range].from, cut);
+
+    // The scan is at `position`, where the spilled part comes back into a register has to be past it
+    uint32_t next = IRRegAllocNextRegisterUse(alloc, interval, cut);
+    if (next != IR_REGALLOC_NONE && IRRegAllocOptimalSplit(scan, earlier, IRRegAllocFloor(next)) < cut)
+        return cut;
+
+    return earlier;
+}
+
+/*
+ * No register is free: take the group whose intervals weigh least from
+ * here on and cut them, or keep the interval itself out of a register up
+ * to its first use that needs one when that is later than theirs, or the
+ * interval weighs less
+ */
+static ParserResult IRRegAllocEvict(IRRegAllocScan* scan, uint32_t current)
+{
+    IRRegAlloc alloc = scan->alloc;
+    uint32_t registerCount = alloc->config.registerCount;
+    IRRegAllocInterval* interval = &alloc->intervals[current];
+    uint32_t position = interval->start;
+
+    uint32_t use = IRRegAllocNextRegisterUse(alloc, interval, position);
+    if (use == IR_REGALLOC_NONE) {
+        interval->kind = IRRegAllocSpillKind(interval);
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    uint32_t nextUse[IR_REGALLOC_MAX_REGISTERS];
+    uint32_t blocked[IR_REGALLOC_MAX_REGISTERS];
+    uint64_t cost[IR_REGALLOC_MAX_REGISTERS];
+    for (uint32_t r = 0; r < registerCount; r++) {
+        nextUse[r] = blocked[r] = (alloc->allocatable >> r) & 1 ? IR_REGALLOC_NONE : 0;
+        cost[r] = 0;
+    }
+
+    CHECK_PARSER_RESULT(IRRegAllocGather(scan, interval->end));
+    for (uint32_t i = 0; i < scan->activeCount + scan->candidateCount; i++) {
+        bool active = i < scan->activeCount;
+        const IRRegAllocInterval* other = &alloc->intervals[active ? scan->active[i] : scan->candidates[i - scan->activeCount]];
+        if (!active && IRRegAllocIntersect(alloc, other, interval, position, IR_REGALLOC_NONE) == IR_REGALLOC_NONE)
+            continue;
+
+        bool pinned = active && IRRegAllocPinned(alloc, other, position);
+        uint32_t otherUse = IRRegAllocNextRegisterUse(alloc, other, position);
+        uint64_t weight = IRRegAllocLoopWeight(scan, other, position);
+        for (uint32_t r = other->reg; r < other->reg + other->count; r++) {
+            if (pinned)
+                nextUse[r] = blocked[r] = 0;
+            nextUse[r] = IRRegAllocMin(nextUse[r], otherUse);
+            cost[r] += weight;
+        }
+    }
+
+    uint32_t clobber = IRRegAllocFirstClobber(scan, interval, position);
+    if (clobber != IR_REGALLOC_NONE) {
+        for (uint32_t r = 0; r < registerCount; r++) {
+            if ((alloc->config.callerSavedMask >> r) & 1) {
+                blocked[r] = IRRegAllocMin(blocked[r], clobber);
+                nextUse[r] = IRRegAllocMin(nextUse[r], clobber);
+            }
+        }
+    }
+
+    uint32_t best = IR_REGALLOC_NONE;
+    uint32_t bestNext = 0;
+    uint32_t bestBlocked = 0;
+    uint64_t bestCost = 0;
+    for (uint32_t reg = 0; reg + interval->count <= registerCount; reg += interval->align) {
+        uint32_t groupBlocked = IRRegAllocGroupUntil(blocked, reg, interval->count, registerCount);
+        uint32_t groupNext = IRRegAllocGroupUntil(nextUse, reg, interval->count, registerCount);
+        uint64_t groupCost = 0;
+        for (uint32_t r = reg; r < reg + interval->count; r++)
+            groupCost += cost[r];
+
+        // The group has to hold the interval up to its first use, and be cut short of a call after it
+        if (groupBlocked <= use || (groupBlocked < interval->end && IRRegAllocFloor(groupBlocked) <= interval->start))
+            continue;
+
+        if (best == IR_REGALLOC_NONE || groupCost < bestCost || (groupCost == bestCost && groupNext > bestNext)) {
+            best = reg;
+            bestNext = groupNext;
+            bestBlocked = groupBlocked;
+            bestCost = groupCost;
+        }
+    }
+
+    bool spillable = IRRegAllocFloor(use) > interval->start;
+    if (spillable && (best == IR_REGALLOC_NONE || use > bestNext ||
+        IRRegAllocLoopWeight(scan, interval, position) < bestCost)) {
+        interval->kind = IRRegAllocSpillKind(interval);
+
+        uint32_t child;
+        CHECK_PARSER_RESULT(IRRegAllocSplit(scan, current, IRRegAllocOptimalSplit(scan, position,
+            IRRegAllocFloor(use)), &child));
+        return IRRegAllocPush(scan, child);
+    }
+
+    if (best == IR_REGALLOC_NONE)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    // Active intervals leave the group at the instruction, or at their own start
+    uint64_t group = IRRegAllocGroupMask(best, interval->count);
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < scan->activeCount; i++) {
+        uint32_t index = scan->active[i];
+        const IRRegAllocInterval* active = &alloc->intervals[index];
+        if (!(IRRegAllocGroupMask(active->reg, active->count) & group)) {
+            scan->active[kept++] = index;
+            continue;
+        }
+
+        uint32_t cut = IRRegAllocEvictPosition(scan, active, position);
+        if (active->start >= cut) {
+            CHECK_PARSER_RESULT(IRRegAllocSpill(scan, index));
+            continue;
+        }
+
+        uint32_t child;
+        scan->active[kept++] = index;
+        CHECK_PARSER_RESULT(IRRegAllocSplit(scan, index, cut, &child));
+        CHECK_PARSER_RESULT(IRRegAllocSpill(scan, child));
+    }
+
+    scan->activeCount = kept;
+
+    // Inactive ones at the end of their hole
+    for (uint32_t i = 0; i < scan->candidateCount; i++) {
+        uint32_t index = scan->candidates[i];
+        const IRRegAllocInterval* inactive = &alloc->intervals[index];
+        if (!(IRRegAllocGroupMask(inactive->reg, inactive->count) & group) ||
+            IRRegAllocIntersect(alloc, inactive, &alloc->intervals[current], position, IR_REGALLOC_NONE) == IR_REGALLOC_NONE)
+            continue;
+
+        uint32_t child;
+        CHECK_PARSER_RESULT(IRRegAllocSplit(scan, index, alloc->ranges[inactive->cursor].from, &child));
+        CHECK_PARSER_RESULT(IRRegAllocSpill(scan, child));
+    }
+
+    interval = &alloc->intervals[current];
+    interval->kind = IR_LOCATION_REGISTER;
+    interval->reg = (uint8_t)best;
+    if (bestBlocked < interval->end) {
+        uint32_t child;
+        CHECK_PARSER_RESULT(IRRegAllocSplit(scan, current, IRRegAllocOptimalSplit(scan, position,
+            IRRegAllocFloor(bestBlocked)), &child));
+        CHECK_PARSER_RESULT(IRRegAllocPush(scan, child));
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Hand out registers to the intervals by start */
+static ParserResult IRRegAllocScanIntervals(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+
+    while (scan->heapCount) {
+        uint32_t current = IRRegAllocPop(scan);
+        uint32_t position = alloc->intervals[current].start;
+
+        // Intervals that ended are done, the others move between active and inactive
+        uint32_t activeCount = 0;
+        for (uint32_t i = 0; i < scan->activeCount; i++) {
+            uint32_t index = scan->active[i];
+            IRRegAllocInterval* interval = &alloc->intervals[index];
+            if (interval->end <= position)
+                continue;
+
+            if (IRRegAllocCovers(alloc, interval, position))
+                scan->active[activeCount++] = index;
+            else
+                CHECK_PARSER_RESULT(IRRegAllocSuspend(scan, index));
+        }
+
+        scan->activeCount = activeCount;
+
+        while (scan->inactiveCount && scan->inactive[0].resume <= position) {
+            uint32_t index = IRRegAllocResume(scan);
+            IRRegAllocInterval* interval = &alloc->intervals[index];
+            if (interval->end <= position)
+                continue;
+
+            if (!IRRegAllocCovers(alloc, interval, position)) {
+                CHECK_PARSER_RESULT(IRRegAllocSuspend(scan, index));
+                continue;
+            }
+
+            // Back from a hole with nothing to read it from a register, a value with a slot gives its register up
+            uint32_t from = alloc->ranges[interval->cursor].from;
+            if (IRRegAllocNextRegisterUse(alloc, interval, from) == IR_REGALLOC_NONE &&
+                (interval->rematerialize || IRRegAllocHasSlot(alloc, index))) {
+                uint32_t child;
+                CHECK_PARSER_RESULT(IRRegAllocSplit(scan, index, from, &child));
+                CHECK_PARSER_RESULT(IRRegAllocSpill(scan, child));
+                continue;
+            }
+
+            CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->active, &scan->activeCapacity, scan->activeCount,
+                scan->activeCount + 1, sizeof(uint32_t), 64));
+            scan->active[scan->activeCount++] = index;
+        }
+
+        // Nothing reads it from a register, a value that costs nothing to keep out of one stays out
+        IRRegAllocInterval* interval = &alloc->intervals[current];
+        if (IRRegAllocNextRegisterUse(alloc, interval, position) == IR_REGALLOC_NONE &&
+            (interval->rematerialize || IRRegAllocHasSlot(alloc, current))) {
+            interval->kind = IRRegAllocSpillKind(interval);
+            continue;
+        }
+
+        bool assigned;
+        CHECK_PARSER_RESULT(IRRegAllocTryFree(scan, current, &assigned));
+        if (!assigned)
+            CHECK_PARSER_RESULT(IRRegAllocEvict(scan, current));
+
+        if (alloc->intervals[current].kind == IR_LOCATION_REGISTER) {
+            CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->active, &scan->activeCapacity, scan->activeCount,
+                scan->activeCount + 1, sizeof(uint32_t), 64));
+            scan->active[scan->activeCount++] = current;
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Give every edge from a block with several successors into a block with several predecessors a block of its own */
+static ParserResult IRRegAllocSplitEdges(IRFunction function)
+{
+    uint32_t blockCount = IRFunction_GetBlockCount(function);
+    IRBlockId* stamps = PARSER_MALLOC(sizeof(IRBlockId) * 2 * blockCount, 0);
+    if (!stamps)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(stamps, 0, sizeof(IRBlockId) * blockCount);
+    IRBlockId* split = stamps + blockCount;
+
+    ParserResult result = PARSER_RESULT_SUCCESS;
+    for (IRBlockId block = 1; block < blockCount && result == PARSER_RESULT_SUCCESS; block++) {
+        if (IRFunction_GetBlock(function, block)->flags & IR_BLOCK_FLAG_REMOVED)
+            continue;
+
+        uint32_t predCount;
+        const IRBlockId* preds = IRFunction_GetPredecessors(function, block, &predCount);
+        uint32_t i = 1;
+        while (i < predCount && preds[i] == preds[0])
+            i++;
+
+        if (i == predCount)
+            continue;
+
+        // Splitting changes the predecessors, the ones to split are taken first
+        uint32_t splitCount = 0;
+        for (i = 0; i < predCount; i++) {
+            if (stamps[preds[i]] != block && IRFunction_GetSuccessorCount(function, preds[i]) > 1)
+                split[splitCount++] = preds[i];
+            stamps[preds[i]] = block;
+        }
+
+        for (i = 0; i < splitCount && result == PARSER_RESULT_SUCCESS; i++) {
+            IRBlockId edge;
+            result = IRFunction_SplitPredecessors(function, block, &split[i], 1, &edge);
+        }
+    }
+
+    PARSER_FREE(stamps);
+
+    return result;
+}
+
+/* Number the positions of the blocks and instructions, and find the calls */
+static void IRRegAllocNumber(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+    IRFunction function = scan->function;
+
+    for (IRValueId id = 1; id < alloc->valueCount; id++) {
+        const IRInstruction* record = IRFunction_GetInstruction(function, id);
+        alloc->positions[id] = IR_REGALLOC_NONE;
+        alloc->firstInterval[id] = IR_REGALLOC_NONE;
+        alloc->slots[id] = IR_REGALLOC_NONE;
+        if (record->opcode == IR_OP_CONST)
+            alloc->valueFlags[id] = IR_REGALLOC_VALUE_CONSTANT;
+    }
+
+    uint32_t position = 0;
+    for (IRBlockId block = 1; block < alloc->blockCount; block++) {
+        uint32_t depth = IRLoopTree_GetDepth(scan->loops, block);
+        scan->weights[block] = 1u << (3 * IRRegAllocMin(depth, IR_REGALLOC_MAX_DEPTH));
+        scan->blockFirst[block] = IR_VALUE_NONE;
+        alloc->blockStart[block] = position;
+
+        const IRInstruction* record;
+        for (IRValueId id = IRFunction_GetBlock(function, block)->first; id != IR_VALUE_NONE; id = record->next) {
+            record = IRFunction_GetInstruction(function, id);
+            if (record->opcode == IR_OP_PHI) {
+                alloc->positions[id] = position;
+                alloc->valueFlags[id] = IR_REGALLOC_VALUE_PHI;
+                continue;
+            }
+
+            if (scan->blockFirst[block] == IR_VALUE_NONE)
+                scan->blockFirst[block] = id;
+
+            position += IR_REGALLOC_STEP;
+            alloc->positions[id] = position;
+            if (record->opcode == IR_OP_CALL)
+                scan->calls[scan->callCount++] = position + IR_REGALLOC_CLOBBER;
+        }
+
+        position += IR_REGALLOC_STEP;
+    }
+
+    alloc->blockStart[alloc->blockCount] = position;
+
+    // Blocks of a loop need not follow each other, the one laid out last ends it
+    for (IRBlockId block = 1; block < alloc->blockCount; block++) {
+        for (IRLoopId loop = IRLoopTree_GetLoop(scan->loops, block); loop != IR_LOOP_NONE;
+            loop = IRLoopTree_GetParent(scan->loops, loop)) {
+            if (scan->loopEnds[loop] < alloc->blockStart[block + 1])
+                scan->loopEnds[loop] = alloc->blockStart[block + 1];
+        }
+    }
+}
+
+static ParserResult IRRegAllocAddRange(IRRegAllocScan* scan, uint32_t from, uint32_t to)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->tempRanges, &scan->tempRangeCapacity, scan->tempRangeCount,
+        scan->tempRangeCount + 1, sizeof(IRRegAllocRange), 64));
+
+    scan->tempRanges[scan->tempRangeCount].from = from;
+    scan->tempRanges[scan->tempRangeCount++].to = to;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRRegAllocAddUse(IRRegAllocScan* scan, uint32_t position, bool requiresRegister, uint32_t weight)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->tempUses, &scan->tempUseCapacity, scan->tempUseCount,
+        scan->tempUseCount + 1, sizeof(IRRegAllocUse), 64));
+
+    IRRegAllocUse* use = &scan->tempUses[scan->tempUseCount++];
+    memset(use, 0, sizeof(IRRegAllocUse));
+    use->position = position;
+    use->requiresRegister = requiresRegister;
+    use->weight = weight;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static int IRRegAllocCompareRanges(const void* a, const void* b)
+{
+    const IRRegAllocRange* rangeA = (const IRRegAllocRange*)a;
+    const IRRegAllocRange* rangeB = (const IRRegAllocRange*)b;
+
+    if (rangeA->from != rangeB->from)
+        return rangeA->from < rangeB->from ? -1 : 1;
+
+    return rangeA->to < rangeB->to ? -1 : (rangeA->to > rangeB->to ? 1 : 0);
+}
+
+static int IRRegAllocCompareUses(const void* a, const void* b)
+{
+    const IRRegAllocUse* useA = (const IRRegAllocUse*)a;
+    const IRRegAllocUse* useB = (const IRRegAllocUse*)b;
+
+    if (useA->position != useB->position)
+        return useA->position < useB->position ? -1 : 1;
+
+    return useA->requiresRegister < useB->requiresRegister ? -1 : (useA->requiresRegister > useB->requiresRegister ? 1 : 0);
+}
+
+/* Merge the gathered ranges and uses into the tables and make them the first interval of a value */
+static ParserResult IRRegAllocAddInterval(IRRegAllocScan* scan, IRValueId value, IRType type, bool rematerialize,
+    uint32_t* index)
+{
+    IRRegAlloc alloc = scan->alloc;
+
+    uint32_t bytes = IRRegAllocBytes(alloc, type);
+    uint32_t count = (bytes + alloc->config.registerBytes - 1) / alloc->config.registerBytes;
+    uint32_t align = count > 1 ? 2 : 1;
+
+    // Some group of registers has to hold the value
+    uint32_t reg = 0;
+    while (reg + count <= alloc->config.registerCount &&
+        (IRRegAllocGroupMask(reg, count) & ~alloc->allocatable))
+        reg += align;
+    if (reg + count > alloc->config.registerCount)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    qsort(scan->tempRanges, scan->tempRangeCount, sizeof(IRRegAllocRange), IRRegAllocCompareRanges);
+    qsort(scan->tempUses, scan->tempUseCount, sizeof(IRRegAllocUse), IRRegAllocCompareUses);
+
+    uint32_t firstRange = alloc->rangeCount;
+    for (uint32_t i = 0; i < scan->tempRangeCount; i++) {
+        const IRRegAllocRange* range = &scan->tempRanges[i];
+        if (alloc->rangeCount > firstRange && range->from <= alloc->ranges[alloc->rangeCount - 1].to) {
+            IRRegAllocRange* last = &alloc->ranges[alloc->rangeCount - 1];
+            last->to = range->to > last->to ? range->to : last->to;
+            continue;
+        }
+
+        CHECK_PARSER_RESULT(ParserArrayReserve((void**)&alloc->ranges, &alloc->rangeCapacity, alloc->rangeCount,
+            alloc->rangeCount + 1, sizeof(IRRegAllocRange), 64));
+        alloc->ranges[alloc->rangeCount++] = *range;
+    }
+
+    // Uses at one position become one, the last of them the one that requires a register if any does
+    uint32_t firstUse = alloc->useCount;
+    for (uint32_t i = 0; i < scan->tempUseCount; i++) {
+        const IRRegAllocUse* use = &scan->tempUses[i];
+        if (alloc->useCount > firstUse && use->position == alloc->uses[alloc->useCount - 1].position) {
+            alloc->uses[alloc->useCount - 1].requiresRegister = use->requiresRegister;
+            continue;
+        }
+
+        CHECK_PARSER_RESULT(ParserArrayReserve((void**)&alloc->uses, &alloc->useCapacity, alloc->useCount,
+            alloc->useCount + 1, sizeof(IRRegAllocUse), 64));
+
+        uint64_t before = alloc->useCount ? alloc->uses[alloc->useCount - 1].before + alloc->uses[alloc->useCount - 1].weight : 0;
+        alloc->uses[alloc->useCount] = *use;
+        alloc->uses[alloc->useCount++].before = before;
+    }
+
+    uint32_t nextRegister = IR_REGALLOC_NONE;
+    for (uint32_t i = alloc->useCount; i-- > firstUse;) {
+        if (alloc->uses[i].requiresRegister)
+            nextRegister = i;
+        alloc->uses[i].nextRegister = nextRegister;
+    }
+
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&alloc->intervals, &alloc->intervalCapacity, alloc->intervalCount,
+        alloc->intervalCount + 1, sizeof(IRRegAllocInterval), 64));
+
+    *index = alloc->intervalCount++;
+    IRRegAllocInterval* interval = &alloc->intervals[*index];
+    memset(interval, 0, sizeof(IRRegAllocInterval));
+    interval->value = value;
+    interval->start = alloc->ranges[firstRange].from;
+    interval->end = alloc->ranges[alloc->rangeCount - 1].to;
+    interval->range = firstRange;
+    interval->rangeEnd = alloc->rangeCount;
+    interval->cursor = firstRange;
+    interval->use = firstUse;
+    interval->useEnd = alloc->useCount;
+    interval->next = IR_REGALLOC_NONE;
+    interval->hintPosition = IR_REGALLOC_NONE;
+    interval->kind = IR_LOCATION_NONE;
+    interval->count = (uint8_t)count;
+    interval->align = (uint8_t)align;
+    interval->bytes = (uint8_t)bytes;
+    interval->rematerialize = rematerialize;
+
+    return IRRegAllocPush(scan, *index);
+}
+
+static ParserResult IRRegAllocLiveIn(IRRegAllocScan* scan, IRBlockId block, IRValueId value, uint32_t* top)
+{
+    if (scan->inStamps[block] == value)
+        return PARSER_RESULT_SUCCESS;
+
+    scan->inStamps[block] = value;
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->liveIns, &scan->liveInCapacity, scan->liveInCount,
+        scan->liveInCount + 1, sizeof(IRRegAllocLiveValue), 64));
+    scan->liveIns[scan->liveInCount].block = block;
+    scan->liveIns[scan->liveInCount++].value = value;
+
+    uint32_t predCount;
+    const IRBlockId* preds = IRFunction_GetPredecessors(scan->function, block, &predCount);
+    for (uint32_t i = 0; i < predCount; i++) {
+        if (scan->outStamps[preds[i]] != value) {
+            scan->outStamps[preds[i]] = value;
+            scan->stack[(*top)++] = preds[i];
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Ranges and uses of a value, walking up from every use to the definition */
+static ParserResult IRRegAllocBuildValue(IRRegAllocScan* scan, IRValueId value)
+{
+    IRRegAlloc alloc = scan->alloc;
+    IRFunction function = scan->function;
+    const IRInstruction* record = IRFunction_GetInstruction(function, value);
+    IRBlockId defBlock = record->block;
+    bool phi = record->opcode == IR_OP_PHI;
+    bool rematerialize = record->opcode == IR_OP_GLOBAL || record->opcode == IR_OP_ALLOCA;
+    uint32_t def = phi ? alloc->positions[value] : alloc->positions[value] + IR_REGALLOC_WRITE;
+
+    uint32_t useCount;
+    const IRUse* uses = IRFunction_GetUses(function, value, &useCount);
+    if (phi && !useCount)
+        return PARSER_RESULT_SUCCESS;
+
+    scan->tempRangeCount = 0;
+    scan->tempUseCount = 0;
+    if (!phi)
+        CHECK_PARSER_RESULT(IRRegAllocAddUse(scan, def, !rematerialize, scan->weights[defBlock]));
+
+    uint32_t top = 0;
+    for (uint32_t i = 0; i < useCount; i++) {
+        const IRInstruction* user = IRFunction_GetInstruction(function, uses[i].user);
+
+        // A phi reads at the end of the predecessor
+        if (user->opcode == IR_OP_PHI) {
+            uint32_t predCount;
+            IRBlockId pred = IRFunction_GetPredecessors(function, user->block, &predCount)[uses[i].slot - IR_USE_LIST_SLOT];
+            if (scan->outStamps[pred] != value) {
+                scan->outStamps[pred] = value;
+                scan->stack[top++] = pred;
+            }
+            continue;
+        }
+
+        uint32_t read = alloc->positions[uses[i].user] + IR_REGALLOC_READ;
+        bool requiresRegister = user->opcode != IR_OP_CALL && user->opcode != IR_OP_RET;
+        CHECK_PARSER_RESULT(IRRegAllocAddUse(scan, read, requiresRegister, scan->weights[user->block]));
+
+        if (user->block == defBlock) {
+            CHECK_PARSER_RESULT(IRRegAllocAddRange(scan, def, read + 1));
+            continue;
+        }
+
+        CHECK_PARSER_RESULT(IRRegAllocAddRange(scan, alloc->blockStart[user->block], read + 1));
+        CHECK_PARSER_RESULT(IRRegAllocLiveIn(scan, user->block, value, &top));
+    }
+
+    while (top) {
+        IRBlockId block = scan->stack[--top];
+        if (block == defBlock) {
+            CHECK_PARSER_RESULT(IRRegAllocAddRange(scan, def, alloc->blockStart[block + 1]));
+            continue;
+        }
+
+        CHECK_PARSER_RESULT(IRRegAllocAddRange(scan, alloc->blockStart[block], alloc->blockStart[block + 1]));
+        CHECK_PARSER_RESULT(IRRegAllocLiveIn(scan, block, value, &top));
+    }
+
+    // A result nothing reads still takes a register where it is written
+    if (!scan->tempRangeCount)
+        CHECK_PARSER_RESULT(IRRegAllocAddRange(scan, def, def + 1));
+
+    uint32_t index;
+    CHECK_PARSER_RESULT(IRRegAllocAddInterval(scan, value, (IRType)record->type, rematerialize, &index));
+    alloc->firstInterval[value] = index;
+
+    // The result of a two-address instruction goes best into its first operand, a phi into an operand
+    IRRegAllocInterval* interval = &alloc->intervals[index];
+    const IROpcodeInfo* info = IROpcode_GetInfo((IROpcode)record->opcode);
+    if (phi) {
+        uint32_t predCount;
+        uint32_t operandCount;
+        const IRBlockId* preds = IRFunction_GetPredecessors(function, defBlock, &predCount);
+        const uint32_t* operands = IRFunction_GetList(function, value, &operandCount);
+        for (uint32_t i = 0; i < operandCount; i++) {
+            if (alloc->positions[operands[i]] != IR_REGALLOC_NONE && preds[i] < defBlock) {
+                interval->hintValue = operands[i];
+                interval->hintPosition = alloc->blockStart[preds[i] + 1] - 1;
+                break;
+            }
+        }
+    } else if (info->operands[0] == IR_OPERAND_VALUE && record->operands[0] != IR_VALUE_NONE &&
+        alloc->positions[record->operands[0]] != IR_REGALLOC_NONE) {
+        interval->hintValue = record->operands[0];
+        interval->hintPosition = alloc->positions[value] + IR_REGALLOC_READ;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Every read of a constant or undefined value that needs a register gets an interval of its own */
+static ParserResult IRRegAllocBuildConstantUses(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+    IRFunction function = scan->function;
+
+    for (IRBlockId block = 1; block < alloc->blockCount; block++) {
+        const IRInstruction* record;
+        for (IRValueId id = scan->blockFirst[block]; id != IR_VALUE_NONE; id = record->next) {
+            record = IRFunction_GetInstruction(function, id);
+            if (record->opcode == IR_OP_CALL || record->opcode == IR_OP_RET)
+                continue;
+
+            const IROpcodeInfo* info = IROpcode_GetInfo((IROpcode)record->opcode);
+            for (uint32_t i = 0; i < 3; i++) {
+                IRValueId operand = record->operands[i];
+                if (info->operands[i] != IR_OPERAND_VALUE || operand == IR_VALUE_NONE ||
+                    alloc->positions[operand] != IR_REGALLOC_NONE)
+                    continue;
+
+                // Once per instruction
+                uint32_t j = 0;
+                while (j < i && (info->operands[j] != IR_OPERAND_VALUE || record->operands[j] != operand))
+                    j++;
+                if (j < i)
+                    continue;
+
+                uint32_t read = alloc->positions[id] + IR_REGALLOC_READ;
+                scan->tempRangeCount = 0;
+                scan->tempUseCount = 0;
+                CHECK_PARSER_RESULT(IRRegAllocAddRange(scan, alloc->positions[id], read + 1));
+                CHECK_PARSER_RESULT(IRRegAllocAddUse(scan, read, true, scan->weights[block]));
+
+                uint32_t index;
+                const IRInstruction* constant = IRFunction_GetInstruction(function, operand);
+                CHECK_PARSER_RESULT(IRRegAllocAddInterval(scan, operand, (IRType)constant->type,
+                    constant->opcode == IR_OP_CONST, &index));
+
+                CHECK_PARSER_RESULT(ParserArrayReserve((void**)&alloc->constantUses, &alloc->constantUseCapacity,
+                    alloc->constantUseCount, alloc->constantUseCount + 1, sizeof(IRRegAllocConstantUse), 64));
+                IRRegAllocConstantUse* use = &alloc->constantUses[alloc->constantUseCount++];
+                use->at = id;
+                use->value = operand;
+                use->interval = index;
+            }
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Lifetimes of all values, and the values live into every block */
+static ParserResult IRRegAllocBuildIntervals(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+
+    for (IRValueId id = 1; id < alloc->valueCount; id++) {
+        const IRInstruction* record = IRFunction_GetInstruction(scan->function, id);
+        if (alloc->positions[id] != IR_REGALLOC_NONE && record->type != IR_TYPE_VOID)
+            CHECK_PARSER_RESULT(IRRegAllocBuildValue(scan, id));
+    }
+
+    CHECK_PARSER_RESULT(IRRegAllocBuildConstantUses(scan));
+
+    // The uses end in one of no value, for the weights up to the last
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&alloc->uses, &alloc->useCapacity, alloc->useCount,
+        alloc->useCount + 1, sizeof(IRRegAllocUse), 64));
+    IRRegAllocUse* last = &alloc->uses[alloc->useCount];
+    memset(last, 0, sizeof(IRRegAllocUse));
+    last->position = IR_REGALLOC_NONE;
+    last->nextRegister = IR_REGALLOC_NONE;
+    last->before = alloc->useCount ? last[-1].before + last[-1].weight : 0;
+
+    // Sort the live values by block, they are in order of the value already
+    for (uint32_t i = 0; i < scan->liveInCount; i++)
+        scan->liveInStart[scan->liveIns[i].block + 1]++;
+    for (IRBlockId block = 1; block <= alloc->blockCount; block++)
+        scan->liveInStart[block] += scan->liveInStart[block - 1];
+
+    scan->liveInValues = PARSER_MALLOC(sizeof(IRValueId) * (scan->liveInCount + 1), 0);
+    if (!scan->liveInValues)
+        return PARSER_ERROR_NO_MEMORY;
+
+    for (uint32_t i = 0; i < scan->liveInCount; i++)
+        scan->liveInValues[scan->liveInStart[scan->liveIns[i].block]++] = scan->liveIns[i].value;
+    for (IRBlockId block = alloc->blockCount; block > 0; block--)
+        scan->liveInStart[block] = scan->liveInStart[block - 1];
+    scan->liveInStart[0] = 0;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* List the intervals of every value in order, and the registers they take */
+static ParserResult IRRegAllocCollect(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+
+    alloc->children = PARSER_MALLOC(sizeof(uint32_t) * (alloc->intervalCount + 1), 0);
+    if (!alloc->children)
+        return PARSER_ERROR_NO_MEMORY;
+
+    uint32_t count = 0;
+    for (IRValueId value = 0; value < alloc->valueCount; value++) {
+        alloc->childStart[value] = count;
+        if (value == IR_VALUE_NONE)
+            continue;
+
+        for (uint32_t index = alloc->firstInterval[value]; index != IR_REGALLOC_NONE; index = alloc->intervals[index].next)
+            alloc->children[count++] = index;
+    }
+
+    alloc->childStart[alloc->valueCount] = count;
+
+    for (uint32_t i = 0; i < alloc->intervalCount; i++) {
+        const IRRegAllocInterval* interval = &alloc->intervals[i];
+        if (interval->kind == IR_LOCATION_REGISTER)
+            alloc->usedRegisters |= IRRegAllocGroupMask(interval->reg, interval->count);
+    }
+
+    alloc->stats.intervals = alloc->intervalCount;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static uint32_t IRRegAllocSlotAlign(const IRRegAlloc alloc, uint32_t bytes)
+{
+    uint32_t align = bytes < alloc->config.registerBytes ? bytes : alloc->config.registerBytes;
+    while (align & (align - 1))
+        align &= align - 1;
+
+    return align;
+}
+
+static int IRRegAllocCompareLifetimes(const void* a, const void* b)
+{
+    const IRRegAllocLifetime* lifetimeA = (const IRRegAllocLifetime*)a;
+    const IRRegAllocLifetime* lifetimeB = (const IRRegAllocLifetime*)b;
+
+    if (lifetimeA->start != lifetimeB->start)
+        return lifetimeA->start < lifetimeB->start ? -1 : 1;
+
+    return lifetimeA->value < lifetimeB->value ? -1 : (lifetimeA->value > lifetimeB->value ? 1 : 0);
+}
+
+static int IRRegAllocCompareEnds(const void* a, const void* b)
+{
+    const IRRegAllocLifetimeEnd* endA = (const IRRegAllocLifetimeEnd*)a;
+    const IRRegAllocLifetimeEnd* endB = (const IRRegAllocLifetimeEnd*)b;
+
+    if (endA->end != endB->end)
+        return endA->end < endB->end ? -1 : 1;
+
+    return endA->lifetime < endB->lifetime ? -1 : (endA->lifetime > endB->lifetime ? 1 : 0);
+}
+
+/* Give every value with an interval on the stack a slot, shared by values whose lifetimes do not overlap */
+static ParserResult IRRegAllocAssignSlots(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+
+    uint32_t count = 0;
+    for (IRValueId value = 1; value < alloc->valueCount; value++) {
+        for (uint32_t i = alloc->childStart[value]; i < alloc->childStart[value + 1]; i++) {
+            if (alloc->intervals[alloc->children[i]].kind == IR_LOCATION_STACK) {
+                count++;
+                break;
+            }
+        }
+    }
+
+    if (!count)
+        return PARSER_RESULT_SUCCESS;
+
+    IRRegAllocLifetime* lifetimes = PARSER_MALLOC(sizeof(IRRegAllocLifetime) * count, 0);
+    IRRegAllocLifetimeEnd* ends = PARSER_MALLOC(sizeof(IRRegAllocLifetimeEnd) * count, 0);
+    IRRegAllocSlot* slots = PARSER_MALLOC(sizeof(IRRegAllocSlot) * count, 0);
+    if (!lifetimes || !ends || !slots) {
+        if (lifetimes)
+            PARSER_FREE(lifetimes);
+        if (ends)
+            PARSER_FREE(ends);
+        if (slots)
+            PARSER_FREE(slots);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    count = 0;
+    for (IRValueId value = 1; value < alloc->valueCount; value++) {
+        uint32_t first = alloc->childStart[value];
+        uint32_t last = alloc->childStart[value + 1];
+        for (uint32_t i = first; i < last; i++) {
+            if (alloc->intervals[alloc->children[i]].kind == IR_LOCATION_STACK) {
+                lifetimes[count].start = alloc->intervals[alloc->children[first]].start;
+                lifetimes[count].end = alloc->intervals[alloc->children[last - 1]].end;
+                lifetimes[count++].value = value;
+                break;
+            }
+        }
+    }
+
+    qsort(lifetimes, count, sizeof(IRRegAllocLifetime), IRRegAllocCompareLifetimes);
+    for (uint32_t i = 0; i < count; i++) {
+        ends[i].end = lifetimes[i].end;
+        ends[i].lifetime = i;
+    }
+
+    qsort(ends, count, sizeof(IRRegAllocLifetimeEnd), IRRegAllocCompareEnds);
+
+    // The slot of a lifetime that ended is free again for a value of its size
+    uint32_t released[UINT8_MAX + 1];
+    for (uint32_t i = 0; i <= UINT8_MAX; i++)
+        released[i] = IR_REGALLOC_NONE;
+
+    uint32_t slotCount = 0;
+    uint32_t ended = 0;
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        IRRegAllocLifetime* lifetime = &lifetimes[i];
+        uint32_t bytes = alloc->intervals[alloc->firstInterval[lifetime->value]].bytes;
+
+        for (; ended < count && ends[ended].end <= lifetime->start; ended++) {
+            IRRegAllocSlot* slot = &slots[lifetimes[ends[ended].lifetime].slot];
+            slot->next = released[slot->bytes];
+            released[slot->bytes] = lifetimes[ends[ended].lifetime].slot;
+        }
+
+        lifetime->slot = released[bytes];
+        if (lifetime->slot != IR_REGALLOC_NONE) {
+            released[bytes] = slots[lifetime->slot].next;
+        } else {
+            IRRegAllocSlot* slot = &slots[slotCount];
+            uint32_t align = IRRegAllocSlotAlign(alloc, bytes);
+            slot->offset = (size + align - 1) & ~(align - 1);
+            slot->bytes = bytes;
+            size = slot->offset + bytes;
+            lifetime->slot = slotCount++;
+        }
+
+        alloc->slots[lifetime->value] = slots[lifetime->slot].offset;
+    }
+
+    alloc->spillSize = size;
+    alloc->stats.spilledValues = count;
+
+    PARSER_FREE(lifetimes);
+    PARSER_FREE(ends);
+    PARSER_FREE(slots);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static inline bool IRRegAllocSameLocation(const IRLocation* a, const IRLocation* b)
+{
+    return a->kind == b->kind && a->index == b->index;
+}
+
+static ParserResult IRRegAllocAddMove(IRRegAllocScan* scan, IRValueId before, uint32_t phase, IRValueId value,
+    IRLocation from, IRLocation to)
+{
+    if (from.kind == IR_LOCATION_NONE || (to.kind != IR_LOCATION_REGISTER && to.kind != IR_LOCATION_STACK) ||
+        IRRegAllocSameLocation(&from, &to))
+        return PARSER_RESULT_SUCCESS;
+
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->pending, &scan->pendingCapacity, scan->pendingCount,
+        scan->pendingCount + 1, sizeof(IRRegAllocPendingMove), 64));
+
+    IRRegAllocPendingMove* pending = &scan->pending[scan->pendingCount];
+    pending->before = before;
+    pending->phase = phase;
+    pending->order = scan->pendingCount++;
+    pending->move.value = value;
+    pending->move.from = from;
+    pending->move.to = to;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Location of a value at `position`, a constant recomputed */
+static IRLocation IRRegAllocSource(const IRRegAlloc alloc, IRValueId value, uint32_t position)
+{
+    if (alloc->positions[value] != IR_REGALLOC_NONE)
+        return IRRegAllocLocation(alloc, IRRegAllocLocate(alloc, value, position));
+
+    IRLocation location = { IR_LOCATION_NONE, 0, 0 };
+    if (alloc->valueFlags[value] & IR_REGALLOC_VALUE_CONSTANT)
+        location.kind = IR_LOCATION_CONSTANT;
+
+    return location;
+}
+
+/* Moves along the edge from predecessor `index` of a block, for its phis and the values live into it */
+static ParserResult IRRegAllocResolveEdge(IRRegAllocScan* scan, IRBlockId block, uint32_t index, IRValueId before,
+    uint32_t phase)
+{
+    IRRegAlloc alloc = scan->alloc;
+    IRFunction function = scan->function;
+
+    uint32_t predCount;
+    IRBlockId pred = IRFunction_GetPredecessors(function, block, &predCount)[index];
+    uint32_t from = alloc->blockStart[pred + 1] - 1;
+    uint32_t to = alloc->blockStart[block];
+
+    const IRInstruction* record;
+    for (IRValueId phi = IRFunction_GetBlock(function, block)->first; phi != scan->blockFirst[block]; phi = record->next) {
+        record = IRFunction_GetInstruction(function, phi);
+        if (alloc->firstInterval[phi] == IR_REGALLOC_NONE)
+            continue;
+
+        uint32_t operandCount;
+        IRValueId operand = IRFunction_GetList(function, phi, &operandCount)[index];
+        CHECK_PARSER_RESULT(IRRegAllocAddMove(scan, before, phase, operand, IRRegAllocSource(alloc, operand, from),
+            IRRegAllocLocation(alloc, IRRegAllocLocate(alloc, phi, to))));
+    }
+
+    for (uint32_t i = scan->liveInStart[block]; i < scan->liveInStart[block + 1]; i++) {
+        IRValueId value = scan->liveInValues[i];
+        CHECK_PARSER_RESULT(IRRegAllocAddMove(scan, before, phase, value, IRRegAllocSource(alloc, value, from),
+            IRRegAllocSource(alloc, value, to)));
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Gather the moves between intervals, into the registers of constants and along the edges */
+static ParserResult IRRegAllocResolve(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+    IRFunction function = scan->function;
+
+    // An interval that takes over inside a block, at a block start the edges see to it
+    for (IRValueId value = 1; value < alloc->valueCount; value++) {
+        for (uint32_t i = alloc->childStart[value] + 1; i < alloc->childStart[value + 1]; i++) {
+            const IRRegAllocInterval* prev = &alloc->intervals[alloc->children[i - 1]];
+            const IRRegAllocInterval* next = &alloc->intervals[alloc->children[i]];
+            IRBlockId block = IRRegAllocBlockAt(alloc, next->start);
+            if (prev->end != next->start || alloc->blockStart[block] == next->start)
+                continue;
+
+            IRValueId before = scan->blockFirst[block] + (next->start - alloc->blockStart[block]) / IR_REGALLOC_STEP - 1;
+            uint32_t phase = next->start == IRRegAllocFloor(next->start) ? IR_REGALLOC_PHASE_SPLIT : IR_REGALLOC_PHASE_SPILL;
+            CHECK_PARSER_RESULT(IRRegAllocAddMove(scan, before, phase, value,
+                IRRegAllocLocation(alloc, alloc->children[i - 1]), IRRegAllocLocation(alloc, alloc->children[i])));
+        }
+    }
+
+    for (uint32_t i = 0; i < alloc->constantUseCount; i++) {
+        const IRRegAllocConstantUse* use = &alloc->constantUses[i];
+        CHECK_PARSER_RESULT(IRRegAllocAddMove(scan, use->at, IR_REGALLOC_PHASE_SPLIT, use->value,
+            IRRegAllocSource(alloc, use->value, 0), IRRegAllocLocation(alloc, use->interval)));
+    }
+
+    for (IRBlockId block = 1; block < alloc->blockCount; block++) {
+        uint32_t predCount;
+        const IRBlockId* preds = IRFunction_GetPredecessors(function, block, &predCount);
+        for (uint32_t i = 0; i < predCount; i++) {
+            if (IRFunction_GetSuccessorCount(function, preds[i]) == 1) {
+                CHECK_PARSER_RESULT(IRRegAllocResolveEdge(scan, block, i, IRFunction_GetBlock(function, preds[i])->last,
+                    IR_REGALLOC_PHASE_EXIT));
+                continue;
+            }
+
+            if (i == 0) {
+                CHECK_PARSER_RESULT(IRRegAllocResolveEdge(scan, block, 0, scan->blockFirst[block],
+                    IR_REGALLOC_PHASE_ENTRY));
+                continue;
+            }
+
+            // The edges split off leave only more edges from that one block, whose moves were made for the first
+            if (preds[i] != preds[0])
+                return PARSER_ERROR_UNSUPPORTED;
+
+            const IRInstruction* record;
+            for (IRValueId phi = IRFunction_GetBlock(function, block)->first; phi != scan->blockFirst[block];
+                phi = record->next) {
+                record = IRFunction_GetInstruction(function, phi);
+
+                uint32_t operandCount;
+                const uint32_t* operands = IRFunction_GetList(function, phi, &operandCount);
+                if (operands[i] != operands[0])
+                    return PARSER_ERROR_UNSUPPORTED;
+            }
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static int IRRegAllocCompareMoves(const void* a, const void* b)
+{
+    const IRRegAllocPendingMove* moveA = (const IRRegAllocPendingMove*)a;
+    const IRRegAllocPendingMove* moveB = (const IRRegAllocPendingMove*)b;
+
+    if (moveA->before != moveB->before)
+        return moveA->before < moveB->before ? -1 : 1;
+    if (moveA->phase != moveB->phase)
+        return moveA->phase < moveB->phase ? -1 : 1;
+
+    return moveA->order < moveB->order ? -1 : (moveA->order > moveB->order ? 1 : 0);
+}
+
+static bool IRRegAllocOverlap(const IRLocation* a, const IRLocation* b)
+{
+    if (a->kind != b->kind || (a->kind != IR_LOCATION_REGISTER && a->kind != IR_LOCATION_STACK))
+        return false;
+
+    return a->index < b->index + b->count && b->index < a->index + a->count;
+}
+
+/* Check whether a move other than `skip` reads from a location, or writes to it */
+static bool IRRegAllocTouches(const IRMove* moves, uint32_t count, uint32_t skip, const IRLocation* location,
+    bool reads)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        if (i != skip && IRRegAllocOverlap(reads ? &moves[i].from : &moves[i].to, location))
+            return true;
+    }
+
+    return false;
+}
+
+static ParserResult IRRegAllocEmit(IRRegAllocScan* scan, IRValueId before, const IRMove* move)
+{
+    IRRegAlloc alloc = scan->alloc;
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&alloc->moves, &alloc->moveCapacity, alloc->moveCount,
+        alloc->moveCount + 1, sizeof(IRMove), 64));
+
+    alloc->moves[alloc->moveCount++] = *move;
+    alloc->moveStart[before + 1]++;
+    if (move->from.kind == IR_LOCATION_CONSTANT)
+        alloc->stats.rematerialized++;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/*
+ * Order each parallel copy: a move goes once no other one still reads
+ * where it writes. Moves left over form cycles, one of which is broken by
+ * parking a source of the cycle in the room for swaps after the stack
+ * slots; a parked copy is never written, so that ends.
+ */
+static ParserResult IRRegAllocSequentialize(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+    uint32_t registerBytes = alloc->config.registerBytes;
+    uint32_t swapBase = (alloc->spillSize + registerBytes - 1) / registerBytes * registerBytes;
+    uint32_t swapSize = 0;
+
+    if (scan->pendingCount)
+        qsort(scan->pending, scan->pendingCount, sizeof(IRRegAllocPendingMove), IRRegAllocCompareMoves);
+
+    for (uint32_t first = 0, last; first < scan->pendingCount; first = last) {
+        IRValueId before = scan->pending[first].before;
+        last = first;
+        while (last < scan->pendingCount && scan->pending[last].before == before &&
+            scan->pending[last].phase == scan->pending[first].phase)
+            last++;
+
+        CHECK_PARSER_RESULT(ParserArrayReserve((void**)&scan->parallel, &scan->parallelCapacity, last - first,
+            last - first + 1, sizeof(IRMove), 64));
+
+        IRMove* moves = scan->parallel;
+        uint32_t count = 0;
+        for (uint32_t i = first; i < last; i++)
+            moves[count++] = scan->pending[i].move;
+
+        uint32_t swapUsed = 0;
+        while (count) {
+            bool progress = false;
+            for (uint32_t i = 0; i < count;) {
+                if (IRRegAllocTouches(moves, count, i, &moves[i].to, true)) {
+                    i++;
+                    continue;
+                }
+
+                CHECK_PARSER_RESULT(IRRegAllocEmit(scan, before, &moves[i]));
+                memmove(&moves[i], &moves[i + 1], sizeof(IRMove) * (count - i - 1));
+                count--;
+                progress = true;
+            }
+
+            if (progress)
+                continue;
+
+            // Every move waits for another: park a source another one writes, the moves from it read the copy
+            uint32_t blocking = 0;
+            while (!IRRegAllocTouches(moves, count, blocking, &moves[blocking].from, false))
+                blocking++;
+
+            IRLocation source = moves[blocking].from;
+            IRMove park = moves[blocking];
+            park.to.kind = IR_LOCATION_STACK;
+            park.to.count = source.kind == IR_LOCATION_REGISTER ? source.count * registerBytes : source.count;
+            park.to.index = swapBase + swapUsed;
+            swapUsed += (park.to.count + registerBytes - 1) / registerBytes * registerBytes;
+            CHECK_PARSER_RESULT(IRRegAllocEmit(scan, before, &park));
+
+            for (uint32_t i = 0; i < count; i++) {
+                if (IRRegAllocSameLocation(&moves[i].from, &source))
+                    moves[i].from = park.to;
+            }
+        }
+
+        swapSize = swapSize > swapUsed ? swapSize : swapUsed;
+    }
+
+    if (swapSize)
+        alloc->spillSize = swapBase + swapSize;
+
+    for (IRValueId id = 1; id <= alloc->valueCount; id++)
+        alloc->moveStart[id] += alloc->moveStart[id - 1];
+
+    alloc->stats.moves = alloc->moveCount;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRRegAllocRun(IRRegAllocScan* scan)
+{
+    IRRegAlloc alloc = scan->alloc;
+    uint32_t blockCount = alloc->blockCount;
+
+    // blockFirst, weights, inStamps, outStamps, stack, liveInStart, loopEnds
+    size_t wordCount = (size_t)blockCount * 7 + 1;
+    scan->words = PARSER_MALLOC(sizeof(uint32_t) * wordCount, 0);
+    scan->calls = PARSER_MALLOC(sizeof(uint32_t) * alloc->valueCount, 0);
+    if (!scan->words || !scan->calls)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(scan->words, 0, sizeof(uint32_t) * wordCount);
+    scan->blockFirst = scan->words;
+    scan->weights = scan->blockFirst + blockCount;
+    scan->inStamps = scan->weights + blockCount;
+    scan->outStamps = scan->inStamps + blockCount;
+    scan->stack = scan->outStamps + blockCount;
+    scan->liveInStart = scan->stack + blockCount;
+    scan->loopEnds = scan->liveInStart + blockCount + 1;
+
+    IRRegAllocNumber(scan);
+    CHECK_PARSER_RESULT(IRRegAllocBuildIntervals(scan));
+    CHECK_PARSER_RESULT(IRRegAllocScanIntervals(scan));
+    CHECK_PARSER_RESULT(IRRegAllocCollect(scan));
+    CHECK_PARSER_RESULT(IRRegAllocAssignSlots(scan));
+    CHECK_PARSER_RESULT(IRRegAllocResolve(scan));
+
+    return IRRegAllocSequentialize(scan);
+}
+
+static void IRRegAllocRelease(IRRegAllocScan* scan)
+{
+    void* buffers[] = {
+        scan->words, scan->liveInValues, scan->liveIns, scan->tempRanges, scan->tempUses, scan->calls,
+        scan->heap, scan->active, scan->inactive, scan->candidates, scan->walk, scan->pending, scan->parallel,
+    };
+
+    for (uint32_t i = 0; i < sizeof(buffers) / sizeof(buffers[0]); i++) {
+        if (buffers[i])
+            PARSER_FREE(buffers[i]);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateIRRegAlloc(
+    IRFunction function,
+    const IRRegAllocConfig* config,
+    IRRegAlloc* alloc)
+{
+    if (!function || !alloc)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRRegAllocConfig settings = {
+        IR_REGALLOC_DEFAULT_REGISTERS, IR_REGALLOC_DEFAULT_REGISTER_BYTES, 0, IR_REGALLOC_DEFAULT_CALLER_SAVED, 0
+    };
+    if (config) {
+        settings = *config;
+        if (!settings.registerCount)
+            settings.registerCount = IR_REGALLOC_DEFAULT_REGISTERS;
+        if (!settings.registerBytes)
+            settings.registerBytes = IR_REGALLOC_DEFAULT_REGISTER_BYTES;
+    }
+
+    if (!settings.pointerBytes)
+        settings.pointerBytes = settings.registerBytes;
+
+    uint64_t registers = IRRegAllocGroupMask(0, settings.registerCount);
+    if (settings.registerCount > IR_REGALLOC_MAX_REGISTERS || !(registers & ~settings.reservedMask))
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(IRRegAllocSplitEdges(function));
+    if (!IRFunction_IsCompact(function))
+        CHECK_PARSER_RESULT(IRFunction_Compact(function));
+
+    IRDomTree domTree;
+    IRLoopTree loops;
+    CHECK_PARSER_RESULT(CreateIRDomTree(function, &domTree));
+    ParserResult result = CreateIRLoopTree(function, domTree, &loops);
+    IRDomTreeDestroy(domTree);
+    if (result != PARSER_RESULT_SUCCESS)
+        return result;
+
+    IRRegAlloc created = PARSER_MALLOC(sizeof(struct IRRegAlloc_T), 0);
+    if (!created) {
+        IRLoopTreeDestroy(loops);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memset(created, 0, sizeof(struct IRRegAlloc_T));
+    created->config = settings;
+    created->config.callerSavedMask &= registers;
+    created->config.reservedMask &= registers;
+    created->allocatable = registers & ~settings.reservedMask;
+    created->blockCount = IRFunction_GetBlockCount(function);
+    created->valueCount = IRFunction_GetInstructionCount(function);
+
+    // blockStart, positions, firstInterval, slots, childStart, moveStart
+    size_t wordCount = (size_t)created->blockCount + 1 + (size_t)created->valueCount * 5 + 2;
+    created->words = PARSER_MALLOC(sizeof(uint32_t) * wordCount, 0);
+    created->valueFlags = PARSER_MALLOC(created->valueCount, 0);
+    if (!created->words || !created->valueFlags) {
+        IRLoopTreeDestroy(loops);
+        IRRegAllocDestroy(created);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memset(created->words, 0, sizeof(uint32_t) * wordCount);
+    memset(created->valueFlags, 0, created->valueCount);
+    created->blockStart = created->words;
+    created->positions = created->blockStart + created->blockCount + 1;
+    created->firstInterval = created->positions + created->valueCount;
+    created->slots = created->firstInterval + created->valueCount;
+    created->childStart = created->slots + created->valueCount;
+    created->moveStart = created->childStart + created->valueCount + 1;
+
+    IRRegAllocScan scan;
+    memset(&scan, 0, sizeof(IRRegAllocScan));
+    scan.alloc = created;
+    scan.function = function;
+    scan.loops = loops;
+
+    result = IRRegAllocRun(&scan);
+    IRRegAllocRelease(&scan);
+    IRLoopTreeDestroy(loops);
+    if (result != PARSER_RESULT_SUCCESS) {
+        IRRegAllocDestroy(created);
+        return result;
+    }
+
+    *alloc = created;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL IRRegAllocDestroy(
+    IRRegAlloc alloc)
+{
+    if (!alloc)
+        return;
+
+    void* buffers[] = {
+        alloc->words, alloc->valueFlags, alloc->ranges, alloc->uses, alloc->intervals, alloc->constantUses,
+        alloc->children, alloc->moves,
+    };
+
+    for (uint32_t i = 0; i < sizeof(buffers) / sizeof(buffers[0]); i++) {
+        if (buffers[i])
+            PARSER_FREE(buffers[i]);
+    }
+
+    PARSER_FREE(alloc);
+}
+
+PARSER_ATTR void PARSER_CALL IRRegAlloc_GetLocation(
+    const IRRegAlloc alloc,
+    IRValueId value,
+    IRValueId at,
+    IRLocation* location)
+{
+    if (!location)
+        return;
+
+    memset(location, 0, sizeof(IRLocation));
+    if (!alloc || value == IR_VALUE_NONE || value >= alloc->valueCount || at == IR_VALUE_NONE ||
+        at >= alloc->valueCount || alloc->positions[at] == IR_REGALLOC_NONE)
+        return;
+
+    // Phi operands come with the moves of the edges
+    bool phi = alloc->valueFlags[at] & IR_REGALLOC_VALUE_PHI;
+    if (phi && value != at)
+        return;
+
+    if (alloc->positions[value] == IR_REGALLOC_NONE) {
+        uint32_t low = 0;
+        uint32_t high = alloc->constantUseCount;
+        while (low < high) {
+            uint32_t middle = low + (high - low) / 2;
+            if (alloc->constantUses[middle].at < at)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        for (; low < alloc->constantUseCount && alloc->constantUses[low].at == at; low++) {
+            if (alloc->constantUses[low].value == value) {
+                *location = IRRegAllocLocation(alloc, alloc->constantUses[low].interval);
+                return;
+            }
+        }
+
+        *location = IRRegAllocSource(alloc, value, 0);
+        return;
+    }
+
+    uint32_t position = alloc->positions[at];
+    if (value != at)
+        position += IR_REGALLOC_READ;
+    else if (!phi)
+        position += IR_REGALLOC_WRITE;
+
+    // In a hole of its lifetime the register of a value may hold another one
+    uint32_t index = IRRegAllocLocate(alloc, value, position);
+    if (index != IR_REGALLOC_NONE) {
+        const IRRegAllocInterval* interval = &alloc->intervals[index];
+        uint32_t range = IRRegAllocFirstRange(alloc, interval, position);
+        if (range == interval->rangeEnd || alloc->ranges[range].from > position)
+            return;
+    }
+
+    *location = IRRegAllocLocation(alloc, index);
+}
+
+PARSER_ATTR const IRMove* PARSER_CALL IRRegAlloc_GetMoves(
+    const IRRegAlloc alloc,
+    IRValueId before,
+    uint32_t* count)
+{
+    if (count)
+        *count = 0;
+    if (!alloc || before == IR_VALUE_NONE || before >= alloc->valueCount)
+        return NULL;
+
+    uint32_t first = alloc->moveStart[before];
+    uint32_t moveCount = alloc->moveStart[before + 1] - first;
+    if (count)
+        *count = moveCount;
+
+    return moveCount ? &alloc->moves[first] : NULL;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL IRRegAlloc_GetSpillSize(
+    const IRRegAlloc alloc)
+{
+    return alloc ? alloc->spillSize : 0;
+}
+
+PARSER_ATTR uint64_t PARSER_CALL IRRegAlloc_GetUsedRegisters(
+    const IRRegAlloc alloc)
+{
+    return alloc ? alloc->usedRegisters : 0;
+}
+
+PARSER_ATTR void PARSER_CALL IRRegAlloc_GetStats(
+    const IRRegAlloc alloc,
+    IRRegAllocStats* stats)
+{
+    if (!stats)
+        return;
+
+    if (!alloc) {
+        memset(stats, 0, sizeof(IRRegAllocStats));
+        return;
+    }
+
+    *stats = alloc->stats;
+}
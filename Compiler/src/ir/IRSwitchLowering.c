@@ -0,0 +1,700 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRPasses.h"
+#include "IRInternal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/*
+ * What the code of a cluster costs on a 16-bit instruction set such as
+ * Thumb: bytes, and cycles on the way through it to a target.
+ */
+#define IR_SWITCH_NODE_SIZE             4u      // Compare and branch, a search tree node or a single value
+#define IR_SWITCH_NODE_CYCLES           2u
+#define IR_SWITCH_RANGE_SIZE            6u      // Subtract, compare and branch
+#define IR_SWITCH_RANGE_CYCLES          3u
+#define IR_SWITCH_TABLE_SIZE            12u     // Subtract, bounds check, load of the entry and indirect jump
+#define IR_SWITCH_TABLE_CYCLES          7u
+#define IR_SWITCH_BITS_SIZE             10u     // Subtract, bounds check and shift of a one
+#define IR_SWITCH_BITS_CYCLES           5u
+#define IR_SWITCH_BIT_TEST_SIZE         8u      // Per target: mask, test and branch, the mask a literal
+#define IR_SWITCH_BIT_TEST_CYCLES       3u
+
+#define IR_SWITCH_MAX_BIT_TESTS         3u      // Targets of one bit test cluster
+#define IR_SWITCH_MAX_TABLE_ENTRIES     4096u
+#define IR_SWITCH_MAX_FORWARDS          8u      // Empty blocks looked through to the target of a case
+
+typedef enum IRSwitchClusterKind {
+    IR_SWITCH_CLUSTER_RANGE,            // One range of values with one target
+    IR_SWITCH_CLUSTER_TABLE,            // Bounds-checked jump table
+    IR_SWITCH_CLUSTER_BITS,             // Bit tests of a one shifted by the value
+} IRSwitchClusterKind;
+
+/* Values low to high going to one target, `index` of the first case in the switch */
+typedef struct IRSwitchRange_T {
+    int64_t low;
+    int64_t high;
+    IRBlockId target;
+    uint32_t index;
+} IRSwitchRange;
+
+/* Cheapest way to lower the ranges from one on: a cluster up to `end`, then the best from there */
+typedef struct IRSwitchChoice_T {
+    uint64_t cost;
+    uint32_t end;
+    uint32_t kind;                      // IRSwitchClusterKind
+} IRSwitchChoice;
+
+typedef struct IRSwitchCluster_T {
+    uint32_t kind;                      // IRSwitchClusterKind
+    uint32_t first;                     // Ranges
+    uint32_t last;
+} IRSwitchCluster;
+
+/* Search tree node still to emit: clusters first to last, reached with values low to high */
+typedef struct IRSwitchNode_T {
+    IRBlockId block;
+    uint32_t first;
+    uint32_t last;
+    int64_t low;
+    int64_t high;
+} IRSwitchNode;
+
+/* Operand a phi had for the edge from the switch */
+typedef struct IRSwitchIncoming_T {
+    IRValueId phi;
+    IRValueId value;
+} IRSwitchIncoming;
+
+typedef struct IRSwitchLowering_T {
+    IRFunction function;
+    IRSwitchConfig config;
+
+    // Per block of the function before lowering
+    uint32_t blockCount;
+    IRBlockId* stamps;                  // Switch block the incoming operands were recorded for
+    uint32_t* incomingFirst;
+    uint32_t* incomingCounts;
+
+    IRSwitchIncoming* incoming;         // One per phi of the function at most
+    uint32_t incomingCount;
+
+    // The switch being lowered
+    IRValueId value;
+    IRType type;
+    uint32_t width;
+    uint64_t mask;
+    IRBlockId defaultBlock;
+
+    IRSwitchRange* ranges;
+    uint32_t rangeCount;
+    IRSwitchChoice* choices;
+    IRSwitchCluster* clusters;
+    uint32_t clusterCount;
+    IRSwitchNode* nodes;
+} IRSwitchLowering;
+
+static int IRSwitchCompareRanges(const void* a, const void* b)
+{
+    const IRSwitchRange* rangeA = (const IRSwitchRange*)a;
+    const IRSwitchRange* rangeB = (const IRSwitchRange*)b;
+
+    if (rangeA->low != rangeB->low)
+        return rangeA->low < rangeB->low ? -1 : 1;
+
+    // The first case of a value wins, as the switch itself takes it
+    return rangeA->index < rangeB->index ? -1 : (rangeA->index > rangeB->index ? 1 : 0);
+}
+
+static inline uint64_t IRSwitchWeigh(const IRSwitchLowering* lowering, uint64_t size, uint64_t cycles)
+{
+    return size * lowering->config.sizeWeight + cycles * lowering->config.cyclesWeight;
+}
+
+static inline int64_t IRSwitchSigned(const IRSwitchLowering* lowering, uint64_t bits)
+{
+    bits &= lowering->mask;
+    if (lowering->width < 64 && (bits >> (lowering->width - 1)))
+        bits |= ~lowering->mask;
+
+    return (int64_t)bits;
+}
+
+/* An empty block that only branches on stands for its target, when that has no phis */
+static IRBlockId IRSwitchForward(const IRSwitchLowering* lowering, IRBlockId block)
+{
+    IRFunction function = lowering->function;
+
+    for (uint32_t i = 0; i < IR_SWITCH_MAX_FORWARDS; i++) {
+        const IRBlock* record = IRFunction_GetBlock(function, block);
+        const IRInstruction* branch = IRFunction_GetInstruction(function, record->first);
+        if (!branch || record->first != record->last || branch->opcode != IR_OP_BR || branch->operands[0] == block)
+            break;
+
+        const IRInstruction* first = IRFunction_GetInstruction(function, IRFunction_GetBlock(function, branch->operands[0])->first);
+        if (first && first->opcode == IR_OP_PHI)
+            break;
+
+        block = branch->operands[0];
+    }
+
+    return block;
+}
+
+/* Case values in signed order, duplicates and cases of the default dropped, neighbours to one target merged */
+static void IRSwitchGatherRanges(IRSwitchLowering* lowering, const uint32_t* items, uint32_t count)
+{
+    uint32_t rangeCount = 0;
+    for (uint32_t i = 0; i + 2 < count; i += 3) {
+        IRSwitchRange* range = &lowering->ranges[rangeCount++];
+        range->low = IRSwitchSigned(lowering, ((uint64_t)items[i + 1] << 32) | items[i]);
+        range->high = range->low;
+        range->target = IRSwitchForward(lowering, items[i + 2]);
+        range->index = i / 3;
+    }
+
+    qsort(lowering->ranges, rangeCount, sizeof(IRSwitchRange), IRSwitchCompareRanges);
+
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < rangeCount; i++) {
+        IRSwitchRange range = lowering->ranges[i];
+        bool duplicate = i && range.low == lowering->ranges[i - 1].low;
+        if (duplicate || range.target == lowering->defaultBlock)
+            continue;
+
+        IRSwitchRange* last = kept ? &lowering->ranges[kept - 1] : NULL;
+        if (last && last->target == range.target && last->high + 1 == range.low)
+            last->high = range.low;
+        else
+            lowering->ranges[kept++] = range;
+    }
+
+    lowering->rangeCount = kept;
+}
+
+/*
+ * Dynamic programming over the sorted ranges, after "Correction to
+ * 'Producing Good Code for the Case Statement'" (Kannan and Proebsting,
+ * 1994): the cheapest clustering of the ranges from i on is a cluster
+ * starting at i followed by the cheapest clustering after it. A cluster
+ * stops growing once it spans more than a table or a mask can hold, so
+ * sparse switches stay close to linear.
+ */
+static void IRSwitchChooseClusters(IRSwitchLowering* lowering)
+{
+    const IRSwitchRange* ranges = lowering->ranges;
+    uint32_t count = lowering->rangeCount;
+    uint64_t tableLimit = IR_SWITCH_MAX_TABLE_ENTRIES;
+    uint64_t maskLimit = lowering->config.maskWidth < 64 ? lowering->config.maskWidth : 64;
+
+    lowering->choices[count].cost = 0;
+    for (uint32_t i = count; i-- > 0;) {
+        IRSwitchChoice* choice = &lowering->choices[i];
+        bool single = ranges[i].low == ranges[i].high;
+        choice->cost = IRSwitchWeigh(lowering, (single ? IR_SWITCH_NODE_SIZE : IR_SWITCH_RANGE_SIZE) + IR_SWITCH_NODE_SIZE,
+            (single ? IR_SWITCH_NODE_CYCLES : IR_SWITCH_RANGE_CYCLES) + IR_SWITCH_NODE_CYCLES) + lowering->choices[i + 1].cost;
+        choice->end = i;
+        choice->kind = IR_SWITCH_CLUSTER_RANGE;
+
+        IRBlockId targets[IR_SWITCH_MAX_BIT_TESTS + 1];
+        uint32_t targetCount = 0;
+        for (uint32_t j = i; j < count; j++) {
+            uint64_t span = (uint64_t)ranges[j].high - (uint64_t)ranges[i].low;
+            if (span >= tableLimit && span >= maskLimit)
+                break;
+
+            bool seen = false;
+            for (uint32_t k = 0; k < targetCount; k++)
+                seen |= targets[k] == ranges[j].target;
+            if (!seen && targetCount <= IR_SWITCH_MAX_BIT_TESTS)
+                targets[targetCount++] = ranges[j].target;
+
+            // A single range is never cheaper as a table or a mask
+            if (j == i)
+                continue;
+
+            uint64_t rest = lowering->choices[j + 1].cost;
+            if (span < tableLimit) {
+                uint64_t cost = IRSwitchWeigh(lowering, IR_SWITCH_TABLE_SIZE + IR_SWITCH_NODE_SIZE +
+                    (span + 1) * lowering->config.entrySize, IR_SWITCH_TABLE_CYCLES + IR_SWITCH_NODE_CYCLES) + rest;
+                if (cost < choice->cost) {
+                    choice->cost = cost;
+                    choice->end = j;
+                    choice->kind = IR_SWITCH_CLUSTER_TABLE;
+                }
+            }
+
+            if (span < maskLimit && targetCount <= IR_SWITCH_MAX_BIT_TESTS) {
+                uint64_t cost = IRSwitchWeigh(lowering, IR_SWITCH_BITS_SIZE + IR_SWITCH_NODE_SIZE +
+                    targetCount * IR_SWITCH_BIT_TEST_SIZE, IR_SWITCH_BITS_CYCLES + IR_SWITCH_NODE_CYCLES +
+                    targetCount * IR_SWITCH_BIT_TEST_CYCLES) + rest;
+                if (cost < choice->cost) {
+                    choice->cost = cost;
+                    choice->end = j;
+                    choice->kind = IR_SWITCH_CLUSTER_BITS;
+                }
+            }
+        }
+    }
+
+    lowering->clusterCount = 0;
+    for (uint32_t i = 0; i < count; i = lowering->choices[i].end + 1) {
+        IRSwitchCluster* cluster = &lowering->clusters[lowering->clusterCount++];
+        cluster->kind = lowering->choices[i].kind;
+        cluster->first = i;
+        cluster->last = lowering->choices[i].end;
+    }
+}
+
+/* Remember the phi operands of the edges from the switch, before it goes */
+static void IRSwitchRecordIncoming(IRSwitchLowering* lowering, IRBlockId block)
+{
+    IRFunction function = lowering->function;
+
+    lowering->incomingCount = 0;
+
+    uint32_t successorCount = IRFunction_GetSuccessorCount(function, block);
+    for (uint32_t i = 0; i < successorCount; i++) {
+        IRBlockId target = IRFunction_GetSuccessor(function, block, i);
+        if (lowering->stamps[target] == block)
+            continue;
+
+        lowering->stamps[target] = block;
+        lowering->incomingFirst[target] = lowering->incomingCount;
+        lowering->incomingCounts[target] = 0;
+
+        uint32_t predCount;
+        const IRBlockId* preds = IRFunction_GetPredecessors(function, target, &predCount);
+        uint32_t index = 0;
+        while (preds[index] != block)
+            index++;
+
+        for (IRValueId phi = IRFunction_GetBlock(function, target)->first; phi != IR_VALUE_NONE;
+             phi = IRFunction_GetInstruction(function, phi)->next) {
+            if (IRFunction_GetInstruction(function, phi)->opcode != IR_OP_PHI)
+                break;
+
+            uint32_t operandCount;
+            const uint32_t* operands = IRFunction_GetList(function, phi, &operandCount);
+
+            IRSwitchIncoming* incoming = &lowering->incoming[lowering->incomingCount++];
+            incoming->phi = phi;
+            incoming->value = operands[index];
+            lowering->incomingCounts[target]++;
+        }
+    }
+}
+
+/* Give the phis of the targets of a new terminator their operands for its edges */
+static ParserResult IRSwitchAddIncoming(IRSwitchLowering* lowering, IRBlockId block, IRBlockId switchBlock)
+{
+    IRFunction function = lowering->function;
+
+    uint32_t successorCount = IRFunction_GetSuccessorCount(function, block);
+    for (uint32_t i = 0; i < successorCount; i++) {
+        IRBlockId target = IRFunction_GetSuccessor(function, block, i);
+        if (target >= lowering->blockCount || lowering->stamps[target] != switchBlock)
+            continue;
+
+        const IRSwitchIncoming* incoming = &lowering->incoming[lowering->incomingFirst[target]];
+        for (uint32_t j = 0; j < lowering->incomingCounts[target]; j++)
+            CHECK_PARSER_RESULT(IRFunction_AppendOperand(function, incoming[j].phi, incoming[j].value));
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRSwitchTerminate(IRSwitchLowering* lowering, IRBlockId block, IRBlockId switchBlock,
+    IROpcode opcode, uint32_t a, uint32_t b, uint32_t c)
+{
+    CHECK_PARSER_RESULT(IRFunction_AddInstruction(lowering->function, block, opcode, IR_TYPE_VOID, a, b, c, NULL));
+
+    return IRSwitchAddIncoming(lowering, block, switchBlock);
+}
+
+static ParserResult IRSwitchEmit(IRSwitchLowering* lowering, IRBlockId block, IROpcode opcode, IRType type,
+    IRValueId a, IRValueId b, IRValueId* value)
+{
+    return IRFunction_AddInstruction(lowering->function, block, opcode, type, a, b, 0, value);
+}
+
+static ParserResult IRSwitchConstant(IRSwitchLowering* lowering, IRType type, int64_t bits, IRValueId* value)
+{
+    return IRFunction_GetConstant(lowering->function, type, (uint64_t)bits, value);
+}
+
+/* Branch to the target of one range, or the default */
+static ParserResult IRSwitchLowerRange(IRSwitchLowering* lowering, const IRSwitchNode* node, const IRSwitchRange* range,
+    IRBlockId switchBlock)
+{
+    IRBlockId block = node->block;
+    IRType type = lowering->type;
+
+    if (node->low >= range->low && node->high <= range->high)
+        return IRSwitchTerminate(lowering, block, switchBlock, IR_OP_BR, range->target, 0, 0);
+
+    IRValueId bound;
+    IRValueId condition;
+    if (range->low == range->high) {
+        CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, range->low, &bound));
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, block, IR_OP_EQ, IR_TYPE_I1, lowering->value, bound, &condition));
+    }
+    else if (node->low >= range->low) {
+        CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, range->high, &bound));
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, block, IR_OP_SLE, IR_TYPE_I1, lowering->value, bound, &condition));
+    }
+    else if (node->high <= range->high) {
+        CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, range->low, &bound));
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, block, IR_OP_SGE, IR_TYPE_I1, lowering->value, bound, &condition));
+    }
+    else {
+        IRValueId offset;
+        CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, range->low, &bound));
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, block, IR_OP_SUB, type, lowering->value, bound, &offset));
+        CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, (int64_t)((uint64_t)range->high - (uint64_t)range->low), &bound));
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, block, IR_OP_ULE, IR_TYPE_I1, offset, bound, &condition));
+    }
+
+    return IRSwitchTerminate(lowering, block, switchBlock, IR_OP_CONDBR, condition, range->target, lowering->defaultBlock);
+}
+
+/* The value less the low end of a cluster, in a block only reached when it is within the cluster */
+static ParserResult IRSwitchCheckedIndex(IRSwitchLowering* lowering, const IRSwitchNode* node, int64_t low, int64_t high,
+    IRBlockId switchBlock, IRBlockId* block, IRValueId* index)
+{
+    IRType type = lowering->type;
+
+    *block = node->block;
+    *index = lowering->value;
+    if (low != 0) {
+        IRValueId bound;
+        CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, low, &bound));
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, *block, IR_OP_SUB, type, lowering->value, bound, index));
+    }
+
+    if (node->low >= low && node->high <= high)
+        return PARSER_RESULT_SUCCESS;
+
+    IRValueId bound;
+    IRValueId condition;
+    CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, (int64_t)((uint64_t)high - (uint64_t)low), &bound));
+    CHECK_PARSER_RESULT(IRSwitchEmit(lowering, *block, IR_OP_ULE, IR_TYPE_I1, *index, bound, &condition));
+
+    IRBlockId inside;
+    CHECK_PARSER_RESULT(IRFunction_AddBlock(lowering->function, &inside));
+    CHECK_PARSER_RESULT(IRSwitchTerminate(lowering, *block, switchBlock, IR_OP_CONDBR, condition, inside,
+        lowering->defaultBlock));
+
+    *block = inside;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* A switch on the index with one case per entry, the gaps going to the default */
+static ParserResult IRSwitchLowerTable(IRSwitchLowering* lowering, const IRSwitchNode* node,
+    const IRSwitchCluster* cluster, IRBlockId switchBlock)
+{
+    const IRSwitchRange* ranges = lowering->ranges;
+    int64_t low = ranges[cluster->first].low;
+    int64_t high = ranges[cluster->last].high;
+    uint32_t entries = (uint32_t)((uint64_t)high - (uint64_t)low) + 1;
+
+    IRBlockId block;
+    IRValueId index;
+    CHECK_PARSER_RESULT(IRSwitchCheckedIndex(lowering, node, low, high, switchBlock, &block, &index));
+
+    uint32_t* items = PARSER_MALLOC(sizeof(uint32_t) * 3 * entries, 0);
+    if (!items)
+        return PARSER_ERROR_NO_MEMORY;
+
+    uint32_t current = cluster->first;
+    for (uint32_t i = 0; i < entries; i++) {
+        int64_t value = (int64_t)((uint64_t)low + i);
+        while (ranges[current].high < value)
+            current++;
+
+        items[i * 3] = i;
+        items[i * 3 + 1] = 0;
+        items[i * 3 + 2] = ranges[current].low <= value ? ranges[current].target : lowering->defaultBlock;
+    }
+
+    IRValueId table;
+    ParserResult result = IRFunction_AddListInstruction(lowering->function, block, IR_OP_SWITCH, IR_TYPE_VOID, index,
+        lowering->defaultBlock, items, entries * 3, &table);
+    PARSER_FREE(items);
+    CHECK_PARSER_RESULT(result);
+
+    IRFunction_SetInstructionFlags(lowering->function, table, IR_INSTRUCTION_FLAG_JUMP_TABLE);
+
+    return IRSwitchAddIncoming(lowering, block, switchBlock);
+}
+
+/* Shift a one by the index and test it against a mask of the values of each target */
+static ParserResult IRSwitchLowerBits(IRSwitchLowering* lowering, const IRSwitchNode* node,
+    const IRSwitchCluster* cluster, IRBlockId switchBlock)
+{
+    const IRSwitchRange* ranges = lowering->ranges;
+    int64_t low = ranges[cluster->first].low;
+    int64_t high = ranges[cluster->last].high;
+    uint64_t span = (uint64_t)high - (uint64_t)low;
+
+    IRBlockId block;
+    IRValueId index;
+    CHECK_PARSER_RESULT(IRSwitchCheckedIndex(lowering, node, low, high, switchBlock, &block, &index));
+
+    // The narrowest of the switch, 32 and 64 bits that holds a bit per value
+    IRType type = span >= 32 ? IR_TYPE_I64 : (lowering->width <= 32 && span < lowering->width ? lowering->type : IR_TYPE_I32);
+    if (type != lowering->type) {
+        IROpcode opcode = IRType_GetSize(type) * 8 > lowering->width ? IR_OP_ZEXT : IR_OP_TRUNC;
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, block, opcode, type, index, 0, &index));
+    }
+
+    IRBlockId targets[IR_SWITCH_MAX_BIT_TESTS];
+    uint64_t masks[IR_SWITCH_MAX_BIT_TESTS];
+    uint32_t targetCount = 0;
+    uint64_t covered = 0;
+    for (uint32_t i = cluster->first; i <= cluster->last; i++) {
+        uint32_t k = 0;
+        while (k < targetCount && targets[k] != ranges[i].target)
+            k++;
+        if (k == targetCount) {
+            targets[targetCount] = ranges[i].target;
+            masks[targetCount++] = 0;
+        }
+
+        uint64_t length = (uint64_t)ranges[i].high - (uint64_t)ranges[i].low + 1;
+        masks[k] |= (length < 64 ? (1ull << length) - 1 : ~0ull) << ((uint64_t)ranges[i].low - (uint64_t)low);
+        covered += length;
+    }
+
+    IRValueId one;
+    IRValueId zero;
+    IRValueId bit;
+    CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, 1, &one));
+    CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, 0, &zero));
+    CHECK_PARSER_RESULT(IRSwitchEmit(lowering, block, IR_OP_SHL, type, one, index, &bit));
+
+    for (uint32_t k = 0; k < targetCount; k++) {
+        // The last target needs no test when the cluster leaves no value to the default
+        if (k + 1 == targetCount && covered == span + 1)
+            return IRSwitchTerminate(lowering, block, switchBlock, IR_OP_BR, targets[k], 0, 0);
+
+        IRValueId mask;
+        IRValueId masked;
+        IRValueId condition;
+        CHECK_PARSER_RESULT(IRSwitchConstant(lowering, type, (int64_t)masks[k], &mask));
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, block, IR_OP_AND, type, bit, mask, &masked));
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, block, IR_OP_NE, IR_TYPE_I1, masked, zero, &condition));
+
+        IRBlockId next = lowering->defaultBlock;
+        if (k + 1 < targetCount)
+            CHECK_PARSER_RESULT(IRFunction_AddBlock(lowering->function, &next));
+
+        CHECK_PARSER_RESULT(IRSwitchTerminate(lowering, block, switchBlock, IR_OP_CONDBR, condition, targets[k], next));
+        block = next;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* A balanced search tree over the clusters, compares against the low end of the middle one */
+static ParserResult IRSwitchLowerTree(IRSwitchLowering* lowering, IRBlockId switchBlock)
+{
+    if (lowering->clusterCount == 0)
+        return IRSwitchTerminate(lowering, switchBlock, switchBlock, IR_OP_BR, lowering->defaultBlock, 0, 0);
+
+    uint32_t top = 0;
+    IRSwitchNode* root = &lowering->nodes[top++];
+    root->block = switchBlock;
+    root->first = 0;
+    root->last = lowering->clusterCount - 1;
+    root->low = IRSwitchSigned(lowering, 1ull << (lowering->width - 1));
+    root->high = IRSwitchSigned(lowering, (1ull << (lowering->width - 1)) - 1);
+
+    while (top) {
+        IRSwitchNode node = lowering->nodes[--top];
+        const IRSwitchCluster* cluster = &lowering->clusters[node.first];
+
+        if (node.first == node.last) {
+            if (cluster->kind == IR_SWITCH_CLUSTER_TABLE)
+                CHECK_PARSER_RESULT(IRSwitchLowerTable(lowering, &node, cluster, switchBlock));
+            else if (cluster->kind == IR_SWITCH_CLUSTER_BITS)
+                CHECK_PARSER_RESULT(IRSwitchLowerBits(lowering, &node, cluster, switchBlock));
+            else
+                CHECK_PARSER_RESULT(IRSwitchLowerRange(lowering, &node, &lowering->ranges[cluster->first], switchBlock));
+            continue;
+        }
+
+        uint32_t middle = node.first + (node.last - node.first + 1) / 2;
+        int64_t pivot = lowering->ranges[lowering->clusters[middle].first].low;
+
+        IRValueId bound;
+        IRValueId condition;
+        IRBlockId left;
+        IRBlockId right;
+        CHECK_PARSER_RESULT(IRSwitchConstant(lowering, lowering->type, pivot, &bound));
+        CHECK_PARSER_RESULT(IRSwitchEmit(lowering, node.block, IR_OP_SLT, IR_TYPE_I1, lowering->value, bound, &condition));
+        CHECK_PARSER_RESULT(IRFunction_AddBlock(lowering->function, &left));
+        CHECK_PARSER_RESULT(IRFunction_AddBlock(lowering->function, &right));
+        CHECK_PARSER_RESULT(IRSwitchTerminate(lowering, node.block, switchBlock, IR_OP_CONDBR, condition, left, right));
+
+        IRSwitchNode* high = &lowering->nodes[top++];
+        high->block = right;
+        high->first = middle;
+        high->last = node.last;
+        high->low = pivot;
+        high->high = node.high;
+
+        IRSwitchNode* low = &lowering->nodes[top++];
+        low->block = left;
+        low->first = node.first;
+        low->last = middle - 1;
+        low->low = node.low;
+        low->high = pivot - 1;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRSwitchLower(IRSwitchLowering* lowering, IRBlockId block)
+{
+    IRFunction function = lowering->function;
+    IRValueId id = IRFunction_GetBlock(function, block)->last;
+    const IRInstruction* record = IRFunction_GetInstruction(function, id);
+
+    lowering->value = record->operands[0];
+    lowering->type = (IRType)IRFunction_GetInstruction(function, lowering->value)->type;
+    lowering->width = IRType_GetSize(lowering->type) * 8;
+    lowering->mask = lowering->width < 64 ? (1ull << lowering->width) - 1 : ~0ull;
+    lowering->defaultBlock = IRSwitchForward(lowering, record->operands[1]);
+
+    uint32_t count;
+    const uint32_t* items = IRFunction_GetList(function, id, &count);
+    uint32_t caseCount = count / 3;
+
+    // Ranges, choices, nodes and clusters; a tree walk holds no more nodes than there are clusters
+    size_t size = sizeof(IRSwitchRange) * caseCount + sizeof(IRSwitchChoice) * (caseCount + 1) +
+                  sizeof(IRSwitchNode) * (caseCount + 1) + sizeof(IRSwitchCluster) * caseCount;
+    uint8_t* memory = PARSER_MALLOC(size, 0);
+    if (!memory)
+        return PARSER_ERROR_NO_MEMORY;
+
+    lowering->ranges = (IRSwitchRange*)memory;
+    lowering->choices = (IRSwitchChoice*)(lowering->ranges + caseCount);
+    lowering->nodes = (IRSwitchNode*)(lowering->choices + caseCount + 1);
+    lowering->clusters = (IRSwitchCluster*)(lowering->nodes + caseCount + 1);
+
+    IRSwitchGatherRanges(lowering, items, count);
+    IRSwitchChooseClusters(lowering);
+    IRSwitchRecordIncoming(lowering, block);
+
+    IRFunction_RemoveInstruction(function, id);
+    ParserResult result = IRSwitchLowerTree(lowering, block);
+
+    PARSER_FREE(memory);
+
+    return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_LowerSwitches(
+    IRFunction function,
+    const IRSwitchConfig* config,
+    IRPassStats* stats)
+{
+    if (!function)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRFunctionStats before;
+    IRFunction_GetStats(function, &before);
+
+    IRSwitchLowering lowering;
+    memset(&lowering, 0, sizeof(IRSwitchLowering));
+    lowering.function = function;
+    if (config)
+        lowering.config = *config;
+    if (!lowering.config.sizeWeight)
+        lowering.config.sizeWeight = IR_SWITCH_DEFAULT_SIZE_WEIGHT;
+    if (!lowering.config.cyclesWeight)
+        lowering.config.cyclesWeight = IR_SWITCH_DEFAULT_CYCLES_WEIGHT;
+    if (!lowering.config.entrySize)
+        lowering.config.entrySize = IR_SWITCH_DEFAULT_ENTRY_SIZE;
+    if (!lowering.config.maskWidth)
+        lowering.config.maskWidth = IR_SWITCH_DEFAULT_MASK_WIDTH;
+
+    // Switches to lower, and the phis whose operands they may need to remember
+    uint32_t blockCount = IRFunction_GetBlockCount(function);
+    uint32_t switchCount = 0;
+    uint32_t phiCount = 0;
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < blockCount; block++) {
+        const IRBlock* record = IRFunction_GetBlock(function, block);
+        for (IRValueId id = record->first; id != IR_VALUE_NONE; id = IRFunction_GetInstruction(function, id)->next) {
+            const IRInstruction* instruction = IRFunction_GetInstruction(function, id);
+            if (instruction->opcode != IR_OP_PHI)
+                break;
+            phiCount++;
+        }
+
+        const IRInstruction* last = IRFunction_GetInstruction(function, record->last);
+        if (last && last->opcode == IR_OP_SWITCH && !(last->flags & IR_INSTRUCTION_FLAG_JUMP_TABLE) &&
+            IRFunction_GetInstruction(function, last->operands[0])->type >= IR_TYPE_I8 &&
+            IRFunction_GetInstruction(function, last->operands[0])->type <= IR_TYPE_I64)
+            switchCount++;
+    }
+
+    if (switchCount == 0)
+        return IRFunction_IsCompact(function) ? PARSER_RESULT_SUCCESS : IRFunction_Compact(function);
+
+    size_t size = sizeof(IRBlockId) * blockCount + sizeof(uint32_t) * 2 * blockCount + sizeof(IRSwitchIncoming) * phiCount;
+    uint8_t* memory = PARSER_MALLOC(size, 0);
+    if (!memory)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(memory, 0, size);
+    lowering.blockCount = blockCount;
+    lowering.stamps = (IRBlockId*)memory;
+    lowering.incomingFirst = (uint32_t*)(lowering.stamps + blockCount);
+    lowering.incomingCounts = lowering.incomingFirst + blockCount;
+    lowering.incoming = (IRSwitchIncoming*)(lowering.incomingCounts + blockCount);
+
+    ParserResult result = PARSER_RESULT_SUCCESS;
+    uint32_t lowered = 0;
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < blockCount && result == PARSER_RESULT_SUCCESS; block++) {
+        const IRInstruction* last = IRFunction_GetInstruction(function, IRFunction_GetBlock(function, block)->last);
+        if (!last || last->opcode != IR_OP_SWITCH || (last->flags & IR_INSTRUCTION_FLAG_JUMP_TABLE))
+            continue;
+
+        IRType type = (IRType)IRFunction_GetInstruction(function, last->operands[0])->type;
+        if (type < IR_TYPE_I8 || type > IR_TYPE_I64)
+            continue;
+
+        result = IRSwitchLower(&lowering, block);
+        lowered++;
+    }
+
+    PARSER_FREE(memory);
+
+    if (result == PARSER_RESULT_SUCCESS && !IRFunction_IsCompact(function))
+        result = IRFunction_Compact(function);
+
+    if (stats) {
+        IRFunctionStats after;
+        IRFunction_GetStats(function, &after);
+
+        stats->instructionsRemoved += before.instructions > after.instructions ? before.instructions - after.instructions : 0;
+        stats->blocksRemoved += before.blocks > after.blocks ? before.blocks - after.blocks : 0;
+        stats->switchesLowered += lowered;
+    }
+
+    return result;
+}
@@ -0,0 +1,1220 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRText.h"
+#include "IRInternal.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define IR_TEXT_MAX_NUMBER              (1u << 24)  // Largest value, block or data number read
+
+static const char* const s_IRTypeNames[IR_TYPE_COUNT] = {
+    [IR_TYPE_VOID] = "void",
+    [IR_TYPE_I1] = "i1",
+    [IR_TYPE_I8] = "i8",
+    [IR_TYPE_I16] = "i16",
+    [IR_TYPE_I32] = "i32",
+    [IR_TYPE_I64] = "i64",
+    [IR_TYPE_PTR] = "ptr",
+    [IR_TYPE_F32] = "f32",
+    [IR_TYPE_F64] = "f64",
+};
+
+/* Sign extend the bits of an integer constant from the width of its type */
+static int64_t IRTextSigned(uint64_t bits, IRType type)
+{
+    uint32_t width = IRType_GetSize(type) * 8;
+    if (width && width < 64 && (bits >> (width - 1)) & 1)
+        bits |= ~((1ull << width) - 1);
+
+    return (int64_t)bits;
+}
+
+// ===== Printing =====
+
+typedef struct IRTextBuffer_T {
+    char* data;
+    size_t length;
+    size_t capacity;
+} IRTextBuffer;
+
+static ParserResult IRTextAppend(IRTextBuffer* buffer, const char* format, ...)
+{
+    // Most pieces fit in the room left, they are formatted once
+    size_t room = buffer->capacity - buffer->length;
+
+    va_list args;
+    va_start(args, format);
+    int needed = vsnprintf(buffer->data ? buffer->data + buffer->length : NULL, room, format, args);
+    va_end(args);
+
+    if (needed < 0)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if ((size_t)needed >= room) {
+        size_t newCapacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+        while (buffer->length + (size_t)needed + 1 > newCapacity)
+            newCapacity *= 2;
+
+        char* data = PARSER_MALLOC(newCapacity, 0);
+        if (!data)
+            return PARSER_ERROR_NO_MEMORY;
+
+        if (buffer->data) {
+            memcpy(data, buffer->data, buffer->length);
+            PARSER_FREE(buffer->data);
+        }
+
+        buffer->data = data;
+        buffer->capacity = newCapacity;
+
+        va_start(args, format);
+        vsnprintf(buffer->data + buffer->length, (size_t)needed + 1, format, args);
+        va_end(args);
+    }
+
+    buffer->length += (size_t)needed;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRTextPrintGlobal(IRTextBuffer* buffer, const IRModule module, IRGlobalId global)
+{
+    const IRGlobalInfo* info = IRModule_GetGlobal(module, global);
+    if (info && info->name)
+        return IRTextAppend(buffer, "@%.*s", (int)info->length, info->name);
+
+    return IRTextAppend(buffer, "@.%u", global);
+}
+
+static ParserResult IRTextPrintValue(IRTextBuffer* buffer, const IRFunction function, const uint32_t* numbers, IRValueId value)
+{
+    if (value == IR_VALUE_NONE)
+        return IRTextAppend(buffer, "none");
+
+    const IRInstruction* record = IRFunctionRecord(function, value);
+    const char* type = s_IRTypeNames[record->type];
+    uint64_t bits = IR_CONST_BITS(record);
+
+    if (record->opcode == IR_OP_UNDEF)
+        return IRTextAppend(buffer, "%s undef", type);
+
+    if (record->opcode != IR_OP_CONST)
+        return IRTextAppend(buffer, "%%%u", numbers[value]);
+
+    switch (record->type) {
+    case IR_TYPE_I1:
+        return IRTextAppend(buffer, "%s %u", type, (uint32_t)bits);
+    case IR_TYPE_F32:
+        return IRTextAppend(buffer, "%s 0x%08X", type, (uint32_t)bits);
+    case IR_TYPE_F64:
+        return IRTextAppend(buffer, "%s 0x%016llX", type, (unsigned long long)bits);
+    default:
+        return IRTextAppend(buffer, "%s %lld", type, (long long)IRTextSigned(bits, (IRType)record->type));
+    }
+}
+
+static ParserResult IRTextPrintList(IRTextBuffer* buffer, const IRFunction function, const uint32_t* numbers, IRValueId id)
+{
+    const IRInstruction* record = IRFunctionRecord(function, id);
+
+    uint32_t count;
+    const uint32_t* items = IRFunction_GetList(function, id, &count);
+
+    uint32_t predCount;
+    const IRBlockId* preds = IRFunction_GetPredecessors(function, record->block, &predCount);
+
+    CHECK_PARSER_RESULT(IRTextAppend(buffer, "["));
+
+    if (record->opcode == IR_OP_SWITCH) {
+        IRType type = (IRType)IRFunctionRecord(function, record->operands[0])->type;
+        for (uint32_t i = 0; i + 2 < count; i += 3) {
+            uint64_t bits = ((uint64_t)items[i + 1] << 32) | items[i];
+            CHECK_PARSER_RESULT(IRTextAppend(buffer, "%s%lld b%u", i ? ", " : "",
+                (long long)IRTextSigned(bits, type), items[i + 2]));
+        }
+    }
+    else {
+        for (uint32_t i = 0; i < count; i++) {
+            if (i)
+                CHECK_PARSER_RESULT(IRTextAppend(buffer, ", "));
+
+            CHECK_PARSER_RESULT(IRTextPrintValue(buffer, function, numbers, items[i]));
+
+            if (record->opcode == IR_OP_PHI)
+                CHECK_PARSER_RESULT(IRTextAppend(buffer, " b%u", i < predCount ? preds[i] : IR_BLOCK_NONE));
+        }
+    }
+
+    return IRTextAppend(buffer, "]");
+}
+
+static ParserResult IRTextPrintInstruction(IRTextBuffer* buffer, const IRFunction function, const uint32_t* numbers, IRValueId id)
+{
+    const IRInstruction* record = IRFunctionRecord(function, id);
+    const IROpcodeInfo* info = IROpcode_GetInfo((IROpcode)record->opcode);
+
+    CHECK_PARSER_RESULT(IRTextAppend(buffer, "  "));
+    if (record->type != IR_TYPE_VOID)
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, "%%%u = ", numbers[id]));
+
+    CHECK_PARSER_RESULT(IRTextAppend(buffer, "%s", info->name));
+    if (record->flags & IR_INSTRUCTION_FLAG_VOLATILE)
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, " volatile"));
+    if (record->flags & IR_INSTRUCTION_FLAG_NOALIAS)
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, " noalias"));
+    if (record->flags & IR_INSTRUCTION_FLAG_JUMP_TABLE)
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, " table"));
+    CHECK_PARSER_RESULT(IRTextAppend(buffer, " %s", s_IRTypeNames[record->type]));
+
+    bool first = true;
+    for (uint32_t i = 0; i < 3; i++) {
+        if (info->operands[i] == IR_OPERAND_NONE)
+            continue;
+
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, first ? " " : ", "));
+        first = false;
+
+        switch (info->operands[i]) {
+        case IR_OPERAND_VALUE:
+            CHECK_PARSER_RESULT(IRTextPrintValue(buffer, function, numbers, record->operands[i]));
+            break;
+        case IR_OPERAND_BLOCK:
+            CHECK_PARSER_RESULT(IRTextAppend(buffer, "b%u", record->operands[i]));
+            break;
+        case IR_OPERAND_IMMEDIATE:
+            if (record->opcode == IR_OP_GLOBAL)
+                CHECK_PARSER_RESULT(IRTextPrintGlobal(buffer, function->module, record->operands[i]));
+            else
+                CHECK_PARSER_RESULT(IRTextAppend(buffer, "#%u", record->operands[i]));
+            break;
+        default:
+            CHECK_PARSER_RESULT(IRTextPrintList(buffer, function, numbers, id));
+            break;
+        }
+    }
+
+    return IRTextAppend(buffer, "\n");
+}
+
+static ParserResult IRTextPrintBody(IRTextBuffer* buffer, const IRFunction function, uint32_t* numbers)
+{
+    // Values are numbered in the order they are printed
+    uint32_t next = 1;
+    for (IRBlockId block = 1; block < function->blockCount; block++) {
+        for (IRValueId id = function->blocks[block].first; id != IR_VALUE_NONE; id = IRFunctionRecord(function, id)->next) {
+            if (IRFunctionRecord(function, id)->type != IR_TYPE_VOID)
+                numbers[id] = next++;
+        }
+    }
+
+    CHECK_PARSER_RESULT(IRTextAppend(buffer, "define "));
+    CHECK_PARSER_RESULT(IRTextPrintGlobal(buffer, function->module, function->global));
+    CHECK_PARSER_RESULT(IRTextAppend(buffer, "("));
+
+    for (uint32_t i = 0; i < function->paramCount; i++)
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, "%s%s", i ? ", " : "", s_IRTypeNames[function->params[i]]));
+
+    CHECK_PARSER_RESULT(IRTextAppend(buffer, ") -> %s {\n", s_IRTypeNames[function->returnType]));
+
+    for (IRBlockId block = 1; block < function->blockCount; block++) {
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, "b%u:\n", block));
+        for (IRValueId id = function->blocks[block].first; id != IR_VALUE_NONE; id = IRFunctionRecord(function, id)->next)
+            CHECK_PARSER_RESULT(IRTextPrintInstruction(buffer, function, numbers, id));
+    }
+
+    return IRTextAppend(buffer, "}\n");
+}
+
+static ParserResult IRTextPrintFunction(IRTextBuffer* buffer, const IRFunction function)
+{
+    uint32_t* numbers = PARSER_MALLOC(sizeof(uint32_t) * function->instructionCount, 0);
+    if (!numbers)
+        return PARSER_ERROR_NO_MEMORY;
+
+    ParserResult result = IRTextPrintBody(buffer, function, numbers);
+    PARSER_FREE(numbers);
+
+    return result;
+}
+
+static ParserResult IRTextPrintDeclaration(IRTextBuffer* buffer, const IRModule module, IRGlobalId global)
+{
+    const IRGlobalInfo* info = IRModule_GetGlobal(module, global);
+
+    CHECK_PARSER_RESULT(IRTextAppend(buffer, info->kind == IR_GLOBAL_KIND_FUNCTION ? "declare " : "data "));
+    CHECK_PARSER_RESULT(IRTextPrintGlobal(buffer, module, global));
+
+    bool isData = info->kind == IR_GLOBAL_KIND_DATA && (info->flags & IR_GLOBAL_FLAG_DEFINED);
+    if (isData)
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, " %u align %u", info->size, info->alignment));
+
+    if (info->flags & IR_GLOBAL_FLAG_INTERNAL)
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, " internal"));
+    if (info->flags & IR_GLOBAL_FLAG_CONSTANT)
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, " constant"));
+    if (info->flags & IR_GLOBAL_FLAG_INLINE)
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, " inline"));
+
+    if (isData && info->data) {
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, " x\""));
+        for (uint32_t i = 0; i < info->size; i++)
+            CHECK_PARSER_RESULT(IRTextAppend(buffer, "%02x", info->data[i]));
+        CHECK_PARSER_RESULT(IRTextAppend(buffer, "\""));
+    }
+
+    return IRTextAppend(buffer, "\n");
+}
+
+// ===== Reading =====
+
+/**
+ * @brief Operand whose value is not known when its instruction is read
+ *
+ * @description A value used before its definition is patched at the end
+ *              of the function. Phi operands are all kept until then:
+ *              they go in the order of the predecessors, which is only
+ *              known once every branch is read.
+ */
+typedef struct IRTextOperand_T {
+    IRValueId user;
+    uint32_t slot;                  // Operand slot, unused for phis
+    uint32_t value;                 // Value id, the number in the text while pending
+    IRBlockId block;                // Predecessor of a phi operand
+    uint8_t pending;
+    uint8_t placed;                 // Phi operand appended
+} IRTextOperand;
+
+typedef struct IRTextReader_T {
+    const char* text;
+    size_t length;
+    size_t position;
+    uint32_t line;
+
+    IRModule module;
+    IRGlobalId* anonymous;          // Anonymous data by the number in the text
+    uint32_t anonymousCapacity;
+
+    // ===== Function being read =====
+    IRFunction function;
+    IRBlockId block;
+    IRValueId* values;              // By the number in the text
+    uint32_t valueCapacity;
+    IRBlockId* blocks;              // By the number in the text
+    uint32_t blockCapacity;
+    IRTextOperand* fixups;
+    uint32_t fixupCount;
+    uint32_t fixupCapacity;
+    IRTextOperand* phis;
+    uint32_t phiCount;
+    uint32_t phiCapacity;
+
+    // ===== Scratch =====
+    uint32_t* items;
+    uint32_t itemCount;
+    uint32_t itemCapacity;
+    uint8_t* bytes;                 // Parameter types, data initializers
+    uint32_t byteCount;
+    uint32_t byteCapacity;
+} IRTextReader;
+
+/* Grow an array to hold `needed` items, new items are zero */
+static ParserResult IRTextReserve(void** items, uint32_t* capacity, uint32_t needed, size_t size)
+{
+    uint32_t oldCapacity = *capacity;
+    CHECK_PARSER_RESULT(ParserArrayReserve(items, capacity, oldCapacity, needed, size, 64));
+
+    memset((uint8_t*)*items + size * oldCapacity, 0, size * (*capacity - oldCapacity));
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRTextPushItem(IRTextReader* reader, uint32_t item)
+{
+    CHECK_PARSER_RESULT(IRTextReserve((void**)&reader->items, &reader->itemCapacity, reader->itemCount + 1, sizeof(uint32_t)));
+    reader->items[reader->itemCount++] = item;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRTextPushByte(IRTextReader* reader, uint8_t byte)
+{
+    CHECK_PARSER_RESULT(IRTextReserve((void**)&reader->bytes, &reader->byteCapacity, reader->byteCount + 1, 1));
+    reader->bytes[reader->byteCount++] = byte;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRTextPushOperand(IRTextOperand** operands, uint32_t* count, uint32_t* capacity, const IRTextOperand* operand)
+{
+    CHECK_PARSER_RESULT(IRTextReserve((void**)operands, capacity, *count + 1, sizeof(IRTextOperand)));
+    (*operands)[(*count)++] = *operand;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static inline bool IRTextIsWordChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '$';
+}
+
+/* Skip white space, line ends and comments */
+static void IRTextSkip(IRTextReader* reader)
+{
+    while (reader->position < reader->length) {
+        char c = reader->text[reader->position];
+        if (c == '\n') {
+            reader->line++;
+            reader->position++;
+        }
+        else if (c == ' ' || c == '\t' || c == '\r') {
+            reader->position++;
+        }
+        else if (c == ';') {
+            while (reader->position < reader->length && reader->text[reader->position] != '\n')
+                reader->position++;
+        }
+        else {
+            break;
+        }
+    }
+}
+
+static bool IRTextPeek(IRTextReader* reader, char c)
+{
+    IRTextSkip(reader);
+    return reader->position < reader->length && reader->text[reader->position] == c;
+}
+
+static bool IRTextAccept(IRTextReader* reader, char c)
+{
+    if (!IRTextPeek(reader, c))
+        return false;
+
+    reader->position++;
+    return true;
+}
+
+static bool IRTextWord(IRTextReader* reader, const char** word, uint32_t* length)
+{
+    IRTextSkip(reader);
+
+    size_t start = reader->position;
+    while (reader->position < reader->length && IRTextIsWordChar(reader->text[reader->position]))
+        reader->position++;
+
+    *word = reader->text + start;
+    *length = (uint32_t)(reader->position - start);
+
+    return *length != 0;
+}
+
+static inline bool IRTextIsWord(const char* word, uint32_t length, const char* expected)
+{
+    return strlen(expected) == length && memcmp(word, expected, length) == 0;
+}
+
+/* Take the next word only when it is `expected` */
+static bool IRTextAcceptWord(IRTextReader* reader, const char* expected)
+{
+    size_t position = reader->position;
+    uint32_t line = reader->line;
+
+    const char* word;
+    uint32_t length;
+    if (IRTextWord(reader, &word, &length) && IRTextIsWord(word, length, expected))
+        return true;
+
+    reader->position = position;
+    reader->line = line;
+    return false;
+}
+
+/* Decimal or 0x hexadecimal digits of a word, at most 64 bits */
+static bool IRTextDigits(const char* word, uint32_t length, uint64_t* value)
+{
+    uint64_t result = 0;
+    uint32_t base = 10;
+
+    if (length > 2 && word[0] == '0' && (word[1] == 'x' || word[1] == 'X')) {
+        base = 16;
+        word += 2;
+        length -= 2;
+    }
+
+    if (!length || length > (base == 16 ? 16u : 20u))
+        return false;
+
+    for (uint32_t i = 0; i < length; i++) {
+        char c = word[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9')
+            digit = (uint32_t)(c - '0');
+        else if (base == 16 && c >= 'a' && c <= 'f')
+            digit = (uint32_t)(c - 'a' + 10);
+        else if (base == 16 && c >= 'A' && c <= 'F')
+            digit = (uint32_t)(c - 'A' + 10);
+        else
+            return false;
+
+        if (base == 10 && result > (UINT64_MAX - digit) / 10)
+            return false;
+
+        result = result * base + digit;
+    }
+
+    *value = result;
+    return true;
+}
+
+static bool IRTextNumber(IRTextReader* reader, uint64_t* value)
+{
+    bool negative = IRTextAccept(reader, '-');
+
+    const char* word;
+    uint32_t length;
+    if (!IRTextWord(reader, &word, &length) || !IRTextDigits(word, length, value))
+        return false;
+
+    if (negative)
+        *value = 0 - *value;
+
+    return true;
+}
+
+static bool IRTextUnsigned(IRTextReader* reader, uint32_t limit, uint32_t* value)
+{
+    const char* word;
+    uint32_t length;
+    uint64_t number;
+    if (!IRTextWord(reader, &word, &length) || !IRTextDigits(word, length, &number) || number >= limit)
+        return false;
+
+    *value = (uint32_t)number;
+    return true;
+}
+
+static bool IRTextType(IRTextReader* reader, IRType* type)
+{
+    const char* word;
+    uint32_t length;
+    if (!IRTextWord(reader, &word, &length))
+        return false;
+
+    for (uint32_t i = 0; i < IR_TYPE_COUNT; i++) {
+        if (IRTextIsWord(word, length, s_IRTypeNames[i])) {
+            *type = (IRType)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Number of a block label or operand `bN` */
+static bool IRTextBlockNumber(const char* word, uint32_t length, uint32_t* number)
+{
+    uint64_t value;
+    if (length < 2 || word[0] != 'b' || word[1] < '0' || word[1] > '9' || !IRTextDigits(word + 1, length - 1, &value) ||
+        value >= IR_TEXT_MAX_NUMBER)
+        return false;
+
+    *number = (uint32_t)value;
+    return true;
+}
+
+static ParserResult IRTextReadBlock(IRTextReader* reader, IRBlockId* block)
+{
+    const char* word;
+    uint32_t length;
+    uint32_t number;
+    if (!IRTextWord(reader, &word, &length) || !IRTextBlockNumber(word, length, &number))
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    if (number >= reader->blockCapacity || reader->blocks[number] == IR_BLOCK_NONE)
+        return PARSER_ERROR_UNKNOWN_IDENTIFIER;
+
+    *block = reader->blocks[number];
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Name after `@`, anonymous data is `.N` */
+static ParserResult IRTextReadName(IRTextReader* reader, const char** name, uint32_t* length, uint32_t* anonymous)
+{
+    if (!IRTextAccept(reader, '@') || reader->position >= reader->length || !IRTextIsWordChar(reader->text[reader->position]) ||
+        !IRTextWord(reader, name, length))
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    *anonymous = UINT32_MAX;
+
+    uint64_t number;
+    if ((*name)[0] == '.') {
+        if (!IRTextDigits(*name + 1, *length - 1, &number) || number >= IR_TEXT_MAX_NUMBER)
+            return PARSER_ERROR_SYNTAX_ERROR;
+
+        *anonymous = (uint32_t)number;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRTextReadGlobal(IRTextReader* reader, IRGlobalId* global)
+{
+    const char* name;
+    uint32_t length;
+    uint32_t anonymous;
+    CHECK_PARSER_RESULT(IRTextReadName(reader, &name, &length, &anonymous));
+
+    if (anonymous != UINT32_MAX)
+        *global = anonymous < reader->anonymousCapacity ? reader->anonymous[anonymous] : IR_GLOBAL_NONE;
+    else
+        *global = IRModule_FindGlobal(reader->module, name, length);
+
+    return *global == IR_GLOBAL_NONE ? PARSER_ERROR_UNKNOWN_IDENTIFIER : PARSER_RESULT_SUCCESS;
+}
+
+/* Value operand: its id, or the number of a value defined further on */
+static ParserResult IRTextReadValue(IRTextReader* reader, uint32_t* value, bool* pending)
+{
+    *pending = false;
+
+    if (IRTextAccept(reader, '%')) {
+        uint32_t number;
+        if (!IRTextUnsigned(reader, IR_TEXT_MAX_NUMBER, &number))
+            return PARSER_ERROR_SYNTAX_ERROR;
+
+        if (number < reader->valueCapacity && reader->values[number] != IR_VALUE_NONE) {
+            *value = reader->values[number];
+        }
+        else {
+            *value = number;
+            *pending = true;
+        }
+
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    if (IRTextAcceptWord(reader, "none")) {
+        *value = IR_VALUE_NONE;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    IRType type;
+    if (!IRTextType(reader, &type) || type == IR_TYPE_VOID)
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    if (IRTextAcceptWord(reader, "undef"))
+        return IRFunction_GetUndef(reader->function, type, value);
+
+    uint64_t bits;
+    if (!IRTextNumber(reader, &bits))
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    return IRFunction_GetConstant(reader->function, type, bits, value);
+}
+
+/* Read a value operand, one not defined yet is patched at the end of the function */
+static ParserResult IRTextReadOperand(IRTextReader* reader, uint32_t slot, uint32_t* value)
+{
+    bool pending;
+    CHECK_PARSER_RESULT(IRTextReadValue(reader, value, &pending));
+
+    if (!pending)
+        return PARSER_RESULT_SUCCESS;
+
+    IRTextOperand fixup = { IR_VALUE_NONE, slot, *value, IR_BLOCK_NONE, 1, 0 };
+    *value = IR_VALUE_NONE;
+
+    return IRTextPushOperand(&reader->fixups, &reader->fixupCount, &reader->fixupCapacity, &fixup);
+}
+
+static ParserResult IRTextReadList(IRTextReader* reader, IROpcode opcode)
+{
+    reader->itemCount = 0;
+
+    if (!IRTextAccept(reader, '['))
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    if (IRTextAccept(reader, ']'))
+        return PARSER_RESULT_SUCCESS;
+
+    do {
+        if (opcode == IR_OP_PHI) {
+            IRTextOperand operand = { IR_VALUE_NONE, 0, 0, IR_BLOCK_NONE, 0, 0 };
+            bool pending;
+            CHECK_PARSER_RESULT(IRTextReadValue(reader, &operand.value, &pending));
+            CHECK_PARSER_RESULT(IRTextReadBlock(reader, &operand.block));
+
+            operand.pending = pending;
+            CHECK_PARSER_RESULT(IRTextPushOperand(&reader->phis, &reader->phiCount, &reader->phiCapacity, &operand));
+        }
+        else if (opcode == IR_OP_SWITCH) {
+            uint64_t bits;
+            IRBlockId block;
+            if (!IRTextNumber(reader, &bits))
+                return PARSER_ERROR_SYNTAX_ERROR;
+
+            CHECK_PARSER_RESULT(IRTextReadBlock(reader, &block));
+            CHECK_PARSER_RESULT(IRTextPushItem(reader, (uint32_t)bits));
+            CHECK_PARSER_RESULT(IRTextPushItem(reader, (uint32_t)(bits >> 32)));
+            CHECK_PARSER_RESULT(IRTextPushItem(reader, block));
+        }
+        else {
+            uint32_t value;
+            CHECK_PARSER_RESULT(IRTextReadOperand(reader, IR_USE_LIST_SLOT + reader->itemCount, &value));
+            CHECK_PARSER_RESULT(IRTextPushItem(reader, value));
+        }
+    } while (IRTextAccept(reader, ','));
+
+    return IRTextAccept(reader, ']') ? PARSER_RESULT_SUCCESS : PARSER_ERROR_SYNTAX_ERROR;
+}
+
+static ParserResult IRTextReadInstruction(IRTextReader* reader, const char* word, uint32_t length, uint32_t result)
+{
+    IROpcode opcode = IR_OP_NOP;
+    for (uint32_t i = IR_OP_NOP + 1; i < IR_OP_COUNT; i++) {
+        if (IRTextIsWord(word, length, IROpcode_GetInfo((IROpcode)i)->name)) {
+            opcode = (IROpcode)i;
+            break;
+        }
+    }
+
+    // Constants and undefined values are written inline
+    if (opcode == IR_OP_NOP || opcode == IR_OP_CONST || opcode == IR_OP_UNDEF)
+        return PARSER_ERROR_UNKNOWN_IDENTIFIER;
+
+    if (reader->block == IR_BLOCK_NONE)
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    uint32_t flags = IR_INSTRUCTION_FLAG_NONE;
+    IRType type;
+    for (;;) {
+        if (IRTextAcceptWord(reader, "volatile"))
+            flags |= IR_INSTRUCTION_FLAG_VOLATILE;
+        else if (IRTextAcceptWord(reader, "noalias"))
+            flags |= IR_INSTRUCTION_FLAG_NOALIAS;
+        else if (IRTextAcceptWord(reader, "table"))
+            flags |= IR_INSTRUCTION_FLAG_JUMP_TABLE;
+        else if (IRTextType(reader, &type))
+            break;
+        else
+            return PARSER_ERROR_SYNTAX_ERROR;
+    }
+
+    const IROpcodeInfo* info = IROpcode_GetInfo(opcode);
+    uint32_t fixupStart = reader->fixupCount;
+    uint32_t phiStart = reader->phiCount;
+    uint32_t operands[3] = { 0, 0, 0 };
+    bool hasList = false;
+    bool first = true;
+
+    for (uint32_t i = 0; i < 3; i++) {
+        if (info->operands[i] == IR_OPERAND_NONE)
+            continue;
+
+        if (!first && !IRTextAccept(reader, ','))
+            return PARSER_ERROR_SYNTAX_ERROR;
+        first = false;
+
+        switch (info->operands[i]) {
+        case IR_OPERAND_VALUE:
+            CHECK_PARSER_RESULT(IRTextReadOperand(reader, i, &operands[i]));
+            break;
+        case IR_OPERAND_BLOCK:
+            CHECK_PARSER_RESULT(IRTextReadBlock(reader, &operands[i]));
+            break;
+        case IR_OPERAND_IMMEDIATE:
+            if (opcode == IR_OP_GLOBAL) {
+                CHECK_PARSER_RESULT(IRTextReadGlobal(reader, &operands[i]));
+            }
+            else if (!IRTextAccept(reader, '#') || !IRTextUnsigned(reader, UINT32_MAX, &operands[i])) {
+                return PARSER_ERROR_SYNTAX_ERROR;
+            }
+            break;
+        default:
+            CHECK_PARSER_RESULT(IRTextReadList(reader, opcode));
+            hasList = true;
+            break;
+        }
+    }
+
+    IRValueId id;
+    if (opcode == IR_OP_PHI) {
+        CHECK_PARSER_RESULT(IRFunction_AddPhi(reader->function, reader->block, type, &id));
+    }
+    else if (hasList) {
+        // The operands before the list slot, in order
+        uint32_t given[2] = { 0, 0 };
+        for (uint32_t i = 0, next = 0; i < 3; i++) {
+            if (info->operands[i] != IR_OPERAND_LIST && info->operands[i] != IR_OPERAND_NONE && next < 2)
+                given[next++] = operands[i];
+        }
+
+        CHECK_PARSER_RESULT(IRFunction_AddListInstruction(reader->function, reader->block, opcode, type, given[0], given[1],
+            reader->items, reader->itemCount, &id));
+    }
+    else {
+        CHECK_PARSER_RESULT(IRFunction_AddInstruction(reader->function, reader->block, opcode, type,
+            operands[0], operands[1], operands[2], &id));
+    }
+
+    IRFunction_SetInstructionFlags(reader->function, id, flags);
+
+    for (uint32_t i = fixupStart; i < reader->fixupCount; i++)
+        reader->fixups[i].user = id;
+    for (uint32_t i = phiStart; i < reader->phiCount; i++)
+        reader->phis[i].user = id;
+
+    if (result != UINT32_MAX) {
+        CHECK_PARSER_RESULT(IRTextReserve((void**)&reader->values, &reader->valueCapacity, result + 1, sizeof(IRValueId)));
+        if (reader->values[result] != IR_VALUE_NONE)
+            return PARSER_ERROR_REDECLARATION;
+
+        reader->values[result] = id;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Create a block for every label up to the closing brace, the first one is the entry */
+static ParserResult IRTextReadLabels(IRTextReader* reader)
+{
+    size_t position = reader->position;
+    uint32_t line = reader->line;
+    bool entry = true;
+
+    for (;;) {
+        IRTextSkip(reader);
+        if (reader->position >= reader->length)
+            return PARSER_ERROR_UNCLOSED_BRACE;
+
+        char c = reader->text[reader->position];
+        if (c == '}')
+            break;
+
+        if (!IRTextIsWordChar(c)) {
+            reader->position++;
+            continue;
+        }
+
+        const char* word;
+        uint32_t length;
+        uint32_t number;
+        IRTextWord(reader, &word, &length);
+
+        if (!IRTextBlockNumber(word, length, &number) || !IRTextAccept(reader, ':'))
+            continue;
+
+        CHECK_PARSER_RESULT(IRTextReserve((void**)&reader->blocks, &reader->blockCapacity, number + 1, sizeof(IRBlockId)));
+        if (reader->blocks[number] != IR_BLOCK_NONE)
+            return PARSER_ERROR_REDECLARATION;
+
+        if (entry)
+            reader->blocks[number] = IR_BLOCK_ENTRY;
+        else
+            CHECK_PARSER_RESULT(IRFunction_AddBlock(reader->function, &reader->blocks[number]));
+
+        entry = false;
+    }
+
+    if (entry)
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    reader->position = position;
+    reader->line = line;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Patch the values used before their definition, then give the phis their operands in predecessor order */
+static ParserResult IRTextResolve(IRTextReader* reader)
+{
+    for (uint32_t i = 0; i < reader->fixupCount; i++) {
+        const IRTextOperand* fixup = &reader->fixups[i];
+        if (fixup->value >= reader->valueCapacity || reader->values[fixup->value] == IR_VALUE_NONE)
+            return PARSER_ERROR_UNKNOWN_IDENTIFIER;
+
+        CHECK_PARSER_RESULT(IRFunction_SetOperand(reader->function, fixup->user, fixup->slot, reader->values[fixup->value]));
+    }
+
+    for (uint32_t start = 0, end; start < reader->phiCount; start = end) {
+        IRValueId phi = reader->phis[start].user;
+        end = start;
+        while (end < reader->phiCount && reader->phis[end].user == phi)
+            end++;
+
+        IRBlockId block = IRFunction_GetInstruction(reader->function, phi)->block;
+        uint32_t predCount;
+        const IRBlockId* preds = IRFunction_GetPredecessors(reader->function, block, &predCount);
+        if (predCount != end - start)
+            return PARSER_ERROR_SYNTAX_ERROR;
+
+        // The first phi of a block puts the predecessors in the order it names them, so the
+        // text prints the same again; no phi of the block has operands yet
+        if (reader->function->blocks[block].first == phi) {
+            IRBlockId* order = IRListItems(reader->function, reader->function->blocks[block].preds);
+            for (uint32_t i = 0; i < predCount; i++) {
+                uint32_t j = i;
+                while (j < predCount && order[j] != reader->phis[start + i].block)
+                    j++;
+
+                if (j == predCount)
+                    break;
+
+                order[j] = order[i];
+                order[i] = reader->phis[start + i].block;
+            }
+        }
+
+        for (uint32_t i = 0; i < predCount; i++) {
+            // A block that branches here twice has two operands
+            IRTextOperand* operand = NULL;
+            for (uint32_t j = start; j < end && !operand; j++) {
+                if (!reader->phis[j].placed && reader->phis[j].block == preds[i])
+                    operand = &reader->phis[j];
+            }
+
+            if (!operand)
+                return PARSER_ERROR_SYNTAX_ERROR;
+
+            uint32_t value = operand->value;
+            if (operand->pending) {
+                if (value >= reader->valueCapacity || reader->values[value] == IR_VALUE_NONE)
+                    return PARSER_ERROR_UNKNOWN_IDENTIFIER;
+
+                value = reader->values[value];
+            }
+
+            operand->placed = 1;
+            CHECK_PARSER_RESULT(IRFunction_AppendOperand(reader->function, phi, value));
+
+            // Appending may move the predecessor list along with the pool
+            preds = IRFunction_GetPredecessors(reader->function, IRFunction_GetInstruction(reader->function, phi)->block, &predCount);
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRTextReadBody(IRTextReader* reader)
+{
+    if (!IRTextAccept(reader, '{'))
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    CHECK_PARSER_RESULT(IRTextReadLabels(reader));
+
+    while (!IRTextAccept(reader, '}')) {
+        uint32_t result = UINT32_MAX;
+        if (IRTextAccept(reader, '%')) {
+            if (!IRTextUnsigned(reader, IR_TEXT_MAX_NUMBER, &result) || !IRTextAccept(reader, '='))
+                return PARSER_ERROR_SYNTAX_ERROR;
+        }
+
+        const char* word;
+        uint32_t length;
+        if (!IRTextWord(reader, &word, &length))
+            return PARSER_ERROR_SYNTAX_ERROR;
+
+        uint32_t number;
+        if (result == UINT32_MAX && IRTextBlockNumber(word, length, &number) && IRTextAccept(reader, ':')) {
+            reader->block = reader->blocks[number];
+            continue;
+        }
+
+        CHECK_PARSER_RESULT(IRTextReadInstruction(reader, word, length, result));
+    }
+
+    return IRTextResolve(reader);
+}
+
+static ParserResult IRTextReadFunction(IRTextReader* reader)
+{
+    const char* name;
+    uint32_t length;
+    uint32_t anonymous;
+    CHECK_PARSER_RESULT(IRTextReadName(reader, &name, &length, &anonymous));
+    if (anonymous != UINT32_MAX)
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    IRGlobalId global;
+    CHECK_PARSER_RESULT(IRModule_DeclareGlobal(reader->module, name, length, IR_GLOBAL_KIND_FUNCTION, &global));
+
+    if (IRModule_GetGlobal(reader->module, global)->function)
+        return PARSER_ERROR_REDECLARATION;
+
+    reader->byteCount = 0;
+    if (!IRTextAccept(reader, '('))
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    if (!IRTextAccept(reader, ')')) {
+        do {
+            IRType type;
+            if (!IRTextType(reader, &type) || type == IR_TYPE_VOID)
+                return PARSER_ERROR_SYNTAX_ERROR;
+
+            CHECK_PARSER_RESULT(IRTextPushByte(reader, (uint8_t)type));
+        } while (IRTextAccept(reader, ','));
+
+        if (!IRTextAccept(reader, ')'))
+            return PARSER_ERROR_SYNTAX_ERROR;
+    }
+
+    IRType returnType;
+    if (!IRTextAccept(reader, '-') || reader->position >= reader->length || reader->text[reader->position] != '>')
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    reader->position++;
+    if (!IRTextType(reader, &returnType))
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    CHECK_PARSER_RESULT(IRModule_CreateFunction(reader->module, global, returnType, reader->bytes, reader->byteCount, &reader->function));
+
+    // Numbers in the text are per function
+    if (reader->values)
+        memset(reader->values, 0, sizeof(IRValueId) * reader->valueCapacity);
+    if (reader->blocks)
+        memset(reader->blocks, 0, sizeof(IRBlockId) * reader->blockCapacity);
+
+    reader->block = IR_BLOCK_NONE;
+    reader->fixupCount = 0;
+    reader->phiCount = 0;
+
+    ParserResult result = IRTextReadBody(reader);
+    if (result != PARSER_RESULT_SUCCESS)
+        IRModule_RemoveFunction(reader->module, reader->function);
+
+    reader->function = NULL;
+
+    return result;
+}
+
+static ParserResult IRTextReadData(IRTextReader* reader)
+{
+    const char* name;
+    uint32_t length;
+    uint32_t anonymous;
+    CHECK_PARSER_RESULT(IRTextReadName(reader, &name, &length, &anonymous));
+
+    IRGlobalId global = IR_GLOBAL_NONE;
+    if (anonymous == UINT32_MAX)
+        CHECK_PARSER_RESULT(IRModule_DeclareGlobal(reader->module, name, length, IR_GLOBAL_KIND_DATA, &global));
+
+    uint32_t size = 0;
+    uint32_t alignment = 0;
+    bool defined = IRTextPeek(reader, '0') || (reader->position < reader->length &&
+        reader->text[reader->position] >= '1' && reader->text[reader->position] <= '9');
+
+    if (defined && (!IRTextUnsigned(reader, UINT32_MAX, &size) || !IRTextAcceptWord(reader, "align") ||
+        !IRTextUnsigned(reader, 1u << 16, &alignment)))
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    uint32_t flags = IR_GLOBAL_FLAG_NONE;
+    for (;;) {
+        if (IRTextAcceptWord(reader, "internal"))
+            flags |= IR_GLOBAL_FLAG_INTERNAL;
+        else if (IRTextAcceptWord(reader, "constant"))
+            flags |= IR_GLOBAL_FLAG_CONSTANT;
+        else
+            break;
+    }
+
+    reader->byteCount = 0;
+    bool initialized = defined && IRTextAcceptWord(reader, "x");
+    if (initialized) {
+        if (reader->position >= reader->length || reader->text[reader->position] != '"')
+            return PARSER_ERROR_SYNTAX_ERROR;
+
+        // Two hexadecimal digits per byte
+        reader->position++;
+        while (reader->position + 1 < reader->length && reader->text[reader->position] != '"') {
+            const char digits[4] = { '0', 'x', reader->text[reader->position], reader->text[reader->position + 1] };
+            uint64_t byte;
+            if (!IRTextDigits(digits, 4, &byte))
+                return PARSER_ERROR_SYNTAX_ERROR;
+
+            CHECK_PARSER_RESULT(IRTextPushByte(reader, (uint8_t)byte));
+            reader->position += 2;
+        }
+
+        if (!IRTextAccept(reader, '"') || reader->byteCount != size)
+            return PARSER_ERROR_SYNTAX_ERROR;
+    }
+
+    if (!defined) {
+        if (anonymous != UINT32_MAX)
+            return PARSER_ERROR_SYNTAX_ERROR;
+
+        IRModule_SetGlobalFlags(reader->module, global, flags);
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    if (global != IR_GLOBAL_NONE && (IRModule_GetGlobal(reader->module, global)->flags & IR_GLOBAL_FLAG_DEFINED))
+        return PARSER_ERROR_REDECLARATION;
+
+    IRGlobalId id;
+    CHECK_PARSER_RESULT(IRModule_DefineData(reader->module, global, initialized ? reader->bytes : NULL, size, alignment, flags, &id));
+
+    if (anonymous != UINT32_MAX) {
+        CHECK_PARSER_RESULT(IRTextReserve((void**)&reader->anonymous, &reader->anonymousCapacity, anonymous + 1, sizeof(IRGlobalId)));
+        if (reader->anonymous[anonymous] != IR_GLOBAL_NONE)
+            return PARSER_ERROR_REDECLARATION;
+
+        reader->anonymous[anonymous] = id;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRTextReadModule(IRTextReader* reader)
+{
+    for (;;) {
+        IRTextSkip(reader);
+        if (reader->position >= reader->length)
+            return PARSER_RESULT_SUCCESS;
+
+        if (IRTextAcceptWord(reader, "declare")) {
+            const char* name;
+            uint32_t length;
+            uint32_t anonymous;
+            IRGlobalId global;
+            CHECK_PARSER_RESULT(IRTextReadName(reader, &name, &length, &anonymous));
+            if (anonymous != UINT32_MAX)
+                return PARSER_ERROR_SYNTAX_ERROR;
+
+            CHECK_PARSER_RESULT(IRModule_DeclareGlobal(reader->module, name, length, IR_GLOBAL_KIND_FUNCTION, &global));
+            for (;;) {
+                if (IRTextAcceptWord(reader, "internal"))
+                    IRModule_SetGlobalFlags(reader->module, global, IR_GLOBAL_FLAG_INTERNAL);
+                else if (IRTextAcceptWord(reader, "inline"))
+                    IRModule_SetGlobalFlags(reader->module, global, IR_GLOBAL_FLAG_INLINE);
+                else
+                    break;
+            }
+        }
+        else if (IRTextAcceptWord(reader, "data")) {
+            CHECK_PARSER_RESULT(IRTextReadData(reader));
+        }
+        else if (IRTextAcceptWord(reader, "define")) {
+            CHECK_PARSER_RESULT(IRTextReadFunction(reader));
+        }
+        else {
+            return PARSER_ERROR_SYNTAX_ERROR;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL IRModule_Print(
+    const IRModule module,
+    char** text,
+    size_t* length)
+{
+    if (!module || !text)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRTextBuffer buffer = { NULL, 0, 0 };
+    ParserResult result = IRTextAppend(&buffer, "");
+
+    uint32_t globalCount = IRModule_GetGlobalCount(module);
+    for (IRGlobalId global = 1; global <= globalCount && result == PARSER_RESULT_SUCCESS; global++)
+        result = IRTextPrintDeclaration(&buffer, module, global);
+
+    for (uint32_t i = 0; i < module->functionCount && result == PARSER_RESULT_SUCCESS; i++) {
+        result = IRTextAppend(&buffer, "\n");
+        if (result == PARSER_RESULT_SUCCESS)
+            result = IRTextPrintFunction(&buffer, module->functions[i]);
+    }
+
+    if (result != PARSER_RESULT_SUCCESS) {
+        if (buffer.data)
+            PARSER_FREE(buffer.data);
+        return result;
+    }
+
+    *text = buffer.data;
+    if (length)
+        *length = buffer.length;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_Print(
+    const IRFunction function,
+    char** text,
+    size_t* length)
+{
+    if (!function || !text)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRTextBuffer buffer = { NULL, 0, 0 };
+    ParserResult result = IRTextPrintFunction(&buffer, function);
+
+    if (result != PARSER_RESULT_SUCCESS) {
+        if (buffer.data)
+            PARSER_FREE(buffer.data);
+        return result;
+    }
+
+    *text = buffer.data;
+    if (length)
+        *length = buffer.length;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL IRText_Free(
+    char* text)
+{
+    if (text)
+        PARSER_FREE(text);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL IRModule_Parse(
+    IRModule module,
+    const char* text,
+    size_t length,
+    uint32_t* errorLine)
+{
+    if (!module || !text)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRTextReader reader;
+    memset(&reader, 0, sizeof(IRTextReader));
+    reader.text = text;
+    reader.length = length;
+    reader.line = 1;
+    reader.module = module;
+
+    ParserResult result = IRTextReadModule(&reader);
+    if (result != PARSER_RESULT_SUCCESS && errorLine)
+        *errorLine = reader.line;
+
+    if (reader.anonymous)
+        PARSER_FREE(reader.anonymous);
+    if (reader.values)
+        PARSER_FREE(reader.values);
+    if (reader.blocks)
+        PARSER_FREE(reader.blocks);
+    if (reader.fixups)
+        PARSER_FREE(reader.fixups);
+    if (reader.phis)
+        PARSER_FREE(reader.phis);
+    if (reader.items)
+        PARSER_FREE(reader.items);
+    if (reader.bytes)
+        PARSER_FREE(reader.bytes);
+
+    return result;
+}
+
+// ------------------------------------------------------------------------------------------------
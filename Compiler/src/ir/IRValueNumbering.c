@@ -0,0 +1,643 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ir/IRPasses.h"
+#include "ir/IRDominators.h"
+#include "IRInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define IR_GVN_SCAN_LIMIT               256u    // Available memory values a store is checked against one by one
+
+typedef enum IRObjectKind {
+    IR_OBJECT_NONE = 0,                 // Not known yet, or no pointer
+    IR_OBJECT_STACK,                    // ALLOCA
+    IR_OBJECT_GLOBAL,                   // Function or data of the module
+    IR_OBJECT_RESTRICT,                 // PARAM flagged IR_INSTRUCTION_FLAG_NOALIAS
+    IR_OBJECT_ANY,
+} IRObjectKind;
+
+/* Object a pointer points into, at a known byte offset when exact */
+typedef struct IRAddress_T {
+    int64_t offset;
+    uint32_t object;                    // Id of the ALLOCA or PARAM, IRGlobalId
+    uint8_t kind;                       // IRObjectKind
+    uint8_t exact;
+} IRAddress;
+
+/*
+ * An expression entry names the instruction that leads its class, the
+ * record is the key. A memory entry holds the value last loaded from or
+ * stored to an address with a type.
+ */
+typedef struct IRGvnEntry_T {
+    IRValueId value;
+    IRValueId address;                  // IR_VALUE_NONE for expressions
+    uint32_t next;                      // In the bucket, 0 ends it
+    uint32_t hash;
+    uint32_t slot;                      // Position on the memory stack
+    uint8_t type;
+    uint8_t killed;
+} IRGvnEntry;
+
+/* Stack tops when the walk entered a block, restored when it leaves the subtree */
+typedef struct IRGvnScope_T {
+    IRBlockId block;
+    uint32_t child;                     // Next child in the dominator tree
+    uint32_t entryTop;
+    uint32_t memoryTop;
+    uint32_t memoryFloor;               // Memory entries below are not available here
+    uint32_t killTop;
+} IRGvnScope;
+
+/*
+ * Tables have a slot per instruction record or per block record. Entries
+ * start at 1 so a bucket of 0 is empty; a scope only ever pushes to the
+ * front of buckets, so leaving it pops entries in the order they went in.
+ */
+typedef struct IRGvn_T {
+    IRFunction function;
+    IRDomTree tree;
+    uint32_t valueCount;
+    uint32_t blockCount;
+
+    IRAddress* addresses;               // Per value
+    IRGvnEntry* entries;
+    IRGvnScope* scopes;
+    uint32_t* buckets;
+    uint32_t* memory;                   // Memory entries in the order they were made
+    uint32_t* kills;                    // Memory entries killed in the current subtree
+    uint8_t* escaped;                   // Per ALLOCA or PARAM, its address is used as a plain value
+    uint32_t bucketMask;
+    uint32_t entryTop;
+    uint32_t memoryTop;
+    uint32_t killTop;
+    uint32_t scopeTop;
+} IRGvn;
+
+static const IRAddress s_IRAddressAny = { 0, 0, IR_OBJECT_ANY, 0 };
+
+static inline uint32_t IRGvnMix(uint32_t hash, uint32_t word)
+{
+    hash = (hash ^ word) * 0x9E3779B1u;
+    return hash ^ (hash >> 15);
+}
+
+static IRAddress IRGvnGetAddress(const IRGvn* gvn, IRValueId value)
+{
+    const IRInstruction* record = IRFunction_GetInstruction(gvn->function, value);
+    if (!record || record->opcode == IR_OP_UNDEF) {
+        IRAddress none;
+        memset(&none, 0, sizeof(IRAddress));
+        return none;
+    }
+
+    return value < gvn->valueCount && record->opcode != IR_OP_CONST ? gvn->addresses[value] : s_IRAddressAny;
+}
+
+static void IRGvnMeet(IRAddress* address, IRAddress other)
+{
+    if (other.kind == IR_OBJECT_NONE || address->kind == IR_OBJECT_ANY)
+        return;
+
+    if (address->kind == IR_OBJECT_NONE) {
+        *address = other;
+    }
+    else if (other.kind != address->kind || other.object != address->object || other.kind == IR_OBJECT_ANY) {
+        *address = s_IRAddressAny;
+    }
+    else if (!other.exact || other.offset != address->offset) {
+        address->exact = 0;
+        address->offset = 0;
+    }
+}
+
+static IRAddress IRGvnTransfer(const IRGvn* gvn, IRValueId id, const IRInstruction* record)
+{
+    IRAddress address;
+    memset(&address, 0, sizeof(IRAddress));
+    address.object = id;
+    address.exact = 1;
+
+    switch (record->opcode) {
+    case IR_OP_ALLOCA:
+        address.kind = IR_OBJECT_STACK;
+        return address;
+
+    case IR_OP_GLOBAL:
+        address.kind = IR_OBJECT_GLOBAL;
+        address.object = record->operands[0];
+        return address;
+
+    case IR_OP_PARAM:
+        address.kind = (record->flags & IR_INSTRUCTION_FLAG_NOALIAS) ? IR_OBJECT_RESTRICT : IR_OBJECT_ANY;
+        return address;
+
+    case IR_OP_PTRADD: {
+        address = IRGvnGetAddress(gvn, record->operands[0]);
+        const IRInstruction* offset = IRFunction_GetInstruction(gvn->function, record->operands[1]);
+        if (address.kind == IR_OBJECT_NONE || address.kind == IR_OBJECT_ANY)
+            return address;
+
+        if (offset && offset->opcode == IR_OP_CONST)
+            address.offset += (int64_t)IR_CONST_BITS(offset);
+        else
+            address.exact = 0;
+        return address;
+    }
+
+    case IR_OP_SELECT:
+        memset(&address, 0, sizeof(IRAddress));
+        IRGvnMeet(&address, IRGvnGetAddress(gvn, record->operands[1]));
+        IRGvnMeet(&address, IRGvnGetAddress(gvn, record->operands[2]));
+        return address;
+
+    case IR_OP_PHI: {
+        memset(&address, 0, sizeof(IRAddress));
+        uint32_t count;
+        const uint32_t* items = IRFunction_GetList(gvn->function, id, &count);
+        for (uint32_t i = 0; i < count; i++)
+            IRGvnMeet(&address, IRGvnGetAddress(gvn, items[i]));
+        return address;
+    }
+
+    default:
+        return s_IRAddressAny;
+    }
+}
+
+/* Find the object of every pointer, round after round in reverse postorder until no phi changes */
+static void IRGvnFindAddresses(IRGvn* gvn)
+{
+    uint32_t count;
+    const IRBlockId* order = IRDomTree_GetOrder(gvn->tree, &count);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (uint32_t i = 0; i < count; i++) {
+            IRValueId id = IRFunction_GetBlock(gvn->function, order[i])->first;
+            while (id != IR_VALUE_NONE) {
+                const IRInstruction* record = IRFunction_GetInstruction(gvn->function, id);
+                if (record->type == IR_TYPE_PTR) {
+                    IRAddress address = IRGvnTransfer(gvn, id, record);
+                    IRAddress* current = &gvn->addresses[id];
+                    if (address.kind != current->kind || address.object != current->object ||
+                        address.exact != current->exact || address.offset != current->offset) {
+                        *current = address;
+                        changed = true;
+                    }
+                }
+
+                id = record->next;
+            }
+        }
+    }
+}
+
+/* Whether a use of an address lets it out of sight, into memory, a call or an integer */
+static bool IRGvnEscapes(const IRGvn* gvn, IRValueId user, const IRInstruction* record, uint32_t slot, IRAddress address)
+{
+    switch (record->opcode) {
+    case IR_OP_LOAD:
+    case IR_OP_STORE:
+    case IR_OP_PTRADD:
+    case IR_OP_MEMZERO:
+        return slot != 0;
+    case IR_OP_MEMCOPY:
+        return slot > 1;
+    case IR_OP_PHI:
+    case IR_OP_SELECT:
+        // Merged with another object the address is lost in a pointer to anything
+        return gvn->addresses[user].kind != address.kind || gvn->addresses[user].object != address.object;
+    default:
+        return !(IROpcode_GetInfo((IROpcode)record->opcode)->flags & IR_OPCODE_FLAG_COMPARE);
+    }
+}
+
+static void IRGvnFindEscapes(IRGvn* gvn)
+{
+    uint32_t count;
+    const IRBlockId* order = IRDomTree_GetOrder(gvn->tree, &count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        IRValueId id = IRFunction_GetBlock(gvn->function, order[i])->first;
+        while (id != IR_VALUE_NONE) {
+            const IRInstruction* record = IRFunction_GetInstruction(gvn->function, id);
+            const IROpcodeInfo* info = IROpcode_GetInfo((IROpcode)record->opcode);
+
+            uint32_t listCount = 0;
+            const uint32_t* items = NULL;
+            if (record->opcode == IR_OP_PHI || record->opcode == IR_OP_CALL)
+                items = IRFunction_GetList(gvn->function, id, &listCount);
+
+            for (uint32_t slot = 0; slot < 3 + listCount; slot++) {
+                IRValueId operand;
+                if (slot < 3) {
+                    if (info->operands[slot] != IR_OPERAND_VALUE)
+                        continue;
+                    operand = record->operands[slot];
+                }
+                else {
+                    operand = items[slot - 3];
+                }
+
+                IRAddress address = IRGvnGetAddress(gvn, operand);
+                if (address.kind != IR_OBJECT_STACK && address.kind != IR_OBJECT_RESTRICT)
+                    continue;
+
+                if (IRGvnEscapes(gvn, id, record, slot, address))
+                    gvn->escaped[address.object] = 1;
+            }
+
+            id = record->next;
+        }
+    }
+}
+
+/* Object an address points into, with the escaped ones seen as anything */
+static IRAddress IRGvnGetObject(const IRGvn* gvn, IRValueId value)
+{
+    IRAddress address = IRGvnGetAddress(gvn, value);
+    if (address.kind == IR_OBJECT_NONE || (address.kind == IR_OBJECT_RESTRICT && gvn->escaped[address.object]))
+        return s_IRAddressAny;
+    return address;
+}
+
+/*
+ * Whether `size` bytes at `a` and `otherSize` bytes at `b` may overlap, a
+ * size of 0 is unknown. Distinct objects never overlap. A pointer to
+ * anything may reach any object whose address was let out, and anything
+ * but a restrict object: memory reached through a restrict parameter is
+ * not reached through a pointer the parameter is not found in.
+ */
+static bool IRGvnMayAlias(const IRGvn* gvn, IRValueId a, uint32_t size, IRValueId b, uint32_t otherSize)
+{
+    IRAddress x = IRGvnGetObject(gvn, a);
+    IRAddress y = IRGvnGetObject(gvn, b);
+
+    if (x.kind == y.kind && x.object == y.object && x.kind != IR_OBJECT_ANY) {
+        if (!x.exact || !y.exact || !size || !otherSize)
+            return true;
+        return x.offset < y.offset + (int64_t)otherSize && y.offset < x.offset + (int64_t)size;
+    }
+
+    if (x.kind == IR_OBJECT_RESTRICT || y.kind == IR_OBJECT_RESTRICT)
+        return false;
+    if (x.kind == IR_OBJECT_ANY)
+        return y.kind != IR_OBJECT_STACK || gvn->escaped[y.object];
+    if (y.kind == IR_OBJECT_ANY)
+        return x.kind != IR_OBJECT_STACK || gvn->escaped[x.object];
+
+    return false;
+}
+
+/* Whether a call may read or write the memory of an address */
+static bool IRGvnCallMayAlias(const IRGvn* gvn, IRValueId address)
+{
+    IRAddress x = IRGvnGetObject(gvn, address);
+    return x.kind != IR_OBJECT_STACK || gvn->escaped[x.object];
+}
+
+/* Instructions that compute a value from their operands alone */
+static bool IRGvnIsExpression(IROpcode opcode)
+{
+    return (opcode >= IR_OP_ADD && opcode <= IR_OP_SELECT) || opcode == IR_OP_PTRADD || opcode == IR_OP_GLOBAL ||
+        opcode == IR_OP_PHI;
+}
+
+static void IRGvnGetOperands(const IRInstruction* record, uint32_t* operands)
+{
+    memcpy(operands, record->operands, sizeof(uint32_t) * 3);
+
+    if ((IROpcode_GetInfo((IROpcode)record->opcode)->flags & IR_OPCODE_FLAG_COMMUTATIVE) && operands[0] > operands[1]) {
+        uint32_t swap = operands[0];
+        operands[0] = operands[1];
+        operands[1] = swap;
+    }
+}
+
+static uint32_t IRGvnHashExpression(const IRGvn* gvn, IRValueId id, const IRInstruction* record)
+{
+    uint32_t hash = IRGvnMix(record->opcode, record->type);
+
+    if (record->opcode == IR_OP_PHI) {
+        hash = IRGvnMix(hash, record->block);
+
+        uint32_t count;
+        const uint32_t* items = IRFunction_GetList(gvn->function, id, &count);
+        for (uint32_t i = 0; i < count; i++)
+            hash = IRGvnMix(hash, items[i]);
+        return hash;
+    }
+
+    uint32_t operands[3];
+    IRGvnGetOperands(record, operands);
+    for (uint32_t i = 0; i < 3; i++)
+        hash = IRGvnMix(hash, operands[i]);
+    return hash;
+}
+
+static bool IRGvnEqual(const IRGvn* gvn, IRValueId a, IRValueId b)
+{
+    const IRInstruction* x = IRFunction_GetInstruction(gvn->function, a);
+    const IRInstruction* y = IRFunction_GetInstruction(gvn->function, b);
+    if (x->opcode != y->opcode || x->type != y->type)
+        return false;
+
+    if (x->opcode == IR_OP_PHI) {
+        uint32_t count, otherCount;
+        const uint32_t* items = IRFunction_GetList(gvn->function, a, &count);
+        const uint32_t* otherItems = IRFunction_GetList(gvn->function, b, &otherCount);
+        return x->block == y->block && count == otherCount && !memcmp(items, otherItems, sizeof(uint32_t) * count);
+    }
+
+    uint32_t operands[3], otherOperands[3];
+    IRGvnGetOperands(x, operands);
+    IRGvnGetOperands(y, otherOperands);
+    return !memcmp(operands, otherOperands, sizeof(operands));
+}
+
+static void IRGvnPush(IRGvn* gvn, IRValueId value, IRValueId address, IRType type, uint32_t hash)
+{
+    uint32_t index = ++gvn->entryTop;
+    IRGvnEntry* entry = &gvn->entries[index];
+    entry->value = value;
+    entry->address = address;
+    entry->hash = hash;
+    entry->type = (uint8_t)type;
+    entry->killed = 0;
+    entry->slot = gvn->memoryTop;
+
+    uint32_t* bucket = &gvn->buckets[hash & gvn->bucketMask];
+    entry->next = *bucket;
+    *bucket = index;
+
+    if (address != IR_VALUE_NONE)
+        gvn->memory[gvn->memoryTop++] = index;
+}
+
+static IRValueId IRGvnFindExpression(const IRGvn* gvn, IRValueId id, uint32_t hash)
+{
+    for (uint32_t index = gvn->buckets[hash & gvn->bucketMask]; index; index = gvn->entries[index].next) {
+        const IRGvnEntry* entry = &gvn->entries[index];
+        if (entry->hash == hash && entry->address == IR_VALUE_NONE && IRGvnEqual(gvn, entry->value, id))
+            return entry->value;
+    }
+
+    return IR_VALUE_NONE;
+}
+
+static IRValueId IRGvnFindMemory(const IRGvn* gvn, const IRGvnScope* scope, IRValueId address, IRType type, uint32_t hash)
+{
+    for (uint32_t index = gvn->buckets[hash & gvn->bucketMask]; index; index = gvn->entries[index].next) {
+        // Entries of an address that were made before the latest are out of date as well
+        const IRGvnEntry* entry = &gvn->entries[index];
+        if (entry->address == address && entry->type == type)
+            return !entry->killed && entry->slot >= scope->memoryFloor ? entry->value : IR_VALUE_NONE;
+    }
+
+    return IR_VALUE_NONE;
+}
+
+/* Forget what memory held where a write may land, IR_VALUE_NONE for a call */
+static void IRGvnClobber(IRGvn* gvn, IRGvnScope* scope, IRValueId address, uint32_t size)
+{
+    if (gvn->memoryTop - scope->memoryFloor > IR_GVN_SCAN_LIMIT) {
+        scope->memoryFloor = gvn->memoryTop;
+        return;
+    }
+
+    for (uint32_t i = scope->memoryFloor; i < gvn->memoryTop; i++) {
+        IRGvnEntry* entry = &gvn->entries[gvn->memory[i]];
+        if (entry->killed)
+            continue;
+
+        bool alias = address == IR_VALUE_NONE ? IRGvnCallMayAlias(gvn, entry->address) :
+            IRGvnMayAlias(gvn, address, size, entry->address, IRType_GetSize((IRType)entry->type));
+        if (alias) {
+            entry->killed = 1;
+            gvn->kills[gvn->killTop++] = gvn->memory[i];
+        }
+    }
+}
+
+static ParserResult IRGvnReplace(IRGvn* gvn, IRValueId id, IRValueId leader, uint32_t* counter)
+{
+    CHECK_PARSER_RESULT(IRFunction_ReplaceAllUses(gvn->function, id, leader));
+    IRFunction_RemoveInstruction(gvn->function, id);
+    (*counter)++;
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* A phi whose operands are one value besides itself is that value */
+static IRValueId IRGvnTrivialPhi(const IRGvn* gvn, IRValueId id)
+{
+    uint32_t count;
+    const uint32_t* items = IRFunction_GetList(gvn->function, id, &count);
+
+    IRValueId same = IR_VALUE_NONE;
+    for (uint32_t i = 0; i < count; i++) {
+        if (items[i] == id || items[i] == same)
+            continue;
+        if (same != IR_VALUE_NONE)
+            return IR_VALUE_NONE;
+        same = items[i];
+    }
+
+    return same;
+}
+
+static ParserResult IRGvnVisitBlock(IRGvn* gvn, IRGvnScope* scope, IRPassStats* stats)
+{
+    IRFunction function = gvn->function;
+
+    IRValueId id = IRFunction_GetBlock(function, scope->block)->first;
+    while (id != IR_VALUE_NONE) {
+        const IRInstruction* record = IRFunction_GetInstruction(function, id);
+        IRValueId next = record->next;
+        IROpcode opcode = (IROpcode)record->opcode;
+        bool isVolatile = (record->flags & IR_INSTRUCTION_FLAG_VOLATILE) != 0;
+
+        if (opcode == IR_OP_PHI) {
+            IRValueId same = IRGvnTrivialPhi(gvn, id);
+            if (same != IR_VALUE_NONE) {
+                CHECK_PARSER_RESULT(IRGvnReplace(gvn, id, same, &stats->valuesMerged));
+                id = next;
+                continue;
+            }
+        }
+
+        if (IRGvnIsExpression(opcode)) {
+            uint32_t hash = IRGvnHashExpression(gvn, id, record);
+            IRValueId leader = IRGvnFindExpression(gvn, id, hash);
+            if (leader != IR_VALUE_NONE)
+                CHECK_PARSER_RESULT(IRGvnReplace(gvn, id, leader, &stats->valuesMerged));
+            else
+                IRGvnPush(gvn, id, IR_VALUE_NONE, IR_TYPE_VOID, hash);
+        }
+        else if (opcode == IR_OP_LOAD && !isVolatile) {
+            IRValueId address = record->operands[0];
+            uint32_t hash = IRGvnMix(IRGvnMix(IR_OP_LOAD, record->type), address);
+            IRValueId value = IRGvnFindMemory(gvn, scope, address, (IRType)record->type, hash);
+            if (value != IR_VALUE_NONE)
+                CHECK_PARSER_RESULT(IRGvnReplace(gvn, id, value, &stats->loadsRemoved));
+            else
+                IRGvnPush(gvn, id, address, (IRType)record->type, hash);
+        }
+        else if (opcode == IR_OP_STORE) {
+            IRValueId address = record->operands[0];
+            IRType type = (IRType)IRFunction_GetInstruction(function, record->operands[1])->type;
+            IRGvnClobber(gvn, scope, address, IRType_GetSize(type));
+
+            // What a volatile store wrote is read again, it may not be there any more
+            if (!isVolatile)
+                IRGvnPush(gvn, record->operands[1], address, type, IRGvnMix(IRGvnMix(IR_OP_LOAD, type), address));
+        }
+        else if (opcode == IR_OP_MEMCOPY) {
+            IRGvnClobber(gvn, scope, record->operands[0], record->operands[2]);
+        }
+        else if (opcode == IR_OP_MEMZERO) {
+            IRGvnClobber(gvn, scope, record->operands[0], record->operands[1]);
+        }
+        else if (opcode == IR_OP_CALL) {
+            IRGvnClobber(gvn, scope, IR_VALUE_NONE, 0);
+        }
+
+        id = next;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult IRGvnEnter(IRGvn* gvn, IRBlockId block, uint32_t memoryFloor, IRPassStats* stats)
+{
+    IRGvnScope* scope = &gvn->scopes[gvn->scopeTop++];
+    scope->block = block;
+    scope->child = 0;
+    scope->entryTop = gvn->entryTop;
+    scope->memoryTop = gvn->memoryTop;
+    scope->killTop = gvn->killTop;
+
+    // Memory is only known to hold on entry what it held at the end of the one predecessor
+    uint32_t count;
+    IRFunction_GetPredecessors(gvn->function, block, &count);
+    scope->memoryFloor = count > 1 ? gvn->memoryTop : memoryFloor;
+
+    return IRGvnVisitBlock(gvn, scope, stats);
+}
+
+static void IRGvnLeave(IRGvn* gvn)
+{
+    const IRGvnScope* scope = &gvn->scopes[--gvn->scopeTop];
+
+    while (gvn->entryTop > scope->entryTop) {
+        const IRGvnEntry* entry = &gvn->entries[gvn->entryTop--];
+        gvn->buckets[entry->hash & gvn->bucketMask] = entry->next;
+    }
+
+    while (gvn->killTop > scope->killTop)
+        gvn->entries[gvn->kills[--gvn->killTop]].killed = 0;
+
+    gvn->memoryTop = scope->memoryTop;
+}
+
+static ParserResult IRGvnRun(IRGvn* gvn, IRPassStats* stats)
+{
+    IRGvnFindAddresses(gvn);
+    IRGvnFindEscapes(gvn);
+
+    // Preorder over the dominator tree, an entry is seen by the blocks its block dominates
+    CHECK_PARSER_RESULT(IRGvnEnter(gvn, IR_BLOCK_ENTRY, 0, stats));
+    while (gvn->scopeTop) {
+        IRGvnScope* scope = &gvn->scopes[gvn->scopeTop - 1];
+
+        uint32_t count;
+        const IRBlockId* children = IRDomTree_GetChildren(gvn->tree, scope->block, &count);
+        if (scope->child < count) {
+            IRBlockId child = children[scope->child++];
+            CHECK_PARSER_RESULT(IRGvnEnter(gvn, child, scope->memoryFloor, stats));
+        }
+        else {
+            IRGvnLeave(gvn);
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL IRFunction_NumberValues(
+    IRFunction function,
+    IRPassStats* stats)
+{
+    if (!function)
+        return PARSER_ERROR_INVALID_ARG;
+
+    IRGvn gvn;
+    memset(&gvn, 0, sizeof(IRGvn));
+    gvn.function = function;
+    gvn.valueCount = IRFunction_GetInstructionCount(function);
+    gvn.blockCount = IRFunction_GetBlockCount(function);
+
+    uint32_t bucketCount = 16;
+    while (bucketCount < gvn.valueCount * 2)
+        bucketCount <<= 1;
+    gvn.bucketMask = bucketCount - 1;
+
+    // One allocation, the widest tables first
+    size_t values = gvn.valueCount;
+    size_t blocks = gvn.blockCount;
+    size_t size = sizeof(IRAddress) * values + sizeof(IRGvnEntry) * (values + 1) + sizeof(IRGvnScope) * blocks +
+        sizeof(uint32_t) * (bucketCount + values + values) + values;
+
+    uint8_t* memory = PARSER_MALLOC(size, 0);
+    if (!memory)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(memory, 0, size);
+    gvn.addresses = (IRAddress*)memory;
+    gvn.entries = (IRGvnEntry*)(gvn.addresses + values);
+    gvn.scopes = (IRGvnScope*)(gvn.entries + values + 1);
+    gvn.buckets = (uint32_t*)(gvn.scopes + blocks);
+    gvn.memory = gvn.buckets + bucketCount;
+    gvn.kills = gvn.memory + values;
+    gvn.escaped = (uint8_t*)(gvn.kills + values);
+
+    IRFunctionStats before;
+    IRFunction_GetStats(function, &before);
+
+    IRPassStats local;
+    memset(&local, 0, sizeof(IRPassStats));
+
+    ParserResult result = CreateIRDomTree(function, &gvn.tree);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRGvnRun(&gvn, &local);
+    if (result == PARSER_RESULT_SUCCESS && !IRFunction_IsCompact(function))
+        result = IRFunction_Compact(function);
+
+    if (gvn.tree)
+        IRDomTreeDestroy(gvn.tree);
+    PARSER_FREE(memory);
+
+    if (stats) {
+        IRFunctionStats after;
+        IRFunction_GetStats(function, &after);
+
+        stats->instructionsRemoved += before.instructions - after.instructions;
+        stats->blocksRemoved += before.blocks - after.blocks;
+        stats->valuesMerged += local.valuesMerged;
+        stats->loadsRemoved += local.loadsRemoved;
+    }
+
+    return result;
+}
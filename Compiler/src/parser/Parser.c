@@ -0,0 +1,540 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserInternal.h"
+#include "ParserArray.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const struct LexerToken_T g_ParserNoMemoryToken = {
+    .lexeme = "",
+    .flags = TOKEN_TYPE_ERROR,
+};
+
+// ===== PARSER INTERNALS =====
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParserError(
+    ASTParser parser,
+    ParserResult error)
+{
+    return ASTParserErrorAt(parser, error, ASTParserTokenIndex(parser));
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParserErrorAt(
+    ASTParser parser,
+    ParserResult error,
+    uint32_t token)
+{
+    if (parser->error == PARSER_RESULT_SUCCESS) {
+        parser->error = error;
+        parser->errorToken = token;
+    }
+
+    return error;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParserAdvance(
+    ASTParser parser)
+{
+    LexerToken token;
+    ParserResult result = LexerNextToken(parser->lexer, &token);
+    if (result != PARSER_RESULT_SUCCESS) {
+        // The error token is consumed, report it where it was
+        if (parser->error == PARSER_RESULT_SUCCESS) {
+            parser->error = result;
+            parser->errorToken = ASTParserTokenIndex(parser) - (token ? 1 : 0);
+        }
+        return result;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParserExpectPunctuation(
+    ASTParser parser,
+    uint32_t punctuation,
+    ParserResult error)
+{
+    if (!ASTParserIsPunctuation(ASTParserPeek(parser), punctuation))
+        return ASTParserError(parser, error);
+
+    return ASTParserAdvance(parser);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParserScratchPush(
+    ASTParser parser,
+    uint32_t value)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&parser->scratch, &parser->scratchCapacity, parser->scratchCount,
+        parser->scratchCount + 1, sizeof(uint32_t), 256));
+
+    parser->scratch[parser->scratchCount++] = value;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParserAddScratchList(
+    ASTParser parser,
+    uint32_t base,
+    ParserASTNodeType type,
+    uint16_t subtype,
+    uint32_t mainToken,
+    ASTNodeId* id)
+{
+    ParserResult result = ASTTree_AddListNode(parser->tree, type, subtype, mainToken,
+        parser->scratch + base, parser->scratchCount - base, id);
+
+    parser->scratchCount = base;
+
+    return result;
+}
+
+// ===== FUNCTION BODIES =====
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParserSkipFunctionBody(
+    ASTParser parser,
+    ASTNodeId function)
+{
+    uint32_t open = ASTParserTokenIndex(parser);
+    uint32_t depth = 0;
+
+    // Only braces are looked at, whatever is between them is left to the
+    // parse on demand, including errors
+    for (;;) {
+        const struct LexerToken_T* token = ASTParserPeek(parser);
+
+        if (token->flags == TOKEN_TYPE_PUNCTUATION) {
+            if (token->value == PUNCTUATION_LBRACE)
+                depth++;
+            else if (token->value == PUNCTUATION_RBRACE && --depth == 0)
+                break;
+        }
+        else if (token->flags == TOKEN_TYPE_EOF) {
+            return ASTParserErrorAt(parser, PARSER_ERROR_UNCLOSED_BRACE, open);
+        }
+
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+
+    uint32_t close = ASTParserTokenIndex(parser);
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    if (ParserArrayReserve((void**)&parser->lazyBodies, &parser->lazyBodyCapacity, parser->lazyBodyCount,
+            parser->lazyBodyCount + 1, sizeof(ASTParserLazyBody), 256) != PARSER_RESULT_SUCCESS)
+        return ASTParserError(parser, PARSER_ERROR_NO_MEMORY);
+
+    // Definitions come in node order, the table stays sorted
+    ASTParserLazyBody* body = &parser->lazyBodies[parser->lazyBodyCount++];
+    body->function = function;
+    body->open = open;
+    body->close = close;
+
+    parser->stats.skippedBodies++;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR const ASTParserLazyBody* PARSER_CALL ASTParserFindLazyBody(
+    const ASTParser parser,
+    ASTNodeId function)
+{
+    uint32_t low = 0;
+    uint32_t high = parser->lazyBodyCount;
+
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (parser->lazyBodies[middle].function < function)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if (low < parser->lazyBodyCount && parser->lazyBodies[low].function == function)
+        return &parser->lazyBodies[low];
+
+    return NULL;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParserParseBody(
+    ASTParser parser,
+    ASTNodeId function,
+    ASTNodeId* body)
+{
+    *body = AST_NODE_ID_NONE;
+
+    if (parser->module) {
+        // The checkpoint keeps the tokens of the body until it is lowered
+        LexerCheckpoint open;
+        CHECK_PARSER_RESULT(LexerMark(parser->lexer, &open));
+
+        uint32_t nodes = ASTTree_GetNodeCount(parser->tree);
+        uint32_t tags = parser->tagBodyCount;
+        uint32_t base = parser->scratchCount;
+        ParserResult error = parser->error;
+        uint32_t errorToken = parser->errorToken;
+
+        IRFunction ir = NULL;
+        ParserResult result = parser->strategy->lowerFunctionBody(parser, AST_NODE_FROM_ID(function), &ir);
+
+        if (result != PARSER_ERROR_UNSUPPORTED) {
+            LexerReleaseMark(parser->lexer, &open);
+            CHECK_PARSER_RESULT(result);
+
+            result = ParserArrayReserve((void**)&parser->loweredBodies, &parser->loweredBodyCapacity,
+                parser->loweredBodyCount, parser->loweredBodyCount + 1, sizeof(ASTParserLoweredBody), 64);
+            if (result != PARSER_RESULT_SUCCESS)
+                return ASTParserError(parser, result);
+
+            // Definitions come in node order, the table stays sorted
+            ASTParserLoweredBody* lowered = &parser->loweredBodies[parser->loweredBodyCount++];
+            lowered->function = function;
+            lowered->ir = ir;
+
+            parser->stats.loweredBodies++;
+
+            return PARSER_RESULT_SUCCESS;
+        }
+
+        // Nothing of the attempt stays but the symbols of its closed scopes.
+        // An error it ran into is found again by the parse.
+        CHECK_PARSER_RESULT(LexerRewind(parser->lexer, &open));
+        ASTTree_Truncate(parser->tree, nodes);
+        parser->tagBodyCount = tags;
+        parser->scratchCount = base;
+        parser->error = error;
+        parser->errorToken = errorToken;
+        parser->stats.fallbackBodies++;
+    }
+
+    ASTNode parsed = NULL;
+    CHECK_PARSER_RESULT(parser->strategy->parseFunctionBody(parser, AST_NODE_FROM_ID(function), &parsed));
+
+    *body = AST_NODE_TO_ID(parsed);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR const ASTParserLoweredBody* PARSER_CALL ASTParserFindLoweredBody(
+    const ASTParser parser,
+    ASTNodeId function)
+{
+    uint32_t low = 0;
+    uint32_t high = parser->loweredBodyCount;
+
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (parser->loweredBodies[middle].function < function)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if (low < parser->loweredBodyCount && parser->loweredBodies[low].function == function)
+        return &parser->loweredBodies[low];
+
+    return NULL;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParserAddTagBody(
+    ASTParser parser,
+    uint32_t tag,
+    ASTNodeId node)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&parser->tagBodies, &parser->tagBodyCapacity, parser->tagBodyCount,
+        parser->tagBodyCount + 1, sizeof(ASTParserTagBody), 64));
+
+    // A nested tag ends before the one around it, its body comes first
+    uint32_t index = parser->tagBodyCount++;
+    while (index > 0 && parser->tagBodies[index - 1].tag > tag) {
+        parser->tagBodies[index] = parser->tagBodies[index - 1];
+        index--;
+    }
+
+    parser->tagBodies[index].tag = tag;
+    parser->tagBodies[index].node = node;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ASTNodeId PARSER_CALL ASTParserFindTagBody(
+    const ASTParser parser,
+    uint32_t tag)
+{
+    uint32_t low = 0;
+    uint32_t high = parser->tagBodyCount;
+
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (parser->tagBodies[middle].tag < tag)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if (low < parser->tagBodyCount && parser->tagBodies[low].tag == tag)
+        return parser->tagBodies[low].node;
+
+    return AST_NODE_ID_NONE;
+}
+
+// ===== PARSER =====
+
+PARSER_ATTR ParserResult PARSER_CALL CreateASTParser(
+    Lexer lexer,
+    const ASTParserCreateConfig* cfg,
+    ASTParser* parser)
+{
+    if (!cfg || !parser)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (!cfg->strategy)
+        return PARSER_ERROR_INVALID_STRATEGY;
+
+    ASTParser hdl = PARSER_MALLOC(sizeof(struct ASTParser_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ASTParser_T));
+
+    // The arena takes its chunks straight from the heap callbacks, so it
+    // can itself be installed as g_parser_allocator_callbacks
+    ParserArenaConfig arenaConfig = { 0 };
+    arenaConfig.chunkSize = cfg->arenaChunkSize;
+
+    ParserResult result = ParserArena_Create(&arenaConfig, &hdl->arena);
+    if (result != PARSER_RESULT_SUCCESS) {
+        PARSER_FREE(hdl);
+        return result;
+    }
+
+    result = CreateASTTree(0, &hdl->tree);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = CreateParserInterner(hdl->arena, &hdl->interner);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = CreateASTSymbolTable(hdl->interner, &hdl->symbols);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = CreateASTTypeTable(&hdl->types);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = ASTSymbolTable_PushScope(hdl->symbols, AST_SCOPE_KIND_FILE, NULL);
+    if (result != PARSER_RESULT_SUCCESS) {
+        ASTParserDestroy(hdl);
+        return result;
+    }
+
+    hdl->lexer = lexer;
+    hdl->strategy = cfg->strategy;
+    hdl->module = cfg->strategy->lowerFunctionBody ? cfg->module : NULL;
+    hdl->lazyFunctionBodies = cfg->lazyFunctionBodies && !hdl->module;
+    hdl->keepTokens = cfg->keepTokens;
+
+    *parser = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL ASTParser_Init(
+    ASTParser parser,
+    Lexer lexer)
+{
+    if (!parser)
+        return;
+
+    // New translation unit, everything of the previous one goes at once
+    ParserArena_Reset(parser->arena);
+    ASTTree_Reset(parser->tree);
+    ASTSymbolTable_Reset(parser->symbols);
+    ParserInterner_Reset(parser->interner);
+    ASTTypeTable_Reset(parser->types);
+    // Storage was reserved on create, the file scope cannot fail
+    ASTSymbolTable_PushScope(parser->symbols, AST_SCOPE_KIND_FILE, NULL);
+    parser->lexer = lexer;
+    parser->scratchCount = 0;
+    parser->lazyBodyCount = 0;
+    parser->loweredBodyCount = 0;
+    parser->tagBodyCount = 0;
+    parser->pendingLabels = 0;
+    memset(&parser->stats, 0, sizeof(parser->stats));
+    parser->error = PARSER_RESULT_SUCCESS;
+    parser->errorToken = 0;
+}
+
+PARSER_ATTR ParserArena PARSER_CALL ASTParser_GetArena(
+    const ASTParser parser)
+{
+    return parser ? parser->arena : NULL;
+}
+
+PARSER_ATTR ASTTree PARSER_CALL ASTParser_GetTree(
+    const ASTParser parser)
+{
+    return parser ? parser->tree : NULL;
+}
+
+PARSER_ATTR ParserInterner PARSER_CALL ASTParser_GetInterner(
+    const ASTParser parser)
+{
+    return parser ? parser->interner : NULL;
+}
+
+PARSER_ATTR ASTSymbolTable PARSER_CALL ASTParser_GetSymbolTable(
+    const ASTParser parser)
+{
+    return parser ? parser->symbols : NULL;
+}
+
+PARSER_ATTR ASTTypeTable PARSER_CALL ASTParser_GetTypeTable(
+    const ASTParser parser)
+{
+    return parser ? parser->types : NULL;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_Parse(
+    ASTParser parser,
+    ASTNode* node)
+{
+    if (!parser || !node)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (!parser->strategy->parseDeclaration)
+        return PARSER_ERROR_INVALID_STRATEGY;
+
+    // Skipped bodies are read again later, the checkpoint keeps their
+    // tokens in the lexer
+    if (parser->lazyFunctionBodies || parser->keepTokens)
+        CHECK_PARSER_RESULT(LexerMark(parser->lexer, &parser->unitStart));
+
+    uint32_t first = ASTParserTokenIndex(parser);
+    uint32_t base = parser->scratchCount;
+
+    while (ASTParserPeek(parser)->flags != TOKEN_TYPE_EOF) {
+        ASTNode declaration;
+        ParserResult result = parser->strategy->parseDeclaration(parser, &declaration);
+        if (result != PARSER_RESULT_SUCCESS) {
+            parser->scratchCount = base;
+            return result;
+        }
+    }
+
+    ASTNodeId id;
+    CHECK_PARSER_RESULT(ASTParserAddScratchList(parser, base, AST_NODE_TYPE_TRANSLATION_UNIT, 0, first, &id));
+
+    *node = AST_NODE_FROM_ID(id);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_ParseFunctionBody(
+    ASTParser parser,
+    ASTNode function,
+    ASTNode* body)
+{
+    if (!parser || !function || !body)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeId id = AST_NODE_TO_ID(function);
+    if (ASTTree_GetNodeType(parser->tree, id) != AST_NODE_TYPE_FUNCTION_DECL)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeId existing = ASTTree_GetChild(parser->tree, id, 1);
+    if (existing != AST_NODE_ID_NONE) {
+        *body = AST_NODE_FROM_ID(existing);
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    const ASTParserLazyBody* lazy = ASTParserFindLazyBody(parser, id);
+    if (!lazy)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (!parser->strategy->parseFunctionBody)
+        return PARSER_ERROR_INVALID_STRATEGY;
+
+    uint32_t resume = ASTParserTokenIndex(parser);
+    CHECK_PARSER_RESULT(LexerSeek(parser->lexer, lazy->open));
+
+    ASTNode parsed = NULL;
+    ParserResult result = parser->strategy->parseFunctionBody(parser, function, &parsed);
+
+    LexerSeek(parser->lexer, resume);
+    CHECK_PARSER_RESULT(result);
+
+    CHECK_PARSER_RESULT(ASTTree_SetChild(parser->tree, id, 1, AST_NODE_TO_ID(parsed)));
+    parser->stats.parsedBodies++;
+
+    *body = parsed;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR IRFunction PARSER_CALL ASTParser_GetFunctionIR(
+    const ASTParser parser,
+    ASTNode function)
+{
+    if (!parser)
+        return NULL;
+
+    const ASTParserLoweredBody* lowered = ASTParserFindLoweredBody(parser, AST_NODE_TO_ID(function));
+    return lowered ? lowered->ir : NULL;
+}
+
+PARSER_ATTR void PARSER_CALL ASTParser_GetStats(
+    const ASTParser parser,
+    ASTParserStats* stats)
+{
+    if (!parser || !stats)
+        return;
+
+    *stats = parser->stats;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_ParseExpression(
+    ASTParser parser,
+    int precedence,
+    ASTNode* node)
+{
+    if (!parser || !node)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (!parser->strategy->parseBinaryOp)
+        return PARSER_ERROR_INVALID_STRATEGY;
+
+    return parser->strategy->parseBinaryOp(parser, NULL, precedence, node);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_GetError(
+    const ASTParser parser,
+    uint32_t* token)
+{
+    if (!parser)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (token)
+        *token = parser->errorToken;
+
+    return parser->error;
+}
+
+PARSER_ATTR void PARSER_CALL ASTParserDestroy(
+    ASTParser parser)
+{
+    if (!parser)
+        return;
+
+    ASTTypeTableDestroy(parser->types);
+    ASTSymbolTableDestroy(parser->symbols);
+    ParserInternerDestroy(parser->interner);
+    ASTTreeDestroy(parser->tree);
+    PARSER_FREE(parser->scratch);
+    PARSER_FREE(parser->lazyBodies);
+    PARSER_FREE(parser->loweredBodies);
+    PARSER_FREE(parser->tagBodies);
+    ParserArena_Destroy(parser->arena);
+
+    PARSER_FREE(parser);
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,795 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserAST.h"
+#include "ParserArray.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/* Data of a parent node replaced through an overlay */
+typedef struct ASTTreePatch_T {
+    ASTNodeId id;
+    ASTNodeData data;
+} ASTTreePatch;
+
+struct ASTTree_T {
+    // ===== Nodes, parallel arrays indexed by ASTNodeId - base =====
+    uint8_t* types;
+    uint16_t* subtypes;
+    uint32_t* mainTokens;
+    ASTNodeData* data;
+    uint32_t count;
+    uint32_t capacity;
+
+    // ===== Extra data =====
+    uint32_t* extra;
+    uint32_t extraCount;
+    uint32_t extraCapacity;
+
+    // ===== Overlay =====
+    const struct ASTTree_T* parent; // Read-only tree below the overlay, NULL otherwise
+    uint32_t base;                  // Id of the first own node, the node count of the parent
+    ASTTreePatch* patches;          // Data written to parent nodes, in write order
+    uint32_t patchCount;
+    uint32_t patchCapacity;
+    uint32_t* patchSlots;           // Newest patch of a node + 1 by hashed id, 0 when empty
+    uint32_t patchSlotMask;
+};
+
+typedef struct ASTNodeTypeInfo_T {
+    uint8_t layout;                 // ASTNodeLayout
+    uint8_t fixedChildren;          // Children of AST_NODE_LAYOUT_FIXED types
+    uint8_t lhs;                    // ASTNodePayload of data.lhs when it is no child
+    uint8_t rhs;                    // ASTNodePayload of data.rhs when it is no child
+} ASTNodeTypeInfo;
+
+static const ASTNodeTypeInfo s_ASTNodeTypeInfo[AST_NODE_TYPE_COUNT] = {
+    [AST_NODE_TYPE_NONE]                 = { AST_NODE_LAYOUT_LEAF, 0 },
+
+    // ===== Declarations =====
+    [AST_NODE_TYPE_TRANSLATION_UNIT]     = { AST_NODE_LAYOUT_LIST, 0 },         // declarations
+    [AST_NODE_TYPE_FUNCTION_DECL]        = { AST_NODE_LAYOUT_FIXED, 2, AST_NODE_PAYLOAD_VALUE, AST_NODE_PAYLOAD_SYMBOL }, // parameters, body, rhs is the symbol
+    [AST_NODE_TYPE_VARIABLE_DECL]        = { AST_NODE_LAYOUT_UNARY, 0, AST_NODE_PAYLOAD_VALUE, AST_NODE_PAYLOAD_SYMBOL }, // initializer, rhs is the symbol
+    [AST_NODE_TYPE_PARAMETER_DECL]       = { AST_NODE_LAYOUT_LEAF, 0, AST_NODE_PAYLOAD_TYPE, AST_NODE_PAYLOAD_SYMBOL }, // lhs is the type, rhs the symbol
+    [AST_NODE_TYPE_STRUCT_DECL]          = { AST_NODE_LAYOUT_LIST, 0 },         // members
+    [AST_NODE_TYPE_UNION_DECL]           = { AST_NODE_LAYOUT_LIST, 0 },         // members
+    [AST_NODE_TYPE_ENUM_DECL]            = { AST_NODE_LAYOUT_LIST, 0 },         // enumerators
+    [AST_NODE_TYPE_TYPEDEF_DECL]         = { AST_NODE_LAYOUT_LEAF, 0, AST_NODE_PAYLOAD_TYPE, AST_NODE_PAYLOAD_SYMBOL }, // lhs is the type, rhs the symbol
+
+    // ===== Type Specifiers =====
+    [AST_NODE_TYPE_TYPE_SPECIFIER]       = { AST_NODE_LAYOUT_LEAF, 0, AST_NODE_PAYLOAD_TYPE, AST_NODE_PAYLOAD_VALUE }, // lhs is the interned type
+    [AST_NODE_TYPE_POINTER_TYPE]         = { AST_NODE_LAYOUT_UNARY, 0 },        // pointee
+    [AST_NODE_TYPE_ARRAY_TYPE]           = { AST_NODE_LAYOUT_BINARY, 0 },       // element, size
+    [AST_NODE_TYPE_FUNCTION_TYPE]        = { AST_NODE_LAYOUT_LIST, 0 },         // parameters
+
+    // ===== Statements =====
+    [AST_NODE_TYPE_COMPOUND_STMT]        = { AST_NODE_LAYOUT_LIST, 0 },         // items
+    [AST_NODE_TYPE_EXPRESSION_STMT]      = { AST_NODE_LAYOUT_UNARY, 0 },        // expression
+    [AST_NODE_TYPE_RETURN_STMT]          = { AST_NODE_LAYOUT_UNARY, 0 },        // value
+    [AST_NODE_TYPE_IF_STMT]              = { AST_NODE_LAYOUT_FIXED, 3 },        // condition, then, else
+    [AST_NODE_TYPE_WHILE_STMT]           = { AST_NODE_LAYOUT_BINARY, 0 },       // condition, body
+    [AST_NODE_TYPE_DO_WHILE_STMT]        = { AST_NODE_LAYOUT_BINARY, 0 },       // body, condition
+    [AST_NODE_TYPE_FOR_STMT]             = { AST_NODE_LAYOUT_FIXED, 4 },        // init, condition, step, body
+    [AST_NODE_TYPE_SWITCH_STMT]          = { AST_NODE_LAYOUT_BINARY, 0 },       // condition, body
+    [AST_NODE_TYPE_CASE_STMT]            = { AST_NODE_LAYOUT_BINARY, 0 },       // value, statement
+    [AST_NODE_TYPE_DEFAULT_STMT]         = { AST_NODE_LAYOUT_UNARY, 0 },        // statement
+    [AST_NODE_TYPE_BREAK_STMT]           = { AST_NODE_LAYOUT_LEAF, 0 },
+    [AST_NODE_TYPE_CONTINUE_STMT]        = { AST_NODE_LAYOUT_LEAF, 0 },
+    [AST_NODE_TYPE_GOTO_STMT]            = { AST_NODE_LAYOUT_LEAF, 0, AST_NODE_PAYLOAD_VALUE, AST_NODE_PAYLOAD_SYMBOL }, // lhs is the name, rhs the label
+    [AST_NODE_TYPE_LABEL_STMT]           = { AST_NODE_LAYOUT_UNARY, 0, AST_NODE_PAYLOAD_VALUE, AST_NODE_PAYLOAD_SYMBOL }, // statement, rhs is the label
+
+    // ===== Expressions =====
+    [AST_NODE_TYPE_BINARY_EXPR]          = { AST_NODE_LAYOUT_BINARY, 0 },       // left, right
+    [AST_NODE_TYPE_UNARY_EXPR]           = { AST_NODE_LAYOUT_UNARY, 0 },        // operand
+    [AST_NODE_TYPE_TERNARY_EXPR]         = { AST_NODE_LAYOUT_FIXED, 3 },        // condition, then, else
+    [AST_NODE_TYPE_CALL_EXPR]            = { AST_NODE_LAYOUT_LIST, 0 },         // callee, arguments
+    [AST_NODE_TYPE_CAST_EXPR]            = { AST_NODE_LAYOUT_BINARY, 0 },       // type, operand
+    [AST_NODE_TYPE_ASSIGNMENT_EXPR]      = { AST_NODE_LAYOUT_BINARY, 0 },       // target, value
+    [AST_NODE_TYPE_MEMBER_EXPR]          = { AST_NODE_LAYOUT_UNARY, 0 },        // object
+    [AST_NODE_TYPE_ARROW_EXPR]           = { AST_NODE_LAYOUT_UNARY, 0 },        // pointer
+    [AST_NODE_TYPE_ARRAY_SUBSCRIPT_EXPR] = { AST_NODE_LAYOUT_BINARY, 0 },       // array, index
+    [AST_NODE_TYPE_SIZEOF_EXPR]          = { AST_NODE_LAYOUT_UNARY, 0 },        // operand or type
+    [AST_NODE_TYPE_COMMA_EXPR]           = { AST_NODE_LAYOUT_LIST, 0 },         // operands
+
+    // ===== Literals & Identifiers =====
+    [AST_NODE_TYPE_INTEGER_LITERAL]      = { AST_NODE_LAYOUT_LEAF, 0 },         // literal index, or the folded value
+    [AST_NODE_TYPE_FLOAT_LITERAL]        = { AST_NODE_LAYOUT_LEAF, 0 },
+    [AST_NODE_TYPE_STRING_LITERAL]       = { AST_NODE_LAYOUT_LEAF, 0 },
+    [AST_NODE_TYPE_CHAR_LITERAL]         = { AST_NODE_LAYOUT_LEAF, 0 },
+    [AST_NODE_TYPE_IDENTIFIER]           = { AST_NODE_LAYOUT_LEAF, 0, AST_NODE_PAYLOAD_VALUE, AST_NODE_PAYLOAD_SYMBOL }, // lhs is the name, rhs the symbol
+
+    // ===== Initialization =====
+    [AST_NODE_TYPE_INITIALIZER]          = { AST_NODE_LAYOUT_BINARY, 0 },       // designator, value
+    [AST_NODE_TYPE_INITIALIZER_LIST]     = { AST_NODE_LAYOUT_LIST, 0 },         // elements
+
+    // ===== Preprocessor =====
+    [AST_NODE_TYPE_MACRO_EXPANSION]      = { AST_NODE_LAYOUT_LEAF, 0 },
+};
+
+/* Grow every node array to `capacity`, keeping the nodes */
+static ParserResult ASTTreeGrowNodes(ASTTree tree, uint32_t capacity)
+{
+    uint8_t* types = PARSER_MALLOC(sizeof(uint8_t) * capacity, 0);
+    uint16_t* subtypes = PARSER_MALLOC(sizeof(uint16_t) * capacity, 0);
+    uint32_t* mainTokens = PARSER_MALLOC(sizeof(uint32_t) * capacity, 0);
+    ASTNodeData* data = PARSER_MALLOC(sizeof(ASTNodeData) * capacity, 0);
+
+    if (!types || !subtypes || !mainTokens || !data) {
+        PARSER_FREE(types);
+        PARSER_FREE(subtypes);
+        PARSER_FREE(mainTokens);
+        PARSER_FREE(data);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    if (tree->count) {
+        memcpy(types, tree->types, sizeof(uint8_t) * tree->count);
+        memcpy(subtypes, tree->subtypes, sizeof(uint16_t) * tree->count);
+        memcpy(mainTokens, tree->mainTokens, sizeof(uint32_t) * tree->count);
+        memcpy(data, tree->data, sizeof(ASTNodeData) * tree->count);
+    }
+
+    PARSER_FREE(tree->types);
+    PARSER_FREE(tree->subtypes);
+    PARSER_FREE(tree->mainTokens);
+    PARSER_FREE(tree->data);
+
+    tree->types = types;
+    tree->subtypes = subtypes;
+    tree->mainTokens = mainTokens;
+    tree->data = data;
+    tree->capacity = capacity;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Node 0 is the none node, so a zeroed id or child slot means no node */
+static void ASTTreeAddNoneNode(ASTTree tree)
+{
+    tree->types[0] = AST_NODE_TYPE_NONE;
+    tree->subtypes[0] = 0;
+    tree->mainTokens[0] = 0;
+    tree->data[0].lhs = 0;
+    tree->data[0].rhs = 0;
+    tree->count = 1;
+}
+
+/* Tree storing node `id`, and the index of the node in its arrays */
+static const struct ASTTree_T* ASTTreeFind(const struct ASTTree_T* tree, ASTNodeId id, uint32_t* index)
+{
+    while (id < tree->base)
+        tree = tree->parent;
+
+    *index = id - tree->base;
+
+    return *index < tree->count ? tree : NULL;
+}
+
+/* Slot holding the newest patch of node `id`, or the empty slot it would go in */
+static uint32_t* ASTTreePatchProbe(const struct ASTTree_T* tree, ASTNodeId id)
+{
+    uint32_t hash = id * 0x9E3779B1u;
+    uint32_t i = (hash ^ (hash >> 15)) & tree->patchSlotMask;
+
+    for (;;) {
+        uint32_t* slot = &tree->patchSlots[i];
+        if (*slot == 0 || tree->patches[*slot - 1].id == id)
+            return slot;
+
+        i = (i + 1) & tree->patchSlotMask;
+    }
+}
+
+/* Index the patches in `slotCount` slots, later patches of a node replace earlier ones */
+static ParserResult ASTTreeRehashPatches(ASTTree tree, uint32_t slotCount)
+{
+    uint32_t* slots = PARSER_MALLOC(sizeof(uint32_t) * slotCount, 0);
+    if (!slots)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(slots, 0, sizeof(uint32_t) * slotCount);
+
+    PARSER_FREE(tree->patchSlots);
+    tree->patchSlots = slots;
+    tree->patchSlotMask = slotCount - 1;
+
+    for (uint32_t i = 0; i < tree->patchCount; i++)
+        *ASTTreePatchProbe(tree, tree->patches[i].id) = i + 1;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Data of node `id`, as replaced by the newest patch of an overlay on the way */
+static const ASTNodeData* ASTTreeFindData(const struct ASTTree_T* tree, ASTNodeId id)
+{
+    while (id < tree->base) {
+        if (tree->patchCount) {
+            uint32_t patch = *ASTTreePatchProbe(tree, id);
+            if (patch)
+                return &tree->patches[patch - 1].data;
+        }
+        tree = tree->parent;
+    }
+
+    return id - tree->base < tree->count ? &tree->data[id - tree->base] : NULL;
+}
+
+/* Record new data for a node of the parent, newer patches win */
+static ParserResult ASTTreeAddPatch(ASTTree tree, ASTNodeId id, ASTNodeData data)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&tree->patches, &tree->patchCapacity, tree->patchCount,
+        tree->patchCount + 1, sizeof(ASTTreePatch), 256));
+
+    // Every lookup of a parent node probes, twice as many slots as patches keeps that short
+    if (tree->patchSlotMask + 1 < tree->patchCapacity * 2) {
+        if (tree->patchCapacity > UINT32_MAX / 4)
+            return PARSER_ERROR_NO_MEMORY;
+
+        CHECK_PARSER_RESULT(ASTTreeRehashPatches(tree, tree->patchCapacity * 2));
+    }
+
+    tree->patches[tree->patchCount].id = id;
+    tree->patches[tree->patchCount].data = data;
+    tree->patchCount++;
+
+    *ASTTreePatchProbe(tree, id) = tree->patchCount;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Nodes and child lists of an overlay being merged, and where they go */
+typedef struct ASTTreeMergeRange_T {
+    uint32_t first;                 // First merged node id of the overlay
+    uint32_t end;
+    uint32_t target;                // Id of the first merged node in the target
+    uint32_t extraFirst;            // First merged extra index of the overlay
+    uint32_t extraTarget;
+    const ASTTreeMergeMap* map;
+} ASTTreeMergeRange;
+
+/* Target of a node id, ids of the parent stay */
+static inline uint32_t ASTTreeMergeNode(const ASTTreeMergeRange* range, uint32_t id)
+{
+    return (id >= range->first && id < range->end) ? id - range->first + range->target : id;
+}
+
+static inline uint32_t ASTTreeMergePayload(const ASTTreeMergeRange* range, uint32_t value, uint32_t payload)
+{
+    const ASTTreeMergeMap* map = range->map;
+
+    switch (payload) {
+    case AST_NODE_PAYLOAD_SYMBOL:
+        if (value >= map->symbolFirst && value < map->symbolEnd)
+            return value - map->symbolFirst + map->symbolTarget;
+        return value;
+    case AST_NODE_PAYLOAD_TYPE:
+        if (value >= map->typeFirst && value < map->typeEnd)
+            return map->types[value - map->typeFirst];
+        return value;
+    default:
+        return value;
+    }
+}
+
+/* Data of a merged node, or of a parent node patched by the overlay when `own` is false */
+static ASTNodeData ASTTreeMergeData(const ASTTreeMergeRange* range, uint8_t type, ASTNodeData data, bool own)
+{
+    const ASTNodeTypeInfo* info = &s_ASTNodeTypeInfo[type];
+
+    switch (info->layout) {
+    case AST_NODE_LAYOUT_LEAF:
+        data.lhs = ASTTreeMergePayload(range, data.lhs, info->lhs);
+        data.rhs = ASTTreeMergePayload(range, data.rhs, info->rhs);
+        break;
+    case AST_NODE_LAYOUT_UNARY:
+        data.lhs = ASTTreeMergeNode(range, data.lhs);
+        data.rhs = ASTTreeMergePayload(range, data.rhs, info->rhs);
+        break;
+    case AST_NODE_LAYOUT_BINARY:
+        data.lhs = ASTTreeMergeNode(range, data.lhs);
+        data.rhs = ASTTreeMergeNode(range, data.rhs);
+        break;
+    case AST_NODE_LAYOUT_LIST:
+    case AST_NODE_LAYOUT_FIXED:
+        // Child lists of parent nodes stay where they are
+        if (own)
+            data.lhs = data.lhs - range->extraFirst + range->extraTarget;
+        if (info->layout == AST_NODE_LAYOUT_FIXED)
+            data.rhs = ASTTreeMergePayload(range, data.rhs, info->rhs);
+        break;
+    }
+
+    return data;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateASTTree(
+    uint32_t capacity,
+    ASTTree* tree)
+{
+    if (!tree)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTree hdl = PARSER_MALLOC(sizeof(struct ASTTree_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ASTTree_T));
+
+    ParserResult result = ASTTreeGrowNodes(hdl, capacity > 1 ? capacity : AST_TREE_INITIAL_CAPACITY);
+    if (result != PARSER_RESULT_SUCCESS) {
+        PARSER_FREE(hdl);
+        return result;
+    }
+
+    ASTTreeAddNoneNode(hdl);
+
+    *tree = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL CreateASTTreeOverlay(
+    const ASTTree parent,
+    uint32_t capacity,
+    ASTTree* tree)
+{
+    if (!parent || !tree)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTree hdl = PARSER_MALLOC(sizeof(struct ASTTree_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ASTTree_T));
+
+    ParserResult result = ASTTreeGrowNodes(hdl, capacity ? capacity : AST_TREE_INITIAL_CAPACITY);
+    if (result != PARSER_RESULT_SUCCESS) {
+        PARSER_FREE(hdl);
+        return result;
+    }
+
+    hdl->parent = parent;
+    hdl->base = parent->base + parent->count;
+
+    *tree = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL ASTTreeDestroy(
+    ASTTree tree)
+{
+    if (!tree)
+        return;
+
+    PARSER_FREE(tree->types);
+    PARSER_FREE(tree->subtypes);
+    PARSER_FREE(tree->mainTokens);
+    PARSER_FREE(tree->data);
+    PARSER_FREE(tree->extra);
+    PARSER_FREE(tree->patches);
+    PARSER_FREE(tree->patchSlots);
+
+    PARSER_FREE(tree);
+}
+
+PARSER_ATTR void PARSER_CALL ASTTree_Reset(
+    ASTTree tree)
+{
+    if (!tree)
+        return;
+
+    if (tree->parent)
+        tree->count = 0;
+    else
+        ASTTreeAddNoneNode(tree);
+
+    tree->extraCount = 0;
+    tree->patchCount = 0;
+
+    if (tree->patchSlots)
+        memset(tree->patchSlots, 0, sizeof(uint32_t) * (tree->patchSlotMask + 1));
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_AddNode(
+    ASTTree tree,
+    ParserASTNodeType type,
+    uint16_t subtype,
+    uint32_t mainToken,
+    ASTNodeData data,
+    ASTNodeId* id)
+{
+    if (!tree || !id || type >= AST_NODE_TYPE_COUNT)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (tree->count == tree->capacity) {
+        if (tree->capacity > UINT32_MAX / 2 - tree->base)
+            return PARSER_ERROR_NO_MEMORY;
+
+        CHECK_PARSER_RESULT(ASTTreeGrowNodes(tree, tree->capacity * 2));
+    }
+
+    uint32_t index = tree->count++;
+
+    tree->types[index] = (uint8_t)type;
+    tree->subtypes[index] = subtype;
+    tree->mainTokens[index] = mainToken;
+    tree->data[index] = data;
+
+    *id = tree->base + index;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_AddExtra(
+    ASTTree tree,
+    const uint32_t* values,
+    uint32_t count,
+    uint32_t* start)
+{
+    if (!tree || !start || (count && !values))
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (count > UINT32_MAX - tree->extraCount)
+        return PARSER_ERROR_NO_MEMORY;
+
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&tree->extra, &tree->extraCapacity, tree->extraCount,
+        tree->extraCount + count, sizeof(uint32_t), 256));
+
+    *start = tree->extraCount;
+
+    if (count)
+        memcpy(tree->extra + tree->extraCount, values, sizeof(uint32_t) * count);
+    tree->extraCount += count;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_AddListNode(
+    ASTTree tree,
+    ParserASTNodeType type,
+    uint16_t subtype,
+    uint32_t mainToken,
+    const ASTNodeId* children,
+    uint32_t count,
+    ASTNodeId* id)
+{
+    if (!tree || type >= AST_NODE_TYPE_COUNT)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeLayout layout = (ASTNodeLayout)s_ASTNodeTypeInfo[type].layout;
+    if (layout != AST_NODE_LAYOUT_LIST &&
+        (layout != AST_NODE_LAYOUT_FIXED || count != s_ASTNodeTypeInfo[type].fixedChildren))
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeData data;
+    CHECK_PARSER_RESULT(ASTTree_AddExtra(tree, children, count, &data.lhs));
+    data.rhs = layout == AST_NODE_LAYOUT_LIST ? count : 0;
+
+    return ASTTree_AddNode(tree, type, subtype, mainToken, data, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_Truncate(
+    ASTTree tree,
+    ASTNodeId first)
+{
+    // The none node of a tree stays
+    if (!tree || first < tree->base + (tree->parent ? 0u : 1u) || first > tree->base + tree->count)
+        return PARSER_ERROR_INVALID_ARG;
+
+    tree->count = first - tree->base;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_SetData(
+    ASTTree tree,
+    ASTNodeId id,
+    ASTNodeData data)
+{
+    if (!tree || id == AST_NODE_ID_NONE || id >= tree->base + tree->count)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (id < tree->base)
+        return ASTTreeAddPatch(tree, id, data);
+
+    tree->data[id - tree->base] = data;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_SetChild(
+    ASTTree tree,
+    ASTNodeId id,
+    uint32_t index,
+    ASTNodeId child)
+{
+    if (!tree || id == AST_NODE_ID_NONE || index >= ASTTree_GetChildCount(tree, id))
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeData data = *ASTTreeFindData(tree, id);
+
+    switch (s_ASTNodeTypeInfo[ASTTree_GetNodeType(tree, id)].layout) {
+    case AST_NODE_LAYOUT_UNARY:
+    case AST_NODE_LAYOUT_BINARY:
+        if (index == 0)
+            data.lhs = child;
+        else
+            data.rhs = child;
+        return ASTTree_SetData(tree, id, data);
+    default:
+        // Child lists of the parent are shared, an overlay cannot patch them
+        if (id < tree->base)
+            return PARSER_ERROR_INVALID_ARG;
+
+        tree->extra[data.lhs + index] = child;
+        return PARSER_RESULT_SUCCESS;
+    }
+}
+
+PARSER_ATTR void PARSER_CALL ASTTree_GetView(
+    const ASTTree tree,
+    ASTTreeView* view)
+{
+    if (!tree || !view)
+        return;
+
+    view->types = tree->types;
+    view->subtypes = tree->subtypes;
+    view->mainTokens = tree->mainTokens;
+    view->data = tree->data;
+    view->extra = tree->extra;
+    view->firstNode = tree->base;
+    view->nodeCount = tree->count;
+    view->extraCount = tree->extraCount;
+}
+
+PARSER_ATTR void PARSER_CALL ASTTree_GetMark(
+    const ASTTree tree,
+    ASTTreeMark* mark)
+{
+    if (!tree || !mark)
+        return;
+
+    mark->node = tree->base + tree->count;
+    mark->extra = tree->extraCount;
+    mark->patch = tree->patchCount;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTree_Merge(
+    ASTTree tree,
+    const ASTTree overlay,
+    const ASTTreeMark* begin,
+    const ASTTreeMark* end,
+    const ASTTreeMergeMap* map,
+    ASTNodeId* first)
+{
+    if (!tree || !overlay || !begin || !end || !map || overlay->parent != tree)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (begin->node < overlay->base || begin->node > end->node || end->node > overlay->base + overlay->count ||
+        begin->extra > end->extra || end->extra > overlay->extraCount ||
+        begin->patch > end->patch || end->patch > overlay->patchCount)
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint32_t count = end->node - begin->node;
+    uint32_t target = tree->base + tree->count;
+
+    if (count > UINT32_MAX / 2 - target)
+        return PARSER_ERROR_NO_MEMORY;
+
+    ASTTreeMergeRange range;
+    range.first = begin->node;
+    range.end = end->node;
+    range.target = target;
+    range.extraFirst = begin->extra;
+    range.map = map;
+
+    // ===== CHILD LISTS =====
+    CHECK_PARSER_RESULT(ASTTree_AddExtra(tree, overlay->extra + begin->extra, end->extra - begin->extra,
+        &range.extraTarget));
+
+    for (uint32_t i = range.extraTarget; i < tree->extraCount; i++)
+        tree->extra[i] = ASTTreeMergeNode(&range, tree->extra[i]);
+
+    // ===== NODES =====
+    if (tree->count + count > tree->capacity) {
+        uint32_t newCapacity = tree->capacity;
+        while (newCapacity < tree->count + count)
+            newCapacity *= 2;
+
+        CHECK_PARSER_RESULT(ASTTreeGrowNodes(tree, newCapacity));
+    }
+
+    uint32_t from = begin->node - overlay->base;
+    memcpy(tree->types + tree->count, overlay->types + from, sizeof(uint8_t) * count);
+    memcpy(tree->subtypes + tree->count, overlay->subtypes + from, sizeof(uint16_t) * count);
+    memcpy(tree->mainTokens + tree->count, overlay->mainTokens + from, sizeof(uint32_t) * count);
+
+    for (uint32_t i = 0; i < count; i++)
+        tree->data[tree->count + i] = ASTTreeMergeData(&range, overlay->types[from + i], overlay->data[from + i], true);
+
+    tree->count += count;
+
+    // ===== WRITES TO PARENT NODES =====
+    for (uint32_t i = begin->patch; i < end->patch; i++) {
+        const ASTTreePatch* patch = &overlay->patches[i];
+        ASTNodeData data = ASTTreeMergeData(&range, (uint8_t)ASTTree_GetNodeType(tree, patch->id), patch->data, false);
+        CHECK_PARSER_RESULT(ASTTree_SetData(tree, patch->id, data));
+    }
+
+    if (first)
+        *first = target;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ASTTree_GetNodeCount(
+    const ASTTree tree)
+{
+    return tree ? tree->base + tree->count : 0;
+}
+
+PARSER_ATTR ParserASTNodeType PARSER_CALL ASTTree_GetNodeType(
+    const ASTTree tree,
+    ASTNodeId id)
+{
+    uint32_t index;
+    const struct ASTTree_T* owner = tree ? ASTTreeFind(tree, id, &index) : NULL;
+
+    return owner ? (ParserASTNodeType)owner->types[index] : AST_NODE_TYPE_NONE;
+}
+
+PARSER_ATTR uint16_t PARSER_CALL ASTTree_GetSubtype(
+    const ASTTree tree,
+    ASTNodeId id)
+{
+    uint32_t index;
+    const struct ASTTree_T* owner = tree ? ASTTreeFind(tree, id, &index) : NULL;
+
+    return owner ? owner->subtypes[index] : 0;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ASTTree_GetMainToken(
+    const ASTTree tree,
+    ASTNodeId id)
+{
+    uint32_t index;
+    const struct ASTTree_T* owner = tree ? ASTTreeFind(tree, id, &index) : NULL;
+
+    return owner ? owner->mainTokens[index] : 0;
+}
+
+PARSER_ATTR ASTNodeData PARSER_CALL ASTTree_GetData(
+    const ASTTree tree,
+    ASTNodeId id)
+{
+    const ASTNodeData* data = tree ? ASTTreeFindData(tree, id) : NULL;
+    if (!data) {
+        ASTNodeData none = { 0, 0 };
+        return none;
+    }
+
+    return *data;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ASTTree_GetChildCount(
+    const ASTTree tree,
+    ASTNodeId id)
+{
+    const ASTNodeData* data = tree ? ASTTreeFindData(tree, id) : NULL;
+    if (!data)
+        return 0;
+
+    const ASTNodeTypeInfo* info = &s_ASTNodeTypeInfo[ASTTree_GetNodeType(tree, id)];
+
+    switch (info->layout) {
+    case AST_NODE_LAYOUT_UNARY:     return 1;
+    case AST_NODE_LAYOUT_BINARY:    return 2;
+    case AST_NODE_LAYOUT_LIST:      return data->rhs;
+    case AST_NODE_LAYOUT_FIXED:     return info->fixedChildren;
+    default:                        return 0;
+    }
+}
+
+PARSER_ATTR ASTNodeId PARSER_CALL ASTTree_GetChild(
+    const ASTTree tree,
+    ASTNodeId id,
+    uint32_t index)
+{
+    if (index >= ASTTree_GetChildCount(tree, id))
+        return AST_NODE_ID_NONE;
+
+    const ASTNodeData* data = ASTTreeFindData(tree, id);
+
+    switch (s_ASTNodeTypeInfo[ASTTree_GetNodeType(tree, id)].layout) {
+    case AST_NODE_LAYOUT_UNARY:
+    case AST_NODE_LAYOUT_BINARY:
+        return index == 0 ? data->lhs : data->rhs;
+    default: {
+        // Child lists live in the extra data of the tree holding the node
+        uint32_t local;
+        return ASTTreeFind(tree, id, &local)->extra[data->lhs + index];
+    }
+    }
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ASTTreeView_GetChildCount(
+    const ASTTreeView* view,
+    ASTNodeId id)
+{
+    if (!view || id < view->firstNode || id - view->firstNode >= view->nodeCount || id == AST_NODE_ID_NONE)
+        return 0;
+
+    uint32_t index = id - view->firstNode;
+    if (view->types[index] >= AST_NODE_TYPE_COUNT)
+        return 0;
+
+    const ASTNodeTypeInfo* info = &s_ASTNodeTypeInfo[view->types[index]];
+
+    switch (info->layout) {
+    case AST_NODE_LAYOUT_UNARY:     return 1;
+    case AST_NODE_LAYOUT_BINARY:    return 2;
+    case AST_NODE_LAYOUT_LIST:      return view->data[index].rhs;
+    case AST_NODE_LAYOUT_FIXED:     return info->fixedChildren;
+    default:                        return 0;
+    }
+}
+
+PARSER_ATTR ASTNodeId PARSER_CALL ASTTreeView_GetChild(
+    const ASTTreeView* view,
+    ASTNodeId id,
+    uint32_t index)
+{
+    if (index >= ASTTreeView_GetChildCount(view, id))
+        return AST_NODE_ID_NONE;
+
+    const ASTNodeData* data = &view->data[id - view->firstNode];
+
+    switch (s_ASTNodeTypeInfo[view->types[id - view->firstNode]].layout) {
+    case AST_NODE_LAYOUT_UNARY:
+    case AST_NODE_LAYOUT_BINARY:
+        return index == 0 ? data->lhs : data->rhs;
+    default:
+        return data->lhs + index < view->extraCount ? view->extra[data->lhs + index] : AST_NODE_ID_NONE;
+    }
+}
+
+PARSER_ATTR ASTNodeLayout PARSER_CALL ASTNodeType_GetLayout(
+    ParserASTNodeType type)
+{
+    if (type >= AST_NODE_TYPE_COUNT)
+        return AST_NODE_LAYOUT_LEAF;
+
+    return (ASTNodeLayout)s_ASTNodeTypeInfo[type].layout;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ASTNodeType_GetFixedChildCount(
+    ParserASTNodeType type)
+{
+    if (type >= AST_NODE_TYPE_COUNT)
+        return 0;
+
+    return s_ASTNodeTypeInfo[type].fixedChildren;
+}
+
+PARSER_ATTR ASTNodePayload PARSER_CALL ASTNodeType_GetPayload(
+    ParserASTNodeType type,
+    uint32_t word)
+{
+    if (type >= AST_NODE_TYPE_COUNT)
+        return AST_NODE_PAYLOAD_VALUE;
+
+    return (ASTNodePayload)(word == 0 ? s_ASTNodeTypeInfo[type].lhs : s_ASTNodeTypeInfo[type].rhs);
+}
+
+// ------------------------------------------------------------------------------------------------
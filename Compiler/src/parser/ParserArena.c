@@ -0,0 +1,342 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserArena.h"
+
+#include "ParserThread.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define PARSER_ARENA_DEFAULT_ALIGNMENT  16u
+#define PARSER_ARENA_SIZE_CLASS_STEP    (PARSER_ARENA_MAX_POOLED_SIZE / PARSER_ARENA_SIZE_CLASS_COUNT)
+
+// Header in front of every default heap allocation, keeps the size for the
+// counters and the alignment malloc guarantees
+#define PARSER_HEAP_HEADER_SIZE         16u
+
+typedef struct ParserArenaChunk_T {
+    struct ParserArenaChunk_T* next;
+    size_t size;                // Usable bytes after the header
+} ParserArenaChunk;
+
+#define PARSER_ARENA_CHUNK_HEADER \
+    ((sizeof(ParserArenaChunk) + PARSER_ARENA_DEFAULT_ALIGNMENT - 1) & ~(size_t)(PARSER_ARENA_DEFAULT_ALIGNMENT - 1))
+
+/* Storage of a freed pooled allocation */
+typedef struct ParserArenaFreeNode_T {
+    struct ParserArenaFreeNode_T* next;
+} ParserArenaFreeNode;
+
+struct ParserArena_T {
+    ParserArenaChunk* chunks;   // All chunks, kept across resets
+    ParserArenaChunk* current;  // Chunk being bumped
+    uint8_t* cur;               // Next free byte of the current chunk
+    uint8_t* end;               // End of the current chunk
+    size_t chunkSize;
+
+    ParserAllocationCallbacks parent;
+    ParserArenaFreeNode* pools[PARSER_ARENA_SIZE_CLASS_COUNT];
+
+    ParserAllocationStats stats;
+};
+
+// ===== Default heap callbacks =====
+
+static volatile int64_t s_ParserHeapAllocations;
+static volatile int64_t s_ParserHeapFrees;
+static volatile int64_t s_ParserHeapRequested;
+static volatile int64_t s_ParserHeapReserved;
+static volatile int64_t s_ParserHeapPeak;
+
+static void* PARSER_PTR ParserHeapAllocate(void* pUserData, size_t size, size_t alignment)
+{
+    (void)pUserData;
+    (void)alignment;            // malloc alignment, which covers every parser type
+
+    uint8_t* block = malloc(size + PARSER_HEAP_HEADER_SIZE);
+    if (!block)
+        return NULL;
+
+    memcpy(block, &size, sizeof(size));
+
+    ParserAtomicAdd64(&s_ParserHeapAllocations, 1);
+    ParserAtomicAdd64(&s_ParserHeapRequested, (int64_t)size);
+    ParserAtomicMax64(&s_ParserHeapPeak, ParserAtomicAdd64(&s_ParserHeapReserved, (int64_t)size));
+
+    return block + PARSER_HEAP_HEADER_SIZE;
+}
+
+static void PARSER_PTR ParserHeapFree(void* pUserData, void* pMemory)
+{
+    (void)pUserData;
+
+    if (!pMemory)
+        return;
+
+    uint8_t* block = (uint8_t*)pMemory - PARSER_HEAP_HEADER_SIZE;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+
+    ParserAtomicAdd64(&s_ParserHeapFrees, 1);
+    ParserAtomicAdd64(&s_ParserHeapReserved, -(int64_t)size);
+
+    free(block);
+}
+
+static ParserAllocationCallbacks s_ParserDefaultCallbacks = {
+    .pUserData = NULL,
+    .pfnAllocation = ParserHeapAllocate,
+    .pfnFree = ParserHeapFree,
+};
+
+// ===== Arena =====
+
+static uint8_t* ParserArenaChunkData(ParserArenaChunk* chunk)
+{
+    return (uint8_t*)chunk + PARSER_ARENA_CHUNK_HEADER;
+}
+
+static void ParserArenaUseChunk(ParserArena arena, ParserArenaChunk* chunk)
+{
+    arena->current = chunk;
+    arena->cur = ParserArenaChunkData(chunk);
+    arena->end = arena->cur + chunk->size;
+}
+
+/* Move to a chunk with at least `need` free bytes, reusing chunks kept by a reset */
+static bool ParserArenaNextChunk(ParserArena arena, size_t need)
+{
+    ParserArenaChunk* next = arena->current ? arena->current->next : arena->chunks;
+    if (next && next->size >= need) {
+        ParserArenaUseChunk(arena, next);
+        return true;
+    }
+
+    size_t size = need > arena->chunkSize ? need : arena->chunkSize;
+
+    ParserArenaChunk* chunk = arena->parent.pfnAllocation(arena->parent.pUserData,
+        PARSER_ARENA_CHUNK_HEADER + size, PARSER_ARENA_DEFAULT_ALIGNMENT);
+    if (!chunk)
+        return false;
+
+    chunk->size = size;
+
+    // Insert after the current chunk, in front of any chunk too small to use
+    if (arena->current) {
+        chunk->next = arena->current->next;
+        arena->current->next = chunk;
+    }
+    else {
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+
+    arena->stats.chunks++;
+    arena->stats.bytesReserved += (int64_t)(PARSER_ARENA_CHUNK_HEADER + size);
+    if (arena->stats.bytesReserved > arena->stats.bytesPeak)
+        arena->stats.bytesPeak = arena->stats.bytesReserved;
+
+    ParserArenaUseChunk(arena, chunk);
+
+    return true;
+}
+
+static void* PARSER_PTR ParserArenaCallbackAllocate(void* pUserData, size_t size, size_t alignment)
+{
+    return ParserArena_Alloc((ParserArena)pUserData, size, alignment);
+}
+
+static void PARSER_PTR ParserArenaCallbackFree(void* pUserData, void* pMemory)
+{
+    // Released with the region
+    (void)pMemory;
+    ((ParserArena)pUserData)->stats.frees++;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+ParserAllocationCallbacks* g_parser_allocator_callbacks = &s_ParserDefaultCallbacks;
+
+PARSER_ATTR ParserResult PARSER_CALL ParserArena_Create(
+    const ParserArenaConfig* cfg,
+    ParserArena* arena)
+{
+    if (!arena)
+        return PARSER_ERROR_INVALID_ARG;
+
+    const ParserAllocationCallbacks* parent = (cfg && cfg->parent) ? cfg->parent : &s_ParserDefaultCallbacks;
+
+    ParserArena hdl = parent->pfnAllocation(parent->pUserData, sizeof(struct ParserArena_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ParserArena_T));
+
+    hdl->parent = *parent;
+    hdl->chunkSize = (cfg && cfg->chunkSize) ? cfg->chunkSize : PARSER_ARENA_DEFAULT_CHUNK_SIZE;
+
+    // The first chunk is allocated on first use
+    *arena = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void* PARSER_CALL ParserArena_Alloc(
+    ParserArena arena,
+    size_t size,
+    size_t alignment)
+{
+    if (!arena)
+        return NULL;
+
+    if (alignment == 0)
+        alignment = PARSER_ARENA_DEFAULT_ALIGNMENT;
+
+    uintptr_t address = ((uintptr_t)arena->cur + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+    if (!arena->cur || address + size > (uintptr_t)arena->end) {
+        if (!ParserArenaNextChunk(arena, size + alignment))
+            return NULL;
+
+        address = ((uintptr_t)arena->cur + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    }
+
+    arena->cur = (uint8_t*)(address + size);
+
+    arena->stats.allocations++;
+    arena->stats.bytesRequested += (int64_t)size;
+
+    return (void*)address;
+}
+
+PARSER_ATTR void* PARSER_CALL ParserArena_AllocPooled(
+    ParserArena arena,
+    size_t size)
+{
+    if (!arena)
+        return NULL;
+
+    if (size == 0 || size > PARSER_ARENA_MAX_POOLED_SIZE)
+        return ParserArena_Alloc(arena, size, 0);
+
+    uint32_t sizeClass = (uint32_t)((size - 1) / PARSER_ARENA_SIZE_CLASS_STEP);
+
+    ParserArenaFreeNode* node = arena->pools[sizeClass];
+    if (node) {
+        arena->pools[sizeClass] = node->next;
+        arena->stats.allocations++;
+        arena->stats.bytesRequested += (int64_t)size;
+        arena->stats.poolReuses++;
+        return node;
+    }
+
+    return ParserArena_Alloc(arena, (sizeClass + 1) * PARSER_ARENA_SIZE_CLASS_STEP, 0);
+}
+
+PARSER_ATTR void PARSER_CALL ParserArena_FreePooled(
+    ParserArena arena,
+    void* memory,
+    size_t size)
+{
+    if (!arena || !memory)
+        return;
+
+    arena->stats.frees++;
+
+    if (size == 0 || size > PARSER_ARENA_MAX_POOLED_SIZE)
+        return;
+
+    uint32_t sizeClass = (uint32_t)((size - 1) / PARSER_ARENA_SIZE_CLASS_STEP);
+
+    ParserArenaFreeNode* node = memory;
+    node->next = arena->pools[sizeClass];
+    arena->pools[sizeClass] = node;
+}
+
+PARSER_ATTR void PARSER_CALL ParserArena_Reset(
+    ParserArena arena)
+{
+    if (!arena)
+        return;
+
+    // Chunks stay allocated, the next allocation starts over at the first
+    arena->current = NULL;
+    arena->cur = NULL;
+    arena->end = NULL;
+
+    memset(arena->pools, 0, sizeof(arena->pools));
+}
+
+PARSER_ATTR void PARSER_CALL ParserArena_Destroy(
+    ParserArena arena)
+{
+    if (!arena)
+        return;
+
+    ParserArenaChunk* chunk = arena->chunks;
+    while (chunk) {
+        ParserArenaChunk* next = chunk->next;
+        arena->parent.pfnFree(arena->parent.pUserData, chunk);
+        chunk = next;
+    }
+
+    ParserAllocationCallbacks parent = arena->parent;
+    parent.pfnFree(parent.pUserData, arena);
+}
+
+PARSER_ATTR void PARSER_CALL ParserArena_GetStats(
+    const ParserArena arena,
+    ParserAllocationStats* stats)
+{
+    if (!arena || !stats)
+        return;
+
+    *stats = arena->stats;
+}
+
+PARSER_ATTR void PARSER_CALL ParserArena_GetCallbacks(
+    ParserArena arena,
+    ParserAllocationCallbacks* callbacks)
+{
+    if (!callbacks)
+        return;
+
+    callbacks->pUserData = arena;
+    callbacks->pfnAllocation = ParserArenaCallbackAllocate;
+    callbacks->pfnFree = ParserArenaCallbackFree;
+}
+
+PARSER_ATTR bool PARSER_CALL ParserThreadSafeAllocator(void)
+{
+    // An arena bumps one pointer without a lock
+    return !g_parser_allocator_callbacks || g_parser_allocator_callbacks->pfnAllocation != ParserArenaCallbackAllocate;
+}
+
+PARSER_ATTR const ParserAllocationCallbacks* PARSER_CALL ParserGetDefaultAllocationCallbacks(void)
+{
+    return &s_ParserDefaultCallbacks;
+}
+
+PARSER_ATTR void PARSER_CALL ParserGetDefaultAllocationStats(
+    ParserAllocationStats* stats)
+{
+    if (!stats)
+        return;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->allocations = s_ParserHeapAllocations;
+    stats->frees = s_ParserHeapFrees;
+    stats->bytesRequested = s_ParserHeapRequested;
+    stats->bytesReserved = s_ParserHeapReserved;
+    stats->bytesPeak = s_ParserHeapPeak;
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,50 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserArray.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL ParserArrayGrow(
+    void** items,
+    uint32_t* capacity,
+    uint32_t count,
+    uint32_t need,
+    size_t size,
+    uint32_t minCapacity)
+{
+    if (need <= *capacity)
+        return PARSER_RESULT_SUCCESS;
+
+    // Doubling past half the range would wrap around to 0
+    uint32_t newCapacity = *capacity ? *capacity : minCapacity;
+    while (newCapacity < need) {
+        if (newCapacity > UINT32_MAX / 2)
+            return PARSER_ERROR_NO_MEMORY;
+        newCapacity *= 2;
+    }
+
+    if (newCapacity > SIZE_MAX / size)
+        return PARSER_ERROR_NO_MEMORY;
+
+    void* storage = PARSER_MALLOC(size * newCapacity, 0);
+    if (!storage)
+        return PARSER_ERROR_NO_MEMORY;
+
+    if (*items) {
+        memcpy(storage, *items, size * count);
+        PARSER_FREE(*items);
+    }
+
+    *items = storage;
+    *capacity = newCapacity;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
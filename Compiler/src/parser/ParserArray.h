@@ -0,0 +1,59 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_ARRAY_H
+#define PARSER_ARRAY_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserCore.h"
+#include "parser/Results.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Grow a heap array to hold at least `need` items
+ *
+ * @description The capacity starts at `minCapacity` and doubles until it
+ *              covers `need`. The first `count` items move to the new
+ *              storage, the items past them are uninitialized. Nothing
+ *              changes when the growth fails. Callers go through
+ *              ParserArrayReserve, which only calls this when the array
+ *              is full.
+ *
+ * @param items[in,out] Pointer to the array, NULL while it has no storage
+ * @param capacity[in,out] Items the array has room for
+ * @param count[in] Items in use, at most `*capacity`
+ * @param need[in] Items the array must have room for
+ * @param size[in] Size of one item in bytes
+ * @param minCapacity[in] Capacity of the first storage, at least 1
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not allocate, or the capacity or size in bytes would overflow
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserArrayGrow(
+    void** items,
+    uint32_t* capacity,
+    uint32_t count,
+    uint32_t need,
+    size_t size,
+    uint32_t minCapacity);
+
+/* Make room for `need` items, see ParserArrayGrow */
+static inline ParserResult ParserArrayReserve(void** items, uint32_t* capacity, uint32_t count, uint32_t need,
+    size_t size, uint32_t minCapacity)
+{
+    if (need <= *capacity)
+        return PARSER_RESULT_SUCCESS;
+
+    return ParserArrayGrow(items, capacity, count, need, size, minCapacity);
+}
+
+// ------------------------------------------------------------------------------------------------
+#endif // !PARSER_ARRAY_H
+// ------------------------------------------------------------------------------------------------
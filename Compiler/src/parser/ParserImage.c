@@ -0,0 +1,406 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserImage.h"
+#include "ParserInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+static const uint32_t s_ASTImageStrides[AST_IMAGE_SECTION_COUNT] = {
+    [AST_IMAGE_SECTION_NODE_TYPES]      = sizeof(uint8_t),
+    [AST_IMAGE_SECTION_NODE_SUBTYPES]   = sizeof(uint16_t),
+    [AST_IMAGE_SECTION_NODE_TOKENS]     = sizeof(uint32_t),
+    [AST_IMAGE_SECTION_NODE_DATA]       = sizeof(ASTNodeData),
+    [AST_IMAGE_SECTION_EXTRA]           = sizeof(uint32_t),
+    [AST_IMAGE_SECTION_LOCATIONS]       = sizeof(ASTImageLocation),
+    [AST_IMAGE_SECTION_IDENTIFIERS]     = sizeof(ASTImageString),
+    [AST_IMAGE_SECTION_STRINGS]         = sizeof(char),
+    [AST_IMAGE_SECTION_SPELLINGS]       = sizeof(ASTImageSpelling),
+    [AST_IMAGE_SECTION_LITERALS]        = sizeof(LexerLiteral),
+    [AST_IMAGE_SECTION_SYMBOLS]         = sizeof(ASTSymbolInfo),
+    [AST_IMAGE_SECTION_TYPES]           = sizeof(ASTTypeInfo),
+    [AST_IMAGE_SECTION_TYPE_PARAMS]     = sizeof(ASTTypeId),
+};
+
+static inline uint64_t ASTImageAlign(uint64_t offset)
+{
+    return (offset + AST_IMAGE_ALIGNMENT - 1) & ~(uint64_t)(AST_IMAGE_ALIGNMENT - 1);
+}
+
+static inline bool ASTImageHasSpelling(uint8_t type)
+{
+    return type == AST_NODE_TYPE_STRING_LITERAL || type == AST_NODE_TYPE_CHAR_LITERAL;
+}
+
+/* Source of a string or character literal node, all pieces of a string */
+static const char* ASTImageSpellingOf(const ASTParser parser, const ASTTreeView* view, ASTNodeId node, uint32_t* length)
+{
+    uint32_t mainToken = view->mainTokens[node];
+    uint32_t pieces = view->types[node] == AST_NODE_TYPE_STRING_LITERAL ? view->data[node].lhs : 1;
+
+    const struct LexerToken_T* first = LexerRingAt(parser->lexer, mainToken);
+    const struct LexerToken_T* last = LexerRingAt(parser->lexer, mainToken + (pieces ? pieces - 1 : 0));
+    *length = (uint32_t)(last->lexeme + last->length - first->lexeme);
+
+    return first->lexeme;
+}
+
+/* Place the sections of an image of the current unit */
+static ParserResult ASTImageLayout(const ASTParser parser, const ASTTreeView* view, ASTImageHeader* header)
+{
+    uint32_t counts[AST_IMAGE_SECTION_COUNT] = { 0 };
+
+    counts[AST_IMAGE_SECTION_NODE_TYPES] = view->nodeCount;
+    counts[AST_IMAGE_SECTION_NODE_SUBTYPES] = view->nodeCount;
+    counts[AST_IMAGE_SECTION_NODE_TOKENS] = view->nodeCount;
+    counts[AST_IMAGE_SECTION_NODE_DATA] = view->nodeCount;
+    counts[AST_IMAGE_SECTION_LOCATIONS] = view->nodeCount;
+    counts[AST_IMAGE_SECTION_EXTRA] = view->extraCount;
+    counts[AST_IMAGE_SECTION_LITERALS] = parser->lexer->literals.count;
+
+    // String 0 is empty, identifier id 0 points at it
+    uint64_t strings = 1;
+
+    uint32_t identifiers = ParserInterner_GetCount(parser->interner);
+    counts[AST_IMAGE_SECTION_IDENTIFIERS] = identifiers + 1;
+    for (ParserIdentifierId id = 1; id <= identifiers; id++)
+        strings += (uint64_t)ParserInterner_Get(parser->interner, id)->length + 1;
+
+    for (ASTNodeId node = 1; node < view->nodeCount; node++) {
+        if (!ASTImageHasSpelling(view->types[node]))
+            continue;
+
+        uint32_t length;
+        ASTImageSpellingOf(parser, view, node, &length);
+        strings += (uint64_t)length + 1;
+        counts[AST_IMAGE_SECTION_SPELLINGS]++;
+    }
+
+    if (strings > UINT32_MAX)
+        return PARSER_ERROR_NO_MEMORY;
+    counts[AST_IMAGE_SECTION_STRINGS] = (uint32_t)strings;
+
+    counts[AST_IMAGE_SECTION_SYMBOLS] = ASTSymbolTable_GetSymbolCount(parser->symbols) + 1;
+
+    uint32_t types = ASTTypeTable_GetTypeCount(parser->types);
+    counts[AST_IMAGE_SECTION_TYPES] = types + 1;
+    for (ASTTypeId id = 1; id <= types; id++) {
+        const ASTTypeInfo* type = ASTTypeTable_Get(parser->types, id);
+        if (type->kind == AST_TYPE_KIND_FUNCTION)
+            counts[AST_IMAGE_SECTION_TYPE_PARAMS] += type->count;
+    }
+
+    memset(header, 0, sizeof(*header));
+    header->magic = AST_IMAGE_MAGIC;
+    header->version = AST_IMAGE_VERSION;
+
+    uint64_t offset = ASTImageAlign(sizeof(ASTImageHeader));
+    for (uint32_t kind = 0; kind < AST_IMAGE_SECTION_COUNT; kind++) {
+        header->sections[kind].offset = (uint32_t)offset;
+        header->sections[kind].count = counts[kind];
+        header->sections[kind].stride = s_ASTImageStrides[kind];
+
+        offset = ASTImageAlign(offset + (uint64_t)counts[kind] * s_ASTImageStrides[kind]);
+        if (offset > UINT32_MAX)
+            return PARSER_ERROR_NO_MEMORY;
+    }
+
+    header->size = (uint32_t)offset;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static inline void* ASTImageSectionAt(void* image, const ASTImageHeader* header, ASTImageSectionKind kind)
+{
+    return (uint8_t*)image + header->sections[kind].offset;
+}
+
+/* Append NUL terminated text to the string section, return its record */
+static ASTImageString ASTImageAddString(char* strings, uint32_t* used, const char* text, uint32_t length)
+{
+    ASTImageString record;
+    record.offset = *used;
+    record.length = length;
+
+    memcpy(strings + *used, text, length);
+    strings[*used + length] = '\0';
+    *used += length + 1;
+
+    return record;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_WriteImage(
+    const ASTParser parser,
+    ASTNode root,
+    void* buffer,
+    size_t capacity,
+    size_t* size)
+{
+    if (!parser || !size)
+        return PARSER_ERROR_INVALID_ARG;
+
+    // Locations and spellings are read from the tokens of the unit
+    if (!parser->lazyFunctionBodies && !parser->keepTokens)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTreeView view;
+    ASTTree_GetView(parser->tree, &view);
+
+    ASTImageHeader header;
+    CHECK_PARSER_RESULT(ASTImageLayout(parser, &view, &header));
+
+    header.root = AST_NODE_TO_ID(root);
+    *size = header.size;
+
+    if (!buffer)
+        return PARSER_RESULT_SUCCESS;
+
+    if (capacity < header.size || (uintptr_t)buffer % AST_IMAGE_ALIGNMENT != 0)
+        return PARSER_ERROR_INVALID_ARG;
+
+    // Padding is zeroed so equal units give equal images
+    memset(buffer, 0, header.size);
+    memcpy(buffer, &header, sizeof(header));
+
+    // ===== Nodes =====
+    memcpy(ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_NODE_TYPES), view.types, view.nodeCount * sizeof(uint8_t));
+    memcpy(ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_NODE_SUBTYPES), view.subtypes, view.nodeCount * sizeof(uint16_t));
+    memcpy(ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_NODE_TOKENS), view.mainTokens, view.nodeCount * sizeof(uint32_t));
+    memcpy(ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_NODE_DATA), view.data, view.nodeCount * sizeof(ASTNodeData));
+    if (view.extraCount)
+        memcpy(ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_EXTRA), view.extra, view.extraCount * sizeof(uint32_t));
+
+    ASTImageLocation* locations = ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_LOCATIONS);
+    for (ASTNodeId node = 1; node < view.nodeCount; node++) {
+        const struct LexerToken_T* token = LexerRingAt(parser->lexer, view.mainTokens[node]);
+        locations[node].line = token->line;
+        locations[node].column = token->column;
+    }
+
+    // ===== Strings =====
+    char* strings = ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_STRINGS);
+    uint32_t used = 1;
+
+    ASTImageString* identifiers = ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_IDENTIFIERS);
+    for (ParserIdentifierId id = 1; id < header.sections[AST_IMAGE_SECTION_IDENTIFIERS].count; id++) {
+        const ParserIdentifier* identifier = ParserInterner_Get(parser->interner, id);
+        identifiers[id] = ASTImageAddString(strings, &used, identifier->text, identifier->length);
+    }
+
+    ASTImageSpelling* spellings = ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_SPELLINGS);
+    for (ASTNodeId node = 1; node < view.nodeCount; node++) {
+        if (!ASTImageHasSpelling(view.types[node]))
+            continue;
+
+        uint32_t length;
+        const char* text = ASTImageSpellingOf(parser, &view, node, &length);
+        spellings->node = node;
+        spellings->text = ASTImageAddString(strings, &used, text, length);
+        spellings++;
+    }
+
+    // ===== Tables =====
+    if (parser->lexer->literals.count)
+        memcpy(ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_LITERALS), parser->lexer->literals.items,
+            parser->lexer->literals.count * sizeof(LexerLiteral));
+
+    ASTSymbolInfo* symbols = ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_SYMBOLS);
+    for (ASTSymbolId id = 1; id < header.sections[AST_IMAGE_SECTION_SYMBOLS].count; id++)
+        symbols[id] = *ASTSymbolTable_GetSymbol(parser->symbols, id);
+
+    // Function types point into the parameter section instead of the table
+    ASTTypeInfo* types = ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_TYPES);
+    ASTTypeId* params = ASTImageSectionAt(buffer, &header, AST_IMAGE_SECTION_TYPE_PARAMS);
+    uint32_t paramCount = 0;
+    for (ASTTypeId id = 1; id < header.sections[AST_IMAGE_SECTION_TYPES].count; id++) {
+        types[id] = *ASTTypeTable_Get(parser->types, id);
+        if (types[id].kind != AST_TYPE_KIND_FUNCTION)
+            continue;
+
+        types[id].value = paramCount;
+        if (types[id].count)
+            memcpy(params + paramCount, ASTTypeTable_GetParams(parser->types, id), types[id].count * sizeof(ASTTypeId));
+        paramCount += types[id].count;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTImage_Open(
+    const void* data,
+    size_t size,
+    ASTImage* image)
+{
+    if (!data || !image)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if ((uintptr_t)data % AST_IMAGE_ALIGNMENT != 0 || size < sizeof(ASTImageHeader))
+        return PARSER_ERROR_INVALID_FILE;
+
+    const ASTImageHeader* header = data;
+    if (header->magic != AST_IMAGE_MAGIC || header->version != AST_IMAGE_VERSION || header->size > size)
+        return PARSER_ERROR_INVALID_FILE;
+
+    for (uint32_t kind = 0; kind < AST_IMAGE_SECTION_COUNT; kind++) {
+        const ASTImageSection* section = &header->sections[kind];
+        if (section->stride != s_ASTImageStrides[kind] ||
+            section->offset % AST_IMAGE_ALIGNMENT != 0 ||
+            section->offset < sizeof(ASTImageHeader) ||
+            section->offset + (uint64_t)section->count * section->stride > header->size)
+            return PARSER_ERROR_INVALID_FILE;
+    }
+
+    // Node arrays run in parallel, each table keeps its none entry
+    uint32_t nodeCount = header->sections[AST_IMAGE_SECTION_NODE_TYPES].count;
+    if (nodeCount == 0 ||
+        header->sections[AST_IMAGE_SECTION_NODE_SUBTYPES].count != nodeCount ||
+        header->sections[AST_IMAGE_SECTION_NODE_TOKENS].count != nodeCount ||
+        header->sections[AST_IMAGE_SECTION_NODE_DATA].count != nodeCount ||
+        header->sections[AST_IMAGE_SECTION_LOCATIONS].count != nodeCount ||
+        header->sections[AST_IMAGE_SECTION_IDENTIFIERS].count == 0 ||
+        header->sections[AST_IMAGE_SECTION_STRINGS].count == 0 ||
+        header->sections[AST_IMAGE_SECTION_SYMBOLS].count == 0 ||
+        header->sections[AST_IMAGE_SECTION_TYPES].count == 0 ||
+        header->root >= nodeCount)
+        return PARSER_ERROR_INVALID_FILE;
+
+    const uint8_t* base = data;
+    #define AST_IMAGE_SECTION(kind) ((const void*)(base + header->sections[kind].offset))
+
+    image->header = header;
+    image->root = header->root;
+
+    image->tree.types = AST_IMAGE_SECTION(AST_IMAGE_SECTION_NODE_TYPES);
+    image->tree.subtypes = AST_IMAGE_SECTION(AST_IMAGE_SECTION_NODE_SUBTYPES);
+    image->tree.mainTokens = AST_IMAGE_SECTION(AST_IMAGE_SECTION_NODE_TOKENS);
+    image->tree.data = AST_IMAGE_SECTION(AST_IMAGE_SECTION_NODE_DATA);
+    image->tree.extra = AST_IMAGE_SECTION(AST_IMAGE_SECTION_EXTRA);
+    image->tree.firstNode = 0;
+    image->tree.nodeCount = nodeCount;
+    image->tree.extraCount = header->sections[AST_IMAGE_SECTION_EXTRA].count;
+
+    image->locations = AST_IMAGE_SECTION(AST_IMAGE_SECTION_LOCATIONS);
+    image->identifiers = AST_IMAGE_SECTION(AST_IMAGE_SECTION_IDENTIFIERS);
+    image->identifierCount = header->sections[AST_IMAGE_SECTION_IDENTIFIERS].count;
+    image->strings = AST_IMAGE_SECTION(AST_IMAGE_SECTION_STRINGS);
+    image->spellings = AST_IMAGE_SECTION(AST_IMAGE_SECTION_SPELLINGS);
+    image->spellingCount = header->sections[AST_IMAGE_SECTION_SPELLINGS].count;
+    image->literals = AST_IMAGE_SECTION(AST_IMAGE_SECTION_LITERALS);
+    image->literalCount = header->sections[AST_IMAGE_SECTION_LITERALS].count;
+    image->symbols = AST_IMAGE_SECTION(AST_IMAGE_SECTION_SYMBOLS);
+    image->symbolCount = header->sections[AST_IMAGE_SECTION_SYMBOLS].count;
+    image->types = AST_IMAGE_SECTION(AST_IMAGE_SECTION_TYPES);
+    image->typeCount = header->sections[AST_IMAGE_SECTION_TYPES].count;
+    image->typeParams = AST_IMAGE_SECTION(AST_IMAGE_SECTION_TYPE_PARAMS);
+    image->typeParamCount = header->sections[AST_IMAGE_SECTION_TYPE_PARAMS].count;
+
+    #undef AST_IMAGE_SECTION
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR const char* PARSER_CALL ASTImage_GetIdentifier(
+    const ASTImage* image,
+    ParserIdentifierId id,
+    uint32_t* length)
+{
+    if (!image || id == PARSER_IDENTIFIER_NONE || id >= image->identifierCount)
+        return NULL;
+
+    if (length)
+        *length = image->identifiers[id].length;
+
+    return image->strings + image->identifiers[id].offset;
+}
+
+PARSER_ATTR const char* PARSER_CALL ASTImage_GetSpelling(
+    const ASTImage* image,
+    ASTNodeId node,
+    uint32_t* length)
+{
+    if (!image)
+        return NULL;
+
+    // Spellings are written in node order
+    uint32_t low = 0;
+    uint32_t high = image->spellingCount;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (image->spellings[mid].node < node)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low == image->spellingCount || image->spellings[low].node != node)
+        return NULL;
+
+    if (length)
+        *length = image->spellings[low].text.length;
+
+    return image->strings + image->spellings[low].text.offset;
+}
+
+PARSER_ATTR ASTImageLocation PARSER_CALL ASTImage_GetLocation(
+    const ASTImage* image,
+    ASTNodeId node)
+{
+    ASTImageLocation location = { 0, 0 };
+    if (image && node != AST_NODE_ID_NONE && node < image->tree.nodeCount)
+        location = image->locations[node];
+
+    return location;
+}
+
+PARSER_ATTR const LexerLiteral* PARSER_CALL ASTImage_GetLiteral(
+    const ASTImage* image,
+    uint32_t index)
+{
+    if (!image || index >= image->literalCount)
+        return NULL;
+
+    return &image->literals[index];
+}
+
+PARSER_ATTR const ASTSymbolInfo* PARSER_CALL ASTImage_GetSymbol(
+    const ASTImage* image,
+    ASTSymbolId id)
+{
+    if (!image || id == AST_SYMBOL_ID_NONE || id >= image->symbolCount)
+        return NULL;
+
+    return &image->symbols[id];
+}
+
+PARSER_ATTR const ASTTypeInfo* PARSER_CALL ASTImage_GetType(
+    const ASTImage* image,
+    ASTTypeId id)
+{
+    if (!image || id == AST_TYPE_ID_NONE || id >= image->typeCount)
+        return NULL;
+
+    return &image->types[id];
+}
+
+PARSER_ATTR const ASTTypeId* PARSER_CALL ASTImage_GetTypeParams(
+    const ASTImage* image,
+    ASTTypeId id)
+{
+    const ASTTypeInfo* type = ASTImage_GetType(image, id);
+    if (!type || type->kind != AST_TYPE_KIND_FUNCTION || type->count == 0 ||
+        (uint64_t)type->value + type->count > image->typeParamCount)
+        return NULL;
+
+    return image->typeParams + type->value;
+}
+
+// ------------------------------------------------------------------------------------------------
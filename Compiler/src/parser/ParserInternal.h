@@ -0,0 +1,352 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_INTERNAL_H
+#define PARSER_INTERNAL_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/Parser.h"
+#include "parser/ParserArena.h"
+#include "ParserInternerInternal.h"
+
+#include "lexer/LexerInternal.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Function body skipped by the top-level parse
+ */
+typedef struct ASTParserLazyBody_T {
+    ASTNodeId function;         // FUNCTION_DECL of the definition
+    uint32_t open;              // Token index of the opening brace
+    uint32_t close;             // Token index of the closing brace
+} ASTParserLazyBody;
+
+/**
+ * @brief Function body lowered to IR while parsing
+ */
+typedef struct ASTParserLoweredBody_T {
+    ASTNodeId function;         // FUNCTION_DECL of the definition
+    IRFunction ir;              // Definition in the module of the parser
+} ASTParserLoweredBody;
+
+/**
+ * @brief Body of a tag that has no symbol to keep its node, e.g. an anonymous struct
+ */
+typedef struct ASTParserTagBody_T {
+    uint32_t tag;               // Tag identity of the type
+    ASTNodeId node;             // Declaration node of the body
+} ASTParserTagBody;
+
+struct ASTParser_T {
+    // ===== Input =====
+    Lexer lexer;                // Token source of the current translation unit
+
+    // ===== Output =====
+    ASTTree tree;               // Nodes of the current translation unit, reset by ASTParser_Init
+
+    // ===== Names =====
+    ParserInterner interner;    // Identifier text to id, strings live in the arena
+    ASTSymbolTable symbols;     // Scoped bindings, file scope pushed by ASTParser_Init
+    ASTTypeTable types;         // Hash-consed types of the translation unit
+
+    // ===== Memory =====
+    ParserArena arena;          // Per translation unit, reset by ASTParser_Init
+
+    // Stack of node ids for lists under construction (arguments, block
+    // items, comma operands). Each list pushes its items and pops them once
+    // the list node is added, nested lists stack on top.
+    uint32_t* scratch;
+    uint32_t scratchCount;
+    uint32_t scratchCapacity;
+
+    // ===== Function Bodies =====
+    bool lazyFunctionBodies;    // Skip bodies, parse them on demand
+    bool keepTokens;            // Keep the tokens of the unit even without skipped bodies
+    LexerCheckpoint unitStart;  // Keeps the tokens of the unit for skipped bodies and images
+    ASTParserLazyBody* lazyBodies; // Skipped bodies, ordered by function node
+    uint32_t lazyBodyCount;
+    uint32_t lazyBodyCapacity;
+    uint32_t pendingLabels;     // Labels of the current body used by goto but not defined yet
+    ASTParserStats stats;
+    bool bodyWorker;            // Worker of ASTParser_ParseFunctionBodies, names live in overlays
+
+    // ===== Lowering =====
+    IRModule module;            // Bodies are lowered into it, NULL to parse them
+    ASTParserLoweredBody* loweredBodies; // Ordered by function node
+    uint32_t loweredBodyCount;
+    uint32_t loweredBodyCapacity;
+    ASTParserTagBody* tagBodies; // Ordered by tag, kept while lowering only
+    uint32_t tagBodyCount;
+    uint32_t tagBodyCapacity;
+
+    // ===== Error Tracking =====
+    ParserResult error;         // First error, PARSER_RESULT_SUCCESS when none
+    uint32_t errorToken;        // Token index of the first error
+
+    // ===== LANGUAGE STRATEGY =====
+    const ParserLanguageStrategy* strategy;
+};
+
+/* Allocate translation unit storage, released with the arena */
+static inline void* ASTParserAlloc(ASTParser parser, size_t size)
+{
+    return ParserArena_Alloc(parser->arena, size, 0);
+}
+
+/* Allocate storage that may die before the translation unit (size-class pool) */
+static inline void* ASTParserAllocPooled(ASTParser parser, size_t size)
+{
+    return ParserArena_AllocPooled(parser->arena, size);
+}
+
+/* Return storage from ASTParserAllocPooled */
+static inline void ASTParserFreePooled(ASTParser parser, void* memory, size_t size)
+{
+    ParserArena_FreePooled(parser->arena, memory, size);
+}
+
+// ===== TOKENS =====
+
+/* Returned when the token ring could not grow, parses as an error token */
+extern const struct LexerToken_T g_ParserNoMemoryToken;
+
+/* Token `k` positions after the current one */
+static inline const struct LexerToken_T* ASTParserPeekN(ASTParser parser, uint32_t k)
+{
+    LexerToken token = LexerPeekN(parser->lexer, k);
+    return token ? token : &g_ParserNoMemoryToken;
+}
+
+static inline const struct LexerToken_T* ASTParserPeek(ASTParser parser)
+{
+    return ASTParserPeekN(parser, 0);
+}
+
+/* Absolute index of the current token, what nodes store as main token */
+static inline uint32_t ASTParserTokenIndex(ASTParser parser)
+{
+    return parser->lexer->position;
+}
+
+static inline bool ASTParserIsPunctuation(const struct LexerToken_T* token, uint32_t punctuation)
+{
+    return token->flags == TOKEN_TYPE_PUNCTUATION && token->value == punctuation;
+}
+
+static inline bool ASTParserIsKeyword(const struct LexerToken_T* token, uint32_t keyword)
+{
+    return token->flags == TOKEN_TYPE_KEYWORD && token->value == keyword;
+}
+
+/**
+ * @brief Consume the current token
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the token ring
+ *      Lexer error : The consumed token was the error token
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParserAdvance(
+    ASTParser parser);
+
+/**
+ * @brief Consume the current token if it is the given punctuation
+ *
+ * @return ParserResult
+ *      `error` : The current token is something else
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParserExpectPunctuation(
+    ASTParser parser,
+    uint32_t punctuation,
+    ParserResult error);
+
+/**
+ * @brief Record an error at the current token
+ *
+ * @description Only the first error is kept.
+ *
+ * @return `error`, so callers can return the result of the call
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParserError(
+    ASTParser parser,
+    ParserResult error);
+
+/**
+ * @brief Record an error at an earlier token, e.g. the name of a redeclaration
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParserErrorAt(
+    ASTParser parser,
+    ParserResult error,
+    uint32_t token);
+
+/**
+ * @brief Interned name of an identifier token
+ *
+ * @description The id is cached in the token value, so a token is hashed
+ *              once however often the parser asks about it.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the table
+ */
+static inline ParserResult ASTParserTokenName(ASTParser parser, LexerToken token, ParserIdentifierId* id)
+{
+    if (token->value == PARSER_IDENTIFIER_NONE)
+        CHECK_PARSER_RESULT(ParserInterner_Intern(parser->interner, token->lexeme, token->length, &token->value));
+
+    *id = token->value;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/**
+ * @brief Is a name bound to a typedef in the current scope
+ *
+ * @description Reads the typedef bit of the interner. Body workers share the
+ *              interner read-only and their symbol tables do not keep the
+ *              bits, they look the name up instead.
+ */
+static inline bool ASTParserIsTypedefName(ASTParser parser, ParserIdentifierId name)
+{
+    if (!parser->bodyWorker)
+        return ParserInternerIsTypedef(parser->interner, name);
+
+    ASTSymbolId symbol = ASTSymbolTable_Lookup(parser->symbols, AST_NAMESPACE_ORDINARY, name, 0);
+    return symbol != AST_SYMBOL_ID_NONE &&
+        ASTSymbolTable_GetSymbol(parser->symbols, symbol)->kind == AST_SYMBOL_KIND_TYPEDEF;
+}
+
+/* Value of a numeric literal token, by the index its node stores */
+static inline const LexerLiteral* ASTParserGetLiteral(ASTParser parser, uint32_t index)
+{
+    return &parser->lexer->literals.items[index];
+}
+
+// ===== FUNCTION BODIES =====
+
+/**
+ * @brief Skip the function body at the current token by matching braces
+ *
+ * @description Records the token range for ASTParser_ParseFunctionBody,
+ *              no nodes are built and no names are looked up.
+ *
+ * @param parser[in] Parser handle
+ * @param function[in] FUNCTION_DECL of the definition
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_UNCLOSED_BRACE : The input ends inside the body
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the body table
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParserSkipFunctionBody(
+    ASTParser parser,
+    ASTNodeId function);
+
+/**
+ * @brief Find the skipped body of a function
+ *
+ * @return Body record, NULL when the body was not skipped
+ */
+PARSER_ATTR const ASTParserLazyBody* PARSER_CALL ASTParserFindLazyBody(
+    const ASTParser parser,
+    ASTNodeId function);
+
+/**
+ * @brief Parse or lower the body of a definition at the current token
+ *
+ * @description With a module the strategy lowers the body first. When it
+ *              gives up, the lexer returns to the opening brace, the nodes
+ *              it added are dropped and the body is parsed.
+ *
+ * @param parser[in] Parser handle
+ * @param function[in] FUNCTION_DECL of the definition
+ * @param body[out] Body node, AST_NODE_ID_NONE when the body was lowered
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the lowered body table
+ *      Parse error : First error in the body
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParserParseBody(
+    ASTParser parser,
+    ASTNodeId function,
+    ASTNodeId* body);
+
+/**
+ * @brief Find the lowered body of a function
+ *
+ * @return Body record, NULL when the body was not lowered
+ */
+PARSER_ATTR const ASTParserLoweredBody* PARSER_CALL ASTParserFindLoweredBody(
+    const ASTParser parser,
+    ASTNodeId function);
+
+/**
+ * @brief Remember the body node of a tag without a symbol
+ *
+ * @description Only while lowering, which needs the members to lay out the
+ *              type. The table is kept in tag order.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the table
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParserAddTagBody(
+    ASTParser parser,
+    uint32_t tag,
+    ASTNodeId node);
+
+/**
+ * @brief Find the body node of a tag without a symbol
+ *
+ * @return Node id, AST_NODE_ID_NONE when it was not recorded
+ */
+PARSER_ATTR ASTNodeId PARSER_CALL ASTParserFindTagBody(
+    const ASTParser parser,
+    uint32_t tag);
+
+// ===== NODES =====
+
+/**
+ * @brief Push a node id on the scratch stack
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the stack
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParserScratchPush(
+    ASTParser parser,
+    uint32_t value);
+
+/**
+ * @brief Add a list node from the scratch entries above `base` and pop them
+ */
+PARSER_ATTR ParserResult PARSER_CALL ASTParserAddScratchList(
+    ASTParser parser,
+    uint32_t base,
+    ParserASTNodeType type,
+    uint16_t subtype,
+    uint32_t mainToken,
+    ASTNodeId* id);
+
+static inline ParserResult ASTParserAddNode(
+    ASTParser parser,
+    ParserASTNodeType type,
+    uint16_t subtype,
+    uint32_t mainToken,
+    uint32_t lhs,
+    uint32_t rhs,
+    ASTNodeId* id)
+{
+    ASTNodeData data;
+    data.lhs = lhs;
+    data.rhs = rhs;
+    return ASTTree_AddNode(parser->tree, type, subtype, mainToken, data, id);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+#endif // !PARSER_INTERNAL_H
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,231 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserInternerInternal.h"
+#include "ParserArray.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/* Word at a time multiply-xor hash, identifiers are short */
+static uint32_t ParserInternerHash(const char* text, uint32_t length)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ length;
+
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, text, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+        text += 8;
+        length -= 8;
+    }
+
+    uint64_t tail = 0;
+    memcpy(&tail, text, length);
+    hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 29;
+
+    return (uint32_t)hash ^ (uint32_t)(hash >> 32);
+}
+
+static ParserResult ParserInternerGrowSlots(ParserInterner interner, uint32_t slotCount)
+{
+    uint32_t* slots = PARSER_MALLOC(sizeof(uint32_t) * slotCount, 0);
+    if (!slots)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(slots, 0, sizeof(uint32_t) * slotCount);
+
+    // Rehash from the stored hashes, the text is not touched
+    uint32_t mask = slotCount - 1;
+    for (uint32_t id = 1; id < interner->count; id++) {
+        uint32_t i = interner->records[id].hash & mask;
+        while (slots[i])
+            i = (i + 1) & mask;
+        slots[i] = id;
+    }
+
+    PARSER_FREE(interner->slots);
+    interner->slots = slots;
+    interner->slotMask = mask;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserInternerGrowRecords(ParserInterner interner)
+{
+    return ParserArrayReserve((void**)&interner->records, &interner->capacity, interner->count, interner->count + 1,
+        sizeof(ParserIdentifier), 256);
+}
+
+/* Slot holding the identifier, or the empty slot it would go in */
+static uint32_t* ParserInternerProbe(const ParserInterner interner, const char* text, uint32_t length, uint32_t hash)
+{
+    uint32_t i = hash & interner->slotMask;
+
+    for (;;) {
+        uint32_t* slot = &interner->slots[i];
+        if (*slot == 0)
+            return slot;
+
+        const ParserIdentifier* record = &interner->records[*slot];
+        if (record->hash == hash && record->length == length && memcmp(record->text, text, length) == 0)
+            return slot;
+
+        i = (i + 1) & interner->slotMask;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateParserInterner(
+    ParserArena arena,
+    ParserInterner* interner)
+{
+    if (!arena || !interner)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ParserInterner hdl = PARSER_MALLOC(sizeof(struct ParserInterner_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ParserInterner_T));
+    hdl->arena = arena;
+    hdl->count = 1;
+
+    if (ParserInternerGrowRecords(hdl) != PARSER_RESULT_SUCCESS ||
+        ParserInternerGrowSlots(hdl, PARSER_INTERNER_INITIAL_SLOTS) != PARSER_RESULT_SUCCESS) {
+        ParserInternerDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    memset(&hdl->records[0], 0, sizeof(ParserIdentifier));
+
+    *interner = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserInterner_Intern(
+    ParserInterner interner,
+    const char* text,
+    uint32_t length,
+    ParserIdentifierId* id)
+{
+    if (!interner || !id || (length && !text))
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint32_t hash = ParserInternerHash(text, length);
+    uint32_t* slot = ParserInternerProbe(interner, text, length, hash);
+
+    if (*slot) {
+        *id = *slot;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    // ===== NEW IDENTIFIER =====
+    if (interner->count == interner->capacity)
+        CHECK_PARSER_RESULT(ParserInternerGrowRecords(interner));
+
+    char* copy = ParserArena_Alloc(interner->arena, (size_t)length + 1, 1);
+    if (!copy)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+
+    uint32_t newId = interner->count++;
+    ParserIdentifier* record = &interner->records[newId];
+    record->text = copy;
+    record->length = length;
+    record->hash = hash;
+    record->flags = PARSER_IDENTIFIER_FLAG_NONE;
+
+    *slot = newId;
+
+    // Keep the load factor under one half
+    if (interner->count * 2 > interner->slotMask + 1) {
+        ParserResult result = ParserInternerGrowSlots(interner, (interner->slotMask + 1) * 2);
+        if (result != PARSER_RESULT_SUCCESS) {
+            *slot = 0;
+            interner->count--;
+            return result;
+        }
+    }
+
+    *id = newId;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserIdentifierId PARSER_CALL ParserInterner_Find(
+    const ParserInterner interner,
+    const char* text,
+    uint32_t length)
+{
+    if (!interner || (length && !text))
+        return PARSER_IDENTIFIER_NONE;
+
+    return *ParserInternerProbe(interner, text, length, ParserInternerHash(text, length));
+}
+
+PARSER_ATTR const ParserIdentifier* PARSER_CALL ParserInterner_Get(
+    const ParserInterner interner,
+    ParserIdentifierId id)
+{
+    if (!interner || id == PARSER_IDENTIFIER_NONE || id >= interner->count)
+        return NULL;
+
+    return &interner->records[id];
+}
+
+PARSER_ATTR void PARSER_CALL ParserInterner_SetFlags(
+    ParserInterner interner,
+    ParserIdentifierId id,
+    uint32_t flags,
+    bool set)
+{
+    if (!interner || id == PARSER_IDENTIFIER_NONE || id >= interner->count)
+        return;
+
+    if (set)
+        interner->records[id].flags |= flags;
+    else
+        interner->records[id].flags &= ~flags;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ParserInterner_GetCount(
+    const ParserInterner interner)
+{
+    return interner ? interner->count - 1 : 0;
+}
+
+PARSER_ATTR void PARSER_CALL ParserInterner_Reset(
+    ParserInterner interner)
+{
+    if (!interner)
+        return;
+
+    interner->count = 1;
+    memset(interner->slots, 0, sizeof(uint32_t) * (interner->slotMask + 1));
+}
+
+PARSER_ATTR void PARSER_CALL ParserInternerDestroy(
+    ParserInterner interner)
+{
+    if (!interner)
+        return;
+
+    PARSER_FREE(interner->records);
+    PARSER_FREE(interner->slots);
+    PARSER_FREE(interner);
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,39 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_INTERNER_INTERNAL_H
+#define PARSER_INTERNER_INTERNAL_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserInterner.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+struct ParserInterner_T {
+    ParserArena arena;              // Identifier text, owned by the caller
+
+    ParserIdentifier* records;      // Indexed by id, record 0 is unused
+    uint32_t count;                 // Including record 0
+    uint32_t capacity;
+
+    uint32_t* slots;                // Ids, 0 marks an empty slot
+    uint32_t slotMask;              // Slot count - 1, a power of two
+};
+
+/* Typedef bit of an interned identifier, a single load for the parser */
+static inline bool ParserInternerIsTypedef(const ParserInterner interner, ParserIdentifierId id)
+{
+    return (interner->records[id].flags & PARSER_IDENTIFIER_FLAG_TYPEDEF) != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+
+#endif // !PARSER_INTERNER_INTERNAL_H
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,462 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserInternal.h"
+#include "ParserThread.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/**
+ * @brief One skipped body and what parsing it left in the overlays of its worker
+ */
+typedef struct ASTParserBodyTask_T {
+    uint32_t lazy;              // Index in the skipped body table
+    uint32_t worker;            // Worker that parsed the body
+
+    ASTTreeMark begin;          // Overlay nodes of the body
+    ASTTreeMark end;
+    ASTSymbolId symbolFirst;    // Overlay symbols of the body
+    ASTSymbolId symbolEnd;
+    ASTTypeId typeFirst;        // Overlay types of the body
+    ASTTypeId typeEnd;
+
+    ASTNodeId body;             // Overlay id of the body node
+    uint32_t folded;            // Constant expressions folded in the body
+    ParserResult result;
+    uint32_t errorToken;
+} ASTParserBodyTask;
+
+/**
+ * @brief Parser of one thread
+ *
+ * @description A copy of the parser with its own token cursor, scratch
+ *              stack, arena and errors. Nodes, symbols and types go to
+ *              overlays of the tables of the unit, the interner and the
+ *              tokens are shared and only read.
+ */
+typedef struct ASTParserBodyWorker_T {
+    struct ASTParser_T parser;
+    struct Lexer_T lexer;
+
+    // Task indices [head, tail) the worker owns, head in the high half.
+    // The owner takes the head, thieves cut off the back half.
+    volatile int64_t range;
+
+    uint32_t index;
+    uint32_t first;             // Range the worker started with
+    uint32_t end;
+    uint32_t stolen;            // Tasks parsed from outside that range
+    struct ASTParserBodyPool_T* pool;
+} ASTParserBodyWorker;
+
+typedef struct ASTParserBodyPool_T {
+    ASTParserBodyWorker* workers;
+    uint32_t workerCount;
+    ASTParserBodyTask* tasks;
+    uint32_t taskCount;
+} ASTParserBodyPool;
+
+static inline int64_t ASTParserPackRange(uint32_t head, uint32_t tail)
+{
+    return (int64_t)(((uint64_t)head << 32) | tail);
+}
+
+static inline uint32_t ASTParserRangeHead(int64_t range)
+{
+    return (uint32_t)((uint64_t)range >> 32);
+}
+
+static inline uint32_t ASTParserRangeTail(int64_t range)
+{
+    return (uint32_t)range;
+}
+
+/* Take the next task of the worker's own range */
+static bool ASTParserPopBodyTask(ASTParserBodyWorker* worker, uint32_t* task)
+{
+    int64_t range = ParserAtomicLoad64(&worker->range);
+
+    for (;;) {
+        uint32_t head = ASTParserRangeHead(range);
+        uint32_t tail = ASTParserRangeTail(range);
+        if (head >= tail)
+            return false;
+
+        if (ParserAtomicCompareExchange64(&worker->range, &range, ASTParserPackRange(head + 1, tail))) {
+            *task = head;
+            return true;
+        }
+    }
+}
+
+/**
+ * Take the back half of the range of another worker. The first stolen task
+ * is returned, the others become the range of the thief. A task is never in
+ * two ranges, so a stale range can not match again and the exchange needs no
+ * tag.
+ */
+static bool ASTParserStealBodyTask(ASTParserBodyWorker* worker, uint32_t* task)
+{
+    ASTParserBodyPool* pool = worker->pool;
+
+    for (uint32_t i = 1; i < pool->workerCount; i++) {
+        ASTParserBodyWorker* victim = &pool->workers[(worker->index + i) % pool->workerCount];
+        int64_t range = ParserAtomicLoad64(&victim->range);
+
+        for (;;) {
+            uint32_t head = ASTParserRangeHead(range);
+            uint32_t tail = ASTParserRangeTail(range);
+            if (head >= tail)
+                break;
+
+            uint32_t split = tail - (tail - head + 1) / 2;
+            if (!ParserAtomicCompareExchange64(&victim->range, &range, ASTParserPackRange(head, split)))
+                continue;
+
+            ParserAtomicStore64(&worker->range, ASTParserPackRange(split + 1, tail));
+            *task = split;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void ASTParserRunBodyTask(ASTParserBodyWorker* worker, ASTParserBodyTask* task)
+{
+    ASTParser parser = &worker->parser;
+    const ASTParserLazyBody* lazy = &parser->lazyBodies[task->lazy];
+
+    parser->error = PARSER_RESULT_SUCCESS;
+    parser->errorToken = 0;
+    parser->scratchCount = 0;
+
+    task->worker = worker->index;
+    ASTTree_GetMark(parser->tree, &task->begin);
+    task->symbolFirst = ASTSymbolTable_GetSymbolCount(parser->symbols) + 1;
+    task->typeFirst = ASTTypeTable_BeginRange(parser->types);
+    uint32_t folded = parser->stats.foldedExpressions;
+
+    ASTNode body = NULL;
+    ParserResult result = LexerSeek(parser->lexer, lazy->open);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = parser->strategy->parseFunctionBody(parser, AST_NODE_FROM_ID(lazy->function), &body);
+
+    ASTTree_GetMark(parser->tree, &task->end);
+    task->symbolEnd = ASTSymbolTable_GetSymbolCount(parser->symbols) + 1;
+    task->typeEnd = ASTTypeTable_GetTypeCount(parser->types) + 1;
+
+    task->body = AST_NODE_TO_ID(body);
+    task->folded = parser->stats.foldedExpressions - folded;
+    task->result = result;
+    task->errorToken = parser->error != PARSER_RESULT_SUCCESS ? parser->errorToken : lazy->open;
+
+    // An error can leave block scopes open, the next body starts at file scope
+    if (result != PARSER_RESULT_SUCCESS) {
+        while (ASTSymbolTable_GetDepth(parser->symbols) > 0)
+            ASTSymbolTable_PopScope(parser->symbols, NULL);
+    }
+}
+
+static void PARSER_PTR ASTParserBodyWorkerEntry(void* userData)
+{
+    ASTParserBodyWorker* worker = (ASTParserBodyWorker*)userData;
+    uint32_t task;
+
+    while (ASTParserPopBodyTask(worker, &task) || ASTParserStealBodyTask(worker, &task)) {
+        if (task < worker->first || task >= worker->end)
+            worker->stolen++;
+
+        ASTParserRunBodyTask(worker, &worker->pool->tasks[task]);
+    }
+}
+
+static ParserResult ASTParserCreateBodyWorker(ASTParser parser, ASTParserBodyWorker* worker)
+{
+    ASTParser clone = &worker->parser;
+
+    worker->lexer = *parser->lexer;
+    clone->lexer = &worker->lexer;
+    clone->interner = parser->interner;
+    clone->strategy = parser->strategy;
+    clone->lazyBodies = parser->lazyBodies;
+    clone->lazyBodyCount = parser->lazyBodyCount;
+    clone->bodyWorker = true;
+
+    ParserArenaConfig arenaConfig = { 0 };
+
+    CHECK_PARSER_RESULT(ParserArena_Create(&arenaConfig, &clone->arena));
+    CHECK_PARSER_RESULT(CreateASTTreeOverlay(parser->tree, 0, &clone->tree));
+    CHECK_PARSER_RESULT(CreateASTSymbolTableOverlay(parser->symbols, &clone->symbols));
+    CHECK_PARSER_RESULT(CreateASTTypeTableOverlay(parser->types, &clone->types));
+
+    return ASTSymbolTable_PushScope(clone->symbols, AST_SCOPE_KIND_FILE, NULL);
+}
+
+static void ASTParserDestroyBodyWorker(ASTParserBodyWorker* worker)
+{
+    ASTParser clone = &worker->parser;
+
+    ASTTypeTableDestroy(clone->types);
+    ASTSymbolTableDestroy(clone->symbols);
+    ASTTreeDestroy(clone->tree);
+    PARSER_FREE(clone->scratch);
+    ParserArena_Destroy(clone->arena);
+}
+
+/* Id of an overlay word in [first, end) once merged at `target`, other words stay */
+static inline uint32_t ASTParserMergeId(uint32_t id, uint32_t first, uint32_t end, uint32_t target)
+{
+    return (id >= first && id < end) ? target + (id - first) : id;
+}
+
+/* Id of an overlay type of a task in the table of the unit, once mapped at `mapBase` of the scratch stack */
+static inline ASTTypeId ASTParserMergeType(const ASTParser parser, uint32_t mapBase, const ASTParserBodyTask* task,
+    ASTTypeId id)
+{
+    return (id >= task->typeFirst && id < task->typeEnd) ? parser->scratch[mapBase + (id - task->typeFirst)] : id;
+}
+
+/**
+ * Import the types of a task into the table of the unit in id order, pushing
+ * the id each one gets. Types only refer to types made before them, which
+ * are mapped by then.
+ */
+static ParserResult ASTParserMergeBodyTypes(ASTParser parser, const ASTParserBodyWorker* worker,
+    const ASTParserBodyTask* task, const ASTTreeMergeMap* map, ASTNodeId nodeTarget)
+{
+    ASTTypeTable types = worker->parser.types;
+    uint32_t mapBase = parser->scratchCount;
+
+    for (ASTTypeId id = task->typeFirst; id < task->typeEnd; id++) {
+        ASTTypeInfo info = *ASTTypeTable_Get(types, id);
+
+        info.base = ASTParserMergeType(parser, mapBase, task, info.base);
+        info.unqualified = ASTParserMergeType(parser, mapBase, task, info.unqualified);
+
+        // Tags are symbols, the size expression of an unsized array is a node
+        if (info.kind == AST_TYPE_KIND_STRUCT || info.kind == AST_TYPE_KIND_UNION || info.kind == AST_TYPE_KIND_ENUM)
+            info.value = ASTParserMergeId(info.value, map->symbolFirst, map->symbolEnd, map->symbolTarget);
+        else if (info.kind == AST_TYPE_KIND_ARRAY && !(info.flags & AST_TYPE_FLAG_SIZED))
+            info.value = ASTParserMergeId(info.value, task->begin.node, task->end.node, nodeTarget);
+
+        // Parameters go on the stack above the map while the type is imported
+        uint32_t base = parser->scratchCount;
+        const ASTTypeId* params = info.kind == AST_TYPE_KIND_FUNCTION ? ASTTypeTable_GetParams(types, id) : NULL;
+
+        for (uint32_t i = 0; params && i < info.count; i++)
+            CHECK_PARSER_RESULT(ASTParserScratchPush(parser, ASTParserMergeType(parser, mapBase, task, params[i])));
+
+        ASTTypeId imported;
+        ParserResult result = ASTTypeTable_Import(parser->types, &info, parser->scratch + base, &imported);
+        parser->scratchCount = base;
+        CHECK_PARSER_RESULT(result);
+
+        CHECK_PARSER_RESULT(ASTParserScratchPush(parser, imported));
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Append the nodes, symbols and types of a parsed body to the unit and attach the body */
+static ParserResult ASTParserMergeBody(ASTParser parser, const ASTParserBodyPool* pool, const ASTParserBodyTask* task)
+{
+    const ASTParserBodyWorker* worker = &pool->workers[task->worker];
+    const ASTParserLazyBody* lazy = &parser->lazyBodies[task->lazy];
+
+    ASTTreeMergeMap map;
+    map.symbolFirst = task->symbolFirst;
+    map.symbolEnd = task->symbolEnd;
+    map.symbolTarget = ASTSymbolTable_GetSymbolCount(parser->symbols) + 1;
+    map.typeFirst = task->typeFirst;
+    map.typeEnd = task->typeEnd;
+
+    ASTNodeId nodeTarget = ASTTree_GetNodeCount(parser->tree);
+
+    // ===== TYPES =====
+    uint32_t base = parser->scratchCount;
+    ParserResult result = ASTParserMergeBodyTypes(parser, worker, task, &map, nodeTarget);
+
+    // ===== NODES =====
+    ASTNodeId first = nodeTarget;
+    if (result == PARSER_RESULT_SUCCESS) {
+        map.types = parser->scratch + base;
+        result = ASTTree_Merge(parser->tree, worker->parser.tree, &task->begin, &task->end, &map, &first);
+    }
+
+    // ===== SYMBOLS =====
+    for (ASTSymbolId id = task->symbolFirst; id < task->symbolEnd && result == PARSER_RESULT_SUCCESS; id++) {
+        ASTSymbolInfo info = *ASTSymbolTable_GetSymbol(worker->parser.symbols, id);
+
+        info.node = ASTParserMergeId(info.node, task->begin.node, task->end.node, first);
+        info.owner = ASTParserMergeId(info.owner, map.symbolFirst, map.symbolEnd, map.symbolTarget);
+        info.shadowed = ASTParserMergeId(info.shadowed, map.symbolFirst, map.symbolEnd, map.symbolTarget);
+        info.type = ASTParserMergeType(parser, base, task, info.type);
+
+        ASTSymbolId merged;
+        result = ASTSymbolTable_AddRecord(parser->symbols, &info, &merged);
+    }
+
+    parser->scratchCount = base;
+    CHECK_PARSER_RESULT(result);
+
+    ASTNodeId body = ASTParserMergeId(task->body, task->begin.node, task->end.node, first);
+    CHECK_PARSER_RESULT(ASTTree_SetChild(parser->tree, lazy->function, 1, body));
+
+    parser->stats.parsedBodies++;
+    parser->stats.foldedExpressions += task->folded;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL ASTParser_ParseFunctionBodies(
+    ASTParser parser,
+    uint32_t threadCount)
+{
+    if (!parser)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (!parser->strategy->parseFunctionBody)
+        return PARSER_ERROR_INVALID_STRATEGY;
+
+    if (!ParserThreadSafeAllocator())
+        return PARSER_ERROR_UNSUPPORTED;
+
+    // Workers read the tokens through copies of the lexer, which only works
+    // once everything up to EOF sits in the ring
+    Lexer lexer = parser->lexer;
+    if (lexer->filled == 0 || LexerRingAt(lexer, lexer->filled - 1)->flags != TOKEN_TYPE_EOF)
+        return PARSER_ERROR_INVALID_ARG;
+
+    // ===== COLLECT THE SKIPPED BODIES =====
+    ASTParserBodyPool pool;
+    memset(&pool, 0, sizeof(pool));
+
+    if (parser->lazyBodyCount) {
+        pool.tasks = PARSER_MALLOC(sizeof(ASTParserBodyTask) * parser->lazyBodyCount, 0);
+        if (!pool.tasks)
+            return PARSER_ERROR_NO_MEMORY;
+    }
+
+    for (uint32_t i = 0; i < parser->lazyBodyCount; i++) {
+        if (ASTTree_GetChild(parser->tree, parser->lazyBodies[i].function, 1) != AST_NODE_ID_NONE)
+            continue;
+
+        memset(&pool.tasks[pool.taskCount], 0, sizeof(ASTParserBodyTask));
+        pool.tasks[pool.taskCount++].lazy = i;
+    }
+
+    if (pool.taskCount == 0) {
+        PARSER_FREE(pool.tasks);
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    // ===== INTERN THE NAMES =====
+    // Identifier tokens cache their interned id. Interning every name of the
+    // bodies up front leaves workers nothing to write to the tokens or the
+    // interner.
+    ParserResult result = PARSER_RESULT_SUCCESS;
+
+    for (uint32_t i = 0; i < pool.taskCount && result == PARSER_RESULT_SUCCESS; i++) {
+        const ASTParserLazyBody* lazy = &parser->lazyBodies[pool.tasks[i].lazy];
+
+        for (uint32_t index = lazy->open; index <= lazy->close && result == PARSER_RESULT_SUCCESS; index++) {
+            struct LexerToken_T* token = LexerRingAt(lexer, index);
+            if (token->flags != TOKEN_TYPE_IDENTIFIER)
+                continue;
+
+            ParserIdentifierId name;
+            result = ASTParserTokenName(parser, token, &name);
+        }
+    }
+
+    // ===== START THE WORKERS =====
+    uint32_t workerCount = threadCount ? threadCount : ParserThreadHardwareConcurrency();
+    if (workerCount > pool.taskCount)
+        workerCount = pool.taskCount;
+    if (workerCount > AST_PARSER_MAX_BODY_THREADS)
+        workerCount = AST_PARSER_MAX_BODY_THREADS;
+
+    if (result == PARSER_RESULT_SUCCESS) {
+        pool.workers = PARSER_MALLOC(sizeof(ASTParserBodyWorker) * workerCount, 0);
+        if (!pool.workers)
+            result = PARSER_ERROR_NO_MEMORY;
+    }
+
+    if (result == PARSER_RESULT_SUCCESS) {
+        memset(pool.workers, 0, sizeof(ASTParserBodyWorker) * workerCount);
+
+        for (uint32_t i = 0; i < workerCount && result == PARSER_RESULT_SUCCESS; i++) {
+            ASTParserBodyWorker* worker = &pool.workers[i];
+            worker->index = i;
+            worker->pool = &pool;
+            worker->first = (uint32_t)((uint64_t)pool.taskCount * i / workerCount);
+            worker->end = (uint32_t)((uint64_t)pool.taskCount * (i + 1) / workerCount);
+            worker->range = ASTParserPackRange(worker->first, worker->end);
+
+            pool.workerCount++;
+            result = ASTParserCreateBodyWorker(parser, worker);
+        }
+    }
+
+    // ===== PARSE =====
+    // Worker 0 runs on the calling thread. The ranges of workers whose thread
+    // could not be started are stolen by the others.
+    uint32_t started = 0;
+
+    if (result == PARSER_RESULT_SUCCESS) {
+        ParserThread threads[AST_PARSER_MAX_BODY_THREADS];
+        started = 1;
+
+        for (uint32_t i = 1; i < workerCount; i++) {
+            if (ParserThreadCreate(ASTParserBodyWorkerEntry, &pool.workers[i], &threads[started]) != PARSER_RESULT_SUCCESS)
+                break;
+            started++;
+        }
+
+        ASTParserBodyWorkerEntry(&pool.workers[0]);
+
+        for (uint32_t i = 1; i < started; i++)
+            ParserThreadJoin(threads[i]);
+    }
+
+    // ===== MERGE IN SOURCE ORDER =====
+    for (uint32_t i = 0; i < pool.taskCount && result == PARSER_RESULT_SUCCESS; i++) {
+        const ASTParserBodyTask* task = &pool.tasks[i];
+
+        if (task->result != PARSER_RESULT_SUCCESS) {
+            result = ASTParserErrorAt(parser, task->result, task->errorToken);
+            break;
+        }
+
+        result = ASTParserMergeBody(parser, &pool, task);
+        if (result != PARSER_RESULT_SUCCESS)
+            ASTParserErrorAt(parser, result, parser->lazyBodies[task->lazy].open);
+    }
+
+    if (started) {
+        parser->stats.bodyThreads = started;
+        parser->stats.stolenBodies = 0;
+        for (uint32_t i = 0; i < pool.workerCount; i++)
+            parser->stats.stolenBodies += pool.workers[i].stolen;
+    }
+
+    for (uint32_t i = 0; i < pool.workerCount; i++)
+        ASTParserDestroyBodyWorker(&pool.workers[i]);
+
+    PARSER_FREE(pool.workers);
+    PARSER_FREE(pool.tasks);
+
+    return result;
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,471 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserSymbol.h"
+#include "ParserArray.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/* Binding of one (name, name space, owner) key, symbol 0 once unbound */
+typedef struct ASTSymbolSlot_T {
+    uint32_t name;                  // 0 marks an empty slot
+    uint32_t space;
+    uint32_t owner;
+    uint32_t symbol;
+} ASTSymbolSlot;
+
+typedef struct ASTScopeFrame_T {
+    uint32_t kind;                  // ASTScopeKind
+    uint32_t undoBase;              // First undo entry of the scope
+    uint32_t labelBase;             // First label entry, function scopes only
+} ASTScopeFrame;
+
+struct ASTSymbolTable_T {
+    ParserInterner interner;        // Typedef bits of the names, may be NULL
+
+    ASTSymbolInfo* symbols;         // Indexed by id - base, record 0 of a table is unused
+    uint32_t symbolCount;           // Records, including record 0 of a table
+    uint32_t symbolCapacity;
+
+    ASTSymbolSlot* slots;
+    uint32_t slotMask;              // Slot count - 1, a power of two
+    uint32_t slotUsed;              // Keys in the table, bound or not
+
+    uint32_t* undo;                 // Symbols declared per scope, innermost last
+    uint32_t undoCount;
+    uint32_t undoCapacity;
+
+    uint32_t* labels;               // Labels per function scope
+    uint32_t labelCount;
+    uint32_t labelCapacity;
+
+    ASTScopeFrame* scopes;
+    uint32_t scopeCount;
+    uint32_t scopeCapacity;
+
+    // ===== Overlay =====
+    const struct ASTSymbolTable_T* parent;  // Read-only table below the overlay, NULL otherwise
+    uint32_t base;                  // Id of record 0, the id count of the parent
+};
+
+static uint32_t ASTSymbolHash(uint32_t name, uint32_t space, uint32_t owner)
+{
+    uint32_t hash = name * 0x9E3779B1u ^ space * 0x85EBCA77u ^ owner * 0xC2B2AE3Du;
+    return hash ^ (hash >> 15);
+}
+
+/* Record of a symbol, in the table or overlay below `symbols` that holds it */
+static ASTSymbolInfo* ASTSymbolTableAt(const struct ASTSymbolTable_T* symbols, ASTSymbolId id)
+{
+    while (id < symbols->base)
+        symbols = symbols->parent;
+
+    uint32_t index = id - symbols->base;
+    if (index >= symbols->symbolCount || (index == 0 && !symbols->parent))
+        return NULL;
+
+    return &symbols->symbols[index];
+}
+
+/* Slot holding the key, or the empty slot it would go in */
+static ASTSymbolSlot* ASTSymbolTableProbe(const ASTSymbolTable symbols, uint32_t name, uint32_t space, uint32_t owner)
+{
+    uint32_t i = ASTSymbolHash(name, space, owner) & symbols->slotMask;
+
+    for (;;) {
+        ASTSymbolSlot* slot = &symbols->slots[i];
+        if (slot->name == 0 || (slot->name == name && slot->space == space && slot->owner == owner))
+            return slot;
+
+        i = (i + 1) & symbols->slotMask;
+    }
+}
+
+/* Rehash into `slotCount` slots, dropping keys that are no longer bound */
+static ParserResult ASTSymbolTableRehash(ASTSymbolTable symbols, uint32_t slotCount)
+{
+    ASTSymbolSlot* slots = PARSER_MALLOC(sizeof(ASTSymbolSlot) * slotCount, 0);
+    if (!slots)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(slots, 0, sizeof(ASTSymbolSlot) * slotCount);
+
+    ASTSymbolSlot* old = symbols->slots;
+    uint32_t oldCount = old ? symbols->slotMask + 1 : 0;
+
+    symbols->slots = slots;
+    symbols->slotMask = slotCount - 1;
+    symbols->slotUsed = 0;
+
+    for (uint32_t i = 0; i < oldCount; i++) {
+        if (old[i].name == 0 || old[i].symbol == AST_SYMBOL_ID_NONE)
+            continue;
+
+        *ASTSymbolTableProbe(symbols, old[i].name, old[i].space, old[i].owner) = old[i];
+        symbols->slotUsed++;
+    }
+
+    PARSER_FREE(old);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Make `symbol` the visible ordinary binding of `name` for the typedef bit */
+static void ASTSymbolTableSetTypedef(ASTSymbolTable symbols, ParserIdentifierId name, ASTSymbolId symbol)
+{
+    if (!symbols->interner)
+        return;
+
+    bool typedefName = symbol != AST_SYMBOL_ID_NONE && ASTSymbolTableAt(symbols, symbol)->kind == AST_SYMBOL_KIND_TYPEDEF;
+    ParserInterner_SetFlags(symbols->interner, name, PARSER_IDENTIFIER_FLAG_TYPEDEF, typedefName);
+}
+
+/* Undo the bindings in log[base..count) newest first */
+static void ASTSymbolTableUnbind(ASTSymbolTable symbols, const uint32_t* log, uint32_t base, uint32_t count)
+{
+    for (uint32_t i = count; i > base; i--) {
+        const ASTSymbolInfo* symbol = ASTSymbolTableAt(symbols, log[i - 1]);
+        ASTSymbolTableProbe(symbols, symbol->name, symbol->space, symbol->owner)->symbol = symbol->shadowed;
+
+        if (symbol->space == AST_NAMESPACE_ORDINARY)
+            ASTSymbolTableSetTypedef(symbols, symbol->name, symbol->shadowed);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateASTSymbolTable(
+    ParserInterner interner,
+    ASTSymbolTable* symbols)
+{
+    if (!symbols)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTSymbolTable hdl = PARSER_MALLOC(sizeof(struct ASTSymbolTable_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ASTSymbolTable_T));
+    hdl->interner = interner;
+
+    if (ParserArrayReserve((void**)&hdl->symbols, &hdl->symbolCapacity, 0,
+        1, sizeof(ASTSymbolInfo), 256) != PARSER_RESULT_SUCCESS ||
+        ASTSymbolTableRehash(hdl, AST_SYMBOL_TABLE_INITIAL_SLOTS) != PARSER_RESULT_SUCCESS) {
+        ASTSymbolTableDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    ASTSymbolTable_Reset(hdl);
+
+    *symbols = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL ASTSymbolTable_Reset(
+    ASTSymbolTable symbols)
+{
+    if (!symbols)
+        return;
+
+    // Every ordinary binding is in the undo log, unwinding it clears the bits
+    if (symbols->interner)
+        ASTSymbolTableUnbind(symbols, symbols->undo, 0, symbols->undoCount);
+
+    // Record 0 of a table is the none symbol, an overlay has no none symbol
+    if (symbols->parent) {
+        symbols->symbolCount = 0;
+    }
+    else {
+        memset(&symbols->symbols[0], 0, sizeof(ASTSymbolInfo));
+        symbols->symbolCount = 1;
+    }
+
+    memset(symbols->slots, 0, sizeof(ASTSymbolSlot) * (symbols->slotMask + 1));
+    symbols->slotUsed = 0;
+
+    symbols->undoCount = 0;
+    symbols->labelCount = 0;
+    symbols->scopeCount = 0;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL CreateASTSymbolTableOverlay(
+    const ASTSymbolTable parent,
+    ASTSymbolTable* symbols)
+{
+    if (!parent || !symbols)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTSymbolTable hdl = PARSER_MALLOC(sizeof(struct ASTSymbolTable_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ASTSymbolTable_T));
+    hdl->parent = parent;
+    hdl->base = parent->base + parent->symbolCount;
+
+    if (ASTSymbolTableRehash(hdl, AST_SYMBOL_TABLE_INITIAL_SLOTS) != PARSER_RESULT_SUCCESS) {
+        ASTSymbolTableDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    *symbols = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL ASTSymbolTableDestroy(
+    ASTSymbolTable symbols)
+{
+    if (!symbols)
+        return;
+
+    PARSER_FREE(symbols->symbols);
+    PARSER_FREE(symbols->slots);
+    PARSER_FREE(symbols->undo);
+    PARSER_FREE(symbols->labels);
+    PARSER_FREE(symbols->scopes);
+    PARSER_FREE(symbols);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTSymbolTable_PushScope(
+    ASTSymbolTable symbols,
+    ASTScopeKind kind,
+    ASTScope* scope)
+{
+    if (!symbols)
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&symbols->scopes, &symbols->scopeCapacity, symbols->scopeCount,
+        symbols->scopeCount + 1, sizeof(ASTScopeFrame), 256));
+
+    ASTScopeFrame* frame = &symbols->scopes[symbols->scopeCount++];
+    frame->kind = kind;
+    frame->undoBase = symbols->undoCount;
+    frame->labelBase = symbols->labelCount;
+
+    if (scope)
+        *scope = (ASTScope)(uintptr_t)symbols->scopeCount;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTSymbolTable_PopScope(
+    ASTSymbolTable symbols,
+    ASTScope scope)
+{
+    if (!symbols || symbols->scopeCount == 0)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (scope && (uintptr_t)scope != symbols->scopeCount)
+        return PARSER_ERROR_INVALID_ARG;
+
+    const ASTScopeFrame* frame = &symbols->scopes[symbols->scopeCount - 1];
+
+    ASTSymbolTableUnbind(symbols, symbols->undo, frame->undoBase, symbols->undoCount);
+    symbols->undoCount = frame->undoBase;
+
+    if (frame->kind == AST_SCOPE_KIND_FUNCTION) {
+        ASTSymbolTableUnbind(symbols, symbols->labels, frame->labelBase, symbols->labelCount);
+        symbols->labelCount = frame->labelBase;
+    }
+
+    symbols->scopeCount--;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ASTSymbolTable_GetDepth(
+    const ASTSymbolTable symbols)
+{
+    return (symbols && symbols->scopeCount) ? symbols->scopeCount - 1 : 0;
+}
+
+PARSER_ATTR ASTScopeKind PARSER_CALL ASTSymbolTable_GetScopeKind(
+    const ASTSymbolTable symbols)
+{
+    if (!symbols || symbols->scopeCount == 0)
+        return AST_SCOPE_KIND_FILE;
+
+    return (ASTScopeKind)symbols->scopes[symbols->scopeCount - 1].kind;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTSymbolTable_Declare(
+    ASTSymbolTable symbols,
+    ASTSymbolNamespace space,
+    ParserIdentifierId name,
+    ASTSymbolKind kind,
+    ASTSymbolId owner,
+    uint32_t node,
+    ASTSymbolId* id)
+{
+    if (!symbols || !id || name == PARSER_IDENTIFIER_NONE || symbols->scopeCount == 0)
+        return PARSER_ERROR_INVALID_ARG;
+
+    // ===== TARGET SCOPE =====
+    uint32_t depth = symbols->scopeCount - 1;
+
+    if (space == AST_NAMESPACE_LABEL) {
+        while (symbols->scopes[depth].kind != AST_SCOPE_KIND_FUNCTION) {
+            if (depth == 0)
+                return PARSER_ERROR_INVALID_ARG;
+            depth--;
+        }
+    }
+
+    // Keep the load factor under one half, unbound keys are dropped here
+    if ((symbols->slotUsed + 1) * 2 > symbols->slotMask + 1) {
+        uint32_t slotCount = symbols->slotMask + 1;
+        uint32_t bound = 0;
+        for (uint32_t i = 0; i < slotCount; i++)
+            bound += symbols->slots[i].symbol != AST_SYMBOL_ID_NONE;
+
+        // Same size when mostly dead keys were filling it up
+        if ((bound + 1) * 4 > slotCount)
+            slotCount *= 2;
+        CHECK_PARSER_RESULT(ASTSymbolTableRehash(symbols, slotCount));
+    }
+
+    ASTSymbolSlot* slot = ASTSymbolTableProbe(symbols, name, space, owner);
+    ASTSymbolId existing = slot->name ? slot->symbol : AST_SYMBOL_ID_NONE;
+
+    // Names the overlay has not bound are bound as in the parent
+    if (!existing && symbols->parent)
+        existing = ASTSymbolTable_Lookup((ASTSymbolTable)symbols->parent, space, name, owner);
+
+    // Members never go out of scope, everything else only clashes within
+    // the same scope
+    if (existing && (owner || ASTSymbolTableAt(symbols, existing)->scope == depth)) {
+        *id = existing;
+        return PARSER_ERROR_REDECLARATION;
+    }
+
+    // ===== RECORD =====
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&symbols->symbols, &symbols->symbolCapacity, symbols->symbolCount,
+        symbols->symbolCount + 1, sizeof(ASTSymbolInfo), 256));
+
+    if (!owner) {
+        if (space == AST_NAMESPACE_LABEL) {
+            CHECK_PARSER_RESULT(ParserArrayReserve((void**)&symbols->labels, &symbols->labelCapacity,
+                symbols->labelCount, symbols->labelCount + 1, sizeof(uint32_t), 256));
+        }
+        else {
+            CHECK_PARSER_RESULT(ParserArrayReserve((void**)&symbols->undo, &symbols->undoCapacity, symbols->undoCount,
+                symbols->undoCount + 1, sizeof(uint32_t), 256));
+        }
+    }
+
+    ASTSymbolId symbolId = symbols->base + symbols->symbolCount;
+    ASTSymbolInfo* symbol = &symbols->symbols[symbols->symbolCount++];
+    symbol->name = name;
+    symbol->node = node;
+    symbol->type = 0;
+    symbol->owner = owner;
+    symbol->shadowed = existing;
+    symbol->scope = depth;
+    symbol->space = (uint16_t)space;
+    symbol->kind = (uint16_t)kind;
+
+    if (!slot->name) {
+        slot->name = name;
+        slot->space = space;
+        slot->owner = owner;
+        symbols->slotUsed++;
+    }
+    slot->symbol = symbolId;
+
+    if (!owner) {
+        if (space == AST_NAMESPACE_LABEL)
+            symbols->labels[symbols->labelCount++] = symbolId;
+        else
+            symbols->undo[symbols->undoCount++] = symbolId;
+    }
+
+    if (space == AST_NAMESPACE_ORDINARY)
+        ASTSymbolTableSetTypedef(symbols, name, symbolId);
+
+    *id = symbolId;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ASTSymbolId PARSER_CALL ASTSymbolTable_Lookup(
+    const ASTSymbolTable symbols,
+    ASTSymbolNamespace space,
+    ParserIdentifierId name,
+    ASTSymbolId owner)
+{
+    if (!symbols || name == PARSER_IDENTIFIER_NONE)
+        return AST_SYMBOL_ID_NONE;
+
+    const ASTSymbolSlot* slot = ASTSymbolTableProbe(symbols, name, space, owner);
+    if (slot->name && slot->symbol != AST_SYMBOL_ID_NONE)
+        return slot->symbol;
+
+    return symbols->parent ? ASTSymbolTable_Lookup((ASTSymbolTable)symbols->parent, space, name, owner) : AST_SYMBOL_ID_NONE;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTSymbolTable_AddRecord(
+    ASTSymbolTable symbols,
+    const ASTSymbolInfo* info,
+    ASTSymbolId* id)
+{
+    if (!symbols || !info || !id)
+        return PARSER_ERROR_INVALID_ARG;
+
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&symbols->symbols, &symbols->symbolCapacity, symbols->symbolCount,
+        symbols->symbolCount + 1, sizeof(ASTSymbolInfo), 256));
+
+    *id = symbols->base + symbols->symbolCount;
+    symbols->symbols[symbols->symbolCount++] = *info;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR const ASTSymbolInfo* PARSER_CALL ASTSymbolTable_GetSymbol(
+    const ASTSymbolTable symbols,
+    ASTSymbolId id)
+{
+    if (!symbols)
+        return NULL;
+
+    return ASTSymbolTableAt(symbols, id);
+}
+
+PARSER_ATTR void PARSER_CALL ASTSymbolTable_SetType(
+    ASTSymbolTable symbols,
+    ASTSymbolId id,
+    uint32_t type)
+{
+    // The parent of an overlay is read-only
+    if (!symbols || id < symbols->base || id - symbols->base >= symbols->symbolCount || id == AST_SYMBOL_ID_NONE)
+        return;
+
+    symbols->symbols[id - symbols->base].type = type;
+}
+
+PARSER_ATTR void PARSER_CALL ASTSymbolTable_SetNode(
+    ASTSymbolTable symbols,
+    ASTSymbolId id,
+    uint32_t node)
+{
+    if (!symbols || id < symbols->base || id - symbols->base >= symbols->symbolCount || id == AST_SYMBOL_ID_NONE)
+        return;
+
+    symbols->symbols[id - symbols->base].node = node;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ASTSymbolTable_GetSymbolCount(
+    const ASTSymbolTable symbols)
+{
+    return symbols ? symbols->base + symbols->symbolCount - 1 : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
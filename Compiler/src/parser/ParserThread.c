@@ -0,0 +1,190 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserThread.h"
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#if defined(PLATFORM_WINDOWS)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#elif defined(PLATFORM_LINUX)
+	#include <pthread.h>
+	#include <unistd.h>        // sysconf
+#endif
+
+struct ParserThread_T {
+	PFN_ParserThreadEntry entry;
+	void* userData;
+
+#if defined(PLATFORM_WINDOWS)
+	HANDLE threadHandle;
+#elif defined(PLATFORM_LINUX)
+	pthread_t thread;
+#endif
+};
+
+#if defined(PLATFORM_WINDOWS)
+
+static DWORD WINAPI ParserThreadTrampoline(LPVOID param)
+{
+    ParserThread thread = (ParserThread)param;
+    thread->entry(thread->userData);
+    return 0;
+}
+
+#elif defined(PLATFORM_LINUX)
+
+static void* ParserThreadTrampoline(void* param)
+{
+    ParserThread thread = (ParserThread)param;
+    thread->entry(thread->userData);
+    return NULL;
+}
+
+#endif
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL ParserThreadCreate(
+    PFN_ParserThreadEntry entry,
+    void* userData,
+    ParserThread* thread)
+{
+    if (!entry || !thread)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ParserThread hdl = PARSER_MALLOC(sizeof(struct ParserThread_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    hdl->entry = entry;
+    hdl->userData = userData;
+
+#if defined(PLATFORM_WINDOWS)
+    hdl->threadHandle = CreateThread(NULL, 0, ParserThreadTrampoline, hdl, 0, NULL);
+    if (hdl->threadHandle == NULL) {
+        PARSER_FREE(hdl);
+        return PARSER_RESULT_ERROR;
+    }
+#elif defined(PLATFORM_LINUX)
+    if (pthread_create(&hdl->thread, NULL, ParserThreadTrampoline, hdl) != 0) {
+        PARSER_FREE(hdl);
+        return PARSER_RESULT_ERROR;
+    }
+#else
+
+#error "Unsupported platform"
+
+#endif
+
+    *thread = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL ParserThreadJoin(
+    ParserThread thread)
+{
+    if (!thread)
+        return;
+
+#if defined(PLATFORM_WINDOWS)
+    WaitForSingleObject(thread->threadHandle, INFINITE);
+    CloseHandle(thread->threadHandle);
+#elif defined(PLATFORM_LINUX)
+    pthread_join(thread->thread, NULL);
+#endif
+
+    PARSER_FREE(thread);
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ParserThreadHardwareConcurrency(void)
+{
+#if defined(PLATFORM_WINDOWS)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? (uint32_t)info.dwNumberOfProcessors : 1;
+#elif defined(PLATFORM_LINUX)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t)count : 1;
+#else
+    return 1;
+#endif
+}
+
+PARSER_ATTR int64_t PARSER_CALL ParserAtomicAdd64(
+    volatile int64_t* target,
+    int64_t value)
+{
+#if defined(PLATFORM_WINDOWS)
+    return InterlockedExchangeAdd64((volatile LONG64*)target, value) + value;
+#else
+    return __atomic_add_fetch(target, value, __ATOMIC_RELAXED);
+#endif
+}
+
+PARSER_ATTR void PARSER_CALL ParserAtomicMax64(
+    volatile int64_t* target,
+    int64_t value)
+{
+#if defined(PLATFORM_WINDOWS)
+    LONG64 current = *target;
+    while (current < value) {
+        LONG64 seen = InterlockedCompareExchange64((volatile LONG64*)target, value, current);
+        if (seen == current)
+            break;
+        current = seen;
+    }
+#else
+    int64_t current = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (current < value &&
+           !__atomic_compare_exchange_n(target, &current, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+#endif
+}
+
+PARSER_ATTR int64_t PARSER_CALL ParserAtomicLoad64(
+    volatile int64_t* target)
+{
+#if defined(PLATFORM_WINDOWS)
+    return InterlockedCompareExchange64((volatile LONG64*)target, 0, 0);
+#else
+    return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+#endif
+}
+
+PARSER_ATTR void PARSER_CALL ParserAtomicStore64(
+    volatile int64_t* target,
+    int64_t value)
+{
+#if defined(PLATFORM_WINDOWS)
+    InterlockedExchange64((volatile LONG64*)target, value);
+#else
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+#endif
+}
+
+PARSER_ATTR bool PARSER_CALL ParserAtomicCompareExchange64(
+    volatile int64_t* target,
+    int64_t* expected,
+    int64_t value)
+{
+#if defined(PLATFORM_WINDOWS)
+    LONG64 seen = InterlockedCompareExchange64((volatile LONG64*)target, value, *expected);
+    if (seen == *expected)
+        return true;
+
+    *expected = seen;
+    return false;
+#else
+    return __atomic_compare_exchange_n(target, expected, value, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,112 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_THREAD_H
+#define PARSER_THREAD_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserCore.h"
+#include "parser/Results.h"
+
+#include <stdbool.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_CORE_DEFINE_HANDLE(ParserThread)
+
+/**
+ * @brief Entry point of a parser worker thread
+ *
+ * @param userData[in] Pointer passed to ParserThreadCreate
+ */
+typedef void (PARSER_PTR* PFN_ParserThreadEntry)(void* userData);
+
+/**
+ * @brief Start a worker thread
+ *
+ * @param entry[in] Thread entry point
+ * @param userData[in] Pointer passed to the entry point
+ * @param thread[out] Pointer to the thread handle
+ *
+ * @return ParserResult
+ *      PARSER_RESULT_SUCCES : Thread started
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserThreadCreate(
+    PFN_ParserThreadEntry entry,
+    void* userData,
+    ParserThread* thread);
+
+/**
+ * @brief Wait for a worker thread to finish and release the handle
+ *
+ * @param thread[in] Thread handle
+ */
+PARSER_ATTR void PARSER_CALL ParserThreadJoin(
+    ParserThread thread);
+
+/**
+ * @brief Number of processors available to the process
+ *
+ * @return Processor count, at least 1
+ */
+PARSER_ATTR uint32_t PARSER_CALL ParserThreadHardwareConcurrency(void);
+
+/**
+ * @brief Check whether g_parser_allocator_callbacks may be called from several threads
+ *
+ * @description False while the callbacks of an arena are installed, see
+ *              ParserArena_GetCallbacks. Other callbacks are trusted to be
+ *              thread safe, as the default heap callbacks are.
+ */
+PARSER_ATTR bool PARSER_CALL ParserThreadSafeAllocator(void);
+
+/**
+ * @brief Atomically add to a 64-bit counter
+ *
+ * @return The new value
+ */
+PARSER_ATTR int64_t PARSER_CALL ParserAtomicAdd64(
+    volatile int64_t* target,
+    int64_t value);
+
+/**
+ * @brief Atomically raise a 64-bit counter to at least `value`
+ */
+PARSER_ATTR void PARSER_CALL ParserAtomicMax64(
+    volatile int64_t* target,
+    int64_t value);
+
+/**
+ * @brief Atomically load a 64-bit value, acquiring what its last store released
+ */
+PARSER_ATTR int64_t PARSER_CALL ParserAtomicLoad64(
+    volatile int64_t* target);
+
+/**
+ * @brief Atomically store a 64-bit value, releasing earlier writes
+ */
+PARSER_ATTR void PARSER_CALL ParserAtomicStore64(
+    volatile int64_t* target,
+    int64_t value);
+
+/**
+ * @brief Atomically replace `expected` with `value`
+ *
+ * @return True when the value was replaced, otherwise `expected` holds the current value
+ */
+PARSER_ATTR bool PARSER_CALL ParserAtomicCompareExchange64(
+    volatile int64_t* target,
+    int64_t* expected,
+    int64_t value);
+
+// ------------------------------------------------------------------------------------------------
+
+#endif // !PARSER_THREAD_H
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,550 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserType.h"
+#include "ParserArray.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+struct ASTTypeTable_T {
+    ASTTypeInfo* types;             // Indexed by id - base, record 0 of a table is unused
+    uint32_t typeCount;             // Records, including record 0 of a table
+    uint32_t typeCapacity;
+
+    ASTTypeId* params;              // Parameter lists of the function types
+    uint32_t paramCount;
+    uint32_t paramCapacity;
+
+    uint32_t* slots;                // Type ids, 0 marks an empty slot
+    uint32_t slotMask;              // Slot count - 1, a power of two
+    uint32_t slotFirst;             // First record in the slots, see ASTTypeTable_BeginRange
+
+    // ===== Overlay =====
+    const struct ASTTypeTable_T* parent;    // Read-only table below the overlay, NULL otherwise
+    uint32_t base;                  // Id of record 0, the id count of the parent
+};
+
+/* Record of a type, in the table or overlay below `types` that holds it */
+static const ASTTypeInfo* ASTTypeTableAt(const struct ASTTypeTable_T* types, ASTTypeId id)
+{
+    while (id < types->base)
+        types = types->parent;
+
+    uint32_t index = id - types->base;
+    if (index >= types->typeCount || (index == 0 && !types->parent))
+        return NULL;
+
+    return &types->types[index];
+}
+
+/* Parameter types of a function type, from the table that holds it */
+static const ASTTypeId* ASTTypeTableParamsAt(const struct ASTTypeTable_T* types, ASTTypeId id)
+{
+    while (id < types->base)
+        types = types->parent;
+
+    return &types->params[types->types[id - types->base].value];
+}
+
+static uint32_t ASTTypeHashWord(uint32_t hash, uint32_t word)
+{
+    hash = (hash ^ word) * 0x85EBCA6Bu;
+    return hash ^ (hash >> 13);
+}
+
+/* Hash of everything that identifies a type, the parameters standing in for `value` */
+static uint32_t ASTTypeHash(const ASTTypeInfo* key, const ASTTypeId* params)
+{
+    uint32_t hash = 0x9E3779B1u;
+    hash = ASTTypeHashWord(hash, (uint32_t)key->kind | (uint32_t)key->qualifiers << 8 |
+        (uint32_t)key->arraySize << 16 | (uint32_t)key->flags << 24);
+    hash = ASTTypeHashWord(hash, key->base);
+    hash = ASTTypeHashWord(hash, key->count);
+
+    if (key->kind == AST_TYPE_KIND_FUNCTION) {
+        for (uint32_t i = 0; i < key->count; i++)
+            hash = ASTTypeHashWord(hash, params[i]);
+    }
+    else {
+        hash = ASTTypeHashWord(hash, key->value);
+    }
+
+    return hash;
+}
+
+/* `types` is the table holding `type` */
+static bool ASTTypeEquals(const struct ASTTypeTable_T* types, const ASTTypeInfo* type, const ASTTypeInfo* key, const ASTTypeId* params)
+{
+    if (type->hash != key->hash || type->kind != key->kind || type->qualifiers != key->qualifiers ||
+        type->arraySize != key->arraySize || type->flags != key->flags || type->base != key->base ||
+        type->count != key->count)
+        return false;
+
+    if (key->kind == AST_TYPE_KIND_FUNCTION)
+        return key->count == 0 || memcmp(&types->params[type->value], params, sizeof(ASTTypeId) * key->count) == 0;
+
+    return type->value == key->value;
+}
+
+static ParserResult ASTTypeTableRehash(ASTTypeTable types, uint32_t slotCount)
+{
+    uint32_t* slots = PARSER_MALLOC(sizeof(uint32_t) * slotCount, 0);
+    if (!slots)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(slots, 0, sizeof(uint32_t) * slotCount);
+
+    // Rehash from the stored hashes
+    uint32_t mask = slotCount - 1;
+    for (uint32_t index = types->slotFirst; index < types->typeCount; index++) {
+        uint32_t i = types->types[index].hash & mask;
+        while (slots[i])
+            i = (i + 1) & mask;
+        slots[i] = types->base + index;
+    }
+
+    PARSER_FREE(types->slots);
+    types->slots = slots;
+    types->slotMask = mask;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Probe the slots of one table for `key`, 0 and the empty slot when absent */
+static ASTTypeId ASTTypeTableFind(const struct ASTTypeTable_T* types, const ASTTypeInfo* key, const ASTTypeId* params, uint32_t* empty)
+{
+    uint32_t i = key->hash & types->slotMask;
+    for (;;) {
+        uint32_t slot = types->slots[i];
+        if (slot == 0)
+            break;
+
+        if (ASTTypeEquals(types, &types->types[slot - types->base], key, params))
+            return slot;
+
+        i = (i + 1) & types->slotMask;
+    }
+
+    *empty = i;
+
+    return AST_TYPE_ID_NONE;
+}
+
+/**
+ * Find or add the type described by `key`. Function parameters are staged
+ * in the unused tail of the parameter array and only kept when the type is
+ * new. An overlay finds the types of its parents first and adds only the
+ * ones they do not have.
+ */
+static ParserResult ASTTypeTableIntern(ASTTypeTable types, ASTTypeInfo* key, const ASTTypeId* params, ASTTypeId* id)
+{
+    key->hash = ASTTypeHash(key, params);
+
+    uint32_t i;
+    for (const struct ASTTypeTable_T* parent = types->parent; parent; parent = parent->parent) {
+        *id = ASTTypeTableFind(parent, key, params, &i);
+        if (*id != AST_TYPE_ID_NONE)
+            return PARSER_RESULT_SUCCESS;
+    }
+
+    *id = ASTTypeTableFind(types, key, params, &i);
+    if (*id != AST_TYPE_ID_NONE)
+        return PARSER_RESULT_SUCCESS;
+
+    // ===== NEW TYPE =====
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&types->types, &types->typeCapacity, types->typeCount,
+        types->typeCount + 1, sizeof(ASTTypeInfo), 256));
+
+    if (key->kind == AST_TYPE_KIND_FUNCTION) {
+        key->value = types->paramCount;
+        types->paramCount += key->count;
+    }
+
+    uint32_t newId = types->base + types->typeCount;
+    if (key->qualifiers == 0)
+        key->unqualified = newId;
+
+    types->types[types->typeCount++] = *key;
+    types->slots[i] = newId;
+
+    // Keep the load factor under one half
+    if ((types->typeCount - types->slotFirst) * 2 > types->slotMask + 1)
+        CHECK_PARSER_RESULT(ASTTypeTableRehash(types, (types->slotMask + 1) * 2));
+
+    *id = newId;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Key with every field cleared */
+static ASTTypeInfo ASTTypeKey(ASTTypeKind kind, uint32_t base, uint32_t value)
+{
+    ASTTypeInfo key;
+    memset(&key, 0, sizeof(key));
+    key.kind = (uint8_t)kind;
+    key.base = base;
+    key.value = value;
+    return key;
+}
+
+/* Intern `key` unqualified first, so qualified types know their unqualified id */
+static ParserResult ASTTypeTableInternQualified(ASTTypeTable types, ASTTypeInfo* key, uint32_t qualifiers, ASTTypeId* id)
+{
+    CHECK_PARSER_RESULT(ASTTypeTableIntern(types, key, NULL, id));
+
+    if (qualifiers == 0)
+        return PARSER_RESULT_SUCCESS;
+
+    key->qualifiers = (uint8_t)qualifiers;
+    key->unqualified = *id;
+
+    return ASTTypeTableIntern(types, key, NULL, id);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateASTTypeTable(
+    ASTTypeTable* types)
+{
+    if (!types)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTypeTable hdl = PARSER_MALLOC(sizeof(struct ASTTypeTable_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ASTTypeTable_T));
+
+    if (ParserArrayReserve((void**)&hdl->types, &hdl->typeCapacity, 0,
+        1, sizeof(ASTTypeInfo), 256) != PARSER_RESULT_SUCCESS ||
+        ASTTypeTableRehash(hdl, AST_TYPE_TABLE_INITIAL_SLOTS) != PARSER_RESULT_SUCCESS) {
+        ASTTypeTableDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    ASTTypeTable_Reset(hdl);
+
+    *types = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL CreateASTTypeTableOverlay(
+    const ASTTypeTable parent,
+    ASTTypeTable* types)
+{
+    if (!parent || !types)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTypeTable hdl = PARSER_MALLOC(sizeof(struct ASTTypeTable_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ASTTypeTable_T));
+    hdl->parent = parent;
+    hdl->base = parent->base + parent->typeCount;
+
+    if (ASTTypeTableRehash(hdl, AST_TYPE_TABLE_INITIAL_SLOTS) != PARSER_RESULT_SUCCESS) {
+        ASTTypeTableDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    *types = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL ASTTypeTable_Reset(
+    ASTTypeTable types)
+{
+    if (!types)
+        return;
+
+    // Record 0 of a table is the none type, an overlay has no none type
+    if (types->parent) {
+        types->typeCount = 0;
+    }
+    else {
+        memset(&types->types[0], 0, sizeof(ASTTypeInfo));
+        types->typeCount = 1;
+    }
+    types->slotFirst = types->typeCount;
+    types->paramCount = 0;
+
+    memset(types->slots, 0, sizeof(uint32_t) * (types->slotMask + 1));
+}
+
+PARSER_ATTR ASTTypeId PARSER_CALL ASTTypeTable_BeginRange(
+    ASTTypeTable types)
+{
+    if (!types)
+        return AST_TYPE_ID_NONE;
+
+    types->slotFirst = types->typeCount;
+    memset(types->slots, 0, sizeof(uint32_t) * (types->slotMask + 1));
+
+    return types->base + types->typeCount;
+}
+
+PARSER_ATTR void PARSER_CALL ASTTypeTableDestroy(
+    ASTTypeTable types)
+{
+    if (!types)
+        return;
+
+    PARSER_FREE(types->types);
+    PARSER_FREE(types->params);
+    PARSER_FREE(types->slots);
+    PARSER_FREE(types);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetBasic(
+    ASTTypeTable types,
+    uint32_t basic,
+    uint32_t qualifiers,
+    ASTTypeId* id)
+{
+    if (!types || !id)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTypeInfo key = ASTTypeKey(AST_TYPE_KIND_BASIC, AST_TYPE_ID_NONE, basic);
+
+    return ASTTypeTableInternQualified(types, &key, qualifiers, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetPointer(
+    ASTTypeTable types,
+    ASTTypeId pointee,
+    uint32_t qualifiers,
+    ASTTypeId* id)
+{
+    if (!types || !id || !ASTTypeTableAt(types, pointee))
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTypeInfo key = ASTTypeKey(AST_TYPE_KIND_POINTER, pointee, 0);
+
+    return ASTTypeTableInternQualified(types, &key, qualifiers, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetArray(
+    ASTTypeTable types,
+    ASTTypeId element,
+    uint32_t arraySize,
+    uint32_t value,
+    uint32_t flags,
+    ASTTypeId* id)
+{
+    if (!types || !id || !ASTTypeTableAt(types, element))
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTypeInfo key = ASTTypeKey(AST_TYPE_KIND_ARRAY, element, value);
+    key.arraySize = (uint8_t)arraySize;
+    key.flags = (uint8_t)(flags & AST_TYPE_FLAG_SIZED);
+
+    return ASTTypeTableIntern(types, &key, NULL, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetFunction(
+    ASTTypeTable types,
+    ASTTypeId result,
+    const ASTTypeId* params,
+    uint32_t count,
+    uint32_t flags,
+    ASTTypeId* id)
+{
+    if (!types || !id || !ASTTypeTableAt(types, result) || (count && !params))
+        return PARSER_ERROR_INVALID_ARG;
+
+    // Stage the parameters in the unused tail, top-level qualifiers of a
+    // parameter are not part of the function type (C11 6.7.6.3)
+    if (count > UINT32_MAX - types->paramCount)
+        return PARSER_ERROR_NO_MEMORY;
+
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&types->params, &types->paramCapacity, types->paramCount,
+        types->paramCount + count, sizeof(ASTTypeId), 256));
+
+    ASTTypeId* staged = types->params + types->paramCount;
+    for (uint32_t i = 0; i < count; i++) {
+        const ASTTypeInfo* param = ASTTypeTableAt(types, params[i]);
+        if (!param)
+            return PARSER_ERROR_INVALID_ARG;
+        staged[i] = param->unqualified;
+    }
+
+    ASTTypeInfo key = ASTTypeKey(AST_TYPE_KIND_FUNCTION, result, 0);
+    key.count = count;
+    key.flags = (uint8_t)(flags & (AST_TYPE_FLAG_PROTOTYPE | AST_TYPE_FLAG_VARIADIC));
+
+    return ASTTypeTableIntern(types, &key, staged, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetTagged(
+    ASTTypeTable types,
+    ASTTypeKind kind,
+    uint32_t tag,
+    uint32_t qualifiers,
+    ASTTypeId* id)
+{
+    if (!types || !id)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (kind != AST_TYPE_KIND_STRUCT && kind != AST_TYPE_KIND_UNION && kind != AST_TYPE_KIND_ENUM)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTypeInfo key = ASTTypeKey(kind, AST_TYPE_ID_NONE, tag);
+
+    return ASTTypeTableInternQualified(types, &key, qualifiers, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_GetQualified(
+    ASTTypeTable types,
+    ASTTypeId type,
+    uint32_t qualifiers,
+    ASTTypeId* id)
+{
+    const ASTTypeInfo* record = types ? ASTTypeTableAt(types, type) : NULL;
+    if (!record || !id)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTypeInfo key = *record;
+
+    // Already qualified that way, and function types take no qualifiers
+    if ((key.qualifiers | qualifiers) == key.qualifiers || key.kind == AST_TYPE_KIND_FUNCTION) {
+        *id = type;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    if (key.kind == AST_TYPE_KIND_ARRAY) {
+        ASTTypeId element;
+        CHECK_PARSER_RESULT(ASTTypeTable_GetQualified(types, key.base, qualifiers, &element));
+        return ASTTypeTable_GetArray(types, element, key.arraySize, key.value, key.flags, id);
+    }
+
+    key.qualifiers |= (uint8_t)qualifiers;
+
+    return ASTTypeTableIntern(types, &key, NULL, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTTypeTable_Import(
+    ASTTypeTable types,
+    const ASTTypeInfo* type,
+    const ASTTypeId* params,
+    ASTTypeId* id)
+{
+    if (!types || !type || !id || (type->kind == AST_TYPE_KIND_FUNCTION && type->count && !params))
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (type->kind == AST_TYPE_KIND_NONE || (type->qualifiers && !ASTTypeTableAt(types, type->unqualified)))
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTTypeInfo key = *type;
+
+    if (key.kind == AST_TYPE_KIND_FUNCTION) {
+        if (key.count > UINT32_MAX - types->paramCount)
+            return PARSER_ERROR_NO_MEMORY;
+
+        CHECK_PARSER_RESULT(ParserArrayReserve((void**)&types->params, &types->paramCapacity, types->paramCount,
+            types->paramCount + key.count, sizeof(ASTTypeId), 256));
+
+        ASTTypeId* staged = types->params + types->paramCount;
+        if (key.count)
+            memcpy(staged, params, sizeof(ASTTypeId) * key.count);
+
+        return ASTTypeTableIntern(types, &key, staged, id);
+    }
+
+    return ASTTypeTableIntern(types, &key, NULL, id);
+}
+
+PARSER_ATTR const ASTTypeInfo* PARSER_CALL ASTTypeTable_Get(
+    const ASTTypeTable types,
+    ASTTypeId id)
+{
+    if (!types)
+        return NULL;
+
+    return ASTTypeTableAt(types, id);
+}
+
+PARSER_ATTR const ASTTypeId* PARSER_CALL ASTTypeTable_GetParams(
+    const ASTTypeTable types,
+    ASTTypeId id)
+{
+    const ASTTypeInfo* type = ASTTypeTable_Get(types, id);
+    if (!type || type->kind != AST_TYPE_KIND_FUNCTION || type->count == 0)
+        return NULL;
+
+    return ASTTypeTableParamsAt(types, id);
+}
+
+PARSER_ATTR ASTTypeId PARSER_CALL ASTTypeTable_GetUnqualified(
+    const ASTTypeTable types,
+    ASTTypeId id)
+{
+    const ASTTypeInfo* type = ASTTypeTable_Get(types, id);
+    return type ? type->unqualified : AST_TYPE_ID_NONE;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ASTTypeTable_GetTypeCount(
+    const ASTTypeTable types)
+{
+    return types ? types->base + types->typeCount - 1 : 0;
+}
+
+PARSER_ATTR bool PARSER_CALL ASTTypeTable_AreCompatible(
+    const ASTTypeTable types,
+    ASTTypeId a,
+    ASTTypeId b)
+{
+    if (a == b)
+        return a != AST_TYPE_ID_NONE;
+
+    const ASTTypeInfo* ta = ASTTypeTable_Get(types, a);
+    const ASTTypeInfo* tb = ASTTypeTable_Get(types, b);
+    if (!ta || !tb || ta->kind != tb->kind || ta->qualifiers != tb->qualifiers)
+        return false;
+
+    switch (ta->kind) {
+    case AST_TYPE_KIND_POINTER:
+        return ASTTypeTable_AreCompatible(types, ta->base, tb->base);
+
+    case AST_TYPE_KIND_ARRAY:
+        if ((ta->flags & tb->flags & AST_TYPE_FLAG_SIZED) && ta->value != tb->value)
+            return false;
+        return ASTTypeTable_AreCompatible(types, ta->base, tb->base);
+
+    case AST_TYPE_KIND_FUNCTION: {
+        if (!ASTTypeTable_AreCompatible(types, ta->base, tb->base))
+            return false;
+
+        // Without a prototype on one side only the variadic form is ruled out
+        if (!(ta->flags & tb->flags & AST_TYPE_FLAG_PROTOTYPE))
+            return !((ta->flags | tb->flags) & AST_TYPE_FLAG_VARIADIC);
+
+        if (ta->count != tb->count || (ta->flags & AST_TYPE_FLAG_VARIADIC) != (tb->flags & AST_TYPE_FLAG_VARIADIC))
+            return false;
+
+        const ASTTypeId* pa = ASTTypeTableParamsAt(types, a);
+        const ASTTypeId* pb = ASTTypeTableParamsAt(types, b);
+
+        for (uint32_t i = 0; i < ta->count; i++) {
+            if (!ASTTypeTable_AreCompatible(types, pa[i], pb[i]))
+                return false;
+        }
+        return true;
+    }
+
+    default:
+        // Basic and tagged types are only compatible with themselves
+        return false;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,286 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/ParserVisitor.h"
+#include "parser/ParserArena.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Node on the path from the root whose children are being visited
+ */
+typedef struct ASTVisitorFrame_T {
+    ASTNodeId node;
+    ASTNodeId parent;
+    uint32_t next;              // Index of the next child
+    uint32_t childCount;
+    uint32_t leaveMask;         // Passes that get the leave callback
+    uint32_t childMask;         // Passes that visit the children
+} ASTVisitorFrame;
+
+/**
+ * @brief Block of the work stack, blocks are linked and never move
+ */
+typedef struct ASTVisitorSegment_T {
+    struct ASTVisitorSegment_T* prev;
+    struct ASTVisitorSegment_T* next;
+    ASTVisitorFrame frames[AST_VISITOR_SEGMENT_FRAMES];
+} ASTVisitorSegment;
+
+struct ASTVisitor_T {
+    ASTVisitorPass passes[AST_VISITOR_MAX_PASSES];
+    uint32_t passCount;
+    uint32_t running;           // Passes that have not stopped in the current walk
+
+    // ===== Work stack =====
+    ParserArena arena;          // Backs the segments, released with the visitor
+    ASTVisitorSegment* first;
+    ASTVisitorSegment* top;     // Segment of the top frame
+    uint32_t topCount;          // Frames used in `top`
+    uint32_t depth;
+    uint32_t maxDepth;
+};
+
+static ParserResult ASTVisitorPush(ASTVisitor visitor, ASTVisitorFrame** frame)
+{
+    if (visitor->topCount == AST_VISITOR_SEGMENT_FRAMES) {
+        // Blocks of earlier walks are reused before new ones are taken
+        ASTVisitorSegment* next = visitor->top->next;
+        if (!next) {
+            next = ParserArena_Alloc(visitor->arena, sizeof(ASTVisitorSegment), 0);
+            if (!next)
+                return PARSER_ERROR_NO_MEMORY;
+
+            next->prev = visitor->top;
+            next->next = NULL;
+            visitor->top->next = next;
+        }
+
+        visitor->top = next;
+        visitor->topCount = 0;
+    }
+
+    *frame = &visitor->top->frames[visitor->topCount++];
+
+    if (++visitor->depth > visitor->maxDepth)
+        visitor->maxDepth = visitor->depth;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static void ASTVisitorPop(ASTVisitor visitor)
+{
+    visitor->depth--;
+
+    if (--visitor->topCount == 0 && visitor->top->prev) {
+        visitor->top = visitor->top->prev;
+        visitor->topCount = AST_VISITOR_SEGMENT_FRAMES;
+    }
+}
+
+static inline ASTVisitorFrame* ASTVisitorTop(ASTVisitor visitor)
+{
+    return &visitor->top->frames[visitor->topCount - 1];
+}
+
+/* Run the enter callbacks of `mask`, return the passes that visit the children */
+static uint32_t ASTVisitorEnter(ASTVisitor visitor, const ASTTreeView* tree, ASTNodeId node, ASTNodeId parent, uint32_t mask)
+{
+    uint8_t type = tree->types[node - tree->firstNode];
+    uint32_t childMask = mask;
+
+    for (uint32_t i = 0; i < visitor->passCount; i++) {
+        uint32_t bit = 1u << i;
+        if (!(mask & bit))
+            continue;
+
+        const ASTVisitorPass* pass = &visitor->passes[i];
+        PFN_ASTVisitNode enter = pass->enter[type] ? pass->enter[type] : pass->enterAny;
+        if (!enter)
+            continue;
+
+        switch (enter(pass->userData, tree, node, parent)) {
+        case AST_VISIT_CONTINUE:
+            break;
+        case AST_VISIT_SKIP_CHILDREN:
+            childMask &= ~bit;
+            break;
+        default:
+            childMask &= ~bit;
+            visitor->running &= ~bit;
+            break;
+        }
+    }
+
+    return childMask;
+}
+
+static void ASTVisitorLeave(ASTVisitor visitor, const ASTTreeView* tree, ASTNodeId node, ASTNodeId parent, uint32_t mask)
+{
+    uint8_t type = tree->types[node - tree->firstNode];
+
+    for (uint32_t i = 0; i < visitor->passCount; i++) {
+        uint32_t bit = 1u << i;
+        if (!(mask & visitor->running & bit))
+            continue;
+
+        const ASTVisitorPass* pass = &visitor->passes[i];
+        PFN_ASTVisitNode leave = pass->leave[type] ? pass->leave[type] : pass->leaveAny;
+        if (leave && leave(pass->userData, tree, node, parent) == AST_VISIT_STOP)
+            visitor->running &= ~bit;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL CreateASTVisitor(
+    ASTVisitor* visitor)
+{
+    if (!visitor)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTVisitor hdl = PARSER_MALLOC(sizeof(struct ASTVisitor_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct ASTVisitor_T));
+
+    if (ParserArena_Create(NULL, &hdl->arena) != PARSER_RESULT_SUCCESS) {
+        ASTVisitorDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    hdl->first = ParserArena_Alloc(hdl->arena, sizeof(ASTVisitorSegment), 0);
+    if (!hdl->first) {
+        ASTVisitorDestroy(hdl);
+        return PARSER_ERROR_NO_MEMORY;
+    }
+
+    hdl->first->prev = NULL;
+    hdl->first->next = NULL;
+    hdl->top = hdl->first;
+
+    *visitor = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL ASTVisitorDestroy(
+    ASTVisitor visitor)
+{
+    if (!visitor)
+        return;
+
+    if (visitor->arena)
+        ParserArena_Destroy(visitor->arena);
+
+    PARSER_FREE(visitor);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTVisitor_AddPass(
+    ASTVisitor visitor,
+    const ASTVisitorPass* pass)
+{
+    if (!visitor || !pass || visitor->passCount == AST_VISITOR_MAX_PASSES)
+        return PARSER_ERROR_INVALID_ARG;
+
+    visitor->passes[visitor->passCount++] = *pass;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR void PARSER_CALL ASTVisitor_ClearPasses(
+    ASTVisitor visitor)
+{
+    if (visitor)
+        visitor->passCount = 0;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ASTVisitor_Walk(
+    ASTVisitor visitor,
+    const ASTTreeView* tree,
+    ASTNodeId root)
+{
+    if (!visitor || !tree)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (root == AST_NODE_ID_NONE || root - tree->firstNode >= tree->nodeCount || visitor->passCount == 0)
+        return PARSER_RESULT_SUCCESS;
+
+    visitor->running = visitor->passCount == 32 ? ~0u : (1u << visitor->passCount) - 1;
+    visitor->top = visitor->first;
+    visitor->topCount = 0;
+    visitor->depth = 0;
+
+    ParserResult result = PARSER_RESULT_SUCCESS;
+
+    uint32_t mask = visitor->running;
+    uint32_t childMask = ASTVisitorEnter(visitor, tree, root, AST_NODE_ID_NONE, mask);
+
+    ASTVisitorFrame* frame;
+    CHECK_PARSER_RESULT(ASTVisitorPush(visitor, &frame));
+    frame->node = root;
+    frame->parent = AST_NODE_ID_NONE;
+    frame->next = 0;
+    frame->childCount = ASTTreeView_GetChildCount(tree, root);
+    frame->leaveMask = mask;
+    frame->childMask = childMask;
+
+    while (visitor->depth && visitor->running) {
+        ASTVisitorFrame* top = ASTVisitorTop(visitor);
+        uint32_t active = top->childMask & visitor->running;
+
+        if (!active || top->next == top->childCount) {
+            ASTVisitorLeave(visitor, tree, top->node, top->parent, top->leaveMask);
+            ASTVisitorPop(visitor);
+            continue;
+        }
+
+        ASTNodeId child = ASTTreeView_GetChild(tree, top->node, top->next++);
+        if (child == AST_NODE_ID_NONE)
+            continue;
+
+        ASTNodeId parent = top->node;
+        childMask = ASTVisitorEnter(visitor, tree, child, parent, active);
+
+        // Leaves never reach the stack, most nodes of a tree are leaves
+        uint32_t childCount = ASTTreeView_GetChildCount(tree, child);
+        if (childCount == 0 || !(childMask & visitor->running)) {
+            ASTVisitorLeave(visitor, tree, child, parent, active);
+            continue;
+        }
+
+        result = ASTVisitorPush(visitor, &frame);
+        if (result != PARSER_RESULT_SUCCESS)
+            break;
+
+        frame->node = child;
+        frame->parent = parent;
+        frame->next = 0;
+        frame->childCount = childCount;
+        frame->leaveMask = active;
+        frame->childMask = childMask;
+    }
+
+    // A stopped walk leaves no frames for the next one
+    visitor->top = visitor->first;
+    visitor->topCount = 0;
+    visitor->depth = 0;
+
+    return result;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ASTVisitor_GetMaxDepth(
+    const ASTVisitor visitor)
+{
+    return visitor ? visitor->maxDepth : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
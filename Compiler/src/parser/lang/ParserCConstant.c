@@ -0,0 +1,540 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCInternal.h"
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/* Is a signed result representable in its type */
+static inline bool ParserCFitsSigned(int64_t value, uint32_t type)
+{
+    uint32_t width = ParserCTypeWidth(type);
+    if (width == 64)
+        return true;
+
+    int64_t limit = (int64_t)1 << (width - 1);
+    return value >= -limit && value < limit;
+}
+
+/* Signed operations of promoted types, false when the result overflows */
+static bool ParserCSignedArithmetic(uint32_t op, int64_t a, int64_t b, uint32_t type, int64_t* result)
+{
+    switch (op) {
+    case C_BINARY_OP_ADD:
+        if ((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b))
+            return false;
+        *result = a + b;
+        break;
+    case C_BINARY_OP_SUBTRACT:
+        if ((b < 0 && a > INT64_MAX + b) || (b > 0 && a < INT64_MIN + b))
+            return false;
+        *result = a - b;
+        break;
+    case C_BINARY_OP_MULTIPLY:
+        if (a != 0 && b != 0) {
+            if (a == -1 || b == -1) {
+                if (a == INT64_MIN || b == INT64_MIN)
+                    return false;
+            }
+            else if ((a > 0) == (b > 0) ? (a > 0 ? a > INT64_MAX / b : a < INT64_MAX / b)
+                                        : (a > 0 ? b < INT64_MIN / a : a < INT64_MIN / b)) {
+                return false;
+            }
+        }
+        *result = a * b;
+        break;
+    case C_BINARY_OP_DIVIDE:
+    case C_BINARY_OP_MODULO:
+        // a % b is undefined along with a / b when the quotient does not fit (C11 6.5.5)
+        if (b == 0 || (a == INT64_MIN && b == -1) || !ParserCFitsSigned(a / b, type))
+            return false;
+        *result = op == C_BINARY_OP_DIVIDE ? a / b : a % b;
+        break;
+    default:
+        return false;
+    }
+
+    return ParserCFitsSigned(*result, type);
+}
+
+static bool ParserCFoldBinary(uint32_t op, const ParserCConstant* left, const ParserCConstant* right, ParserCConstant* result)
+{
+    uint32_t leftType = ParserCPromote(left->type);
+    uint32_t rightType = ParserCPromote(right->type);
+
+    switch (op) {
+    case C_BINARY_OP_LOGICAL_AND:
+    case C_BINARY_OP_LOGICAL_OR:
+        result->type = C_BASIC_TYPE_INT;
+        result->value = op == C_BINARY_OP_LOGICAL_AND ? (left->value != 0 && right->value != 0)
+                                                      : (left->value != 0 || right->value != 0);
+        return true;
+
+    case C_BINARY_OP_SHIFT_LEFT:
+    case C_BINARY_OP_SHIFT_RIGHT: {
+        // The result has the promoted left type, the count must be in range
+        uint32_t width = ParserCTypeWidth(leftType);
+        if ((ParserCIsSignedType(rightType) && (int64_t)right->value < 0) || right->value >= width)
+            return false;
+
+        uint32_t count = (uint32_t)right->value;
+        result->type = leftType;
+
+        if (!ParserCIsSignedType(leftType)) {
+            result->value = ParserCConvert(op == C_BINARY_OP_SHIFT_LEFT ? left->value << count : left->value >> count, leftType);
+            return true;
+        }
+
+        int64_t value = (int64_t)left->value;
+        if (op == C_BINARY_OP_SHIFT_RIGHT) {
+            // Arithmetic shift of negative values, as the target does
+            result->value = (uint64_t)(value < 0 ? ~(~value >> count) : value >> count);
+            return true;
+        }
+
+        // Negative values and results that do not fit are undefined
+        if (value < 0 || (count && (uint64_t)value >> (width - 1 - count)))
+            return false;
+
+        result->value = (uint64_t)value << count;
+        return true;
+    }
+
+    default:
+        break;
+    }
+
+    uint32_t type = ParserCCommonType(leftType, rightType);
+    uint64_t a = ParserCConvert(left->value, type);
+    uint64_t b = ParserCConvert(right->value, type);
+    bool isSigned = ParserCIsSignedType(type);
+
+    switch (op) {
+    case C_BINARY_OP_EQUAL:
+    case C_BINARY_OP_NOT_EQUAL:
+    case C_BINARY_OP_LESS:
+    case C_BINARY_OP_GREATER:
+    case C_BINARY_OP_LESS_EQUAL:
+    case C_BINARY_OP_GREATER_EQUAL: {
+        int order = isSigned ? ((int64_t)a < (int64_t)b ? -1 : (int64_t)a > (int64_t)b)
+                             : (a < b ? -1 : a > b);
+        bool holds = op == C_BINARY_OP_EQUAL ? order == 0 :
+                     op == C_BINARY_OP_NOT_EQUAL ? order != 0 :
+                     op == C_BINARY_OP_LESS ? order < 0 :
+                     op == C_BINARY_OP_GREATER ? order > 0 :
+                     op == C_BINARY_OP_LESS_EQUAL ? order <= 0 : order >= 0;
+
+        result->type = C_BASIC_TYPE_INT;
+        result->value = holds;
+        return true;
+    }
+
+    case C_BINARY_OP_BITWISE_AND:
+        result->value = a & b;
+        break;
+    case C_BINARY_OP_BITWISE_OR:
+        result->value = a | b;
+        break;
+    case C_BINARY_OP_BITWISE_XOR:
+        result->value = a ^ b;
+        break;
+
+    case C_BINARY_OP_ADD:
+    case C_BINARY_OP_SUBTRACT:
+    case C_BINARY_OP_MULTIPLY:
+    case C_BINARY_OP_DIVIDE:
+    case C_BINARY_OP_MODULO:
+        if (isSigned) {
+            int64_t value;
+            if (!ParserCSignedArithmetic(op, (int64_t)a, (int64_t)b, type, &value))
+                return false;
+            result->value = (uint64_t)value;
+            break;
+        }
+
+        // Unsigned arithmetic is modulo 2^width
+        if ((op == C_BINARY_OP_DIVIDE || op == C_BINARY_OP_MODULO) && b == 0)
+            return false;
+
+        result->value = op == C_BINARY_OP_ADD ? a + b :
+                        op == C_BINARY_OP_SUBTRACT ? a - b :
+                        op == C_BINARY_OP_MULTIPLY ? a * b :
+                        op == C_BINARY_OP_DIVIDE ? a / b : a % b;
+        break;
+
+    default:
+        return false;
+    }
+
+    result->type = type;
+    result->value = ParserCConvert(result->value, type);
+
+    return true;
+}
+
+static bool ParserCFoldUnary(uint32_t op, const ParserCConstant* operand, ParserCConstant* result)
+{
+    uint32_t type = ParserCPromote(operand->type);
+    uint64_t value = ParserCConvert(operand->value, type);
+
+    switch (op) {
+    case C_UNARY_OP_PLUS:
+        break;
+    case C_UNARY_OP_MINUS:
+        // Negating the most negative value overflows
+        if (ParserCIsSignedType(type) && (value << (64 - ParserCTypeWidth(type))) == (uint64_t)1 << 63)
+            return false;
+        value = 0 - value;
+        break;
+    case C_UNARY_OP_BITWISE_NOT:
+        value = ~value;
+        break;
+    case C_UNARY_OP_LOGICAL_NOT:
+        type = C_BASIC_TYPE_INT;
+        value = value == 0;
+        break;
+    default:
+        return false;
+    }
+
+    result->type = type;
+    result->value = ParserCConvert(value, type);
+
+    return true;
+}
+
+/* Size of a complete object type, false when it has none at parse time */
+static bool ParserCTypeSize(ASTParser parser, ASTTypeId id, uint64_t* size)
+{
+    uint64_t count = 1;
+
+    for (;;) {
+        const ASTTypeInfo* type = ASTTypeTable_Get(parser->types, id);
+        if (!type)
+            return false;
+
+        switch (type->kind) {
+        case AST_TYPE_KIND_BASIC:
+            if (type->value >= sizeof(g_ParserCBasicSizes) || !g_ParserCBasicSizes[type->value])
+                return false;
+            *size = count * g_ParserCBasicSizes[type->value];
+            return *size / g_ParserCBasicSizes[type->value] == count;
+        case AST_TYPE_KIND_POINTER:
+            *size = count * C_POINTER_SIZE;
+            return *size / C_POINTER_SIZE == count;
+        case AST_TYPE_KIND_ENUM:
+            *size = count * g_ParserCBasicSizes[C_BASIC_TYPE_INT];
+            return *size / g_ParserCBasicSizes[C_BASIC_TYPE_INT] == count;
+        case AST_TYPE_KIND_ARRAY:
+            // Variable and unspecified lengths have no size here
+            if (!(type->flags & AST_TYPE_FLAG_SIZED) || (type->value && count > UINT64_MAX / type->value))
+                return false;
+            count *= type->value;
+            id = type->base;
+            break;
+        default:
+            // Struct and union layout is not known while parsing
+            return false;
+        }
+    }
+}
+
+/* Integer type a cast converts to */
+static bool ParserCCastType(ASTParser parser, ASTTypeId id, uint32_t* basic)
+{
+    const ASTTypeInfo* type = ASTTypeTable_Get(parser->types, id);
+    if (!type)
+        return false;
+
+    if (type->kind == AST_TYPE_KIND_ENUM) {
+        *basic = C_BASIC_TYPE_INT;
+        return true;
+    }
+
+    *basic = type->value;
+    return type->kind == AST_TYPE_KIND_BASIC && ParserCIsIntegerType(type->value);
+}
+
+/* Floating constant converted to an integer type, false when out of range (C11 6.3.1.4) */
+static bool ParserCConvertFloating(double value, uint32_t type, uint64_t* result)
+{
+    if (type == C_BASIC_TYPE_BOOL) {
+        *result = value != 0.0;
+        return true;
+    }
+
+    if (value != value)
+        return false;
+
+    uint32_t width = ParserCTypeWidth(type);
+    if (ParserCIsSignedType(type)) {
+        double limit = (double)((uint64_t)1 << (width - 1));
+        if (!(value > -limit - 1.0 && value < limit))
+            return false;
+        *result = ParserCConvert((uint64_t)(int64_t)value, type);
+        return true;
+    }
+
+    double limit = width == 64 ? 18446744073709551616.0 : (double)((uint64_t)1 << width);
+    if (!(value > -1.0 && value < limit))
+        return false;
+
+    *result = (uint64_t)value;
+    return true;
+}
+
+/* Evaluate the operator of a node being built, its operands are already folded */
+static bool ParserCFold(ASTParser parser, ParserASTNodeType type, uint16_t subtype, uint32_t lhs, uint32_t rhs, ParserCConstant* result)
+{
+    ParserCConstant left;
+    ParserCConstant right;
+
+    switch (type) {
+    case AST_NODE_TYPE_BINARY_EXPR:
+        return ParserCGetConstant(parser, lhs, &left) && ParserCGetConstant(parser, rhs, &right) &&
+            ParserCFoldBinary(subtype, &left, &right, result);
+
+    case AST_NODE_TYPE_UNARY_EXPR:
+        return ParserCGetConstant(parser, lhs, &left) && ParserCFoldUnary(subtype, &left, result);
+
+    case AST_NODE_TYPE_SIZEOF_EXPR: {
+        // rhs tells the operand is a type name, otherwise the type of a
+        // constant or of a declared object
+        ASTTypeId operandType = AST_TYPE_ID_NONE;
+        uint64_t size;
+
+        if (rhs)
+            operandType = ASTTree_GetData(parser->tree, lhs).lhs;
+        else if (ParserCGetConstant(parser, lhs, &left)) {
+            result->type = C_SIZE_TYPE;
+            result->value = g_ParserCBasicSizes[left.type];
+            return true;
+        }
+        else if (ASTTree_GetNodeType(parser->tree, lhs) == AST_NODE_TYPE_IDENTIFIER) {
+            const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(parser->symbols, ASTTree_GetData(parser->tree, lhs).rhs);
+            if (symbol && (symbol->kind == AST_SYMBOL_KIND_VARIABLE || symbol->kind == AST_SYMBOL_KIND_PARAMETER))
+                operandType = symbol->type;
+        }
+
+        if (!ParserCTypeSize(parser, operandType, &size) || size == 0)
+            return false;
+
+        result->type = C_SIZE_TYPE;
+        result->value = size;
+        return true;
+    }
+
+    case AST_NODE_TYPE_CAST_EXPR: {
+        uint32_t target;
+        if (!ParserCCastType(parser, ASTTree_GetData(parser->tree, lhs).lhs, &target))
+            return false;
+
+        result->type = target;
+
+        // Floating constants may only appear as the operand of a cast
+        if (ASTTree_GetNodeType(parser->tree, rhs) == AST_NODE_TYPE_FLOAT_LITERAL)
+            return ParserCConvertFloating(ASTParserGetLiteral(parser, ASTTree_GetData(parser->tree, rhs).lhs)->value.floating,
+                target, &result->value);
+
+        if (!ParserCGetConstant(parser, rhs, &right))
+            return false;
+
+        result->value = ParserCConvert(right.value, target);
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR bool PARSER_CALL ParserCGetConstant(
+    ASTParser parser,
+    ASTNodeId id,
+    ParserCConstant* constant)
+{
+    // Enumeration constants name the node of their enumerator, whose value
+    // can be another enumeration constant. Earlier ones only, so this ends.
+    for (;;) {
+        ASTNodeData data = ASTTree_GetData(parser->tree, id);
+
+        switch (ASTTree_GetNodeType(parser->tree, id)) {
+        case AST_NODE_TYPE_INTEGER_LITERAL: {
+            uint16_t subtype = ASTTree_GetSubtype(parser->tree, id);
+            if (subtype) {
+                constant->type = subtype;
+                constant->value = C_FOLDED_LITERAL_VALUE(data);
+                return true;
+            }
+
+            const LexerLiteral* literal = ASTParserGetLiteral(parser, data.lhs);
+            constant->type = ParserCLiteralType(literal);
+            constant->value = ParserCConvert(literal->value.integer, constant->type);
+            return true;
+        }
+
+        case AST_NODE_TYPE_CHAR_LITERAL: {
+            // The token is read back from the ring, it is gone once the
+            // ring has wrapped past it
+            uint32_t token = ASTTree_GetMainToken(parser->tree, id);
+            if (parser->lexer->filled - token > parser->lexer->ringMask + 1u)
+                return false;
+
+            constant->type = C_BASIC_TYPE_INT;
+            return ParserCCharValue(LexerRingAt(parser->lexer, token), &constant->value);
+        }
+
+        case AST_NODE_TYPE_IDENTIFIER: {
+            const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(parser->symbols, data.rhs);
+            if (!symbol || symbol->kind != AST_SYMBOL_KIND_ENUM_CONSTANT || symbol->node == AST_NODE_ID_NONE)
+                return false;
+
+            id = ASTTree_GetData(parser->tree, symbol->node).lhs;
+            if (id == AST_NODE_ID_NONE)
+                return false;
+            break;
+        }
+
+        default:
+            return false;
+        }
+    }
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCAddConstantNode(
+    ASTParser parser,
+    const ParserCConstant* constant,
+    uint32_t mainToken,
+    ASTNodeId* id)
+{
+    return ASTParserAddNode(parser, AST_NODE_TYPE_INTEGER_LITERAL, (uint16_t)constant->type, mainToken,
+        (uint32_t)constant->value, (uint32_t)(constant->value >> 32), id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCAddFoldedNode(
+    ASTParser parser,
+    ParserASTNodeType type,
+    uint16_t subtype,
+    uint32_t mainToken,
+    uint32_t lhs,
+    uint32_t rhs,
+    ASTNodeId* id)
+{
+    ParserCConstant constant;
+    if (!ParserCFold(parser, type, subtype, lhs, rhs, &constant))
+        return ASTParserAddNode(parser, type, subtype, mainToken, lhs, rhs, id);
+
+    // Operands that are the newest nodes are dropped, the literal takes
+    // the slot of the first one
+    ASTNodeId first = lhs;
+    uint32_t operands = 1;
+    if (type == AST_NODE_TYPE_BINARY_EXPR || type == AST_NODE_TYPE_CAST_EXPR) {
+        first = lhs < rhs ? lhs : rhs;
+        operands = 2;
+    }
+
+    if (ASTTree_GetNodeCount(parser->tree) - first == operands)
+        ASTTree_Truncate(parser->tree, first);
+
+    parser->stats.foldedExpressions++;
+
+    return ParserCAddConstantNode(parser, &constant, mainToken, id);
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ParserCLiteralType(
+    const LexerLiteral* literal)
+{
+    static const uint8_t s_Candidates[] = {
+        C_BASIC_TYPE_INT, C_BASIC_TYPE_UNSIGNED_INT, C_BASIC_TYPE_LONG,
+        C_BASIC_TYPE_UNSIGNED_LONG, C_BASIC_TYPE_LONG_LONG, C_BASIC_TYPE_UNSIGNED_LONG_LONG,
+    };
+
+    bool isUnsigned = (literal->suffix & LITERAL_SUFFIX_UNSIGNED) != 0;
+    bool decimal = literal->base == 10;
+    uint32_t first = (literal->suffix & LITERAL_SUFFIX_LONG_LONG) ? 4u :
+                     (literal->suffix & LITERAL_SUFFIX_LONG) ? 2u : 0u;
+
+    // Decimal constants without a u suffix only take signed types
+    for (uint32_t i = first; i < sizeof(s_Candidates); i++) {
+        uint32_t type = s_Candidates[i];
+        bool typeUnsigned = !ParserCIsSignedType(type);
+
+        if (isUnsigned != typeUnsigned && (isUnsigned || decimal))
+            continue;
+
+        uint32_t width = ParserCTypeWidth(type) - (typeUnsigned ? 0u : 1u);
+        if (width == 64 || literal->value.integer >> width == 0)
+            return type;
+    }
+
+    // Too large for any signed type, as an extension
+    return C_BASIC_TYPE_UNSIGNED_LONG_LONG;
+}
+
+PARSER_ATTR bool PARSER_CALL ParserCCharValue(
+    const struct LexerToken_T* token,
+    uint64_t* value)
+{
+    const char* p = token->lexeme;
+    const char* end = token->lexeme + token->length;
+    if (token->length < 3 || p[0] != '\'' || end[-1] != '\'')
+        return false;
+
+    p++;
+    end--;
+
+    uint32_t c = (uint8_t)*p++;
+    if (c == '\\') {
+        if (p == end)
+            return false;
+
+        c = (uint8_t)*p++;
+        switch (c) {
+        case 'a': c = '\a'; break;
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'v': c = '\v'; break;
+        case '\\': case '\'': case '"': case '?':
+            break;
+        case 'x':
+            for (c = 0; p < end; p++) {
+                uint32_t digit = (*p >= '0' && *p <= '9') ? (uint32_t)(*p - '0') :
+                                 (*p >= 'a' && *p <= 'f') ? (uint32_t)(*p - 'a' + 10) :
+                                 (*p >= 'A' && *p <= 'F') ? (uint32_t)(*p - 'A' + 10) : 16u;
+                if (digit == 16 || c > 0xFu)
+                    return false;
+                c = (c << 4) | digit;
+            }
+            break;
+        default:
+            if (c < '0' || c > '7')
+                return false;
+            c -= '0';
+            for (int i = 0; i < 2 && p < end && *p >= '0' && *p <= '7'; i++)
+                c = (c << 3) | (uint32_t)(*p++ - '0');
+            if (c > 0xFFu)
+                return false;
+            break;
+        }
+    }
+
+    if (p != end)
+        return false;
+
+    // A char converted to int
+    *value = ParserCConvert(c, C_BASIC_TYPE_CHAR);
+
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
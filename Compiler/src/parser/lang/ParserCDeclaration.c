@@ -0,0 +1,414 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCInternal.h"
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/* `_Static_assert ( constant-expression , string-literal ) ;`, a condition that folds to zero fails */
+static ParserResult ParserCParseStaticAssert(ASTParser parser)
+{
+    ASTNodeId condition;
+    ASTNodeId message;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_LPAREN, PARSER_ERROR_UNEXPECTED_TOKEN));
+
+    uint32_t conditionToken = ASTParserTokenIndex(parser);
+    CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_CONDITIONAL, &condition));
+
+    // Conditions that do not fold yet are left to later passes
+    ParserCConstant value;
+    if (ParserCGetConstant(parser, condition, &value) && value.value == 0)
+        return ASTParserErrorAt(parser, PARSER_ERROR_STATIC_ASSERTION, conditionToken);
+
+    if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA)) {
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        uint32_t token = ASTParserTokenIndex(parser);
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_ASSIGNMENT, &message));
+
+        if (ASTTree_GetNodeType(parser->tree, message) != AST_NODE_TYPE_STRING_LITERAL)
+            return ASTParserErrorAt(parser, PARSER_ERROR_UNEXPECTED_TOKEN, token);
+    }
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+    return ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON);
+}
+
+/* Designators `.member` and `[index]` chain as member and subscript nodes on no object */
+static ParserResult ParserCParseDesignation(ASTParser parser, ASTNodeId* designator)
+{
+    *designator = AST_NODE_ID_NONE;
+
+    for (;;) {
+        const struct LexerToken_T* token = ASTParserPeek(parser);
+        uint32_t index = ASTParserTokenIndex(parser);
+
+        if (ASTParserIsPunctuation(token, PUNCTUATION_LBRACKET)) {
+            ASTNodeId element;
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_CONDITIONAL, &element));
+            CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RBRACKET, PARSER_ERROR_UNCLOSED_BRACKET));
+            CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_ARRAY_SUBSCRIPT_EXPR, 0, index, *designator, element, designator));
+        }
+        else if (ASTParserIsPunctuation(token, PUNCTUATION_DOT)) {
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            if (ASTParserPeek(parser)->flags != TOKEN_TYPE_IDENTIFIER)
+                return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+            uint32_t member = ASTParserTokenIndex(parser);
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_MEMBER_EXPR, 0, index, *designator, member, designator));
+        }
+        else {
+            break;
+        }
+    }
+
+    if (*designator == AST_NODE_ID_NONE)
+        return PARSER_RESULT_SUCCESS;
+
+    if (!ParserCIsOperator(ASTParserPeek(parser), OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ASSIGN))
+        return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+    return ASTParserAdvance(parser);
+}
+
+/* Assignment expression, or a braced list of (designated) initializers */
+static ParserResult ParserCParseInitializer(ASTParser parser, ASTNodeId* id)
+{
+    if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_LBRACE))
+        return ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_ASSIGNMENT, id);
+
+    uint32_t open = ASTParserTokenIndex(parser);
+    uint32_t base = parser->scratchCount;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    while (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RBRACE)) {
+        uint32_t first = ASTParserTokenIndex(parser);
+
+        ASTNodeId designator;
+        ASTNodeId value;
+        CHECK_PARSER_RESULT(ParserCParseDesignation(parser, &designator));
+        CHECK_PARSER_RESULT(ParserCParseInitializer(parser, &value));
+
+        if (designator != AST_NODE_ID_NONE)
+            CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_INITIALIZER, 0, first, designator, value, &value));
+
+        CHECK_PARSER_RESULT(ASTParserScratchPush(parser, value));
+
+        // A trailing comma is allowed
+        if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA))
+            break;
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RBRACE, PARSER_ERROR_UNCLOSED_BRACE));
+
+    return ASTParserAddScratchList(parser, base, AST_NODE_TYPE_INITIALIZER_LIST, 0, open, id);
+}
+
+/* Is a declaration node a definition: a function with a body, an initialized object */
+static bool ParserCIsDefinition(ASTParser parser, ASTNodeId node)
+{
+    switch (ASTTree_GetNodeType(parser->tree, node)) {
+    case AST_NODE_TYPE_FUNCTION_DECL:
+        return ASTTree_GetChild(parser->tree, node, 1) != AST_NODE_ID_NONE || ASTParserFindLazyBody(parser, node) ||
+            ASTParserFindLoweredBody(parser, node);
+    case AST_NODE_TYPE_VARIABLE_DECL:
+        return ASTTree_GetData(parser->tree, node).lhs != AST_NODE_ID_NONE;
+    default:
+        return false;
+    }
+}
+
+/* The completed type of a redeclaration: array length and prototype, whichever declaration has them */
+static ASTTypeId ParserCCompositeType(ASTParser parser, ASTTypeId existing, ASTTypeId type)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, existing);
+
+    if (info->kind == AST_TYPE_KIND_ARRAY && !(info->flags & AST_TYPE_FLAG_SIZED))
+        return type;
+
+    if (info->kind == AST_TYPE_KIND_FUNCTION && !(info->flags & AST_TYPE_FLAG_PROTOTYPE))
+        return type;
+
+    return existing;
+}
+
+/**
+ * Declare the name of a declarator. Names with linkage may be declared
+ * again with a compatible type (C11 6.7p3), typedef names with the same
+ * type; the symbol is shared and its type completed.
+ */
+static ParserResult ParserCDeclareName(ASTParser parser, ASTSymbolKind kind, const ParserCDeclSpec* spec,
+    const ParserCDeclarator* declarator, ASTSymbolId* id)
+{
+    ParserResult result = ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_ORDINARY, declarator->name,
+        kind, 0, AST_NODE_ID_NONE, id);
+
+    if (result == PARSER_ERROR_REDECLARATION) {
+        const ASTSymbolInfo* existing = ASTSymbolTable_GetSymbol(parser->symbols, *id);
+
+        bool linked = kind == AST_SYMBOL_KIND_FUNCTION ||
+            (kind == AST_SYMBOL_KIND_VARIABLE &&
+             (ASTSymbolTable_GetDepth(parser->symbols) == 0 || spec->storageClass == C_STORAGE_CLASS_EXTERN));
+
+        bool compatible = existing->kind == (uint16_t)kind && (kind == AST_SYMBOL_KIND_TYPEDEF
+            ? existing->type == declarator->type
+            : linked && ASTTypeTable_AreCompatible(parser->types, existing->type, declarator->type));
+
+        if (!compatible)
+            return ASTParserErrorAt(parser, PARSER_ERROR_REDECLARATION, declarator->nameToken);
+
+        ASTSymbolTable_SetType(parser->symbols, *id, ParserCCompositeType(parser, existing->type, declarator->type));
+
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    if (result != PARSER_RESULT_SUCCESS)
+        return ASTParserErrorAt(parser, result, declarator->nameToken);
+
+    ASTSymbolTable_SetType(parser->symbols, *id, declarator->type);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Point the symbol at its definition, or at its first declaration until there is one */
+static ParserResult ParserCBindNode(ASTParser parser, ASTSymbolId symbol, ASTNodeId node, uint32_t nameToken)
+{
+    ASTNodeId existing = ASTSymbolTable_GetSymbol(parser->symbols, symbol)->node;
+
+    if (existing == AST_NODE_ID_NONE) {
+        ASTSymbolTable_SetNode(parser->symbols, symbol, node);
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    if (!ParserCIsDefinition(parser, node))
+        return PARSER_RESULT_SUCCESS;
+
+    if (ParserCIsDefinition(parser, existing))
+        return ASTParserErrorAt(parser, PARSER_ERROR_REDECLARATION, nameToken);
+
+    ASTSymbolTable_SetNode(parser->symbols, symbol, node);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* FUNCTION_DECL with its parameters, the body slot is filled by the caller */
+static ParserResult ParserCAddFunctionNode(ASTParser parser, const ParserCDeclSpec* spec,
+    const ParserCDeclarator* declarator, ASTSymbolId symbol, ASTNodeId* id)
+{
+    uint32_t base = parser->scratchCount;
+    CHECK_PARSER_RESULT(ASTParserScratchPush(parser, declarator->params));
+    CHECK_PARSER_RESULT(ASTParserScratchPush(parser, AST_NODE_ID_NONE));
+    CHECK_PARSER_RESULT(ASTParserAddScratchList(parser, base, AST_NODE_TYPE_FUNCTION_DECL,
+        AST_DECL_SUBTYPE(AST_SYMBOL_KIND_FUNCTION, C_DECL_STORAGE(spec->storageClass, spec->funcSpecs)), declarator->nameToken, id));
+
+    // Fixed nodes leave rhs free, it holds the symbol
+    ASTNodeData data = ASTTree_GetData(parser->tree, *id);
+    data.rhs = symbol;
+
+    return ASTTree_SetData(parser->tree, *id, data);
+}
+
+static ParserResult ParserCParseFunctionDefinition(ASTParser parser, const ParserCDeclSpec* spec,
+    const ParserCDeclarator* declarator, ASTNodeId* id)
+{
+    if (spec->storageClass == C_STORAGE_CLASS_TYPEDEF || ASTSymbolTable_GetDepth(parser->symbols) != 0)
+        return ASTParserErrorAt(parser, PARSER_ERROR_SYNTAX_ERROR, declarator->nameToken);
+
+    ASTSymbolId symbol;
+    CHECK_PARSER_RESULT(ParserCDeclareName(parser, AST_SYMBOL_KIND_FUNCTION, spec, declarator, &symbol));
+    CHECK_PARSER_RESULT(ParserCAddFunctionNode(parser, spec, declarator, symbol, id));
+    CHECK_PARSER_RESULT(ASTParserScratchPush(parser, *id));
+
+    parser->stats.functionDefinitions++;
+
+    // The symbol points at the definition before the body is parsed, a
+    // recursive call resolves to it and a second definition is an error
+    if (parser->lazyFunctionBodies) {
+        CHECK_PARSER_RESULT(ASTParserSkipFunctionBody(parser, *id));
+        return ParserCBindNode(parser, symbol, *id, declarator->nameToken);
+    }
+
+    ASTNodeId existing = ASTSymbolTable_GetSymbol(parser->symbols, symbol)->node;
+    if (existing != AST_NODE_ID_NONE && ParserCIsDefinition(parser, existing))
+        return ASTParserErrorAt(parser, PARSER_ERROR_REDECLARATION, declarator->nameToken);
+    ASTSymbolTable_SetNode(parser->symbols, symbol, *id);
+
+    ASTNodeId body;
+    CHECK_PARSER_RESULT(ASTParserParseBody(parser, *id, &body));
+
+    return ASTTree_SetChild(parser->tree, *id, 1, body);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseDeclarationList(
+    ASTParser parser,
+    ASTNodeId* last)
+{
+    *last = AST_NODE_ID_NONE;
+
+    if (ASTParserIsKeyword(ASTParserPeek(parser), C_KEYWORD_STATIC_ASSERT))
+        return ParserCParseStaticAssert(parser);
+
+    ParserCDeclSpec spec;
+    CHECK_PARSER_RESULT(ParserCParseDeclSpec(parser, C_DECL_SPEC_STORAGE, &spec));
+
+    // Only a tag, `struct S { ... };`
+    if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON))
+        return ASTParserAdvance(parser);
+
+    for (uint32_t index = 0;; index++) {
+        ParserCDeclarator declarator;
+        CHECK_PARSER_RESULT(ParserCParseDeclarator(parser, spec.type, C_DECLARATOR_NAMED, &declarator));
+
+        // A function declarator followed by a body is a definition
+        if (index == 0 && declarator.params != AST_NODE_ID_NONE &&
+            ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_LBRACE))
+            return ParserCParseFunctionDefinition(parser, &spec, &declarator, last);
+
+        CHECK_PARSER_RESULT(ParserCParseInitDeclarator(parser, &spec, &declarator, true, last));
+        CHECK_PARSER_RESULT(ASTParserScratchPush(parser, *last));
+
+        if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA))
+            break;
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+
+    return ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseDeclaration(
+    ASTParser parser,
+    ASTNode* node)
+{
+    if (!parser || !node)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeId last;
+    CHECK_PARSER_RESULT(ParserCParseDeclarationList(parser, &last));
+
+    *node = AST_NODE_FROM_ID(last);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseInitDeclarator(
+    ASTParser parser,
+    const ParserCDeclSpec* spec,
+    const ParserCDeclarator* declarator,
+    bool parseInitializer,
+    ASTNodeId* id)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, declarator->type);
+    bool initialized = parseInitializer &&
+        ParserCIsOperator(ASTParserPeek(parser), OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ASSIGN);
+
+    ASTSymbolKind kind = AST_SYMBOL_KIND_VARIABLE;
+    if (spec->storageClass == C_STORAGE_CLASS_TYPEDEF)
+        kind = AST_SYMBOL_KIND_TYPEDEF;
+    else if (info->kind == AST_TYPE_KIND_FUNCTION)
+        kind = AST_SYMBOL_KIND_FUNCTION;
+
+    if (initialized && kind != AST_SYMBOL_KIND_VARIABLE)
+        return ASTParserError(parser, PARSER_ERROR_SYNTAX_ERROR);
+
+    // The name is in scope from the end of its declarator, its own initializer sees it
+    ASTSymbolId symbol;
+    CHECK_PARSER_RESULT(ParserCDeclareName(parser, kind, spec, declarator, &symbol));
+
+    switch (kind) {
+    case AST_SYMBOL_KIND_TYPEDEF:
+        CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_TYPEDEF_DECL,
+            AST_DECL_SUBTYPE(kind, spec->storageClass), declarator->nameToken, declarator->type, symbol, id));
+        break;
+
+    case AST_SYMBOL_KIND_FUNCTION:
+        CHECK_PARSER_RESULT(ParserCAddFunctionNode(parser, spec, declarator, symbol, id));
+        break;
+
+    default: {
+        ASTNodeId initializer = AST_NODE_ID_NONE;
+        if (initialized) {
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ParserCParseInitializer(parser, &initializer));
+        }
+
+        CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_VARIABLE_DECL,
+            AST_DECL_SUBTYPE(kind, spec->storageClass), declarator->nameToken, initializer, symbol, id));
+        break;
+    }
+    }
+
+    return ParserCBindNode(parser, symbol, *id, declarator->nameToken);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseFunctionBody(
+    ASTParser parser,
+    ASTNode function,
+    ASTNode* node)
+{
+    if (!parser || !function || !node)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeId id = AST_NODE_TO_ID(function);
+    ASTNodeId params = ASTTree_GetChild(parser->tree, id, 0);
+
+    // Parameters and the outermost block share the function scope, the
+    // prototype scope they were declared in is gone
+    ASTScope scope;
+    CHECK_PARSER_RESULT(ASTSymbolTable_PushScope(parser->symbols, AST_SCOPE_KIND_FUNCTION, &scope));
+
+    ParserResult result = PARSER_RESULT_SUCCESS;
+    uint32_t count = ASTTree_GetChildCount(parser->tree, params);
+
+    for (uint32_t i = 0; i < count && result == PARSER_RESULT_SUCCESS; i++) {
+        ASTNodeId param = ASTTree_GetChild(parser->tree, params, i);
+        ASTNodeData data = ASTTree_GetData(parser->tree, param);
+
+        const ASTSymbolInfo* declared = ASTSymbolTable_GetSymbol(parser->symbols, data.rhs);
+        if (!declared)
+            continue;
+
+        ParserIdentifierId name = declared->name;
+        ASTTypeId type = declared->type;
+
+        result = ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_ORDINARY, name,
+            AST_SYMBOL_KIND_PARAMETER, 0, param, &data.rhs);
+        if (result != PARSER_RESULT_SUCCESS) {
+            ASTParserErrorAt(parser, result, ASTTree_GetMainToken(parser->tree, param));
+            break;
+        }
+
+        ASTSymbolTable_SetType(parser->symbols, data.rhs, type);
+        result = ASTTree_SetData(parser->tree, param, data);
+    }
+
+    ASTNodeId body = AST_NODE_ID_NONE;
+    parser->pendingLabels = 0;
+
+    if (result == PARSER_RESULT_SUCCESS)
+        result = ParserCParseCompoundStatement(parser, false, &body);
+
+    // A goto to a label the body never defines
+    if (result == PARSER_RESULT_SUCCESS && parser->pendingLabels)
+        result = ASTParserErrorAt(parser, PARSER_ERROR_UNKNOWN_IDENTIFIER, ASTTree_GetMainToken(parser->tree, id));
+
+    ASTSymbolTable_PopScope(parser->symbols, scope);
+    CHECK_PARSER_RESULT(result);
+
+    *node = AST_NODE_FROM_ID(body);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
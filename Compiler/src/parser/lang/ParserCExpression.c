@@ -0,0 +1,404 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCInternal.h"
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/*
+ * Operator tokens are keyed by (kind, value), punctuation by value. Both
+ * fit in a byte, so the operator after an operand is one table load away.
+ */
+#define PARSER_C_OPERATOR_KEY(type, op)     (((uint32_t)(type) << 4) | (uint32_t)(op))
+#define PARSER_C_PUNCTUATION_KEY(p)         (128u + (uint32_t)(p))
+#define PARSER_C_OPERATOR_KEY_COUNT         144u
+
+#define PARSER_C_BINARY(type, op, prec, binaryOp) \
+    [PARSER_C_OPERATOR_KEY(type, op)] = { prec, C_ASSOC_LEFT, binaryOp, AST_NODE_TYPE_BINARY_EXPR }
+#define PARSER_C_ASSIGN(op, binaryOp) \
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_ASSIGNMENT, op)] = { C_PREC_ASSIGNMENT, C_ASSOC_RIGHT, binaryOp, AST_NODE_TYPE_ASSIGNMENT_EXPR }
+#define PARSER_C_POSTFIX(key, nodeType, op) \
+    [key] = { C_PREC_POSTFIX, C_ASSOC_LEFT, op, nodeType }
+
+static const ParserCOperatorInfo s_ParserCOperators[PARSER_C_OPERATOR_KEY_COUNT] = {
+    // ===== Binary =====
+    PARSER_C_BINARY(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_ADD, C_PREC_ADDITIVE, C_BINARY_OP_ADD),
+    PARSER_C_BINARY(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_SUBTRACT, C_PREC_ADDITIVE, C_BINARY_OP_SUBTRACT),
+    PARSER_C_BINARY(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MULTIPLY, C_PREC_MULTIPLICATIVE, C_BINARY_OP_MULTIPLY),
+    PARSER_C_BINARY(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_DIVIDE, C_PREC_MULTIPLICATIVE, C_BINARY_OP_DIVIDE),
+    PARSER_C_BINARY(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MODULO, C_PREC_MULTIPLICATIVE, C_BINARY_OP_MODULO),
+
+    PARSER_C_BINARY(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_AND, C_PREC_BITWISE_AND, C_BINARY_OP_BITWISE_AND),
+    PARSER_C_BINARY(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_OR, C_PREC_BITWISE_OR, C_BINARY_OP_BITWISE_OR),
+    PARSER_C_BINARY(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_XOR, C_PREC_BITWISE_XOR, C_BINARY_OP_BITWISE_XOR),
+    PARSER_C_BINARY(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHL, C_PREC_SHIFT, C_BINARY_OP_SHIFT_LEFT),
+    PARSER_C_BINARY(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHR, C_PREC_SHIFT, C_BINARY_OP_SHIFT_RIGHT),
+
+    PARSER_C_BINARY(OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_AND, C_PREC_LOGICAL_AND, C_BINARY_OP_LOGICAL_AND),
+    PARSER_C_BINARY(OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_OR, C_PREC_LOGICAL_OR, C_BINARY_OP_LOGICAL_OR),
+
+    PARSER_C_BINARY(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_EQUAL, C_PREC_EQUALITY, C_BINARY_OP_EQUAL),
+    PARSER_C_BINARY(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_NOT_EQUAL, C_PREC_EQUALITY, C_BINARY_OP_NOT_EQUAL),
+    PARSER_C_BINARY(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS, C_PREC_RELATIONAL, C_BINARY_OP_LESS),
+    PARSER_C_BINARY(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER, C_PREC_RELATIONAL, C_BINARY_OP_GREATER),
+    PARSER_C_BINARY(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS_EQUAL, C_PREC_RELATIONAL, C_BINARY_OP_LESS_EQUAL),
+    PARSER_C_BINARY(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER_EQUAL, C_PREC_RELATIONAL, C_BINARY_OP_GREATER_EQUAL),
+
+    // ===== Assignment =====
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_ASSIGN, C_BINARY_OP_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_ADD_ASSIGN, C_BINARY_OP_ADD_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_SUBTRACT_ASSIGN, C_BINARY_OP_SUB_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_MULTIPLY_ASSIGN, C_BINARY_OP_MUL_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_DIVIDE_ASSIGN, C_BINARY_OP_DIV_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_MODULO_ASSIGN, C_BINARY_OP_MOD_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_AND_ASSIGN, C_BINARY_OP_AND_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_OR_ASSIGN, C_BINARY_OP_OR_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_XOR_ASSIGN, C_BINARY_OP_XOR_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_SHL_ASSIGN, C_BINARY_OP_SHL_ASSIGN),
+    PARSER_C_ASSIGN(ASSINGMENT_OPERATOR_SHR_ASSIGN, C_BINARY_OP_SHR_ASSIGN),
+
+    // ===== Conditional and comma =====
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_TERNARY, TERNARY_OPERATOR_CONDITIONAL)] =
+        { C_PREC_CONDITIONAL, C_ASSOC_RIGHT, C_BINARY_OP_NONE, AST_NODE_TYPE_TERNARY_EXPR },
+    [PARSER_C_PUNCTUATION_KEY(PUNCTUATION_COMMA)] =
+        { C_PREC_COMMA, C_ASSOC_LEFT, C_BINARY_OP_COMMA, AST_NODE_TYPE_COMMA_EXPR },
+
+    // ===== Postfix =====
+    PARSER_C_POSTFIX(PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_UNARY, UNARY_OPERATOR_INCREMENT), AST_NODE_TYPE_UNARY_EXPR, C_UNARY_OP_POST_INCREMENT),
+    PARSER_C_POSTFIX(PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_UNARY, UNARY_OPERATOR_DECREMENT), AST_NODE_TYPE_UNARY_EXPR, C_UNARY_OP_POST_DECREMENT),
+    PARSER_C_POSTFIX(PARSER_C_PUNCTUATION_KEY(PUNCTUATION_LPAREN), AST_NODE_TYPE_CALL_EXPR, 0),
+    PARSER_C_POSTFIX(PARSER_C_PUNCTUATION_KEY(PUNCTUATION_LBRACKET), AST_NODE_TYPE_ARRAY_SUBSCRIPT_EXPR, 0),
+    PARSER_C_POSTFIX(PARSER_C_PUNCTUATION_KEY(PUNCTUATION_DOT), AST_NODE_TYPE_MEMBER_EXPR, 0),
+    PARSER_C_POSTFIX(PARSER_C_PUNCTUATION_KEY(PUNCTUATION_ARROW), AST_NODE_TYPE_ARROW_EXPR, 0),
+};
+
+/* ParserCUnaryOperator of the tokens that can start a unary expression */
+static const uint8_t s_ParserCPrefixOperators[PARSER_C_OPERATOR_KEY_COUNT] = {
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_ADD)]      = C_UNARY_OP_PLUS,
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_SUBTRACT)] = C_UNARY_OP_MINUS,
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MULTIPLY)] = C_UNARY_OP_DEREFERENCE,
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_AND)]            = C_UNARY_OP_ADDRESS_OF,
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_NOT)]            = C_UNARY_OP_BITWISE_NOT,
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_NOT)]            = C_UNARY_OP_LOGICAL_NOT,
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_UNARY, UNARY_OPERATOR_INCREMENT)]          = C_UNARY_OP_PRE_INCREMENT,
+    [PARSER_C_OPERATOR_KEY(OPERATOR_TYPE_UNARY, UNARY_OPERATOR_DECREMENT)]          = C_UNARY_OP_PRE_DECREMENT,
+};
+
+ML_FORCE_INLINE uint32_t ParserCOperatorKey(const struct LexerToken_T* token)
+{
+    if (token->flags == TOKEN_TYPE_OPERATOR)
+        return PARSER_C_OPERATOR_KEY(token->kind & 0x7u, token->value & 0xFu);
+    if (token->flags == TOKEN_TYPE_PUNCTUATION)
+        return PARSER_C_PUNCTUATION_KEY(token->value & 0xFu);
+    return 0;
+}
+
+static bool ParserCIsStringLiteral(const struct LexerToken_T* token)
+{
+    return token->flags == TOKEN_TYPE_LITERAL && token->kind == LITERAL_TYPE_STRING;
+}
+
+static ParserResult ParserCParsePrimary(ASTParser parser, ASTNodeId* id)
+{
+    const struct LexerToken_T* token = ASTParserPeek(parser);
+    uint32_t index = ASTParserTokenIndex(parser);
+
+    switch (token->flags) {
+    case TOKEN_TYPE_IDENTIFIER: {
+        // lhs is the interned name, rhs the ordinary binding visible here
+        ParserIdentifierId name;
+        CHECK_PARSER_RESULT(ASTParserTokenName(parser, LexerPeekN(parser->lexer, 0), &name));
+
+        ASTSymbolId symbol = ASTSymbolTable_Lookup(parser->symbols, AST_NAMESPACE_ORDINARY, name, 0);
+
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        return ASTParserAddNode(parser, AST_NODE_TYPE_IDENTIFIER, 0, index, name, symbol, id);
+    }
+
+    case TOKEN_TYPE_LITERAL: {
+        // Numeric literals keep their literal table index, character
+        // literals their LexerStringFlags
+        uint32_t value = token->value;
+
+        switch (token->kind) {
+        case LITERAL_TYPE_INTEGER:
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            return ASTParserAddNode(parser, AST_NODE_TYPE_INTEGER_LITERAL, 0, index, value, 0, id);
+        case LITERAL_TYPE_FLOAT:
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            return ASTParserAddNode(parser, AST_NODE_TYPE_FLOAT_LITERAL, 0, index, value, 0, id);
+        case LITERAL_TYPE_CHAR:
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            return ASTParserAddNode(parser, AST_NODE_TYPE_CHAR_LITERAL, 0, index, value, 0, id);
+        case LITERAL_TYPE_STRING: {
+            // Adjacent pieces are one literal, lhs counts the tokens
+            uint32_t pieces = 0;
+            do {
+                CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+                pieces++;
+            } while (ParserCIsStringLiteral(ASTParserPeek(parser)));
+            return ASTParserAddNode(parser, AST_NODE_TYPE_STRING_LITERAL, 0, index, pieces, 0, id);
+        }
+        default:
+            break;
+        }
+        break;
+    }
+
+    case TOKEN_TYPE_PUNCTUATION:
+        if (token->value != PUNCTUATION_LPAREN)
+            break;
+
+        if (ParserCIsTypeNameAt(parser, 1)) {
+            // ===== CAST =====
+            ASTNodeId type;
+            ASTNodeId operand;
+
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ParserCParseTypeName(parser, &type));
+            CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+            CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_UNARY, &operand));
+
+            return ParserCAddFoldedNode(parser, AST_NODE_TYPE_CAST_EXPR, 0, index, type, operand, id);
+        }
+
+        // Parentheses only group, the inner node is the result
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_NONE, id));
+        return ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS);
+
+    default:
+        break;
+    }
+
+    return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+}
+
+static ParserResult ParserCParseUnary(ASTParser parser, ASTNodeId* id)
+{
+    const struct LexerToken_T* token = ASTParserPeek(parser);
+    uint32_t index = ASTParserTokenIndex(parser);
+    ASTNodeId operand;
+
+    if (ASTParserIsKeyword(token, C_KEYWORD_SIZEOF)) {
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+        // sizeof ( type-name ), rhs tells the operand is a type
+        if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_LPAREN) &&
+            ParserCIsTypeNameAt(parser, 1)) {
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ParserCParseTypeName(parser, &operand));
+            CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+            return ParserCAddFoldedNode(parser, AST_NODE_TYPE_SIZEOF_EXPR, C_UNARY_OP_SIZEOF, index, operand, 1, id);
+        }
+
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_UNARY, &operand));
+        return ParserCAddFoldedNode(parser, AST_NODE_TYPE_SIZEOF_EXPR, C_UNARY_OP_SIZEOF, index, operand, 0, id);
+    }
+
+    uint8_t op = s_ParserCPrefixOperators[ParserCOperatorKey(token)];
+    if (op == C_UNARY_OP_NONE)
+        return ParserCParsePrimary(parser, id);
+
+    // The operand takes postfix operators, which bind tighter
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_UNARY, &operand));
+
+    return ParserCAddFoldedNode(parser, AST_NODE_TYPE_UNARY_EXPR, op, index, operand, 0, id);
+}
+
+/* Parse assignment expressions separated by commas onto the scratch stack */
+static ParserResult ParserCParseList(ASTParser parser, bool first)
+{
+    for (;;) {
+        if (!first) {
+            if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA))
+                return PARSER_RESULT_SUCCESS;
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        }
+        first = false;
+
+        ASTNodeId item;
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_ASSIGNMENT, &item));
+        CHECK_PARSER_RESULT(ASTParserScratchPush(parser, item));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseExpression(
+    ASTParser parser,
+    ASTNodeId left,
+    uint32_t precedence,
+    ASTNodeId* id)
+{
+    if (precedence < C_PREC_COMMA)
+        precedence = C_PREC_COMMA;
+
+    if (left == AST_NODE_ID_NONE)
+        CHECK_PARSER_RESULT(ParserCParseUnary(parser, &left));
+
+    for (;;) {
+        const ParserCOperatorInfo* info = &s_ParserCOperators[ParserCOperatorKey(ASTParserPeek(parser))];
+        if (info->precedence < precedence)
+            break;
+
+        uint32_t index = ASTParserTokenIndex(parser);
+        uint32_t base = parser->scratchCount;
+        ASTNodeId right;
+        ParserResult result;
+
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+        switch (info->nodeType) {
+        case AST_NODE_TYPE_TERNARY_EXPR: {
+            ASTNodeId children[3];
+            children[0] = left;
+
+            CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_COMMA, &children[1]));
+            CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_COLON, PARSER_ERROR_SYNTAX_ERROR));
+            CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_CONDITIONAL, &children[2]));
+            CHECK_PARSER_RESULT(ASTTree_AddListNode(parser->tree, AST_NODE_TYPE_TERNARY_EXPR, 0, index, children, 3, &left));
+            break;
+        }
+
+        case AST_NODE_TYPE_COMMA_EXPR:
+            // One list node for the whole a, b, c chain
+            result = ASTParserScratchPush(parser, left);
+            if (result == PARSER_RESULT_SUCCESS)
+                result = ParserCParseList(parser, true);
+            if (result != PARSER_RESULT_SUCCESS) {
+                parser->scratchCount = base;
+                return result;
+            }
+            CHECK_PARSER_RESULT(ASTParserAddScratchList(parser, base, AST_NODE_TYPE_COMMA_EXPR, C_BINARY_OP_COMMA, index, &left));
+            break;
+
+        case AST_NODE_TYPE_CALL_EXPR:
+            result = ASTParserScratchPush(parser, left);
+            if (result == PARSER_RESULT_SUCCESS && !ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RPAREN))
+                result = ParserCParseList(parser, true);
+            if (result == PARSER_RESULT_SUCCESS)
+                result = ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS);
+            if (result != PARSER_RESULT_SUCCESS) {
+                parser->scratchCount = base;
+                return result;
+            }
+            CHECK_PARSER_RESULT(ASTParserAddScratchList(parser, base, AST_NODE_TYPE_CALL_EXPR, 0, index, &left));
+            break;
+
+        case AST_NODE_TYPE_ARRAY_SUBSCRIPT_EXPR:
+            CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_NONE, &right));
+            CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RBRACKET, PARSER_ERROR_UNCLOSED_BRACKET));
+            CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_ARRAY_SUBSCRIPT_EXPR, 0, index, left, right, &left));
+            break;
+
+        case AST_NODE_TYPE_MEMBER_EXPR:
+        case AST_NODE_TYPE_ARROW_EXPR: {
+            // rhs is the token of the member name
+            if (ASTParserPeek(parser)->flags != TOKEN_TYPE_IDENTIFIER)
+                return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+            uint32_t member = ASTParserTokenIndex(parser);
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ASTParserAddNode(parser, (ParserASTNodeType)info->nodeType, 0, index, left, member, &left));
+            break;
+        }
+
+        case AST_NODE_TYPE_UNARY_EXPR:
+            // Postfix ++ and --
+            CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_UNARY_EXPR, info->op, index, left, 0, &left));
+            break;
+
+        default: {
+            // Binary and assignment: left associative operators only take
+            // tighter operators on their right. Constant operands fold.
+            uint32_t next = info->associativity == C_ASSOC_RIGHT ? info->precedence : info->precedence + 1u;
+
+            CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, next, &right));
+            CHECK_PARSER_RESULT(ParserCAddFoldedNode(parser, (ParserASTNodeType)info->nodeType, info->op, index, left, right, &left));
+            break;
+        }
+        }
+    }
+
+    *id = left;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR const ParserCOperatorInfo* PARSER_CALL ParserCGetOperatorInfo(
+    const LexerToken token)
+{
+    if (!token)
+        return &s_ParserCOperators[0];
+
+    return &s_ParserCOperators[ParserCOperatorKey(token)];
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ParserCGetPrefixOperator(
+    const struct LexerToken_T* token)
+{
+    return s_ParserCPrefixOperators[ParserCOperatorKey(token)];
+}
+
+PARSER_ATTR uint16_t PARSER_CALL ParserCGetOperatorPrecedence(
+    LexerToken token)
+{
+    return ParserCGetOperatorInfo(token)->precedence;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParsePrimaryExpression(
+    ASTParser parser,
+    ASTNode* node)
+{
+    if (!parser || !node)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeId id;
+    CHECK_PARSER_RESULT(ParserCParsePrimary(parser, &id));
+
+    *node = AST_NODE_FROM_ID(id);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseUnaryOperator(
+    ASTParser parser,
+    ASTNode* node)
+{
+    if (!parser || !node)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeId id;
+    CHECK_PARSER_RESULT(ParserCParseUnary(parser, &id));
+
+    *node = AST_NODE_FROM_ID(id);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseBinaryOperator(
+    ASTParser parser,
+    ASTNode left,
+    int precedence,
+    ASTNode* node)
+{
+    if (!parser || !node)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeId id;
+    CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_TO_ID(left),
+        precedence > 0 ? (uint32_t)precedence : C_PREC_NONE, &id));
+
+    *node = AST_NODE_FROM_ID(id);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
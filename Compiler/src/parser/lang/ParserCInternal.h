@@ -0,0 +1,567 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef PARSER_C_INTERNAL_H
+#define PARSER_C_INTERNAL_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/lang/ParserCLanguage.h"
+
+#include "ir/IRBuilder.h"
+
+#include "../ParserInternal.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+#define C_KEYWORD_BIT(keyword)      ((uint64_t)1 << (keyword))
+
+/* Keywords that start a type name: specifiers and qualifiers */
+#define C_TYPE_NAME_KEYWORDS \
+    (C_KEYWORD_BIT(C_KEYWORD_VOID) | C_KEYWORD_BIT(C_KEYWORD_CHAR) | C_KEYWORD_BIT(C_KEYWORD_SHORT) | \
+     C_KEYWORD_BIT(C_KEYWORD_INT) | C_KEYWORD_BIT(C_KEYWORD_LONG) | C_KEYWORD_BIT(C_KEYWORD_FLOAT) | \
+     C_KEYWORD_BIT(C_KEYWORD_DOUBLE) | C_KEYWORD_BIT(C_KEYWORD_SIGNED) | C_KEYWORD_BIT(C_KEYWORD_UNSIGNED) | \
+     C_KEYWORD_BIT(C_KEYWORD_BOOL) | C_KEYWORD_BIT(C_KEYWORD_COMPLEX) | C_KEYWORD_BIT(C_KEYWORD_STRUCT) | \
+     C_KEYWORD_BIT(C_KEYWORD_UNION) | C_KEYWORD_BIT(C_KEYWORD_ENUM) | C_KEYWORD_BIT(C_KEYWORD_CONST) | \
+     C_KEYWORD_BIT(C_KEYWORD_VOLATILE) | C_KEYWORD_BIT(C_KEYWORD_RESTRICT) | C_KEYWORD_BIT(C_KEYWORD_ATOMIC))
+
+#define C_TYPE_QUALIFIER_KEYWORDS \
+    (C_KEYWORD_BIT(C_KEYWORD_CONST) | C_KEYWORD_BIT(C_KEYWORD_VOLATILE) | \
+     C_KEYWORD_BIT(C_KEYWORD_RESTRICT) | C_KEYWORD_BIT(C_KEYWORD_ATOMIC))
+
+#define C_TAG_KEYWORDS \
+    (C_KEYWORD_BIT(C_KEYWORD_STRUCT) | C_KEYWORD_BIT(C_KEYWORD_UNION) | C_KEYWORD_BIT(C_KEYWORD_ENUM))
+
+#define C_STORAGE_CLASS_KEYWORDS \
+    (C_KEYWORD_BIT(C_KEYWORD_TYPEDEF) | C_KEYWORD_BIT(C_KEYWORD_EXTERN) | C_KEYWORD_BIT(C_KEYWORD_STATIC) | \
+     C_KEYWORD_BIT(C_KEYWORD_AUTO) | C_KEYWORD_BIT(C_KEYWORD_REGISTER) | C_KEYWORD_BIT(C_KEYWORD_THREAD_LOCAL))
+
+#define C_FUNCTION_SPECIFIER_KEYWORDS \
+    (C_KEYWORD_BIT(C_KEYWORD_INLINE) | C_KEYWORD_BIT(C_KEYWORD_NORETURN))
+
+/* Qualifier bits kept in ASTTypeInfo.qualifiers */
+#define C_TYPE_QUALIFIERS \
+    (C_TYPE_QUAL_CONST | C_TYPE_QUAL_VOLATILE | C_TYPE_QUAL_ATOMIC | C_TYPE_QUAL_RESTRICT)
+
+/* Tag identity of an anonymous struct, union or enum, apart from tag symbol ids */
+#define C_ANONYMOUS_TAG(token)      ((token) | 0x80000000u)
+
+static inline bool ParserCIsKeywordIn(const struct LexerToken_T* token, uint64_t keywords)
+{
+    return token->flags == TOKEN_TYPE_KEYWORD && token->value < 64 && (keywords & C_KEYWORD_BIT(token->value));
+}
+
+static inline bool ParserCIsOperator(const struct LexerToken_T* token, uint32_t kind, uint32_t value)
+{
+    return token->flags == TOKEN_TYPE_OPERATOR && token->kind == kind && token->value == value;
+}
+
+static inline bool ParserCIsStar(const struct LexerToken_T* token)
+{
+    return ParserCIsOperator(token, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MULTIPLY);
+}
+
+/**
+ * @brief Does the token `k` positions ahead start a type name
+ *
+ * @description A keyword specifier or qualifier, or an identifier whose
+ *              visible binding is a typedef. The typedef bit lives in the
+ *              interned record, no symbol lookup is made.
+ */
+static inline bool ParserCIsTypeNameAt(ASTParser parser, uint32_t k)
+{
+    LexerToken token = LexerPeekN(parser->lexer, k);
+    if (!token)
+        return false;
+
+    if (token->flags == TOKEN_TYPE_IDENTIFIER) {
+        ParserIdentifierId name;
+        if (ASTParserTokenName(parser, token, &name) != PARSER_RESULT_SUCCESS)
+            return false;
+
+        return ASTParserIsTypedefName(parser, name);
+    }
+
+    return ParserCIsKeywordIn(token, C_TYPE_NAME_KEYWORDS);
+}
+
+/**
+ * @brief Parse the operators binding at least as tight as `precedence`
+ *
+ * @param parser[in] Parser handle
+ * @param left[in] Parsed left operand, AST_NODE_ID_NONE to parse it first
+ * @param precedence[in] Minimum precedence, C_PREC_NONE for a full expression
+ * @param id[out] Expression node
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseExpression(
+    ASTParser parser,
+    ASTNodeId left,
+    uint32_t precedence,
+    ASTNodeId* id);
+
+/**
+ * @brief ParserCUnaryOperator of a token that starts a unary expression, C_UNARY_OP_NONE otherwise
+ *
+ * @description sizeof and casts are told apart by the caller.
+ */
+PARSER_ATTR uint32_t PARSER_CALL ParserCGetPrefixOperator(
+    const struct LexerToken_T* token);
+
+// ===== TARGET =====
+
+/* Sizes in bytes on the LP64 target, 0 for types without a size */
+extern const uint8_t g_ParserCBasicSizes[C_BASIC_TYPE_LONG_DOUBLE_COMPLEX + 1];
+
+/* Conversion rank of the integer types (C11 6.3.1.1) */
+extern const uint8_t g_ParserCIntegerRanks[C_BASIC_TYPE_UNSIGNED_LONG_LONG + 1];
+
+#define C_POINTER_SIZE              8u
+#define C_SIZE_TYPE                 C_BASIC_TYPE_UNSIGNED_LONG
+#define C_PTRDIFF_TYPE              C_BASIC_TYPE_LONG
+
+static inline bool ParserCIsIntegerType(uint32_t type)
+{
+    return type >= C_BASIC_TYPE_BOOL && type <= C_BASIC_TYPE_UNSIGNED_LONG_LONG;
+}
+
+/* Plain char is signed on the target */
+static inline bool ParserCIsSignedType(uint32_t type)
+{
+    return type == C_BASIC_TYPE_CHAR || type == C_BASIC_TYPE_SIGNED_CHAR || type == C_BASIC_TYPE_SHORT ||
+        type == C_BASIC_TYPE_INT || type == C_BASIC_TYPE_LONG || type == C_BASIC_TYPE_LONG_LONG;
+}
+
+static inline uint32_t ParserCTypeWidth(uint32_t type)
+{
+    return type == C_BASIC_TYPE_BOOL ? 1u : g_ParserCBasicSizes[type] * 8u;
+}
+
+/* Integer promotion, every type of lower rank fits in int */
+static inline uint32_t ParserCPromote(uint32_t type)
+{
+    return g_ParserCIntegerRanks[type] < g_ParserCIntegerRanks[C_BASIC_TYPE_INT] ? C_BASIC_TYPE_INT : type;
+}
+
+static inline uint32_t ParserCToUnsigned(uint32_t type)
+{
+    return ParserCIsSignedType(type) ? type + 1u : type;
+}
+
+/**
+ * @brief Value converted to an integer type (C11 6.3.1.2, 6.3.1.3, two's complement)
+ */
+PARSER_ATTR uint64_t PARSER_CALL ParserCConvert(
+    uint64_t value,
+    uint32_t type);
+
+/**
+ * @brief Common type of two promoted integer operands (C11 6.3.1.8)
+ */
+PARSER_ATTR uint32_t PARSER_CALL ParserCCommonType(
+    uint32_t a,
+    uint32_t b);
+
+/**
+ * @brief Size and alignment of a complete object type
+ *
+ * @description Structs and unions are laid out from the members of their
+ *              body: the tag symbol holds it, the parser keeps the body of
+ *              an anonymous tag while it lowers. Bit-fields, anonymous
+ *              members, flexible array members and variable length arrays
+ *              are not laid out.
+ *
+ * @return true when the type has a layout
+ */
+PARSER_ATTR bool PARSER_CALL ParserCGetLayout(
+    ASTParser parser,
+    ASTTypeId type,
+    uint64_t* size,
+    uint32_t* alignment);
+
+/**
+ * @brief Offset and type of a member of a struct or union type
+ *
+ * @return true when the tag has the member and a layout up to it
+ */
+PARSER_ATTR bool PARSER_CALL ParserCGetMember(
+    ASTParser parser,
+    ASTTypeId type,
+    ParserIdentifierId name,
+    uint64_t* offset,
+    ASTTypeId* memberType);
+
+/**
+ * @brief Offset and type of the member at a position in declaration order, for initializers
+ *
+ * @return true when the tag has that many members and a layout up to it
+ */
+PARSER_ATTR bool PARSER_CALL ParserCGetMemberAt(
+    ASTParser parser,
+    ASTTypeId type,
+    uint32_t index,
+    uint64_t* offset,
+    ASTTypeId* memberType);
+
+// ===== CONSTANTS =====
+
+/**
+ * @brief Value of an integer constant expression
+ */
+typedef struct ParserCConstant_T {
+    uint64_t value;             // Value bits, sign extended for signed types
+    uint32_t type;              // Integer ParserCBasicType
+} ParserCConstant;
+
+/**
+ * @brief Get the value of a node that is an integer constant
+ *
+ * @description Integer and character literals, folded literals and names
+ *              of enumeration constants. Operators are folded when their
+ *              node is built, so no subtree is evaluated here.
+ *
+ * @return true when the node is an integer constant
+ */
+PARSER_ATTR bool PARSER_CALL ParserCGetConstant(
+    ASTParser parser,
+    ASTNodeId id,
+    ParserCConstant* constant);
+
+/**
+ * @brief Type of an integer constant token by its value, base and suffix (C11 6.4.4.1)
+ */
+PARSER_ATTR uint32_t PARSER_CALL ParserCLiteralType(
+    const LexerLiteral* literal);
+
+/**
+ * @brief Value of a plain character constant, converted to int
+ *
+ * @return false for prefixed and multi-character constants
+ */
+PARSER_ATTR bool PARSER_CALL ParserCCharValue(
+    const struct LexerToken_T* token,
+    uint64_t* value);
+
+/**
+ * @brief Add a folded literal node holding a constant
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCAddConstantNode(
+    ASTParser parser,
+    const ParserCConstant* constant,
+    uint32_t mainToken,
+    ASTNodeId* id);
+
+/**
+ * @brief Add a BINARY_EXPR, UNARY_EXPR, SIZEOF_EXPR or CAST_EXPR node, folded when constant
+ *
+ * @description Constant operands are evaluated with the integer promotions
+ *              and usual arithmetic conversions of C11 6.3.1 on an LP64
+ *              target. Unsigned arithmetic wraps, an operation whose
+ *              behavior is undefined (signed overflow, division by zero,
+ *              shift out of range) is kept as a node. A folded node becomes
+ *              a literal and its operands are removed when they are the
+ *              newest nodes of the tree.
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCAddFoldedNode(
+    ASTParser parser,
+    ParserASTNodeType type,
+    uint16_t subtype,
+    uint32_t mainToken,
+    uint32_t lhs,
+    uint32_t rhs,
+    ASTNodeId* id);
+
+// ===== DECLARATIONS =====
+
+typedef enum ParserCDeclSpecFlags {
+    C_DECL_SPEC_NONE        = 0,
+    C_DECL_SPEC_STORAGE     = 1 << 0,   // Storage classes and function specifiers are allowed
+} ParserCDeclSpecFlags;
+
+typedef enum ParserCDeclaratorFlags {
+    C_DECLARATOR_ANY        = 0,        // Named or abstract, parameters
+    C_DECLARATOR_ABSTRACT   = 1 << 0,   // No name, type names
+    C_DECLARATOR_NAMED      = 1 << 1,   // Name required
+} ParserCDeclaratorFlags;
+
+typedef struct ParserCDeclarator_T {
+    ParserIdentifierId name;    // PARSER_IDENTIFIER_NONE for an abstract declarator
+    uint32_t nameToken;         // Token of the name, first token of the declarator when abstract
+    ASTTypeId type;             // Declared type
+    ASTNodeId params;           // FUNCTION_TYPE list when the name is declared as a function
+} ParserCDeclarator;
+
+/**
+ * @brief Parse declaration specifiers and intern the type they specify
+ *
+ * @param parser[in] Parser handle
+ * @param flags[in] ParserCDeclSpecFlags
+ * @param spec[out] Specifiers, spec->type is the ASTTypeId
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_UNEXPECTED_TOKEN : No type specifier, or a storage class where none is allowed
+ *      PARSER_ERROR_SYNTAX_ERROR : Invalid combination of specifiers
+ *      PARSER_ERROR_REDECLARATION : Tag redefined, or declared with another kind
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseDeclSpec(
+    ASTParser parser,
+    uint32_t flags,
+    ParserCDeclSpec* spec);
+
+/**
+ * @brief Parse a declarator and derive its type from `base`
+ *
+ * @description Parameters of function declarators are declared in a
+ *              prototype scope that ends with the parameter list, their
+ *              PARAMETER_DECL nodes keep the symbols.
+ *
+ * @param parser[in] Parser handle
+ * @param base[in] Type from the declaration specifiers
+ * @param flags[in] ParserCDeclaratorFlags
+ * @param declarator[out] Name and type
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseDeclarator(
+    ASTParser parser,
+    ASTTypeId base,
+    uint32_t flags,
+    ParserCDeclarator* declarator);
+
+/**
+ * @brief Parse a type name (casts, sizeof), a TYPE_SPECIFIER leaf holding the type
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseTypeName(
+    ASTParser parser,
+    ASTNodeId* id);
+
+/* Does the token `k` positions ahead start a declaration rather than a statement */
+static inline bool ParserCIsDeclarationAt(ASTParser parser, uint32_t k)
+{
+    const struct LexerToken_T* token = ASTParserPeekN(parser, k);
+
+    // `T:` is a label even when T names a type
+    if (token->flags == TOKEN_TYPE_IDENTIFIER)
+        return !ASTParserIsPunctuation(ASTParserPeekN(parser, k + 1), PUNCTUATION_COLON) && ParserCIsTypeNameAt(parser, k);
+
+    return ParserCIsKeywordIn(token, C_TYPE_NAME_KEYWORDS | C_STORAGE_CLASS_KEYWORDS | C_FUNCTION_SPECIFIER_KEYWORDS |
+        C_KEYWORD_BIT(C_KEYWORD_ALIGNAS) | C_KEYWORD_BIT(C_KEYWORD_STATIC_ASSERT));
+}
+
+/**
+ * @brief Parse a declaration at file or block scope
+ *
+ * @description Every declarator gets its own declaration node, pushed on
+ *              the scratch list of the caller. A function definition ends
+ *              the declaration, its body is parsed or, with
+ *              lazyFunctionBodies, skipped.
+ *
+ * @param parser[in] Parser handle
+ * @param last[out] Last declaration node, AST_NODE_ID_NONE when only a tag
+ *                  or a static assertion was declared
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_REDECLARATION : Incompatible redeclaration, or a second definition
+ *      PARSER_ERROR_MISSING_SEMICOLON : The declaration does not end in a semicolon
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseDeclarationList(
+    ASTParser parser,
+    ASTNodeId* last);
+
+/**
+ * @brief Declare one init-declarator of a declaration that is not a function definition
+ *
+ * @param parser[in] Parser handle
+ * @param spec[in] Specifiers of the declaration
+ * @param declarator[in] Parsed declarator
+ * @param parseInitializer[in] Parse an `= initializer` into the node, false
+ *                             leaves it at the current token for the caller
+ * @param id[out] TYPEDEF_DECL, FUNCTION_DECL or VARIABLE_DECL node, rhs is the symbol
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_SYNTAX_ERROR : A typedef or function is initialized
+ *      PARSER_ERROR_REDECLARATION : Incompatible redeclaration, or a second definition
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseInitDeclarator(
+    ASTParser parser,
+    const ParserCDeclSpec* spec,
+    const ParserCDeclarator* declarator,
+    bool parseInitializer,
+    ASTNodeId* id);
+
+// ===== LOWERING =====
+
+typedef enum ParserCLocalKind {
+    C_LOCAL_NONE = 0,                   // Not a local of the body: a global, a typedef, ...
+    C_LOCAL_SSA,                        // Scalar kept as an SSA variable, the symbol id is the variable
+    C_LOCAL_MEMORY,                     // Object in a stack slot
+    C_LOCAL_LABEL,                      // Label, its block
+} ParserCLocalKind;
+
+/**
+ * @brief What the lowering knows of a symbol declared in the body
+ */
+typedef struct ParserCLocal_T {
+    uint8_t kind;                       // ParserCLocalKind
+    uint8_t irType;                     // IRType of an SSA variable
+    uint8_t defined;                    // Label whose statement was lowered
+    IRValueId address;                  // ALLOCA of a memory local
+    IRBlockId block;                    // Block of a label
+} ParserCLocal;
+
+typedef enum ParserCValueKind {
+    C_VALUE_RVALUE = 0,                 // `value` holds the value, IR_VALUE_NONE for void
+    C_VALUE_CONDITION,                  // `value` is an IR_TYPE_I1 comparison of type int
+    C_VALUE_MEMORY,                     // Object at address `value`, also every struct value
+    C_VALUE_VARIABLE,                   // SSA local, `value` is its symbol
+} ParserCValueKind;
+
+/**
+ * @brief Result of a lowered expression
+ */
+typedef struct ParserCValue_T {
+    IRValueId value;
+    ASTTypeId type;                     // C type of the expression
+    uint32_t kind;                      // ParserCValueKind
+} ParserCValue;
+
+/**
+ * @brief State of one function body being lowered
+ */
+typedef struct ParserCLowering_T {
+    ASTParser parser;
+    IRFunction function;
+    IRBuilder builder;
+    IRValueId entryBranch;              // Stack slots go before it
+    ASTTypeId returnType;
+    bool isMain;                        // Falling off its end returns 0
+
+    // Symbols declared since the body started, by id - firstSymbol
+    ASTSymbolId firstSymbol;
+    ParserCLocal* locals;
+    uint32_t localCapacity;
+
+    // Names whose address the body takes, sorted; they live in memory
+    ParserIdentifierId* addressTaken;
+    uint32_t addressTakenCount;
+    uint32_t addressTakenCapacity;
+
+    // ===== Jumps =====
+    IRBlockId breakBlock;
+    IRBlockId continueBlock;
+    bool inSwitch;
+    ASTTypeId switchType;               // Promoted type of the controlling expression
+    IRBlockId defaultBlock;
+    uint32_t* cases;                    // (low bits, high bits, block) of every open switch
+    uint32_t caseCount;
+    uint32_t caseCapacity;
+} ParserCLowering;
+
+/**
+ * @brief Lower an expression binding at least as tight as `precedence`
+ *
+ * @description Mirrors ParserCParseExpression, instructions are emitted
+ *              instead of nodes. The value is left as it is found, an
+ *              lvalue stays an lvalue.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_UNSUPPORTED : A construct the lowering leaves to the AST path
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerExpression(
+    ParserCLowering* lowering,
+    uint32_t precedence,
+    ParserCValue* value);
+
+/**
+ * @brief Convert a value to an rvalue: load an lvalue, decay arrays and functions
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerRValue(
+    ParserCLowering* lowering,
+    ParserCValue* value);
+
+/**
+ * @brief Convert an rvalue to a scalar type, as by assignment or a cast
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerConvert(
+    ParserCLowering* lowering,
+    ParserCValue* value,
+    ASTTypeId type);
+
+/**
+ * @brief Compare a value against zero, for branches
+ *
+ * @param condition[out] IR_TYPE_I1 value
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerCondition(
+    ParserCLowering* lowering,
+    ParserCValue* value,
+    IRValueId* condition);
+
+/**
+ * @brief Store an rvalue, converted to the type of the lvalue
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerStore(
+    ParserCLowering* lowering,
+    const ParserCValue* lvalue,
+    ParserCValue* value);
+
+/**
+ * @brief IRType of a scalar type, IR_TYPE_VOID for aggregates and types the lowering does not handle
+ */
+PARSER_ATTR IRType PARSER_CALL ParserCGetIRType(
+    ASTParser parser,
+    ASTTypeId type);
+
+/**
+ * @brief Local record of a symbol, NULL for symbols declared before the body
+ */
+static inline ParserCLocal* ParserCGetLocal(ParserCLowering* lowering, ASTSymbolId symbol)
+{
+    uint32_t index = symbol - lowering->firstSymbol;
+    return symbol >= lowering->firstSymbol && index < lowering->localCapacity ? &lowering->locals[index] : NULL;
+}
+
+static inline bool ParserCIsVolatile(ASTParser parser, ASTTypeId type)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+    return info && (info->qualifiers & C_TYPE_QUAL_VOLATILE);
+}
+
+/**
+ * @brief Drop the nodes of a type name or constant expression the lowering has read
+ *
+ * @description Kept when they declared something, a tag body or an
+ *              enumerator is found through its symbol.
+ */
+static inline void ParserCLowerDropNodes(ParserCLowering* lowering, uint32_t nodes, uint32_t symbols)
+{
+    if (ASTSymbolTable_GetSymbolCount(lowering->parser->symbols) == symbols)
+        ASTTree_Truncate(lowering->parser->tree, nodes);
+}
+
+// ===== STATEMENTS =====
+
+/**
+ * @brief Parse a compound statement
+ *
+ * @param parser[in] Parser handle
+ * @param scoped[in] Open a block scope, false for a function body whose
+ *                   scope is already open
+ * @param id[out] COMPOUND_STMT node
+ */
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseCompoundStatement(
+    ASTParser parser,
+    bool scoped,
+    ASTNodeId* id);
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseStatementNode(
+    ASTParser parser,
+    ASTNodeId* id);
+
+// ------------------------------------------------------------------------------------------------
+
+#endif // !PARSER_C_INTERNAL_H
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,43 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCInternal.h"
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const ParserLanguageStrategy g_CLanguageStrategy = {
+    .languageName = "C11",
+
+    // Expression parsing
+    .parsePrimaryExpr = ParserCParsePrimaryExpression,
+    .parseBinaryOp = ParserCParseBinaryOperator,
+    .parseUnaryOp = ParserCParseUnaryOperator,
+    .getOpPrecedence = ParserCGetOperatorPrecedence,
+
+    // Declaration parsing
+    .parseDeclaration = ParserCParseDeclaration,
+    .parseTypeSpec = NULL,
+    .isTypeName = ParserCIsTypeName,
+    .parseParamList = NULL,
+
+    // Statement parsing
+    .parseStatement = ParserCParseStatement,
+    .parseFunctionBody = ParserCParseFunctionBody,
+    .lowerFunctionBody = ParserCLowerFunctionBody,
+
+    .userData = NULL,
+};
+
+PARSER_ATTR bool PARSER_CALL ParserCIsTypeName(
+    ASTParser parser)
+{
+    if (!parser)
+        return false;
+
+    return ParserCIsTypeNameAt(parser, 0);
+}
+
+// ------------------------------------------------------------------------------------------------
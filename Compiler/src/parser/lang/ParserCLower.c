@@ -0,0 +1,1128 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCInternal.h"
+#include "../ParserArray.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+static ParserResult ParserCLowerStatement(ParserCLowering* lowering);
+
+/* Local record of a symbol declared in the body, the table grows to cover it */
+static ParserResult ParserCAddLocal(ParserCLowering* lowering, ASTSymbolId symbol, ParserCLocal** local)
+{
+    if (symbol < lowering->firstSymbol)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    uint32_t index = symbol - lowering->firstSymbol;
+    if (index >= lowering->localCapacity) {
+        uint32_t oldCapacity = lowering->localCapacity;
+        CHECK_PARSER_RESULT(ParserArrayReserve((void**)&lowering->locals, &lowering->localCapacity, oldCapacity,
+            index + 1, sizeof(ParserCLocal), 64));
+        memset(lowering->locals + oldCapacity, 0, sizeof(ParserCLocal) * (lowering->localCapacity - oldCapacity));
+    }
+
+    *local = &lowering->locals[index];
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserCPushCase(ParserCLowering* lowering, uint64_t value, IRBlockId block)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&lowering->cases, &lowering->caseCapacity, lowering->caseCount,
+        lowering->caseCount + 3, sizeof(uint32_t), 48));
+
+    lowering->cases[lowering->caseCount++] = (uint32_t)value;
+    lowering->cases[lowering->caseCount++] = (uint32_t)(value >> 32);
+    lowering->cases[lowering->caseCount++] = block;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserCPushAddressTaken(ParserCLowering* lowering, ParserIdentifierId name)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&lowering->addressTaken, &lowering->addressTakenCapacity,
+        lowering->addressTakenCount, lowering->addressTakenCount + 1, sizeof(ParserIdentifierId), 16));
+
+    lowering->addressTaken[lowering->addressTakenCount++] = name;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static int ParserCCompareNames(const void* a, const void* b)
+{
+    ParserIdentifierId x = *(const ParserIdentifierId*)a;
+    ParserIdentifierId y = *(const ParserIdentifierId*)b;
+    return (x > y) - (x < y);
+}
+
+static bool ParserCIsAddressTaken(const ParserCLowering* lowering, ParserIdentifierId name)
+{
+    return lowering->addressTakenCount &&
+        bsearch(&name, lowering->addressTaken, lowering->addressTakenCount, sizeof(ParserIdentifierId),
+            ParserCCompareNames) != NULL;
+}
+
+/**
+ * Find the names the body applies unary & to, before anything is lowered:
+ * such a local needs a stack slot from its declaration on. Names are not
+ * resolved, a shadowed name goes to memory in every scope. An & the scan
+ * takes for binary makes the lowering give up at the operator.
+ */
+static ParserResult ParserCScanAddressTaken(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+    uint32_t open = ASTParserTokenIndex(parser);
+    uint32_t depth = 0;
+    bool operand = false;       // Previous token ends an operand, & after it is binary
+
+    for (;;) {
+        const struct LexerToken_T* token = ASTParserPeek(parser);
+
+        if (token->flags == TOKEN_TYPE_EOF)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        if (token->flags == TOKEN_TYPE_PUNCTUATION) {
+            if (token->value == PUNCTUATION_LBRACE)
+                depth++;
+            else if (token->value == PUNCTUATION_RBRACE && --depth == 0)
+                break;
+        }
+
+        if (!operand && ParserCGetPrefixOperator(token) == C_UNARY_OP_ADDRESS_OF) {
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            while (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_LPAREN))
+                CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+            if (ASTParserPeek(parser)->flags == TOKEN_TYPE_IDENTIFIER) {
+                ParserIdentifierId name;
+                CHECK_PARSER_RESULT(ASTParserTokenName(parser, LexerPeekN(parser->lexer, 0), &name));
+                CHECK_PARSER_RESULT(ParserCPushAddressTaken(lowering, name));
+            }
+
+            operand = false;
+            continue;
+        }
+
+        operand = token->flags == TOKEN_TYPE_IDENTIFIER || token->flags == TOKEN_TYPE_LITERAL ||
+            ASTParserIsPunctuation(token, PUNCTUATION_RPAREN) || ASTParserIsPunctuation(token, PUNCTUATION_RBRACKET);
+
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+
+    if (lowering->addressTakenCount > 1)
+        qsort(lowering->addressTaken, lowering->addressTakenCount, sizeof(ParserIdentifierId), ParserCCompareNames);
+
+    return LexerSeek(parser->lexer, open);
+}
+
+/* Stack slot in the entry block, before its branch to the body */
+static ParserResult ParserCAddStackSlot(ParserCLowering* lowering, ASTTypeId type, IRValueId* address)
+{
+    uint64_t size;
+    uint32_t alignment;
+    if (!ParserCGetLayout(lowering->parser, type, &size, &alignment) || size == 0 || size > UINT32_MAX)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    if (lowering->entryBranch == IR_VALUE_NONE)
+        return IRBuilder_Emit(lowering->builder, IR_OP_ALLOCA, IR_TYPE_PTR, (uint32_t)size, alignment, 0, address);
+
+    return IRFunction_InsertInstruction(lowering->function, lowering->entryBranch, IR_OP_ALLOCA, IR_TYPE_PTR,
+        (uint32_t)size, alignment, 0, address);
+}
+
+/* A local goes to memory when it is no scalar, is volatile or has its address taken */
+static ParserResult ParserCDeclareLocal(ParserCLowering* lowering, ASTSymbolId symbol)
+{
+    ASTParser parser = lowering->parser;
+    const ASTSymbolInfo* info = ASTSymbolTable_GetSymbol(parser->symbols, symbol);
+
+    ParserCLocal* local;
+    CHECK_PARSER_RESULT(ParserCAddLocal(lowering, symbol, &local));
+
+    IRType type = ParserCGetIRType(parser, info->type);
+    if (type != IR_TYPE_VOID && !ParserCIsVolatile(parser, info->type) && !ParserCIsAddressTaken(lowering, info->name)) {
+        local->kind = C_LOCAL_SSA;
+        local->irType = (uint8_t)type;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    IRValueId address;
+    CHECK_PARSER_RESULT(ParserCAddStackSlot(lowering, info->type, &address));
+
+    // The record may have moved while the slot was added
+    CHECK_PARSER_RESULT(ParserCAddLocal(lowering, symbol, &local));
+    local->kind = C_LOCAL_MEMORY;
+    local->address = address;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Address of `offset` bytes into an object */
+static ParserResult ParserCLowerOffset(ParserCLowering* lowering, IRValueId base, uint64_t offset, IRValueId* address)
+{
+    if (offset == 0) {
+        *address = base;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    IRValueId displacement;
+    CHECK_PARSER_RESULT(IRBuilder_GetConstant(lowering->builder, IR_TYPE_I64, offset, &displacement));
+
+    return IRBuilder_Emit(lowering->builder, IR_OP_PTRADD, IR_TYPE_PTR, base, displacement, 0, address);
+}
+
+/**
+ * `{ a, b, ... }` for an array or struct of scalars in memory: the object
+ * is zeroed, the values are stored in order. Designators and nested braces
+ * are left to the AST path.
+ */
+static ParserResult ParserCLowerInitializerList(ParserCLowering* lowering, const ParserCLocal* local, ASTTypeId type)
+{
+    ASTParser parser = lowering->parser;
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+
+    uint64_t size;
+    uint32_t alignment;
+    if (local->kind != C_LOCAL_MEMORY || !ParserCGetLayout(parser, type, &size, &alignment))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    // The stack slot was only given when the size fits
+    IRValueId base = local->address;
+    CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_MEMZERO, IR_TYPE_VOID, base, (uint32_t)size, 0, NULL));
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    for (uint32_t index = 0; !ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RBRACE); index++) {
+        const struct LexerToken_T* token = ASTParserPeek(parser);
+        if (ASTParserIsPunctuation(token, PUNCTUATION_LBRACE) || ASTParserIsPunctuation(token, PUNCTUATION_LBRACKET) ||
+            ASTParserIsPunctuation(token, PUNCTUATION_DOT))
+            return PARSER_ERROR_UNSUPPORTED;
+
+        uint64_t offset;
+        ASTTypeId element;
+
+        if (info->kind == AST_TYPE_KIND_ARRAY) {
+            uint64_t elementSize;
+            uint32_t elementAlignment;
+            if (index >= info->value || !ParserCGetLayout(parser, info->base, &elementSize, &elementAlignment))
+                return PARSER_ERROR_UNSUPPORTED;
+
+            element = info->base;
+            offset = elementSize * index;
+        }
+        else if ((info->kind != AST_TYPE_KIND_UNION || index == 0) &&
+                 ParserCGetMemberAt(parser, type, index, &offset, &element)) {
+            // Qualifiers of the object apply to its members
+            if (info->qualifiers)
+                CHECK_PARSER_RESULT(ASTTypeTable_GetQualified(parser->types, element, info->qualifiers, &element));
+        }
+        else {
+            return PARSER_ERROR_UNSUPPORTED;
+        }
+
+        ParserCValue lvalue = { .kind = C_VALUE_MEMORY, .type = element };
+        ParserCValue value;
+        CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_ASSIGNMENT, &value));
+        CHECK_PARSER_RESULT(ParserCLowerOffset(lowering, base, offset, &lvalue.value));
+        CHECK_PARSER_RESULT(ParserCLowerStore(lowering, &lvalue, &value));
+
+        // A trailing comma is allowed
+        if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA))
+            break;
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+
+    return ASTParserExpectPunctuation(parser, PUNCTUATION_RBRACE, PARSER_ERROR_UNCLOSED_BRACE);
+}
+
+static ParserResult ParserCLowerInitializer(ParserCLowering* lowering, ASTSymbolId symbol)
+{
+    ASTParser parser = lowering->parser;
+    const ParserCLocal* local = ParserCGetLocal(lowering, symbol);
+    ASTTypeId type = ASTSymbolTable_GetSymbol(parser->symbols, symbol)->type;
+    ASTTypeKind kind = (ASTTypeKind)ASTTypeTable_Get(parser->types, type)->kind;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_LBRACE))
+        return ParserCLowerInitializerList(lowering, local, type);
+
+    // An array is only initialized by a brace list here, not by a string
+    if (kind == AST_TYPE_KIND_ARRAY)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    ParserCValue lvalue = {
+        .kind = local->kind == C_LOCAL_SSA ? C_VALUE_VARIABLE : C_VALUE_MEMORY,
+        .value = local->kind == C_LOCAL_SSA ? symbol : local->address,
+        .type = type,
+    };
+    ParserCValue value;
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_ASSIGNMENT, &value));
+
+    return ParserCLowerStore(lowering, &lvalue, &value);
+}
+
+/**
+ * Declarations build their nodes as on the AST path, the declarators
+ * declare the names; initializers are lowered in place of their nodes.
+ */
+static ParserResult ParserCLowerDeclaration(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+
+    if (ASTParserIsKeyword(ASTParserPeek(parser), C_KEYWORD_STATIC_ASSERT))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    ParserCDeclSpec spec;
+    CHECK_PARSER_RESULT(ParserCParseDeclSpec(parser, C_DECL_SPEC_STORAGE, &spec));
+
+    // Only a tag, `struct S { ... };`
+    if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON))
+        return ASTParserAdvance(parser);
+
+    // Static locals are file-scope data, left to the AST path
+    if (spec.storageClass == C_STORAGE_CLASS_STATIC)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    for (;;) {
+        ParserCDeclarator declarator;
+        CHECK_PARSER_RESULT(ParserCParseDeclarator(parser, spec.type, C_DECLARATOR_NAMED, &declarator));
+
+        if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_LBRACE))
+            return PARSER_ERROR_UNSUPPORTED;
+
+        ASTNodeId node;
+        CHECK_PARSER_RESULT(ParserCParseInitDeclarator(parser, &spec, &declarator, false, &node));
+
+        ASTSymbolId symbol = ASTTree_GetData(parser->tree, node).rhs;
+        bool initialized = ParserCIsOperator(ASTParserPeek(parser), OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ASSIGN);
+
+        // Typedefs, functions and extern objects name nothing of the body
+        if (ASTTree_GetNodeType(parser->tree, node) == AST_NODE_TYPE_VARIABLE_DECL &&
+            spec.storageClass != C_STORAGE_CLASS_EXTERN) {
+            CHECK_PARSER_RESULT(ParserCDeclareLocal(lowering, symbol));
+            if (initialized)
+                CHECK_PARSER_RESULT(ParserCLowerInitializer(lowering, symbol));
+        }
+        else if (initialized) {
+            return PARSER_ERROR_UNSUPPORTED;
+        }
+
+        if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA))
+            break;
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+
+    return ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON);
+}
+
+static ParserResult ParserCLowerBlockItem(ParserCLowering* lowering)
+{
+    if (ParserCIsDeclarationAt(lowering->parser, 0))
+        return ParserCLowerDeclaration(lowering);
+
+    return ParserCLowerStatement(lowering);
+}
+
+static ParserResult ParserCLowerCompound(ParserCLowering* lowering, bool scoped)
+{
+    ASTParser parser = lowering->parser;
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_LBRACE, PARSER_ERROR_UNEXPECTED_TOKEN));
+
+    ASTScope scope = NULL;
+    if (scoped)
+        CHECK_PARSER_RESULT(ASTSymbolTable_PushScope(parser->symbols, AST_SCOPE_KIND_BLOCK, &scope));
+
+    ParserResult result = PARSER_RESULT_SUCCESS;
+
+    while (result == PARSER_RESULT_SUCCESS && !ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RBRACE)) {
+        if (ASTParserPeek(parser)->flags == TOKEN_TYPE_EOF)
+            result = PARSER_ERROR_UNSUPPORTED;
+        else
+            result = ParserCLowerBlockItem(lowering);
+    }
+
+    if (result == PARSER_RESULT_SUCCESS)
+        result = ASTParserAdvance(parser);
+
+    if (scoped)
+        ASTSymbolTable_PopScope(parser->symbols, scope);
+
+    return result;
+}
+
+/* `( expression )` of if, while, do and switch */
+static ParserResult ParserCLowerParenthesized(ParserCLowering* lowering, ParserCValue* value)
+{
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(lowering->parser, PUNCTUATION_LPAREN, PARSER_ERROR_UNEXPECTED_TOKEN));
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_NONE, value));
+    return ASTParserExpectPunctuation(lowering->parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS);
+}
+
+/* Branch on a condition to two new blocks, both sealed */
+static ParserResult ParserCLowerBranch(ParserCLowering* lowering, ParserCValue* value, IRBlockId* whenTrue, IRBlockId* whenFalse)
+{
+    IRValueId condition;
+    CHECK_PARSER_RESULT(ParserCLowerCondition(lowering, value, &condition));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(lowering->builder, whenTrue));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(lowering->builder, whenFalse));
+    return IRBuilder_Emit(lowering->builder, IR_OP_CONDBR, IR_TYPE_VOID, condition, *whenTrue, *whenFalse, NULL);
+}
+
+/* Branch to a block unless the current one already ended */
+static ParserResult ParserCLowerJump(ParserCLowering* lowering, IRBlockId target)
+{
+    if (IRBuilder_GetBlock(lowering->builder) == IR_BLOCK_NONE)
+        return PARSER_RESULT_SUCCESS;
+
+    return IRBuilder_Emit(lowering->builder, IR_OP_BR, IR_TYPE_VOID, target, 0, 0, NULL);
+}
+
+/* Lower the body of a loop or switch with new break and continue targets */
+static ParserResult ParserCLowerNested(ParserCLowering* lowering, IRBlockId breakBlock, IRBlockId continueBlock)
+{
+    IRBlockId outerBreak = lowering->breakBlock;
+    IRBlockId outerContinue = lowering->continueBlock;
+
+    lowering->breakBlock = breakBlock;
+    lowering->continueBlock = continueBlock;
+
+    ParserResult result = ParserCLowerStatement(lowering);
+
+    lowering->breakBlock = outerBreak;
+    lowering->continueBlock = outerContinue;
+
+    return result;
+}
+
+static ParserResult ParserCLowerIf(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+    IRBuilder builder = lowering->builder;
+
+    ParserCValue value;
+    IRBlockId then;
+    IRBlockId otherwise;
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ParserCLowerParenthesized(lowering, &value));
+    CHECK_PARSER_RESULT(ParserCLowerBranch(lowering, &value, &then, &otherwise));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, then));
+
+    IRBuilder_SetBlock(builder, then);
+    CHECK_PARSER_RESULT(ParserCLowerStatement(lowering));
+
+    // Without an else the false block is where both paths meet
+    if (!ASTParserIsKeyword(ASTParserPeek(parser), C_KEYWORD_ELSE)) {
+        CHECK_PARSER_RESULT(ParserCLowerJump(lowering, otherwise));
+        CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, otherwise));
+        IRBuilder_SetBlock(builder, otherwise);
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    IRBlockId thenEnd = IRBuilder_GetBlock(builder);
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, otherwise));
+    IRBuilder_SetBlock(builder, otherwise);
+    CHECK_PARSER_RESULT(ParserCLowerStatement(lowering));
+
+    IRBlockId elseEnd = IRBuilder_GetBlock(builder);
+    if (thenEnd == IR_BLOCK_NONE && elseEnd == IR_BLOCK_NONE)
+        return PARSER_RESULT_SUCCESS;
+
+    IRBlockId join;
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &join));
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, join));
+
+    if (thenEnd != IR_BLOCK_NONE) {
+        IRBuilder_SetBlock(builder, thenEnd);
+        CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_BR, IR_TYPE_VOID, join, 0, 0, NULL));
+    }
+
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, join));
+    IRBuilder_SetBlock(builder, join);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* The header takes the back edge, it is sealed once the body is done */
+static ParserResult ParserCLowerWhile(ParserCLowering* lowering)
+{
+    IRBuilder builder = lowering->builder;
+
+    IRBlockId header;
+    CHECK_PARSER_RESULT(ASTParserAdvance(lowering->parser));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &header));
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, header));
+    IRBuilder_SetBlock(builder, header);
+
+    ParserCValue value;
+    IRBlockId body;
+    IRBlockId exit;
+    CHECK_PARSER_RESULT(ParserCLowerParenthesized(lowering, &value));
+    CHECK_PARSER_RESULT(ParserCLowerBranch(lowering, &value, &body, &exit));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, body));
+
+    IRBuilder_SetBlock(builder, body);
+    CHECK_PARSER_RESULT(ParserCLowerNested(lowering, exit, header));
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, header));
+
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, header));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, exit));
+    IRBuilder_SetBlock(builder, exit);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserCLowerDoWhile(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+    IRBuilder builder = lowering->builder;
+
+    IRBlockId body;
+    IRBlockId condition;
+    IRBlockId exit;
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &body));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &condition));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &exit));
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, body));
+
+    IRBuilder_SetBlock(builder, body);
+    CHECK_PARSER_RESULT(ParserCLowerNested(lowering, exit, condition));
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, condition));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, condition));
+
+    if (!ASTParserIsKeyword(ASTParserPeek(parser), C_KEYWORD_WHILE))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    ParserCValue value;
+    IRValueId test;
+    IRBuilder_SetBlock(builder, condition);
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ParserCLowerParenthesized(lowering, &value));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+    CHECK_PARSER_RESULT(ParserCLowerCondition(lowering, &value, &test));
+    CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_CONDBR, IR_TYPE_VOID, test, body, exit, NULL));
+
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, body));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, exit));
+    IRBuilder_SetBlock(builder, exit);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Move past the step of a for statement, it is lowered after the body */
+static ParserResult ParserCSkipStep(ASTParser parser)
+{
+    uint32_t depth = 0;
+
+    for (;;) {
+        const struct LexerToken_T* token = ASTParserPeek(parser);
+
+        if (token->flags == TOKEN_TYPE_EOF)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        if (ASTParserIsPunctuation(token, PUNCTUATION_LPAREN))
+            depth++;
+        else if (ASTParserIsPunctuation(token, PUNCTUATION_RPAREN) && depth-- == 0)
+            return ASTParserAdvance(parser);
+
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+}
+
+/**
+ * The step comes before the body in the source and after it in the code.
+ * Its tokens are skipped and lowered once the body is: the lexer keeps
+ * every token of the body, so it can go back to them.
+ */
+static ParserResult ParserCLowerForClauses(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+    IRBuilder builder = lowering->builder;
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_LPAREN, PARSER_ERROR_UNEXPECTED_TOKEN));
+
+    // ===== INIT =====
+    if (ParserCIsDeclarationAt(parser, 0)) {
+        CHECK_PARSER_RESULT(ParserCLowerDeclaration(lowering));
+    }
+    else {
+        if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON)) {
+            ParserCValue init;
+            CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_NONE, &init));
+        }
+        CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+    }
+
+    // ===== CONDITION =====
+    IRBlockId header;
+    IRBlockId body;
+    IRBlockId exit;
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &header));
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, header));
+    IRBuilder_SetBlock(builder, header);
+
+    if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON)) {
+        ParserCValue value;
+        CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_NONE, &value));
+        CHECK_PARSER_RESULT(ParserCLowerBranch(lowering, &value, &body, &exit));
+    }
+    else {
+        CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &body));
+        CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &exit));
+        CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_BR, IR_TYPE_VOID, body, 0, 0, NULL));
+    }
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, body));
+
+    // ===== STEP =====
+    uint32_t step = ASTParserTokenIndex(parser);
+    bool hasStep = !ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RPAREN);
+    CHECK_PARSER_RESULT(ParserCSkipStep(parser));
+
+    IRBlockId next;
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &next));
+
+    IRBuilder_SetBlock(builder, body);
+    CHECK_PARSER_RESULT(ParserCLowerNested(lowering, exit, next));
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, next));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, next));
+    IRBuilder_SetBlock(builder, next);
+
+    if (hasStep) {
+        uint32_t resume = ASTParserTokenIndex(parser);
+        ParserCValue value;
+
+        CHECK_PARSER_RESULT(LexerSeek(parser->lexer, step));
+        CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_NONE, &value));
+        CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+        CHECK_PARSER_RESULT(LexerSeek(parser->lexer, resume));
+    }
+
+    CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_BR, IR_TYPE_VOID, header, 0, 0, NULL));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, header));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, exit));
+    IRBuilder_SetBlock(builder, exit);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserCLowerFor(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    ASTScope scope;
+    CHECK_PARSER_RESULT(ASTSymbolTable_PushScope(parser->symbols, AST_SCOPE_KIND_BLOCK, &scope));
+
+    ParserResult result = ParserCLowerForClauses(lowering);
+
+    ASTSymbolTable_PopScope(parser->symbols, scope);
+
+    return result;
+}
+
+/**
+ * The controlling value is computed in the block before the switch, the
+ * body is lowered from a block nothing branches to. Case labels collect
+ * their (value, block) pairs on the case stack; the SWITCH goes to the end
+ * of the head block once they are all known.
+ */
+static ParserResult ParserCLowerSwitch(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+    IRBuilder builder = lowering->builder;
+
+    ParserCValue value;
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ParserCLowerParenthesized(lowering, &value));
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, &value));
+
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, value.type);
+    uint32_t basic = info->kind == AST_TYPE_KIND_ENUM ? C_BASIC_TYPE_INT :
+                     info->kind == AST_TYPE_KIND_BASIC ? info->value : C_BASIC_TYPE_NONE;
+    if (!ParserCIsIntegerType(basic))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    ASTTypeId type;
+    CHECK_PARSER_RESULT(ASTTypeTable_GetBasic(parser->types, ParserCPromote(basic), 0, &type));
+    CHECK_PARSER_RESULT(ParserCLowerConvert(lowering, &value, type));
+
+    IRBlockId head = IRBuilder_GetBlock(builder);
+    IRBlockId exit;
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &exit));
+
+    bool outerInSwitch = lowering->inSwitch;
+    ASTTypeId outerType = lowering->switchType;
+    IRBlockId outerDefault = lowering->defaultBlock;
+    uint32_t base = lowering->caseCount;
+
+    lowering->inSwitch = true;
+    lowering->switchType = type;
+    lowering->defaultBlock = IR_BLOCK_NONE;
+
+    IRBuilder_SetBlock(builder, IR_BLOCK_NONE);
+    ParserResult result = ParserCLowerNested(lowering, exit, lowering->continueBlock);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = ParserCLowerJump(lowering, exit);
+
+    IRBlockId defaultBlock = lowering->defaultBlock;
+    lowering->inSwitch = outerInSwitch;
+    lowering->switchType = outerType;
+    lowering->defaultBlock = outerDefault;
+    CHECK_PARSER_RESULT(result);
+
+    IRBuilder_SetBlock(builder, head);
+    CHECK_PARSER_RESULT(IRBuilder_EmitList(builder, IR_OP_SWITCH, IR_TYPE_VOID, value.value,
+        defaultBlock != IR_BLOCK_NONE ? defaultBlock : exit, lowering->cases ? &lowering->cases[base] : NULL,
+        lowering->caseCount - base, NULL));
+
+    for (uint32_t i = base; i < lowering->caseCount; i += 3)
+        CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, lowering->cases[i + 2]));
+    if (defaultBlock != IR_BLOCK_NONE)
+        CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, defaultBlock));
+
+    lowering->caseCount = base;
+
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, exit));
+    IRBuilder_SetBlock(builder, exit);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* `case constant-expression:` and `default:` start a block the switch and the code before fall into */
+static ParserResult ParserCLowerCaseLabel(ParserCLowering* lowering, uint32_t keyword)
+{
+    ASTParser parser = lowering->parser;
+
+    if (!lowering->inSwitch || (keyword == C_KEYWORD_DEFAULT && lowering->defaultBlock != IR_BLOCK_NONE))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    uint64_t value = 0;
+    if (keyword == C_KEYWORD_CASE) {
+        // The constant is parsed and folded as on the AST path, its nodes dropped
+        uint32_t nodes = ASTTree_GetNodeCount(parser->tree);
+        uint32_t symbols = ASTSymbolTable_GetSymbolCount(parser->symbols);
+
+        ASTNodeId node;
+        ParserCConstant constant;
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_CONDITIONAL, &node));
+        if (!ParserCGetConstant(parser, node, &constant))
+            return PARSER_ERROR_UNSUPPORTED;
+
+        value = ParserCConvert(constant.value, ASTTypeTable_Get(parser->types, lowering->switchType)->value);
+        ParserCLowerDropNodes(lowering, nodes, symbols);
+    }
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_COLON, PARSER_ERROR_UNEXPECTED_TOKEN));
+
+    IRBlockId block;
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(lowering->builder, &block));
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, block));
+    IRBuilder_SetBlock(lowering->builder, block);
+
+    if (keyword == C_KEYWORD_CASE)
+        CHECK_PARSER_RESULT(ParserCPushCase(lowering, value, block));
+    else
+        lowering->defaultBlock = block;
+
+    return ParserCLowerStatement(lowering);
+}
+
+/* Block of a label, declared by the first goto or by the label itself */
+static ParserResult ParserCLabelBlock(ParserCLowering* lowering, ParserIdentifierId name, ParserCLocal** local)
+{
+    ASTParser parser = lowering->parser;
+
+    ASTSymbolId label = ASTSymbolTable_Lookup(parser->symbols, AST_NAMESPACE_LABEL, name, 0);
+    if (label != AST_SYMBOL_ID_NONE) {
+        *local = ParserCGetLocal(lowering, label);
+        return *local && (*local)->kind == C_LOCAL_LABEL ? PARSER_RESULT_SUCCESS : PARSER_ERROR_UNSUPPORTED;
+    }
+
+    ParserResult result = ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_LABEL, name,
+        AST_SYMBOL_KIND_LABEL, 0, AST_NODE_ID_NONE, &label);
+    if (result != PARSER_RESULT_SUCCESS)
+        return result;
+
+    IRBlockId block;
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(lowering->builder, &block));
+    CHECK_PARSER_RESULT(ParserCAddLocal(lowering, label, local));
+
+    (*local)->kind = C_LOCAL_LABEL;
+    (*local)->block = block;
+
+    parser->pendingLabels++;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserCLowerGoto(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    LexerToken token = LexerPeekN(parser->lexer, 0);
+    if (!token || token->flags != TOKEN_TYPE_IDENTIFIER)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    ParserIdentifierId name;
+    ParserCLocal* local;
+    CHECK_PARSER_RESULT(ASTParserTokenName(parser, token, &name));
+    CHECK_PARSER_RESULT(ParserCLabelBlock(lowering, name, &local));
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, local->block));
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    return ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON);
+}
+
+/* `name: statement`, the label block is sealed when the body ends: a later goto may jump to it */
+static ParserResult ParserCLowerLabel(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+
+    ParserIdentifierId name;
+    ParserCLocal* local;
+    CHECK_PARSER_RESULT(ASTParserTokenName(parser, LexerPeekN(parser->lexer, 0), &name));
+    CHECK_PARSER_RESULT(ParserCLabelBlock(lowering, name, &local));
+
+    // Defined twice is an error the AST path reports
+    if (local->defined)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    local->defined = 1;
+    parser->pendingLabels--;
+
+    IRBlockId block = local->block;
+    CHECK_PARSER_RESULT(ParserCLowerJump(lowering, block));
+    IRBuilder_SetBlock(lowering->builder, block);
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    return ParserCLowerStatement(lowering);
+}
+
+static ParserResult ParserCLowerReturn(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+    IRBuilder builder = lowering->builder;
+    IRType type = IRFunction_GetReturnType(lowering->function);
+    IRValueId result = IR_VALUE_NONE;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON)) {
+        ParserCValue value;
+        CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_NONE, &value));
+
+        if (type != IR_TYPE_VOID) {
+            CHECK_PARSER_RESULT(ParserCLowerConvert(lowering, &value, lowering->returnType));
+            result = value.value;
+        }
+    }
+    else if (type != IR_TYPE_VOID) {
+        CHECK_PARSER_RESULT(IRFunction_GetUndef(lowering->function, type, &result));
+    }
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+
+    return IRBuilder_Emit(builder, IR_OP_RET, IR_TYPE_VOID, result, 0, 0, NULL);
+}
+
+/* break and continue, outside of a loop or switch the AST path reports them */
+static ParserResult ParserCLowerBreak(ParserCLowering* lowering, IRBlockId target)
+{
+    if (target == IR_BLOCK_NONE)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(lowering->parser));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(lowering->parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+
+    return IRBuilder_Emit(lowering->builder, IR_OP_BR, IR_TYPE_VOID, target, 0, 0, NULL);
+}
+
+static ParserResult ParserCLowerStatement(ParserCLowering* lowering)
+{
+    ASTParser parser = lowering->parser;
+    const struct LexerToken_T* token = ASTParserPeek(parser);
+
+    switch (token->flags) {
+    case TOKEN_TYPE_PUNCTUATION:
+        if (token->value == PUNCTUATION_LBRACE)
+            return ParserCLowerCompound(lowering, true);
+
+        // Null statement
+        if (token->value == PUNCTUATION_SEMICOLON)
+            return ASTParserAdvance(parser);
+        break;
+
+    case TOKEN_TYPE_KEYWORD:
+        switch (token->value) {
+        case C_KEYWORD_IF:
+            return ParserCLowerIf(lowering);
+
+        case C_KEYWORD_WHILE:
+            return ParserCLowerWhile(lowering);
+
+        case C_KEYWORD_DO:
+            return ParserCLowerDoWhile(lowering);
+
+        case C_KEYWORD_FOR:
+            return ParserCLowerFor(lowering);
+
+        case C_KEYWORD_SWITCH:
+            return ParserCLowerSwitch(lowering);
+
+        case C_KEYWORD_CASE:
+        case C_KEYWORD_DEFAULT:
+            return ParserCLowerCaseLabel(lowering, token->value);
+
+        case C_KEYWORD_BREAK:
+            return ParserCLowerBreak(lowering, lowering->breakBlock);
+
+        case C_KEYWORD_CONTINUE:
+            return ParserCLowerBreak(lowering, lowering->continueBlock);
+
+        case C_KEYWORD_RETURN:
+            return ParserCLowerReturn(lowering);
+
+        case C_KEYWORD_GOTO:
+            return ParserCLowerGoto(lowering);
+
+        default:
+            break;
+        }
+        break;
+
+    case TOKEN_TYPE_IDENTIFIER:
+        if (ASTParserIsPunctuation(ASTParserPeekN(parser, 1), PUNCTUATION_COLON))
+            return ParserCLowerLabel(lowering);
+        break;
+
+    default:
+        break;
+    }
+
+    // ===== EXPRESSION =====
+    // The value is discarded, a volatile object is still read
+    ParserCValue value;
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_NONE, &value));
+    if (value.kind == C_VALUE_MEMORY && ParserCIsVolatile(parser, value.type))
+        CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, &value));
+
+    return ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON);
+}
+
+/**
+ * Parameters are declared in the function scope as on the AST path. Each
+ * gets its PARAM in the entry block, a stack slot when it lives in memory.
+ */
+static ParserResult ParserCLowerParams(ParserCLowering* lowering, ASTNodeId function)
+{
+    ASTParser parser = lowering->parser;
+    ASTNodeId params = ASTTree_GetChild(parser->tree, function, 0);
+    uint32_t count = IRFunction_GetParamCount(lowering->function);
+
+    for (uint32_t i = 0; i < count; i++) {
+        ASTNodeId param = ASTTree_GetChild(parser->tree, params, i);
+        ASTNodeData data = ASTTree_GetData(parser->tree, param);
+
+        IRValueId value;
+        CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_PARAM, IRFunction_GetParamType(lowering->function, i),
+            i, 0, 0, &value));
+
+        const ASTSymbolInfo* declared = ASTSymbolTable_GetSymbol(parser->symbols, data.rhs);
+        if (!declared)
+            continue;
+
+        ParserIdentifierId name = declared->name;
+        ASTTypeId type = declared->type;
+
+        // Memory reached through a restrict pointer is reached through nothing else in the body
+        const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+        if (info && (info->qualifiers & C_TYPE_QUAL_RESTRICT))
+            IRFunction_SetInstructionFlags(lowering->function, value, IR_INSTRUCTION_FLAG_NOALIAS);
+
+        CHECK_PARSER_RESULT(ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_ORDINARY, name,
+            AST_SYMBOL_KIND_PARAMETER, 0, param, &data.rhs));
+        ASTSymbolTable_SetType(parser->symbols, data.rhs, type);
+        CHECK_PARSER_RESULT(ASTTree_SetData(parser->tree, param, data));
+
+        CHECK_PARSER_RESULT(ParserCDeclareLocal(lowering, data.rhs));
+
+        const ParserCLocal* local = ParserCGetLocal(lowering, data.rhs);
+        if (local->kind == C_LOCAL_SSA) {
+            CHECK_PARSER_RESULT(IRBuilder_WriteVariable(lowering->builder, data.rhs, value));
+            continue;
+        }
+
+        IRValueId store;
+        CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_STORE, IR_TYPE_VOID, local->address, value, 0, &store));
+        if (ParserCIsVolatile(parser, type))
+            IRFunction_SetInstructionFlags(lowering->function, store, IR_INSTRUCTION_FLAG_VOLATILE);
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Function definition in the module, with the IR types of its signature */
+static ParserResult ParserCCreateFunction(ParserCLowering* lowering, ASTNodeId function)
+{
+    ASTParser parser = lowering->parser;
+    ASTNodeData data = ASTTree_GetData(parser->tree, function);
+    const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(parser->symbols, data.rhs);
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, symbol->type);
+
+    // Variadic definitions need va_list, unprototyped ones have no parameter types
+    if (info->flags & AST_TYPE_FLAG_VARIADIC)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    uint32_t count = info->count;
+    ASTNodeId params = ASTTree_GetChild(parser->tree, function, 0);
+    if (count != ASTTree_GetChildCount(parser->tree, params) || count > 255)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    uint8_t types[255];
+    const ASTTypeId* paramTypes = ASTTypeTable_GetParams(parser->types, symbol->type);
+    for (uint32_t i = 0; i < count; i++) {
+        types[i] = (uint8_t)ParserCGetIRType(parser, paramTypes[i]);
+        if (types[i] == IR_TYPE_VOID)
+            return PARSER_ERROR_UNSUPPORTED;
+    }
+
+    lowering->returnType = ASTTypeTable_GetUnqualified(parser->types, info->base);
+    const ASTTypeInfo* returnInfo = ASTTypeTable_Get(parser->types, lowering->returnType);
+    IRType returnType = ParserCGetIRType(parser, lowering->returnType);
+    if (returnType == IR_TYPE_VOID && !(returnInfo->kind == AST_TYPE_KIND_BASIC && returnInfo->value == C_BASIC_TYPE_VOID))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    const ParserIdentifier* name = ParserInterner_Get(parser->interner, symbol->name);
+    if (!name)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    IRModule module = parser->module;
+    IRGlobalId global;
+    CHECK_PARSER_RESULT(IRModule_DeclareGlobal(module, name->text, name->length, IR_GLOBAL_KIND_FUNCTION, &global));
+    CHECK_PARSER_RESULT(IRModule_CreateFunction(module, global, returnType, types, count, &lowering->function));
+
+    uint32_t storage = AST_DECL_SUBTYPE_STORAGE(ASTTree_GetSubtype(parser->tree, function));
+    if (C_DECL_STORAGE_CLASS(storage) == C_STORAGE_CLASS_STATIC)
+        IRModule_SetGlobalFlags(module, global, IR_GLOBAL_FLAG_INTERNAL);
+    if (C_DECL_FUNC_SPECS(storage) & C_FUNC_SPEC_INLINE)
+        IRModule_SetGlobalFlags(module, global, IR_GLOBAL_FLAG_INLINE);
+
+    lowering->isMain = name->length == 4 && memcmp(name->text, "main", 4) == 0;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserCLowerBody(ParserCLowering* lowering, ASTNodeId function)
+{
+    ASTParser parser = lowering->parser;
+    IRBuilder builder;
+
+    CHECK_PARSER_RESULT(ParserCCreateFunction(lowering, function));
+    CHECK_PARSER_RESULT(ParserCScanAddressTaken(lowering));
+    CHECK_PARSER_RESULT(CreateIRBuilder(lowering->function, &builder));
+    lowering->builder = builder;
+    lowering->firstSymbol = ASTSymbolTable_GetSymbolCount(parser->symbols) + 1;
+
+    // The entry block only holds parameters and stack slots
+    IRBlockId body;
+    CHECK_PARSER_RESULT(ParserCLowerParams(lowering, function));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &body));
+    CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_BR, IR_TYPE_VOID, body, 0, 0, &lowering->entryBranch));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, body));
+    IRBuilder_SetBlock(builder, body);
+
+    parser->pendingLabels = 0;
+    CHECK_PARSER_RESULT(ParserCLowerCompound(lowering, false));
+
+    // A goto to a label the body never defines
+    if (parser->pendingLabels)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    for (uint32_t i = 0; i < lowering->localCapacity; i++) {
+        if (lowering->locals[i].kind == C_LOCAL_LABEL)
+            CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, lowering->locals[i].block));
+    }
+
+    // Falling off the end returns an undefined value, 0 from main
+    if (IRBuilder_GetBlock(builder) != IR_BLOCK_NONE) {
+        IRType type = IRFunction_GetReturnType(lowering->function);
+        IRValueId value = IR_VALUE_NONE;
+
+        if (type != IR_TYPE_VOID && lowering->isMain)
+            CHECK_PARSER_RESULT(IRBuilder_GetConstant(builder, type, 0, &value));
+        else if (type != IR_TYPE_VOID)
+            CHECK_PARSER_RESULT(IRFunction_GetUndef(lowering->function, type, &value));
+
+        CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_RET, IR_TYPE_VOID, value, 0, 0, NULL));
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerFunctionBody(
+    ASTParser parser,
+    ASTNode function,
+    IRFunction* ir)
+{
+    if (!parser || !function || !ir || !parser->module)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ParserCLowering lowering = {
+        .parser = parser,
+        .switchType = AST_TYPE_ID_NONE,
+    };
+
+    // Parameters and the outermost block share the function scope
+    ASTScope scope;
+    CHECK_PARSER_RESULT(ASTSymbolTable_PushScope(parser->symbols, AST_SCOPE_KIND_FUNCTION, &scope));
+
+    ParserResult result = ParserCLowerBody(&lowering, AST_NODE_TO_ID(function));
+
+    ASTSymbolTable_PopScope(parser->symbols, scope);
+
+    if (lowering.builder)
+        IRBuilderDestroy(lowering.builder);
+    PARSER_FREE(lowering.locals);
+    PARSER_FREE(lowering.addressTaken);
+    PARSER_FREE(lowering.cases);
+
+    // With the builder gone the blocks can become id ranges
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRFunction_Compact(lowering.function);
+
+    // Whatever stopped the lowering, the AST path parses the body again
+    // and reports the errors in it
+    if (result != PARSER_RESULT_SUCCESS) {
+        if (lowering.function)
+            IRModule_RemoveFunction(parser->module, lowering.function);
+        return result == PARSER_ERROR_NO_MEMORY ? result : PARSER_ERROR_UNSUPPORTED;
+    }
+
+    *ir = lowering.function;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,1229 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+enum {
+    C_OPERANDS_SIGNED = 0,
+    C_OPERANDS_UNSIGNED,
+    C_OPERANDS_FLOATING,
+};
+
+/* IROpcode of a binary operator by operand class, IR_OP_NOP where the operator does not apply */
+static const uint8_t s_ParserCBinaryOpcodes[C_BINARY_OP_GREATER_EQUAL + 1][3] = {
+    [C_BINARY_OP_ADD]           = { IR_OP_ADD, IR_OP_ADD, IR_OP_FADD },
+    [C_BINARY_OP_SUBTRACT]      = { IR_OP_SUB, IR_OP_SUB, IR_OP_FSUB },
+    [C_BINARY_OP_MULTIPLY]      = { IR_OP_MUL, IR_OP_MUL, IR_OP_FMUL },
+    [C_BINARY_OP_DIVIDE]        = { IR_OP_SDIV, IR_OP_UDIV, IR_OP_FDIV },
+    [C_BINARY_OP_MODULO]        = { IR_OP_SREM, IR_OP_UREM, IR_OP_NOP },
+    [C_BINARY_OP_BITWISE_AND]   = { IR_OP_AND, IR_OP_AND, IR_OP_NOP },
+    [C_BINARY_OP_BITWISE_OR]    = { IR_OP_OR, IR_OP_OR, IR_OP_NOP },
+    [C_BINARY_OP_BITWISE_XOR]   = { IR_OP_XOR, IR_OP_XOR, IR_OP_NOP },
+    [C_BINARY_OP_SHIFT_LEFT]    = { IR_OP_SHL, IR_OP_SHL, IR_OP_NOP },
+    [C_BINARY_OP_SHIFT_RIGHT]   = { IR_OP_ASHR, IR_OP_LSHR, IR_OP_NOP },
+    [C_BINARY_OP_EQUAL]         = { IR_OP_EQ, IR_OP_EQ, IR_OP_FEQ },
+    [C_BINARY_OP_NOT_EQUAL]     = { IR_OP_NE, IR_OP_NE, IR_OP_FNE },
+    [C_BINARY_OP_LESS]          = { IR_OP_SLT, IR_OP_ULT, IR_OP_FLT },
+    [C_BINARY_OP_GREATER]       = { IR_OP_SGT, IR_OP_UGT, IR_OP_FGT },
+    [C_BINARY_OP_LESS_EQUAL]    = { IR_OP_SLE, IR_OP_ULE, IR_OP_FLE },
+    [C_BINARY_OP_GREATER_EQUAL] = { IR_OP_SGE, IR_OP_UGE, IR_OP_FGE },
+};
+
+static inline bool ParserCIsComparison(uint32_t op)
+{
+    return op >= C_BINARY_OP_EQUAL && op <= C_BINARY_OP_GREATER_EQUAL;
+}
+
+static inline bool ParserCIsFloating(uint32_t basic)
+{
+    return basic == C_BASIC_TYPE_FLOAT || basic == C_BASIC_TYPE_DOUBLE;
+}
+
+static inline ASTTypeKind ParserCTypeKind(ASTParser parser, ASTTypeId type)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+    return info ? (ASTTypeKind)info->kind : AST_TYPE_KIND_NONE;
+}
+
+/* Basic type of an arithmetic type the lowering handles, enums are int; C_BASIC_TYPE_NONE otherwise */
+static uint32_t ParserCArithmeticType(ASTParser parser, ASTTypeId type)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+    if (!info)
+        return C_BASIC_TYPE_NONE;
+
+    if (info->kind == AST_TYPE_KIND_ENUM)
+        return C_BASIC_TYPE_INT;
+
+    if (info->kind == AST_TYPE_KIND_BASIC && info->value >= C_BASIC_TYPE_BOOL && info->value <= C_BASIC_TYPE_DOUBLE)
+        return info->value;
+
+    return C_BASIC_TYPE_NONE;
+}
+
+/* Usual arithmetic conversions (C11 6.3.1.8) without long double and complex types */
+static uint32_t ParserCArithmeticCommon(uint32_t a, uint32_t b)
+{
+    if (a == C_BASIC_TYPE_NONE || b == C_BASIC_TYPE_NONE)
+        return C_BASIC_TYPE_NONE;
+
+    if (a == C_BASIC_TYPE_DOUBLE || b == C_BASIC_TYPE_DOUBLE)
+        return C_BASIC_TYPE_DOUBLE;
+    if (a == C_BASIC_TYPE_FLOAT || b == C_BASIC_TYPE_FLOAT)
+        return C_BASIC_TYPE_FLOAT;
+
+    return ParserCCommonType(ParserCPromote(a), ParserCPromote(b));
+}
+
+static ParserResult ParserCLowerConstant(ParserCLowering* lowering, uint32_t basic, uint64_t bits, ParserCValue* value)
+{
+    CHECK_PARSER_RESULT(ASTTypeTable_GetBasic(lowering->parser->types, basic, 0, &value->type));
+    value->kind = C_VALUE_RVALUE;
+
+    return IRBuilder_GetConstant(lowering->builder, ParserCGetIRType(lowering->parser, value->type), bits, &value->value);
+}
+
+static ParserResult ParserCConvertBasic(ParserCLowering* lowering, ParserCValue* value, uint32_t basic)
+{
+    ASTTypeId type;
+    CHECK_PARSER_RESULT(ASTTypeTable_GetBasic(lowering->parser->types, basic, 0, &type));
+    return ParserCLowerConvert(lowering, value, type);
+}
+
+/* Apply the integer promotions to an rvalue, leave other types alone */
+static ParserResult ParserCPromoteValue(ParserCLowering* lowering, ParserCValue* value)
+{
+    uint32_t basic = ParserCArithmeticType(lowering->parser, value->type);
+    if (!ParserCIsIntegerType(basic))
+        return PARSER_RESULT_SUCCESS;
+
+    return ParserCConvertBasic(lowering, value, ParserCPromote(basic));
+}
+
+/* Pointer moved by `index` elements, backwards for `negate` */
+static ParserResult ParserCLowerPointerOffset(ParserCLowering* lowering, const ParserCValue* pointer,
+    ParserCValue* index, bool negate, ParserCValue* result)
+{
+    ASTParser parser = lowering->parser;
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, pointer->type);
+
+    uint64_t size;
+    uint32_t alignment;
+    if (!ParserCIsIntegerType(ParserCArithmeticType(parser, index->type)) ||
+        !ParserCGetLayout(parser, info->base, &size, &alignment))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    CHECK_PARSER_RESULT(ParserCConvertBasic(lowering, index, C_PTRDIFF_TYPE));
+
+    IRValueId offset = index->value;
+    if (size != 1) {
+        IRValueId scale;
+        CHECK_PARSER_RESULT(IRBuilder_GetConstant(lowering->builder, IR_TYPE_I64, size, &scale));
+        CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_MUL, IR_TYPE_I64, offset, scale, 0, &offset));
+    }
+    if (negate)
+        CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_NEG, IR_TYPE_I64, offset, 0, 0, &offset));
+
+    result->kind = C_VALUE_RVALUE;
+    result->type = pointer->type;
+
+    return IRBuilder_Emit(lowering->builder, IR_OP_PTRADD, IR_TYPE_PTR, pointer->value, offset, 0, &result->value);
+}
+
+/* Number of elements between two pointers, as ptrdiff_t */
+static ParserResult ParserCLowerPointerDifference(ParserCLowering* lowering, const ParserCValue* left,
+    const ParserCValue* right, ParserCValue* result)
+{
+    ASTParser parser = lowering->parser;
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, left->type);
+
+    uint64_t size;
+    uint32_t alignment;
+    if (ParserCTypeKind(parser, right->type) != AST_TYPE_KIND_POINTER ||
+        !ParserCGetLayout(parser, info->base, &size, &alignment) || size == 0)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    IRValueId a;
+    IRValueId b;
+    IRValueId difference;
+    CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_PTRTOINT, IR_TYPE_I64, left->value, 0, 0, &a));
+    CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_PTRTOINT, IR_TYPE_I64, right->value, 0, 0, &b));
+    CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_SUB, IR_TYPE_I64, a, b, 0, &difference));
+
+    if (size != 1) {
+        IRValueId scale;
+        CHECK_PARSER_RESULT(IRBuilder_GetConstant(lowering->builder, IR_TYPE_I64, size, &scale));
+        CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_SDIV, IR_TYPE_I64, difference, scale, 0, &difference));
+    }
+
+    result->kind = C_VALUE_RVALUE;
+    result->value = difference;
+
+    return ASTTypeTable_GetBasic(parser->types, C_PTRDIFF_TYPE, 0, &result->type);
+}
+
+/* Pointer comparison, a null pointer constant on either side is converted */
+static ParserResult ParserCLowerPointerComparison(ParserCLowering* lowering, uint32_t op, ParserCValue* left,
+    ParserCValue* right, ParserCValue* result)
+{
+    if (ParserCTypeKind(lowering->parser, left->type) != AST_TYPE_KIND_POINTER)
+        CHECK_PARSER_RESULT(ParserCLowerConvert(lowering, left, right->type));
+    if (ParserCTypeKind(lowering->parser, right->type) != AST_TYPE_KIND_POINTER)
+        CHECK_PARSER_RESULT(ParserCLowerConvert(lowering, right, left->type));
+
+    result->kind = C_VALUE_CONDITION;
+    CHECK_PARSER_RESULT(ASTTypeTable_GetBasic(lowering->parser->types, C_BASIC_TYPE_INT, 0, &result->type));
+
+    // Addresses compare unsigned
+    return IRBuilder_Emit(lowering->builder, (IROpcode)s_ParserCBinaryOpcodes[op][C_OPERANDS_UNSIGNED], IR_TYPE_I1,
+        left->value, right->value, 0, &result->value);
+}
+
+/* Binary operator on two rvalues, the operands are converted in place */
+static ParserResult ParserCLowerArithmetic(ParserCLowering* lowering, uint32_t op, ParserCValue* left,
+    ParserCValue* right, ParserCValue* result)
+{
+    ASTParser parser = lowering->parser;
+    bool leftPointer = ParserCTypeKind(parser, left->type) == AST_TYPE_KIND_POINTER;
+    bool rightPointer = ParserCTypeKind(parser, right->type) == AST_TYPE_KIND_POINTER;
+
+    if (leftPointer || rightPointer) {
+        if (ParserCIsComparison(op))
+            return ParserCLowerPointerComparison(lowering, op, left, right, result);
+        if (op == C_BINARY_OP_SUBTRACT && leftPointer && rightPointer)
+            return ParserCLowerPointerDifference(lowering, left, right, result);
+        if (op == C_BINARY_OP_ADD && rightPointer && !leftPointer)
+            return ParserCLowerPointerOffset(lowering, right, left, false, result);
+        if ((op == C_BINARY_OP_ADD || op == C_BINARY_OP_SUBTRACT) && !rightPointer)
+            return ParserCLowerPointerOffset(lowering, left, right, op == C_BINARY_OP_SUBTRACT, result);
+
+        return PARSER_ERROR_UNSUPPORTED;
+    }
+
+    uint32_t leftType = ParserCArithmeticType(parser, left->type);
+    uint32_t rightType = ParserCArithmeticType(parser, right->type);
+    uint32_t type;
+
+    if (op == C_BINARY_OP_SHIFT_LEFT || op == C_BINARY_OP_SHIFT_RIGHT) {
+        // The result has the promoted left type, the count is converted to it
+        if (!ParserCIsIntegerType(leftType) || !ParserCIsIntegerType(rightType))
+            return PARSER_ERROR_UNSUPPORTED;
+        type = ParserCPromote(leftType);
+    }
+    else {
+        type = ParserCArithmeticCommon(leftType, rightType);
+        if (type == C_BASIC_TYPE_NONE)
+            return PARSER_ERROR_UNSUPPORTED;
+    }
+
+    uint32_t operands = ParserCIsFloating(type) ? C_OPERANDS_FLOATING :
+                        ParserCIsSignedType(type) ? C_OPERANDS_SIGNED : C_OPERANDS_UNSIGNED;
+    IROpcode opcode = (IROpcode)s_ParserCBinaryOpcodes[op][operands];
+    if (opcode == IR_OP_NOP)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    CHECK_PARSER_RESULT(ParserCConvertBasic(lowering, left, type));
+    CHECK_PARSER_RESULT(ParserCConvertBasic(lowering, right, type));
+
+    if (ParserCIsComparison(op)) {
+        result->kind = C_VALUE_CONDITION;
+        CHECK_PARSER_RESULT(ASTTypeTable_GetBasic(parser->types, C_BASIC_TYPE_INT, 0, &result->type));
+        return IRBuilder_Emit(lowering->builder, opcode, IR_TYPE_I1, left->value, right->value, 0, &result->value);
+    }
+
+    result->kind = C_VALUE_RVALUE;
+    result->type = left->type;
+
+    return IRBuilder_Emit(lowering->builder, opcode, ParserCGetIRType(parser, result->type),
+        left->value, right->value, 0, &result->value);
+}
+
+/* ++ and --, the value before or after the update */
+static ParserResult ParserCLowerIncrement(ParserCLowering* lowering, ParserCValue* lvalue, bool increment,
+    bool prefix, ParserCValue* result)
+{
+    if (lvalue->kind != C_VALUE_VARIABLE && lvalue->kind != C_VALUE_MEMORY)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    ParserCValue old = *lvalue;
+    ParserCValue one;
+    ParserCValue updated;
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, &old));
+    CHECK_PARSER_RESULT(ParserCLowerConstant(lowering, C_BASIC_TYPE_INT, 1, &one));
+
+    ParserCValue left = old;
+    CHECK_PARSER_RESULT(ParserCLowerArithmetic(lowering, increment ? C_BINARY_OP_ADD : C_BINARY_OP_SUBTRACT,
+        &left, &one, &updated));
+    CHECK_PARSER_RESULT(ParserCLowerStore(lowering, lvalue, &updated));
+
+    *result = prefix ? updated : old;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Reference to a name with linkage, the module has one global per name */
+static ParserResult ParserCLowerGlobal(ParserCLowering* lowering, const ASTSymbolInfo* symbol, ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+    const ParserIdentifier* name = ParserInterner_Get(parser->interner, symbol->name);
+    if (!name)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    IRGlobalKind kind = ParserCTypeKind(parser, symbol->type) == AST_TYPE_KIND_FUNCTION ?
+        IR_GLOBAL_KIND_FUNCTION : IR_GLOBAL_KIND_DATA;
+
+    IRGlobalId global;
+    ParserResult result = IRModule_DeclareGlobal(IRFunction_GetModule(lowering->function), name->text, name->length,
+        kind, &global);
+    if (result == PARSER_ERROR_INVALID_ARG)
+        return PARSER_ERROR_UNSUPPORTED;
+    CHECK_PARSER_RESULT(result);
+
+    value->kind = C_VALUE_MEMORY;
+    value->type = symbol->type;
+
+    return IRBuilder_Emit(lowering->builder, IR_OP_GLOBAL, IR_TYPE_PTR, global, 0, 0, &value->value);
+}
+
+static ParserResult ParserCLowerName(ParserCLowering* lowering, ASTSymbolId id, ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+    const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(parser->symbols, id);
+    if (!symbol)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    switch (symbol->kind) {
+    case AST_SYMBOL_KIND_ENUM_CONSTANT: {
+        ParserCConstant constant;
+        ASTNodeId node = symbol->node != AST_NODE_ID_NONE ? ASTTree_GetData(parser->tree, symbol->node).lhs : AST_NODE_ID_NONE;
+        if (node == AST_NODE_ID_NONE || !ParserCGetConstant(parser, node, &constant))
+            return PARSER_ERROR_UNSUPPORTED;
+
+        uint32_t basic = ParserCArithmeticType(parser, symbol->type);
+        if (!ParserCIsIntegerType(basic))
+            basic = C_BASIC_TYPE_INT;
+
+        return ParserCLowerConstant(lowering, basic, ParserCConvert(constant.value, basic), value);
+    }
+
+    case AST_SYMBOL_KIND_VARIABLE:
+    case AST_SYMBOL_KIND_PARAMETER: {
+        const ParserCLocal* local = ParserCGetLocal(lowering, id);
+        value->type = symbol->type;
+
+        if (local && local->kind == C_LOCAL_SSA) {
+            value->kind = C_VALUE_VARIABLE;
+            value->value = id;
+            return PARSER_RESULT_SUCCESS;
+        }
+
+        if (local && local->kind == C_LOCAL_MEMORY) {
+            value->kind = C_VALUE_MEMORY;
+            value->value = local->address;
+            return PARSER_RESULT_SUCCESS;
+        }
+
+        if (symbol->kind == AST_SYMBOL_KIND_PARAMETER)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        return ParserCLowerGlobal(lowering, symbol, value);
+    }
+
+    case AST_SYMBOL_KIND_FUNCTION:
+        return ParserCLowerGlobal(lowering, symbol, value);
+
+    default:
+        return PARSER_ERROR_UNSUPPORTED;
+    }
+}
+
+/* Narrow string literal as anonymous read-only data, an lvalue of type char[N] */
+static ParserResult ParserCLowerString(ParserCLowering* lowering, ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+
+    // Decoded literals live as long as the rest of the translation unit
+    LexerStringBytes bytes;
+    CHECK_PARSER_RESULT(LexerCDecodeStringAt(parser->lexer, ASTParserTokenIndex(parser), parser->arena, &bytes));
+    if (bytes.unitSize != 1 || bytes.length >= UINT32_MAX)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    for (uint32_t i = 0; i < bytes.tokenCount; i++)
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    uint32_t size = (uint32_t)bytes.length + 1u;
+    uint8_t* data = ASTParserAlloc(parser, size);
+    if (!data)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memcpy(data, bytes.data, bytes.length);
+    data[bytes.length] = 0;
+
+    IRGlobalId global;
+    CHECK_PARSER_RESULT(IRModule_DefineData(IRFunction_GetModule(lowering->function), IR_GLOBAL_NONE, data, size, 1,
+        IR_GLOBAL_FLAG_INTERNAL | IR_GLOBAL_FLAG_CONSTANT, &global));
+
+    ASTTypeId element;
+    CHECK_PARSER_RESULT(ASTTypeTable_GetBasic(parser->types, C_BASIC_TYPE_CHAR, 0, &element));
+    CHECK_PARSER_RESULT(ASTTypeTable_GetArray(parser->types, element, C_ARRAY_SIZE_FIXED, size, AST_TYPE_FLAG_SIZED,
+        &value->type));
+
+    value->kind = C_VALUE_MEMORY;
+
+    return IRBuilder_Emit(lowering->builder, IR_OP_GLOBAL, IR_TYPE_PTR, global, 0, 0, &value->value);
+}
+
+static ParserResult ParserCLowerLiteral(ParserCLowering* lowering, ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+    const struct LexerToken_T* token = ASTParserPeek(parser);
+
+    switch (token->kind) {
+    case LITERAL_TYPE_INTEGER: {
+        const LexerLiteral* literal = ASTParserGetLiteral(parser, token->value);
+        uint32_t type = ParserCLiteralType(literal);
+
+        CHECK_PARSER_RESULT(ParserCLowerConstant(lowering, type, ParserCConvert(literal->value.integer, type), value));
+        return ASTParserAdvance(parser);
+    }
+
+    case LITERAL_TYPE_FLOAT: {
+        const LexerLiteral* literal = ASTParserGetLiteral(parser, token->value);
+        uint64_t bits = 0;
+
+        if (literal->suffix & LITERAL_SUFFIX_LONG)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        if (literal->suffix & LITERAL_SUFFIX_FLOAT) {
+            float single = (float)literal->value.floating;
+            uint32_t word;
+            memcpy(&word, &single, sizeof(word));
+            bits = word;
+        }
+        else {
+            memcpy(&bits, &literal->value.floating, sizeof(bits));
+        }
+
+        CHECK_PARSER_RESULT(ParserCLowerConstant(lowering,
+            (literal->suffix & LITERAL_SUFFIX_FLOAT) ? C_BASIC_TYPE_FLOAT : C_BASIC_TYPE_DOUBLE, bits, value));
+        return ASTParserAdvance(parser);
+    }
+
+    case LITERAL_TYPE_CHAR: {
+        uint64_t character;
+        if (!ParserCCharValue(token, &character))
+            return PARSER_ERROR_UNSUPPORTED;
+
+        CHECK_PARSER_RESULT(ParserCLowerConstant(lowering, C_BASIC_TYPE_INT, character, value));
+        return ASTParserAdvance(parser);
+    }
+
+    case LITERAL_TYPE_STRING:
+        return ParserCLowerString(lowering, value);
+
+    default:
+        return PARSER_ERROR_UNSUPPORTED;
+    }
+}
+
+/* Type name of a cast or sizeof, its nodes are dropped once read */
+static ParserResult ParserCLowerTypeName(ParserCLowering* lowering, ASTTypeId* type)
+{
+    ASTParser parser = lowering->parser;
+    uint32_t nodes = ASTTree_GetNodeCount(parser->tree);
+    uint32_t symbols = ASTSymbolTable_GetSymbolCount(parser->symbols);
+
+    ASTNodeId node;
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ParserCParseTypeName(parser, &node));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+
+    *type = ASTTree_GetData(parser->tree, node).lhs;
+    ParserCLowerDropNodes(lowering, nodes, symbols);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserCLowerPrimary(ParserCLowering* lowering, ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+    const struct LexerToken_T* token = ASTParserPeek(parser);
+
+    switch (token->flags) {
+    case TOKEN_TYPE_IDENTIFIER: {
+        ParserIdentifierId name;
+        CHECK_PARSER_RESULT(ASTParserTokenName(parser, LexerPeekN(parser->lexer, 0), &name));
+
+        ASTSymbolId symbol = ASTSymbolTable_Lookup(parser->symbols, AST_NAMESPACE_ORDINARY, name, 0);
+
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        return ParserCLowerName(lowering, symbol, value);
+    }
+
+    case TOKEN_TYPE_LITERAL:
+        return ParserCLowerLiteral(lowering, value);
+
+    case TOKEN_TYPE_PUNCTUATION:
+        if (token->value != PUNCTUATION_LPAREN)
+            break;
+
+        if (ParserCIsTypeNameAt(parser, 1)) {
+            // ===== CAST =====
+            ASTTypeId type;
+            CHECK_PARSER_RESULT(ParserCLowerTypeName(lowering, &type));
+            CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_UNARY, value));
+
+            if (ParserCTypeKind(parser, type) == AST_TYPE_KIND_BASIC &&
+                ASTTypeTable_Get(parser->types, type)->value == C_BASIC_TYPE_VOID) {
+                value->kind = C_VALUE_RVALUE;
+                value->value = IR_VALUE_NONE;
+                value->type = type;
+                return PARSER_RESULT_SUCCESS;
+            }
+
+            CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, value));
+            return ParserCLowerConvert(lowering, value, type);
+        }
+
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_NONE, value));
+        return ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS);
+
+    default:
+        break;
+    }
+
+    return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+}
+
+/* Operand of sizeof: lowered into a block nothing reaches, only its type is kept */
+static ParserResult ParserCLowerUnevaluated(ParserCLowering* lowering, ParserCValue* value)
+{
+    IRBlockId current = IRBuilder_GetBlock(lowering->builder);
+    IRBlockId unreachable;
+
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(lowering->builder, &unreachable));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(lowering->builder, unreachable));
+    IRBuilder_SetBlock(lowering->builder, unreachable);
+
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_UNARY, value));
+    CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_UNREACHABLE, IR_TYPE_VOID, 0, 0, 0, NULL));
+
+    IRBuilder_SetBlock(lowering->builder, current);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserCLowerUnary(ParserCLowering* lowering, ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+    const struct LexerToken_T* token = ASTParserPeek(parser);
+
+    if (ASTParserIsKeyword(token, C_KEYWORD_SIZEOF)) {
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+        ASTTypeId type;
+        if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_LPAREN) && ParserCIsTypeNameAt(parser, 1)) {
+            CHECK_PARSER_RESULT(ParserCLowerTypeName(lowering, &type));
+        }
+        else {
+            ParserCValue operand;
+            CHECK_PARSER_RESULT(ParserCLowerUnevaluated(lowering, &operand));
+            type = operand.type;
+        }
+
+        uint64_t size;
+        uint32_t alignment;
+        if (!ParserCGetLayout(parser, type, &size, &alignment) || size == 0)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        return ParserCLowerConstant(lowering, C_SIZE_TYPE, size, value);
+    }
+
+    uint32_t op = ParserCGetPrefixOperator(token);
+    if (op == C_UNARY_OP_NONE)
+        return ParserCLowerPrimary(lowering, value);
+
+    // The operand takes postfix operators, which bind tighter
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_UNARY, value));
+
+    switch (op) {
+    case C_UNARY_OP_PRE_INCREMENT:
+    case C_UNARY_OP_PRE_DECREMENT:
+        return ParserCLowerIncrement(lowering, value, op == C_UNARY_OP_PRE_INCREMENT, true, value);
+
+    case C_UNARY_OP_ADDRESS_OF: {
+        // Locals whose address is taken were given a stack slot up front
+        if (value->kind != C_VALUE_MEMORY)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        value->kind = C_VALUE_RVALUE;
+        return ASTTypeTable_GetPointer(parser->types, value->type, 0, &value->type);
+    }
+
+    case C_UNARY_OP_DEREFERENCE: {
+        CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, value));
+        if (ParserCTypeKind(parser, value->type) != AST_TYPE_KIND_POINTER)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        value->kind = C_VALUE_MEMORY;
+        value->type = ASTTypeTable_Get(parser->types, value->type)->base;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    case C_UNARY_OP_LOGICAL_NOT: {
+        IRValueId condition;
+        IRValueId one;
+        CHECK_PARSER_RESULT(ParserCLowerCondition(lowering, value, &condition));
+        CHECK_PARSER_RESULT(IRBuilder_GetConstant(lowering->builder, IR_TYPE_I1, 1, &one));
+
+        value->kind = C_VALUE_CONDITION;
+        CHECK_PARSER_RESULT(ASTTypeTable_GetBasic(parser->types, C_BASIC_TYPE_INT, 0, &value->type));
+        return IRBuilder_Emit(lowering->builder, IR_OP_XOR, IR_TYPE_I1, condition, one, 0, &value->value);
+    }
+
+    default:
+        break;
+    }
+
+    // + - ~ on promoted arithmetic operands
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, value));
+
+    uint32_t basic = ParserCArithmeticType(parser, value->type);
+    if (basic == C_BASIC_TYPE_NONE || (op == C_UNARY_OP_BITWISE_NOT && !ParserCIsIntegerType(basic)))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    CHECK_PARSER_RESULT(ParserCPromoteValue(lowering, value));
+    if (op == C_UNARY_OP_PLUS)
+        return PARSER_RESULT_SUCCESS;
+
+    IROpcode opcode = op == C_UNARY_OP_BITWISE_NOT ? IR_OP_NOT : ParserCIsFloating(basic) ? IR_OP_FNEG : IR_OP_NEG;
+
+    return IRBuilder_Emit(lowering->builder, opcode, ParserCGetIRType(parser, value->type), value->value, 0, 0,
+        &value->value);
+}
+
+/* `a ? b : c`, the condition is lowered; each arm gets a block and the value a phi */
+static ParserResult ParserCLowerConditional(ParserCLowering* lowering, ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+    IRBuilder builder = lowering->builder;
+
+    IRValueId condition;
+    IRBlockId arms[2];
+    IRBlockId join;
+    CHECK_PARSER_RESULT(ParserCLowerCondition(lowering, value, &condition));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &arms[0]));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &arms[1]));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &join));
+    CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_CONDBR, IR_TYPE_VOID, condition, arms[0], arms[1], NULL));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, arms[0]));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, arms[1]));
+
+    // Both arms are lowered before either is converted, the result type
+    // needs both; the arms stay open until then
+    ParserCValue values[2];
+    IRBlockId ends[2];
+
+    IRBuilder_SetBlock(builder, arms[0]);
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_COMMA, &values[0]));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_COLON, PARSER_ERROR_SYNTAX_ERROR));
+    ends[0] = IRBuilder_GetBlock(builder);
+
+    IRBuilder_SetBlock(builder, arms[1]);
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_CONDITIONAL, &values[1]));
+    ends[1] = IRBuilder_GetBlock(builder);
+
+    ASTTypeId type = AST_TYPE_ID_NONE;
+    bool aggregate = false;
+
+    for (uint32_t i = 0; i < 2; i++) {
+        IRBuilder_SetBlock(builder, ends[i]);
+        ASTTypeKind kind = ParserCTypeKind(parser, values[i].type);
+        aggregate = kind == AST_TYPE_KIND_STRUCT || kind == AST_TYPE_KIND_UNION;
+        if (!aggregate)
+            CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, &values[i]));
+    }
+
+    uint32_t common = ParserCArithmeticCommon(ParserCArithmeticType(parser, values[0].type),
+        ParserCArithmeticType(parser, values[1].type));
+
+    if (common != C_BASIC_TYPE_NONE)
+        CHECK_PARSER_RESULT(ASTTypeTable_GetBasic(parser->types, common, 0, &type));
+    else if (ParserCTypeKind(parser, values[0].type) == AST_TYPE_KIND_POINTER)
+        type = values[0].type;
+    else if (ParserCTypeKind(parser, values[1].type) == AST_TYPE_KIND_POINTER)
+        type = values[1].type;
+    else if (ASTTypeTable_AreCompatible(parser->types, ASTTypeTable_GetUnqualified(parser->types, values[0].type),
+                 ASTTypeTable_GetUnqualified(parser->types, values[1].type)))
+        type = values[0].type;
+    else
+        return PARSER_ERROR_UNSUPPORTED;
+
+    IRType irType = aggregate ? IR_TYPE_PTR : ParserCGetIRType(parser, type);
+    bool isVoid = !aggregate && ParserCTypeKind(parser, type) == AST_TYPE_KIND_BASIC &&
+        ASTTypeTable_Get(parser->types, type)->value == C_BASIC_TYPE_VOID;
+
+    for (uint32_t i = 0; i < 2; i++) {
+        IRBuilder_SetBlock(builder, ends[i]);
+        if (!aggregate && !isVoid)
+            CHECK_PARSER_RESULT(ParserCLowerConvert(lowering, &values[i], type));
+        CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_BR, IR_TYPE_VOID, join, 0, 0, NULL));
+    }
+
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, join));
+    IRBuilder_SetBlock(builder, join);
+
+    value->kind = aggregate ? C_VALUE_MEMORY : C_VALUE_RVALUE;
+    value->type = type;
+    value->value = IR_VALUE_NONE;
+    if (isVoid)
+        return PARSER_RESULT_SUCCESS;
+
+    if (irType == IR_TYPE_VOID)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    // The arms branched to the join in order, so are its predecessors
+    CHECK_PARSER_RESULT(IRFunction_AddPhi(lowering->function, join, irType, &value->value));
+    CHECK_PARSER_RESULT(IRFunction_AppendOperand(lowering->function, value->value, values[0].value));
+    return IRFunction_AppendOperand(lowering->function, value->value, values[1].value);
+}
+
+/* `a && b`, `a || b`: b only runs when a does not decide */
+static ParserResult ParserCLowerLogical(ParserCLowering* lowering, uint32_t op, uint32_t precedence, ParserCValue* value)
+{
+    IRBuilder builder = lowering->builder;
+    bool isOr = op == C_BINARY_OP_LOGICAL_OR;
+
+    IRValueId left;
+    IRBlockId right;
+    IRBlockId join;
+    CHECK_PARSER_RESULT(ParserCLowerCondition(lowering, value, &left));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &right));
+    CHECK_PARSER_RESULT(IRBuilder_AddBlock(builder, &join));
+    CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_CONDBR, IR_TYPE_VOID, left,
+        isOr ? join : right, isOr ? right : join, NULL));
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, right));
+
+    ParserCValue operand;
+    IRValueId condition;
+    IRBuilder_SetBlock(builder, right);
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, precedence, &operand));
+    CHECK_PARSER_RESULT(ParserCLowerCondition(lowering, &operand, &condition));
+    CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_BR, IR_TYPE_VOID, join, 0, 0, NULL));
+
+    CHECK_PARSER_RESULT(IRBuilder_SealBlock(builder, join));
+    IRBuilder_SetBlock(builder, join);
+
+    // Predecessors: the block that decided, then the right operand
+    IRValueId decided;
+    CHECK_PARSER_RESULT(IRBuilder_GetConstant(builder, IR_TYPE_I1, isOr, &decided));
+    CHECK_PARSER_RESULT(IRFunction_AddPhi(lowering->function, join, IR_TYPE_I1, &value->value));
+    CHECK_PARSER_RESULT(IRFunction_AppendOperand(lowering->function, value->value, decided));
+    CHECK_PARSER_RESULT(IRFunction_AppendOperand(lowering->function, value->value, condition));
+
+    value->kind = C_VALUE_CONDITION;
+
+    return ASTTypeTable_GetBasic(lowering->parser->types, C_BASIC_TYPE_INT, 0, &value->type);
+}
+
+/* Arguments of a call after `(`, converted as by assignment or promoted */
+static ParserResult ParserCLowerCall(ParserCLowering* lowering, ParserCValue* callee)
+{
+    ASTParser parser = lowering->parser;
+
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, callee));
+
+    const ASTTypeInfo* pointer = ASTTypeTable_Get(parser->types, callee->type);
+    if (!pointer || pointer->kind != AST_TYPE_KIND_POINTER ||
+        ParserCTypeKind(parser, pointer->base) != AST_TYPE_KIND_FUNCTION)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    ASTTypeId functionType = pointer->base;
+    const ASTTypeInfo* function = ASTTypeTable_Get(parser->types, functionType);
+    ASTTypeId returnType = ASTTypeTable_GetUnqualified(parser->types, function->base);
+    uint32_t paramCount = function->count;
+    bool prototype = (function->flags & AST_TYPE_FLAG_PROTOTYPE) != 0;
+    bool variadic = (function->flags & AST_TYPE_FLAG_VARIADIC) != 0;
+
+    IRType irReturn = ParserCGetIRType(parser, returnType);
+    const ASTTypeInfo* returnInfo = ASTTypeTable_Get(parser->types, returnType);
+    if (irReturn == IR_TYPE_VOID && !(returnInfo->kind == AST_TYPE_KIND_BASIC && returnInfo->value == C_BASIC_TYPE_VOID))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    // Argument values stack on the scratch list, nested calls above them
+    uint32_t base = parser->scratchCount;
+    uint32_t count = 0;
+
+    if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RPAREN)) {
+        for (;;) {
+            ParserCValue argument;
+            CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_ASSIGNMENT, &argument));
+            CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, &argument));
+
+            if (prototype && count < paramCount) {
+                CHECK_PARSER_RESULT(ParserCLowerConvert(lowering, &argument,
+                    ASTTypeTable_GetParams(parser->types, functionType)[count]));
+            }
+            else if (prototype && !variadic) {
+                return PARSER_ERROR_UNSUPPORTED;
+            }
+            else {
+                // Default argument promotions
+                uint32_t basic = ParserCArithmeticType(parser, argument.type);
+                if (basic == C_BASIC_TYPE_FLOAT)
+                    CHECK_PARSER_RESULT(ParserCConvertBasic(lowering, &argument, C_BASIC_TYPE_DOUBLE));
+                else
+                    CHECK_PARSER_RESULT(ParserCPromoteValue(lowering, &argument));
+            }
+
+            if (ParserCGetIRType(parser, argument.type) == IR_TYPE_VOID)
+                return PARSER_ERROR_UNSUPPORTED;
+
+            CHECK_PARSER_RESULT(ASTParserScratchPush(parser, argument.value));
+            count++;
+
+            if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA))
+                break;
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        }
+    }
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+    if (prototype && count < paramCount)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    ParserResult result = IRBuilder_EmitList(lowering->builder, IR_OP_CALL, irReturn, callee->value, 0,
+        &parser->scratch[base], count, &callee->value);
+    parser->scratchCount = base;
+
+    callee->kind = C_VALUE_RVALUE;
+    callee->type = returnType;
+
+    return result;
+}
+
+/* `s.m` and `p->m`: the member is at a constant offset from the object */
+static ParserResult ParserCLowerMember(ParserCLowering* lowering, ParserCValue* value, bool arrow)
+{
+    ASTParser parser = lowering->parser;
+
+    if (ASTParserPeek(parser)->flags != TOKEN_TYPE_IDENTIFIER)
+        return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+    ParserIdentifierId name;
+    CHECK_PARSER_RESULT(ASTParserTokenName(parser, LexerPeekN(parser->lexer, 0), &name));
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    ASTTypeId object = value->type;
+    if (arrow) {
+        CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, value));
+        if (ParserCTypeKind(parser, value->type) != AST_TYPE_KIND_POINTER)
+            return PARSER_ERROR_UNSUPPORTED;
+        object = ASTTypeTable_Get(parser->types, value->type)->base;
+    }
+    else if (value->kind != C_VALUE_MEMORY) {
+        return PARSER_ERROR_UNSUPPORTED;
+    }
+
+    uint64_t offset;
+    ASTTypeId member;
+    if (!ParserCGetMember(parser, object, name, &offset, &member))
+        return PARSER_ERROR_UNSUPPORTED;
+
+    // Qualifiers of the object apply to its members
+    uint32_t qualifiers = ASTTypeTable_Get(parser->types, object)->qualifiers;
+    if (qualifiers)
+        CHECK_PARSER_RESULT(ASTTypeTable_GetQualified(parser->types, member, qualifiers, &member));
+
+    value->kind = C_VALUE_MEMORY;
+    value->type = member;
+    if (offset == 0)
+        return PARSER_RESULT_SUCCESS;
+
+    IRValueId displacement;
+    CHECK_PARSER_RESULT(IRBuilder_GetConstant(lowering->builder, IR_TYPE_I64, offset, &displacement));
+
+    return IRBuilder_Emit(lowering->builder, IR_OP_PTRADD, IR_TYPE_PTR, value->value, displacement, 0, &value->value);
+}
+
+/* `a[i]` is `*(a + i)` */
+static ParserResult ParserCLowerSubscript(ParserCLowering* lowering, ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+    ParserCValue index;
+
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, value));
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_NONE, &index));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RBRACKET, PARSER_ERROR_UNCLOSED_BRACKET));
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, &index));
+
+    if (ParserCTypeKind(parser, value->type) == AST_TYPE_KIND_POINTER)
+        CHECK_PARSER_RESULT(ParserCLowerPointerOffset(lowering, value, &index, false, value));
+    else if (ParserCTypeKind(parser, index.type) == AST_TYPE_KIND_POINTER)
+        CHECK_PARSER_RESULT(ParserCLowerPointerOffset(lowering, &index, value, false, value));
+    else
+        return PARSER_ERROR_UNSUPPORTED;
+
+    value->kind = C_VALUE_MEMORY;
+    value->type = ASTTypeTable_Get(parser->types, value->type)->base;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* `=` and compound assignment, the result is the stored value */
+static ParserResult ParserCLowerAssignment(ParserCLowering* lowering, uint32_t op, uint32_t precedence, ParserCValue* value)
+{
+    if (value->kind != C_VALUE_VARIABLE && value->kind != C_VALUE_MEMORY)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    ParserCValue lvalue = *value;
+    ParserCValue right;
+    CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, precedence, &right));
+
+    if (op == C_BINARY_OP_ASSIGN) {
+        ASTTypeKind kind = ParserCTypeKind(lowering->parser, lvalue.type);
+        CHECK_PARSER_RESULT(ParserCLowerStore(lowering, &lvalue, &right));
+
+        // A struct assignment yields the object
+        if (kind != AST_TYPE_KIND_STRUCT && kind != AST_TYPE_KIND_UNION)
+            *value = right;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    // a op= b is a = a op b with a evaluated once; the assignment
+    // operators list the arithmetic ones in the same order
+    ParserCValue left = lvalue;
+    ParserCValue updated;
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, &left));
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, &right));
+    CHECK_PARSER_RESULT(ParserCLowerArithmetic(lowering, op - C_BINARY_OP_ADD_ASSIGN + C_BINARY_OP_ADD,
+        &left, &right, &updated));
+    CHECK_PARSER_RESULT(ParserCLowerStore(lowering, &lvalue, &updated));
+
+    *value = updated;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR IRType PARSER_CALL ParserCGetIRType(
+    ASTParser parser,
+    ASTTypeId type)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+    if (!info)
+        return IR_TYPE_VOID;
+
+    switch (info->kind) {
+    case AST_TYPE_KIND_POINTER:
+        return IR_TYPE_PTR;
+    case AST_TYPE_KIND_ENUM:
+        return IR_TYPE_I32;
+    case AST_TYPE_KIND_BASIC:
+        switch (info->value) {
+        case C_BASIC_TYPE_FLOAT:
+            return IR_TYPE_F32;
+        case C_BASIC_TYPE_DOUBLE:
+            return IR_TYPE_F64;
+        default:
+            if (!ParserCIsIntegerType(info->value))
+                return IR_TYPE_VOID;
+
+            // _Bool is a byte in memory
+            switch (g_ParserCBasicSizes[info->value]) {
+            case 1:  return IR_TYPE_I8;
+            case 2:  return IR_TYPE_I16;
+            case 4:  return IR_TYPE_I32;
+            default: return IR_TYPE_I64;
+            }
+        }
+    default:
+        return IR_TYPE_VOID;
+    }
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerRValue(
+    ParserCLowering* lowering,
+    ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+
+    switch (value->kind) {
+    case C_VALUE_CONDITION:
+        value->kind = C_VALUE_RVALUE;
+        return IRBuilder_Emit(lowering->builder, IR_OP_ZEXT, IR_TYPE_I32, value->value, 0, 0, &value->value);
+
+    case C_VALUE_VARIABLE: {
+        const ParserCLocal* local = ParserCGetLocal(lowering, value->value);
+        value->kind = C_VALUE_RVALUE;
+        value->type = ASTTypeTable_GetUnqualified(parser->types, value->type);
+        return IRBuilder_ReadVariable(lowering->builder, value->value, (IRType)local->irType, &value->value);
+    }
+
+    case C_VALUE_MEMORY: {
+        const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, value->type);
+
+        switch (info->kind) {
+        case AST_TYPE_KIND_ARRAY:
+            value->kind = C_VALUE_RVALUE;
+            return ASTTypeTable_GetPointer(parser->types, info->base, 0, &value->type);
+        case AST_TYPE_KIND_FUNCTION:
+            value->kind = C_VALUE_RVALUE;
+            return ASTTypeTable_GetPointer(parser->types, value->type, 0, &value->type);
+        case AST_TYPE_KIND_STRUCT:
+        case AST_TYPE_KIND_UNION:
+            // Struct values stay where they are
+            return PARSER_RESULT_SUCCESS;
+        default:
+            break;
+        }
+
+        IRType type = ParserCGetIRType(parser, value->type);
+        if (type == IR_TYPE_VOID)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        bool isVolatile = (info->qualifiers & C_TYPE_QUAL_VOLATILE) != 0;
+        CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_LOAD, type, value->value, 0, 0, &value->value));
+        if (isVolatile)
+            IRFunction_SetInstructionFlags(lowering->function, value->value, IR_INSTRUCTION_FLAG_VOLATILE);
+
+        value->kind = C_VALUE_RVALUE;
+        value->type = ASTTypeTable_GetUnqualified(parser->types, value->type);
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    default:
+        return PARSER_RESULT_SUCCESS;
+    }
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerConvert(
+    ParserCLowering* lowering,
+    ParserCValue* value,
+    ASTTypeId type)
+{
+    ASTParser parser = lowering->parser;
+    IRBuilder builder = lowering->builder;
+
+    type = ASTTypeTable_GetUnqualified(parser->types, type);
+    uint32_t toBasic = ParserCArithmeticType(parser, type);
+
+    // Any scalar converts to _Bool by comparing against zero
+    if (toBasic == C_BASIC_TYPE_BOOL) {
+        IRValueId condition;
+        CHECK_PARSER_RESULT(ParserCLowerCondition(lowering, value, &condition));
+
+        value->kind = C_VALUE_RVALUE;
+        value->type = type;
+        return IRBuilder_Emit(builder, IR_OP_ZEXT, IR_TYPE_I8, condition, 0, 0, &value->value);
+    }
+
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, value));
+
+    IRType from = ParserCGetIRType(parser, value->type);
+    IRType to = ParserCGetIRType(parser, type);
+    if (from == IR_TYPE_VOID || to == IR_TYPE_VOID)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    uint32_t fromBasic = ParserCArithmeticType(parser, value->type);
+    value->type = type;
+
+    bool fromFloating = ParserCIsFloating(fromBasic);
+    bool toFloating = ParserCIsFloating(toBasic);
+    bool fromSigned = ParserCIsSignedType(fromBasic);
+    IROpcode opcode = IR_OP_NOP;
+
+    if (fromFloating && toFloating) {
+        opcode = from == to ? IR_OP_NOP : from == IR_TYPE_F32 ? IR_OP_FPEXT : IR_OP_FPTRUNC;
+    }
+    else if (fromFloating || toFloating) {
+        // Pointers do not convert to or from floating types
+        if (from == IR_TYPE_PTR || to == IR_TYPE_PTR)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        opcode = toFloating ? (fromSigned ? IR_OP_SITOFP : IR_OP_UITOFP) :
+                              (ParserCIsSignedType(toBasic) ? IR_OP_FPTOSI : IR_OP_FPTOUI);
+    }
+    else if (to == IR_TYPE_PTR && from != IR_TYPE_PTR) {
+        if (from != IR_TYPE_I64)
+            CHECK_PARSER_RESULT(IRBuilder_Emit(builder, fromSigned ? IR_OP_SEXT : IR_OP_ZEXT, IR_TYPE_I64,
+                value->value, 0, 0, &value->value));
+        opcode = IR_OP_INTTOPTR;
+    }
+    else if (from == IR_TYPE_PTR && to != IR_TYPE_PTR) {
+        CHECK_PARSER_RESULT(IRBuilder_Emit(builder, IR_OP_PTRTOINT, IR_TYPE_I64, value->value, 0, 0, &value->value));
+        opcode = to == IR_TYPE_I64 ? IR_OP_NOP : IR_OP_TRUNC;
+    }
+    else if (from != to) {
+        uint32_t fromSize = IRType_GetSize(from);
+        uint32_t toSize = IRType_GetSize(to);
+
+        // Literals are converted here, not in the code
+        const IRInstruction* source = IRFunction_GetInstruction(lowering->function, value->value);
+        if (source && source->opcode == IR_OP_CONST) {
+            uint64_t bits = IR_CONST_BITS(source);
+            uint32_t width = fromSize * 8u;
+            if (width < 64) {
+                uint64_t mask = ((uint64_t)1 << width) - 1;
+                bits &= mask;
+                if (fromSigned && (bits >> (width - 1)))
+                    bits |= ~mask;
+            }
+            return IRBuilder_GetConstant(builder, to, bits, &value->value);
+        }
+
+        opcode = toSize < fromSize ? IR_OP_TRUNC : fromSigned ? IR_OP_SEXT : IR_OP_ZEXT;
+    }
+
+    if (opcode == IR_OP_NOP)
+        return PARSER_RESULT_SUCCESS;
+
+    return IRBuilder_Emit(builder, opcode, to, value->value, 0, 0, &value->value);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerCondition(
+    ParserCLowering* lowering,
+    ParserCValue* value,
+    IRValueId* condition)
+{
+    if (value->kind == C_VALUE_CONDITION) {
+        *condition = value->value;
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, value));
+
+    IRType type = ParserCGetIRType(lowering->parser, value->type);
+    if (type == IR_TYPE_VOID)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    IRValueId zero;
+    CHECK_PARSER_RESULT(IRBuilder_GetConstant(lowering->builder, type, 0, &zero));
+
+    IROpcode opcode = type == IR_TYPE_F32 || type == IR_TYPE_F64 ? IR_OP_FNE : IR_OP_NE;
+
+    return IRBuilder_Emit(lowering->builder, opcode, IR_TYPE_I1, value->value, zero, 0, condition);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerStore(
+    ParserCLowering* lowering,
+    const ParserCValue* lvalue,
+    ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+    ASTTypeKind kind = ParserCTypeKind(parser, lvalue->type);
+
+    if (kind == AST_TYPE_KIND_STRUCT || kind == AST_TYPE_KIND_UNION) {
+        uint64_t size;
+        uint32_t alignment;
+        if (lvalue->kind != C_VALUE_MEMORY || value->kind != C_VALUE_MEMORY ||
+            !ASTTypeTable_AreCompatible(parser->types, ASTTypeTable_GetUnqualified(parser->types, lvalue->type),
+                ASTTypeTable_GetUnqualified(parser->types, value->type)) ||
+            !ParserCGetLayout(parser, lvalue->type, &size, &alignment) || size > UINT32_MAX)
+            return PARSER_ERROR_UNSUPPORTED;
+
+        return IRBuilder_Emit(lowering->builder, IR_OP_MEMCOPY, IR_TYPE_VOID, lvalue->value, value->value,
+            (uint32_t)size, NULL);
+    }
+
+    CHECK_PARSER_RESULT(ParserCLowerConvert(lowering, value, lvalue->type));
+
+    if (lvalue->kind == C_VALUE_VARIABLE)
+        return IRBuilder_WriteVariable(lowering->builder, lvalue->value, value->value);
+
+    if (lvalue->kind != C_VALUE_MEMORY)
+        return PARSER_ERROR_UNSUPPORTED;
+
+    IRValueId store;
+    CHECK_PARSER_RESULT(IRBuilder_Emit(lowering->builder, IR_OP_STORE, IR_TYPE_VOID, lvalue->value, value->value, 0, &store));
+    if (ParserCIsVolatile(parser, lvalue->type))
+        IRFunction_SetInstructionFlags(lowering->function, store, IR_INSTRUCTION_FLAG_VOLATILE);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCLowerExpression(
+    ParserCLowering* lowering,
+    uint32_t precedence,
+    ParserCValue* value)
+{
+    ASTParser parser = lowering->parser;
+
+    if (precedence < C_PREC_COMMA)
+        precedence = C_PREC_COMMA;
+
+    CHECK_PARSER_RESULT(ParserCLowerUnary(lowering, value));
+
+    for (;;) {
+        const ParserCOperatorInfo* info = ParserCGetOperatorInfo(LexerPeekN(parser->lexer, 0));
+        if (info->precedence < precedence)
+            break;
+
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+        switch (info->nodeType) {
+        case AST_NODE_TYPE_TERNARY_EXPR:
+            CHECK_PARSER_RESULT(ParserCLowerConditional(lowering, value));
+            break;
+
+        case AST_NODE_TYPE_COMMA_EXPR:
+            // The left operand is only evaluated
+            CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, C_PREC_ASSIGNMENT, value));
+            break;
+
+        case AST_NODE_TYPE_CALL_EXPR:
+            CHECK_PARSER_RESULT(ParserCLowerCall(lowering, value));
+            break;
+
+        case AST_NODE_TYPE_ARRAY_SUBSCRIPT_EXPR:
+            CHECK_PARSER_RESULT(ParserCLowerSubscript(lowering, value));
+            break;
+
+        case AST_NODE_TYPE_MEMBER_EXPR:
+        case AST_NODE_TYPE_ARROW_EXPR:
+            CHECK_PARSER_RESULT(ParserCLowerMember(lowering, value, info->nodeType == AST_NODE_TYPE_ARROW_EXPR));
+            break;
+
+        case AST_NODE_TYPE_UNARY_EXPR:
+            // Postfix ++ and --
+            CHECK_PARSER_RESULT(ParserCLowerIncrement(lowering, value, info->op == C_UNARY_OP_POST_INCREMENT, false, value));
+            break;
+
+        case AST_NODE_TYPE_ASSIGNMENT_EXPR:
+            CHECK_PARSER_RESULT(ParserCLowerAssignment(lowering, info->op, info->precedence, value));
+            break;
+
+        default: {
+            uint32_t next = info->precedence + 1u;
+
+            if (info->op == C_BINARY_OP_LOGICAL_AND || info->op == C_BINARY_OP_LOGICAL_OR) {
+                CHECK_PARSER_RESULT(ParserCLowerLogical(lowering, info->op, next, value));
+                break;
+            }
+
+            ParserCValue right;
+            CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, value));
+            CHECK_PARSER_RESULT(ParserCLowerExpression(lowering, next, &right));
+            CHECK_PARSER_RESULT(ParserCLowerRValue(lowering, &right));
+            CHECK_PARSER_RESULT(ParserCLowerArithmetic(lowering, info->op, value, &right, value));
+            break;
+        }
+        }
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,353 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCInternal.h"
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/* `( expression )` of if, while, do and switch */
+static ParserResult ParserCParseCondition(ASTParser parser, ASTNodeId* id)
+{
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_LPAREN, PARSER_ERROR_UNEXPECTED_TOKEN));
+    CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_NONE, id));
+    return ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS);
+}
+
+/* Statement, or a declaration whose nodes go to the enclosing list */
+static ParserResult ParserCParseBlockItem(ASTParser parser)
+{
+    ASTNodeId id;
+
+    if (ParserCIsDeclarationAt(parser, 0))
+        return ParserCParseDeclarationList(parser, &id);
+
+    CHECK_PARSER_RESULT(ParserCParseStatementNode(parser, &id));
+    return ASTParserScratchPush(parser, id);
+}
+
+static ParserResult ParserCParseIf(ASTParser parser, uint32_t index, ASTNodeId* id)
+{
+    ASTNodeId children[3] = { AST_NODE_ID_NONE, AST_NODE_ID_NONE, AST_NODE_ID_NONE };
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ParserCParseCondition(parser, &children[0]));
+    CHECK_PARSER_RESULT(ParserCParseStatementNode(parser, &children[1]));
+
+    // A dangling else binds to the innermost if
+    if (ASTParserIsKeyword(ASTParserPeek(parser), C_KEYWORD_ELSE)) {
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        CHECK_PARSER_RESULT(ParserCParseStatementNode(parser, &children[2]));
+    }
+
+    return ASTTree_AddListNode(parser->tree, AST_NODE_TYPE_IF_STMT, 0, index, children, 3, id);
+}
+
+static ParserResult ParserCParseDoWhile(ASTParser parser, uint32_t index, ASTNodeId* id)
+{
+    ASTNodeId body;
+    ASTNodeId condition;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ParserCParseStatementNode(parser, &body));
+
+    if (!ASTParserIsKeyword(ASTParserPeek(parser), C_KEYWORD_WHILE))
+        return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ParserCParseCondition(parser, &condition));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+
+    return ASTParserAddNode(parser, AST_NODE_TYPE_DO_WHILE_STMT, 0, index, body, condition, id);
+}
+
+/* Clauses of a for statement, in the block the statement opens */
+static ParserResult ParserCParseForClauses(ASTParser parser, ASTNodeId* children)
+{
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_LPAREN, PARSER_ERROR_UNEXPECTED_TOKEN));
+
+    // ===== INIT =====
+    // A declaration keeps its declarators together in a block node
+    uint32_t first = ASTParserTokenIndex(parser);
+
+    if (ParserCIsDeclarationAt(parser, 0)) {
+        uint32_t base = parser->scratchCount;
+        ASTNodeId last;
+        CHECK_PARSER_RESULT(ParserCParseDeclarationList(parser, &last));
+        CHECK_PARSER_RESULT(ASTParserAddScratchList(parser, base, AST_NODE_TYPE_COMPOUND_STMT, 0, first, &children[0]));
+    }
+    else {
+        if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON))
+            CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_NONE, &children[0]));
+        CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+    }
+
+    // ===== CONDITION =====
+    if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON))
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_NONE, &children[1]));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+
+    // ===== STEP =====
+    if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RPAREN))
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_NONE, &children[2]));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+
+    return ParserCParseStatementNode(parser, &children[3]);
+}
+
+static ParserResult ParserCParseFor(ASTParser parser, uint32_t index, ASTNodeId* id)
+{
+    ASTNodeId children[4] = { AST_NODE_ID_NONE, AST_NODE_ID_NONE, AST_NODE_ID_NONE, AST_NODE_ID_NONE };
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    ASTScope scope;
+    CHECK_PARSER_RESULT(ASTSymbolTable_PushScope(parser->symbols, AST_SCOPE_KIND_BLOCK, &scope));
+
+    ParserResult result = ParserCParseForClauses(parser, children);
+
+    ASTSymbolTable_PopScope(parser->symbols, scope);
+    CHECK_PARSER_RESULT(result);
+
+    return ASTTree_AddListNode(parser->tree, AST_NODE_TYPE_FOR_STMT, 0, index, children, 4, id);
+}
+
+/* `goto name;`, a label defined later is declared here and completed by its statement */
+static ParserResult ParserCParseGoto(ASTParser parser, uint32_t index, ASTNodeId* id)
+{
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    LexerToken token = LexerPeekN(parser->lexer, 0);
+    if (!token || token->flags != TOKEN_TYPE_IDENTIFIER)
+        return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+    ParserIdentifierId name;
+    CHECK_PARSER_RESULT(ASTParserTokenName(parser, token, &name));
+
+    ASTSymbolId label = ASTSymbolTable_Lookup(parser->symbols, AST_NAMESPACE_LABEL, name, 0);
+    if (label == AST_SYMBOL_ID_NONE) {
+        ParserResult result = ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_LABEL, name,
+            AST_SYMBOL_KIND_LABEL, 0, AST_NODE_ID_NONE, &label);
+        if (result != PARSER_RESULT_SUCCESS)
+            return ASTParserError(parser, result);
+
+        parser->pendingLabels++;
+    }
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+
+    return ASTParserAddNode(parser, AST_NODE_TYPE_GOTO_STMT, 0, index, name, label, id);
+}
+
+/* `name: statement` */
+static ParserResult ParserCParseLabel(ASTParser parser, uint32_t index, ASTNodeId* id)
+{
+    ParserIdentifierId name;
+    CHECK_PARSER_RESULT(ASTParserTokenName(parser, LexerPeekN(parser->lexer, 0), &name));
+
+    ASTSymbolId label = ASTSymbolTable_Lookup(parser->symbols, AST_NAMESPACE_LABEL, name, 0);
+    if (label != AST_SYMBOL_ID_NONE) {
+        // Declared by a goto, defined here; defined twice is an error
+        if (ASTSymbolTable_GetSymbol(parser->symbols, label)->node != AST_NODE_ID_NONE)
+            return ASTParserError(parser, PARSER_ERROR_REDECLARATION);
+
+        parser->pendingLabels--;
+    }
+    else {
+        ParserResult result = ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_LABEL, name,
+            AST_SYMBOL_KIND_LABEL, 0, AST_NODE_ID_NONE, &label);
+        if (result != PARSER_RESULT_SUCCESS)
+            return ASTParserError(parser, result);
+    }
+
+    // The node is bound before its statement, which may define labels too
+    CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_LABEL_STMT, 0, index, AST_NODE_ID_NONE, label, id));
+    ASTSymbolTable_SetNode(parser->symbols, label, *id);
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    ASTNodeId statement;
+    CHECK_PARSER_RESULT(ParserCParseStatementNode(parser, &statement));
+
+    return ASTTree_SetChild(parser->tree, *id, 0, statement);
+}
+
+/* `case constant-expression: statement` and `default: statement` */
+static ParserResult ParserCParseCaseLabel(ASTParser parser, uint32_t keyword, uint32_t index, ASTNodeId* id)
+{
+    ASTNodeId value = AST_NODE_ID_NONE;
+    ASTNodeId statement;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    if (keyword == C_KEYWORD_CASE)
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_CONDITIONAL, &value));
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_COLON, PARSER_ERROR_UNEXPECTED_TOKEN));
+    CHECK_PARSER_RESULT(ParserCParseStatementNode(parser, &statement));
+
+    if (keyword == C_KEYWORD_CASE)
+        return ASTParserAddNode(parser, AST_NODE_TYPE_CASE_STMT, 0, index, value, statement, id);
+
+    return ASTParserAddNode(parser, AST_NODE_TYPE_DEFAULT_STMT, 0, index, statement, 0, id);
+}
+
+/* break, continue and return end in a semicolon */
+static ParserResult ParserCParseJump(ASTParser parser, uint32_t keyword, uint32_t index, ASTNodeId* id)
+{
+    ASTNodeId value = AST_NODE_ID_NONE;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    if (keyword == C_KEYWORD_RETURN && !ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON))
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_NONE, &value));
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+
+    switch (keyword) {
+    case C_KEYWORD_BREAK:
+        return ASTParserAddNode(parser, AST_NODE_TYPE_BREAK_STMT, 0, index, 0, 0, id);
+    case C_KEYWORD_CONTINUE:
+        return ASTParserAddNode(parser, AST_NODE_TYPE_CONTINUE_STMT, 0, index, 0, 0, id);
+    default:
+        return ASTParserAddNode(parser, AST_NODE_TYPE_RETURN_STMT, 0, index, value, 0, id);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseCompoundStatement(
+    ASTParser parser,
+    bool scoped,
+    ASTNodeId* id)
+{
+    uint32_t open = ASTParserTokenIndex(parser);
+    uint32_t base = parser->scratchCount;
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_LBRACE, PARSER_ERROR_UNEXPECTED_TOKEN));
+
+    ASTScope scope = NULL;
+    if (scoped)
+        CHECK_PARSER_RESULT(ASTSymbolTable_PushScope(parser->symbols, AST_SCOPE_KIND_BLOCK, &scope));
+
+    ParserResult result = PARSER_RESULT_SUCCESS;
+
+    while (result == PARSER_RESULT_SUCCESS && !ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RBRACE)) {
+        if (ASTParserPeek(parser)->flags == TOKEN_TYPE_EOF)
+            result = ASTParserErrorAt(parser, PARSER_ERROR_UNCLOSED_BRACE, open);
+        else
+            result = ParserCParseBlockItem(parser);
+    }
+
+    if (result == PARSER_RESULT_SUCCESS)
+        result = ASTParserAdvance(parser);
+
+    if (scoped)
+        ASTSymbolTable_PopScope(parser->symbols, scope);
+
+    if (result != PARSER_RESULT_SUCCESS) {
+        parser->scratchCount = base;
+        return result;
+    }
+
+    return ASTParserAddScratchList(parser, base, AST_NODE_TYPE_COMPOUND_STMT, 0, open, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseStatementNode(
+    ASTParser parser,
+    ASTNodeId* id)
+{
+    const struct LexerToken_T* token = ASTParserPeek(parser);
+    uint32_t index = ASTParserTokenIndex(parser);
+
+    switch (token->flags) {
+    case TOKEN_TYPE_PUNCTUATION:
+        if (token->value == PUNCTUATION_LBRACE)
+            return ParserCParseCompoundStatement(parser, true, id);
+
+        // Null statement
+        if (token->value == PUNCTUATION_SEMICOLON) {
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            return ASTParserAddNode(parser, AST_NODE_TYPE_EXPRESSION_STMT, 0, index, AST_NODE_ID_NONE, 0, id);
+        }
+        break;
+
+    case TOKEN_TYPE_KEYWORD:
+        switch (token->value) {
+        case C_KEYWORD_IF:
+            return ParserCParseIf(parser, index, id);
+
+        case C_KEYWORD_WHILE:
+        case C_KEYWORD_SWITCH: {
+            ParserASTNodeType type = token->value == C_KEYWORD_WHILE ? AST_NODE_TYPE_WHILE_STMT : AST_NODE_TYPE_SWITCH_STMT;
+            ASTNodeId condition;
+            ASTNodeId body;
+
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ParserCParseCondition(parser, &condition));
+            CHECK_PARSER_RESULT(ParserCParseStatementNode(parser, &body));
+
+            return ASTParserAddNode(parser, type, 0, index, condition, body, id);
+        }
+
+        case C_KEYWORD_DO:
+            return ParserCParseDoWhile(parser, index, id);
+
+        case C_KEYWORD_FOR:
+            return ParserCParseFor(parser, index, id);
+
+        case C_KEYWORD_CASE:
+        case C_KEYWORD_DEFAULT:
+            return ParserCParseCaseLabel(parser, token->value, index, id);
+
+        case C_KEYWORD_BREAK:
+        case C_KEYWORD_CONTINUE:
+        case C_KEYWORD_RETURN:
+            return ParserCParseJump(parser, token->value, index, id);
+
+        case C_KEYWORD_GOTO:
+            return ParserCParseGoto(parser, index, id);
+
+        default:
+            break;
+        }
+        break;
+
+    case TOKEN_TYPE_IDENTIFIER:
+        if (ASTParserIsPunctuation(ASTParserPeekN(parser, 1), PUNCTUATION_COLON))
+            return ParserCParseLabel(parser, index, id);
+        break;
+
+    default:
+        break;
+    }
+
+    // ===== EXPRESSION =====
+    ASTNodeId expression;
+    CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_NONE, &expression));
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+
+    return ASTParserAddNode(parser, AST_NODE_TYPE_EXPRESSION_STMT, 0, index, expression, 0, id);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseStatement(
+    ASTParser parser,
+    ASTNode* node)
+{
+    if (!parser || !node)
+        return PARSER_ERROR_INVALID_ARG;
+
+    ASTNodeId id;
+    CHECK_PARSER_RESULT(ParserCParseStatementNode(parser, &id));
+
+    *node = AST_NODE_FROM_ID(id);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,291 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCInternal.h"
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/* Body node of a struct or union type, AST_NODE_ID_NONE while it is incomplete */
+static ASTNodeId ParserCTagBody(ASTParser parser, const ASTTypeInfo* info)
+{
+    if (info->value & C_ANONYMOUS_TAG(0))
+        return ASTParserFindTagBody(parser, info->value);
+
+    const ASTSymbolInfo* tag = ASTSymbolTable_GetSymbol(parser->symbols, info->value);
+    return tag ? tag->node : AST_NODE_ID_NONE;
+}
+
+/* Member record of a body child, false for bit-fields and anonymous members */
+static bool ParserCMemberOf(ASTParser parser, ASTNodeId node, const ASTSymbolInfo** member)
+{
+    ASTNodeData data = ASTTree_GetData(parser->tree, node);
+    if (data.lhs != AST_NODE_ID_NONE)
+        return false;
+
+    *member = ASTSymbolTable_GetSymbol(parser->symbols, data.rhs);
+    return *member != NULL;
+}
+
+static inline uint64_t ParserCAlignUp(uint64_t value, uint32_t alignment)
+{
+    return (value + alignment - 1) & ~(uint64_t)(alignment - 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const uint8_t g_ParserCBasicSizes[C_BASIC_TYPE_LONG_DOUBLE_COMPLEX + 1] = {
+    [C_BASIC_TYPE_BOOL]                 = 1,
+    [C_BASIC_TYPE_CHAR]                 = 1,
+    [C_BASIC_TYPE_SIGNED_CHAR]          = 1,
+    [C_BASIC_TYPE_UNSIGNED_CHAR]        = 1,
+    [C_BASIC_TYPE_SHORT]                = 2,
+    [C_BASIC_TYPE_UNSIGNED_SHORT]       = 2,
+    [C_BASIC_TYPE_INT]                  = 4,
+    [C_BASIC_TYPE_UNSIGNED_INT]         = 4,
+    [C_BASIC_TYPE_LONG]                 = 8,
+    [C_BASIC_TYPE_UNSIGNED_LONG]        = 8,
+    [C_BASIC_TYPE_LONG_LONG]            = 8,
+    [C_BASIC_TYPE_UNSIGNED_LONG_LONG]   = 8,
+    [C_BASIC_TYPE_FLOAT]                = 4,
+    [C_BASIC_TYPE_DOUBLE]               = 8,
+    [C_BASIC_TYPE_LONG_DOUBLE]          = 16,
+    [C_BASIC_TYPE_FLOAT_COMPLEX]        = 8,
+    [C_BASIC_TYPE_DOUBLE_COMPLEX]       = 16,
+    [C_BASIC_TYPE_LONG_DOUBLE_COMPLEX]  = 32,
+};
+
+const uint8_t g_ParserCIntegerRanks[C_BASIC_TYPE_UNSIGNED_LONG_LONG + 1] = {
+    [C_BASIC_TYPE_BOOL]                 = 1,
+    [C_BASIC_TYPE_CHAR]                 = 2,
+    [C_BASIC_TYPE_SIGNED_CHAR]          = 2,
+    [C_BASIC_TYPE_UNSIGNED_CHAR]        = 2,
+    [C_BASIC_TYPE_SHORT]                = 3,
+    [C_BASIC_TYPE_UNSIGNED_SHORT]       = 3,
+    [C_BASIC_TYPE_INT]                  = 4,
+    [C_BASIC_TYPE_UNSIGNED_INT]         = 4,
+    [C_BASIC_TYPE_LONG]                 = 5,
+    [C_BASIC_TYPE_UNSIGNED_LONG]        = 5,
+    [C_BASIC_TYPE_LONG_LONG]            = 6,
+    [C_BASIC_TYPE_UNSIGNED_LONG_LONG]   = 6,
+};
+
+PARSER_ATTR uint64_t PARSER_CALL ParserCConvert(
+    uint64_t value,
+    uint32_t type)
+{
+    if (type == C_BASIC_TYPE_BOOL)
+        return value != 0;
+
+    uint32_t width = ParserCTypeWidth(type);
+    if (width == 64)
+        return value;
+
+    uint64_t mask = ((uint64_t)1 << width) - 1;
+    value &= mask;
+    if (ParserCIsSignedType(type) && (value >> (width - 1)))
+        value |= ~mask;
+
+    return value;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL ParserCCommonType(
+    uint32_t a,
+    uint32_t b)
+{
+    if (a == b)
+        return a;
+
+    bool signedA = ParserCIsSignedType(a);
+    if (signedA == ParserCIsSignedType(b))
+        return g_ParserCIntegerRanks[a] >= g_ParserCIntegerRanks[b] ? a : b;
+
+    uint32_t u = signedA ? b : a;
+    uint32_t s = signedA ? a : b;
+
+    if (g_ParserCIntegerRanks[u] >= g_ParserCIntegerRanks[s])
+        return u;
+    if (ParserCTypeWidth(s) > ParserCTypeWidth(u))
+        return s;
+
+    return ParserCToUnsigned(s);
+}
+
+PARSER_ATTR bool PARSER_CALL ParserCGetLayout(
+    ASTParser parser,
+    ASTTypeId type,
+    uint64_t* size,
+    uint32_t* alignment)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+    if (!info)
+        return false;
+
+    switch (info->kind) {
+    case AST_TYPE_KIND_BASIC:
+        if (info->value >= sizeof(g_ParserCBasicSizes) || !g_ParserCBasicSizes[info->value])
+            return false;
+
+        // Complex types align as their parts
+        *size = g_ParserCBasicSizes[info->value];
+        *alignment = info->value >= C_BASIC_TYPE_FLOAT_COMPLEX ? (uint32_t)*size / 2 : (uint32_t)*size;
+        return true;
+
+    case AST_TYPE_KIND_POINTER:
+        *size = C_POINTER_SIZE;
+        *alignment = C_POINTER_SIZE;
+        return true;
+
+    case AST_TYPE_KIND_ENUM:
+        *size = g_ParserCBasicSizes[C_BASIC_TYPE_INT];
+        *alignment = g_ParserCBasicSizes[C_BASIC_TYPE_INT];
+        return true;
+
+    case AST_TYPE_KIND_ARRAY: {
+        uint32_t length = info->value;
+        if (!(info->flags & AST_TYPE_FLAG_SIZED) || !ParserCGetLayout(parser, info->base, size, alignment))
+            return false;
+
+        if (length && *size > UINT64_MAX / length)
+            return false;
+
+        *size *= length;
+        return true;
+    }
+
+    case AST_TYPE_KIND_STRUCT:
+    case AST_TYPE_KIND_UNION: {
+        ASTNodeId body = ParserCTagBody(parser, info);
+        if (body == AST_NODE_ID_NONE)
+            return false;
+
+        bool isUnion = info->kind == AST_TYPE_KIND_UNION;
+        uint32_t count = ASTTree_GetChildCount(parser->tree, body);
+        uint64_t offset = 0;
+        uint32_t maxAlignment = 1;
+
+        for (uint32_t i = 0; i < count; i++) {
+            const ASTSymbolInfo* member;
+            uint64_t memberSize;
+            uint32_t memberAlignment;
+
+            if (!ParserCMemberOf(parser, ASTTree_GetChild(parser->tree, body, i), &member) ||
+                !ParserCGetLayout(parser, member->type, &memberSize, &memberAlignment))
+                return false;
+
+            if (memberAlignment > maxAlignment)
+                maxAlignment = memberAlignment;
+
+            if (isUnion) {
+                if (memberSize > offset)
+                    offset = memberSize;
+            }
+            else {
+                offset = ParserCAlignUp(offset, memberAlignment) + memberSize;
+            }
+        }
+
+        *size = ParserCAlignUp(offset, maxAlignment);
+        *alignment = maxAlignment;
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+PARSER_ATTR bool PARSER_CALL ParserCGetMember(
+    ASTParser parser,
+    ASTTypeId type,
+    ParserIdentifierId name,
+    uint64_t* offset,
+    ASTTypeId* memberType)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+    if (!info || (info->kind != AST_TYPE_KIND_STRUCT && info->kind != AST_TYPE_KIND_UNION))
+        return false;
+
+    ASTNodeId body = ParserCTagBody(parser, info);
+    ASTSymbolId symbol = ASTSymbolTable_Lookup(parser->symbols, AST_NAMESPACE_MEMBER, name, info->value);
+    if (body == AST_NODE_ID_NONE || symbol == AST_SYMBOL_ID_NONE)
+        return false;
+
+    bool isUnion = info->kind == AST_TYPE_KIND_UNION;
+    uint32_t count = ASTTree_GetChildCount(parser->tree, body);
+    uint64_t position = 0;
+
+    // Members before the one asked for are laid out to find its offset
+    for (uint32_t i = 0; i < count; i++) {
+        ASTNodeId node = ASTTree_GetChild(parser->tree, body, i);
+
+        const ASTSymbolInfo* member;
+        uint64_t memberSize;
+        uint32_t memberAlignment;
+
+        if (!ParserCMemberOf(parser, node, &member) ||
+            !ParserCGetLayout(parser, member->type, &memberSize, &memberAlignment))
+            return false;
+
+        if (!isUnion)
+            position = ParserCAlignUp(position, memberAlignment);
+
+        if (ASTTree_GetData(parser->tree, node).rhs == symbol) {
+            *offset = isUnion ? 0 : position;
+            *memberType = member->type;
+            return true;
+        }
+
+        if (!isUnion)
+            position += memberSize;
+    }
+
+    return false;
+}
+
+PARSER_ATTR bool PARSER_CALL ParserCGetMemberAt(
+    ASTParser parser,
+    ASTTypeId type,
+    uint32_t index,
+    uint64_t* offset,
+    ASTTypeId* memberType)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+    if (!info || (info->kind != AST_TYPE_KIND_STRUCT && info->kind != AST_TYPE_KIND_UNION))
+        return false;
+
+    ASTNodeId body = ParserCTagBody(parser, info);
+    if (body == AST_NODE_ID_NONE || index >= ASTTree_GetChildCount(parser->tree, body))
+        return false;
+
+    bool isUnion = info->kind == AST_TYPE_KIND_UNION;
+    uint64_t position = 0;
+
+    for (uint32_t i = 0;; i++) {
+        const ASTSymbolInfo* member;
+        uint64_t memberSize;
+        uint32_t memberAlignment;
+
+        if (!ParserCMemberOf(parser, ASTTree_GetChild(parser->tree, body, i), &member) ||
+            !ParserCGetLayout(parser, member->type, &memberSize, &memberAlignment))
+            return false;
+
+        if (!isUnion)
+            position = ParserCAlignUp(position, memberAlignment);
+
+        if (i == index) {
+            *offset = isUnion ? 0 : position;
+            *memberType = member->type;
+            return true;
+        }
+
+        if (!isUnion)
+            position += memberSize;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,828 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "ParserCInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define C_SPEC(specifier)           ((uint32_t)PARSER_BIT(C_TYPE_SPEC_##specifier))
+
+#define C_BASIC_SPECIFIER_KEYWORDS \
+    (C_KEYWORD_BIT(C_KEYWORD_VOID) | C_KEYWORD_BIT(C_KEYWORD_CHAR) | C_KEYWORD_BIT(C_KEYWORD_SHORT) | \
+     C_KEYWORD_BIT(C_KEYWORD_INT) | C_KEYWORD_BIT(C_KEYWORD_LONG) | C_KEYWORD_BIT(C_KEYWORD_FLOAT) | \
+     C_KEYWORD_BIT(C_KEYWORD_DOUBLE) | C_KEYWORD_BIT(C_KEYWORD_SIGNED) | C_KEYWORD_BIT(C_KEYWORD_UNSIGNED) | \
+     C_KEYWORD_BIT(C_KEYWORD_BOOL) | C_KEYWORD_BIT(C_KEYWORD_COMPLEX))
+
+static const uint8_t s_ParserCKeywordSpecifiers[C_KEYWORD_COUNT] = {
+    [C_KEYWORD_VOID]     = C_TYPE_SPEC_VOID,
+    [C_KEYWORD_CHAR]     = C_TYPE_SPEC_CHAR,
+    [C_KEYWORD_SHORT]    = C_TYPE_SPEC_SHORT,
+    [C_KEYWORD_INT]      = C_TYPE_SPEC_INT,
+    [C_KEYWORD_LONG]     = C_TYPE_SPEC_LONG,
+    [C_KEYWORD_FLOAT]    = C_TYPE_SPEC_FLOAT,
+    [C_KEYWORD_DOUBLE]   = C_TYPE_SPEC_DOUBLE,
+    [C_KEYWORD_SIGNED]   = C_TYPE_SPEC_SIGNED,
+    [C_KEYWORD_UNSIGNED] = C_TYPE_SPEC_UNSIGNED,
+    [C_KEYWORD_BOOL]     = C_TYPE_SPEC_BOOL,
+    [C_KEYWORD_COMPLEX]  = C_TYPE_SPEC_COMPLEX,
+};
+
+static const uint8_t s_ParserCKeywordQualifiers[C_KEYWORD_COUNT] = {
+    [C_KEYWORD_CONST]    = C_TYPE_QUAL_CONST,
+    [C_KEYWORD_VOLATILE] = C_TYPE_QUAL_VOLATILE,
+    [C_KEYWORD_RESTRICT] = C_TYPE_QUAL_RESTRICT,
+    [C_KEYWORD_ATOMIC]   = C_TYPE_QUAL_ATOMIC,
+};
+
+static const uint8_t s_ParserCKeywordStorageClasses[C_KEYWORD_COUNT] = {
+    [C_KEYWORD_TYPEDEF]  = C_STORAGE_CLASS_TYPEDEF,
+    [C_KEYWORD_EXTERN]   = C_STORAGE_CLASS_EXTERN,
+    [C_KEYWORD_STATIC]   = C_STORAGE_CLASS_STATIC,
+    [C_KEYWORD_AUTO]     = C_STORAGE_CLASS_AUTO,
+    [C_KEYWORD_REGISTER] = C_STORAGE_CLASS_REGISTER,
+};
+
+/*
+ * Declarator derivations are collected on the scratch stack as triples and
+ * applied to the base type once the whole declarator is read. The order on
+ * the stack is the application order, the last one binds to the name.
+ */
+typedef enum ParserCDerivation {
+    C_DERIVE_POINTER = 0,           // aux: qualifiers
+    C_DERIVE_ARRAY,                 // aux: ParserCArraySizeType, value: length or size node, extra: ASTTypeFlags
+    C_DERIVE_FUNCTION,              // aux: ASTTypeFlags, value: FUNCTION_TYPE list node
+} ParserCDerivation;
+
+#define C_DERIVATION_WORDS          3u
+
+static ParserResult ParserCPushDerivation(ASTParser parser, uint32_t kind, uint32_t aux, uint32_t value, uint32_t extra)
+{
+    CHECK_PARSER_RESULT(ASTParserScratchPush(parser, kind | aux << 8));
+    CHECK_PARSER_RESULT(ASTParserScratchPush(parser, value));
+    return ASTParserScratchPush(parser, extra);
+}
+
+/* Reverse the order of the derivations in scratch[first..last) */
+static void ParserCReverseDerivations(ASTParser parser, uint32_t first, uint32_t last)
+{
+    while (last - first >= 2 * C_DERIVATION_WORDS) {
+        last -= C_DERIVATION_WORDS;
+        for (uint32_t i = 0; i < C_DERIVATION_WORDS; i++) {
+            uint32_t word = parser->scratch[first + i];
+            parser->scratch[first + i] = parser->scratch[last + i];
+            parser->scratch[last + i] = word;
+        }
+        first += C_DERIVATION_WORDS;
+    }
+}
+
+static ParserResult ParserCParseTagBody(ASTParser parser, ASTTypeKind kind, uint32_t owner, ASTNodeId* id);
+
+/**
+ * struct, union or enum specifier. A body or `struct S;` declares the tag in
+ * the current scope, any other use refers to the visible tag and declares
+ * it only when there is none.
+ */
+static ParserResult ParserCParseTagSpecifier(ASTParser parser, uint32_t flags, ParserCTypeSpecifier* typeSpec, ASTTypeId* type)
+{
+    uint32_t keyword = ASTParserPeek(parser)->value;
+    uint32_t keywordToken = ASTParserTokenIndex(parser);
+
+    ASTTypeKind kind = AST_TYPE_KIND_STRUCT;
+    ASTSymbolKind symbolKind = AST_SYMBOL_KIND_STRUCT_TAG;
+    *typeSpec = C_TYPE_SPEC_STRUCT;
+
+    if (keyword == C_KEYWORD_UNION) {
+        kind = AST_TYPE_KIND_UNION;
+        symbolKind = AST_SYMBOL_KIND_UNION_TAG;
+        *typeSpec = C_TYPE_SPEC_UNION;
+    }
+    else if (keyword == C_KEYWORD_ENUM) {
+        kind = AST_TYPE_KIND_ENUM;
+        symbolKind = AST_SYMBOL_KIND_ENUM_TAG;
+        *typeSpec = C_TYPE_SPEC_ENUM;
+    }
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    ParserIdentifierId name = PARSER_IDENTIFIER_NONE;
+    uint32_t nameToken = ASTParserTokenIndex(parser);
+
+    LexerToken token = LexerPeekN(parser->lexer, 0);
+    if (token && token->flags == TOKEN_TYPE_IDENTIFIER) {
+        CHECK_PARSER_RESULT(ASTParserTokenName(parser, token, &name));
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+
+    bool body = ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_LBRACE);
+
+    // ===== ANONYMOUS =====
+    if (name == PARSER_IDENTIFIER_NONE) {
+        if (!body)
+            return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+        uint32_t tag = C_ANONYMOUS_TAG(keywordToken);
+        CHECK_PARSER_RESULT(ASTTypeTable_GetTagged(parser->types, kind, tag, 0, type));
+
+        ASTNodeId node;
+        CHECK_PARSER_RESULT(ParserCParseTagBody(parser, kind, tag, &node));
+
+        // There is no symbol to hold the body, the lowering lays it out
+        if (parser->module)
+            CHECK_PARSER_RESULT(ASTParserAddTagBody(parser, tag, node));
+
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    // ===== NAMED =====
+    bool declares = body ||
+        ((flags & C_DECL_SPEC_STORAGE) && ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON));
+
+    ASTSymbolId tag = ASTSymbolTable_Lookup(parser->symbols, AST_NAMESPACE_TAG, name, 0);
+    const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(parser->symbols, tag);
+
+    if (symbol && declares && symbol->scope != ASTSymbolTable_GetDepth(parser->symbols))
+        symbol = NULL;
+
+    if (!symbol) {
+        ParserResult result = ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_TAG, name, symbolKind, 0, AST_NODE_ID_NONE, &tag);
+        if (result != PARSER_RESULT_SUCCESS)
+            return ASTParserErrorAt(parser, result, nameToken);
+
+        CHECK_PARSER_RESULT(ASTTypeTable_GetTagged(parser->types, kind, tag, 0, type));
+        ASTSymbolTable_SetType(parser->symbols, tag, *type);
+    }
+    else {
+        // The node of a tag is its definition, a second one is an error
+        if (symbol->kind != symbolKind || (body && symbol->node != AST_NODE_ID_NONE))
+            return ASTParserErrorAt(parser, PARSER_ERROR_REDECLARATION, nameToken);
+
+        *type = symbol->type;
+    }
+
+    if (!body)
+        return PARSER_RESULT_SUCCESS;
+
+    ASTNodeId node;
+    CHECK_PARSER_RESULT(ParserCParseTagBody(parser, kind, tag, &node));
+    ASTSymbolTable_SetNode(parser->symbols, tag, node);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Member declarations, or enumerators, between braces */
+static ParserResult ParserCParseTagBody(ASTParser parser, ASTTypeKind kind, uint32_t owner, ASTNodeId* id)
+{
+    uint32_t open = ASTParserTokenIndex(parser);
+    uint32_t base = parser->scratchCount;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    // ===== ENUMERATORS =====
+    if (kind == AST_TYPE_KIND_ENUM) {
+        // Enumeration constants have type int (C11 6.7.2.2)
+        ASTTypeId constantType;
+        CHECK_PARSER_RESULT(ASTTypeTable_GetBasic(parser->types, C_BASIC_TYPE_INT, 0, &constantType));
+
+        // Value of an enumerator without initializer, one more than the
+        // previous. Unknown after a value that is not constant.
+        ParserCConstant next = { 0, C_BASIC_TYPE_INT };
+        bool nextKnown = true;
+
+        while (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RBRACE)) {
+            LexerToken token = LexerPeekN(parser->lexer, 0);
+            if (!token || token->flags != TOKEN_TYPE_IDENTIFIER)
+                return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+            uint32_t nameToken = ASTParserTokenIndex(parser);
+            ParserIdentifierId name;
+            CHECK_PARSER_RESULT(ASTParserTokenName(parser, token, &name));
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+            ASTNodeId value = AST_NODE_ID_NONE;
+            if (ParserCIsOperator(ASTParserPeek(parser), OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ASSIGN)) {
+                CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+                CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_CONDITIONAL, &value));
+
+                nextKnown = ParserCGetConstant(parser, value, &next);
+            }
+            else if (nextKnown) {
+                CHECK_PARSER_RESULT(ParserCAddConstantNode(parser, &next, nameToken, &value));
+            }
+
+            // The next value must still be an int
+            int64_t following = (int64_t)next.value + 1;
+            nextKnown = nextKnown && following >= INT32_MIN && following <= INT32_MAX;
+            next.value = (uint64_t)following;
+            next.type = C_BASIC_TYPE_INT;
+
+            // In scope from the end of its enumerator on
+            ASTSymbolId symbol;
+            ParserResult result = ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_ORDINARY, name,
+                AST_SYMBOL_KIND_ENUM_CONSTANT, 0, AST_NODE_ID_NONE, &symbol);
+            if (result != PARSER_RESULT_SUCCESS)
+                return ASTParserErrorAt(parser, result, nameToken);
+
+            ASTNodeId node;
+            CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_VARIABLE_DECL, AST_SYMBOL_KIND_ENUM_CONSTANT,
+                nameToken, value, symbol, &node));
+            ASTSymbolTable_SetType(parser->symbols, symbol, constantType);
+            ASTSymbolTable_SetNode(parser->symbols, symbol, node);
+            CHECK_PARSER_RESULT(ASTParserScratchPush(parser, node));
+
+            if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA))
+                break;
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        }
+
+        CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RBRACE, PARSER_ERROR_UNCLOSED_BRACE));
+        return ASTParserAddScratchList(parser, base, AST_NODE_TYPE_ENUM_DECL, 0, open, id);
+    }
+
+    // ===== MEMBERS =====
+    while (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RBRACE)) {
+        if (ASTParserPeek(parser)->flags == TOKEN_TYPE_EOF)
+            return ASTParserErrorAt(parser, PARSER_ERROR_UNCLOSED_BRACE, open);
+
+        ParserCDeclSpec spec;
+        CHECK_PARSER_RESULT(ParserCParseDeclSpec(parser, C_DECL_SPEC_NONE, &spec));
+
+        // Anonymous struct or union member (C11), its members stay with their
+        // own owner. The lowering gets a member without name or width, so
+        // it knows the layout has a hole it cannot size.
+        if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_SEMICOLON)) {
+            if (parser->module) {
+                ASTNodeId node;
+                CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_VARIABLE_DECL, AST_SYMBOL_KIND_MEMBER,
+                    ASTParserTokenIndex(parser), AST_NODE_ID_NONE, AST_SYMBOL_ID_NONE, &node));
+                CHECK_PARSER_RESULT(ASTParserScratchPush(parser, node));
+            }
+
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            continue;
+        }
+
+        for (;;) {
+            ParserCDeclarator declarator;
+            memset(&declarator, 0, sizeof(declarator));
+            declarator.nameToken = ASTParserTokenIndex(parser);
+            declarator.type = spec.type;
+
+            // `: width` alone is an unnamed bit-field
+            if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COLON))
+                CHECK_PARSER_RESULT(ParserCParseDeclarator(parser, spec.type, C_DECLARATOR_NAMED, &declarator));
+
+            ASTNodeId width = AST_NODE_ID_NONE;
+            if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COLON)) {
+                CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+                CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_CONDITIONAL, &width));
+            }
+
+            ASTSymbolId member = AST_SYMBOL_ID_NONE;
+            if (declarator.name != PARSER_IDENTIFIER_NONE) {
+                ParserResult result = ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_MEMBER, declarator.name,
+                    AST_SYMBOL_KIND_MEMBER, owner, AST_NODE_ID_NONE, &member);
+                if (result != PARSER_RESULT_SUCCESS)
+                    return ASTParserErrorAt(parser, result, declarator.nameToken);
+
+                ASTSymbolTable_SetType(parser->symbols, member, declarator.type);
+            }
+
+            ASTNodeId node;
+            CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_VARIABLE_DECL, AST_SYMBOL_KIND_MEMBER,
+                declarator.nameToken, width, member, &node));
+            ASTSymbolTable_SetNode(parser->symbols, member, node);
+            CHECK_PARSER_RESULT(ASTParserScratchPush(parser, node));
+
+            if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA))
+                break;
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        }
+
+        CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_SEMICOLON, PARSER_ERROR_MISSING_SEMICOLON));
+    }
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    return ASTParserAddScratchList(parser, base,
+        kind == AST_TYPE_KIND_UNION ? AST_NODE_TYPE_UNION_DECL : AST_NODE_TYPE_STRUCT_DECL, 0, open, id);
+}
+
+/* `[ static? qualifiers* size? ]` */
+static ParserResult ParserCParseArraySuffix(ASTParser parser)
+{
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    bool isStatic = false;
+    while (ParserCIsKeywordIn(ASTParserPeek(parser), C_TYPE_QUALIFIER_KEYWORDS | C_KEYWORD_BIT(C_KEYWORD_STATIC))) {
+        isStatic |= ASTParserIsKeyword(ASTParserPeek(parser), C_KEYWORD_STATIC);
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+
+    uint32_t sizeType = C_ARRAY_SIZE_UNSPECIFIED;
+    uint32_t value = 0;
+    uint32_t flags = AST_TYPE_FLAG_NONE;
+
+    if (ParserCIsStar(ASTParserPeek(parser)) && ASTParserIsPunctuation(ASTParserPeekN(parser, 1), PUNCTUATION_RBRACKET)) {
+        // [*], variable length of unspecified size
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        sizeType = C_ARRAY_SIZE_VARIABLE;
+    }
+    else if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RBRACKET)) {
+        ASTNodeId size;
+        CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_ASSIGNMENT, &size));
+
+        // Anything but a constant length is kept as its expression.
+        // Negative lengths are sign extended, so they fail the range check.
+        ParserCConstant length;
+        if (ParserCGetConstant(parser, size, &length)) {
+            if (length.value > UINT32_MAX)
+                return ASTParserErrorAt(parser, PARSER_ERROR_SYNTAX_ERROR, ASTTree_GetMainToken(parser->tree, size));
+
+            sizeType = isStatic ? C_ARRAY_SIZE_STATIC : C_ARRAY_SIZE_FIXED;
+            value = (uint32_t)length.value;
+            flags = AST_TYPE_FLAG_SIZED;
+        }
+        else {
+            sizeType = C_ARRAY_SIZE_VARIABLE;
+            value = size;
+        }
+    }
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RBRACKET, PARSER_ERROR_UNCLOSED_BRACKET));
+
+    return ParserCPushDerivation(parser, C_DERIVE_ARRAY, sizeType, value, flags);
+}
+
+/* Parameter types are adjusted: arrays and functions become pointers (C11 6.7.6.3) */
+static ParserResult ParserCAdjustParameterType(ASTParser parser, ASTTypeId type, ASTTypeId* adjusted)
+{
+    const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+
+    if (info->kind == AST_TYPE_KIND_ARRAY)
+        return ASTTypeTable_GetPointer(parser->types, info->base, 0, adjusted);
+
+    if (info->kind == AST_TYPE_KIND_FUNCTION)
+        return ASTTypeTable_GetPointer(parser->types, type, 0, adjusted);
+
+    *adjusted = type;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static ParserResult ParserCParseParameters(ASTParser parser)
+{
+    for (;;) {
+        if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_ELLIPSIS))
+            return PARSER_RESULT_SUCCESS;
+
+        uint32_t first = ASTParserTokenIndex(parser);
+
+        ParserCDeclSpec spec;
+        CHECK_PARSER_RESULT(ParserCParseDeclSpec(parser, C_DECL_SPEC_STORAGE, &spec));
+
+        ParserCDeclarator declarator;
+        CHECK_PARSER_RESULT(ParserCParseDeclarator(parser, spec.type, C_DECLARATOR_ANY, &declarator));
+
+        ASTTypeId type;
+        CHECK_PARSER_RESULT(ParserCAdjustParameterType(parser, declarator.type, &type));
+
+        ASTSymbolId symbol = AST_SYMBOL_ID_NONE;
+        if (declarator.name != PARSER_IDENTIFIER_NONE) {
+            ParserResult result = ASTSymbolTable_Declare(parser->symbols, AST_NAMESPACE_ORDINARY, declarator.name,
+                AST_SYMBOL_KIND_PARAMETER, 0, AST_NODE_ID_NONE, &symbol);
+            if (result != PARSER_RESULT_SUCCESS)
+                return ASTParserErrorAt(parser, result, declarator.nameToken);
+
+            ASTSymbolTable_SetType(parser->symbols, symbol, type);
+        }
+
+        ASTNodeId node;
+        CHECK_PARSER_RESULT(ASTParserAddNode(parser, AST_NODE_TYPE_PARAMETER_DECL, 0,
+            symbol ? declarator.nameToken : first, type, symbol, &node));
+        ASTSymbolTable_SetNode(parser->symbols, symbol, node);
+        CHECK_PARSER_RESULT(ASTParserScratchPush(parser, node));
+
+        if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_COMMA))
+            return PARSER_RESULT_SUCCESS;
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+}
+
+/* `( parameter-type-list? )`, the parameters go out of scope at the `)` */
+static ParserResult ParserCParseFunctionSuffix(ASTParser parser)
+{
+    uint32_t open = ASTParserTokenIndex(parser);
+    uint32_t base = parser->scratchCount;
+    uint32_t flags = AST_TYPE_FLAG_NONE;
+
+    CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+    if (ASTParserIsKeyword(ASTParserPeek(parser), C_KEYWORD_VOID) &&
+        ASTParserIsPunctuation(ASTParserPeekN(parser, 1), PUNCTUATION_RPAREN)) {
+        // (void), a prototype without parameters
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        flags = AST_TYPE_FLAG_PROTOTYPE;
+    }
+    else if (!ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_RPAREN)) {
+        flags = AST_TYPE_FLAG_PROTOTYPE;
+
+        ASTScope scope;
+        CHECK_PARSER_RESULT(ASTSymbolTable_PushScope(parser->symbols, AST_SCOPE_KIND_PROTOTYPE, &scope));
+
+        ParserResult result = ParserCParseParameters(parser);
+        if (result == PARSER_RESULT_SUCCESS && ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_ELLIPSIS)) {
+            flags |= AST_TYPE_FLAG_VARIADIC;
+            result = ASTParserAdvance(parser);
+        }
+
+        ASTSymbolTable_PopScope(parser->symbols, scope);
+        CHECK_PARSER_RESULT(result);
+    }
+
+    CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+
+    ASTNodeId params;
+    CHECK_PARSER_RESULT(ASTParserAddScratchList(parser, base, AST_NODE_TYPE_FUNCTION_TYPE, 0, open, &params));
+
+    return ParserCPushDerivation(parser, C_DERIVE_FUNCTION, flags, params, 0);
+}
+
+/* Does the `(` at the current token open a nested declarator rather than parameters */
+static bool ParserCIsNestedDeclarator(ASTParser parser, uint32_t flags)
+{
+    const struct LexerToken_T* next = ASTParserPeekN(parser, 1);
+
+    if (ParserCIsStar(next) || ASTParserIsPunctuation(next, PUNCTUATION_LPAREN) ||
+        ASTParserIsPunctuation(next, PUNCTUATION_LBRACKET))
+        return true;
+
+    if (next->flags == TOKEN_TYPE_IDENTIFIER && !(flags & C_DECLARATOR_ABSTRACT))
+        return !ParserCIsTypeNameAt(parser, 1);
+
+    return false;
+}
+
+/* One nesting level: pointers, the direct declarator, then suffixes */
+static ParserResult ParserCParseDeclaratorLevel(ASTParser parser, uint32_t flags, ParserCDeclarator* declarator)
+{
+    // ===== POINTERS =====
+    while (ParserCIsStar(ASTParserPeek(parser))) {
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+
+        uint32_t qualifiers = 0;
+        while (ParserCIsKeywordIn(ASTParserPeek(parser), C_TYPE_QUALIFIER_KEYWORDS)) {
+            qualifiers |= s_ParserCKeywordQualifiers[ASTParserPeek(parser)->value];
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        }
+
+        CHECK_PARSER_RESULT(ParserCPushDerivation(parser, C_DERIVE_POINTER, qualifiers & C_TYPE_QUALIFIERS, 0, 0));
+    }
+
+    // ===== DIRECT DECLARATOR =====
+    uint32_t inner = parser->scratchCount;
+    LexerToken token = LexerPeekN(parser->lexer, 0);
+
+    if (token && token->flags == TOKEN_TYPE_IDENTIFIER && !(flags & C_DECLARATOR_ABSTRACT)) {
+        declarator->nameToken = ASTParserTokenIndex(parser);
+        CHECK_PARSER_RESULT(ASTParserTokenName(parser, token, &declarator->name));
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+    }
+    else if (ASTParserIsPunctuation(ASTParserPeek(parser), PUNCTUATION_LPAREN) && ParserCIsNestedDeclarator(parser, flags)) {
+        CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+        CHECK_PARSER_RESULT(ParserCParseDeclaratorLevel(parser, flags, declarator));
+        CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+    }
+    else if (flags & C_DECLARATOR_NAMED) {
+        return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+    }
+
+    // ===== SUFFIXES =====
+    uint32_t suffixes = parser->scratchCount;
+
+    for (;;) {
+        const struct LexerToken_T* next = ASTParserPeek(parser);
+
+        if (ASTParserIsPunctuation(next, PUNCTUATION_LBRACKET))
+            CHECK_PARSER_RESULT(ParserCParseArraySuffix(parser));
+        else if (ASTParserIsPunctuation(next, PUNCTUATION_LPAREN))
+            CHECK_PARSER_RESULT(ParserCParseFunctionSuffix(parser));
+        else
+            break;
+    }
+
+    // Pointers apply first, then the suffixes right to left, then the inner
+    // declarator: [inner][suffixes] becomes [reversed suffixes][inner]
+    ParserCReverseDerivations(parser, inner, parser->scratchCount);
+    ParserCReverseDerivations(parser, inner + (parser->scratchCount - suffixes), parser->scratchCount);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCGetBasicType(
+    uint32_t specifiers,
+    ParserCBasicType* basic)
+{
+    if (!basic)
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint32_t sign = specifiers & (C_SPEC(SIGNED) | C_SPEC(UNSIGNED));
+    bool isUnsigned = sign == C_SPEC(UNSIGNED);
+
+    if (sign == (C_SPEC(SIGNED) | C_SPEC(UNSIGNED)))
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    switch (specifiers & ~sign) {
+    case C_SPEC(CHAR):
+        *basic = !sign ? C_BASIC_TYPE_CHAR : isUnsigned ? C_BASIC_TYPE_UNSIGNED_CHAR : C_BASIC_TYPE_SIGNED_CHAR;
+        return PARSER_RESULT_SUCCESS;
+
+    case 0:                         // `unsigned` alone is unsigned int
+        if (!sign)
+            return PARSER_ERROR_SYNTAX_ERROR;
+        *basic = isUnsigned ? C_BASIC_TYPE_UNSIGNED_INT : C_BASIC_TYPE_INT;
+        return PARSER_RESULT_SUCCESS;
+
+    case C_SPEC(INT):
+        *basic = isUnsigned ? C_BASIC_TYPE_UNSIGNED_INT : C_BASIC_TYPE_INT;
+        return PARSER_RESULT_SUCCESS;
+
+    case C_SPEC(SHORT):
+    case C_SPEC(SHORT) | C_SPEC(INT):
+        *basic = isUnsigned ? C_BASIC_TYPE_UNSIGNED_SHORT : C_BASIC_TYPE_SHORT;
+        return PARSER_RESULT_SUCCESS;
+
+    case C_SPEC(LONG):
+    case C_SPEC(LONG) | C_SPEC(INT):
+        *basic = isUnsigned ? C_BASIC_TYPE_UNSIGNED_LONG : C_BASIC_TYPE_LONG;
+        return PARSER_RESULT_SUCCESS;
+
+    case C_SPEC(LONG_LONG):
+    case C_SPEC(LONG_LONG) | C_SPEC(INT):
+        *basic = isUnsigned ? C_BASIC_TYPE_UNSIGNED_LONG_LONG : C_BASIC_TYPE_LONG_LONG;
+        return PARSER_RESULT_SUCCESS;
+
+    default:
+        break;
+    }
+
+    // The remaining types take no sign
+    if (sign)
+        return PARSER_ERROR_SYNTAX_ERROR;
+
+    switch (specifiers) {
+    case C_SPEC(VOID):                                  *basic = C_BASIC_TYPE_VOID; break;
+    case C_SPEC(BOOL):                                  *basic = C_BASIC_TYPE_BOOL; break;
+    case C_SPEC(FLOAT):                                 *basic = C_BASIC_TYPE_FLOAT; break;
+    case C_SPEC(DOUBLE):                                *basic = C_BASIC_TYPE_DOUBLE; break;
+    case C_SPEC(LONG) | C_SPEC(DOUBLE):                 *basic = C_BASIC_TYPE_LONG_DOUBLE; break;
+    case C_SPEC(FLOAT) | C_SPEC(COMPLEX):               *basic = C_BASIC_TYPE_FLOAT_COMPLEX; break;
+    case C_SPEC(DOUBLE) | C_SPEC(COMPLEX):              *basic = C_BASIC_TYPE_DOUBLE_COMPLEX; break;
+    case C_SPEC(LONG) | C_SPEC(DOUBLE) | C_SPEC(COMPLEX): *basic = C_BASIC_TYPE_LONG_DOUBLE_COMPLEX; break;
+    default:
+        return PARSER_ERROR_SYNTAX_ERROR;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseDeclSpec(
+    ASTParser parser,
+    uint32_t flags,
+    ParserCDeclSpec* spec)
+{
+    memset(spec, 0, sizeof(*spec));
+
+    uint32_t qualifiers = 0;
+    ASTTypeId named = AST_TYPE_ID_NONE;     // Tagged, typedef or _Atomic( ) type
+
+    for (;;) {
+        LexerToken token = LexerPeekN(parser->lexer, 0);
+        if (!token)
+            return PARSER_ERROR_NO_MEMORY;
+
+        // ===== TYPEDEF NAME =====
+        // Only before any other type specifier, `T x` and `int T` both name a declarator after
+        if (token->flags == TOKEN_TYPE_IDENTIFIER) {
+            if (spec->specifiers || named)
+                break;
+
+            ParserIdentifierId name;
+            CHECK_PARSER_RESULT(ASTParserTokenName(parser, token, &name));
+            if (!ASTParserIsTypedefName(parser, name))
+                break;
+
+            ASTSymbolId symbol = ASTSymbolTable_Lookup(parser->symbols, AST_NAMESPACE_ORDINARY, name, 0);
+            named = ASTSymbolTable_GetSymbol(parser->symbols, symbol)->type;
+            spec->typeSpec = C_TYPE_SPEC_TYPEDEF_NAME;
+
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            continue;
+        }
+
+        if (token->flags != TOKEN_TYPE_KEYWORD || token->value >= 64)
+            break;
+
+        uint32_t keyword = token->value;
+        uint64_t bit = C_KEYWORD_BIT(keyword);
+
+        // ===== _Atomic ( type-name ) =====
+        if (keyword == C_KEYWORD_ATOMIC && ASTParserIsPunctuation(ASTParserPeekN(parser, 1), PUNCTUATION_LPAREN)) {
+            if (spec->specifiers || named)
+                return ASTParserError(parser, PARSER_ERROR_SYNTAX_ERROR);
+
+            ASTNodeId typeName;
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ParserCParseTypeName(parser, &typeName));
+            CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+
+            named = ASTTree_GetData(parser->tree, typeName).lhs;
+            qualifiers |= C_TYPE_QUAL_ATOMIC;
+            continue;
+        }
+
+        // ===== QUALIFIERS =====
+        if (bit & C_TYPE_QUALIFIER_KEYWORDS) {
+            qualifiers |= s_ParserCKeywordQualifiers[keyword];
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            continue;
+        }
+
+        // ===== STORAGE CLASS AND FUNCTION SPECIFIERS =====
+        if (bit & (C_STORAGE_CLASS_KEYWORDS | C_FUNCTION_SPECIFIER_KEYWORDS)) {
+            if (!(flags & C_DECL_SPEC_STORAGE))
+                return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+            if (keyword == C_KEYWORD_INLINE)
+                spec->funcSpecs |= C_FUNC_SPEC_INLINE;
+            else if (keyword == C_KEYWORD_NORETURN)
+                spec->funcSpecs |= C_FUNC_SPEC_NORETURN;
+            else if (keyword != C_KEYWORD_THREAD_LOCAL) {
+                // _Thread_local combines with static and extern, the others stand alone
+                if (spec->storageClass != C_STORAGE_CLASS_NONE)
+                    return ASTParserError(parser, PARSER_ERROR_SYNTAX_ERROR);
+                spec->storageClass = (ParserCStorageClass)s_ParserCKeywordStorageClasses[keyword];
+            }
+
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            continue;
+        }
+
+        // ===== _Alignas, no effect on the type =====
+        if (keyword == C_KEYWORD_ALIGNAS) {
+            ASTNodeId alignment;
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_LPAREN, PARSER_ERROR_UNEXPECTED_TOKEN));
+
+            if (ParserCIsTypeNameAt(parser, 0))
+                CHECK_PARSER_RESULT(ParserCParseTypeName(parser, &alignment));
+            else
+                CHECK_PARSER_RESULT(ParserCParseExpression(parser, AST_NODE_ID_NONE, C_PREC_CONDITIONAL, &alignment));
+
+            CHECK_PARSER_RESULT(ASTParserExpectPunctuation(parser, PUNCTUATION_RPAREN, PARSER_ERROR_UNCLOSED_PARENTHESIS));
+            continue;
+        }
+
+        // ===== BASIC TYPE SPECIFIERS =====
+        if (bit & C_BASIC_SPECIFIER_KEYWORDS) {
+            uint32_t specifier = s_ParserCKeywordSpecifiers[keyword];
+
+            if (specifier == C_TYPE_SPEC_LONG && (spec->specifiers & C_SPEC(LONG))) {
+                spec->specifiers &= ~C_SPEC(LONG);
+                specifier = C_TYPE_SPEC_LONG_LONG;
+            }
+
+            if (named || (spec->specifiers & PARSER_BIT(specifier)))
+                return ASTParserError(parser, PARSER_ERROR_SYNTAX_ERROR);
+
+            spec->specifiers |= PARSER_BIT(specifier);
+            spec->typeSpec = (ParserCTypeSpecifier)specifier;
+
+            CHECK_PARSER_RESULT(ASTParserAdvance(parser));
+            continue;
+        }
+
+        // ===== STRUCT, UNION, ENUM =====
+        if (bit & C_TAG_KEYWORDS) {
+            if (named || spec->specifiers)
+                return ASTParserError(parser, PARSER_ERROR_SYNTAX_ERROR);
+
+            CHECK_PARSER_RESULT(ParserCParseTagSpecifier(parser, flags, &spec->typeSpec, &named));
+            continue;
+        }
+
+        break;
+    }
+
+    // ===== TYPE =====
+    qualifiers &= C_TYPE_QUALIFIERS;
+    spec->typeQualifiers = (ParserCTypeQualifier)qualifiers;
+
+    if (named != AST_TYPE_ID_NONE) {
+        spec->specifiers |= PARSER_BIT(spec->typeSpec);
+        return ASTTypeTable_GetQualified(parser->types, named, qualifiers, &spec->type);
+    }
+
+    if (spec->specifiers == 0)
+        return ASTParserError(parser, PARSER_ERROR_UNEXPECTED_TOKEN);
+
+    ParserCBasicType basic;
+    if (ParserCGetBasicType(spec->specifiers, &basic) != PARSER_RESULT_SUCCESS)
+        return ASTParserError(parser, PARSER_ERROR_SYNTAX_ERROR);
+
+    return ASTTypeTable_GetBasic(parser->types, basic, qualifiers, &spec->type);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseDeclarator(
+    ASTParser parser,
+    ASTTypeId base,
+    uint32_t flags,
+    ParserCDeclarator* declarator)
+{
+    memset(declarator, 0, sizeof(*declarator));
+    declarator->nameToken = ASTParserTokenIndex(parser);
+
+    uint32_t start = parser->scratchCount;
+    CHECK_PARSER_RESULT(ParserCParseDeclaratorLevel(parser, flags, declarator));
+
+    // ===== DERIVE THE TYPE =====
+    ASTTypeId type = base;
+    uint32_t end = parser->scratchCount;
+    ParserResult result = PARSER_RESULT_SUCCESS;
+
+    for (uint32_t i = start; i < end && result == PARSER_RESULT_SUCCESS; i += C_DERIVATION_WORDS) {
+        uint32_t kind = parser->scratch[i] & 0xFF;
+        uint32_t aux = parser->scratch[i] >> 8;
+        uint32_t value = parser->scratch[i + 1];
+        uint32_t extra = parser->scratch[i + 2];
+
+        const ASTTypeInfo* info = ASTTypeTable_Get(parser->types, type);
+        declarator->params = AST_NODE_ID_NONE;
+
+        switch (kind) {
+        case C_DERIVE_POINTER:
+            result = ASTTypeTable_GetPointer(parser->types, type, aux, &type);
+            break;
+
+        case C_DERIVE_ARRAY:
+            // No arrays of functions (C11 6.7.6.2)
+            if (info->kind == AST_TYPE_KIND_FUNCTION)
+                return ASTParserErrorAt(parser, PARSER_ERROR_SYNTAX_ERROR, declarator->nameToken);
+            result = ASTTypeTable_GetArray(parser->types, type, aux, value, extra, &type);
+            break;
+
+        case C_DERIVE_FUNCTION: {
+            // Functions return neither arrays nor functions (C11 6.7.6.3)
+            if (info->kind == AST_TYPE_KIND_ARRAY || info->kind == AST_TYPE_KIND_FUNCTION)
+                return ASTParserErrorAt(parser, PARSER_ERROR_SYNTAX_ERROR, declarator->nameToken);
+
+            // Stage the parameter types above the derivations
+            uint32_t count = ASTTree_GetChildCount(parser->tree, value);
+            for (uint32_t p = 0; p < count && result == PARSER_RESULT_SUCCESS; p++)
+                result = ASTParserScratchPush(parser, ASTTree_GetData(parser->tree, ASTTree_GetChild(parser->tree, value, p)).lhs);
+
+            if (result == PARSER_RESULT_SUCCESS)
+                result = ASTTypeTable_GetFunction(parser->types, type, parser->scratch + end, count, aux, &type);
+
+            parser->scratchCount = end;
+            declarator->params = value;
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    parser->scratchCount = start;
+    declarator->type = type;
+
+    return result;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL ParserCParseTypeName(
+    ASTParser parser,
+    ASTNodeId* id)
+{
+    uint32_t first = ASTParserTokenIndex(parser);
+
+    ParserCDeclSpec spec;
+    CHECK_PARSER_RESULT(ParserCParseDeclSpec(parser, C_DECL_SPEC_NONE, &spec));
+
+    ParserCDeclarator declarator;
+    CHECK_PARSER_RESULT(ParserCParseDeclarator(parser, spec.type, C_DECLARATOR_ABSTRACT, &declarator));
+
+    return ASTParserAddNode(parser, AST_NODE_TYPE_TYPE_SPECIFIER, (uint16_t)spec.typeSpec, first, declarator.type, 0, id);
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -25,6 +25,7 @@ struct FileBuffer_T {
 	ParserSize size;               // Size of the file in bytes
 
 	FileBufferCursor Cursor;
+	FileBufferEncoding encoding;   // Encoding from the creation config
 
 #if defined(PLATFORM_WINDOWS)
 	HANDLE fileHandle;         // Windows file handle
@@ -49,10 +50,12 @@ PARSER_ATTR ParserResult PARSER_CALL CreateFileBuffer(
         return PARSER_ERROR_INVALID_ARG;
     }
 
-    FileBuffer hdl = PARSER_MALLOC(sizeof(struct FileBuffer_T), NULL);
+    FileBuffer hdl = PARSER_MALLOC(sizeof(struct FileBuffer_T), 0);
     if (!hdl)
         return PARSER_ERROR_INVALID_ARG;
 
+    hdl->encoding = cfg->encoding;
+
 #if defined(PLATFORM_WINDOWS)
     // Open file for reading
     hdl->fileHandle = CreateFileA(
@@ -114,7 +117,7 @@ PARSER_ATTR ParserResult PARSER_CALL CreateFileBuffer(
 
 #elif defined(PLATFORM_LINUX)
     // Open file
-    hdl->fileDescriptor = open(path, O_RDONLY);
+    hdl->fileDescriptor = open(cfg->filePath, O_RDONLY);
     if (hdl->fileDescriptor == -1) {
         return PARSER_ERROR_INVALID_FILE;
     }
@@ -157,7 +160,7 @@ PARSER_ATTR ParserResult PARSER_CALL CreateFileBuffer(
 }
 
 
-PARSER_ATTR inline ParserResult PARSER_CALL DestroyFileBuffer(
+PARSER_ATTR ParserResult PARSER_CALL DestroyFileBuffer(
 	FileBuffer file)
 {
 
@@ -220,7 +223,20 @@ PARSER_ATTR int32_t PARSER_CALL AdvanceFileBuffer(FileBuffer file)
     return (unsigned char)*file->Cursor.cur;  // Cast to unsigned to get 0-255
 }
 
-PARSER_ATTR inline const FileBufferCursor* PARSER_CALL GetFileBufferCursor(
+PARSER_ATTR int32_t PARSER_CALL PeekFileBuffer(FileBuffer file)
+{
+    if (!file) {
+        return FILE_BUFFER_EOF;
+    }
+
+    if (file->Cursor.cur >= file->Cursor.end) {
+        return FILE_BUFFER_EOF;
+    }
+
+    return (unsigned char)*file->Cursor.cur;
+}
+
+PARSER_ATTR const FileBufferCursor* PARSER_CALL GetFileBufferCursor(
 	FileBuffer file)
 {
     if (!file)
@@ -228,3 +244,12 @@ PARSER_ATTR inline const FileBufferCursor* PARSER_CALL GetFileBufferCursor(
 
     return &file->Cursor;
 }
+
+PARSER_ATTR FileBufferEncoding PARSER_CALL GetFileBufferEncoding(
+	FileBuffer file)
+{
+    if (!file)
+        return FILE_ENCODING_UNKNOWN;
+
+    return file->encoding;
+}
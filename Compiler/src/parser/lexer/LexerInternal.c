@@ -3,16 +3,33 @@
 // ------------------------------------------------------------------------------------------------
 
 #include "LexerInternal.h"
+#include "../ParserArray.h"
 
 #include "parser/Results.h"
 
+#include <string.h>
+
 // ------------------------------------------------------------------------------------------------
 // Public definitions
 // ------------------------------------------------------------------------------------------------
 
-PARSER_ATTR static LexerToken PARSER_CALL Lexer_GenerateNextToken(Lexer* lexer);
+PARSER_ATTR void PARSER_CALL LexerInitState(
+    Lexer lexer,
+    FileBuffer file,
+    const LexerLanguageStrategy* strategy)
+{
+    memset(lexer, 0, sizeof(struct Lexer_T));
 
+    lexer->file = file;
+    lexer->cursor = *GetFileBufferCursor(file);
+    lexer->limit = lexer->cursor.end;
+    lexer->column = 0;
+    lexer->line = 0;
 
+    lexer->encoding = GetFileBufferEncoding(file);
+    lexer->strictMode = false;
+    lexer->strategy = strategy;
+}
 
 PARSER_ATTR ParserResult PARSER_CALL CreateLexer(
     FileBuffer file,
@@ -22,29 +39,18 @@ PARSER_ATTR ParserResult PARSER_CALL CreateLexer(
     if (!file || !cfg || !lexer)
         return PARSER_ERROR_INVALID_ARG;
 
-    Lexer hdl = PARSER_MALLOC(sizeof(struct Lexer_T), NULL);
-    if (!hdl)
-        return PARSER_ERROR_NO_MEMORY;
-
-   
-    hdl->file = file;
-    hdl->column = 0;
-    hdl->line = 0;
-
-
-    // TODO: Implement lookahead allocation
-    hdl->currentToken = NULL;
-    hdl->peekToken = NULL;
-
-    hdl->encoding = GetFileBufferEncoding(file);
-    hdl->strictMode = false;
-
-    // Setting the language strategy. The language strategy is essentially the 
+    // Setting the language strategy. The language strategy is essentially the
     // syntax of the to-be-compiled file
     if (!cfg->strategy) {
         return PARSER_ERROR_INVALID_STRATEGY;
     }
-    hdl->strategy = cfg->strategy;
+
+    Lexer hdl = PARSER_MALLOC(sizeof(struct Lexer_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    LexerInitState(hdl, file, cfg->strategy);
+    hdl->ringCapacity = cfg->lookaheadCapacity ? cfg->lookaheadCapacity : LEXER_LOOKAHEAD_DEFAULT_CAPACITY;
 
     *lexer = hdl;
 
@@ -64,162 +70,792 @@ PARSER_ATTR ParserResult PARSER_CALL LexerNextToken(
         return PARSER_ERROR_INVALID_ARG;
     }
 
-    // ===== CHECK FOR ERROR STATE =====
-    if (lexer->hasError) {
-        return PARSER_RESULT_ERROR;
-    }
-
-    // ===== SHIFT TOKEN WINDOW (lazy lookahead) =====
-    // In lazy lexing with 2-token lookahead:
-    // currentToken -> return to parser
-    // peekToken -> becomes new currentToken
-    // generate new peekToken
+    // ===== TAKE THE TOKEN AT THE CURSOR =====
+    // The token at `position` is scanned ahead by the ring refill together
+    // with up to a batch of followers. The returned slot stays untouched
+    // until the next call since the refill keeps position - 1.
+    CHECK_PARSER_RESULT(LexerRingRequire(lexer, lexer->position));
 
-    *token = lexer->currentToken;
+    struct LexerToken_T* next = LexerRingAt(lexer, lexer->position);
+    *token = next;
 
-    // Shift lookahead window
-    lexer->currentToken = lexer->peekToken;
-    lexer->peekToken = Lexer_GenerateNextToken(lexer);
+    // The EOF or error token is returned again on every later call
+    if (lexer->position < lexer->filled)
+        lexer->position++;
 
     // Update statistics
     lexer->tokenCount++;
 
+    return next->flags == TOKEN_TYPE_ERROR ? lexer->errorResult : PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR LexerToken PARSER_CALL LexerCurrentToken(
+    const Lexer lexer)
+{
+    return LexerPeekN(lexer, 0);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerLookAheadToken(
+    const Lexer lexer,
+    LexerToken* token)
+{
+    if (!lexer || !token)
+        return PARSER_ERROR_INVALID_ARG;
+
+    *token = LexerPeekN(lexer, 1);
+
+    return *token ? PARSER_RESULT_SUCCESS : PARSER_ERROR_NO_MEMORY;
+}
+
+PARSER_ATTR LexerToken PARSER_CALL LexerPeekN(
+    const Lexer lexer,
+    uint32_t k)
+{
+    if (!lexer)
+        return NULL;
+
+    if (LexerRingRequire(lexer, lexer->position + k) != PARSER_RESULT_SUCCESS)
+        return NULL;
+
+    return LexerRingAt(lexer, lexer->position + k);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerMark(
+    Lexer lexer,
+    LexerCheckpoint* checkpoint)
+{
+    if (!lexer || !checkpoint)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (lexer->markCount == LEXER_MAX_CHECKPOINTS)
+        return PARSER_ERROR_NO_MEMORY;
+
+    checkpoint->position = lexer->position;
+    checkpoint->depth = lexer->markCount;
+    lexer->marks[lexer->markCount++] = lexer->position;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* True when the checkpoint is still active */
+static bool LexerIsActiveMark(const Lexer lexer, const LexerCheckpoint* checkpoint)
+{
+    return checkpoint->depth < lexer->markCount && lexer->marks[checkpoint->depth] == checkpoint->position;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerRewind(
+    Lexer lexer,
+    const LexerCheckpoint* checkpoint)
+{
+    if (!lexer || !checkpoint || !LexerIsActiveMark(lexer, checkpoint))
+        return PARSER_ERROR_INVALID_ARG;
+
+    // The tokens are still in the ring, nothing is scanned again
+    lexer->position = checkpoint->position;
+    lexer->markCount = checkpoint->depth;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerReleaseMark(
+    Lexer lexer,
+    const LexerCheckpoint* checkpoint)
+{
+    if (!lexer || !checkpoint || !LexerIsActiveMark(lexer, checkpoint))
+        return PARSER_ERROR_INVALID_ARG;
+
+    lexer->markCount = checkpoint->depth;
+
     return PARSER_RESULT_SUCCESS;
 }
 
+PARSER_ATTR ParserResult PARSER_CALL LexerSeek(
+    Lexer lexer,
+    uint32_t position)
+{
+    if (!lexer)
+        return PARSER_ERROR_INVALID_ARG;
+
+    // Moving within [position, filled] needs no checkpoint, anything
+    // earlier only survives behind the oldest one
+    uint32_t keep = lexer->position;
+    if (lexer->markCount && lexer->marks[0] < keep)
+        keep = lexer->marks[0];
+
+    if (position < keep || position > lexer->filled)
+        return PARSER_ERROR_INVALID_ARG;
+
+    lexer->position = position;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Hot loop
+// ------------------------------------------------------------------------------------------------
+//
+// The trim and scan functions are templates over `preserve`. They are
+// instantiated once with trivia recording compiled out and once with it
+// compiled in, so the default path does not test the preservation flags
+// per byte or per token.
+
+PARSER_ATTR void PARSER_CALL LexerPushTrivia(
+    Lexer lexer,
+    const uint8_t* from,
+    const uint8_t* to,
+    LexerTriviaKind kind)
+{
+    LexerTrivia range;
+    range.offset = (uint32_t)(from - lexer->cursor.begin);
+    range.length = (uint32_t)(to - from);
+    range.kind = kind;
+    range.tokenIndex = lexer->scanIndex;
+
+    if (LexerTriviaArrayPush(&lexer->trivia, &range) != PARSER_RESULT_SUCCESS)
+        LexerSetError(lexer, PARSER_ERROR_NO_MEMORY, "Out of memory recording trivia");
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerPushLiteral(
+    Lexer lexer,
+    const LexerLiteral* literal,
+    uint32_t* index)
+{
+    uint32_t next = lexer->literals.count;
+
+    CHECK_PARSER_RESULT(LexerLiteralArrayPush(&lexer->literals, literal));
+    *index = next;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+ML_FORCE_INLINE void LexerTrimTrivia(
+    const Lexer lexer,
+    const bool preserve)
+{
+    const LexerLanguageStrategy* strategy = lexer->strategy;
+    const uint8_t* whitespace = NULL;   // Start of the pending whitespace run
+
+    // Whitespace never crosses the chunk limit, comments are consumed
+    // whole even when they run into the next chunk
+    while (lexer->cursor.cur < lexer->limit && !lexer->hasError) {
+        uint8_t c = *lexer->cursor.cur;
+
+        if (strategy->isWhitespace(c)) {
+            if (preserve && !whitespace)
+                whitespace = lexer->cursor.cur;
+
+            // Update line/column tracking
+            if (c == '\n') {
+                lexer->line++;
+                lexer->column = 0;
+            }
+            else if (c == '\t') {
+                lexer->column += 4;  // Tab = 4 spaces (configurable)
+            }
+            else {
+                lexer->column++;
+            }
+
+            // Advance
+            lexer->cursor.cur++;
+            continue;
+        }
+
+        if (preserve && whitespace) {
+            if (lexer->preserveWhitespace)
+                LexerPushTrivia(lexer, whitespace, lexer->cursor.cur, LEXER_TRIVIA_WHITESPACE);
+            whitespace = NULL;
+        }
+
+        const uint8_t* start = lexer->cursor.cur;
+        const char* text = (const char*)start;
+        size_t remaining = LexerRemaining(lexer);
+
+        if (strategy->isLineComment(text, remaining)) {
+            strategy->parseLineComments(lexer);
+            if (preserve && lexer->preserveComments)
+                LexerPushTrivia(lexer, start, lexer->cursor.cur, LEXER_TRIVIA_LINE_COMMENT);
+            continue;
+        }
+
+        if (strategy->isBlockComment(text, remaining)) {
+            strategy->parseBlockComments(lexer);
+            if (preserve && lexer->preserveComments)
+                LexerPushTrivia(lexer, start, lexer->cursor.cur, LEXER_TRIVIA_BLOCK_COMMENT);
+            continue;
+        }
+
+        break;
+    }
+
+    if (preserve && whitespace && lexer->preserveWhitespace)
+        LexerPushTrivia(lexer, whitespace, lexer->cursor.cur, LEXER_TRIVIA_WHITESPACE);
+}
+
 /**
  * @brief Internal: Generate the next token from input stream
- * @note This is STATIC - called only by Lexer_NextToken
+ * @note Called by LexerNextToken, LexerTokenize and the parallel chunk workers
  */
-PARSER_ATTR static LexerToken PARSER_CALL Lexer_GenerateNextToken(Lexer lexer) {
-    //LexerToken token = { 0 };
+ML_FORCE_INLINE bool LexerScanTokenImpl(
+    Lexer lexer,
+    struct LexerToken_T* token,
+    const bool preserve)
+{
+    const LexerLanguageStrategy* strategy = lexer->strategy;
 
     // ===== SKIP WHITESPACE AND COMMENTS =====
-    LexerTrimWhitespaces(lexer);
-    
+    LexerTrimTrivia(lexer, preserve);
 
     // ===== SET TOKEN LOCATION =====
-    //token.line = lexer->line;
-    //token.column = lexer->column;
+    uint32_t line = (uint32_t)lexer->line;
+    uint32_t column = (uint32_t)lexer->column;
 
-    // ===== TOKENIZE BASED ON CHARACTER TYPE =====
-    int32_t byte = PeekFileBuffer(lexer->file);
-    char c = (char)byte;
+    LexerToken result;
 
-    // ===== STRING LITERAL =====
-    if (lexer->strategy->isStringStart(c)) {
-        return Lexer_ParseStringLiteral(lexer);
+    if (lexer->hasError) {
+        result = &lexer->scanToken;
     }
+    else if (lexer->cursor.cur >= lexer->cursor.end) {
+        result = LexerBeginToken(lexer, TOKEN_TYPE_EOF, 0, 0);
+    }
+    else if (lexer->cursor.cur >= lexer->limit) {
+        return false;
+    }
+    else {
+        // ===== TOKENIZE BASED ON CHARACTER TYPE =====
+        uint8_t c = *lexer->cursor.cur;
+
+        // ===== STRING LITERAL =====
+        if (strategy->isStringStart(c)) {
+            result = strategy->parseStringLiteral(lexer);
+        }
 
-    // ===== CHARACTER LITERAL =====
-    if (lexer->strategy->isCharStart(c)) {
-        return Lexer_ParseCharLiteral(lexer);
+        // ===== CHARACTER LITERAL =====
+        else if (strategy->isCharStart(c)) {
+            result = strategy->parseCharLiteral(lexer);
+        }
+
+        // ===== NUMERIC LITERAL =====
+        else if (strategy->isNumberStart(c)) {
+            result = strategy->parseNumericalLiteral(lexer);
+        }
+
+        // ===== IDENTIFIER OR KEYWORD =====
+        else if (strategy->isIdentifierStart(c)) {
+            result = strategy->parseIdentifier(lexer);
+        }
+
+        // ===== OPERATOR / PUNCTUATION =====
+        else if (strategy->isOperator((const char*)lexer->cursor.cur, 1) || strategy->isPunctuation(c)) {
+            result = strategy->parseOperator(lexer);
+        }
+
+        // ===== UNKNOWN CHARACTER - ERROR =====
+        else {
+            LexerBeginToken(lexer, TOKEN_TYPE_ERROR, 0, 0);
+            LexerConsume(lexer, 1);
+            result = LexerSetError(lexer, PARSER_ERROR_UNEXPECTED_TOKEN, "Unexpected character");
+        }
     }
 
-    // ===== NUMERIC LITERAL =====
-    if (lexer->strategy->isNumberStart(c)) {
-        return Lexer_ParseNumericLiteral(lexer);
+    *token = *result;
+    token->line = line;
+    token->column = column;
+
+    lexer->scanIndex++;
+
+    return true;
+}
+
+static bool LexerScanTokenPlain(Lexer lexer, struct LexerToken_T* token)
+{
+    return LexerScanTokenImpl(lexer, token, false);
+}
+
+static bool LexerScanTokenTrivia(Lexer lexer, struct LexerToken_T* token)
+{
+    return LexerScanTokenImpl(lexer, token, true);
+}
+
+PARSER_ATTR bool PARSER_CALL LexerScanToken(
+    Lexer lexer,
+    struct LexerToken_T* token)
+{
+    const LexerLanguageStrategy* strategy = lexer->strategy;
+    bool preserve = lexer->preserveWhitespace || lexer->preserveComments;
+
+    // ===== GENERATED SCANNER =====
+    if (strategy->scanToken)
+        return preserve ? strategy->scanTokenTrivia(lexer, token) : strategy->scanToken(lexer, token);
+
+    if (preserve)
+        return LexerScanTokenTrivia(lexer, token);
+
+    return LexerScanTokenPlain(lexer, token);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// Lookahead ring
+// ------------------------------------------------------------------------------------------------
+
+/* Oldest absolute token index that has to stay in the ring */
+static uint32_t LexerRingKeepFrom(const Lexer lexer)
+{
+    // The token handed out by the last LexerNextToken and every token from
+    // the oldest checkpoint on
+    uint32_t keep = lexer->position;
+    if (lexer->markCount && lexer->marks[0] < keep)
+        keep = lexer->marks[0];
+
+    return keep ? keep - 1 : 0;
+}
+
+static ParserResult LexerRingGrow(Lexer lexer, uint32_t capacity)
+{
+    uint32_t oldCapacity = lexer->ring ? lexer->ringMask + 1 : 0;
+    uint32_t newCapacity = oldCapacity ? oldCapacity : 16;
+
+    while (newCapacity < capacity || newCapacity < lexer->ringCapacity)
+        newCapacity *= 2;
+
+    struct LexerToken_T* ring = PARSER_MALLOC(sizeof(struct LexerToken_T) * newCapacity, 0);
+    if (!ring)
+        return PARSER_ERROR_NO_MEMORY;
+
+    if (lexer->ring) {
+        for (uint32_t i = LexerRingKeepFrom(lexer); i < lexer->filled; i++)
+            ring[i & (newCapacity - 1)] = lexer->ring[i & lexer->ringMask];
+        PARSER_FREE(lexer->ring);
     }
 
-    // ===== IDENTIFIER OR KEYWORD =====
-    if (lexer->strategy->isIdentifierStart(c)) {
-        return Lexer_ParseIdentifierOrKeyword(lexer);
+    lexer->ring = ring;
+    lexer->ringMask = newCapacity - 1;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Scan tokens into the ring up to absolute index `until`, stopping after EOF or an error */
+ML_FORCE_INLINE void LexerRingFill(
+    Lexer lexer,
+    uint32_t until,
+    const bool preserve,
+    PFN_LexerScanToken scanner)
+{
+    struct LexerToken_T* ring = lexer->ring;
+    uint32_t mask = lexer->ringMask;
+    uint32_t filled = lexer->filled;
+
+    while (filled < until) {
+        struct LexerToken_T* token = &ring[filled & mask];
+        if (scanner)
+            scanner(lexer, token);
+        else
+            LexerScanTokenImpl(lexer, token, preserve);
+        filled++;
+
+        if (token->flags == TOKEN_TYPE_EOF || token->flags == TOKEN_TYPE_ERROR)
+            break;
+    }
+
+    lexer->filled = filled;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerRingRequire(
+    Lexer lexer,
+    uint32_t index)
+{
+    if (index < lexer->filled)
+        return PARSER_RESULT_SUCCESS;
+
+    // Nothing follows the EOF or error token, LexerRingAt repeats it
+    if (lexer->filled > 0) {
+        uint16_t flags = lexer->ring[(lexer->filled - 1) & lexer->ringMask].flags;
+        if (flags == TOKEN_TYPE_EOF || flags == TOKEN_TYPE_ERROR)
+            return PARSER_RESULT_SUCCESS;
+    }
+
+    uint32_t keepFrom = LexerRingKeepFrom(lexer);
+    if (!lexer->ring || index - keepFrom + 1 > lexer->ringMask + 1)
+        CHECK_PARSER_RESULT(LexerRingGrow(lexer, index - keepFrom + 1));
+
+    // Refill a whole batch at once, as far as the free slots allow, so
+    // the strategy dispatch below runs once per batch and not per token
+    uint32_t until = lexer->filled + LEXER_LOOKAHEAD_REFILL_BATCH;
+    if (until < index + 1)
+        until = index + 1;
+    if (until > keepFrom + lexer->ringMask + 1)
+        until = keepFrom + lexer->ringMask + 1;
+
+    const LexerLanguageStrategy* strategy = lexer->strategy;
+    bool preserve = lexer->preserveWhitespace || lexer->preserveComments;
+
+    if (strategy->scanToken)
+        LexerRingFill(lexer, until, preserve, preserve ? strategy->scanTokenTrivia : strategy->scanToken);
+    else if (preserve)
+        LexerRingFill(lexer, until, true, NULL);
+    else
+        LexerRingFill(lexer, until, false, NULL);
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerTokenArrayReserve(
+    struct LexerTokenArray_T* tokens,
+    uint32_t capacity)
+{
+    return ParserArrayReserve((void**)&tokens->tokens, &tokens->capacity, tokens->count, capacity,
+        sizeof(struct LexerToken_T), 256);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerTriviaArrayPush(
+    struct LexerTriviaArray_T* trivia,
+    const LexerTrivia* range)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&trivia->items, &trivia->capacity, trivia->count, trivia->count + 1,
+        sizeof(LexerTrivia), 256));
+
+    trivia->items[trivia->count++] = *range;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerLiteralArrayPush(
+    struct LexerLiteralArray_T* literals,
+    const LexerLiteral* literal)
+{
+    CHECK_PARSER_RESULT(ParserArrayReserve((void**)&literals->items, &literals->capacity, literals->count,
+        literals->count + 1, sizeof(LexerLiteral), 256));
+
+    literals->items[literals->count++] = *literal;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+ML_FORCE_INLINE ParserResult LexerTokenizeLoop(
+    Lexer lexer,
+    struct LexerTokenArray_T* tokens,
+    const bool preserve,
+    PFN_LexerScanToken scanner)
+{
+    ParserResult result = PARSER_RESULT_SUCCESS;
+
+    while (result == PARSER_RESULT_SUCCESS) {
+        result = LexerTokenArrayReserve(tokens, tokens->count + 1);
+        if (result != PARSER_RESULT_SUCCESS)
+            break;
+
+        // The scanners stop without a token at the limit of a chunk
+        struct LexerToken_T* token = &tokens->tokens[tokens->count];
+        if (!(scanner ? scanner(lexer, token) : LexerScanTokenImpl(lexer, token, preserve)))
+            break;
+        tokens->count++;
+
+        if (lexer->hasError)
+            result = lexer->errorResult;
+        else if (token->flags == TOKEN_TYPE_EOF)
+            break;
+    }
+
+    return result;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerScanTokens(
+    Lexer lexer,
+    struct LexerTokenArray_T* tokens)
+{
+    const LexerLanguageStrategy* strategy = lexer->strategy;
+    bool preserve = lexer->preserveWhitespace || lexer->preserveComments;
+
+    if (strategy->scanToken)
+        return LexerTokenizeLoop(lexer, tokens, preserve, preserve ? strategy->scanTokenTrivia : strategy->scanToken);
+    if (preserve)
+        return LexerTokenizeLoop(lexer, tokens, true, NULL);
+
+    return LexerTokenizeLoop(lexer, tokens, false, NULL);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerTokenize(
+    Lexer lexer,
+    LexerTokenArray* tokens)
+{
+    if (!lexer || !tokens)
+        return PARSER_ERROR_INVALID_ARG;
+
+    LexerTokenArray hdl = PARSER_MALLOC(sizeof(struct LexerTokenArray_T), 0);
+    if (!hdl)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(hdl, 0, sizeof(struct LexerTokenArray_T));
+
+    // Roughly one token per four bytes of source
+    ParserResult result = LexerTokenArrayReserve(hdl, (uint32_t)(LexerRemaining(lexer) / 4) + 1);
+
+    uint32_t firstToken = lexer->scanIndex;
+    uint32_t firstTrivia = lexer->trivia.count;
+    uint32_t firstLiteral = lexer->literals.count;
+
+    if (result == PARSER_RESULT_SUCCESS)
+        result = LexerScanTokens(lexer, hdl);
+
+    // ===== MOVE TRIVIA INTO THE ARRAY =====
+    if (result == PARSER_RESULT_SUCCESS && firstTrivia == 0) {
+        hdl->trivia = lexer->trivia;
+        memset(&lexer->trivia, 0, sizeof(lexer->trivia));
+    }
+    else {
+        for (uint32_t i = firstTrivia; i < lexer->trivia.count && result == PARSER_RESULT_SUCCESS; i++)
+            result = LexerTriviaArrayPush(&hdl->trivia, &lexer->trivia.items[i]);
+        lexer->trivia.count = firstTrivia;
+    }
+
+    for (uint32_t i = 0; i < hdl->trivia.count; i++)
+        hdl->trivia.items[i].tokenIndex -= firstToken;
+
+    // ===== MOVE LITERAL VALUES INTO THE ARRAY =====
+    if (result == PARSER_RESULT_SUCCESS && firstLiteral == 0) {
+        hdl->literals = lexer->literals;
+        memset(&lexer->literals, 0, sizeof(lexer->literals));
+    }
+    else {
+        for (uint32_t i = firstLiteral; i < lexer->literals.count && result == PARSER_RESULT_SUCCESS; i++)
+            result = LexerLiteralArrayPush(&hdl->literals, &lexer->literals.items[i]);
+        lexer->literals.count = firstLiteral;
+
+        for (uint32_t i = 0; i < hdl->count && firstLiteral != 0; i++) {
+            if (LexerIsNumericLiteral(&hdl->tokens[i]))
+                hdl->tokens[i].value -= firstLiteral;
+        }
     }
 
-    // ===== OPERATOR =====
-    if (lexer->strategy->isOperator((const char*)lexer->file->Cursor.cur, 2)) {
-        return Lexer_ParseOperator(lexer);
+    lexer->tokenCount += hdl->count;
+
+    if (result != PARSER_RESULT_SUCCESS) {
+        LexerTokenArray_Destroy(hdl);
+        return result;
     }
 
-    // ===== PUNCTUATION =====
-    if (lexer->strategy->isPunctuation(c)) {
-        token.flags = TOKEN_TYPE_PUNCTUATION;
-        token.lexeme = (const char*)lexer->file->Cursor.cur;
-        FileBuffer_Advance(lexer->file);
-        lexer->column++;
-        return token;
+    *tokens = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR uint32_t PARSER_CALL LexerTokenArray_GetCount(
+    const LexerTokenArray tokens)
+{
+    if (!tokens)
+        return 0;
+
+    return tokens->count;
+}
+
+PARSER_ATTR LexerToken PARSER_CALL LexerTokenArray_GetToken(
+    const LexerTokenArray tokens,
+    uint32_t index)
+{
+    if (!tokens || index >= tokens->count)
+        return NULL;
+
+    return &tokens->tokens[index];
+}
+
+PARSER_ATTR const LexerTrivia* PARSER_CALL LexerTokenArray_GetLeadingTrivia(
+    const LexerTokenArray tokens,
+    uint32_t index,
+    uint32_t* count)
+{
+    if (count)
+        *count = 0;
+
+    if (!tokens || !count || tokens->trivia.count == 0)
+        return NULL;
+
+    // Lower bound on the token index, ranges are sorted by offset and
+    // therefore by the token they lead
+    const LexerTrivia* items = tokens->trivia.items;
+    uint32_t lo = 0;
+    uint32_t hi = tokens->trivia.count;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (items[mid].tokenIndex < index)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
 
-    // ===== UNKNOWN CHARACTER - ERROR =====
-    lexer->hasError = true;
-    lexer->errorMessage = "Unexpected character";
-    lexer->errorLine = lexer->line;
-    lexer->errorColumn = lexer->column;
+    uint32_t first = lo;
+    while (lo < tokens->trivia.count && items[lo].tokenIndex == index)
+        lo++;
+
+    *count = lo - first;
+
+    return *count ? &items[first] : NULL;
+}
+
+PARSER_ATTR const LexerTrivia* PARSER_CALL LexerTokenArray_GetTrivia(
+    const LexerTokenArray tokens,
+    uint32_t* count)
+{
+    if (!tokens || !count)
+        return NULL;
+
+    *count = tokens->trivia.count;
+
+    return tokens->trivia.count ? tokens->trivia.items : NULL;
+}
+
+PARSER_ATTR const LexerLiteral* PARSER_CALL LexerTokenArray_GetLiteral(
+    const LexerTokenArray tokens,
+    uint32_t index)
+{
+    if (!tokens || index >= tokens->count)
+        return NULL;
 
-    token.flags = TOKEN_TYPE_ERROR;
-    token.lexeme = (const char*)lexer->file->Cursor.cur;
-    FileBuffer_Advance(lexer->file);
+    const struct LexerToken_T* token = &tokens->tokens[index];
+    if (!LexerIsNumericLiteral(token) || token->value >= tokens->literals.count)
+        return NULL;
 
-    return token;
+    return &tokens->literals.items[token->value];
 }
 
+PARSER_ATTR void PARSER_CALL LexerTokenArray_Destroy(
+    LexerTokenArray tokens)
+{
+    if (!tokens)
+        return;
+
+    if (tokens->tokens)
+        PARSER_FREE(tokens->tokens);
+
+    if (tokens->trivia.items)
+        PARSER_FREE(tokens->trivia.items);
+
+    if (tokens->literals.items)
+        PARSER_FREE(tokens->literals.items);
 
-PARSER_ATTR inline int PARSER_CALL LexerAdvance(
+    PARSER_FREE(tokens);
+}
+
+
+PARSER_ATTR int PARSER_CALL LexerAdvance(
     Lexer lexer)
 {
     if (!lexer)
         return PARSER_ERROR_INVALID_ARG;
 
-    return AdvanceFileBuffer(lexer->file);
-   
+    if (lexer->cursor.cur >= lexer->cursor.end)
+        return FILE_BUFFER_EOF;
+
+    LexerConsumeTo(lexer, lexer->cursor.cur + 1);
+
+    if (lexer->cursor.cur >= lexer->cursor.end)
+        return FILE_BUFFER_EOF;
+
+    return *lexer->cursor.cur;
 }
 
 PARSER_ATTR int PARSER_CALL LexerPeek(
     Lexer lexer)
 {
-
+    return LexerPeekOffset(lexer, 0);
 }
 
 PARSER_ATTR int PARSER_CALL LexerPeekOffset(
     Lexer lexer,
     size_t offset)
 {
-    
+    if (!lexer)
+        return FILE_BUFFER_EOF;
+
+    if (offset >= LexerRemaining(lexer))
+        return FILE_BUFFER_EOF;
+
+    return lexer->cursor.cur[offset];
 }
 
-PARSER_ATTR inline bool PARSER_CALL LexerIsAtEnd(
+PARSER_ATTR bool PARSER_CALL LexerIsAtEnd(
     const Lexer* lexer)
 {
+    if (!lexer || !*lexer)
+        return true;
 
+    return (*lexer)->cursor.cur >= (*lexer)->cursor.end;
 }
 
-PARSER_ATTR inline void PARSER_CALL LexerTrimWhitespaces(
+PARSER_ATTR void PARSER_CALL LexerTrimWhitespaces(
     const Lexer lexer)
 {
     if (!lexer)
         return;
 
-    while (true) {
-        int32_t byte = PeekFileBuffer(lexer->file);
+    if (lexer->preserveWhitespace || lexer->preserveComments)
+        LexerTrimTrivia(lexer, true);
+    else
+        LexerTrimTrivia(lexer, false);
+}
 
-        // EOF or error
-        if (byte == FILE_BUFFER_EOF) {
-            break;
-        }
+// ===== CONFIGURATION =====
 
-        char c = (char)byte;
+PARSER_ATTR void PARSER_CALL Lexer_SetPreserveWhitespace(
+    Lexer lexer,
+    bool preserve)
+{
+    if (lexer)
+        lexer->preserveWhitespace = preserve;
+}
 
-        // Not whitespace stop
-        if (!lexer->strategy->isWhitespace(c)) {
-            break;
-        }
+PARSER_ATTR void PARSER_CALL Lexer_SetPreserveComments(
+    Lexer lexer,
+    bool preserve)
+{
+    if (lexer)
+        lexer->preserveComments = preserve;
+}
 
-        // Update line/column tracking
-        if (c == '\n') {
-            lexer->line++;
-            lexer->column = 0;
-        }
-        else if (c == '\t') {
-            lexer->column += 4;  // Tab = 4 spaces (configurable)
-        }
-        else {
-            lexer->column++;
-        }
+PARSER_ATTR const LexerTrivia* PARSER_CALL Lexer_GetTrivia(
+    const Lexer lexer,
+    uint32_t* count)
+{
+    if (!lexer || !count)
+        return NULL;
 
-        // Advance
-        AdvanceFileBuffer(lexer->file);
-    }
+    *count = lexer->trivia.count;
 
+    return lexer->trivia.count ? lexer->trivia.items : NULL;
 }
 
-// ------------------------------------------------------------------------------------------------
\ No newline at end of file
+PARSER_ATTR const LexerLiteral* PARSER_CALL Lexer_GetLiteral(
+    const Lexer lexer,
+    const LexerToken token)
+{
+    if (!lexer || !token)
+        return NULL;
+
+    if (!LexerIsNumericLiteral(token) || token->value >= lexer->literals.count)
+        return NULL;
+
+    return &lexer->literals.items[token->value];
+}
+
+// ===== CLEANUP =====
+
+PARSER_ATTR void PARSER_CALL LexerDestroy(
+    Lexer lexer)
+{
+    if (!lexer)
+        return;
+
+    if (lexer->trivia.items)
+        PARSER_FREE(lexer->trivia.items);
+
+    if (lexer->literals.items)
+        PARSER_FREE(lexer->literals.items);
+
+    if (lexer->ring)
+        PARSER_FREE(lexer->ring);
+
+    PARSER_FREE(lexer);
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -10,25 +10,86 @@
 // ------------------------------------------------------------------------------------------------
 
 #include "parser/lexer/Lexer.h"
+#include "parser/Results.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define LEXER_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 // ------------------------------------------------------------------------------------------------
 // Public definitions
 // ------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Token record
+ *
+ * @description Tokens are plain values. A LexerToken handle points at one
+ *              of these records, either inside a token array or inside the
+ *              lexer itself.
+ */
+struct LexerToken_T {
+    const char* lexeme;         // First byte of the token inside the file buffer
+    uint32_t length;            // Length of the lexeme in bytes
+    uint16_t flags;             // TokenTypeFlags
+    uint16_t kind;              // TokenOperatorTypeFlags / TokenLiteralTypeFlags
+    uint32_t value;             // Operator, punctuation or keyword value, literal table index,
+                                // identifier id once the parser interned it
+    uint32_t line;              // Line of the first byte
+    uint32_t column;            // Column of the first byte
+};
+
+struct LexerTriviaArray_T {
+    LexerTrivia* items;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+struct LexerLiteralArray_T {
+    LexerLiteral* items;
+    uint32_t count;
+    uint32_t capacity;
+};
+
+struct LexerTokenArray_T {
+    struct LexerToken_T* tokens;
+    uint32_t count;
+    uint32_t capacity;
+
+    struct LexerTriviaArray_T trivia;   // Leading trivia, empty unless preserved
+    struct LexerLiteralArray_T literals; // Values of the numeric literal tokens
+};
+
 struct Lexer_T {
     // ===== Input Management =====
     FileBuffer file;            // File buffer for reading source
+    FileBufferCursor cursor;    // Private cursor, begin is the first byte of the file
+    const uint8_t* limit;       // No token starts at or past this byte (end of chunk)
 
     // ===== Current Position =====
     ParserSize line;            // Current line number
     ParserSize column;          // Current column number
-    
+
     // ===== Token Lookahead =====
-    LexerToken currentToken;    // Current token
-    LexerToken peekToken;       // Lookahead token
+    // Ring slots are addressed by absolute token index & ringMask
+    struct LexerToken_T* ring;  // Power-of-two ring of scanned tokens, allocated on first use
+    uint32_t ringMask;          // Ring capacity - 1
+    uint32_t ringCapacity;      // Initial capacity requested at creation
+    uint32_t position;          // Absolute index of the token LexerNextToken returns next
+    uint32_t filled;            // Absolute index one past the last scanned token
+    uint32_t marks[LEXER_MAX_CHECKPOINTS]; // Positions of the active checkpoints, oldest first
+    uint32_t markCount;
+    struct LexerToken_T scanToken;  // Filled by the strategy scanner callbacks
 
     // ===== Error Tracking =====
     bool hasError;              // Flag indicating lexing errors
+    ParserResult errorResult;   // Result code of the last error
     const char* errorMessage;   // Last error message
     ParserSize errorLine;       // Line where error occurred
     ParserSize errorColumn;     // Column where error occurred
@@ -41,12 +102,174 @@ struct Lexer_T {
     FileBufferEncoding encoding; // Character encoding
     bool strictMode;            // Strict lexing rules
 
-    // TODO: add preservation of whitespaces and comments
+    // ===== Trivia Preservation =====
+    bool preserveWhitespace;    // Record whitespace ranges
+    bool preserveComments;      // Record comment ranges
+    struct LexerTriviaArray_T trivia;   // Side array of skipped ranges
+    uint32_t scanIndex;         // Index of the next token to be scanned
+
+    // ===== Literal Values =====
+    struct LexerLiteralArray_T literals;    // Indexed by the value of numeric literal tokens
 
     // ===== LANGUAGE STRATEGY =====
     const LexerLanguageStrategy* strategy;  // Single pointer to strategy
 };
 
+/**
+ * @brief Initialize a lexer record for a file
+ *
+ * @description Used by CreateLexer and by the parallel lexer, which keeps
+ *              one lexer record per chunk.
+ *
+ * @param lexer[in] Lexer record
+ * @param file[in] File buffer to be lexed
+ * @param strategy[in] Language strategy
+ */
+PARSER_ATTR void PARSER_CALL LexerInitState(
+    Lexer lexer,
+    FileBuffer file,
+    const LexerLanguageStrategy* strategy);
+
+/**
+ * @brief Scan the next token into a token record
+ *
+ * @param lexer[in] Lexer handle
+ * @param token[out] Token record to fill
+ *
+ * @return false when the cursor reached the chunk limit before the end of
+ *         the file, true when a token (possibly EOF or ERROR) was written
+ */
+PARSER_ATTR bool PARSER_CALL LexerScanToken(
+    Lexer lexer,
+    struct LexerToken_T* token);
+
+/**
+ * @brief Scan tokens into a token array up to the EOF token, or the chunk limit
+ *
+ * @description The scanner of the strategy is chosen once for the whole run
+ *              instead of once per token. The EOF token is appended when the
+ *              end of the file is reached.
+ *
+ * @param lexer[in] Lexer handle
+ * @param tokens[in,out] Token array to append to
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the array
+ *      Otherwise the error of an ERROR token, which ends the run
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerScanTokens(
+    Lexer lexer,
+    struct LexerTokenArray_T* tokens);
+
+/**
+ * @brief Make sure the token at an absolute index has been scanned into the ring
+ *
+ * @description Scans a batch of tokens when it has not. Indices past the EOF
+ *              or error token are left for LexerRingAt to clamp.
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the ring
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerRingRequire(
+    Lexer lexer,
+    uint32_t index);
+
+/**
+ * @brief Grow a token array to hold at least `capacity` tokens
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the array, or `capacity` is past what it can address
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerTokenArrayReserve(
+    struct LexerTokenArray_T* tokens,
+    uint32_t capacity);
+
+/**
+ * @brief Append a trivia range
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the array
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerTriviaArrayPush(
+    struct LexerTriviaArray_T* trivia,
+    const LexerTrivia* range);
+
+/**
+ * @brief Append a literal value
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the array
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerLiteralArrayPush(
+    struct LexerLiteralArray_T* literals,
+    const LexerLiteral* literal);
+
+/**
+ * @brief Record [from, to) as trivia leading the next scanned token
+ *
+ * @description Sets the lexer error state when the range cannot be stored.
+ */
+PARSER_ATTR void PARSER_CALL LexerPushTrivia(
+    Lexer lexer,
+    const uint8_t* from,
+    const uint8_t* to,
+    LexerTriviaKind kind);
+
+/**
+ * @brief Store the value of a numeric literal
+ *
+ * @param lexer[in] Lexer handle
+ * @param literal[in] Converted value
+ * @param index[out] Index to store in the token value
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : Could not grow the literal table
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerPushLiteral(
+    Lexer lexer,
+    const LexerLiteral* literal,
+    uint32_t* index);
+
+/**
+ * @brief Round a decimal number to the nearest float or double
+ *
+ * @description Eisel-Lemire over a 128-bit table of powers of five. When the
+ *              digits had to be truncated and the result is not decided by
+ *              them, falls back to the C library on the original text.
+ *
+ * @param mantissa[in] First (up to 19) significant digits
+ * @param exponent[in] Power of ten applied to @p mantissa
+ * @param truncated[in] Non zero digits were dropped after the 19th
+ * @param single[in] Round to float instead of double
+ * @param text[in] Literal text without suffix, used by the fallback
+ * @param length[in] Size of @p text
+ * @param value[out] Rounded value
+ *
+ * @return ParserResult
+ *      PARSER_ERROR_NO_MEMORY : The fallback could not copy the text
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerDecimalToBinary(
+    uint64_t mantissa,
+    int64_t exponent,
+    bool truncated,
+    bool single,
+    const char* text,
+    size_t length,
+    double* value);
+
+/**
+ * @brief Convert literal text with the C library (strtod/strtof)
+ *
+ * @description Correctly rounded slow path, also handles hexadecimal floats.
+ */
+PARSER_ATTR ParserResult PARSER_CALL LexerParseFloatFallback(
+    const char* text,
+    size_t length,
+    bool single,
+    double* value);
+
+/* Value of a hexadecimal digit, 0xFF for other bytes */
+extern const uint8_t g_LexerNibbleTable[256];
 
 /**
  * @brief Advance lexer cursor by one character
@@ -61,7 +284,7 @@ PARSER_ATTR inline int PARSER_CALL LexerAdvance(
  * @brief Peek at current character without advancing
  *
  * @param lexer[in] Lexer handle
- * 
+ *
  * @return Current character or EOF
  */
 PARSER_ATTR int PARSER_CALL LexerPeek(
@@ -72,7 +295,7 @@ PARSER_ATTR int PARSER_CALL LexerPeek(
  *
  * @param lexer[in] Lexer handle
  * @param offset[in] Offset from current position (1 = next char, 2 = char after that)
- * 
+ *
  * @return Character at offset or EOF
  */
 PARSER_ATTR int PARSER_CALL LexerPeekOffset(
@@ -91,18 +314,211 @@ PARSER_ATTR inline bool PARSER_CALL LexerIsAtEnd(
 
 
 /**
- * @brief Check if at end of file
+ * @brief Skip whitespace and comments
  *
- * @param lexer[in] Lexer handle
+ * @description Stops at the chunk limit unless a comment runs past it.
  *
- * @return true if at EOF, false otherwise
+ * @param lexer[in] Lexer handle
  */
 PARSER_ATTR inline void PARSER_CALL LexerTrimWhitespaces(
     const Lexer lexer);
 
+// ------------------------------------------------------------------------------------------------
+// Scanner helpers (used by the language strategies)
+// ------------------------------------------------------------------------------------------------
+
+/* Number of bytes left before the end of the file */
+static inline size_t LexerRemaining(const Lexer lexer)
+{
+    return (size_t)(lexer->cursor.end - lexer->cursor.cur);
+}
+
+/* Consume `count` bytes that are known not to contain a newline */
+static inline void LexerConsume(Lexer lexer, size_t count)
+{
+    lexer->cursor.cur += count;
+    lexer->column += count;
+}
+
+/* Consume up to `to`, updating line and column for every newline in between */
+static inline void LexerConsumeTo(Lexer lexer, const uint8_t* to)
+{
+    for (const uint8_t* p = lexer->cursor.cur; p < to; p++) {
+        if (*p == '\n') {
+            lexer->line++;
+            lexer->column = 0;
+        }
+        else {
+            lexer->column++;
+        }
+    }
+    lexer->cursor.cur = to;
+}
+
+/* Start a token in the scan slot at the current cursor */
+static inline LexerToken LexerBeginToken(Lexer lexer, TokenTypeFlags flags, uint16_t kind, uint32_t value)
+{
+    lexer->scanToken.lexeme = (const char*)lexer->cursor.cur;
+    lexer->scanToken.length = 0;
+    lexer->scanToken.flags = (uint16_t)flags;
+    lexer->scanToken.kind = kind;
+    lexer->scanToken.value = value;
+    return &lexer->scanToken;
+}
+
+/* Close the token in the scan slot at the current cursor */
+static inline LexerToken LexerEndToken(Lexer lexer)
+{
+    lexer->scanToken.length = (uint32_t)((const char*)lexer->cursor.cur - lexer->scanToken.lexeme);
+    return &lexer->scanToken;
+}
+
+/* Record a lexing error, the first error wins */
+static inline LexerToken LexerSetError(Lexer lexer, ParserResult result, const char* message)
+{
+    if (!lexer->hasError) {
+        lexer->hasError = true;
+        lexer->errorResult = result;
+        lexer->errorMessage = message;
+        lexer->errorLine = lexer->line;
+        lexer->errorColumn = lexer->column;
+    }
+    lexer->scanToken.flags = TOKEN_TYPE_ERROR;
+    return LexerEndToken(lexer);
+}
+
+/* Ring slot of an absolute token index, clamped to the last scanned token */
+static inline struct LexerToken_T* LexerRingAt(const Lexer lexer, uint32_t index)
+{
+    if (index >= lexer->filled)
+        index = lexer->filled - 1;
+
+    return &lexer->ring[index & lexer->ringMask];
+}
+
+/* Error message for a failed literal conversion */
+static inline const char* LexerLiteralErrorMessage(ParserResult result)
+{
+    return result == PARSER_ERROR_NO_MEMORY ? "Out of memory recording literal" : "Invalid numeric literal";
+}
+
+/* True for tokens whose value indexes the literal table */
+static inline bool LexerIsNumericLiteral(const struct LexerToken_T* token)
+{
+    return token->flags == TOKEN_TYPE_LITERAL &&
+        (token->kind == LITERAL_TYPE_INTEGER || token->kind == LITERAL_TYPE_FLOAT);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Numeric helpers
+// ------------------------------------------------------------------------------------------------
+
+/* Load 8 bytes as a little-endian word (the target is x86_64) */
+static inline uint64_t LexerLoad8(const uint8_t* p)
+{
+    uint64_t chunk;
+    memcpy(&chunk, p, sizeof(chunk));
+    return chunk;
+}
+
+/* All 8 bytes of the word are ASCII digits */
+static inline bool LexerIsEightDigits(uint64_t chunk)
+{
+    return (((chunk & 0xF0F0F0F0F0F0F0F0ull) |
+             (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);
+}
+
+/* Value of 8 ASCII digits, first digit in the lowest byte */
+static inline uint32_t LexerParseEightDigits(uint64_t chunk)
+{
+    const uint64_t mask = 0x000000FF000000FFull;
+    const uint64_t mul1 = 0x000F424000000064ull;   // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ull;   // 1 + (10000 << 32)
+
+    chunk -= 0x3030303030303030ull;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+
+    return (uint32_t)chunk;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Quoted literal helpers
+// ------------------------------------------------------------------------------------------------
+
+/* Index of the lowest set bit, `value` must not be zero */
+static inline uint32_t LexerTrailingZeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (uint32_t)index;
+#else
+    uint32_t count = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Find the next byte of a quoted literal the scanner has to look at
+ *
+ * @description Skips ordinary literal bytes 16 at a time with SSE2 compares,
+ *              8 at a time with SWAR where SSE2 is not available.
+ *
+ * @return First byte in [p, end) equal to `quote`, `escape` or a newline,
+ *         `end` (or `p` when it is already past `end`) when there is none
+ */
+static inline const uint8_t* LexerFindQuotedStop(const uint8_t* p, const uint8_t* end, uint8_t quote, uint8_t escape)
+{
+#if LEXER_SIMD_SSE2
+    const __m128i quotes = _mm_set1_epi8((char)quote);
+    const __m128i escapes = _mm_set1_epi8((char)escape);
+    const __m128i newlines = _mm_set1_epi8('\n');
+
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quotes), _mm_cmpeq_epi8(chunk, escapes)),
+            _mm_cmpeq_epi8(chunk, newlines));
+
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (mask)
+            return p + LexerTrailingZeros(mask);
+
+        p += 16;
+    }
+#else
+    // Zero byte test on chunk ^ pattern, exact for the lowest matching byte
+    const uint64_t ones = 0x0101010101010101ull;
+    const uint64_t highs = 0x8080808080808080ull;
+
+    while (end - p >= 8) {
+        uint64_t chunk = LexerLoad8(p);
+        uint64_t a = chunk ^ (ones * quote);
+        uint64_t b = chunk ^ (ones * escape);
+        uint64_t c = chunk ^ (ones * '\n');
+        uint64_t hits = (((a - ones) & ~a) | ((b - ones) & ~b) | ((c - ones) & ~c)) & highs;
+
+        if (hits)
+            return p + (LexerTrailingZeros(hits) >> 3);
+
+        p += 8;
+    }
+#endif
+
+    while (p < end && *p != quote && *p != escape && *p != '\n')
+        p++;
+
+    return p;
+}
 
 // ------------------------------------------------------------------------------------------------
 
 #endif // !LEXER_INTERNAL_H
 
-// ------------------------------------------------------------------------------------------------
\ No newline at end of file
+// ------------------------------------------------------------------------------------------------
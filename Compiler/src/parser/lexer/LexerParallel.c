@@ -0,0 +1,354 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "LexerInternal.h"
+
+#include "../ParserThread.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/**
+ * @brief One speculatively lexed slice of the file
+ *
+ * @description A chunk starts right after a newline and is lexed as if no
+ *              comment or literal was open at that point. The lexer stops at
+ *              the first token that would start at or past `limit`. Tokens
+ *              that started before the limit are finished even when they run
+ *              into the next chunk, `resume` is where the lexer stopped and
+ *              therefore where the next chunk really starts.
+ */
+typedef struct LexerChunk_T {
+    const LexerLanguageStrategy* strategy;
+    FileBuffer file;
+
+    const uint8_t* start;       // Where the chunk lexer started
+    const uint8_t* limit;       // Guessed start of the next chunk
+    const uint8_t* resume;      // Where the chunk lexer stopped
+    uint32_t startColumn;       // Column of `start`, non zero only after a re-lex
+    bool isLast;                // Last chunk, keeps the EOF token
+    bool preserveWhitespace;
+    bool preserveComments;
+
+    struct LexerTokenArray_T tokens;    // Tokens, trivia and literals, indices local to the chunk
+    ParserResult result;
+    uint32_t lines;             // Newlines between start and resume
+
+    // Concatenation
+    uint32_t lineBase;          // Line of `start` in the file
+    uint32_t outputIndex;       // Index of the first token in the output array
+    uint32_t literalBase;       // Index of the first literal in the output array
+    struct LexerToken_T* output;
+    LexerLiteral* literalOutput;
+} LexerChunk;
+
+static void LexerLexChunk(LexerChunk* chunk)
+{
+    struct Lexer_T lexer;
+    LexerInitState(&lexer, chunk->file, chunk->strategy);
+
+    lexer.cursor.cur = chunk->start;
+    lexer.limit = chunk->limit;
+    lexer.column = chunk->startColumn;
+    lexer.preserveWhitespace = chunk->preserveWhitespace;
+    lexer.preserveComments = chunk->preserveComments;
+
+    // A re-lex reuses the trivia and literal storage of the speculative run
+    lexer.trivia = chunk->tokens.trivia;
+    lexer.trivia.count = 0;
+    lexer.literals = chunk->tokens.literals;
+    lexer.literals.count = 0;
+
+    chunk->tokens.count = 0;
+    chunk->result = LexerTokenArrayReserve(&chunk->tokens, (uint32_t)((chunk->limit - chunk->start) / 4) + 1);
+    if (chunk->result == PARSER_RESULT_SUCCESS)
+        chunk->result = LexerScanTokens(&lexer, &chunk->tokens);
+
+    // Only the last chunk terminates the stream, a token running to the end of the file can reach it early
+    struct LexerTokenArray_T* tokens = &chunk->tokens;
+    if (chunk->result == PARSER_RESULT_SUCCESS && !chunk->isLast && tokens->count &&
+        tokens->tokens[tokens->count - 1].flags == TOKEN_TYPE_EOF)
+        tokens->count--;
+
+    chunk->resume = lexer.cursor.cur;
+    chunk->lines = (uint32_t)lexer.line;
+    chunk->tokens.trivia = lexer.trivia;
+    chunk->tokens.literals = lexer.literals;
+
+    if (lexer.hasError && chunk->result == PARSER_RESULT_SUCCESS)
+        chunk->result = lexer.errorResult;
+}
+
+/* Append the trivia of a chunk, joining whitespace runs split by the chunk boundary */
+static ParserResult LexerAppendChunkTrivia(struct LexerTriviaArray_T* trivia, const LexerChunk* chunk)
+{
+    for (uint32_t i = 0; i < chunk->tokens.trivia.count; i++) {
+        LexerTrivia range = chunk->tokens.trivia.items[i];
+        range.tokenIndex += chunk->outputIndex;
+
+        if (trivia->count > 0) {
+            LexerTrivia* last = &trivia->items[trivia->count - 1];
+            if (last->kind == LEXER_TRIVIA_WHITESPACE && range.kind == LEXER_TRIVIA_WHITESPACE &&
+                last->tokenIndex == range.tokenIndex && last->offset + last->length == range.offset) {
+                last->length += range.length;
+                continue;
+            }
+        }
+
+        CHECK_PARSER_RESULT(LexerTriviaArrayPush(trivia, &range));
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+static void PARSER_PTR LexerChunkWorker(void* userData)
+{
+    LexerLexChunk((LexerChunk*)userData);
+}
+
+static void PARSER_PTR LexerChunkCopyWorker(void* userData)
+{
+    LexerChunk* chunk = (LexerChunk*)userData;
+
+    struct LexerToken_T* dst = chunk->output + chunk->outputIndex;
+    const struct LexerToken_T* src = chunk->tokens.tokens;
+
+    for (uint32_t i = 0; i < chunk->tokens.count; i++) {
+        dst[i] = src[i];
+        dst[i].line += chunk->lineBase;
+
+        if (LexerIsNumericLiteral(&dst[i]))
+            dst[i].value += chunk->literalBase;
+    }
+
+    if (chunk->tokens.literals.count) {
+        memcpy(chunk->literalOutput + chunk->literalBase, chunk->tokens.literals.items,
+            sizeof(LexerLiteral) * chunk->tokens.literals.count);
+    }
+}
+
+/* Run `worker` for every chunk, chunk 0 on the calling thread */
+static void LexerRunChunks(LexerChunk* chunks, uint32_t count, PFN_ParserThreadEntry worker)
+{
+    ParserThread threads[LEXER_PARALLEL_MAX_CHUNKS];
+    uint32_t started = 1;
+
+    for (uint32_t i = 1; i < count; i++) {
+        if (ParserThreadCreate(worker, &chunks[i], &threads[i]) != PARSER_RESULT_SUCCESS)
+            break;
+        started++;
+    }
+
+    worker(&chunks[0]);
+
+    // Chunks whose thread could not be started run here
+    for (uint32_t i = started; i < count; i++)
+        worker(&chunks[i]);
+
+    for (uint32_t i = 1; i < started; i++)
+        ParserThreadJoin(threads[i]);
+}
+
+/* Column of `position` as the serial lexer counts it inside a multi-line token */
+static uint32_t LexerColumnAt(const uint8_t* begin, const uint8_t* position)
+{
+    const uint8_t* p = position;
+    while (p > begin && p[-1] != '\n')
+        p--;
+
+    return (uint32_t)(position - p);
+}
+
+/* Next chunk boundary, the byte after the first newline at or after `from` */
+static const uint8_t* LexerFindChunkBoundary(const uint8_t* from, const uint8_t* end)
+{
+    if (from >= end)
+        return end;
+
+    const uint8_t* newline = memchr(from, '\n', (size_t)(end - from));
+    return newline ? newline + 1 : end;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL LexerTokenizeParallel(
+    FileBuffer file,
+    const LexerParallelConfig* cfg,
+    LexerTokenArray* tokens,
+    LexerParallelStats* stats)
+{
+    if (!file || !cfg || !tokens)
+        return PARSER_ERROR_INVALID_ARG;
+
+    if (!cfg->strategy)
+        return PARSER_ERROR_INVALID_STRATEGY;
+
+    if (!ParserThreadSafeAllocator())
+        return PARSER_ERROR_UNSUPPORTED;
+
+    const FileBufferCursor* cursor = GetFileBufferCursor(file);
+    const uint8_t* begin = cursor->begin;
+    const uint8_t* end = cursor->end;
+    ParserSize size = (ParserSize)(end - begin);
+
+    // ===== PICK THE CHUNK COUNT =====
+    uint32_t threadCount = cfg->threadCount ? cfg->threadCount : ParserThreadHardwareConcurrency();
+    ParserSize minChunk = cfg->minChunkSize ? cfg->minChunkSize : LEXER_PARALLEL_DEFAULT_MIN_CHUNK;
+
+    ParserSize chunkCount = size / minChunk;
+    if (chunkCount > threadCount)
+        chunkCount = threadCount;
+    if (chunkCount > LEXER_PARALLEL_MAX_CHUNKS)
+        chunkCount = LEXER_PARALLEL_MAX_CHUNKS;
+    if (chunkCount == 0)
+        chunkCount = 1;
+
+    LexerChunk* chunks = PARSER_MALLOC(sizeof(LexerChunk) * chunkCount, 0);
+    if (!chunks)
+        return PARSER_ERROR_NO_MEMORY;
+
+    memset(chunks, 0, sizeof(LexerChunk) * chunkCount);
+
+    // ===== SPLIT AT NEWLINE BOUNDARIES =====
+    uint32_t count = 0;
+    const uint8_t* start = begin;
+    ParserSize step = size / chunkCount;
+
+    for (ParserSize i = 0; i < chunkCount && (count == 0 || start < end); i++) {
+        const uint8_t* limit = (i + 1 == chunkCount) ? end : LexerFindChunkBoundary(begin + step * (i + 1), end);
+
+        // Skip slices swallowed by a very long line
+        if (limit <= start && count > 0)
+            continue;
+
+        LexerChunk* chunk = &chunks[count++];
+        chunk->strategy = cfg->strategy;
+        chunk->file = file;
+        chunk->start = start;
+        chunk->limit = limit;
+        chunk->preserveWhitespace = cfg->preserveWhitespace;
+        chunk->preserveComments = cfg->preserveComments;
+
+        start = limit;
+    }
+    chunks[count - 1].limit = end;
+    chunks[count - 1].isLast = true;
+
+    // ===== SPECULATIVE LEXING =====
+    LexerRunChunks(chunks, count, LexerChunkWorker);
+    ParserResult result = PARSER_RESULT_SUCCESS;
+
+    // ===== VALIDATE CHUNK BOUNDARIES =====
+    // A chunk guessed right when the previous (valid) chunk stopped exactly
+    // where it started. Otherwise the boundary fell inside a comment or a
+    // literal and the chunk is lexed again from the true resume point, after
+    // which it is valid as well. A comment or literal can also run past the
+    // whole chunk, which then has nothing left to lex.
+    uint32_t relexed = 0;
+    uint32_t total = 0;
+    uint32_t literals = 0;
+
+    for (uint32_t i = 0; i < count && result == PARSER_RESULT_SUCCESS; i++) {
+        LexerChunk* chunk = &chunks[i];
+
+        if (i > 0) {
+            const LexerChunk* previous = &chunks[i - 1];
+            chunk->lineBase = previous->lineBase + previous->lines;
+
+            if (chunk->start != previous->resume && previous->resume >= chunk->limit && !chunk->isLast) {
+                chunk->start = previous->resume;
+                chunk->resume = previous->resume;
+                chunk->lines = 0;
+                chunk->tokens.count = 0;
+                chunk->tokens.trivia.count = 0;
+                chunk->tokens.literals.count = 0;
+                chunk->result = PARSER_RESULT_SUCCESS;
+                relexed++;
+            } else if (chunk->start != previous->resume) {
+                chunk->start = previous->resume;
+                chunk->startColumn = LexerColumnAt(begin, chunk->start);
+                LexerLexChunk(chunk);
+                relexed++;
+            }
+        }
+
+        result = chunk->result;
+
+        chunk->outputIndex = total;
+        total += chunk->tokens.count;
+
+        chunk->literalBase = literals;
+        literals += chunk->tokens.literals.count;
+    }
+
+    // ===== CONCATENATE =====
+    LexerTokenArray hdl = NULL;
+
+    if (result == PARSER_RESULT_SUCCESS) {
+        hdl = PARSER_MALLOC(sizeof(struct LexerTokenArray_T), 0);
+        if (!hdl)
+            result = PARSER_ERROR_NO_MEMORY;
+    }
+
+    if (result == PARSER_RESULT_SUCCESS && count == 1) {
+        // A single chunk already holds the whole stream, its arrays are handed over
+        *hdl = chunks[0].tokens;
+        memset(&chunks[0].tokens, 0, sizeof(chunks[0].tokens));
+    } else if (result == PARSER_RESULT_SUCCESS) {
+        memset(hdl, 0, sizeof(struct LexerTokenArray_T));
+        result = LexerTokenArrayReserve(hdl, total);
+
+        if (result == PARSER_RESULT_SUCCESS && literals > 0) {
+            hdl->literals.items = PARSER_MALLOC(sizeof(LexerLiteral) * literals, 0);
+            if (!hdl->literals.items)
+                result = PARSER_ERROR_NO_MEMORY;
+        }
+
+        if (result == PARSER_RESULT_SUCCESS) {
+            for (uint32_t i = 0; i < count; i++) {
+                chunks[i].output = hdl->tokens;
+                chunks[i].literalOutput = hdl->literals.items;
+            }
+
+            LexerRunChunks(chunks, count, LexerChunkCopyWorker);
+            hdl->count = total;
+            hdl->literals.count = literals;
+            hdl->literals.capacity = literals;
+
+            for (uint32_t i = 0; i < count && result == PARSER_RESULT_SUCCESS; i++)
+                result = LexerAppendChunkTrivia(&hdl->trivia, &chunks[i]);
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (chunks[i].tokens.tokens)
+            PARSER_FREE(chunks[i].tokens.tokens);
+        if (chunks[i].tokens.trivia.items)
+            PARSER_FREE(chunks[i].tokens.trivia.items);
+        if (chunks[i].tokens.literals.items)
+            PARSER_FREE(chunks[i].tokens.literals.items);
+    }
+    PARSER_FREE(chunks);
+
+    if (result != PARSER_RESULT_SUCCESS) {
+        LexerTokenArray_Destroy(hdl);
+        return result;
+    }
+
+    if (stats) {
+        stats->chunkCount = count;
+        stats->relexedChunks = relexed;
+    }
+
+    *tokens = hdl;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
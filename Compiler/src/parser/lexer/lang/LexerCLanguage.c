@@ -0,0 +1,799 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/lexer/lang/LexerCLanguage.h"
+
+#include "../LexerInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define C_CLASS_IDENT_START     0x01
+#define C_CLASS_IDENT_CHAR      0x02
+#define C_CLASS_DIGIT           0x04
+#define C_CLASS_HEX_DIGIT       0x08
+#define C_CLASS_WHITESPACE      0x10
+#define C_CLASS_OPERATOR        0x20
+#define C_CLASS_PUNCTUATION     0x40
+
+/* Character classes of the C basic source character set, bytes >= 0x80 have no class */
+static const uint8_t s_CCharClass[256] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x20, 0x00, 0x40, 0x00, 0x20, 0x20, 0x00, 0x40, 0x40, 0x20, 0x20, 0x40, 0x20, 0x40, 0x20,
+    0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x40, 0x40, 0x20, 0x20, 0x20, 0x20,
+    0x00, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x40, 0x00, 0x40, 0x20, 0x03,
+    0x00, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x40, 0x20, 0x40, 0x20, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+#define C_IS(c, cls)    ((s_CCharClass[(uint8_t)(c)] & (cls)) != 0)
+
+typedef struct LexerCKeywordEntry {
+    const char* text;
+    uint8_t length;
+    LexerCKeyword keyword;
+} LexerCKeywordEntry;
+
+/* Keywords sorted by length, s_CKeywordsByLength[n] is the first entry of length >= n */
+static const LexerCKeywordEntry s_CKeywords[] = {
+    { "do", 2, C_KEYWORD_DO },
+    { "if", 2, C_KEYWORD_IF },
+    { "for", 3, C_KEYWORD_FOR },
+    { "int", 3, C_KEYWORD_INT },
+    { "auto", 4, C_KEYWORD_AUTO },
+    { "case", 4, C_KEYWORD_CASE },
+    { "char", 4, C_KEYWORD_CHAR },
+    { "else", 4, C_KEYWORD_ELSE },
+    { "enum", 4, C_KEYWORD_ENUM },
+    { "goto", 4, C_KEYWORD_GOTO },
+    { "long", 4, C_KEYWORD_LONG },
+    { "void", 4, C_KEYWORD_VOID },
+    { "_Bool", 5, C_KEYWORD_BOOL },
+    { "break", 5, C_KEYWORD_BREAK },
+    { "const", 5, C_KEYWORD_CONST },
+    { "float", 5, C_KEYWORD_FLOAT },
+    { "short", 5, C_KEYWORD_SHORT },
+    { "union", 5, C_KEYWORD_UNION },
+    { "while", 5, C_KEYWORD_WHILE },
+    { "double", 6, C_KEYWORD_DOUBLE },
+    { "extern", 6, C_KEYWORD_EXTERN },
+    { "inline", 6, C_KEYWORD_INLINE },
+    { "return", 6, C_KEYWORD_RETURN },
+    { "signed", 6, C_KEYWORD_SIGNED },
+    { "sizeof", 6, C_KEYWORD_SIZEOF },
+    { "static", 6, C_KEYWORD_STATIC },
+    { "struct", 6, C_KEYWORD_STRUCT },
+    { "switch", 6, C_KEYWORD_SWITCH },
+    { "_Atomic", 7, C_KEYWORD_ATOMIC },
+    { "default", 7, C_KEYWORD_DEFAULT },
+    { "typedef", 7, C_KEYWORD_TYPEDEF },
+    { "_Alignas", 8, C_KEYWORD_ALIGNAS },
+    { "_Alignof", 8, C_KEYWORD_ALIGNOF },
+    { "_Complex", 8, C_KEYWORD_COMPLEX },
+    { "_Generic", 8, C_KEYWORD_GENERIC },
+    { "continue", 8, C_KEYWORD_CONTINUE },
+    { "register", 8, C_KEYWORD_REGISTER },
+    { "restrict", 8, C_KEYWORD_RESTRICT },
+    { "unsigned", 8, C_KEYWORD_UNSIGNED },
+    { "volatile", 8, C_KEYWORD_VOLATILE },
+    { "_Noreturn", 9, C_KEYWORD_NORETURN },
+    { "_Imaginary", 10, C_KEYWORD_IMAGINARY },
+    { "_Thread_local", 13, C_KEYWORD_THREAD_LOCAL },
+    { "_Static_assert", 14, C_KEYWORD_STATIC_ASSERT },
+};
+
+#define C_KEYWORD_MAX_LENGTH    14
+
+static const uint8_t s_CKeywordsByLength[C_KEYWORD_MAX_LENGTH + 2] = {
+    0, 0, 0, 2, 4, 12, 19, 28, 31, 40, 41, 42, 42, 42, 43, 44
+};
+
+typedef struct LexerCOperatorEntry {
+    const char* text;
+    uint8_t length;
+    uint32_t code;
+} LexerCOperatorEntry;
+
+/* Operators and punctuation, longest first so the first match is the maximal munch */
+static const LexerCOperatorEntry s_COperators[] = {
+    { "<<=", 3, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SHL_ASSIGN) },
+    { ">>=", 3, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SHR_ASSIGN) },
+    { "...", 3, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_ELLIPSIS) },
+
+    { "++", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_UNARY, UNARY_OPERATOR_INCREMENT) },
+    { "--", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_UNARY, UNARY_OPERATOR_DECREMENT) },
+    { "->", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_ARROW) },
+    { "<<", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHL) },
+    { ">>", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHR) },
+    { "<=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS_EQUAL) },
+    { ">=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER_EQUAL) },
+    { "==", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_EQUAL) },
+    { "!=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_NOT_EQUAL) },
+    { "&&", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_AND) },
+    { "||", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_OR) },
+    { "+=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ADD_ASSIGN) },
+    { "-=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SUBTRACT_ASSIGN) },
+    { "*=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_MULTIPLY_ASSIGN) },
+    { "/=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_DIVIDE_ASSIGN) },
+    { "%=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_MODULO_ASSIGN) },
+    { "&=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_AND_ASSIGN) },
+    { "|=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_OR_ASSIGN) },
+    { "^=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_XOR_ASSIGN) },
+    { "##", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_HASH_HASH) },
+
+    { "+", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_ADD) },
+    { "-", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_SUBTRACT) },
+    { "*", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MULTIPLY) },
+    { "/", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_DIVIDE) },
+    { "%", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MODULO) },
+    { "&", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_AND) },
+    { "|", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_OR) },
+    { "^", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_XOR) },
+    { "~", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_NOT) },
+    { "!", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_NOT) },
+    { "<", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS) },
+    { ">", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER) },
+    { "=", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ASSIGN) },
+    { "?", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_TERNARY, TERNARY_OPERATOR_CONDITIONAL) },
+    { "(", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_LPAREN) },
+    { ")", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_RPAREN) },
+    { "[", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_LBRACKET) },
+    { "]", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_RBRACKET) },
+    { "{", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_LBRACE) },
+    { "}", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_RBRACE) },
+    { ";", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_SEMICOLON) },
+    { ",", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_COMMA) },
+    { ":", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_COLON) },
+    { ".", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_DOT) },
+    { "#", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_HASH) },
+};
+
+#define C_OPERATOR_COUNT    (sizeof(s_COperators) / sizeof(s_COperators[0]))
+
+// ------------------------------------------------------------------------------------------------
+// Character classification
+// ------------------------------------------------------------------------------------------------
+
+static bool PARSER_PTR LexerCIsIdentifierStart(uint8_t c)
+{
+    return C_IS(c, C_CLASS_IDENT_START);
+}
+
+static bool PARSER_PTR LexerCIsIdentifierChar(uint8_t c)
+{
+    return C_IS(c, C_CLASS_IDENT_CHAR);
+}
+
+static bool PARSER_PTR LexerCIsKeyword(const char* lexeme)
+{
+    return LexerCLookupKeyword(lexeme, strlen(lexeme)) != C_KEYWORD_NONE;
+}
+
+static bool PARSER_PTR LexerCIsWhitespace(uint8_t c)
+{
+    return C_IS(c, C_CLASS_WHITESPACE);
+}
+
+static bool PARSER_PTR LexerCIsLineComment(const char* text, size_t length)
+{
+    return length >= 2 && text[0] == '/' && text[1] == '/';
+}
+
+static bool PARSER_PTR LexerCIsBlockComment(const char* text, size_t length)
+{
+    return length >= 2 && text[0] == '/' && text[1] == '*';
+}
+
+static bool PARSER_PTR LexerCIsStringStart(uint8_t c)
+{
+    return c == '"';
+}
+
+static bool PARSER_PTR LexerCIsCharStart(uint8_t c)
+{
+    return c == '\'';
+}
+
+static bool PARSER_PTR LexerCIsNumberStart(uint8_t c)
+{
+    return C_IS(c, C_CLASS_DIGIT);
+}
+
+static bool PARSER_PTR LexerCIsNumberChar(uint8_t c, int base)
+{
+    switch (base) {
+    case 2:  return c == '0' || c == '1';
+    case 8:  return c >= '0' && c <= '7';
+    case 16: return C_IS(c, C_CLASS_HEX_DIGIT);
+    default: return C_IS(c, C_CLASS_DIGIT);
+    }
+}
+
+static bool PARSER_PTR LexerCIsPunctuation(uint8_t c)
+{
+    return C_IS(c, C_CLASS_PUNCTUATION);
+}
+
+static bool PARSER_PTR LexerCIsOperator(const char* lexeme, size_t length)
+{
+    if (length == 1)
+        return C_IS(lexeme[0], C_CLASS_OPERATOR);
+
+    for (size_t i = 0; i < C_OPERATOR_COUNT; i++) {
+        const LexerCOperatorEntry* entry = &s_COperators[i];
+        if (entry->length == length && TOKEN_OPERATOR_CODE_TYPE(entry->code) != OPERATOR_TYPE_NONE &&
+            memcmp(entry->text, lexeme, length) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+static uint32_t PARSER_PTR LexerCGetOperatorType(const char* lexeme, size_t length)
+{
+    for (size_t i = 0; i < C_OPERATOR_COUNT; i++) {
+        const LexerCOperatorEntry* entry = &s_COperators[i];
+        if (entry->length == length && memcmp(entry->text, lexeme, length) == 0)
+            return entry->code;
+    }
+
+    return TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_NONE);
+}
+
+PARSER_ATTR LexerCKeyword PARSER_CALL LexerCLookupKeyword(
+    const char* lexeme,
+    size_t length)
+{
+    if (length < 2 || length > C_KEYWORD_MAX_LENGTH)
+        return C_KEYWORD_NONE;
+
+    for (uint32_t i = s_CKeywordsByLength[length]; i < s_CKeywordsByLength[length + 1]; i++) {
+        if (s_CKeywords[i].text[0] == lexeme[0] && memcmp(s_CKeywords[i].text, lexeme, length) == 0)
+            return s_CKeywords[i].keyword;
+    }
+
+    return C_KEYWORD_NONE;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Numeric literals
+// ------------------------------------------------------------------------------------------------
+
+/* Significand of a decimal floating constant, first 19 significant digits */
+typedef struct LexerCDecimal {
+    uint64_t mantissa;
+    int64_t exponent;           // Power of ten applied to the mantissa
+    uint32_t digits;            // Significant digits in the mantissa
+    bool truncated;             // Non zero digits were dropped
+    bool any;                   // At least one digit was seen
+} LexerCDecimal;
+
+/* Scan the digits of the integer (fraction = 0) or fraction (fraction = 1) part */
+static const uint8_t* LexerCScanSignificand(const uint8_t* p, const uint8_t* end, LexerCDecimal* decimal, int fraction)
+{
+    while (p < end) {
+        // Eight digits at once while they all fit in the mantissa
+        if (decimal->digits != 0 && decimal->digits + 8 <= 19 && end - p >= 8) {
+            uint64_t chunk = LexerLoad8(p);
+            if (LexerIsEightDigits(chunk)) {
+                decimal->mantissa = decimal->mantissa * 100000000u + LexerParseEightDigits(chunk);
+                decimal->digits += 8;
+                decimal->exponent -= 8 * fraction;
+                p += 8;
+                continue;
+            }
+        }
+
+        if (!C_IS(*p, C_CLASS_DIGIT))
+            break;
+
+        uint32_t digit = (uint32_t)(*p++ - '0');
+        decimal->any = true;
+
+        if (decimal->digits == 0 && digit == 0) {
+            // Leading zero
+            decimal->exponent -= fraction;
+        }
+        else if (decimal->digits < 19) {
+            decimal->mantissa = decimal->mantissa * 10 + digit;
+            decimal->digits++;
+            decimal->exponent -= fraction;
+        }
+        else {
+            decimal->exponent += 1 - fraction;
+            decimal->truncated |= digit != 0;
+        }
+    }
+
+    return p;
+}
+
+/* Parse the suffix [p, end), false for anything C does not allow */
+static bool LexerCParseSuffix(const uint8_t* p, const uint8_t* end, bool isFloat, uint16_t* suffix)
+{
+    uint16_t flags = LITERAL_SUFFIX_NONE;
+
+    if (isFloat) {
+        if (end - p == 1 && (*p == 'f' || *p == 'F'))
+            flags = LITERAL_SUFFIX_FLOAT;
+        else if (end - p == 1 && (*p == 'l' || *p == 'L'))
+            flags = LITERAL_SUFFIX_LONG;
+        else if (p != end)
+            return false;
+
+        *suffix = flags;
+        return true;
+    }
+
+    while (p < end) {
+        if ((*p == 'u' || *p == 'U') && !(flags & LITERAL_SUFFIX_UNSIGNED)) {
+            flags |= LITERAL_SUFFIX_UNSIGNED;
+            p++;
+        }
+        else if ((*p == 'l' || *p == 'L') && !(flags & (LITERAL_SUFFIX_LONG | LITERAL_SUFFIX_LONG_LONG))) {
+            // ll and LL, but not lL
+            if (end - p >= 2 && p[1] == p[0]) {
+                flags |= LITERAL_SUFFIX_LONG_LONG;
+                p += 2;
+            }
+            else {
+                flags |= LITERAL_SUFFIX_LONG;
+                p++;
+            }
+        }
+        else {
+            return false;
+        }
+    }
+
+    *suffix = flags;
+    return true;
+}
+
+static ParserResult LexerCParseDecimalFloat(const uint8_t* text, const uint8_t* end, LexerLiteral* literal)
+{
+    LexerCDecimal decimal = { 0 };
+
+    const uint8_t* p = LexerCScanSignificand(text, end, &decimal, 0);
+    if (p < end && *p == '.')
+        p = LexerCScanSignificand(p + 1, end, &decimal, 1);
+
+    if (!decimal.any)
+        return PARSER_ERROR_INVALID_NUMBER_FORMAT;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+
+        bool negative = false;
+        if (p < end && (*p == '+' || *p == '-'))
+            negative = *p++ == '-';
+
+        const uint8_t* digits = p;
+        int64_t exponent = 0;
+
+        while (p < end && C_IS(*p, C_CLASS_DIGIT)) {
+            // Saturate, anything this large is zero or infinity anyway
+            if (exponent < 100000)
+                exponent = exponent * 10 + (*p - '0');
+            p++;
+        }
+
+        if (p == digits)
+            return PARSER_ERROR_INVALID_NUMBER_FORMAT;
+
+        decimal.exponent += negative ? -exponent : exponent;
+    }
+
+    if (!LexerCParseSuffix(p, end, true, &literal->suffix))
+        return PARSER_ERROR_INVALID_NUMBER_FORMAT;
+
+    literal->type = LITERAL_TYPE_FLOAT;
+
+    return LexerDecimalToBinary(decimal.mantissa, decimal.exponent, decimal.truncated,
+        (literal->suffix & LITERAL_SUFFIX_FLOAT) != 0, (const char*)text, (size_t)(p - text), &literal->value.floating);
+}
+
+/* 0x and 0b constants, `bits` is the width of one digit */
+static ParserResult LexerCParsePowerOfTwo(const uint8_t* text, const uint8_t* end, uint32_t bits, LexerLiteral* literal)
+{
+    const uint8_t* p = text + 2;
+    const uint8_t* digits = p;
+    uint32_t base = 1u << bits;
+    uint64_t value = 0;
+
+    for (; p < end; p++) {
+        uint8_t digit = g_LexerNibbleTable[*p];
+        if (digit >= base)
+            break;
+
+        if (value >> (64 - bits))
+            return PARSER_ERROR_INVALID_NUMBER_FORMAT;
+
+        value = (value << bits) | digit;
+    }
+
+    // Hexadecimal floating constant, rare enough for the library
+    if (bits == 4 && p < end && (*p == '.' || *p == 'p' || *p == 'P')) {
+        bool any = p > digits;
+        if (*p == '.') {
+            for (p++; p < end && g_LexerNibbleTable[*p] < 16; p++)
+                any = true;
+        }
+
+        if (!any || p == end || (*p != 'p' && *p != 'P'))
+            return PARSER_ERROR_INVALID_NUMBER_FORMAT;
+
+        p++;
+        if (p < end && (*p == '+' || *p == '-'))
+            p++;
+
+        const uint8_t* exponent = p;
+        while (p < end && C_IS(*p, C_CLASS_DIGIT))
+            p++;
+
+        if (p == exponent || !LexerCParseSuffix(p, end, true, &literal->suffix))
+            return PARSER_ERROR_INVALID_NUMBER_FORMAT;
+
+        literal->type = LITERAL_TYPE_FLOAT;
+        return LexerParseFloatFallback((const char*)text, (size_t)(p - text),
+            (literal->suffix & LITERAL_SUFFIX_FLOAT) != 0, &literal->value.floating);
+    }
+
+    if (p == digits || !LexerCParseSuffix(p, end, false, &literal->suffix))
+        return PARSER_ERROR_INVALID_NUMBER_FORMAT;
+
+    literal->value.integer = value;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerCParseNumber(
+    const char* text,
+    size_t length,
+    LexerLiteral* literal)
+{
+    const uint8_t* p = (const uint8_t*)text;
+    const uint8_t* end = p + length;
+
+    if (!text || !literal || length == 0)
+        return PARSER_ERROR_INVALID_ARG;
+
+    literal->value.integer = 0;
+    literal->type = LITERAL_TYPE_INTEGER;
+    literal->suffix = LITERAL_SUFFIX_NONE;
+    literal->base = 10;
+
+    if (length >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        literal->base = 16;
+        return LexerCParsePowerOfTwo(p, end, 4, literal);
+    }
+
+    if (length >= 2 && p[0] == '0' && (p[1] == 'b' || p[1] == 'B')) {
+        literal->base = 2;
+        return LexerCParsePowerOfTwo(p, end, 1, literal);
+    }
+
+    // ===== DECIMAL DIGITS, EIGHT AT A TIME =====
+    uint64_t value = 0;
+    bool overflow = false;
+
+    while (end - p >= 8) {
+        uint64_t chunk = LexerLoad8(p);
+        if (!LexerIsEightDigits(chunk))
+            break;
+
+        uint32_t eight = LexerParseEightDigits(chunk);
+        overflow |= value > (UINT64_MAX - eight) / 100000000u;
+        value = value * 100000000u + eight;
+        p += 8;
+    }
+
+    while (p < end && C_IS(*p, C_CLASS_DIGIT)) {
+        uint32_t digit = (uint32_t)(*p - '0');
+        overflow |= value > (UINT64_MAX - digit) / 10;
+        value = value * 10 + digit;
+        p++;
+    }
+
+    if (p < end && (*p == '.' || *p == 'e' || *p == 'E'))
+        return LexerCParseDecimalFloat((const uint8_t*)text, end, literal);
+
+    // ===== OCTAL =====
+    const uint8_t* digits = (const uint8_t*)text;
+
+    if (digits[0] == '0' && p - digits > 1) {
+        literal->base = 8;
+        value = 0;
+        overflow = false;
+
+        for (const uint8_t* q = digits + 1; q < p; q++) {
+            if (*q > '7')
+                return PARSER_ERROR_INVALID_NUMBER_FORMAT;
+
+            overflow |= (value >> 61) != 0;
+            value = (value << 3) | (uint32_t)(*q - '0');
+        }
+    }
+
+    if (overflow || !LexerCParseSuffix(p, end, false, &literal->suffix))
+        return PARSER_ERROR_INVALID_NUMBER_FORMAT;
+
+    literal->value.integer = value;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Scanners
+// ------------------------------------------------------------------------------------------------
+
+/* Scan a quoted literal, the token has been started and the cursor is on the opening quote */
+static LexerToken LexerCScanQuoted(Lexer lexer, uint8_t quote)
+{
+    const uint8_t* p = lexer->cursor.cur + 1;
+    const uint8_t* end = lexer->cursor.end;
+    uint32_t flags = LEXER_STRING_NONE;
+
+    for (;;) {
+        p = LexerFindQuotedStop(p, end, quote, '\\');
+        if (p >= end || *p == '\n')
+            break;
+
+        if (*p == quote) {
+            // Without escapes there is no line splice and no newline to count
+            if (flags)
+                LexerConsumeTo(lexer, p + 1);
+            else
+                LexerConsume(lexer, (size_t)(p + 1 - lexer->cursor.cur));
+
+            lexer->scanToken.value = flags;
+            return LexerEndToken(lexer);
+        }
+
+        // Escape sequence, a backslash-newline splices the next line
+        flags |= LEXER_STRING_HAS_ESCAPES;
+        p += 2;
+    }
+
+    LexerConsumeTo(lexer, p < end ? p : end);
+    return LexerSetError(lexer, PARSER_ERROR_UNTERMINATED_STRING, "Unterminated literal");
+}
+
+static LexerToken PARSER_PTR LexerCParseStringLiteral(Lexer lexer)
+{
+    LexerBeginToken(lexer, TOKEN_TYPE_LITERAL, LITERAL_TYPE_STRING, 0);
+    return LexerCScanQuoted(lexer, '"');
+}
+
+static LexerToken PARSER_PTR LexerCParseCharLiteral(Lexer lexer)
+{
+    LexerBeginToken(lexer, TOKEN_TYPE_LITERAL, LITERAL_TYPE_CHAR, 0);
+    return LexerCScanQuoted(lexer, '\'');
+}
+
+static LexerToken PARSER_PTR LexerCParseNumericLiteral(Lexer lexer)
+{
+    LexerBeginToken(lexer, TOKEN_TYPE_LITERAL, LITERAL_TYPE_INTEGER, 0);
+
+    const uint8_t* p = lexer->cursor.cur;
+    const uint8_t* end = lexer->cursor.end;
+
+    bool hex = (end - p) >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X');
+    bool isFloat = false;
+
+    // Preprocessing number: digits, identifier characters, dots and signed exponents
+    while (p < end) {
+        uint8_t c = *p;
+
+        if (c == '.') {
+            isFloat = true;
+            p++;
+        }
+        else if (((c == 'e' || c == 'E') && !hex) || ((c == 'p' || c == 'P') && hex)) {
+            isFloat = true;
+            p++;
+            if (p < end && (*p == '+' || *p == '-'))
+                p++;
+        }
+        else if (C_IS(c, C_CLASS_IDENT_CHAR)) {
+            p++;
+        }
+        else {
+            break;
+        }
+    }
+
+    if (isFloat)
+        lexer->scanToken.kind = LITERAL_TYPE_FLOAT;
+
+    // ===== CONVERT IN THE SAME PASS =====
+    const char* text = (const char*)lexer->cursor.cur;
+    size_t length = (size_t)(p - lexer->cursor.cur);
+
+    // Literals are written to images as they are, the padding must not carry stack bytes
+    LexerLiteral literal;
+    memset(&literal, 0, sizeof(literal));
+    ParserResult result = LexerCParseNumber(text, length, &literal);
+    LexerConsume(lexer, length);
+
+    if (result == PARSER_RESULT_SUCCESS)
+        result = LexerPushLiteral(lexer, &literal, &lexer->scanToken.value);
+
+    if (result != PARSER_RESULT_SUCCESS)
+        return LexerSetError(lexer, result, LexerLiteralErrorMessage(result));
+
+    lexer->scanToken.kind = literal.type;
+    return LexerEndToken(lexer);
+}
+
+static LexerToken PARSER_PTR LexerCParseIdentifier(Lexer lexer)
+{
+    LexerBeginToken(lexer, TOKEN_TYPE_IDENTIFIER, 0, 0);
+
+    const uint8_t* start = lexer->cursor.cur;
+    const uint8_t* p = start + 1;
+    const uint8_t* end = lexer->cursor.end;
+
+    while (p < end && C_IS(*p, C_CLASS_IDENT_CHAR))
+        p++;
+
+    size_t length = (size_t)(p - start);
+
+    // Encoding prefixes of string and character literals: L"", u"", U"", u8""
+    if (p < end && (*p == '"' || *p == '\'') &&
+        ((length == 1 && (start[0] == 'L' || start[0] == 'u' || start[0] == 'U')) ||
+         (length == 2 && start[0] == 'u' && start[1] == '8'))) {
+        uint8_t quote = *p;
+        LexerConsume(lexer, length);
+        lexer->scanToken.flags = TOKEN_TYPE_LITERAL;
+        lexer->scanToken.kind = quote == '"' ? LITERAL_TYPE_STRING : LITERAL_TYPE_CHAR;
+        return LexerCScanQuoted(lexer, quote);
+    }
+
+    LexerCKeyword keyword = LexerCLookupKeyword((const char*)start, length);
+    if (keyword != C_KEYWORD_NONE) {
+        lexer->scanToken.flags = TOKEN_TYPE_KEYWORD;
+        lexer->scanToken.value = keyword;
+    }
+
+    LexerConsume(lexer, length);
+    return LexerEndToken(lexer);
+}
+
+static LexerToken PARSER_PTR LexerCParseKeyword(Lexer lexer)
+{
+    return LexerCParseIdentifier(lexer);
+}
+
+static LexerToken PARSER_PTR LexerCParseOperator(Lexer lexer)
+{
+    const char* text = (const char*)lexer->cursor.cur;
+    size_t remaining = LexerRemaining(lexer);
+
+    // .5 is a floating constant, not member access
+    if (text[0] == '.' && remaining >= 2 && C_IS(text[1], C_CLASS_DIGIT))
+        return LexerCParseNumericLiteral(lexer);
+
+    LexerBeginToken(lexer, TOKEN_TYPE_OPERATOR, 0, 0);
+
+    for (size_t i = 0; i < C_OPERATOR_COUNT; i++) {
+        const LexerCOperatorEntry* entry = &s_COperators[i];
+        if (entry->length > remaining || entry->text[0] != text[0] ||
+            memcmp(entry->text, text, entry->length) != 0)
+            continue;
+
+        uint32_t type = TOKEN_OPERATOR_CODE_TYPE(entry->code);
+        if (type == OPERATOR_TYPE_NONE)
+            lexer->scanToken.flags = TOKEN_TYPE_PUNCTUATION;
+
+        lexer->scanToken.kind = (uint16_t)type;
+        lexer->scanToken.value = TOKEN_OPERATOR_CODE_OP(entry->code);
+
+        LexerConsume(lexer, entry->length);
+        return LexerEndToken(lexer);
+    }
+
+    LexerConsume(lexer, 1);
+    return LexerSetError(lexer, PARSER_ERROR_INVALID_OPERATOR_USAGE, "Unknown operator");
+}
+
+static LexerToken PARSER_PTR LexerCParseLineComment(Lexer lexer)
+{
+    LexerBeginToken(lexer, TOKEN_TYPE_COMMENT, 0, 0);
+
+    const uint8_t* p = lexer->cursor.cur + 2;
+    const uint8_t* end = lexer->cursor.end;
+
+    // Runs up to (not including) the newline, a backslash-newline continues the comment
+    while (p < end && *p != '\n') {
+        if (*p == '\\' && p + 1 < end && p[1] == '\n')
+            p += 2;
+        else
+            p++;
+    }
+
+    LexerConsumeTo(lexer, p);
+    return LexerEndToken(lexer);
+}
+
+static LexerToken PARSER_PTR LexerCParseBlockComment(Lexer lexer)
+{
+    LexerBeginToken(lexer, TOKEN_TYPE_COMMENT, 0, 0);
+
+    const uint8_t* p = lexer->cursor.cur + 2;
+    const uint8_t* end = lexer->cursor.end;
+
+    while (p + 1 < end) {
+        const uint8_t* star = memchr(p, '*', (size_t)(end - p - 1));
+        if (!star)
+            break;
+
+        if (star[1] == '/') {
+            LexerConsumeTo(lexer, star + 2);
+            return LexerEndToken(lexer);
+        }
+
+        p = star + 1;
+    }
+
+    LexerConsumeTo(lexer, end);
+    return LexerSetError(lexer, PARSER_ERROR_UNTERMINATED_COMMENT, "Unterminated comment");
+}
+
+// ------------------------------------------------------------------------------------------------
+// Strategy
+// ------------------------------------------------------------------------------------------------
+
+const LexerLanguageStrategy g_CLexerLanguageStrategy = {
+    .languageName = "C11",
+
+    .isIdentifierStart = LexerCIsIdentifierStart,
+    .isIdentifierChar = LexerCIsIdentifierChar,
+
+    .isKeyword = LexerCIsKeyword,
+
+    .isWhitespace = LexerCIsWhitespace,
+
+    .isLineComment = LexerCIsLineComment,
+    .isBlockComment = LexerCIsBlockComment,
+
+    .isStringStart = LexerCIsStringStart,
+    .isCharStart = LexerCIsCharStart,
+    .isNumberStart = LexerCIsNumberStart,
+    .isNumberChar = LexerCIsNumberChar,
+
+    .isPunctuation = LexerCIsPunctuation,
+    .isOperator = LexerCIsOperator,
+    .getOperatorType = LexerCGetOperatorType,
+
+    .parseStringLiteral = LexerCParseStringLiteral,
+    .parseCharLiteral = LexerCParseCharLiteral,
+    .parseNumericalLiteral = LexerCParseNumericLiteral,
+
+    .parseIdentifier = LexerCParseIdentifier,
+
+    .parseKeywords = LexerCParseKeyword,
+
+    .parseOperator = LexerCParseOperator,
+
+    .parseLineComments = LexerCParseLineComment,
+    .parseBlockComments = LexerCParseBlockComment,
+
+    .userData = NULL,
+};
+
+// ------------------------------------------------------------------------------------------------
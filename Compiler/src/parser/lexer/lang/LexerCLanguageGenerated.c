@@ -0,0 +1,1295 @@
+// ------------------------------------------------------------------------------------------------
+// Generated by LexerGen from LexerCLanguage.lexdesc, do not edit
+// ------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/lexer/lang/LexerCLanguage.h"
+#include "../LexerInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GEN_COMPUTED_GOTO       1
+#else
+#define GEN_COMPUTED_GOTO       0
+#endif
+
+#define GEN_CLASS_WHITESPACE    0x01
+#define GEN_CLASS_IDENT_START   0x02
+#define GEN_CLASS_IDENT_CHAR    0x04
+#define GEN_CLASS_DIGIT         0x08
+#define GEN_CLASS_HEX_DIGIT     0x10
+#define GEN_CLASS_OPERATOR      0x20
+#define GEN_CLASS_PUNCTUATION   0x40
+
+static const uint8_t s_GenClass[256] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x20, 0x00, 0x40, 0x00, 0x20, 0x20, 0x00, 0x40, 0x40, 0x20, 0x20, 0x40, 0x20, 0x40, 0x20,
+    0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x40, 0x40, 0x20, 0x20, 0x20, 0x20,
+    0x00, 0x16, 0x16, 0x16, 0x16, 0x16, 0x16, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+    0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x40, 0x00, 0x40, 0x20, 0x06,
+    0x00, 0x16, 0x16, 0x16, 0x16, 0x16, 0x16, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+    0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x40, 0x20, 0x40, 0x20, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+#define GEN_IS(c, cls)          ((s_GenClass[(uint8_t)(c)] & (cls)) != 0)
+
+/* Dispatch state of the first byte of a token */
+enum {
+    GEN_STATE_ERROR,
+    GEN_STATE_WHITESPACE,
+    GEN_STATE_COMMENT,
+    GEN_STATE_STRING,
+    GEN_STATE_CHAR,
+    GEN_STATE_NUMBER,
+    GEN_STATE_DOT,
+    GEN_STATE_IDENTIFIER,
+    GEN_STATE_OPERATOR,
+};
+
+static const uint8_t s_GenState[256] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x08, 0x03, 0x08, 0x00, 0x08, 0x08, 0x04, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x06, 0x02,
+    0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x00, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+    0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x08, 0x00, 0x08, 0x08, 0x07,
+    0x00, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07,
+    0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x07, 0x08, 0x08, 0x08, 0x08, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+typedef struct GenOperatorEntry {
+    const char* text;
+    uint8_t length;
+    uint32_t code;
+} GenOperatorEntry;
+
+static const GenOperatorEntry s_GenOperators[] = {
+    { "<<=", 3, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SHL_ASSIGN) },
+    { ">>=", 3, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SHR_ASSIGN) },
+    { "...", 3, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_ELLIPSIS) },
+    { "++", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_UNARY, UNARY_OPERATOR_INCREMENT) },
+    { "--", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_UNARY, UNARY_OPERATOR_DECREMENT) },
+    { "->", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_ARROW) },
+    { "<<", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHL) },
+    { ">>", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHR) },
+    { "<=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS_EQUAL) },
+    { ">=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER_EQUAL) },
+    { "==", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_EQUAL) },
+    { "!=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_NOT_EQUAL) },
+    { "&&", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_AND) },
+    { "||", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_OR) },
+    { "+=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ADD_ASSIGN) },
+    { "-=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SUBTRACT_ASSIGN) },
+    { "*=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_MULTIPLY_ASSIGN) },
+    { "/=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_DIVIDE_ASSIGN) },
+    { "%=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_MODULO_ASSIGN) },
+    { "&=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_AND_ASSIGN) },
+    { "|=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_OR_ASSIGN) },
+    { "^=", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_XOR_ASSIGN) },
+    { "##", 2, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_HASH_HASH) },
+    { "+", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_ADD) },
+    { "-", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_SUBTRACT) },
+    { "*", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MULTIPLY) },
+    { "/", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_DIVIDE) },
+    { "%", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MODULO) },
+    { "&", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_AND) },
+    { "|", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_OR) },
+    { "^", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_XOR) },
+    { "~", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_NOT) },
+    { "!", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_NOT) },
+    { "<", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS) },
+    { ">", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER) },
+    { "=", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ASSIGN) },
+    { "?", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_TERNARY, TERNARY_OPERATOR_CONDITIONAL) },
+    { "(", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_LPAREN) },
+    { ")", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_RPAREN) },
+    { "[", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_LBRACKET) },
+    { "]", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_RBRACKET) },
+    { "{", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_LBRACE) },
+    { "}", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_RBRACE) },
+    { ";", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_SEMICOLON) },
+    { ",", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_COMMA) },
+    { ":", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_COLON) },
+    { ".", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_DOT) },
+    { "#", 1, TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_HASH) },
+};
+
+#define GEN_OPERATOR_COUNT      (sizeof(s_GenOperators) / sizeof(s_GenOperators[0]))
+
+/* Advance line and column over [from, to) */
+static inline void LexerCGeneratedAdvance(const uint8_t* from, const uint8_t* to, ParserSize* line, ParserSize* column)
+{
+    for (const uint8_t* p = from; p < to; p++) {
+        if (*p == '\n') {
+            (*line)++;
+            *column = 0;
+        }
+        else {
+            (*column)++;
+        }
+    }
+}
+
+/* Put the erroneous token [start, cursor) into the scan slot and record the error */
+static void LexerCGeneratedError(Lexer lexer, const uint8_t* start, TokenTypeFlags flags, uint16_t kind, ParserResult result, const char* message)
+{
+    const uint8_t* cursor = lexer->cursor.cur;
+    lexer->cursor.cur = start;
+    LexerBeginToken(lexer, flags, kind, 0);
+    lexer->cursor.cur = cursor;
+    LexerSetError(lexer, result, message);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Keywords
+// ------------------------------------------------------------------------------------------------
+
+static inline uint32_t LexerCGeneratedKeyword(const uint8_t* s, size_t length)
+{
+    switch (length) {
+    case 2:
+        switch (s[0]) {
+        case 'd':
+            if (memcmp(s + 1, "o", 1) == 0) return C_KEYWORD_DO;
+            break;
+        case 'i':
+            if (memcmp(s + 1, "f", 1) == 0) return C_KEYWORD_IF;
+            break;
+        }
+        break;
+    case 3:
+        switch (s[0]) {
+        case 'f':
+            if (memcmp(s + 1, "or", 2) == 0) return C_KEYWORD_FOR;
+            break;
+        case 'i':
+            if (memcmp(s + 1, "nt", 2) == 0) return C_KEYWORD_INT;
+            break;
+        }
+        break;
+    case 4:
+        switch (s[0]) {
+        case 'a':
+            if (memcmp(s + 1, "uto", 3) == 0) return C_KEYWORD_AUTO;
+            break;
+        case 'c':
+            if (memcmp(s + 1, "ase", 3) == 0) return C_KEYWORD_CASE;
+            if (memcmp(s + 1, "har", 3) == 0) return C_KEYWORD_CHAR;
+            break;
+        case 'e':
+            if (memcmp(s + 1, "lse", 3) == 0) return C_KEYWORD_ELSE;
+            if (memcmp(s + 1, "num", 3) == 0) return C_KEYWORD_ENUM;
+            break;
+        case 'g':
+            if (memcmp(s + 1, "oto", 3) == 0) return C_KEYWORD_GOTO;
+            break;
+        case 'l':
+            if (memcmp(s + 1, "ong", 3) == 0) return C_KEYWORD_LONG;
+            break;
+        case 'v':
+            if (memcmp(s + 1, "oid", 3) == 0) return C_KEYWORD_VOID;
+            break;
+        }
+        break;
+    case 5:
+        switch (s[0]) {
+        case '_':
+            if (memcmp(s + 1, "Bool", 4) == 0) return C_KEYWORD_BOOL;
+            break;
+        case 'b':
+            if (memcmp(s + 1, "reak", 4) == 0) return C_KEYWORD_BREAK;
+            break;
+        case 'c':
+            if (memcmp(s + 1, "onst", 4) == 0) return C_KEYWORD_CONST;
+            break;
+        case 'f':
+            if (memcmp(s + 1, "loat", 4) == 0) return C_KEYWORD_FLOAT;
+            break;
+        case 's':
+            if (memcmp(s + 1, "hort", 4) == 0) return C_KEYWORD_SHORT;
+            break;
+        case 'u':
+            if (memcmp(s + 1, "nion", 4) == 0) return C_KEYWORD_UNION;
+            break;
+        case 'w':
+            if (memcmp(s + 1, "hile", 4) == 0) return C_KEYWORD_WHILE;
+            break;
+        }
+        break;
+    case 6:
+        switch (s[0]) {
+        case 'd':
+            if (memcmp(s + 1, "ouble", 5) == 0) return C_KEYWORD_DOUBLE;
+            break;
+        case 'e':
+            if (memcmp(s + 1, "xtern", 5) == 0) return C_KEYWORD_EXTERN;
+            break;
+        case 'i':
+            if (memcmp(s + 1, "nline", 5) == 0) return C_KEYWORD_INLINE;
+            break;
+        case 'r':
+            if (memcmp(s + 1, "eturn", 5) == 0) return C_KEYWORD_RETURN;
+            break;
+        case 's':
+            if (memcmp(s + 1, "igned", 5) == 0) return C_KEYWORD_SIGNED;
+            if (memcmp(s + 1, "izeof", 5) == 0) return C_KEYWORD_SIZEOF;
+            if (memcmp(s + 1, "tatic", 5) == 0) return C_KEYWORD_STATIC;
+            if (memcmp(s + 1, "truct", 5) == 0) return C_KEYWORD_STRUCT;
+            if (memcmp(s + 1, "witch", 5) == 0) return C_KEYWORD_SWITCH;
+            break;
+        }
+        break;
+    case 7:
+        switch (s[0]) {
+        case '_':
+            if (memcmp(s + 1, "Atomic", 6) == 0) return C_KEYWORD_ATOMIC;
+            break;
+        case 'd':
+            if (memcmp(s + 1, "efault", 6) == 0) return C_KEYWORD_DEFAULT;
+            break;
+        case 't':
+            if (memcmp(s + 1, "ypedef", 6) == 0) return C_KEYWORD_TYPEDEF;
+            break;
+        }
+        break;
+    case 8:
+        switch (s[0]) {
+        case '_':
+            if (memcmp(s + 1, "Alignas", 7) == 0) return C_KEYWORD_ALIGNAS;
+            if (memcmp(s + 1, "Alignof", 7) == 0) return C_KEYWORD_ALIGNOF;
+            if (memcmp(s + 1, "Complex", 7) == 0) return C_KEYWORD_COMPLEX;
+            if (memcmp(s + 1, "Generic", 7) == 0) return C_KEYWORD_GENERIC;
+            break;
+        case 'c':
+            if (memcmp(s + 1, "ontinue", 7) == 0) return C_KEYWORD_CONTINUE;
+            break;
+        case 'r':
+            if (memcmp(s + 1, "egister", 7) == 0) return C_KEYWORD_REGISTER;
+            if (memcmp(s + 1, "estrict", 7) == 0) return C_KEYWORD_RESTRICT;
+            break;
+        case 'u':
+            if (memcmp(s + 1, "nsigned", 7) == 0) return C_KEYWORD_UNSIGNED;
+            break;
+        case 'v':
+            if (memcmp(s + 1, "olatile", 7) == 0) return C_KEYWORD_VOLATILE;
+            break;
+        }
+        break;
+    case 9:
+        switch (s[0]) {
+        case '_':
+            if (memcmp(s + 1, "Noreturn", 8) == 0) return C_KEYWORD_NORETURN;
+            break;
+        }
+        break;
+    case 10:
+        switch (s[0]) {
+        case '_':
+            if (memcmp(s + 1, "Imaginary", 9) == 0) return C_KEYWORD_IMAGINARY;
+            break;
+        }
+        break;
+    case 13:
+        switch (s[0]) {
+        case '_':
+            if (memcmp(s + 1, "Thread_local", 12) == 0) return C_KEYWORD_THREAD_LOCAL;
+            break;
+        }
+        break;
+    case 14:
+        switch (s[0]) {
+        case '_':
+            if (memcmp(s + 1, "Static_assert", 13) == 0) return C_KEYWORD_STATIC_ASSERT;
+            break;
+        }
+        break;
+    }
+
+    return 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Scanner
+// ------------------------------------------------------------------------------------------------
+
+#if GEN_COMPUTED_GOTO
+#define GEN_DISPATCH(c)         goto *s_dispatch[s_GenState[(c)]]
+#else
+#define GEN_DISPATCH(c)                                 \
+    switch (s_GenState[(c)]) {                          \
+    case GEN_STATE_WHITESPACE:   goto state_whitespace; \
+    case GEN_STATE_COMMENT:      goto state_comment;    \
+    case GEN_STATE_STRING:       goto state_string;     \
+    case GEN_STATE_CHAR:         goto state_char;       \
+    case GEN_STATE_NUMBER:       goto state_number;     \
+    case GEN_STATE_DOT:          goto state_dot;        \
+    case GEN_STATE_IDENTIFIER:   goto state_identifier; \
+    case GEN_STATE_OPERATOR:     goto state_operator;   \
+    default:                     goto state_error;      \
+    }
+#endif
+
+#define GEN_SYNC()                      \
+    do {                                \
+        lexer->cursor.cur = p;          \
+        lexer->line = line;             \
+        lexer->column = column;         \
+    } while (0)
+
+#define GEN_OPERATOR(n, f, k, v)        \
+    do {                                \
+        p += (n);                       \
+        flags = (f);                    \
+        kind = (k);                     \
+        value = (v);                    \
+        goto operator_done;             \
+    } while (0)
+
+static bool PARSER_PTR LexerCGeneratedScanToken(
+    Lexer lexer,
+    LexerToken token)
+{
+#if GEN_COMPUTED_GOTO
+    static const void* const s_dispatch[] = {
+        &&state_error,
+        &&state_whitespace,
+        &&state_comment,
+        &&state_string,
+        &&state_char,
+        &&state_number,
+        &&state_dot,
+        &&state_identifier,
+        &&state_operator,
+    };
+#endif
+
+    const uint8_t* p = lexer->cursor.cur;
+    const uint8_t* const end = lexer->cursor.end;
+    const uint8_t* const limit = lexer->limit;
+    const uint8_t* start = p;
+    ParserSize line = lexer->line;
+    ParserSize column = lexer->column;
+    ParserSize tokenLine = line;
+    ParserSize tokenColumn = column;
+    uint32_t flags = TOKEN_TYPE_EOF;
+    uint32_t kind = 0;
+    uint32_t value = 0;
+
+    if (lexer->hasError)
+        goto token_error;
+
+next:
+    if (p >= limit)
+        goto stop;
+    GEN_DISPATCH(*p);
+
+state_whitespace:
+    start = p;
+    do {
+        uint8_t c = *p++;
+        if (c == '\n') {
+            line++;
+            column = 0;
+        }
+        else if (c == '\t') {
+            column += 4;
+        }
+        else {
+            column++;
+        }
+    } while (p < limit && GEN_IS(*p, GEN_CLASS_WHITESPACE));
+    goto next;
+
+state_comment:
+    if (end - p >= 2 && p[1] == '/')
+        goto line_comment;
+    if (end - p >= 2 && p[1] == '*')
+        goto block_comment;
+    goto state_operator;
+
+line_comment:
+    start = p;
+    p += 2;
+    while (p < end && *p != '\n') {
+        if (*p == '\\' && p + 1 < end && p[1] == '\n')
+            p += 2;
+        else
+            p++;
+    }
+    LexerCGeneratedAdvance(start, p, &line, &column);
+    goto next;
+
+block_comment:
+    start = p;
+    p += 2;
+    for (;;) {
+        const uint8_t* close = end - p >= 2 ? memchr(p, '*', (size_t)(end - p - 1)) : NULL;
+        if (!close) {
+            p = end;
+            goto comment_error;
+        }
+        if (close[1] == '/') {
+            p = close + 2;
+            break;
+        }
+        p = close + 1;
+    }
+    LexerCGeneratedAdvance(start, p, &line, &column);
+    goto next;
+
+comment_error:
+    LexerCGeneratedAdvance(start, p, &line, &column);
+    GEN_SYNC();
+    LexerCGeneratedError(lexer, start, TOKEN_TYPE_COMMENT, 0, PARSER_ERROR_UNTERMINATED_COMMENT, "Unterminated comment");
+    goto token_error;
+
+state_string:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    flags = TOKEN_TYPE_LITERAL;
+    kind = LITERAL_TYPE_STRING;
+string_body:
+    p++;
+    value = LEXER_STRING_NONE;
+    for (;;) {
+        p = LexerFindQuotedStop(p, end, '"', '\\');
+        if (p >= end || *p == '\n')
+            goto literal_error;
+        if (*p == '"') {
+            p++;
+            if (value)
+                LexerCGeneratedAdvance(start, p, &line, &column);
+            else
+                column += (ParserSize)(p - start);
+            goto emit;
+        }
+        value |= LEXER_STRING_HAS_ESCAPES;
+        p += 2;
+    }
+
+state_char:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    flags = TOKEN_TYPE_LITERAL;
+    kind = LITERAL_TYPE_CHAR;
+char_body:
+    p++;
+    value = LEXER_STRING_NONE;
+    for (;;) {
+        p = LexerFindQuotedStop(p, end, '\'', '\\');
+        if (p >= end || *p == '\n')
+            goto literal_error;
+        if (*p == '\'') {
+            p++;
+            if (value)
+                LexerCGeneratedAdvance(start, p, &line, &column);
+            else
+                column += (ParserSize)(p - start);
+            goto emit;
+        }
+        value |= LEXER_STRING_HAS_ESCAPES;
+        p += 2;
+    }
+
+literal_error:
+    if (p > end)
+        p = end;
+    LexerCGeneratedAdvance(start, p, &line, &column);
+    GEN_SYNC();
+    LexerCGeneratedError(lexer, start, TOKEN_TYPE_LITERAL, (uint16_t)kind, PARSER_ERROR_UNTERMINATED_STRING, "Unterminated literal");
+    goto token_failed;
+
+state_dot:
+    if (end - p >= 2 && GEN_IS(p[1], GEN_CLASS_DIGIT))
+        goto state_number;
+    goto state_operator;
+
+state_number:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    flags = TOKEN_TYPE_LITERAL;
+    kind = LITERAL_TYPE_INTEGER;
+    value = 0;
+    {
+        bool hex = (end - p >= 2 && p[0] == '0' && p[1] == 'x') || (end - p >= 2 && p[0] == '0' && p[1] == 'X');
+        while (p < end) {
+            uint8_t c = *p;
+            if (c == '.') {
+                kind = LITERAL_TYPE_FLOAT;
+                p++;
+            }
+            else if ((!hex && (0 || c == 'e' || c == 'E')) || (hex && (0 || c == 'p' || c == 'P'))) {
+                kind = LITERAL_TYPE_FLOAT;
+                p++;
+                if (p < end && (*p == '+' || *p == '-'))
+                    p++;
+            }
+            else if (GEN_IS(c, GEN_CLASS_IDENT_CHAR)) {
+                p++;
+            }
+            else {
+                break;
+            }
+        }
+    }
+    column += (ParserSize)(p - start);
+    {
+        LexerLiteral literal;
+        memset(&literal, 0, sizeof(literal));
+        ParserResult result = LexerCParseNumber((const char*)start, (size_t)(p - start), &literal);
+        if (result == PARSER_RESULT_SUCCESS)
+            result = LexerPushLiteral(lexer, &literal, &value);
+        if (result != PARSER_RESULT_SUCCESS) {
+            GEN_SYNC();
+            LexerCGeneratedError(lexer, start, TOKEN_TYPE_LITERAL, (uint16_t)kind, result, LexerLiteralErrorMessage(result));
+            goto token_failed;
+        }
+        kind = literal.type;
+    }
+    goto emit;
+
+state_identifier:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    p++;
+    while (p < end && GEN_IS(*p, GEN_CLASS_IDENT_CHAR))
+        p++;
+    if (p < end && ((p - start == 1 && start[0] == 'L') ||
+         (p - start == 1 && start[0] == 'u') ||
+         (p - start == 1 && start[0] == 'U') ||
+         (p - start == 2 && start[0] == 'u' && start[1] == '8'))) {
+        flags = TOKEN_TYPE_LITERAL;
+        if (*p == '"') {
+            kind = LITERAL_TYPE_STRING;
+            goto string_body;
+        }
+        if (*p == '\'') {
+            kind = LITERAL_TYPE_CHAR;
+            goto char_body;
+        }
+    }
+    value = LexerCGeneratedKeyword(start, (size_t)(p - start));
+    flags = value ? TOKEN_TYPE_KEYWORD : TOKEN_TYPE_IDENTIFIER;
+    kind = 0;
+    column += (ParserSize)(p - start);
+    goto emit;
+
+state_operator:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    switch (*p) {
+    case '!':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_NOT_EQUAL);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_NOT);
+    case '#':
+        if (end - p >= 2 && p[1] == '#')
+            GEN_OPERATOR(2, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_HASH_HASH);
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_HASH);
+    case '%':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_MODULO_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MODULO);
+    case '&':
+        if (end - p >= 2 && p[1] == '&')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_AND);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_AND_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_AND);
+    case '(':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_LPAREN);
+    case ')':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_RPAREN);
+    case '*':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_MULTIPLY_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MULTIPLY);
+    case '+':
+        if (end - p >= 2 && p[1] == '+')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_UNARY, UNARY_OPERATOR_INCREMENT);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ADD_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_ADD);
+    case ',':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_COMMA);
+    case '-':
+        if (end - p >= 2 && p[1] == '-')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_UNARY, UNARY_OPERATOR_DECREMENT);
+        if (end - p >= 2 && p[1] == '>')
+            GEN_OPERATOR(2, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_ARROW);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SUBTRACT_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_SUBTRACT);
+    case '.':
+        if (end - p >= 3 && p[1] == '.' && p[2] == '.')
+            GEN_OPERATOR(3, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_ELLIPSIS);
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_DOT);
+    case '/':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_DIVIDE_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_DIVIDE);
+    case ':':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_COLON);
+    case ';':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_SEMICOLON);
+    case '<':
+        if (end - p >= 3 && p[1] == '<' && p[2] == '=')
+            GEN_OPERATOR(3, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SHL_ASSIGN);
+        if (end - p >= 2 && p[1] == '<')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHL);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS_EQUAL);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS);
+    case '=':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_EQUAL);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ASSIGN);
+    case '>':
+        if (end - p >= 3 && p[1] == '>' && p[2] == '=')
+            GEN_OPERATOR(3, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SHR_ASSIGN);
+        if (end - p >= 2 && p[1] == '>')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHR);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER_EQUAL);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER);
+    case '?':
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_TERNARY, TERNARY_OPERATOR_CONDITIONAL);
+    case '[':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_LBRACKET);
+    case ']':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_RBRACKET);
+    case '^':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_XOR_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_XOR);
+    case '{':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_LBRACE);
+    case '|':
+        if (end - p >= 2 && p[1] == '|')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_OR);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_OR_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_OR);
+    case '}':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_RBRACE);
+    case '~':
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_NOT);
+    default:
+        break;
+    }
+    goto state_error;
+
+operator_done:
+    column += (ParserSize)(p - start);
+    goto emit;
+
+state_error:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    p++;
+    column++;
+    GEN_SYNC();
+    LexerCGeneratedError(lexer, start, TOKEN_TYPE_ERROR, 0, PARSER_ERROR_UNEXPECTED_TOKEN, "Unexpected character");
+    goto token_failed;
+
+stop:
+    if (p < end) {
+        GEN_SYNC();
+        return false;
+    }
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    flags = TOKEN_TYPE_EOF;
+    kind = 0;
+    value = 0;
+
+emit:
+    token->lexeme = (const char*)start;
+    token->length = (uint32_t)(p - start);
+    token->flags = (uint16_t)flags;
+    token->kind = (uint16_t)kind;
+    token->value = value;
+    token->line = (uint32_t)tokenLine;
+    token->column = (uint32_t)tokenColumn;
+    GEN_SYNC();
+    lexer->scanIndex++;
+    return true;
+
+token_error:
+    tokenLine = lexer->line = line;
+    tokenColumn = lexer->column = column;
+token_failed:
+    *token = lexer->scanToken;
+    token->line = (uint32_t)tokenLine;
+    token->column = (uint32_t)tokenColumn;
+    lexer->scanIndex++;
+    return true;
+}
+
+static bool PARSER_PTR LexerCGeneratedScanTokenTrivia(
+    Lexer lexer,
+    LexerToken token)
+{
+#if GEN_COMPUTED_GOTO
+    static const void* const s_dispatch[] = {
+        &&state_error,
+        &&state_whitespace,
+        &&state_comment,
+        &&state_string,
+        &&state_char,
+        &&state_number,
+        &&state_dot,
+        &&state_identifier,
+        &&state_operator,
+    };
+#endif
+
+    const uint8_t* p = lexer->cursor.cur;
+    const uint8_t* const end = lexer->cursor.end;
+    const uint8_t* const limit = lexer->limit;
+    const uint8_t* start = p;
+    ParserSize line = lexer->line;
+    ParserSize column = lexer->column;
+    ParserSize tokenLine = line;
+    ParserSize tokenColumn = column;
+    uint32_t flags = TOKEN_TYPE_EOF;
+    uint32_t kind = 0;
+    uint32_t value = 0;
+
+    if (lexer->hasError)
+        goto token_error;
+
+next:
+    if (p >= limit)
+        goto stop;
+    GEN_DISPATCH(*p);
+
+state_whitespace:
+    start = p;
+    do {
+        uint8_t c = *p++;
+        if (c == '\n') {
+            line++;
+            column = 0;
+        }
+        else if (c == '\t') {
+            column += 4;
+        }
+        else {
+            column++;
+        }
+    } while (p < limit && GEN_IS(*p, GEN_CLASS_WHITESPACE));
+    if (lexer->preserveWhitespace) {
+        LexerPushTrivia(lexer, start, p, LEXER_TRIVIA_WHITESPACE);
+        if (lexer->hasError)
+            goto token_error;
+    }
+    goto next;
+
+state_comment:
+    if (end - p >= 2 && p[1] == '/')
+        goto line_comment;
+    if (end - p >= 2 && p[1] == '*')
+        goto block_comment;
+    goto state_operator;
+
+line_comment:
+    start = p;
+    p += 2;
+    while (p < end && *p != '\n') {
+        if (*p == '\\' && p + 1 < end && p[1] == '\n')
+            p += 2;
+        else
+            p++;
+    }
+    LexerCGeneratedAdvance(start, p, &line, &column);
+    if (lexer->preserveComments) {
+        LexerPushTrivia(lexer, start, p, LEXER_TRIVIA_LINE_COMMENT);
+        if (lexer->hasError)
+            goto token_error;
+    }
+    goto next;
+
+block_comment:
+    start = p;
+    p += 2;
+    for (;;) {
+        const uint8_t* close = end - p >= 2 ? memchr(p, '*', (size_t)(end - p - 1)) : NULL;
+        if (!close) {
+            p = end;
+            goto comment_error;
+        }
+        if (close[1] == '/') {
+            p = close + 2;
+            break;
+        }
+        p = close + 1;
+    }
+    LexerCGeneratedAdvance(start, p, &line, &column);
+    if (lexer->preserveComments) {
+        LexerPushTrivia(lexer, start, p, LEXER_TRIVIA_BLOCK_COMMENT);
+        if (lexer->hasError)
+            goto token_error;
+    }
+    goto next;
+
+comment_error:
+    LexerCGeneratedAdvance(start, p, &line, &column);
+    if (lexer->preserveComments) {
+        LexerPushTrivia(lexer, start, p, LEXER_TRIVIA_BLOCK_COMMENT);
+        if (lexer->hasError)
+            goto token_error;
+    }
+    GEN_SYNC();
+    LexerCGeneratedError(lexer, start, TOKEN_TYPE_COMMENT, 0, PARSER_ERROR_UNTERMINATED_COMMENT, "Unterminated comment");
+    goto token_error;
+
+state_string:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    flags = TOKEN_TYPE_LITERAL;
+    kind = LITERAL_TYPE_STRING;
+string_body:
+    p++;
+    value = LEXER_STRING_NONE;
+    for (;;) {
+        p = LexerFindQuotedStop(p, end, '"', '\\');
+        if (p >= end || *p == '\n')
+            goto literal_error;
+        if (*p == '"') {
+            p++;
+            if (value)
+                LexerCGeneratedAdvance(start, p, &line, &column);
+            else
+                column += (ParserSize)(p - start);
+            goto emit;
+        }
+        value |= LEXER_STRING_HAS_ESCAPES;
+        p += 2;
+    }
+
+state_char:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    flags = TOKEN_TYPE_LITERAL;
+    kind = LITERAL_TYPE_CHAR;
+char_body:
+    p++;
+    value = LEXER_STRING_NONE;
+    for (;;) {
+        p = LexerFindQuotedStop(p, end, '\'', '\\');
+        if (p >= end || *p == '\n')
+            goto literal_error;
+        if (*p == '\'') {
+            p++;
+            if (value)
+                LexerCGeneratedAdvance(start, p, &line, &column);
+            else
+                column += (ParserSize)(p - start);
+            goto emit;
+        }
+        value |= LEXER_STRING_HAS_ESCAPES;
+        p += 2;
+    }
+
+literal_error:
+    if (p > end)
+        p = end;
+    LexerCGeneratedAdvance(start, p, &line, &column);
+    GEN_SYNC();
+    LexerCGeneratedError(lexer, start, TOKEN_TYPE_LITERAL, (uint16_t)kind, PARSER_ERROR_UNTERMINATED_STRING, "Unterminated literal");
+    goto token_failed;
+
+state_dot:
+    if (end - p >= 2 && GEN_IS(p[1], GEN_CLASS_DIGIT))
+        goto state_number;
+    goto state_operator;
+
+state_number:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    flags = TOKEN_TYPE_LITERAL;
+    kind = LITERAL_TYPE_INTEGER;
+    value = 0;
+    {
+        bool hex = (end - p >= 2 && p[0] == '0' && p[1] == 'x') || (end - p >= 2 && p[0] == '0' && p[1] == 'X');
+        while (p < end) {
+            uint8_t c = *p;
+            if (c == '.') {
+                kind = LITERAL_TYPE_FLOAT;
+                p++;
+            }
+            else if ((!hex && (0 || c == 'e' || c == 'E')) || (hex && (0 || c == 'p' || c == 'P'))) {
+                kind = LITERAL_TYPE_FLOAT;
+                p++;
+                if (p < end && (*p == '+' || *p == '-'))
+                    p++;
+            }
+            else if (GEN_IS(c, GEN_CLASS_IDENT_CHAR)) {
+                p++;
+            }
+            else {
+                break;
+            }
+        }
+    }
+    column += (ParserSize)(p - start);
+    {
+        LexerLiteral literal;
+        memset(&literal, 0, sizeof(literal));
+        ParserResult result = LexerCParseNumber((const char*)start, (size_t)(p - start), &literal);
+        if (result == PARSER_RESULT_SUCCESS)
+            result = LexerPushLiteral(lexer, &literal, &value);
+        if (result != PARSER_RESULT_SUCCESS) {
+            GEN_SYNC();
+            LexerCGeneratedError(lexer, start, TOKEN_TYPE_LITERAL, (uint16_t)kind, result, LexerLiteralErrorMessage(result));
+            goto token_failed;
+        }
+        kind = literal.type;
+    }
+    goto emit;
+
+state_identifier:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    p++;
+    while (p < end && GEN_IS(*p, GEN_CLASS_IDENT_CHAR))
+        p++;
+    if (p < end && ((p - start == 1 && start[0] == 'L') ||
+         (p - start == 1 && start[0] == 'u') ||
+         (p - start == 1 && start[0] == 'U') ||
+         (p - start == 2 && start[0] == 'u' && start[1] == '8'))) {
+        flags = TOKEN_TYPE_LITERAL;
+        if (*p == '"') {
+            kind = LITERAL_TYPE_STRING;
+            goto string_body;
+        }
+        if (*p == '\'') {
+            kind = LITERAL_TYPE_CHAR;
+            goto char_body;
+        }
+    }
+    value = LexerCGeneratedKeyword(start, (size_t)(p - start));
+    flags = value ? TOKEN_TYPE_KEYWORD : TOKEN_TYPE_IDENTIFIER;
+    kind = 0;
+    column += (ParserSize)(p - start);
+    goto emit;
+
+state_operator:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    switch (*p) {
+    case '!':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_NOT_EQUAL);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_NOT);
+    case '#':
+        if (end - p >= 2 && p[1] == '#')
+            GEN_OPERATOR(2, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_HASH_HASH);
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_HASH);
+    case '%':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_MODULO_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MODULO);
+    case '&':
+        if (end - p >= 2 && p[1] == '&')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_AND);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_AND_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_AND);
+    case '(':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_LPAREN);
+    case ')':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_RPAREN);
+    case '*':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_MULTIPLY_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_MULTIPLY);
+    case '+':
+        if (end - p >= 2 && p[1] == '+')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_UNARY, UNARY_OPERATOR_INCREMENT);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ADD_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_ADD);
+    case ',':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_COMMA);
+    case '-':
+        if (end - p >= 2 && p[1] == '-')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_UNARY, UNARY_OPERATOR_DECREMENT);
+        if (end - p >= 2 && p[1] == '>')
+            GEN_OPERATOR(2, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_ARROW);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SUBTRACT_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_SUBTRACT);
+    case '.':
+        if (end - p >= 3 && p[1] == '.' && p[2] == '.')
+            GEN_OPERATOR(3, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_ELLIPSIS);
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_DOT);
+    case '/':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_DIVIDE_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ARITHMETIC, ARITHMETIC_OPERATOR_DIVIDE);
+    case ':':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_COLON);
+    case ';':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_SEMICOLON);
+    case '<':
+        if (end - p >= 3 && p[1] == '<' && p[2] == '=')
+            GEN_OPERATOR(3, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SHL_ASSIGN);
+        if (end - p >= 2 && p[1] == '<')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHL);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS_EQUAL);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_LESS);
+    case '=':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_EQUAL);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_ASSIGN);
+    case '>':
+        if (end - p >= 3 && p[1] == '>' && p[2] == '=')
+            GEN_OPERATOR(3, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_SHR_ASSIGN);
+        if (end - p >= 2 && p[1] == '>')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_SHR);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER_EQUAL);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_COMPARISON, COMPARISON_OPERATOR_GREATER);
+    case '?':
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_TERNARY, TERNARY_OPERATOR_CONDITIONAL);
+    case '[':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_LBRACKET);
+    case ']':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_RBRACKET);
+    case '^':
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_XOR_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_XOR);
+    case '{':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_LBRACE);
+    case '|':
+        if (end - p >= 2 && p[1] == '|')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_LOGICAL, LOGICAL_OPERATOR_OR);
+        if (end - p >= 2 && p[1] == '=')
+            GEN_OPERATOR(2, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_ASSIGNMENT, ASSINGMENT_OPERATOR_OR_ASSIGN);
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_OR);
+    case '}':
+        GEN_OPERATOR(1, TOKEN_TYPE_PUNCTUATION, OPERATOR_TYPE_NONE, PUNCTUATION_RBRACE);
+    case '~':
+        GEN_OPERATOR(1, TOKEN_TYPE_OPERATOR, OPERATOR_TYPE_BITWISE, BITWISE_OPERATOR_NOT);
+    default:
+        break;
+    }
+    goto state_error;
+
+operator_done:
+    column += (ParserSize)(p - start);
+    goto emit;
+
+state_error:
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    p++;
+    column++;
+    GEN_SYNC();
+    LexerCGeneratedError(lexer, start, TOKEN_TYPE_ERROR, 0, PARSER_ERROR_UNEXPECTED_TOKEN, "Unexpected character");
+    goto token_failed;
+
+stop:
+    if (p < end) {
+        GEN_SYNC();
+        return false;
+    }
+    start = p;
+    tokenLine = line;
+    tokenColumn = column;
+    flags = TOKEN_TYPE_EOF;
+    kind = 0;
+    value = 0;
+
+emit:
+    token->lexeme = (const char*)start;
+    token->length = (uint32_t)(p - start);
+    token->flags = (uint16_t)flags;
+    token->kind = (uint16_t)kind;
+    token->value = value;
+    token->line = (uint32_t)tokenLine;
+    token->column = (uint32_t)tokenColumn;
+    GEN_SYNC();
+    lexer->scanIndex++;
+    return true;
+
+token_error:
+    tokenLine = lexer->line = line;
+    tokenColumn = lexer->column = column;
+token_failed:
+    *token = lexer->scanToken;
+    token->line = (uint32_t)tokenLine;
+    token->column = (uint32_t)tokenColumn;
+    lexer->scanIndex++;
+    return true;
+}
+
+#undef GEN_OPERATOR
+#undef GEN_SYNC
+#undef GEN_DISPATCH
+
+// ------------------------------------------------------------------------------------------------
+// Character classification
+// ------------------------------------------------------------------------------------------------
+
+static bool PARSER_PTR LexerCGeneratedIsIdentifierStart(uint8_t c)
+{
+    return GEN_IS(c, GEN_CLASS_IDENT_START);
+}
+
+static bool PARSER_PTR LexerCGeneratedIsIdentifierChar(uint8_t c)
+{
+    return GEN_IS(c, GEN_CLASS_IDENT_CHAR);
+}
+
+static bool PARSER_PTR LexerCGeneratedIsKeyword(const char* lexeme)
+{
+    return LexerCGeneratedKeyword((const uint8_t*)lexeme, strlen(lexeme)) != 0;
+}
+
+static bool PARSER_PTR LexerCGeneratedIsWhitespace(uint8_t c)
+{
+    return GEN_IS(c, GEN_CLASS_WHITESPACE);
+}
+
+static bool PARSER_PTR LexerCGeneratedIsLineComment(const char* text, size_t length)
+{
+    return length >= 2 && text[0] == '/' && text[1] == '/';
+}
+
+static bool PARSER_PTR LexerCGeneratedIsBlockComment(const char* text, size_t length)
+{
+    return length >= 2 && text[0] == '/' && text[1] == '*';
+}
+
+static bool PARSER_PTR LexerCGeneratedIsStringStart(uint8_t c)
+{
+    return c == '"';
+}
+
+static bool PARSER_PTR LexerCGeneratedIsCharStart(uint8_t c)
+{
+    return c == '\'';
+}
+
+static bool PARSER_PTR LexerCGeneratedIsNumberStart(uint8_t c)
+{
+    return GEN_IS(c, GEN_CLASS_DIGIT);
+}
+
+static bool PARSER_PTR LexerCGeneratedIsNumberChar(uint8_t c, int base)
+{
+    switch (base) {
+    case 2:  return c == '0' || c == '1';
+    case 8:  return c >= '0' && c <= '7';
+    case 16: return GEN_IS(c, GEN_CLASS_HEX_DIGIT);
+    default: return GEN_IS(c, GEN_CLASS_DIGIT);
+    }
+}
+
+static bool PARSER_PTR LexerCGeneratedIsPunctuation(uint8_t c)
+{
+    return GEN_IS(c, GEN_CLASS_PUNCTUATION);
+}
+
+static bool PARSER_PTR LexerCGeneratedIsOperator(const char* lexeme, size_t length)
+{
+    if (length == 1)
+        return GEN_IS(lexeme[0], GEN_CLASS_OPERATOR);
+
+    for (size_t i = 0; i < GEN_OPERATOR_COUNT; i++) {
+        const GenOperatorEntry* entry = &s_GenOperators[i];
+        if (entry->length == length && TOKEN_OPERATOR_CODE_TYPE(entry->code) != OPERATOR_TYPE_NONE &&
+            memcmp(entry->text, lexeme, length) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+static uint32_t PARSER_PTR LexerCGeneratedGetOperatorType(const char* lexeme, size_t length)
+{
+    for (size_t i = 0; i < GEN_OPERATOR_COUNT; i++) {
+        const GenOperatorEntry* entry = &s_GenOperators[i];
+        if (entry->length == length && memcmp(entry->text, lexeme, length) == 0)
+            return entry->code;
+    }
+
+    return TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_NONE);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Strategy
+// ------------------------------------------------------------------------------------------------
+
+const LexerLanguageStrategy g_CLexerGeneratedStrategy = {
+    .languageName = "C11",
+
+    .isIdentifierStart = LexerCGeneratedIsIdentifierStart,
+    .isIdentifierChar = LexerCGeneratedIsIdentifierChar,
+
+    .isKeyword = LexerCGeneratedIsKeyword,
+
+    .isWhitespace = LexerCGeneratedIsWhitespace,
+
+    .isLineComment = LexerCGeneratedIsLineComment,
+    .isBlockComment = LexerCGeneratedIsBlockComment,
+
+    .isStringStart = LexerCGeneratedIsStringStart,
+    .isCharStart = LexerCGeneratedIsCharStart,
+    .isNumberStart = LexerCGeneratedIsNumberStart,
+    .isNumberChar = LexerCGeneratedIsNumberChar,
+
+    .isPunctuation = LexerCGeneratedIsPunctuation,
+    .isOperator = LexerCGeneratedIsOperator,
+    .getOperatorType = LexerCGeneratedGetOperatorType,
+
+    .scanToken = LexerCGeneratedScanToken,
+    .scanTokenTrivia = LexerCGeneratedScanTokenTrivia,
+
+    .userData = NULL,
+};
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,358 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/lexer/lang/LexerCLanguage.h"
+
+#include "../LexerInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/* Encoding prefix of a literal token and its length */
+static uint32_t LexerCStringPrefix(const struct LexerToken_T* token, size_t* prefixLength)
+{
+    const uint8_t* lexeme = (const uint8_t*)token->lexeme;
+
+    switch (lexeme[0]) {
+    case 'L':
+        *prefixLength = 1;
+        return LEXER_STRING_ENCODING_WIDE;
+    case 'U':
+        *prefixLength = 1;
+        return LEXER_STRING_ENCODING_UTF32;
+    case 'u':
+        if (lexeme[1] == '8') {
+            *prefixLength = 2;
+            return LEXER_STRING_ENCODING_UTF8;
+        }
+        *prefixLength = 1;
+        return LEXER_STRING_ENCODING_UTF16;
+    default:
+        *prefixLength = 0;
+        return LEXER_STRING_ENCODING_NONE;
+    }
+}
+
+static uint32_t LexerCStringUnitSize(uint32_t encoding)
+{
+    switch (encoding) {
+    case LEXER_STRING_ENCODING_UTF16:
+        return 2;
+    case LEXER_STRING_ENCODING_UTF32:
+    case LEXER_STRING_ENCODING_WIDE:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+/* Bytes between the quotes */
+static void LexerCStringBody(const struct LexerToken_T* token, const uint8_t** body, const uint8_t** end)
+{
+    size_t prefixLength;
+    LexerCStringPrefix(token, &prefixLength);
+
+    *body = (const uint8_t*)token->lexeme + prefixLength + 1;
+    *end = (const uint8_t*)token->lexeme + token->length - 1;
+}
+
+static bool LexerCIsQuotedLiteral(const struct LexerToken_T* token, uint16_t kind)
+{
+    return token->flags == TOKEN_TYPE_LITERAL && token->kind == kind;
+}
+
+/* Store one code unit, `out` is aligned for `unitSize` */
+static void LexerCPutUnit(uint8_t* out, size_t* length, uint32_t unitSize, uint32_t unit)
+{
+    if (unitSize == 1) {
+        out[*length] = (uint8_t)unit;
+    }
+    else if (unitSize == 2) {
+        uint16_t value = (uint16_t)unit;
+        memcpy(out + *length * 2, &value, sizeof(value));
+    }
+    else {
+        memcpy(out + *length * 4, &unit, sizeof(unit));
+    }
+
+    (*length)++;
+}
+
+/* Store a code point as UTF-8, UTF-16 or UTF-32 */
+static void LexerCPutCodePoint(uint8_t* out, size_t* length, uint32_t unitSize, uint32_t codePoint)
+{
+    if (unitSize == 4 || (unitSize == 2 && codePoint < 0x10000) || (unitSize == 1 && codePoint < 0x80)) {
+        LexerCPutUnit(out, length, unitSize, codePoint);
+    }
+    else if (unitSize == 2) {
+        codePoint -= 0x10000;
+        LexerCPutUnit(out, length, 2, 0xD800 | (codePoint >> 10));
+        LexerCPutUnit(out, length, 2, 0xDC00 | (codePoint & 0x3FF));
+    }
+    else if (codePoint < 0x800) {
+        LexerCPutUnit(out, length, 1, 0xC0 | (codePoint >> 6));
+        LexerCPutUnit(out, length, 1, 0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000) {
+        LexerCPutUnit(out, length, 1, 0xE0 | (codePoint >> 12));
+        LexerCPutUnit(out, length, 1, 0x80 | ((codePoint >> 6) & 0x3F));
+        LexerCPutUnit(out, length, 1, 0x80 | (codePoint & 0x3F));
+    }
+    else {
+        LexerCPutUnit(out, length, 1, 0xF0 | (codePoint >> 18));
+        LexerCPutUnit(out, length, 1, 0x80 | ((codePoint >> 12) & 0x3F));
+        LexerCPutUnit(out, length, 1, 0x80 | ((codePoint >> 6) & 0x3F));
+        LexerCPutUnit(out, length, 1, 0x80 | (codePoint & 0x3F));
+    }
+}
+
+/* Next source character of a wide literal, malformed UTF-8 is taken byte by byte */
+static uint32_t LexerCReadUtf8(const uint8_t** cursor, const uint8_t* end)
+{
+    const uint8_t* p = *cursor;
+    uint32_t lead = *p++;
+    uint32_t extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+
+    if (lead < 0x80 || extra == 0 || lead >= 0xF8 || (size_t)(end - p) < extra) {
+        *cursor = p;
+        return lead;
+    }
+
+    uint32_t codePoint = lead & (0x3Fu >> extra);
+    for (uint32_t i = 0; i < extra; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            *cursor = p;
+            return lead;
+        }
+        codePoint = (codePoint << 6) | (p[i] & 0x3F);
+    }
+
+    *cursor = p + extra;
+    return codePoint;
+}
+
+/* Value of exactly `digits` hexadecimal digits, false when they are not there */
+static bool LexerCReadHex(const uint8_t** cursor, const uint8_t* end, uint32_t digits, uint32_t* value)
+{
+    const uint8_t* p = *cursor;
+    if ((size_t)(end - p) < digits)
+        return false;
+
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < digits; i++) {
+        uint8_t nibble = g_LexerNibbleTable[p[i]];
+        if (nibble > 15)
+            return false;
+        result = (result << 4) | nibble;
+    }
+
+    *cursor = p + digits;
+    *value = result;
+    return true;
+}
+
+/* Decode the body of one literal, appending to `out` */
+static ParserResult LexerCDecodeBody(const uint8_t* p, const uint8_t* end, uint32_t unitSize, uint8_t* out, size_t* length)
+{
+    const uint32_t maxUnit = unitSize == 1 ? 0xFFu : unitSize == 2 ? 0xFFFFu : 0xFFFFFFFFu;
+
+    while (p < end) {
+        if (unitSize == 1) {
+            // Copy the run up to the next backslash in one go
+            const uint8_t* stop = memchr(p, '\\', (size_t)(end - p));
+            if (!stop)
+                stop = end;
+
+            memcpy(out + *length, p, (size_t)(stop - p));
+            *length += (size_t)(stop - p);
+            p = stop;
+
+            if (p == end)
+                break;
+        }
+        else if (*p != '\\') {
+            LexerCPutCodePoint(out, length, unitSize, LexerCReadUtf8(&p, end));
+            continue;
+        }
+
+        // The scanner guarantees a character after every backslash
+        p++;
+        uint8_t c = *p++;
+        uint32_t value = 0;
+
+        switch (c) {
+        case '\n':  continue;   // Line splice
+        case 'a':   value = '\a'; break;
+        case 'b':   value = '\b'; break;
+        case 'f':   value = '\f'; break;
+        case 'n':   value = '\n'; break;
+        case 'r':   value = '\r'; break;
+        case 't':   value = '\t'; break;
+        case 'v':   value = '\v'; break;
+        case '\\':
+        case '\'':
+        case '"':
+        case '?':   value = c; break;
+
+        case '0': case '1': case '2': case '3':
+        case '4': case '5': case '6': case '7':
+            // Up to three octal digits
+            value = (uint32_t)(c - '0');
+            for (int i = 0; i < 2 && p < end && *p >= '0' && *p <= '7'; i++)
+                value = (value << 3) | (uint32_t)(*p++ - '0');
+            break;
+
+        case 'x': {
+            const uint8_t* digits = p;
+            for (; p < end && g_LexerNibbleTable[*p] < 16; p++) {
+                if (value > (maxUnit >> 4))
+                    return PARSER_ERROR_INVALID_ESCAPE_SEQUENCE;
+                value = (value << 4) | g_LexerNibbleTable[*p];
+            }
+            if (p == digits)
+                return PARSER_ERROR_INVALID_ESCAPE_SEQUENCE;
+            break;
+        }
+
+        case 'u':
+        case 'U':
+            // Universal character name, stored in the encoding of the literal
+            if (!LexerCReadHex(&p, end, c == 'u' ? 4 : 8, &value) ||
+                value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF))
+                return PARSER_ERROR_INVALID_ESCAPE_SEQUENCE;
+
+            LexerCPutCodePoint(out, length, unitSize, value);
+            continue;
+
+        default:
+            return PARSER_ERROR_INVALID_ESCAPE_SEQUENCE;
+        }
+
+        if (value > maxUnit)
+            return PARSER_ERROR_INVALID_ESCAPE_SEQUENCE;
+
+        LexerCPutUnit(out, length, unitSize, value);
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/* Token `index` of a token array or of the ring of a lexer */
+static const struct LexerToken_T* LexerCSourceToken(const LexerTokenArray tokens, const Lexer lexer, uint32_t index)
+{
+    return tokens ? LexerTokenArray_GetToken(tokens, index) : LexerRingAt(lexer, index);
+}
+
+static ParserResult LexerCDecodeTokens(const LexerTokenArray tokens, const Lexer lexer, uint32_t count,
+    uint32_t index, ParserArena arena, LexerStringBytes* bytes)
+{
+    const struct LexerToken_T* first = index < count ? LexerCSourceToken(tokens, lexer, index) : NULL;
+    if (!first || (!LexerCIsQuotedLiteral(first, LITERAL_TYPE_STRING) && !LexerCIsQuotedLiteral(first, LITERAL_TYPE_CHAR)))
+        return PARSER_ERROR_INVALID_ARG;
+
+    // ===== GATHER ADJACENT STRING LITERALS =====
+    size_t prefixLength;
+    uint32_t encoding = LexerCStringPrefix(first, &prefixLength);
+    uint32_t escapes = first->value & LEXER_STRING_HAS_ESCAPES;
+    size_t sourceLength = first->length - prefixLength - 2;
+    uint32_t last = index + 1;
+
+    if (first->kind == LITERAL_TYPE_STRING) {
+        for (; last < count; last++) {
+            const struct LexerToken_T* token = LexerCSourceToken(tokens, lexer, last);
+            if (!LexerCIsQuotedLiteral(token, LITERAL_TYPE_STRING))
+                break;
+
+            // An unprefixed piece takes the prefix of the others
+            uint32_t pieceEncoding = LexerCStringPrefix(token, &prefixLength);
+            if (pieceEncoding != LEXER_STRING_ENCODING_NONE) {
+                if (encoding != LEXER_STRING_ENCODING_NONE && encoding != pieceEncoding)
+                    return PARSER_ERROR_SYNTAX_ERROR;
+                encoding = pieceEncoding;
+            }
+
+            escapes |= token->value & LEXER_STRING_HAS_ESCAPES;
+            sourceLength += token->length - prefixLength - 2;
+        }
+    }
+
+    uint32_t unitSize = LexerCStringUnitSize(encoding);
+
+    bytes->encoding = encoding;
+    bytes->unitSize = unitSize;
+    bytes->tokenCount = last - index;
+
+    // ===== STRAIGHT FROM THE FILE BUFFER =====
+    if (bytes->tokenCount == 1 && !escapes && unitSize == 1) {
+        const uint8_t* body;
+        const uint8_t* end;
+        LexerCStringBody(first, &body, &end);
+
+        bytes->data = body;
+        bytes->length = (size_t)(end - body);
+        return PARSER_RESULT_SUCCESS;
+    }
+
+    // ===== DECODE INTO THE ARENA =====
+    // No escape sequence or source character produces more code units than
+    // it has bytes, the source length bounds the output
+    if (!arena)
+        return PARSER_ERROR_INVALID_ARG;
+
+    uint8_t* out = ParserArena_Alloc(arena, sourceLength * unitSize + 1, 0);
+    if (!out)
+        return PARSER_ERROR_NO_MEMORY;
+
+    size_t length = 0;
+    for (uint32_t i = index; i < last; i++) {
+        const uint8_t* body;
+        const uint8_t* end;
+        LexerCStringBody(LexerCSourceToken(tokens, lexer, i), &body, &end);
+
+        CHECK_PARSER_RESULT(LexerCDecodeBody(body, end, unitSize, out, &length));
+    }
+
+    bytes->data = out;
+    bytes->length = length;
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+PARSER_ATTR ParserResult PARSER_CALL LexerCDecodeString(
+    const LexerTokenArray tokens,
+    uint32_t index,
+    ParserArena arena,
+    LexerStringBytes* bytes)
+{
+    if (!tokens || !bytes)
+        return PARSER_ERROR_INVALID_ARG;
+
+    return LexerCDecodeTokens(tokens, NULL, LexerTokenArray_GetCount(tokens), index, arena, bytes);
+}
+
+PARSER_ATTR ParserResult PARSER_CALL LexerCDecodeStringAt(
+    const Lexer lexer,
+    uint32_t position,
+    ParserArena arena,
+    LexerStringBytes* bytes)
+{
+    if (!lexer || !bytes)
+        return PARSER_ERROR_INVALID_ARG;
+
+    // Only scanned tokens that the ring still holds
+    uint32_t kept = lexer->ringMask + 1u;
+    if (position >= lexer->filled || lexer->filled - position > kept)
+        return PARSER_ERROR_INVALID_ARG;
+
+    return LexerCDecodeTokens(NULL, lexer, lexer->filled, position, arena, bytes);
+}
+
+// ------------------------------------------------------------------------------------------------
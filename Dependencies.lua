@@ -6,6 +6,8 @@ IncludeDir["Compiler"] = "%{wks.location}/Compiler/include"
 
 SourceDir = {}
 SourceDir["Compiler"] = "%{wks.location}/Compiler/src"
+SourceDir["LexerGen"] = "%{wks.location}/Tools/LexerGen/src"
+SourceDir["Tests"] = "%{wks.location}/Tests/src"
 
 
 LibraryDir = {}
@@ -0,0 +1,23 @@
+include "Dependencies.lua"
+
+project "CompilerTests"
+	kind "ConsoleApp"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{SourceDir.Tests}" .. "/**.c",
+
+		"%{SourceDir.Tests}" .. "/**.h",
+	}
+
+	-- The source directory of the core is searched too, some tests check
+	-- internal state such as the token ring of a lexer
+	includedirs {
+		"%{IncludeDir.Compiler}",
+		"%{SourceDir.Compiler}",
+	}
+
+	links { "CompilerCore" }
@@ -0,0 +1,378 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/lang/ParserCInternal.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+static bool s_CaseFailed;
+
+/* Operator spelling by ParserCBinaryOperator */
+static const char* const s_BinaryOperatorNames[] = {
+    [C_BINARY_OP_ADD] = "+", [C_BINARY_OP_SUBTRACT] = "-", [C_BINARY_OP_MULTIPLY] = "*",
+    [C_BINARY_OP_DIVIDE] = "/", [C_BINARY_OP_MODULO] = "%", [C_BINARY_OP_BITWISE_AND] = "&",
+    [C_BINARY_OP_BITWISE_OR] = "|", [C_BINARY_OP_BITWISE_XOR] = "^", [C_BINARY_OP_SHIFT_LEFT] = "<<",
+    [C_BINARY_OP_SHIFT_RIGHT] = ">>", [C_BINARY_OP_LOGICAL_AND] = "&&", [C_BINARY_OP_LOGICAL_OR] = "||",
+    [C_BINARY_OP_EQUAL] = "==", [C_BINARY_OP_NOT_EQUAL] = "!=", [C_BINARY_OP_LESS] = "<",
+    [C_BINARY_OP_GREATER] = ">", [C_BINARY_OP_LESS_EQUAL] = "<=", [C_BINARY_OP_GREATER_EQUAL] = ">=",
+    [C_BINARY_OP_ASSIGN] = "=", [C_BINARY_OP_ADD_ASSIGN] = "+=", [C_BINARY_OP_SUB_ASSIGN] = "-=",
+    [C_BINARY_OP_MUL_ASSIGN] = "*=", [C_BINARY_OP_DIV_ASSIGN] = "/=", [C_BINARY_OP_MOD_ASSIGN] = "%=",
+    [C_BINARY_OP_AND_ASSIGN] = "&=", [C_BINARY_OP_OR_ASSIGN] = "|=", [C_BINARY_OP_XOR_ASSIGN] = "^=",
+    [C_BINARY_OP_SHL_ASSIGN] = "<<=", [C_BINARY_OP_SHR_ASSIGN] = ">>=", [C_BINARY_OP_COMMA] = ",",
+};
+
+/* Operator spelling by ParserCUnaryOperator, increments tell prefix from postfix */
+static const char* const s_UnaryOperatorNames[] = {
+    [C_UNARY_OP_PLUS] = "+", [C_UNARY_OP_MINUS] = "-", [C_UNARY_OP_LOGICAL_NOT] = "!",
+    [C_UNARY_OP_BITWISE_NOT] = "~", [C_UNARY_OP_PRE_INCREMENT] = "++x", [C_UNARY_OP_PRE_DECREMENT] = "--x",
+    [C_UNARY_OP_POST_INCREMENT] = "x++", [C_UNARY_OP_POST_DECREMENT] = "x--", [C_UNARY_OP_ADDRESS_OF] = "&",
+    [C_UNARY_OP_DEREFERENCE] = "*", [C_UNARY_OP_SIZEOF] = "sizeof",
+};
+
+/* Suffix of a constant by its ParserCBasicType */
+static const char* TestConstantSuffix(uint32_t type)
+{
+    switch (type) {
+    case C_BASIC_TYPE_INT: return "";
+    case C_BASIC_TYPE_UNSIGNED_INT: return "u";
+    case C_BASIC_TYPE_LONG: return "l";
+    case C_BASIC_TYPE_UNSIGNED_LONG: return "ul";
+    case C_BASIC_TYPE_LONG_LONG: return "ll";
+    case C_BASIC_TYPE_UNSIGNED_LONG_LONG: return "ull";
+    default: return "?";
+    }
+}
+
+/* Name of an operator node, NULL for other nodes */
+static const char* TestOperatorName(ParserASTNodeType type, uint16_t subtype)
+{
+    switch (type) {
+    case AST_NODE_TYPE_BINARY_EXPR:
+    case AST_NODE_TYPE_ASSIGNMENT_EXPR:
+        return subtype < TEST_COUNT(s_BinaryOperatorNames) ? s_BinaryOperatorNames[subtype] : NULL;
+    case AST_NODE_TYPE_UNARY_EXPR:
+        return subtype < TEST_COUNT(s_UnaryOperatorNames) ? s_UnaryOperatorNames[subtype] : NULL;
+    case AST_NODE_TYPE_TERNARY_EXPR: return "?";
+    case AST_NODE_TYPE_COMMA_EXPR: return ",";
+    case AST_NODE_TYPE_CALL_EXPR: return "call";
+    case AST_NODE_TYPE_CAST_EXPR: return "cast";
+    case AST_NODE_TYPE_SIZEOF_EXPR: return "sizeof";
+    case AST_NODE_TYPE_ARRAY_SUBSCRIPT_EXPR: return "[]";
+    default: return NULL;
+    }
+}
+
+/* Stop the run, the tests cannot go on without memory */
+static void TestOutOfMemory(void)
+{
+    fprintf(stderr, "error: out of memory\n");
+    exit(2);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+void TestFail(const char* file, int line, const char* condition)
+{
+    fprintf(stderr, "    %s:%d: check failed: %s\n", file, line, condition);
+    s_CaseFailed = true;
+}
+
+bool TestFailed(void)
+{
+    bool failed = s_CaseFailed;
+    s_CaseFailed = false;
+
+    return failed;
+}
+
+double TestNow(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+uint32_t TestRandom(uint32_t* state)
+{
+    uint32_t x = *state ? *state : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+void TestText_Append(TestText* text, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int needed = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    if (needed < 0)
+        return;
+
+    if (text->length + (size_t)needed + 1 > text->capacity) {
+        size_t capacity = text->capacity ? text->capacity : 4096;
+        while (capacity < text->length + (size_t)needed + 1)
+            capacity *= 2;
+
+        char* data = realloc(text->data, capacity);
+        if (!data)
+            TestOutOfMemory();
+
+        text->data = data;
+        text->capacity = capacity;
+    }
+
+    va_start(args, format);
+    vsnprintf(text->data + text->length, (size_t)needed + 1, format, args);
+    va_end(args);
+
+    text->length += (size_t)needed;
+}
+
+void TestText_Reset(TestText* text)
+{
+    text->length = 0;
+    if (text->data)
+        text->data[0] = '\0';
+}
+
+void TestText_Free(TestText* text)
+{
+    free(text->data);
+    memset(text, 0, sizeof(TestText));
+}
+
+bool TestWriteFile(const char* path, const char* data, size_t length)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    bool written = fwrite(data, 1, length, file) == length;
+
+    return fclose(file) == 0 && written;
+}
+
+void TestGenerateC(TestText* text, uint32_t functions, uint32_t seed)
+{
+    uint32_t state = seed;
+
+    TestText_Append(text,
+        "typedef int T;\n"
+        "struct G { int a; T b; };\n"
+        "int g0, g1, g2;\n"
+        "int fwd(int);\n"
+        "int fmt(int, char*, ...);\n"
+        "const char* s0 = \"ab\" \"c\\n\" /* between */ \"d\";\n");
+
+    for (uint32_t i = 0; i < functions; i++) {
+        uint32_t value = TestRandom(&state) % 100000u;
+
+        switch (i % 9) {
+        case 0:
+            TestText_Append(text, "int f%u(int n, T m) { T x = n + m * %uu; { typedef long T; T y = (T)x; "
+                "x = y; } T z = x; return z + g%u; }\n", i, value, i % 3);
+            break;
+        case 1:
+            TestText_Append(text, "void f%u(int n) { struct L%u { int q; struct G g; } s; s.q = n; s.g.a = s.q; "
+                "int a[n]; a[0] = sizeof(struct L%u); goto end; end: ; }\n", i, i, i);
+            break;
+        case 2:
+            TestText_Append(text, "long f%u(long* p, int k) { int (*fp)(int, char) = 0; char c[%u]; "
+                "for (int i = 0; i < k; i++) { p[i] = fwd(i) + c[i]; } return fp ? fp(k, 'a') : *p; }\n",
+                i, value % 64 + 2);
+            break;
+        case 3:
+            TestText_Append(text, "int f%u(void) { enum E%u { A%u, B%u } e = B%u; switch (e) { case A%u: "
+                "return 1; default: break; } return later%u; }\n", i, i, i, i, i, i, i % 4);
+            break;
+        case 4:
+            TestText_Append(text, "T f%u(int n) { int T = n; { struct G g; g.b = T; } unsigned short v[n][3]; "
+                "const volatile struct G* const* pp = 0; return T; }\n", i);
+            break;
+        case 5:
+            TestText_Append(text, "int f%u(int a, int b) { int r = 0; while (a < b) { r += a++ * 2 %% 7; "
+                "if (r > 100) break; } do { r--; } while (r > 50); return r; }\n", i);
+            break;
+        case 6:
+            TestText_Append(text, "int f%u(int n, T m) { T x = n + m * 0x%xu; double d = 1.5e%u; char c = '\\n'; "
+                "return x + (int)d + c + g0; }\n", i, value, value % 9);
+            break;
+        case 7:
+            TestText_Append(text, "void f%u(long* p) { struct M%u { int q; } s; s.q = fmt(%u, \"str%u\", 'z'); "
+                "p[0] = s.q; }\n", i, i, value, i);
+            break;
+        default:
+            TestText_Append(text, "T* f%u(int (*cb)(T, long), unsigned k) { static T arr[%u]; "
+                "for (unsigned i = 0; i < k; i++) arr[i] = cb(i, 3L); return arr; }\n", i, value % 32 + 1);
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < 4; i++)
+        TestText_Append(text, "int later%u;\n", i);
+}
+
+bool TestUnit_Parse(TestUnit* unit, const char* path, const ASTParserCreateConfig* config, uint32_t bodyThreads)
+{
+    memset(unit, 0, sizeof(TestUnit));
+
+    FileBufferConfig fileConfig = { 0 };
+    fileConfig.fileName = path;
+    fileConfig.filePath = path;
+    if (CreateFileBuffer(&fileConfig, &unit->file) != PARSER_RESULT_SUCCESS) {
+        unit->file = NULL;
+        return false;
+    }
+
+    LexerCreateConfig lexerConfig = { &g_CLexerLanguageStrategy, 0 };
+    if (CreateLexer(unit->file, &lexerConfig, &unit->lexer) != PARSER_RESULT_SUCCESS) {
+        unit->lexer = NULL;
+        return false;
+    }
+
+    if (CreateASTParser(unit->lexer, config, &unit->parser) != PARSER_RESULT_SUCCESS) {
+        unit->parser = NULL;
+        return false;
+    }
+
+    unit->result = ASTParser_Parse(unit->parser, &unit->root);
+    if (unit->result == PARSER_RESULT_SUCCESS && config->lazyFunctionBodies && bodyThreads != TEST_BODIES_SKIPPED)
+        unit->result = ASTParser_ParseFunctionBodies(unit->parser, bodyThreads);
+
+    return true;
+}
+
+void TestUnit_Destroy(TestUnit* unit)
+{
+    if (unit->parser)
+        ASTParserDestroy(unit->parser);
+    if (unit->lexer)
+        LexerDestroy(unit->lexer);
+    if (unit->file)
+        DestroyFileBuffer(unit->file);
+
+    memset(unit, 0, sizeof(TestUnit));
+}
+
+void TestUnit_PrintNode(const TestUnit* unit, ASTNodeId node, TestText* text)
+{
+    if (node == AST_NODE_ID_NONE) {
+        TestText_Append(text, "_");
+        return;
+    }
+
+    ASTTree tree = ASTParser_GetTree(unit->parser);
+    ParserASTNodeType type = ASTTree_GetNodeType(tree, node);
+    ASTNodeData data = ASTTree_GetData(tree, node);
+
+    ParserCConstant constant;
+    if (type == AST_NODE_TYPE_IDENTIFIER) {
+        const ParserIdentifier* name = ParserInterner_Get(ASTParser_GetInterner(unit->parser), data.lhs);
+        TestText_Append(text, "%s", name ? name->text : "?");
+        return;
+    }
+    if ((type == AST_NODE_TYPE_INTEGER_LITERAL || type == AST_NODE_TYPE_CHAR_LITERAL) &&
+        ParserCGetConstant(unit->parser, node, &constant)) {
+        if (ParserCIsSignedType(constant.type))
+            TestText_Append(text, "%lld", (long long)constant.value);
+        else
+            TestText_Append(text, "%llu", (unsigned long long)constant.value);
+        TestText_Append(text, "%s", TestConstantSuffix(constant.type));
+        return;
+    }
+    if (type == AST_NODE_TYPE_TYPE_SPECIFIER) {
+        TestText_Append(text, "type");
+        return;
+    }
+
+    const char* name = TestOperatorName(type, ASTTree_GetSubtype(tree, node));
+    if (name)
+        TestText_Append(text, "(%s", name);
+    else
+        TestText_Append(text, "(#%u", (uint32_t)type);
+
+    uint32_t count = ASTTree_GetChildCount(tree, node);
+    for (uint32_t i = 0; i < count; i++) {
+        TestText_Append(text, " ");
+        TestUnit_PrintNode(unit, ASTTree_GetChild(tree, node, i), text);
+    }
+
+    TestText_Append(text, ")");
+}
+
+uint32_t TestUnit_FindNodes(const TestUnit* unit, ParserASTNodeType type, ASTNodeId* nodes, uint32_t capacity)
+{
+    ASTTreeView view;
+    ASTTree_GetView(ASTParser_GetTree(unit->parser), &view);
+
+    uint32_t count = 0;
+    for (uint32_t i = 1; i < view.nodeCount; i++) {
+        if (view.types[i] != type)
+            continue;
+
+        if (count < capacity)
+            nodes[count] = view.firstNode + i;
+        count++;
+    }
+
+    return count;
+}
+
+bool TestSource_Open(TestSource* source, const char* path, const char* text, const LexerCreateConfig* config)
+{
+    memset(source, 0, sizeof(TestSource));
+
+    if (!TestWriteFile(path, text, strlen(text)))
+        return false;
+    source->path = path;
+
+    FileBufferConfig fileConfig = { 0 };
+    fileConfig.fileName = path;
+    fileConfig.filePath = path;
+    if (CreateFileBuffer(&fileConfig, &source->file) != PARSER_RESULT_SUCCESS) {
+        source->file = NULL;
+        return false;
+    }
+
+    LexerCreateConfig lexerConfig = { &g_CLexerLanguageStrategy, 0 };
+    if (CreateLexer(source->file, config ? (LexerCreateConfig*)config : &lexerConfig, &source->lexer) !=
+        PARSER_RESULT_SUCCESS) {
+        source->lexer = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void TestSource_Close(TestSource* source)
+{
+    if (source->lexer)
+        LexerDestroy(source->lexer);
+    if (source->file)
+        DestroyFileBuffer(source->file);
+    if (source->path)
+        remove(source->path);
+
+    memset(source, 0, sizeof(TestSource));
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+// ------------------------------------------------------------------------------------------------
+// Include guard
+// ------------------------------------------------------------------------------------------------
+
+#ifndef TEST_CORE_H
+#define TEST_CORE_H
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "parser/lang/ParserCLanguage.h"
+#include "parser/lexer/lang/LexerCLanguage.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+typedef void (*PFN_TestCase)(void);
+
+typedef struct TestCase_T {
+    const char* name;
+    PFN_TestCase run;
+} TestCase;
+
+/**
+ * @brief Tests of one part of the compiler, and the benchmarks run with --bench
+ */
+typedef struct TestSuite_T {
+    const char* name;
+    const TestCase* tests;
+    uint32_t testCount;
+    const TestCase* benchmarks;
+    uint32_t benchmarkCount;
+} TestSuite;
+
+#define TEST_COUNT(cases) ((uint32_t)(sizeof(cases) / sizeof((cases)[0])))
+
+/* Thread count for TestUnit_Parse that leaves lazy bodies skipped */
+#define TEST_BODIES_SKIPPED UINT32_MAX
+
+/* Fail the running case and leave the function the check is in */
+#define TEST_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            TestFail(__FILE__, __LINE__, #condition); \
+            return; \
+        } \
+    } while (0)
+
+/**
+ * @brief Growing text, always NUL terminated
+ */
+typedef struct TestText_T {
+    char* data;
+    size_t length;
+    size_t capacity;
+} TestText;
+
+/**
+ * @brief A translation unit parsed from a file, with what it was parsed from
+ */
+typedef struct TestUnit_T {
+    FileBuffer file;
+    Lexer lexer;
+    ASTParser parser;
+    ASTNode root;
+    ParserResult result;                // Of ASTParser_Parse, or of the body parse it was asked for
+} TestUnit;
+
+/**
+ * @brief A source written to a file and opened for lexing, the file stays mapped for the lexemes
+ */
+typedef struct TestSource_T {
+    const char* path;
+    FileBuffer file;
+    Lexer lexer;
+} TestSource;
+
+void TestFail(const char* file, int line, const char* condition);
+
+/**
+ * @brief Check whether the running case failed a check
+ */
+bool TestFailed(void);
+
+/**
+ * @brief Seconds from an arbitrary point, for benchmarks
+ */
+double TestNow(void);
+
+/**
+ * @brief Next number of a reproducible sequence, xorshift over `state`
+ */
+uint32_t TestRandom(uint32_t* state);
+
+void TestText_Append(TestText* text, const char* format, ...);
+void TestText_Reset(TestText* text);
+void TestText_Free(TestText* text);
+
+/**
+ * @brief Write a file the lexer can map, false when it cannot be written
+ */
+bool TestWriteFile(const char* path, const char* data, size_t length);
+
+/**
+ * @brief Append a C file of `functions` function definitions after a few declarations
+ *
+ * @description The bodies use typedefs that are shadowed in blocks, structs
+ *              and enums declared inside them, arrays, function pointers,
+ *              loops, switches and literals of every kind, so one file
+ *              reaches most of the C front end. The text depends only on
+ *              `functions` and `seed`.
+ */
+void TestGenerateC(TestText* text, uint32_t functions, uint32_t seed);
+
+/**
+ * @brief Lex and parse a C file, and the skipped bodies with `bodyThreads` threads when they are lazy
+ *
+ * @param bodyThreads[in] Threads for ASTParser_ParseFunctionBodies, ignored unless bodies are lazy,
+ *                        TEST_BODIES_SKIPPED to leave them skipped
+ *
+ * @return false when the file could not be opened or a handle not created
+ */
+bool TestUnit_Parse(TestUnit* unit, const char* path, const ASTParserCreateConfig* config, uint32_t bodyThreads);
+
+void TestUnit_Destroy(TestUnit* unit);
+
+/**
+ * @brief Append a node and its children as an s-expression, e.g. "(+ a (* b 2))"
+ *
+ * @description Identifiers print as their name, integer constants as their
+ *              value with the suffix of their type, operators as their C
+ *              spelling, other nodes as their type number. Absent children
+ *              print as "_".
+ */
+void TestUnit_PrintNode(const TestUnit* unit, ASTNodeId node, TestText* text);
+
+/**
+ * @brief Get the nodes of a type in id order
+ *
+ * @return How many nodes have the type, nodes past `capacity` are not stored
+ */
+uint32_t TestUnit_FindNodes(const TestUnit* unit, ParserASTNodeType type, ASTNodeId* nodes, uint32_t capacity);
+
+/**
+ * @brief Write `text` to `path` and create a lexer over it
+ *
+ * @param config[in] Lexer configuration, NULL for the C strategy with the default ring
+ *
+ * @return false when the file could not be written or a handle not created
+ */
+bool TestSource_Open(TestSource* source, const char* path, const char* text, const LexerCreateConfig* config);
+
+/**
+ * @brief Destroy the lexer and the file buffer, and remove the file
+ */
+void TestSource_Close(TestSource* source);
+
+// ------------------------------------------------------------------------------------------------
+#endif // !TEST_CORE_H
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,324 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "ir/IR.h"
+#include "ir/IRText.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_LOWERING_SOURCE            "CompilerTests_IRLowering.c"
+
+/* A function definition and the IR it has to be lowered to */
+typedef struct TestLowering_T {
+    const char* name;
+    const char* source;
+    const char* ir;
+} TestLowering;
+
+/* Phis only where two definitions of a variable meet, none for values a join or loop leaves alone */
+static const TestLowering s_Phis[] = {
+    {
+        "straight",
+        "int straight(int a, int b) { int x = a + b; int y = x * 2; x = y - a; return x + y; }\n",
+        "define @straight(i32, i32) -> i32 {\n"
+        "b1:\n"
+        "  %1 = param i32 #0\n"
+        "  %2 = param i32 #1\n"
+        "  br void b2\n"
+        "b2:\n"
+        "  %3 = add i32 %1, %2\n"
+        "  %4 = mul i32 %3, i32 2\n"
+        "  %5 = sub i32 %4, %1\n"
+        "  %6 = add i32 %5, %4\n"
+        "  ret void %6\n"
+        "}\n",
+    },
+    {
+        // y is the same on both paths
+        "diamond",
+        "int diamond(int a, int b) { int x = a; int y = b; if (a < b) x = b; else x = a - 1; return x + y; }\n",
+        "define @diamond(i32, i32) -> i32 {\n"
+        "b1:\n"
+        "  %1 = param i32 #0\n"
+        "  %2 = param i32 #1\n"
+        "  br void b2\n"
+        "b2:\n"
+        "  %3 = slt i1 %1, %2\n"
+        "  condbr void %3, b4, b3\n"
+        "b3:\n"
+        "  %4 = sub i32 %1, i32 1\n"
+        "  br void b5\n"
+        "b4:\n"
+        "  br void b5\n"
+        "b5:\n"
+        "  %5 = phi i32 [%4 b3, %2 b4]\n"
+        "  %6 = add i32 %5, %2\n"
+        "  ret void %6\n"
+        "}\n",
+    },
+    {
+        // Both arms assign the same value, the phi would be trivial
+        "sameArms",
+        "int sameArms(int a, int b) { int x; if (a) x = b; else x = b; return x; }\n",
+        "define @sameArms(i32, i32) -> i32 {\n"
+        "b1:\n"
+        "  %1 = param i32 #0\n"
+        "  %2 = param i32 #1\n"
+        "  br void b2\n"
+        "b2:\n"
+        "  %3 = ne i1 %1, i32 0\n"
+        "  condbr void %3, b4, b3\n"
+        "b3:\n"
+        "  br void b5\n"
+        "b4:\n"
+        "  br void b5\n"
+        "b5:\n"
+        "  ret void %2\n"
+        "}\n",
+    },
+    {
+        // k and n are read in the loop but never written
+        "loop",
+        "int loop(int n) { int i = 0, sum = 0, k = 5; while (i < n) { sum = sum + i * k; i++; } return sum + k; }\n",
+        "define @loop(i32) -> i32 {\n"
+        "b1:\n"
+        "  %1 = param i32 #0\n"
+        "  br void b2\n"
+        "b2:\n"
+        "  br void b3\n"
+        "b3:\n"
+        "  %2 = phi i32 [i32 0 b2, %8 b5]\n"
+        "  %3 = phi i32 [i32 0 b2, %7 b5]\n"
+        "  %4 = slt i1 %2, %1\n"
+        "  condbr void %4, b5, b4\n"
+        "b4:\n"
+        "  %5 = add i32 %3, i32 5\n"
+        "  ret void %5\n"
+        "b5:\n"
+        "  %6 = mul i32 %2, i32 5\n"
+        "  %7 = add i32 %3, %6\n"
+        "  %8 = add i32 %2, i32 1\n"
+        "  br void b3\n"
+        "}\n",
+    },
+    {
+        // The inner header merges j and s, i only changes in the outer loop
+        "nested",
+        "int nested(int n) { int s = 0; for (int i = 0; i < n; i++) for (int j = 0; j < i; j++) s += j; return s; }\n",
+        "define @nested(i32) -> i32 {\n"
+        "b1:\n"
+        "  %1 = param i32 #0\n"
+        "  br void b2\n"
+        "b2:\n"
+        "  br void b3\n"
+        "b3:\n"
+        "  %2 = phi i32 [i32 0 b2, %8 b8]\n"
+        "  %3 = phi i32 [i32 0 b2, %6 b8]\n"
+        "  %4 = slt i1 %2, %1\n"
+        "  condbr void %4, b5, b4\n"
+        "b4:\n"
+        "  ret void %3\n"
+        "b5:\n"
+        "  br void b6\n"
+        "b6:\n"
+        "  %5 = phi i32 [i32 0 b5, %10 b10]\n"
+        "  %6 = phi i32 [%3 b5, %9 b10]\n"
+        "  %7 = slt i1 %5, %2\n"
+        "  condbr void %7, b9, b7\n"
+        "b7:\n"
+        "  br void b8\n"
+        "b8:\n"
+        "  %8 = add i32 %2, i32 1\n"
+        "  br void b3\n"
+        "b9:\n"
+        "  %9 = add i32 %6, %5\n"
+        "  br void b10\n"
+        "b10:\n"
+        "  %10 = add i32 %5, i32 1\n"
+        "  br void b6\n"
+        "}\n",
+    },
+    {
+        // The body of a do loop is its header, k is only read after it
+        "untouched",
+        "int untouched(int n, int k) { int i = 0; do { i = i + 1; } while (i < n); return i + k; }\n",
+        "define @untouched(i32, i32) -> i32 {\n"
+        "b1:\n"
+        "  %1 = param i32 #0\n"
+        "  %2 = param i32 #1\n"
+        "  br void b2\n"
+        "b2:\n"
+        "  br void b3\n"
+        "b3:\n"
+        "  %3 = phi i32 [i32 0 b2, %4 b4]\n"
+        "  %4 = add i32 %3, i32 1\n"
+        "  br void b4\n"
+        "b4:\n"
+        "  %5 = slt i1 %4, %1\n"
+        "  condbr void %5, b3, b5\n"
+        "b5:\n"
+        "  %6 = add i32 %4, %2\n"
+        "  ret void %6\n"
+        "}\n",
+    },
+};
+
+/* Parse a file with bodies lowered into `module` */
+static bool TestLoweringParse(TestUnit* unit, IRModule module, const char* source, size_t length)
+{
+    if (!TestWriteFile(TEST_LOWERING_SOURCE, source, length))
+        return false;
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+    config.module = module;
+
+    bool parsed = TestUnit_Parse(unit, TEST_LOWERING_SOURCE, &config, 0) && unit->result == PARSER_RESULT_SUCCESS;
+    remove(TEST_LOWERING_SOURCE);
+
+    return parsed;
+}
+
+/* The FUNCTION_DECL at file scope named `name` */
+static ASTNodeId TestLoweringFunction(const TestUnit* unit, const char* name)
+{
+    ASTTree tree = ASTParser_GetTree(unit->parser);
+    ParserInterner interner = ASTParser_GetInterner(unit->parser);
+    ASTSymbolTable symbols = ASTParser_GetSymbolTable(unit->parser);
+    ASTNodeId root = AST_NODE_TO_ID(unit->root);
+
+    for (uint32_t i = 0; i < ASTTree_GetChildCount(tree, root); i++) {
+        ASTNodeId child = ASTTree_GetChild(tree, root, i);
+        if (ASTTree_GetNodeType(tree, child) != AST_NODE_TYPE_FUNCTION_DECL)
+            continue;
+
+        const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(symbols, ASTTree_GetData(tree, child).rhs);
+        if (symbol && strcmp(ParserInterner_Get(interner, symbol->name)->text, name) == 0)
+            return child;
+    }
+
+    return AST_NODE_ID_NONE;
+}
+
+/* Lower every function of the table in one unit and compare each with its expected text */
+static void TestLoweringPhis(void)
+{
+    TestText source = { 0 };
+    for (uint32_t i = 0; i < TEST_COUNT(s_Phis); i++)
+        TestText_Append(&source, "%s", s_Phis[i].source);
+
+    IRModule module = NULL;
+    TestUnit unit = { 0 };
+    bool parsed = CreateIRModule(&module) == PARSER_RESULT_SUCCESS &&
+        TestLoweringParse(&unit, module, source.data, source.length);
+    TestText_Free(&source);
+
+    ASTParserStats stats = { 0 };
+    if (parsed)
+        ASTParser_GetStats(unit.parser, &stats);
+
+    // No body nodes are built for a lowered function
+    bool same = parsed;
+    bool bodiesAbsent = parsed;
+    for (uint32_t i = 0; i < TEST_COUNT(s_Phis) && same; i++) {
+        ASTNodeId function = TestLoweringFunction(&unit, s_Phis[i].name);
+        IRFunction ir = function ? ASTParser_GetFunctionIR(unit.parser, AST_NODE_FROM_ID(function)) : NULL;
+        bodiesAbsent = bodiesAbsent && function &&
+            ASTTree_GetChild(ASTParser_GetTree(unit.parser), function, 1) == AST_NODE_ID_NONE;
+
+        char* text = NULL;
+        size_t length = 0;
+        same = ir && IRFunction_Print(ir, &text, &length) == PARSER_RESULT_SUCCESS &&
+            length == strlen(s_Phis[i].ir) && memcmp(text, s_Phis[i].ir, length) == 0;
+        if (!same)
+            printf("    %s lowered to:\n%.*s", s_Phis[i].name, (int)length, text ? text : "");
+        IRText_Free(text);
+    }
+
+    TestUnit_Destroy(&unit);
+    IRModuleDestroy(module);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(stats.loweredBodies == TEST_COUNT(s_Phis) && stats.fallbackBodies == 0);
+    TEST_CHECK(bodiesAbsent);
+    TEST_CHECK(same);
+}
+
+/**
+ * Over generated code, every phi that is left joins at least two different
+ * values coming from as many predecessors: a phi whose operands are one value
+ * or the phi itself would be trivial, and the builder removes those.
+ */
+static void TestLoweringMinimal(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, 300, 9);
+
+    IRModule module = NULL;
+    TestUnit unit = { 0 };
+    bool parsed = CreateIRModule(&module) == PARSER_RESULT_SUCCESS &&
+        TestLoweringParse(&unit, module, source.data, source.length);
+    TestText_Free(&source);
+    TestUnit_Destroy(&unit);
+
+    uint32_t phis = 0;
+    uint32_t trivial = 0;
+    uint32_t mismatched = 0;
+
+    for (uint32_t i = 0; parsed && i < IRModule_GetFunctionCount(module); i++) {
+        IRFunction function = IRModule_GetFunction(module, i);
+
+        for (IRValueId id = 1; id < IRFunction_GetInstructionCount(function); id++) {
+            const IRInstruction* instruction = IRFunction_GetInstruction(function, id);
+            if (instruction->opcode != IR_OP_PHI || instruction->block == IR_BLOCK_NONE)
+                continue;
+
+            uint32_t count = 0;
+            uint32_t predCount = 0;
+            const uint32_t* operands = IRFunction_GetList(function, id, &count);
+            IRFunction_GetPredecessors(function, instruction->block, &predCount);
+
+            IRValueId same = IR_VALUE_NONE;
+            bool distinct = false;
+            for (uint32_t j = 0; j < count; j++) {
+                if (operands[j] == id || operands[j] == same)
+                    continue;
+                distinct = distinct || same != IR_VALUE_NONE;
+                same = operands[j];
+            }
+
+            phis++;
+            trivial += !distinct;
+            mismatched += count != predCount || count < 2;
+        }
+    }
+
+    IRModuleDestroy(module);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(phis > 100);
+    TEST_CHECK(trivial == 0 && mismatched == 0);
+}
+
+static const TestCase s_Tests[] = {
+    { "Phis", TestLoweringPhis },
+    { "Minimal", TestLoweringMinimal },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteIRLowering = {
+    "IRLowering", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,877 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "ir/IR.h"
+#include "ir/IRPasses.h"
+#include "ir/IRText.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+/* Passes to run over a module read from text */
+typedef ParserResult (*PFN_TestPassRun)(IRModule module, IRPassStats* stats);
+
+/* Run a function pass over every function of a module */
+static ParserResult TestPassEach(IRModule module, ParserResult (*pass)(IRFunction, IRPassStats*), IRPassStats* stats)
+{
+    for (uint32_t i = 0; i < IRModule_GetFunctionCount(module); i++) {
+        ParserResult result = pass(IRModule_GetFunction(module, i), stats);
+        if (result != PARSER_RESULT_SUCCESS)
+            return result;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/**
+ * Read `input` into a module, run the passes and compare the printed module
+ * with `expected`, unless that is NULL. The text that came out is printed
+ * when they differ.
+ */
+static bool TestPassCheck(const char* input, PFN_TestPassRun run, const char* expected, IRPassStats* stats)
+{
+    IRModule module = NULL;
+    uint32_t errorLine = 0;
+    bool read = CreateIRModule(&module) == PARSER_RESULT_SUCCESS &&
+        IRModule_Parse(module, input, strlen(input), &errorLine) == PARSER_RESULT_SUCCESS;
+    bool ran = read && run(module, stats) == PARSER_RESULT_SUCCESS;
+
+    char* text = NULL;
+    size_t length = 0;
+    bool same = ran && (!expected || (IRModule_Print(module, &text, &length) == PARSER_RESULT_SUCCESS &&
+        length == strlen(expected) && memcmp(text, expected, length) == 0));
+
+    if (!read)
+        printf("    input could not be read, error on line %u\n", errorLine);
+    else if (!same)
+        printf("    passes gave:\n%.*s", (int)length, text ? text : "");
+
+    IRText_Free(text);
+    IRModuleDestroy(module);
+
+    return same;
+}
+
+// ===== CONSTANTS AND DEAD CODE =====
+
+static ParserResult TestPassConstants(IRModule module, IRPassStats* stats)
+{
+    return TestPassEach(module, IRFunction_PropagateConstants, stats);
+}
+
+static ParserResult TestPassConstantsAndDeadCode(IRModule module, IRPassStats* stats)
+{
+    ParserResult result = TestPassEach(module, IRFunction_PropagateConstants, stats);
+    return result == PARSER_RESULT_SUCCESS ? TestPassEach(module, IRFunction_EliminateDeadCode, stats) : result;
+}
+
+static ParserResult TestPassDeadCode(IRModule module, IRPassStats* stats)
+{
+    return TestPassEach(module, IRFunction_EliminateDeadCode, stats);
+}
+
+/* A phi whose back edge brings its own value stays constant, the loop test does not */
+static const char s_ConstantLoopInput[] =
+    "define @phis(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  br void b2\n"
+    "b2:\n"
+    "  %2 = phi i32 [i32 1 b1, %4 b3]\n"
+    "  %3 = slt i1 %1, i32 10\n"
+    "  condbr void %3, b3, b4\n"
+    "b3:\n"
+    "  %4 = mul i32 %2, i32 1\n"
+    "  br void b2\n"
+    "b4:\n"
+    "  %5 = add i32 %2, i32 2\n"
+    "  ret void %5\n"
+    "}\n";
+
+static const char s_ConstantLoopOutput[] =
+    "declare @phis\n"
+    "\n"
+    "define @phis(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  br void b2\n"
+    "b2:\n"
+    "  %2 = slt i1 %1, i32 10\n"
+    "  condbr void %2, b4, b3\n"
+    "b3:\n"
+    "  ret void i32 3\n"
+    "b4:\n"
+    "  br void b2\n"
+    "}\n";
+
+/* The never taken arm goes, so the phi only meets the constant of the other */
+static const char s_ConstantBranchInput[] =
+    "define @branch(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = eq i1 i32 1, i32 1\n"
+    "  condbr void %2, b2, b3\n"
+    "b2:\n"
+    "  %3 = add i32 %1, i32 1\n"
+    "  br void b4\n"
+    "b3:\n"
+    "  %4 = sub i32 %1, i32 1\n"
+    "  br void b4\n"
+    "b4:\n"
+    "  %5 = phi i32 [i32 2 b2, %4 b3]\n"
+    "  %6 = mul i32 %5, i32 3\n"
+    "  ret void %6\n"
+    "}\n";
+
+static const char s_ConstantBranchOutput[] =
+    "declare @branch\n"
+    "\n"
+    "define @branch(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  br void b2\n"
+    "b2:\n"
+    "  %2 = add i32 %1, i32 1\n"
+    "  br void b3\n"
+    "b3:\n"
+    "  ret void i32 6\n"
+    "}\n";
+
+/* Dead code elimination then drops the unused add and merges the chain */
+static const char s_ConstantBranchCleanOutput[] =
+    "declare @branch\n"
+    "\n"
+    "define @branch(i32) -> i32 {\n"
+    "b1:\n"
+    "  ret void i32 6\n"
+    "}\n";
+
+static void TestPassConstantPhis(void)
+{
+    IRPassStats loop = { 0 }, branch = { 0 }, clean = { 0 };
+
+    TEST_CHECK(TestPassCheck(s_ConstantLoopInput, TestPassConstants, s_ConstantLoopOutput, &loop));
+    TEST_CHECK(loop.valuesFolded >= 3 && loop.branchesFolded == 0);
+
+    TEST_CHECK(TestPassCheck(s_ConstantBranchInput, TestPassConstants, s_ConstantBranchOutput, &branch));
+    TEST_CHECK(branch.branchesFolded == 1 && branch.blocksRemoved == 1);
+
+    TEST_CHECK(TestPassCheck(s_ConstantBranchInput, TestPassConstantsAndDeadCode, s_ConstantBranchCleanOutput,
+        &clean));
+    TEST_CHECK(clean.blocksRemoved == 3);
+}
+
+/* A diamond only an unused phi needs goes with its branch, the join merges into the entry */
+static const char s_DeadDiamondInput[] =
+    "define @dead(ptr, i32) -> void {\n"
+    "b1:\n"
+    "  %1 = param ptr #0\n"
+    "  %2 = param i32 #1\n"
+    "  %3 = slt i1 %2, i32 0\n"
+    "  condbr void %3, b2, b3\n"
+    "b2:\n"
+    "  %4 = mul i32 %2, %2\n"
+    "  br void b4\n"
+    "b3:\n"
+    "  %5 = add i32 %2, i32 7\n"
+    "  br void b4\n"
+    "b4:\n"
+    "  %6 = phi i32 [%4 b2, %5 b3]\n"
+    "  %7 = load volatile i32 %1\n"
+    "  %8 = load i32 %1\n"
+    "  store void %1, %2\n"
+    "  ret void none\n"
+    "}\n";
+
+static const char s_DeadDiamondOutput[] =
+    "declare @dead\n"
+    "\n"
+    "define @dead(ptr, i32) -> void {\n"
+    "b1:\n"
+    "  %1 = param ptr #0\n"
+    "  %2 = param i32 #1\n"
+    "  %3 = load volatile i32 %1\n"
+    "  store void %1, %2\n"
+    "  ret void none\n"
+    "}\n";
+
+/* A loop without effects may not end, it is kept as it is */
+static const char s_DeadLoop[] =
+    "declare @spin\n"
+    "\n"
+    "define @spin(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  br void b2\n"
+    "b2:\n"
+    "  %2 = phi i32 [i32 0 b1, %3 b2]\n"
+    "  %3 = add i32 %2, i32 1\n"
+    "  %4 = slt i1 %3, %1\n"
+    "  condbr void %4, b2, b3\n"
+    "b3:\n"
+    "  ret void i32 0\n"
+    "}\n";
+
+static void TestPassDeadBlocks(void)
+{
+    IRPassStats diamond = { 0 }, loop = { 0 };
+
+    TEST_CHECK(TestPassCheck(s_DeadDiamondInput, TestPassDeadCode, s_DeadDiamondOutput, &diamond));
+    TEST_CHECK(diamond.branchesFolded == 1 && diamond.blocksRemoved == 3);
+
+    TEST_CHECK(TestPassCheck(s_DeadLoop, TestPassDeadCode, s_DeadLoop, &loop));
+    TEST_CHECK(loop.instructionsRemoved == 0 && loop.blocksRemoved == 0);
+}
+
+// ===== VALUE NUMBERING =====
+
+static ParserResult TestPassValueNumbering(IRModule module, IRPassStats* stats)
+{
+    return TestPassEach(module, IRFunction_NumberValues, stats);
+}
+
+/**
+ * In @gvn the store through another pointer cannot reach the restrict
+ * parameter, so its second load takes the first. Both volatile loads stay.
+ * The call may write @g, the load after it stays, the one after that
+ * takes it. In @plain the pointers may be the same and the load stays.
+ */
+static const char s_ValueNumberingInput[] =
+    "declare @h\n"
+    "data @g 4 align 4\n"
+    "define @gvn(ptr, ptr, ptr) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param noalias ptr #0\n"
+    "  %2 = param ptr #1\n"
+    "  %3 = param ptr #2\n"
+    "  %4 = load i32 %1\n"
+    "  store void %3, i32 1\n"
+    "  %5 = load i32 %1\n"
+    "  %6 = load volatile i32 %2\n"
+    "  %7 = load volatile i32 %2\n"
+    "  %8 = global ptr @g\n"
+    "  %9 = load i32 %8\n"
+    "  %10 = global ptr @h\n"
+    "  %11 = call i32 %10, [%4]\n"
+    "  %12 = load i32 %8\n"
+    "  %13 = global ptr @g\n"
+    "  %14 = load i32 %13\n"
+    "  %15 = add i32 %4, %5\n"
+    "  %16 = add i32 %6, %7\n"
+    "  %17 = add i32 %9, %12\n"
+    "  %18 = add i32 %15, %16\n"
+    "  %19 = add i32 %17, %14\n"
+    "  %20 = add i32 %18, %19\n"
+    "  ret void %20\n"
+    "}\n"
+    "define @plain(ptr, ptr) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param ptr #0\n"
+    "  %2 = param ptr #1\n"
+    "  %3 = load i32 %1\n"
+    "  store void %2, i32 1\n"
+    "  %4 = load i32 %1\n"
+    "  %5 = add i32 %4, %3\n"
+    "  %6 = add i32 %4, %3\n"
+    "  %7 = mul i32 %5, %6\n"
+    "  ret void %7\n"
+    "}\n";
+
+static const char s_ValueNumberingOutput[] =
+    "declare @h\n"
+    "data @g 4 align 4\n"
+    "declare @gvn\n"
+    "declare @plain\n"
+    "\n"
+    "define @gvn(ptr, ptr, ptr) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param noalias ptr #0\n"
+    "  %2 = param ptr #1\n"
+    "  %3 = param ptr #2\n"
+    "  %4 = load i32 %1\n"
+    "  store void %3, i32 1\n"
+    "  %5 = load volatile i32 %2\n"
+    "  %6 = load volatile i32 %2\n"
+    "  %7 = global ptr @g\n"
+    "  %8 = load i32 %7\n"
+    "  %9 = global ptr @h\n"
+    "  %10 = call i32 %9, [%4]\n"
+    "  %11 = load i32 %7\n"
+    "  %12 = add i32 %4, %4\n"
+    "  %13 = add i32 %5, %6\n"
+    "  %14 = add i32 %8, %11\n"
+    "  %15 = add i32 %12, %13\n"
+    "  %16 = add i32 %14, %11\n"
+    "  %17 = add i32 %15, %16\n"
+    "  ret void %17\n"
+    "}\n"
+    "\n"
+    "define @plain(ptr, ptr) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param ptr #0\n"
+    "  %2 = param ptr #1\n"
+    "  %3 = load i32 %1\n"
+    "  store void %2, i32 1\n"
+    "  %4 = load i32 %1\n"
+    "  %5 = add i32 %4, %3\n"
+    "  %6 = mul i32 %5, %5\n"
+    "  ret void %6\n"
+    "}\n";
+
+static void TestPassValueNumberingMemory(void)
+{
+    IRPassStats stats = { 0 };
+
+    TEST_CHECK(TestPassCheck(s_ValueNumberingInput, TestPassValueNumbering, s_ValueNumberingOutput, &stats));
+    TEST_CHECK(stats.loadsRemoved == 2 && stats.valuesMerged == 2);
+}
+
+// ===== INLINING =====
+
+static ParserResult TestPassInline(IRModule module, IRPassStats* stats)
+{
+    return IRModule_InlineFunctions(module, NULL, stats);
+}
+
+/* One more than the growth of inlining @big */
+static ParserResult TestPassInlineRaised(IRModule module, IRPassStats* stats)
+{
+    IRInlineConfig config = { 0 };
+    config.threshold = 13;
+
+    return IRModule_InlineFunctions(module, &config, stats);
+}
+
+/* As much as the threshold allows, but the module may not grow that much */
+static ParserResult TestPassInlineBudget(IRModule module, IRPassStats* stats)
+{
+    IRInlineConfig config = { 0 };
+    config.threshold = 13;
+    config.growthLimit = 8;
+
+    return IRModule_InlineFunctions(module, &config, stats);
+}
+
+/* Any call out of the recursion may be inlined, the one in it may not */
+static ParserResult TestPassInlineAll(IRModule module, IRPassStats* stats)
+{
+    IRInlineConfig config = { 0 };
+    config.threshold = 1000;
+
+    return IRModule_InlineFunctions(module, &config, stats);
+}
+
+/**
+ * @inc only adds, it is inlined and removed as nothing else refers to it.
+ * @big grows the code by 13 instructions, over the default threshold. The
+ * body of @fact goes into @caller, its call to itself stays a call.
+ */
+static const char s_InlineInput[] =
+    "declare @inc internal\n"
+    "declare @big\n"
+    "declare @fact\n"
+    "declare @caller\n"
+    "define @inc(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = add i32 %1, i32 1\n"
+    "  ret void %2\n"
+    "}\n"
+    "define @big(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = mul i32 %1, i32 3\n"
+    "  %3 = mul i32 %2, i32 4\n"
+    "  %4 = mul i32 %3, i32 5\n"
+    "  %5 = mul i32 %4, i32 6\n"
+    "  %6 = mul i32 %5, i32 7\n"
+    "  %7 = mul i32 %6, i32 8\n"
+    "  %8 = mul i32 %7, i32 9\n"
+    "  %9 = mul i32 %8, i32 10\n"
+    "  %10 = mul i32 %9, i32 11\n"
+    "  %11 = mul i32 %10, i32 12\n"
+    "  %12 = mul i32 %11, i32 13\n"
+    "  %13 = mul i32 %12, i32 14\n"
+    "  %14 = mul i32 %13, i32 15\n"
+    "  %15 = mul i32 %14, i32 16\n"
+    "  %16 = mul i32 %15, i32 17\n"
+    "  %17 = mul i32 %16, i32 18\n"
+    "  ret void %17\n"
+    "}\n"
+    "define @fact(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = slt i1 %1, i32 2\n"
+    "  condbr void %2, b2, b3\n"
+    "b2:\n"
+    "  ret void i32 1\n"
+    "b3:\n"
+    "  %3 = sub i32 %1, i32 1\n"
+    "  %4 = global ptr @fact\n"
+    "  %5 = call i32 %4, [%3]\n"
+    "  %6 = mul i32 %1, %5\n"
+    "  ret void %6\n"
+    "}\n"
+    "define @caller(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = global ptr @inc\n"
+    "  %3 = call i32 %2, [%1]\n"
+    "  %4 = global ptr @big\n"
+    "  %5 = call i32 %4, [%3]\n"
+    "  %6 = global ptr @fact\n"
+    "  %7 = call i32 %6, [%5]\n"
+    "  ret void %7\n"
+    "}\n";
+
+static const char s_InlineOutput[] =
+    "declare @inc internal\n"
+    "declare @big\n"
+    "declare @fact\n"
+    "declare @caller\n"
+    "\n"
+    "define @big(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = mul i32 %1, i32 3\n"
+    "  %3 = mul i32 %2, i32 4\n"
+    "  %4 = mul i32 %3, i32 5\n"
+    "  %5 = mul i32 %4, i32 6\n"
+    "  %6 = mul i32 %5, i32 7\n"
+    "  %7 = mul i32 %6, i32 8\n"
+    "  %8 = mul i32 %7, i32 9\n"
+    "  %9 = mul i32 %8, i32 10\n"
+    "  %10 = mul i32 %9, i32 11\n"
+    "  %11 = mul i32 %10, i32 12\n"
+    "  %12 = mul i32 %11, i32 13\n"
+    "  %13 = mul i32 %12, i32 14\n"
+    "  %14 = mul i32 %13, i32 15\n"
+    "  %15 = mul i32 %14, i32 16\n"
+    "  %16 = mul i32 %15, i32 17\n"
+    "  %17 = mul i32 %16, i32 18\n"
+    "  ret void %17\n"
+    "}\n"
+    "\n"
+    "define @fact(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = slt i1 %1, i32 2\n"
+    "  condbr void %2, b3, b2\n"
+    "b2:\n"
+    "  %3 = sub i32 %1, i32 1\n"
+    "  %4 = global ptr @fact\n"
+    "  %5 = call i32 %4, [%3]\n"
+    "  %6 = mul i32 %1, %5\n"
+    "  ret void %6\n"
+    "b3:\n"
+    "  ret void i32 1\n"
+    "}\n"
+    "\n"
+    "define @caller(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = global ptr @inc\n"
+    "  br void b2\n"
+    "b2:\n"
+    "  %3 = add i32 %1, i32 1\n"
+    "  br void b3\n"
+    "b3:\n"
+    "  %4 = global ptr @big\n"
+    "  %5 = call i32 %4, [%3]\n"
+    "  %6 = global ptr @fact\n"
+    "  br void b4\n"
+    "b4:\n"
+    "  %7 = slt i1 %5, i32 2\n"
+    "  condbr void %7, b6, b5\n"
+    "b5:\n"
+    "  %8 = sub i32 %5, i32 1\n"
+    "  %9 = global ptr @fact\n"
+    "  %10 = call i32 %9, [%8]\n"
+    "  %11 = mul i32 %5, %10\n"
+    "  br void b7\n"
+    "b6:\n"
+    "  br void b7\n"
+    "b7:\n"
+    "  %12 = phi i32 [%11 b5, i32 1 b6]\n"
+    "  ret void %12\n"
+    "}\n";
+
+static void TestPassInlineBudgets(void)
+{
+    IRPassStats defaults = { 0 }, raised = { 0 }, budget = { 0 }, all = { 0 };
+
+    TEST_CHECK(TestPassCheck(s_InlineInput, TestPassInline, s_InlineOutput, &defaults));
+    TEST_CHECK(defaults.callsInlined == 2 && defaults.functionsRemoved == 1);
+
+    TEST_CHECK(TestPassCheck(s_InlineInput, TestPassInlineRaised, NULL, &raised));
+    TEST_CHECK(raised.callsInlined == 3);
+
+    TEST_CHECK(TestPassCheck(s_InlineInput, TestPassInlineBudget, NULL, &budget));
+    TEST_CHECK(budget.callsInlined == 2);
+
+    // The recursive call is left in @fact, and @caller calls @fact again where its body went
+    TEST_CHECK(TestPassCheck(s_InlineInput, TestPassInlineAll, NULL, &all));
+    TEST_CHECK(all.callsInlined == 3);
+}
+
+// ===== LOOPS AND DIVISIONS =====
+
+static ParserResult TestPassLoops(IRModule module, IRPassStats* stats)
+{
+    return TestPassEach(module, IRFunction_OptimizeLoops, stats);
+}
+
+static ParserResult TestPassDivisions(IRModule module, IRPassStats* stats)
+{
+    return TestPassEach(module, IRFunction_LowerDivisions, stats);
+}
+
+/**
+ * `for (i = 0; i < n; i++) s += a[i] * (k * 3);` as lowered from C. The
+ * product of k moves to the preheader b2. a[i] becomes a pointer phi that
+ * moves on by 4 bytes, the exit test shows i cannot wrap before its sign
+ * extension.
+ */
+static const char s_LoopInput[] =
+    "define @sum(ptr, i32, i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param ptr #0\n"
+    "  %2 = param i32 #1\n"
+    "  %3 = param i32 #2\n"
+    "  br void b2\n"
+    "b2:\n"
+    "  br void b3\n"
+    "b3:\n"
+    "  %4 = phi i32 [i32 0 b2, %14 b6]\n"
+    "  %5 = phi i32 [i32 0 b2, %13 b6]\n"
+    "  %6 = slt i1 %4, %2\n"
+    "  condbr void %6, b5, b4\n"
+    "b4:\n"
+    "  ret void %5\n"
+    "b5:\n"
+    "  %7 = sext i64 %4\n"
+    "  %8 = mul i64 %7, i64 4\n"
+    "  %9 = ptradd ptr %1, %8\n"
+    "  %10 = load i32 %9\n"
+    "  %11 = mul i32 %3, i32 3\n"
+    "  %12 = mul i32 %10, %11\n"
+    "  %13 = add i32 %5, %12\n"
+    "  br void b6\n"
+    "b6:\n"
+    "  %14 = add i32 %4, i32 1\n"
+    "  br void b3\n"
+    "}\n";
+
+static const char s_LoopOutput[] =
+    "declare @sum\n"
+    "\n"
+    "define @sum(ptr, i32, i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param ptr #0\n"
+    "  %2 = param i32 #1\n"
+    "  %3 = param i32 #2\n"
+    "  br void b2\n"
+    "b2:\n"
+    "  %4 = mul i32 %3, i32 3\n"
+    "  br void b3\n"
+    "b3:\n"
+    "  %5 = phi i32 [i32 0 b2, %12 b6]\n"
+    "  %6 = phi i32 [i32 0 b2, %11 b6]\n"
+    "  %7 = phi ptr [%1 b2, %13 b6]\n"
+    "  %8 = slt i1 %5, %2\n"
+    "  condbr void %8, b5, b4\n"
+    "b4:\n"
+    "  ret void %6\n"
+    "b5:\n"
+    "  %9 = load i32 %7\n"
+    "  %10 = mul i32 %9, %4\n"
+    "  %11 = add i32 %6, %10\n"
+    "  br void b6\n"
+    "b6:\n"
+    "  %12 = add i32 %5, i32 1\n"
+    "  %13 = ptradd ptr %7, i64 4\n"
+    "  br void b3\n"
+    "}\n";
+
+static void TestPassLoopInvariants(void)
+{
+    IRPassStats stats = { 0 };
+
+    TEST_CHECK(TestPassCheck(s_LoopInput, TestPassLoops, s_LoopOutput, &stats));
+    TEST_CHECK(stats.valuesHoisted == 1 && stats.inductionsReduced == 1);
+}
+
+/**
+ * In order: signed and unsigned division by 7, by 8, signed and unsigned
+ * remainder by 8, signed division by -1 and by -7, a 64-bit unsigned
+ * division by 10, and a division by 0 that stays. The multipliers are
+ * those of Hacker's Delight 10-1: 0x92492493, 0x24924925 with the add
+ * fixup, 0x6DB6DB6D, and 0xCCCCCCCCCCCCCCCD.
+ */
+static const char s_DivisionInput[] =
+    "define @div(i32, i64) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = param i64 #1\n"
+    "  %3 = sdiv i32 %1, i32 7\n"
+    "  %4 = udiv i32 %1, i32 7\n"
+    "  %5 = sdiv i32 %1, i32 8\n"
+    "  %6 = udiv i32 %1, i32 8\n"
+    "  %7 = srem i32 %1, i32 8\n"
+    "  %8 = urem i32 %1, i32 8\n"
+    "  %9 = sdiv i32 %1, i32 -1\n"
+    "  %10 = sdiv i32 %1, i32 -7\n"
+    "  %11 = udiv i64 %2, i64 10\n"
+    "  %12 = sdiv i32 %1, i32 0\n"
+    "  ret void %3\n"
+    "}\n";
+
+static const char s_DivisionOutput[] =
+    "declare @div\n"
+    "\n"
+    "define @div(i32, i64) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = param i64 #1\n"
+    "  %3 = smulh i32 %1, i32 -1840700269\n"
+    "  %4 = add i32 %3, %1\n"
+    "  %5 = ashr i32 %4, i32 2\n"
+    "  %6 = lshr i32 %5, i32 31\n"
+    "  %7 = add i32 %5, %6\n"
+    "  %8 = umulh i32 %1, i32 613566757\n"
+    "  %9 = sub i32 %1, %8\n"
+    "  %10 = lshr i32 %9, i32 1\n"
+    "  %11 = add i32 %10, %8\n"
+    "  %12 = lshr i32 %11, i32 2\n"
+    "  %13 = ashr i32 %1, i32 2\n"
+    "  %14 = lshr i32 %13, i32 29\n"
+    "  %15 = add i32 %1, %14\n"
+    "  %16 = ashr i32 %15, i32 3\n"
+    "  %17 = lshr i32 %1, i32 3\n"
+    "  %18 = ashr i32 %1, i32 2\n"
+    "  %19 = lshr i32 %18, i32 29\n"
+    "  %20 = add i32 %1, %19\n"
+    "  %21 = ashr i32 %20, i32 3\n"
+    "  %22 = shl i32 %21, i32 3\n"
+    "  %23 = sub i32 %1, %22\n"
+    "  %24 = and i32 %1, i32 7\n"
+    "  %25 = neg i32 %1\n"
+    "  %26 = smulh i32 %1, i32 1840700269\n"
+    "  %27 = sub i32 %26, %1\n"
+    "  %28 = ashr i32 %27, i32 2\n"
+    "  %29 = lshr i32 %28, i32 31\n"
+    "  %30 = add i32 %28, %29\n"
+    "  %31 = umulh i64 %2, i64 -3689348814741910323\n"
+    "  %32 = lshr i64 %31, i64 3\n"
+    "  %33 = sdiv i32 %1, i32 0\n"
+    "  ret void %7\n"
+    "}\n";
+
+static void TestPassMagicDivision(void)
+{
+    IRPassStats stats = { 0 };
+
+    TEST_CHECK(TestPassCheck(s_DivisionInput, TestPassDivisions, s_DivisionOutput, &stats));
+    TEST_CHECK(stats.divisionsLowered == 9);
+}
+
+// ===== SWITCHES =====
+
+static ParserResult TestPassSwitches(IRModule module, IRPassStats* stats)
+{
+    for (uint32_t i = 0; i < IRModule_GetFunctionCount(module); i++) {
+        ParserResult result = IRFunction_LowerSwitches(IRModule_GetFunction(module, i), NULL, stats);
+        if (result != PARSER_RESULT_SUCCESS)
+            return result;
+    }
+
+    return PARSER_RESULT_SUCCESS;
+}
+
+/**
+ * @dense has cases 10 to 17: one unsigned bounds check of the value less 10
+ * guards a table switch. @bits has cases 1 to 28 going to two targets: a
+ * one shifted by the value less 1 is tested against a mask per target.
+ * @tree has five cases far apart: a search tree of signed compares against
+ * 1000, 100000 and 5000000 down to an equality test per case.
+ */
+static const char s_SwitchInput[] =
+    "define @dense(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  switch void %1, b2, [10 b3, 11 b4, 12 b5, 13 b6, 14 b7, 15 b3, 16 b4, 17 b5]\n"
+    "b2:\n"
+    "  ret void i32 -1\n"
+    "b3:\n"
+    "  ret void i32 30\n"
+    "b4:\n"
+    "  ret void i32 40\n"
+    "b5:\n"
+    "  ret void i32 50\n"
+    "b6:\n"
+    "  ret void i32 60\n"
+    "b7:\n"
+    "  ret void i32 70\n"
+    "}\n"
+    "\n"
+    "define @bits(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  switch void %1, b2, [1 b3, 3 b4, 5 b3, 9 b4, 17 b3, 20 b4, 28 b3]\n"
+    "b2:\n"
+    "  ret void i32 -1\n"
+    "b3:\n"
+    "  ret void i32 30\n"
+    "b4:\n"
+    "  ret void i32 40\n"
+    "}\n"
+    "\n"
+    "define @tree(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  switch void %1, b2, [-7 b3, 10 b4, 1000 b5, 100000 b6, 5000000 b7]\n"
+    "b2:\n"
+    "  ret void i32 -1\n"
+    "b3:\n"
+    "  ret void i32 30\n"
+    "b4:\n"
+    "  ret void i32 40\n"
+    "b5:\n"
+    "  ret void i32 50\n"
+    "b6:\n"
+    "  ret void i32 60\n"
+    "b7:\n"
+    "  ret void i32 70\n"
+    "}\n";
+
+static const char s_SwitchOutput[] =
+    "declare @dense\n"
+    "declare @bits\n"
+    "declare @tree\n"
+    "\n"
+    "define @dense(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = sub i32 %1, i32 10\n"
+    "  %3 = ule i1 %2, i32 7\n"
+    "  condbr void %3, b2, b8\n"
+    "b2:\n"
+    "  switch table void %2, b8, [0 b7, 1 b6, 2 b5, 3 b4, 4 b3, 5 b7, 6 b6, 7 b5]\n"
+    "b3:\n"
+    "  ret void i32 70\n"
+    "b4:\n"
+    "  ret void i32 60\n"
+    "b5:\n"
+    "  ret void i32 50\n"
+    "b6:\n"
+    "  ret void i32 40\n"
+    "b7:\n"
+    "  ret void i32 30\n"
+    "b8:\n"
+    "  ret void i32 -1\n"
+    "}\n"
+    "\n"
+    "define @bits(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = sub i32 %1, i32 1\n"
+    "  %3 = ule i1 %2, i32 27\n"
+    "  condbr void %3, b2, b4\n"
+    "b2:\n"
+    "  %4 = shl i32 i32 1, %2\n"
+    "  %5 = and i32 %4, i32 134283281\n"
+    "  %6 = ne i1 %5, i32 0\n"
+    "  condbr void %6, b6, b3\n"
+    "b3:\n"
+    "  %7 = and i32 %4, i32 524548\n"
+    "  %8 = ne i1 %7, i32 0\n"
+    "  condbr void %8, b5, b4\n"
+    "b4:\n"
+    "  ret void i32 -1\n"
+    "b5:\n"
+    "  ret void i32 40\n"
+    "b6:\n"
+    "  ret void i32 30\n"
+    "}\n"
+    "\n"
+    "define @tree(i32) -> i32 {\n"
+    "b1:\n"
+    "  %1 = param i32 #0\n"
+    "  %2 = slt i1 %1, i32 1000\n"
+    "  condbr void %2, b10, b2\n"
+    "b2:\n"
+    "  %3 = slt i1 %1, i32 100000\n"
+    "  condbr void %3, b8, b3\n"
+    "b3:\n"
+    "  %4 = slt i1 %1, i32 5000000\n"
+    "  condbr void %4, b6, b4\n"
+    "b4:\n"
+    "  %5 = eq i1 %1, i32 5000000\n"
+    "  condbr void %5, b5, b14\n"
+    "b5:\n"
+    "  ret void i32 70\n"
+    "b6:\n"
+    "  %6 = eq i1 %1, i32 100000\n"
+    "  condbr void %6, b7, b14\n"
+    "b7:\n"
+    "  ret void i32 60\n"
+    "b8:\n"
+    "  %7 = eq i1 %1, i32 1000\n"
+    "  condbr void %7, b9, b14\n"
+    "b9:\n"
+    "  ret void i32 50\n"
+    "b10:\n"
+    "  %8 = slt i1 %1, i32 10\n"
+    "  condbr void %8, b13, b11\n"
+    "b11:\n"
+    "  %9 = eq i1 %1, i32 10\n"
+    "  condbr void %9, b12, b14\n"
+    "b12:\n"
+    "  ret void i32 40\n"
+    "b13:\n"
+    "  %10 = eq i1 %1, i32 -7\n"
+    "  condbr void %10, b15, b14\n"
+    "b14:\n"
+    "  ret void i32 -1\n"
+    "b15:\n"
+    "  ret void i32 30\n"
+    "}\n";
+
+static void TestPassSwitchClusters(void)
+{
+    IRPassStats stats = { 0 }, again = { 0 };
+
+    TEST_CHECK(TestPassCheck(s_SwitchInput, TestPassSwitches, s_SwitchOutput, &stats));
+    TEST_CHECK(stats.switchesLowered == 3);
+
+    // A table switch is left as it is on a later run
+    TEST_CHECK(TestPassCheck(s_SwitchOutput, TestPassSwitches, s_SwitchOutput, &again));
+    TEST_CHECK(again.switchesLowered == 0);
+}
+
+static const TestCase s_Tests[] = {
+    { "ConstantPhis", TestPassConstantPhis },
+    { "DeadBlocks", TestPassDeadBlocks },
+    { "ValueNumberingMemory", TestPassValueNumberingMemory },
+    { "InlineBudgets", TestPassInlineBudgets },
+    { "LoopInvariants", TestPassLoopInvariants },
+    { "MagicDivision", TestPassMagicDivision },
+    { "SwitchClusters", TestPassSwitchClusters },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteIRPasses = {
+    "IRPasses", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
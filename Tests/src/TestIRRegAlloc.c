@@ -0,0 +1,517 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "ir/IR.h"
+#include "ir/IRRegAlloc.h"
+#include "ir/IRText.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_REGALLOC_PRESSURE_VALUES   24u
+#define TEST_REGALLOC_LINEAR_SEGMENTS   2500u
+#define TEST_REGALLOC_LINEAR_RUNS       3u
+
+/* Read a module of one function from text and allocate its registers */
+static bool TestRegAllocCreate(const TestText* text, const IRRegAllocConfig* config, IRModule* module,
+    IRFunction* function, IRRegAlloc* alloc)
+{
+    *module = NULL;
+    *function = NULL;
+    *alloc = NULL;
+
+    uint32_t errorLine = 0;
+    if (CreateIRModule(module) != PARSER_RESULT_SUCCESS ||
+        IRModule_Parse(*module, text->data, text->length, &errorLine) != PARSER_RESULT_SUCCESS) {
+        printf("    text could not be read, error on line %u\n", errorLine);
+        return false;
+    }
+
+    *function = IRModule_GetFunction(*module, 0);
+    return *function && CreateIRRegAlloc(*function, config, alloc) == PARSER_RESULT_SUCCESS;
+}
+
+static void TestRegAllocDestroy(IRModule module, IRRegAlloc alloc)
+{
+    if (alloc)
+        IRRegAllocDestroy(alloc);
+    if (module)
+        IRModuleDestroy(module);
+}
+
+/* The `index`th instruction with `opcode` in layout order, IR_VALUE_NONE when there are fewer */
+static IRValueId TestRegAllocFind(const IRFunction function, IROpcode opcode, uint32_t index)
+{
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < IRFunction_GetBlockCount(function); block++) {
+        for (IRValueId id = IRFunction_GetBlock(function, block)->first; id != IR_VALUE_NONE;
+             id = IRFunction_GetInstruction(function, id)->next) {
+            if (IRFunction_GetInstruction(function, id)->opcode == opcode && index-- == 0)
+                return id;
+        }
+    }
+
+    return IR_VALUE_NONE;
+}
+
+/* Registers of a location as a mask, 0 for other kinds */
+static uint64_t TestRegAllocMask(const IRLocation* location)
+{
+    if (location->kind != IR_LOCATION_REGISTER || location->count == 0)
+        return 0;
+
+    uint64_t registers = location->count >= 64 ? ~0ull : ((1ull << location->count) - 1);
+    return registers << location->index;
+}
+
+/**
+ * Before every instruction but a phi, the values live there hold disjoint
+ * registers below `registerCount`, outside `reserved`, and every operand
+ * that needs a register has one. Returns the most registers held at once.
+ */
+static uint32_t TestRegAllocCheckPressure(const IRFunction function, const IRRegAlloc alloc, uint32_t registerCount,
+    uint64_t reserved, bool* valid)
+{
+    uint32_t valueCount = IRFunction_GetInstructionCount(function);
+    uint32_t most = 0;
+    *valid = true;
+
+    for (IRBlockId block = IR_BLOCK_ENTRY; block < IRFunction_GetBlockCount(function); block++) {
+        for (IRValueId at = IRFunction_GetBlock(function, block)->first; at != IR_VALUE_NONE;
+             at = IRFunction_GetInstruction(function, at)->next) {
+            const IRInstruction* instruction = IRFunction_GetInstruction(function, at);
+            if (instruction->opcode == IR_OP_PHI)
+                continue;
+
+            uint64_t taken = 0;
+            for (IRValueId value = 1; value < valueCount; value++) {
+                if (value == at)
+                    continue;
+
+                IRLocation location;
+                IRRegAlloc_GetLocation(alloc, value, at, &location);
+                uint64_t mask = TestRegAllocMask(&location);
+                if (location.kind == IR_LOCATION_REGISTER &&
+                    (location.index + location.count > registerCount || (mask & reserved) || (mask & taken))) {
+                    printf("    %%%u at %%%u is in r%u, taken or out of range\n", value, at, location.index);
+                    *valid = false;
+                }
+                taken |= mask;
+            }
+
+            // Arithmetic and memory operands are read from registers, call and return operands may be anywhere
+            if (instruction->opcode != IR_OP_CALL && instruction->opcode != IR_OP_RET) {
+                const IROpcodeInfo* info = IROpcode_GetInfo((IROpcode)instruction->opcode);
+                for (uint32_t i = 0; i < 3; i++) {
+                    if (info->operands[i] != IR_OPERAND_VALUE || instruction->operands[i] == IR_VALUE_NONE)
+                        continue;
+
+                    IRLocation location;
+                    IRRegAlloc_GetLocation(alloc, instruction->operands[i], at, &location);
+                    if (location.kind != IR_LOCATION_REGISTER) {
+                        printf("    operand %%%u of %%%u is not in a register\n", instruction->operands[i], at);
+                        *valid = false;
+                    }
+                }
+            }
+
+            uint32_t count = 0;
+            for (uint64_t rest = taken; rest; rest &= rest - 1)
+                count++;
+            if (count > most)
+                most = count;
+        }
+    }
+
+    return most;
+}
+
+/* Whether a move before an instruction of `block` goes to or from the stack */
+static bool TestRegAllocBlockTouchesStack(const IRFunction function, const IRRegAlloc alloc, IRBlockId block)
+{
+    for (IRValueId at = IRFunction_GetBlock(function, block)->first; at != IR_VALUE_NONE;
+         at = IRFunction_GetInstruction(function, at)->next) {
+        uint32_t count = 0;
+        const IRMove* moves = IRRegAlloc_GetMoves(alloc, at, &count);
+        for (uint32_t i = 0; i < count; i++) {
+            if (moves[i].from.kind == IR_LOCATION_STACK || moves[i].to.kind == IR_LOCATION_STACK)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+/* Load `count` values through the pointer `first`, numbered on from `*next` */
+static void TestRegAllocLoads(TestText* text, uint32_t first, uint32_t count, uint32_t* next)
+{
+    for (uint32_t i = 0; i < count; i++)
+        TestText_Append(text, "  %%%u = load i32 %%%u\n", (*next)++, first);
+}
+
+/**
+ * `count` loaded values all live at once: every value is multiplied by the
+ * next one, the last by the first, and the products summed.
+ */
+static void TestRegAllocPressureText(TestText* text, uint32_t count)
+{
+    TestText_Append(text, "define @pressure(ptr) -> i32 {\nb1:\n  %%1 = param ptr #0\n");
+
+    uint32_t next = 2;
+    for (uint32_t i = 0; i < count; i++) {
+        TestText_Append(text, "  %%%u = ptradd ptr %%1, i64 %u\n", next, i * 4);
+        TestText_Append(text, "  %%%u = load i32 %%%u\n", next + 1, next);
+        next += 2;
+    }
+
+    uint32_t products = next;
+    for (uint32_t i = 0; i < count; i++)
+        TestText_Append(text, "  %%%u = mul i32 %%%u, %%%u\n", next++, 3 + 2 * i, 3 + 2 * ((i + 1) % count));
+
+    uint32_t sum = products;
+    for (uint32_t i = 1; i < count; i++) {
+        TestText_Append(text, "  %%%u = add i32 %%%u, %%%u\n", next, sum, products + i);
+        sum = next++;
+    }
+
+    TestText_Append(text, "  ret void %%%u\n}\n", sum);
+}
+
+/* With 8 and 32 registers, no point holds more values in registers than there are */
+static void TestRegAllocPressure(void)
+{
+    static const uint32_t s_RegisterCounts[] = { 8, 32 };
+
+    TestText text = { 0 };
+    TestRegAllocPressureText(&text, TEST_REGALLOC_PRESSURE_VALUES);
+
+    uint32_t most[2] = { 0, 0 };
+    IRRegAllocStats stats[2];
+    bool valid[2] = { false, false };
+
+    for (uint32_t i = 0; i < TEST_COUNT(s_RegisterCounts); i++) {
+        IRRegAllocConfig config = { 0 };
+        config.registerCount = s_RegisterCounts[i];
+
+        IRModule module;
+        IRFunction function;
+        IRRegAlloc alloc;
+        if (TestRegAllocCreate(&text, &config, &module, &function, &alloc)) {
+            most[i] = TestRegAllocCheckPressure(function, alloc, s_RegisterCounts[i], 0, &valid[i]);
+            IRRegAlloc_GetStats(alloc, &stats[i]);
+        }
+        TestRegAllocDestroy(module, alloc);
+    }
+
+    TestText_Free(&text);
+
+    // All 24 values fit in 32 registers, 8 make some go to the stack
+    TEST_CHECK(valid[0] && most[0] <= 8 && most[0] >= 6);
+    TEST_CHECK(stats[0].spilledValues > 0);
+    TEST_CHECK(valid[1] && most[1] <= 32 && most[1] > TEST_REGALLOC_PRESSURE_VALUES);
+    TEST_CHECK(stats[1].spilledValues == 0);
+}
+
+/**
+ * Ten values only used after a loop and three used in it, with eight
+ * registers. The ones outside go to the stack, the loop runs without
+ * touching it.
+ */
+static void TestRegAllocLoopWeights(void)
+{
+    TestText text = { 0 };
+    TestText_Append(&text, "define @weights(ptr, i32) -> i32 {\nb1:\n  %%1 = param ptr #0\n  %%2 = param i32 #1\n");
+
+    uint32_t next = 3;
+    TestRegAllocLoads(&text, 1, 10, &next);
+    uint32_t inner = next;
+    TestRegAllocLoads(&text, 1, 3, &next);
+
+    // b2: i and s, b3: s += (i * l0 + l1) ^ l2
+    TestText_Append(&text, "  br void b2\nb2:\n");
+    TestText_Append(&text, "  %%%u = phi i32 [i32 0 b1, %%%u b3]\n", next, next + 7);
+    TestText_Append(&text, "  %%%u = phi i32 [i32 0 b1, %%%u b3]\n", next + 1, next + 6);
+    TestText_Append(&text, "  %%%u = slt i1 %%%u, %%2\n  condbr void %%%u, b3, b4\nb3:\n", next + 2, next, next + 2);
+    TestText_Append(&text, "  %%%u = mul i32 %%%u, %%%u\n", next + 3, next, inner);
+    TestText_Append(&text, "  %%%u = add i32 %%%u, %%%u\n", next + 4, next + 3, inner + 1);
+    TestText_Append(&text, "  %%%u = xor i32 %%%u, %%%u\n", next + 5, next + 4, inner + 2);
+    TestText_Append(&text, "  %%%u = add i32 %%%u, %%%u\n", next + 6, next + 1, next + 5);
+    TestText_Append(&text, "  %%%u = add i32 %%%u, i32 1\n  br void b2\nb4:\n", next + 7, next);
+
+    uint32_t sum = next + 1;
+    next += 8;
+    for (uint32_t i = 0; i < 10; i++) {
+        TestText_Append(&text, "  %%%u = add i32 %%%u, %%%u\n", next, sum, 3 + i);
+        sum = next++;
+    }
+    TestText_Append(&text, "  ret void %%%u\n}\n", sum);
+
+    IRModule module;
+    IRFunction function;
+    IRRegAlloc alloc;
+    bool created = TestRegAllocCreate(&text, NULL, &module, &function, &alloc);
+    TestText_Free(&text);
+
+    bool valid = false;
+    bool loopClean = created;
+    uint32_t outsideOnStack = 0;
+    IRRegAllocStats stats = { 0 };
+
+    if (created) {
+        TestRegAllocCheckPressure(function, alloc, IR_REGALLOC_DEFAULT_REGISTERS, 0, &valid);
+        IRRegAlloc_GetStats(alloc, &stats);
+
+        // The header holds the phis, the body is its predecessor other than the entry side
+        IRValueId phi = TestRegAllocFind(function, IR_OP_PHI, 0);
+        IRBlockId header = IRFunction_GetInstruction(function, phi)->block;
+        IRValueId step = TestRegAllocFind(function, IR_OP_XOR, 0);
+        IRBlockId body = IRFunction_GetInstruction(function, step)->block;
+
+        loopClean = !TestRegAllocBlockTouchesStack(function, alloc, header) &&
+            !TestRegAllocBlockTouchesStack(function, alloc, body);
+
+        // Where the loop reads the first value loaded for it, the ten loaded before are on the stack
+        IRValueId multiply = TestRegAllocFind(function, IR_OP_MUL, 0);
+        for (uint32_t i = 0; i < 10; i++) {
+            IRLocation location;
+            IRRegAlloc_GetLocation(alloc, TestRegAllocFind(function, IR_OP_LOAD, i), multiply, &location);
+            outsideOnStack += location.kind == IR_LOCATION_STACK;
+        }
+    }
+
+    TestRegAllocDestroy(module, alloc);
+
+    TEST_CHECK(created && valid);
+    TEST_CHECK(loopClean);
+    TEST_CHECK(stats.spilledValues >= 3 && outsideOnStack == stats.spilledValues);
+}
+
+/**
+ * A value used before and after a call and a stretch that needs every
+ * register: its interval is cut, it waits on the stack or in a register the
+ * call keeps, and comes back into a register for its last use.
+ */
+static void TestRegAllocSplitting(void)
+{
+    TestText text = { 0 };
+    TestText_Append(&text, "declare @h\ndefine @split(ptr, i32) -> i32 {\nb1:\n  %%1 = param ptr #0\n"
+        "  %%2 = param i32 #1\n  %%3 = load i32 %%1\n  %%4 = add i32 %%3, %%2\n");
+    TestText_Append(&text, "  %%5 = global ptr @h\n  %%6 = call i32 %%5, [%%4]\n");
+
+    uint32_t next = 7;
+    uint32_t first = next;
+    TestRegAllocLoads(&text, 1, 10, &next);
+    uint32_t sum = first;
+    for (uint32_t i = 1; i < 10; i++) {
+        TestText_Append(&text, "  %%%u = add i32 %%%u, %%%u\n", next, sum, first + i);
+        sum = next++;
+    }
+    TestText_Append(&text, "  %%%u = add i32 %%%u, %%6\n  %%%u = mul i32 %%%u, %%3\n  ret void %%%u\n}\n", next, sum,
+        next + 1, next, next + 1);
+
+    IRRegAllocConfig config = { 0 };
+    config.callerSavedMask = IR_REGALLOC_DEFAULT_CALLER_SAVED;
+
+    IRModule module;
+    IRFunction function;
+    IRRegAlloc alloc;
+    bool created = TestRegAllocCreate(&text, &config, &module, &function, &alloc);
+    TestText_Free(&text);
+
+    bool valid = false;
+    IRRegAllocStats stats = { 0 };
+    IRLocation early = { 0 }, atCall = { 0 }, crowded = { 0 }, late = { 0 };
+
+    if (created) {
+        TestRegAllocCheckPressure(function, alloc, IR_REGALLOC_DEFAULT_REGISTERS, 0, &valid);
+        IRRegAlloc_GetStats(alloc, &stats);
+
+        IRValueId value = TestRegAllocFind(function, IR_OP_LOAD, 0);
+        IRRegAlloc_GetLocation(alloc, value, TestRegAllocFind(function, IR_OP_ADD, 0), &early);
+        IRRegAlloc_GetLocation(alloc, value, TestRegAllocFind(function, IR_OP_CALL, 0), &atCall);
+        IRRegAlloc_GetLocation(alloc, value, TestRegAllocFind(function, IR_OP_ADD, 9), &crowded);
+        IRRegAlloc_GetLocation(alloc, value, TestRegAllocFind(function, IR_OP_MUL, 0), &late);
+    }
+
+    TestRegAllocDestroy(module, alloc);
+
+    TEST_CHECK(created && valid);
+    TEST_CHECK(early.kind == IR_LOCATION_REGISTER && late.kind == IR_LOCATION_REGISTER);
+    TEST_CHECK(atCall.kind == IR_LOCATION_STACK ||
+        (atCall.kind == IR_LOCATION_REGISTER && !(TestRegAllocMask(&atCall) & IR_REGALLOC_DEFAULT_CALLER_SAVED)));
+    TEST_CHECK(crowded.kind == IR_LOCATION_STACK);
+    TEST_CHECK(stats.splits > 0);
+}
+
+/**
+ * A global address and a constant are used again after a stretch that
+ * needs every register. They are computed again where needed, never stored.
+ */
+static void TestRegAllocRematerialize(void)
+{
+    TestText text = { 0 };
+    TestText_Append(&text, "data @d 4 align 4\ndefine @remat(ptr) -> i32 {\nb1:\n  %%1 = param ptr #0\n"
+        "  %%2 = global ptr @d\n  %%3 = load i32 %%2\n  %%4 = add i32 %%3, i32 100000\n");
+
+    uint32_t next = 5;
+    uint32_t first = next;
+    TestRegAllocLoads(&text, 1, 10, &next);
+    uint32_t sum = first;
+    for (uint32_t i = 1; i < 10; i++) {
+        TestText_Append(&text, "  %%%u = add i32 %%%u, %%%u\n", next, sum, first + i);
+        sum = next++;
+    }
+    TestText_Append(&text, "  %%%u = load i32 %%2\n  %%%u = add i32 %%%u, i32 100000\n", next, next + 1, next);
+    TestText_Append(&text, "  %%%u = add i32 %%%u, %%%u\n  %%%u = add i32 %%%u, %%4\n  store void %%2, %%%u\n"
+        "  ret void %%%u\n}\n", next + 2, next + 1, sum, next + 3, next + 2, next + 3, next + 3);
+
+    IRModule module;
+    IRFunction function;
+    IRRegAlloc alloc;
+    bool created = TestRegAllocCreate(&text, NULL, &module, &function, &alloc);
+    TestText_Free(&text);
+
+    bool valid = false;
+    IRRegAllocStats stats = { 0 };
+    uint32_t recomputed = 0;
+    uint32_t stored = 0;
+
+    if (created) {
+        TestRegAllocCheckPressure(function, alloc, IR_REGALLOC_DEFAULT_REGISTERS, 0, &valid);
+        IRRegAlloc_GetStats(alloc, &stats);
+
+        IRValueId address = TestRegAllocFind(function, IR_OP_GLOBAL, 0);
+        for (IRValueId at = 1; at < IRFunction_GetInstructionCount(function); at++) {
+            uint32_t count = 0;
+            const IRMove* moves = IRRegAlloc_GetMoves(alloc, at, &count);
+            for (uint32_t i = 0; i < count; i++) {
+                const IRInstruction* moved = IRFunction_GetInstruction(function, moves[i].value);
+                bool remat = moves[i].value == address || moved->opcode == IR_OP_CONST;
+                recomputed += remat && moves[i].from.kind == IR_LOCATION_CONSTANT;
+                stored += remat && moves[i].to.kind == IR_LOCATION_STACK;
+            }
+        }
+    }
+
+    TestRegAllocDestroy(module, alloc);
+
+    TEST_CHECK(created && valid);
+    TEST_CHECK(stats.rematerialized > 0 && recomputed > 0);
+    TEST_CHECK(stored == 0);
+}
+
+/**
+ * `segments` blocks in a chain, each loads eight values, adds them into a
+ * sum carried in a phi, and branches on it.
+ */
+static void TestRegAllocLinearText(TestText* text, uint32_t segments)
+{
+    TestText_Append(text, "define @linear(ptr) -> i32 {\nb1:\n  %%1 = param ptr #0\n  br void b2\n");
+
+    uint32_t next = 2;
+    uint32_t carried = IR_VALUE_NONE;
+    for (uint32_t s = 0; s < segments; s++) {
+        uint32_t block = 2 + s;
+        TestText_Append(text, "b%u:\n", block);
+
+        uint32_t phi = next++;
+        if (carried)
+            TestText_Append(text, "  %%%u = phi i32 [%%%u b%u, %%%u b%u]\n", phi, carried, block - 1, carried,
+                block + segments - 1);
+        else
+            TestText_Append(text, "  %%%u = add i32 i32 0, i32 0\n", phi);
+
+        uint32_t first = next;
+        TestRegAllocLoads(text, 1, 8, &next);
+        uint32_t sum = phi;
+        for (uint32_t i = 0; i < 8; i++) {
+            TestText_Append(text, "  %%%u = add i32 %%%u, %%%u\n", next, sum, first + (i * 3) % 8);
+            sum = next++;
+        }
+
+        // An empty block on the other side keeps the edges from being critical
+        uint32_t condition = next++;
+        TestText_Append(text, "  %%%u = slt i1 %%%u, i32 %u\n", condition, sum, s);
+        if (s + 1 < segments)
+            TestText_Append(text, "  condbr void %%%u, b%u, b%u\n", condition, block + 1, block + segments);
+        else
+            TestText_Append(text, "  ret void %%%u\n", sum);
+        carried = sum;
+    }
+
+    for (uint32_t s = 0; s + 1 < segments; s++)
+        TestText_Append(text, "b%u:\n  br void b%u\n", 2 + segments + s, 3 + s);
+    TestText_Append(text, "}\n");
+}
+
+/* Best time of allocating a function of `segments` segments */
+static bool TestRegAllocTime(uint32_t segments, double* best, IRRegAllocStats* stats)
+{
+    TestText text = { 0 };
+    TestRegAllocLinearText(&text, segments);
+
+    bool created = true;
+    for (uint32_t run = 0; run < TEST_REGALLOC_LINEAR_RUNS && created; run++) {
+        IRModule module = NULL;
+        uint32_t errorLine = 0;
+        created = CreateIRModule(&module) == PARSER_RESULT_SUCCESS &&
+            IRModule_Parse(module, text.data, text.length, &errorLine) == PARSER_RESULT_SUCCESS;
+
+        IRRegAlloc alloc = NULL;
+        double start = TestNow();
+        created = created && CreateIRRegAlloc(IRModule_GetFunction(module, 0), NULL, &alloc) == PARSER_RESULT_SUCCESS;
+        double elapsed = TestNow() - start;
+
+        if (created)
+            IRRegAlloc_GetStats(alloc, stats);
+        TestRegAllocDestroy(module, alloc);
+
+        if (run == 0 || elapsed < *best)
+            *best = elapsed;
+    }
+
+    TestText_Free(&text);
+
+    return created;
+}
+
+/* Four times the blocks and values take about four times as long, sorting the moves adds a log, far from sixteen */
+static void TestRegAllocLinear(void)
+{
+    double small = 0.0, large = 0.0;
+    IRRegAllocStats smallStats = { 0 }, largeStats = { 0 };
+
+    bool created = TestRegAllocTime(TEST_REGALLOC_LINEAR_SEGMENTS, &small, &smallStats) &&
+        TestRegAllocTime(TEST_REGALLOC_LINEAR_SEGMENTS * 4, &large, &largeStats);
+    TEST_CHECK(created);
+
+    printf("    %u intervals in %.1f ms, %u intervals in %.1f ms\n", smallStats.intervals, small * 1e3,
+        largeStats.intervals, large * 1e3);
+
+    TEST_CHECK(largeStats.intervals >= smallStats.intervals * 4 - 4);
+    TEST_CHECK(large < small * 10.0);
+}
+
+static const TestCase s_Tests[] = {
+    { "Pressure", TestRegAllocPressure },
+    { "LoopWeights", TestRegAllocLoopWeights },
+    { "Splitting", TestRegAllocSplitting },
+    { "Rematerialize", TestRegAllocRematerialize },
+    { "Linear", TestRegAllocLinear },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteIRRegAlloc = {
+    "IRRegAlloc", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
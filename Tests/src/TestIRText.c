@@ -0,0 +1,366 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "ir/IR.h"
+#include "ir/IRBuilder.h"
+#include "ir/IRPasses.h"
+#include "ir/IRText.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_IR_SOURCE                  "CompilerTests_IRText.c"
+#define TEST_IR_BENCH_INSTRUCTIONS      100000u
+#define TEST_IR_BENCH_RUNS              3u
+
+/* Variables of the synthetic function, one per parameter */
+#define TEST_IR_VARIABLE_X              1u
+#define TEST_IR_VARIABLE_Y              2u
+
+/**
+ * A function of `instructions` linked instructions or a few more: a chain
+ * of diamonds that assign one of two variables, and loops that update one,
+ * so every join and header needs phis.
+ */
+static bool TestIRSynthesize(IRModule module, const char* name, uint32_t instructions, IRFunction* function)
+{
+    IRGlobalId global;
+    if (IRModule_DeclareGlobal(module, name, (uint32_t)strlen(name), IR_GLOBAL_KIND_FUNCTION, &global) !=
+        PARSER_RESULT_SUCCESS)
+        return false;
+
+    static const uint8_t params[] = { IR_TYPE_I32, IR_TYPE_I32 };
+    IRFunction f;
+    if (IRModule_CreateFunction(module, global, IR_TYPE_I32, params, 2, &f) != PARSER_RESULT_SUCCESS)
+        return false;
+
+    IRBuilder b;
+    if (CreateIRBuilder(f, &b) != PARSER_RESULT_SUCCESS)
+        return false;
+
+    IRValueId x, y, c, t, k;
+    ParserResult result = IRBuilder_Emit(b, IR_OP_PARAM, IR_TYPE_I32, 0, 0, 0, &x);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRBuilder_Emit(b, IR_OP_PARAM, IR_TYPE_I32, 1, 0, 0, &y);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRBuilder_WriteVariable(b, TEST_IR_VARIABLE_X, x);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRBuilder_WriteVariable(b, TEST_IR_VARIABLE_Y, y);
+
+    // Records count constants and removed phis too, so top up until enough are linked
+    IRFunctionStats stats = { 0 };
+    uint32_t limit = instructions;
+    for (uint32_t i = 0; result == PARSER_RESULT_SUCCESS && stats.instructions < instructions; i++) {
+        if (IRFunction_GetInstructionCount(f) >= limit) {
+            IRFunction_GetStats(f, &stats);
+            limit = IRFunction_GetInstructionCount(f) + instructions - stats.instructions;
+            if (stats.instructions >= instructions)
+                break;
+        }
+
+        IRBlockId first, second, join;
+        IRBuilder_ReadVariable(b, TEST_IR_VARIABLE_X, IR_TYPE_I32, &x);
+        IRBuilder_ReadVariable(b, TEST_IR_VARIABLE_Y, IR_TYPE_I32, &y);
+        IRBuilder_GetConstant(b, IR_TYPE_I32, i & 7, &k);
+        IRBuilder_AddBlock(b, &first);
+        IRBuilder_AddBlock(b, &second);
+        result = IRBuilder_AddBlock(b, &join);
+
+        if (i % 3 == 0) {
+            // while (x < y) x = (x + k) * (x + k);
+            IRBuilder_Emit(b, IR_OP_BR, IR_TYPE_VOID, first, 0, 0, NULL);
+            IRBuilder_SetBlock(b, first);
+            IRBuilder_ReadVariable(b, TEST_IR_VARIABLE_X, IR_TYPE_I32, &x);
+            IRBuilder_Emit(b, IR_OP_SLT, IR_TYPE_I1, x, y, 0, &c);
+            IRBuilder_Emit(b, IR_OP_CONDBR, IR_TYPE_VOID, c, second, join, NULL);
+            IRBuilder_SealBlock(b, second);
+            IRBuilder_SetBlock(b, second);
+            IRBuilder_ReadVariable(b, TEST_IR_VARIABLE_X, IR_TYPE_I32, &x);
+            IRBuilder_Emit(b, IR_OP_ADD, IR_TYPE_I32, x, k, 0, &t);
+            IRBuilder_Emit(b, IR_OP_MUL, IR_TYPE_I32, t, t, 0, &t);
+            IRBuilder_WriteVariable(b, TEST_IR_VARIABLE_X, t);
+            IRBuilder_Emit(b, IR_OP_BR, IR_TYPE_VOID, first, 0, 0, NULL);
+            IRBuilder_SealBlock(b, first);
+        } else {
+            // if (x == y) y = x - k; else x = y ^ k;
+            IRBuilder_Emit(b, IR_OP_EQ, IR_TYPE_I1, x, y, 0, &c);
+            IRBuilder_Emit(b, IR_OP_CONDBR, IR_TYPE_VOID, c, first, second, NULL);
+            IRBuilder_SealBlock(b, first);
+            IRBuilder_SealBlock(b, second);
+            IRBuilder_SetBlock(b, first);
+            IRBuilder_Emit(b, IR_OP_SUB, IR_TYPE_I32, x, k, 0, &t);
+            IRBuilder_WriteVariable(b, TEST_IR_VARIABLE_Y, t);
+            IRBuilder_Emit(b, IR_OP_BR, IR_TYPE_VOID, join, 0, 0, NULL);
+            IRBuilder_SetBlock(b, second);
+            IRBuilder_Emit(b, IR_OP_XOR, IR_TYPE_I32, y, k, 0, &t);
+            IRBuilder_WriteVariable(b, TEST_IR_VARIABLE_X, t);
+            IRBuilder_Emit(b, IR_OP_BR, IR_TYPE_VOID, join, 0, 0, NULL);
+        }
+
+        IRBuilder_SealBlock(b, join);
+        IRBuilder_SetBlock(b, join);
+    }
+
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRBuilder_ReadVariable(b, TEST_IR_VARIABLE_X, IR_TYPE_I32, &x);
+    if (result == PARSER_RESULT_SUCCESS)
+        result = IRBuilder_Emit(b, IR_OP_RET, IR_TYPE_VOID, x, 0, 0, NULL);
+
+    IRBuilderDestroy(b);
+    *function = f;
+
+    return result == PARSER_RESULT_SUCCESS;
+}
+
+/* Compact every function of a module */
+static bool TestIRCompact(IRModule module)
+{
+    for (uint32_t i = 0; i < IRModule_GetFunctionCount(module); i++) {
+        if (IRFunction_Compact(IRModule_GetFunction(module, i)) != PARSER_RESULT_SUCCESS)
+            return false;
+    }
+
+    return true;
+}
+
+/* Whether a module prints exactly `text` */
+static bool TestIRPrintsAs(const IRModule module, const char* text, size_t length)
+{
+    char* printed = NULL;
+    size_t printedLength = 0;
+    bool same = IRModule_Print(module, &printed, &printedLength) == PARSER_RESULT_SUCCESS &&
+        printedLength == length && memcmp(printed, text, length) == 0;
+    IRText_Free(printed);
+
+    return same;
+}
+
+/**
+ * Print a module, read the text into a new module and print that: the two
+ * texts must match. Then compact both modules, which may reorder blocks,
+ * and they must still print the same text.
+ */
+static void TestIRRoundTrip(IRModule module)
+{
+    char* text = NULL;
+    size_t length = 0;
+    TEST_CHECK(IRModule_Print(module, &text, &length) == PARSER_RESULT_SUCCESS);
+
+    IRModule parsed = NULL;
+    uint32_t errorLine = 0;
+    bool read = CreateIRModule(&parsed) == PARSER_RESULT_SUCCESS &&
+        IRModule_Parse(parsed, text, length, &errorLine) == PARSER_RESULT_SUCCESS;
+    bool same = read && TestIRPrintsAs(parsed, text, length);
+    IRText_Free(text);
+    text = NULL;
+
+    bool sameCompact = read && TestIRCompact(module) && TestIRCompact(parsed) &&
+        IRModule_Print(module, &text, &length) == PARSER_RESULT_SUCCESS && TestIRPrintsAs(parsed, text, length);
+
+    IRText_Free(text);
+    IRModuleDestroy(parsed);
+
+    if (!read)
+        fprintf(stderr, "    text could not be read back, error on line %u\n", errorLine);
+
+    TEST_CHECK(read);
+    TEST_CHECK(same);
+    TEST_CHECK(sameCompact);
+}
+
+/* Module lowered from a generated C file */
+static bool TestIRLower(IRModule module, uint32_t functions, uint32_t seed)
+{
+    TestText text = { 0 };
+    TestGenerateC(&text, functions, seed);
+    bool written = TestWriteFile(TEST_IR_SOURCE, text.data, text.length);
+    TestText_Free(&text);
+    if (!written)
+        return false;
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+    config.module = module;
+
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_IR_SOURCE, &config, 0) && unit.result == PARSER_RESULT_SUCCESS;
+    TestUnit_Destroy(&unit);
+    remove(TEST_IR_SOURCE);
+
+    return parsed && IRModule_GetFunctionCount(module) > 0;
+}
+
+/* Functions lowered from C, data and declarations included, as lowered and after every pass */
+static void TestIRLowered(void)
+{
+    IRModule module;
+    TEST_CHECK(CreateIRModule(&module) == PARSER_RESULT_SUCCESS);
+
+    bool lowered = TestIRLower(module, 300, 4);
+    if (lowered)
+        TestIRRoundTrip(module);
+
+    // The passes bring in folded branches, jump tables and high multiplies
+    bool optimized = lowered;
+    for (uint32_t i = 0; optimized && i < IRModule_GetFunctionCount(module); i++) {
+        IRFunction function = IRModule_GetFunction(module, i);
+        optimized = IRFunction_PropagateConstants(function, NULL) == PARSER_RESULT_SUCCESS &&
+            IRFunction_NumberValues(function, NULL) == PARSER_RESULT_SUCCESS &&
+            IRFunction_OptimizeLoops(function, NULL) == PARSER_RESULT_SUCCESS &&
+            IRFunction_LowerDivisions(function, NULL) == PARSER_RESULT_SUCCESS &&
+            IRFunction_LowerSwitches(function, NULL, NULL) == PARSER_RESULT_SUCCESS &&
+            IRFunction_EliminateDeadCode(function, NULL) == PARSER_RESULT_SUCCESS;
+    }
+
+    if (optimized)
+        TestIRRoundTrip(module);
+
+    IRModuleDestroy(module);
+
+    TEST_CHECK(lowered);
+    TEST_CHECK(optimized);
+}
+
+/* Nested loops and joins whose phis name values defined further down */
+static void TestIRSynthetic(void)
+{
+    IRModule module;
+    TEST_CHECK(CreateIRModule(&module) == PARSER_RESULT_SUCCESS);
+
+    IRFunction function;
+    bool built = TestIRSynthesize(module, "synthetic", 5000, &function);
+    if (built)
+        TestIRRoundTrip(module);
+
+    IRModuleDestroy(module);
+
+    TEST_CHECK(built);
+}
+
+/* Malformed texts fail with the documented result, on the line of the mistake */
+static void TestIRErrors(void)
+{
+    static const struct {
+        const char* text;
+        ParserResult result;
+        uint32_t line;
+    } s_Cases[] = {
+        { "define @f(i32) -> i32 {\nb1:\n  %1 = param i32 #0\n  %2 = frob i32 %1, i32 -1\n  ret void %2\n}\n",
+            PARSER_ERROR_UNKNOWN_IDENTIFIER, 4 },
+        { "define @f(i32) -> i32 {\nb1:\n  %1 = param i32 #0\n  ret void %9\n}\n",
+            PARSER_ERROR_UNKNOWN_IDENTIFIER, 5 },
+        { "define @f() -> i32 {\nb1:\n  br void b7\n}\n",
+            PARSER_ERROR_UNKNOWN_IDENTIFIER, 3 },
+        { "define @f(i32) -> i32 {\nb1:\n  %1 = param i32 #0\n  %2 = add i32 %1 i32 -1\n  ret void %2\n}\n",
+            PARSER_ERROR_SYNTAX_ERROR, 4 },
+        { "declare @f\ndata @d 4 align 4 x\"0102\"\n",
+            PARSER_ERROR_SYNTAX_ERROR, 2 },
+        { "define @f() -> i32 {\nb1:\n  ret void i32 0\n}\ndefine @f() -> i32 {\nb1:\n  ret void i32 0\n}\n",
+            PARSER_ERROR_REDECLARATION, 5 },
+        { "define @f() -> i32 {\nb1:\n  ret void i32 0\n",
+            PARSER_ERROR_UNCLOSED_BRACE, 4 },
+    };
+
+    for (uint32_t i = 0; i < TEST_COUNT(s_Cases); i++) {
+        IRModule module;
+        TEST_CHECK(CreateIRModule(&module) == PARSER_RESULT_SUCCESS);
+
+        uint32_t line = 0;
+        ParserResult result = IRModule_Parse(module, s_Cases[i].text, strlen(s_Cases[i].text), &line);
+        IRModuleDestroy(module);
+
+        if (result != s_Cases[i].result || line != s_Cases[i].line)
+            fprintf(stderr, "    case %u: result 0x%X on line %u\n", i, (unsigned)result, line);
+        TEST_CHECK(result == s_Cases[i].result && line == s_Cases[i].line);
+    }
+}
+
+/* Print, parse and print again a function of 100000 instructions */
+static void TestIRBenchRoundTrip(void)
+{
+    IRModule module;
+    TEST_CHECK(CreateIRModule(&module) == PARSER_RESULT_SUCCESS);
+
+    IRFunction function;
+    double start = TestNow();
+    bool built = TestIRSynthesize(module, "big", TEST_IR_BENCH_INSTRUCTIONS, &function) &&
+        IRFunction_Compact(function) == PARSER_RESULT_SUCCESS;
+    double buildTime = TestNow() - start;
+    if (!built) {
+        IRModuleDestroy(module);
+        TEST_CHECK(built);
+    }
+
+    double printTime = 0.0;
+    double parseTime = 0.0;
+    char* text = NULL;
+    size_t length = 0;
+    bool same = true;
+
+    for (uint32_t run = 0; run < TEST_IR_BENCH_RUNS && same; run++) {
+        IRText_Free(text);
+        text = NULL;
+
+        start = TestNow();
+        same = IRModule_Print(module, &text, &length) == PARSER_RESULT_SUCCESS;
+        double printed = TestNow() - start;
+
+        IRModule parsed = NULL;
+        same = same && CreateIRModule(&parsed) == PARSER_RESULT_SUCCESS;
+
+        start = TestNow();
+        same = same && IRModule_Parse(parsed, text, length, NULL) == PARSER_RESULT_SUCCESS;
+        double read = TestNow() - start;
+
+        char* again = NULL;
+        size_t againLength = 0;
+        same = same && IRModule_Print(parsed, &again, &againLength) == PARSER_RESULT_SUCCESS &&
+            againLength == length && memcmp(again, text, length) == 0;
+        IRText_Free(again);
+        IRModuleDestroy(parsed);
+
+        if (run == 0 || printed < printTime)
+            printTime = printed;
+        if (run == 0 || read < parseTime)
+            parseTime = read;
+    }
+
+    IRFunctionStats stats;
+    IRFunction_GetStats(function, &stats);
+    IRText_Free(text);
+    IRModuleDestroy(module);
+
+    printf("    %u instructions in %u blocks, %zu bytes of text, built and compacted in %.1f ms\n",
+        stats.instructions, stats.blocks, length, buildTime * 1e3);
+    printf("    print %.1f ms (%.0f MB/s), parse %.1f ms (%.0f MB/s)\n", printTime * 1e3,
+        (double)length / 1e6 / printTime, parseTime * 1e3, (double)length / 1e6 / parseTime);
+
+    TEST_CHECK(same);
+}
+
+static const TestCase s_Tests[] = {
+    { "Lowered", TestIRLowered },
+    { "Synthetic", TestIRSynthetic },
+    { "Errors", TestIRErrors },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchRoundTrip", TestIRBenchRoundTrip },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteIRText = {
+    "IRText", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
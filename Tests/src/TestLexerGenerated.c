@@ -0,0 +1,247 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/lexer/LexerInternal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_GENERATED_SOURCE           "CompilerTests_LexerGenerated.c"
+#define TEST_GENERATED_BENCH_FUNCTIONS  100000u
+#define TEST_GENERATED_BENCH_RUNS       3u
+
+/* What a strategy made of a file, the lexer is kept for its error state */
+typedef struct TestLexerRun_T {
+    Lexer lexer;
+    LexerTokenArray tokens;
+    ParserResult result;
+} TestLexerRun;
+
+/* Lex a file with a strategy, false when the lexer could not be created */
+static bool TestLexerRunFile(FileBuffer file, const LexerLanguageStrategy* strategy, bool preserve, TestLexerRun* run)
+{
+    memset(run, 0, sizeof(TestLexerRun));
+
+    LexerCreateConfig config = { strategy, 0 };
+    if (CreateLexer(file, &config, &run->lexer) != PARSER_RESULT_SUCCESS) {
+        run->lexer = NULL;
+        return false;
+    }
+
+    Lexer_SetPreserveWhitespace(run->lexer, preserve);
+    Lexer_SetPreserveComments(run->lexer, preserve);
+    run->result = LexerTokenize(run->lexer, &run->tokens);
+
+    return true;
+}
+
+static void TestLexerRunDestroy(TestLexerRun* run)
+{
+    LexerTokenArray_Destroy(run->tokens);
+    if (run->lexer)
+        LexerDestroy(run->lexer);
+
+    memset(run, 0, sizeof(TestLexerRun));
+}
+
+/* Same result, and on success the same tokens, trivia and literal bytes; on failure the same error */
+static void TestLexerRunCompare(const TestLexerRun* expected, const TestLexerRun* run)
+{
+    TEST_CHECK(run->result == expected->result);
+
+    if (expected->result != PARSER_RESULT_SUCCESS) {
+        TEST_CHECK(run->lexer->errorLine == expected->lexer->errorLine);
+        TEST_CHECK(run->lexer->errorColumn == expected->lexer->errorColumn);
+        return;
+    }
+
+    const struct LexerTokenArray_T* a = expected->tokens;
+    const struct LexerTokenArray_T* b = run->tokens;
+    TEST_CHECK(a->count == b->count);
+
+    for (uint32_t i = 0; i < a->count; i++) {
+        const struct LexerToken_T* x = &a->tokens[i];
+        const struct LexerToken_T* y = &b->tokens[i];
+        TEST_CHECK(x->lexeme == y->lexeme && x->length == y->length);
+        TEST_CHECK(x->flags == y->flags && x->kind == y->kind && x->value == y->value);
+        TEST_CHECK(x->line == y->line && x->column == y->column);
+    }
+
+    // Whole records, literals are written to images as they are
+    TEST_CHECK(a->literals.count == b->literals.count);
+    TEST_CHECK(!a->literals.count ||
+        memcmp(a->literals.items, b->literals.items, sizeof(LexerLiteral) * a->literals.count) == 0);
+
+    TEST_CHECK(a->trivia.count == b->trivia.count);
+    TEST_CHECK(!a->trivia.count || memcmp(a->trivia.items, b->trivia.items, sizeof(LexerTrivia) * a->trivia.count) == 0);
+}
+
+/* Lex a text with both C strategies, with and without trivia, and compare */
+static void TestLexerStrategiesMatch(const char* text, size_t length, ParserResult* result)
+{
+    TEST_CHECK(TestWriteFile(TEST_GENERATED_SOURCE, text, length));
+
+    FileBufferConfig fileConfig = { 0 };
+    fileConfig.fileName = TEST_GENERATED_SOURCE;
+    fileConfig.filePath = TEST_GENERATED_SOURCE;
+    FileBuffer file;
+    TEST_CHECK(CreateFileBuffer(&fileConfig, &file) == PARSER_RESULT_SUCCESS);
+
+    for (uint32_t preserve = 0; preserve < 2; preserve++) {
+        TestLexerRun expected;
+        TestLexerRun run;
+        bool created = TestLexerRunFile(file, &g_CLexerLanguageStrategy, preserve != 0, &expected) &&
+            TestLexerRunFile(file, &g_CLexerGeneratedStrategy, preserve != 0, &run);
+
+        if (!created)
+            TestFail(__FILE__, __LINE__, "created");
+        else
+            TestLexerRunCompare(&expected, &run);
+
+        if (result)
+            *result = expected.result;
+
+        TestLexerRunDestroy(&expected);
+        TestLexerRunDestroy(&run);
+    }
+
+    DestroyFileBuffer(file);
+    remove(TEST_GENERATED_SOURCE);
+}
+
+/* Numbers of every base and suffix, escapes, continued lines and every operator */
+static void TestGeneratedEdges(void)
+{
+    static const char* const sources[] = {
+        "0 07 0x1F 0X1fu 0b101 42u 42UL 42llu 18446744073709551615u 1. .5 1.5e10 1.5E-3f 0x1.8p3 1e+9L 3.f",
+        "\"\" \"a\\\"b\" \"\\\\\" 'x' '\\'' '\\n' L\"w\" u8\"s\" u'c' U\"c\" \"line\\\ncontinued\"",
+        "a+++b a->b a-->b <<= >>= ... .. . ## # %:%: <: :> <% %> && || != == ^= |= &= ~ ? : ; ,",
+        "int x; // comment \\\ncontinued\n/* block\n * comment */ y /**/ z /*/ still comment */ w",
+        "\t\r\n  \f\v x\\\n  y _id id_2 $ \xC3\xA9",
+        "x",
+    };
+
+    for (uint32_t i = 0; i < TEST_COUNT(sources); i++)
+        TestLexerStrategiesMatch(sources[i], strlen(sources[i]), NULL);
+}
+
+/* Both strategies fail the same way and at the same place */
+static void TestGeneratedErrors(void)
+{
+    static const char* const sources[] = {
+        "int a = 1;\n/* never closed",
+        "x = \"never closed\nnext",
+        "c = 'ab",
+        "n = 0x;",
+        "n = 1e+;",
+        "n = 99999999999999999999999;",
+        "n = 1.5q;",
+        "n = 0b102;",
+    };
+
+    for (uint32_t i = 0; i < TEST_COUNT(sources); i++) {
+        ParserResult result = PARSER_RESULT_SUCCESS;
+        TestLexerStrategiesMatch(sources[i], strlen(sources[i]), &result);
+        TEST_CHECK(result != PARSER_RESULT_SUCCESS);
+    }
+}
+
+/* A generated C file that reaches most of the language */
+static void TestGeneratedSource(void)
+{
+    TestText text = { 0 };
+    TestGenerateC(&text, 3000, 5);
+    ParserResult result = PARSER_RESULT_SUCCESS;
+    TestLexerStrategiesMatch(text.data, text.length, &result);
+    TestText_Free(&text);
+
+    TEST_CHECK(result == PARSER_RESULT_SUCCESS);
+}
+
+/* Best time in milliseconds of lexing a file with a strategy */
+static double TestGeneratedTime(FileBuffer file, const LexerLanguageStrategy* strategy, bool preserve, uint32_t* count)
+{
+    double best = 0.0;
+
+    for (uint32_t i = 0; i < TEST_GENERATED_BENCH_RUNS; i++) {
+        TestLexerRun run;
+        double start = TestNow();
+        bool created = TestLexerRunFile(file, strategy, preserve, &run);
+        double elapsed = (TestNow() - start) * 1000.0;
+
+        *count = created && run.result == PARSER_RESULT_SUCCESS ? run.tokens->count : 0;
+        TestLexerRunDestroy(&run);
+
+        if (i == 0 || elapsed < best)
+            best = elapsed;
+    }
+
+    return best;
+}
+
+/* Throughput of the generated scanner against the callback scanner */
+static void TestGeneratedBenchCompare(void)
+{
+    TestText text = { 0 };
+    TestGenerateC(&text, TEST_GENERATED_BENCH_FUNCTIONS, 9);
+    bool written = TestWriteFile(TEST_GENERATED_SOURCE, text.data, text.length);
+    double megabytes = (double)text.length / 1e6;
+    TestText_Free(&text);
+    TEST_CHECK(written);
+
+    FileBufferConfig fileConfig = { 0 };
+    fileConfig.fileName = TEST_GENERATED_SOURCE;
+    fileConfig.filePath = TEST_GENERATED_SOURCE;
+    FileBuffer file;
+    if (CreateFileBuffer(&fileConfig, &file) != PARSER_RESULT_SUCCESS) {
+        TestFail(__FILE__, __LINE__, "CreateFileBuffer(&fileConfig, &file) == PARSER_RESULT_SUCCESS");
+        remove(TEST_GENERATED_SOURCE);
+        return;
+    }
+
+    bool same = true;
+    for (uint32_t preserve = 0; preserve < 2; preserve++) {
+        uint32_t callbackCount = 0;
+        uint32_t generatedCount = 0;
+        double callback = TestGeneratedTime(file, &g_CLexerLanguageStrategy, preserve != 0, &callbackCount);
+        double generated = TestGeneratedTime(file, &g_CLexerGeneratedStrategy, preserve != 0, &generatedCount);
+
+        printf("    %.1f MB, %u tokens, trivia %s: callbacks %.1f ms (%.0f MB/s), generated %.1f ms (%.0f MB/s), %.2fx\n",
+            megabytes, callbackCount, preserve ? "kept" : "skipped", callback, megabytes * 1e3 / callback,
+            generated, megabytes * 1e3 / generated, callback / generated);
+
+        same = same && callbackCount > 0 && callbackCount == generatedCount;
+    }
+
+    DestroyFileBuffer(file);
+    remove(TEST_GENERATED_SOURCE);
+
+    TEST_CHECK(same);
+}
+
+static const TestCase s_Tests[] = {
+    { "Edges", TestGeneratedEdges },
+    { "Errors", TestGeneratedErrors },
+    { "Source", TestGeneratedSource },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchCompare", TestGeneratedBenchCompare },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteLexerGenerated = {
+    "LexerGenerated", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,357 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/lexer/LexerInternal.h"
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_NUMBER_SOURCE              "CompilerTests_LexerNumber.c"
+#define TEST_NUMBER_RANDOM_COUNT        50000u
+
+/* An integer constant and what it converts to, result is the expected ParserResult */
+typedef struct TestInteger_T {
+    const char* text;
+    ParserResult result;
+    uint64_t value;
+    uint16_t base;
+    uint16_t suffix;
+} TestInteger;
+
+static const TestInteger s_Integers[] = {
+    { "0", PARSER_RESULT_SUCCESS, 0, 10, LITERAL_SUFFIX_NONE },
+    { "7", PARSER_RESULT_SUCCESS, 7, 10, LITERAL_SUFFIX_NONE },
+    { "12345678", PARSER_RESULT_SUCCESS, 12345678u, 10, LITERAL_SUFFIX_NONE },
+    { "123456789", PARSER_RESULT_SUCCESS, 123456789u, 10, LITERAL_SUFFIX_NONE },
+    { "1234567890123456", PARSER_RESULT_SUCCESS, 1234567890123456ull, 10, LITERAL_SUFFIX_NONE },
+    { "18446744073709551615", PARSER_RESULT_SUCCESS, UINT64_MAX, 10, LITERAL_SUFFIX_NONE },
+    { "18446744073709551616", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 10, LITERAL_SUFFIX_NONE },
+    { "99999999999999999999", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 10, LITERAL_SUFFIX_NONE },
+    { "100000000000000000000000", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 10, LITERAL_SUFFIX_NONE },
+    { "0777", PARSER_RESULT_SUCCESS, 0777, 8, LITERAL_SUFFIX_NONE },
+    { "01777777777777777777777", PARSER_RESULT_SUCCESS, UINT64_MAX, 8, LITERAL_SUFFIX_NONE },
+    { "02000000000000000000000", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 8, LITERAL_SUFFIX_NONE },
+    { "08", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 8, LITERAL_SUFFIX_NONE },
+    { "0xFFFFFFFFFFFFFFFF", PARSER_RESULT_SUCCESS, UINT64_MAX, 16, LITERAL_SUFFIX_NONE },
+    { "0x00000000000000000001", PARSER_RESULT_SUCCESS, 1, 16, LITERAL_SUFFIX_NONE },
+    { "0x10000000000000000", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 16, LITERAL_SUFFIX_NONE },
+    { "0x", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 16, LITERAL_SUFFIX_NONE },
+    { "0b1011", PARSER_RESULT_SUCCESS, 11, 2, LITERAL_SUFFIX_NONE },
+    { "0b2", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 2, LITERAL_SUFFIX_NONE },
+    { "10u", PARSER_RESULT_SUCCESS, 10, 10, LITERAL_SUFFIX_UNSIGNED },
+    { "10ULL", PARSER_RESULT_SUCCESS, 10, 10, LITERAL_SUFFIX_UNSIGNED | LITERAL_SUFFIX_LONG_LONG },
+    { "10llu", PARSER_RESULT_SUCCESS, 10, 10, LITERAL_SUFFIX_UNSIGNED | LITERAL_SUFFIX_LONG_LONG },
+    { "0x7fL", PARSER_RESULT_SUCCESS, 0x7f, 16, LITERAL_SUFFIX_LONG },
+    { "10lL", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 10, LITERAL_SUFFIX_NONE },
+    { "10uu", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 10, LITERAL_SUFFIX_NONE },
+    { "10f", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0, 10, LITERAL_SUFFIX_NONE },
+};
+
+/* Decimal floats at the edges of the fast path, every one must match the C library */
+static const char* const s_DecimalFloats[] = {
+    "1.5", "0.1", "1e23", "1.", ".5", "0.0", "100e-2",
+    // Denormals and the smallest normal
+    "4.9e-324", "5e-324", "2.4703282292062328e-324", "2.2250738585072011e-308", "2.2250738585072014e-308",
+    "1e-320", "1e-400",
+    // The largest double and overflow to infinity
+    "1.7976931348623157e308", "1.7976931348623159e308", "1e400",
+    // More than 19 significant digits, the mantissa is truncated
+    "3.14159265358979323846264338327950288",
+    "9007199254740993.0000000000001",
+    "9007199254740992.9999999999999",
+    "123456789012345678901234567890e-10",
+    "0.000000000000000000000000000000000000000000000001234567890123456789012",
+    "2.22507385850720113605740979670913197593481954635164564e-308",
+    "1.00000000000000011102230246251565404236316680908203125",
+    "1.00000000000000011102230246251565404236316680908203124",
+    // Single precision, rounded as floats
+    "1.5f", "0.1f", "16777217.0f", "3.4028235e38f", "3.4028236e38f", "1.17549435e-38f", "1.4e-45f", "7e-46f",
+    "3.14159265358979323846264338327950288f",
+};
+
+/* A hexadecimal float and the value it must have */
+typedef struct TestHexFloat_T {
+    const char* text;
+    ParserResult result;
+    double value;
+} TestHexFloat;
+
+static const TestHexFloat s_HexFloats[] = {
+    { "0x1.8p1", PARSER_RESULT_SUCCESS, 3.0 },
+    { "0x.8p0", PARSER_RESULT_SUCCESS, 0.5 },
+    { "0X1P-2", PARSER_RESULT_SUCCESS, 0.25 },
+    { "0x1p+4f", PARSER_RESULT_SUCCESS, 16.0 },
+    { "0x1p-1074", PARSER_RESULT_SUCCESS, 4.9406564584124654e-324 },
+    { "0x1.fffffffffffffp1023", PARSER_RESULT_SUCCESS, DBL_MAX },
+    { "0x1p-149f", PARSER_RESULT_SUCCESS, 1.4012984643248171e-45 },
+    { "0x1.8", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0.0 },
+    { "0x.p1", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0.0 },
+    { "0x1p", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0.0 },
+    { "0x1p1u", PARSER_ERROR_INVALID_NUMBER_FORMAT, 0.0 },
+};
+
+/* Convert with the C library, float constants are rounded once, as floats */
+static double TestNumberLibrary(const char* text)
+{
+    size_t length = strlen(text);
+    if (length && (text[length - 1] == 'f' || text[length - 1] == 'F') && !strchr(text, 'x'))
+        return (double)strtof(text, NULL);
+
+    return strtod(text, NULL);
+}
+
+/* Same bits, so signed zeros, denormals and infinities compare exactly */
+static bool TestNumberSameDouble(double a, double b)
+{
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+/* Print a mismatch, the table index alone does not say much */
+static bool TestNumberReport(const char* text, double value, double expected)
+{
+    bool same = TestNumberSameDouble(value, expected);
+    if (!same)
+        printf("    %s: %.17g, expected %.17g\n", text, value, expected);
+
+    return same;
+}
+
+static void TestNumberIntegers(void)
+{
+    for (uint32_t i = 0; i < TEST_COUNT(s_Integers); i++) {
+        const TestInteger* expected = &s_Integers[i];
+
+        LexerLiteral literal;
+        ParserResult result = LexerCParseNumber(expected->text, strlen(expected->text), &literal);
+        if (result != expected->result)
+            printf("    %s: result %d, expected %d\n", expected->text, (int)result, (int)expected->result);
+
+        TEST_CHECK(result == expected->result);
+        if (result != PARSER_RESULT_SUCCESS)
+            continue;
+
+        TEST_CHECK(literal.type == LITERAL_TYPE_INTEGER);
+        TEST_CHECK(literal.value.integer == expected->value);
+        TEST_CHECK(literal.base == expected->base);
+        TEST_CHECK(literal.suffix == expected->suffix);
+    }
+}
+
+/* Every length up to 20 digits, split between the eight digit SWAR loop and the digit tail */
+static void TestNumberDigitRuns(void)
+{
+    char text[24];
+    uint64_t value = 0;
+
+    for (uint32_t digits = 1; digits <= 20; digits++) {
+        text[digits - 1] = (char)('0' + digits % 10);
+        text[digits] = 0;
+        value = value * 10 + digits % 10;
+
+        LexerLiteral literal;
+        ParserResult result = LexerCParseNumber(text, digits, &literal);
+        TEST_CHECK(result == PARSER_RESULT_SUCCESS);
+        TEST_CHECK(literal.value.integer == value);
+    }
+
+    // 20 digits of 9 are above UINT64_MAX whichever way the digits are grouped
+    TEST_CHECK(LexerCParseNumber("99999999999999999999", 20, &(LexerLiteral){ 0 }) ==
+        PARSER_ERROR_INVALID_NUMBER_FORMAT);
+}
+
+static void TestNumberDecimalFloats(void)
+{
+    bool same = true;
+
+    for (uint32_t i = 0; i < TEST_COUNT(s_DecimalFloats); i++) {
+        const char* text = s_DecimalFloats[i];
+
+        LexerLiteral literal;
+        ParserResult result = LexerCParseNumber(text, strlen(text), &literal);
+        TEST_CHECK(result == PARSER_RESULT_SUCCESS);
+        TEST_CHECK(literal.type == LITERAL_TYPE_FLOAT);
+
+        same &= TestNumberReport(text, literal.value.floating, TestNumberLibrary(text));
+    }
+
+    TEST_CHECK(same);
+
+    // Halfway between two doubles, only the digits past the 19th say which way to round
+    LexerLiteral literal;
+    TEST_CHECK(LexerCParseNumber("9007199254740993.0000000000001", 30, &literal) == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(literal.value.floating == 9007199254740994.0);
+    TEST_CHECK(LexerCParseNumber("9007199254740993", 16, &literal) == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(literal.type == LITERAL_TYPE_INTEGER);
+    TEST_CHECK(LexerCParseNumber("9007199254740993.0", 18, &literal) == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(literal.value.floating == 9007199254740992.0);
+}
+
+/* Random significands of up to 25 digits over the whole exponent range */
+static void TestNumberRandomFloats(void)
+{
+    uint32_t state = 29;
+    uint32_t mismatches = 0;
+
+    for (uint32_t i = 0; i < TEST_NUMBER_RANDOM_COUNT; i++) {
+        char text[64];
+        uint32_t length = 0;
+
+        uint32_t digits = 1 + TestRandom(&state) % 25;
+        uint32_t point = TestRandom(&state) % (digits + 1);
+        for (uint32_t d = 0; d < digits; d++) {
+            if (d == point)
+                text[length++] = '.';
+            text[length++] = (char)('0' + TestRandom(&state) % 10);
+        }
+
+        int exponent = (int)(TestRandom(&state) % 660) - 340;
+        bool single = (i & 7) == 0;
+        length += (uint32_t)snprintf(text + length, sizeof(text) - length, "e%d%s", single ? exponent / 8 : exponent,
+            single ? "f" : "");
+
+        LexerLiteral literal;
+        ParserResult result = LexerCParseNumber(text, length, &literal);
+        if (result != PARSER_RESULT_SUCCESS ||
+            !TestNumberReport(text, literal.value.floating, TestNumberLibrary(text))) {
+            mismatches++;
+        }
+    }
+
+    TEST_CHECK(mismatches == 0);
+}
+
+static void TestNumberHexFloats(void)
+{
+    for (uint32_t i = 0; i < TEST_COUNT(s_HexFloats); i++) {
+        const TestHexFloat* expected = &s_HexFloats[i];
+
+        LexerLiteral literal;
+        ParserResult result = LexerCParseNumber(expected->text, strlen(expected->text), &literal);
+        TEST_CHECK(result == expected->result);
+        if (result != PARSER_RESULT_SUCCESS)
+            continue;
+
+        TEST_CHECK(literal.type == LITERAL_TYPE_FLOAT && literal.base == 16);
+        TEST_CHECK(TestNumberReport(expected->text, literal.value.floating, expected->value));
+    }
+}
+
+/* The scanner stores the values in the literal table and stops at an integer that overflows */
+static void TestNumberTokens(void)
+{
+    TestSource source;
+    TEST_CHECK(TestSource_Open(&source, TEST_NUMBER_SOURCE,
+        "x = 18446744073709551615u + 0x1.8p1 * 4.9e-324 - 3.14159265358979323846264338327950288f;\n", NULL));
+
+    LexerTokenArray tokens = NULL;
+    ParserResult result = LexerTokenize(source.lexer, &tokens);
+
+    static const double floats[] = { 3.0, 4.9406564584124654e-324, (double)3.14159265f };
+    uint32_t integers = 0;
+    uint32_t floating = 0;
+    bool values = true;
+
+    for (uint32_t i = 0; i < LexerTokenArray_GetCount(tokens); i++) {
+        const LexerLiteral* literal = LexerTokenArray_GetLiteral(tokens, i);
+        if (!literal)
+            continue;
+
+        if (literal->type == LITERAL_TYPE_INTEGER) {
+            values &= literal->value.integer == UINT64_MAX && literal->suffix == LITERAL_SUFFIX_UNSIGNED;
+            integers++;
+        }
+        else {
+            values &= floating < TEST_COUNT(floats) && TestNumberSameDouble(literal->value.floating, floats[floating]);
+            floating++;
+        }
+    }
+
+    LexerTokenArray_Destroy(tokens);
+    TestSource_Close(&source);
+
+    TEST_CHECK(result == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(values && integers == 1 && floating == 3);
+
+    TEST_CHECK(TestSource_Open(&source, TEST_NUMBER_SOURCE, "x = 1 + 18446744073709551616;\n", NULL));
+    tokens = NULL;
+    result = LexerTokenize(source.lexer, &tokens);
+    LexerTokenArray_Destroy(tokens);
+
+    bool reported = source.lexer->hasError && source.lexer->errorResult == PARSER_ERROR_INVALID_NUMBER_FORMAT;
+    TestSource_Close(&source);
+
+    TEST_CHECK(result == PARSER_ERROR_INVALID_NUMBER_FORMAT);
+    TEST_CHECK(reported);
+}
+
+/* Conversion rate of random decimal floats against strtod */
+static void TestNumberBenchFloats(void)
+{
+    enum { count = 200000 };
+    static char texts[count][32];
+    uint32_t state = 31;
+
+    for (uint32_t i = 0; i < count; i++) {
+        snprintf(texts[i], sizeof(texts[i]), "%u.%ue%d", TestRandom(&state) % 100000, TestRandom(&state),
+            (int)(TestRandom(&state) % 80) - 40);
+    }
+
+    double lexer = 0.0, library = 0.0;
+    double sum = 0.0;
+
+    for (uint32_t run = 0; run < 3; run++) {
+        double start = TestNow();
+        for (uint32_t i = 0; i < count; i++) {
+            LexerLiteral literal;
+            LexerCParseNumber(texts[i], strlen(texts[i]), &literal);
+            sum += literal.value.floating;
+        }
+        double elapsed = TestNow() - start;
+        if (run == 0 || elapsed < lexer)
+            lexer = elapsed;
+
+        start = TestNow();
+        for (uint32_t i = 0; i < count; i++)
+            sum -= strtod(texts[i], NULL);
+        elapsed = TestNow() - start;
+        if (run == 0 || elapsed < library)
+            library = elapsed;
+    }
+
+    TEST_CHECK(sum == sum);
+
+    printf("    %u floats, LexerCParseNumber: %.1f ms, strtod: %.1f ms\n", (uint32_t)count, lexer * 1000.0,
+        library * 1000.0);
+}
+
+static const TestCase s_Tests[] = {
+    { "Integers", TestNumberIntegers },
+    { "DigitRuns", TestNumberDigitRuns },
+    { "DecimalFloats", TestNumberDecimalFloats },
+    { "RandomFloats", TestNumberRandomFloats },
+    { "HexFloats", TestNumberHexFloats },
+    { "Tokens", TestNumberTokens },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchFloats", TestNumberBenchFloats },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteLexerNumber = {
+    "LexerNumber", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
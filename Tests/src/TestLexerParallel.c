@@ -0,0 +1,349 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/lexer/LexerInternal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_LEXER_SOURCE               "CompilerTests_LexerParallel.c"
+#define TEST_LEXER_BENCH_LINES          2000000
+#define TEST_LEXER_BENCH_RUNS           3
+
+/* Source whose comments, strings and continued lines run over chunk boundaries */
+static void TestLexerGenerate(TestText* text, uint32_t lines, uint32_t seed)
+{
+    uint32_t state = seed;
+
+    for (uint32_t i = 0; i < lines; i++) {
+        switch (TestRandom(&state) % 7) {
+        case 0:
+            TestText_Append(text, "int x%u = 0x%X + %u.5e+3; // line comment \\\ncontinued\n", i, i, i);
+            break;
+        case 1:
+            TestText_Append(text, "/* multi\nline\ncomment %u */ y = \"str\\\"ing\\\nnext\" ;\n", i);
+            break;
+        case 2:
+            TestText_Append(text, "\tif (a->b <<= 3 && c != 'x') { return L\"w\"; }\n");
+            break;
+        case 3:
+            TestText_Append(text, "/*\n\n\n\n\n\n\n*/\n");
+            break;
+        default:
+            TestText_Append(text, "  foo(bar[%u], ...);\n", i);
+            break;
+        }
+    }
+}
+
+/* Tokens of a file from the serial lexer */
+static ParserResult TestLexerSerial(FileBuffer file, bool preserve, LexerTokenArray* tokens)
+{
+    LexerCreateConfig config = { &g_CLexerLanguageStrategy, 0 };
+    Lexer lexer;
+    CHECK_PARSER_RESULT(CreateLexer(file, &config, &lexer));
+
+    Lexer_SetPreserveWhitespace(lexer, preserve);
+    Lexer_SetPreserveComments(lexer, preserve);
+
+    ParserResult result = LexerTokenize(lexer, tokens);
+    LexerDestroy(lexer);
+
+    return result;
+}
+
+/* Check that two token arrays hold the same tokens, literal values and trivia */
+static void TestLexerCompare(const LexerTokenArray expected, const LexerTokenArray tokens)
+{
+    uint32_t count = LexerTokenArray_GetCount(expected);
+    TEST_CHECK(LexerTokenArray_GetCount(tokens) == count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        LexerToken a = LexerTokenArray_GetToken(expected, i);
+        LexerToken b = LexerTokenArray_GetToken(tokens, i);
+        TEST_CHECK(a->lexeme == b->lexeme && a->length == b->length);
+        TEST_CHECK(a->flags == b->flags && a->kind == b->kind && a->value == b->value);
+        TEST_CHECK(a->line == b->line && a->column == b->column);
+
+        const LexerLiteral* literalA = LexerTokenArray_GetLiteral(expected, i);
+        const LexerLiteral* literalB = LexerTokenArray_GetLiteral(tokens, i);
+        TEST_CHECK(!literalA == !literalB);
+        if (literalA) {
+            TEST_CHECK(literalA->value.integer == literalB->value.integer && literalA->type == literalB->type);
+            TEST_CHECK(literalA->suffix == literalB->suffix && literalA->base == literalB->base);
+        }
+    }
+
+    uint32_t triviaCount = 0;
+    uint32_t expectedTriviaCount = 0;
+    const LexerTrivia* trivia = LexerTokenArray_GetTrivia(tokens, &triviaCount);
+    const LexerTrivia* expectedTrivia = LexerTokenArray_GetTrivia(expected, &expectedTriviaCount);
+    TEST_CHECK(triviaCount == expectedTriviaCount);
+    TEST_CHECK(!triviaCount || memcmp(trivia, expectedTrivia, sizeof(LexerTrivia) * triviaCount) == 0);
+}
+
+/* Lex a file serially and in parallel with every thread count given, and compare */
+static void TestLexerMatches(const char* text, size_t length, ParserSize minChunkSize, const uint32_t* threads,
+    uint32_t threadCounts, uint32_t* relexed)
+{
+    TEST_CHECK(TestWriteFile(TEST_LEXER_SOURCE, text, length));
+
+    FileBufferConfig fileConfig = { 0 };
+    fileConfig.fileName = TEST_LEXER_SOURCE;
+    fileConfig.filePath = TEST_LEXER_SOURCE;
+    FileBuffer file;
+    TEST_CHECK(CreateFileBuffer(&fileConfig, &file) == PARSER_RESULT_SUCCESS);
+
+    for (uint32_t preserve = 0; preserve < 2; preserve++) {
+        LexerTokenArray expected = NULL;
+        ParserResult expectedResult = TestLexerSerial(file, preserve != 0, &expected);
+
+        for (uint32_t i = 0; i < threadCounts; i++) {
+            LexerParallelConfig config = { 0 };
+            config.strategy = &g_CLexerLanguageStrategy;
+            config.threadCount = threads[i];
+            config.minChunkSize = minChunkSize;
+            config.preserveWhitespace = preserve != 0;
+            config.preserveComments = preserve != 0;
+
+            LexerTokenArray tokens = NULL;
+            LexerParallelStats stats = { 0 };
+            ParserResult result = LexerTokenizeParallel(file, &config, &tokens, &stats);
+            if (result != expectedResult)
+                TestFail(__FILE__, __LINE__, "result == expectedResult");
+            else if (result == PARSER_RESULT_SUCCESS)
+                TestLexerCompare(expected, tokens);
+
+            if (relexed)
+                *relexed += stats.relexedChunks;
+
+            LexerTokenArray_Destroy(tokens);
+        }
+
+        LexerTokenArray_Destroy(expected);
+    }
+
+    DestroyFileBuffer(file);
+    remove(TEST_LEXER_SOURCE);
+}
+
+/* A license comment longer than several chunks, the chunks it covers have nothing left to lex */
+static void TestLexerSpanningComment(void)
+{
+    TestText text = { 0 };
+    TestText_Append(&text, "/*\n");
+    for (uint32_t i = 0; i < 40; i++)
+        TestText_Append(&text, " * Line %02u of the license text of this file.\n", i);
+    TestText_Append(&text, " */\n\nint main(void)\n{\n    return 0x2A + 1.5e3;\n}\n");
+
+    static const uint32_t threads[] = { 2, 4, 8, 16 };
+    uint32_t relexed = 0;
+    TestLexerMatches(text.data, text.length, 64, threads, TEST_COUNT(threads), &relexed);
+    TestText_Free(&text);
+
+    TEST_CHECK(relexed > 0);
+}
+
+/* A string continued over many lines, and a comment that ends the file */
+static void TestLexerSpanningLiteral(void)
+{
+    TestText text = { 0 };
+    TestText_Append(&text, "const char* s = \"");
+    for (uint32_t i = 0; i < 60; i++)
+        TestText_Append(&text, "continued string line %02u\\\n", i);
+    TestText_Append(&text, "\";\nint x = 1;\n/* comment that ends the file\n");
+    for (uint32_t i = 0; i < 40; i++)
+        TestText_Append(&text, "comment line %02u\n", i);
+    TestText_Append(&text, "*/");
+
+    static const uint32_t threads[] = { 3, 8, 64 };
+    TestLexerMatches(text.data, text.length, 32, threads, TEST_COUNT(threads), NULL);
+    TestText_Free(&text);
+}
+
+/* Files shorter than a chunk, and without a final newline */
+static void TestLexerSmall(void)
+{
+    static const char* const sources[] = { "x", "int a;", "\n\n\n", "/* c */", "a\nb\nc", "\"s\"\n'c'\n1.0f" };
+    static const uint32_t threads[] = { 1, 2, 8 };
+
+    for (uint32_t i = 0; i < TEST_COUNT(sources); i++)
+        TestLexerMatches(sources[i], strlen(sources[i]), 1, threads, TEST_COUNT(threads), NULL);
+}
+
+/* Generated source, every boundary lands somewhere else for every thread count */
+static void TestLexerGenerated(void)
+{
+    TestText text = { 0 };
+    TestLexerGenerate(&text, 20000, 1);
+
+    static const uint32_t threads[] = { 1, 2, 3, 4, 5, 8, 16, 64 };
+    TestLexerMatches(text.data, text.length, 1000, threads, TEST_COUNT(threads), NULL);
+    TestText_Free(&text);
+}
+
+/* Growing a token array past what a count can address fails instead of wrapping */
+static void TestLexerReserveOverflow(void)
+{
+    struct LexerTokenArray_T tokens;
+    memset(&tokens, 0, sizeof(tokens));
+
+    TEST_CHECK(LexerTokenArrayReserve(&tokens, UINT32_MAX) == PARSER_ERROR_NO_MEMORY);
+    TEST_CHECK(!tokens.tokens && tokens.capacity == 0);
+}
+
+/* An arena installed as the global allocator is refused, it would be bumped from every thread */
+static void TestLexerArenaAllocator(void)
+{
+    static const char source[] = "int a;\nint b;\n";
+    TEST_CHECK(TestWriteFile(TEST_LEXER_SOURCE, source, sizeof(source) - 1));
+
+    FileBufferConfig fileConfig = { 0 };
+    fileConfig.fileName = TEST_LEXER_SOURCE;
+    fileConfig.filePath = TEST_LEXER_SOURCE;
+    FileBuffer file;
+    TEST_CHECK(CreateFileBuffer(&fileConfig, &file) == PARSER_RESULT_SUCCESS);
+
+    ParserArena arena;
+    TEST_CHECK(ParserArena_Create(NULL, &arena) == PARSER_RESULT_SUCCESS);
+    ParserAllocationCallbacks callbacks;
+    ParserArena_GetCallbacks(arena, &callbacks);
+
+    LexerParallelConfig config = { 0 };
+    config.strategy = &g_CLexerLanguageStrategy;
+    config.threadCount = 2;
+
+    ParserAllocationCallbacks* previous = g_parser_allocator_callbacks;
+    g_parser_allocator_callbacks = &callbacks;
+    LexerTokenArray tokens = NULL;
+    ParserResult refused = LexerTokenizeParallel(file, &config, &tokens, NULL);
+    g_parser_allocator_callbacks = previous;
+
+    ParserResult result = LexerTokenizeParallel(file, &config, &tokens, NULL);
+    LexerTokenArray_Destroy(tokens);
+    ParserArena_Destroy(arena);
+    DestroyFileBuffer(file);
+    remove(TEST_LEXER_SOURCE);
+
+    TEST_CHECK(refused == PARSER_ERROR_UNSUPPORTED);
+    TEST_CHECK(result == PARSER_RESULT_SUCCESS);
+}
+
+/* Best of a few runs of LexerTokenizeParallel in milliseconds, the token count through `count` */
+static double TestLexerTimeParallel(FileBuffer file, uint32_t threads, uint32_t* count, uint32_t* chunks)
+{
+    double best = 0.0;
+
+    for (uint32_t run = 0; run < TEST_LEXER_BENCH_RUNS; run++) {
+        LexerParallelConfig config = { 0 };
+        config.strategy = &g_CLexerLanguageStrategy;
+        config.threadCount = threads;
+
+        LexerTokenArray tokens = NULL;
+        LexerParallelStats stats = { 0 };
+        double start = TestNow();
+        ParserResult result = LexerTokenizeParallel(file, &config, &tokens, &stats);
+        double elapsed = (TestNow() - start) * 1000.0;
+
+        *count = result == PARSER_RESULT_SUCCESS ? LexerTokenArray_GetCount(tokens) : 0;
+        *chunks = stats.chunkCount;
+        LexerTokenArray_Destroy(tokens);
+
+        if (run == 0 || elapsed < best)
+            best = elapsed;
+    }
+
+    return best;
+}
+
+/* Best of a few runs of LexerTokenize in milliseconds */
+static double TestLexerTimeSerial(FileBuffer file, uint32_t* count)
+{
+    double best = 0.0;
+
+    for (uint32_t run = 0; run < TEST_LEXER_BENCH_RUNS; run++) {
+        LexerTokenArray tokens = NULL;
+        double start = TestNow();
+        ParserResult result = TestLexerSerial(file, false, &tokens);
+        double elapsed = (TestNow() - start) * 1000.0;
+
+        *count = result == PARSER_RESULT_SUCCESS ? LexerTokenArray_GetCount(tokens) : 0;
+        LexerTokenArray_Destroy(tokens);
+
+        if (run == 0 || elapsed < best)
+            best = elapsed;
+    }
+
+    return best;
+}
+
+/* Speed of the parallel lexer over thread counts against the serial lexer, on about 60 MB of source */
+static void TestLexerBenchScaling(void)
+{
+    TestText text = { 0 };
+    TestLexerGenerate(&text, TEST_LEXER_BENCH_LINES, 7);
+    TEST_CHECK(TestWriteFile(TEST_LEXER_SOURCE, text.data, text.length));
+
+    FileBufferConfig fileConfig = { 0 };
+    fileConfig.fileName = TEST_LEXER_SOURCE;
+    fileConfig.filePath = TEST_LEXER_SOURCE;
+    FileBuffer file;
+    if (CreateFileBuffer(&fileConfig, &file) != PARSER_RESULT_SUCCESS) {
+        TestFail(__FILE__, __LINE__, "CreateFileBuffer(&fileConfig, &file) == PARSER_RESULT_SUCCESS");
+        TestText_Free(&text);
+        remove(TEST_LEXER_SOURCE);
+        return;
+    }
+
+    uint32_t expected = 0;
+    double serial = TestLexerTimeSerial(file, &expected);
+    printf("    %.1f MB, %u tokens, LexerTokenize %.1f ms\n", (double)text.length / 1e6, expected, serial);
+
+    static const uint32_t threads[] = { 1, 2, 4, 8, 16 };
+    bool same = expected > 0;
+
+    for (uint32_t i = 0; i < TEST_COUNT(threads); i++) {
+        uint32_t count = 0;
+        uint32_t chunks = 0;
+        double elapsed = TestLexerTimeParallel(file, threads[i], &count, &chunks);
+        printf("    %2u threads, %2u chunks: %.1f ms, %.2fx\n", threads[i], chunks, elapsed, serial / elapsed);
+
+        same = same && count == expected;
+    }
+
+    DestroyFileBuffer(file);
+    TestText_Free(&text);
+    remove(TEST_LEXER_SOURCE);
+
+    TEST_CHECK(same);
+}
+
+static const TestCase s_Tests[] = {
+    { "SpanningComment", TestLexerSpanningComment },
+    { "SpanningLiteral", TestLexerSpanningLiteral },
+    { "Small", TestLexerSmall },
+    { "Generated", TestLexerGenerated },
+    { "ReserveOverflow", TestLexerReserveOverflow },
+    { "ArenaAllocator", TestLexerArenaAllocator },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchScaling", TestLexerBenchScaling },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteLexerParallel = {
+    "LexerParallel", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,244 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/lexer/LexerInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_RING_SOURCE                "CompilerTests_LexerRing.c"
+#define TEST_RING_TOKENS                3000u
+#define TEST_RING_CAPACITY              4u
+
+/* A streaming lexer with a small ring and the batch tokens of the same file to compare with */
+typedef struct TestRing_T {
+    TestSource source;
+    Lexer batch;
+    LexerTokenArray expected;
+    uint32_t count;
+} TestRing;
+
+static bool TestRingOpen(TestRing* ring)
+{
+    memset(ring, 0, sizeof(TestRing));
+
+    TestText text = { 0 };
+    for (uint32_t i = 0; i < TEST_RING_TOKENS; i++)
+        TestText_Append(&text, i % 12 == 11 ? "t%u\n" : "t%u ", i);
+
+    LexerCreateConfig config = { &g_CLexerLanguageStrategy, TEST_RING_CAPACITY };
+    bool opened = TestSource_Open(&ring->source, TEST_RING_SOURCE, text.data, &config);
+    TestText_Free(&text);
+
+    LexerCreateConfig batchConfig = { &g_CLexerLanguageStrategy, 0 };
+    if (!opened || CreateLexer(ring->source.file, &batchConfig, &ring->batch) != PARSER_RESULT_SUCCESS) {
+        ring->batch = NULL;
+        return false;
+    }
+
+    if (LexerTokenize(ring->batch, &ring->expected) != PARSER_RESULT_SUCCESS)
+        return false;
+
+    // The identifiers and the EOF token
+    ring->count = LexerTokenArray_GetCount(ring->expected);
+    return ring->count == TEST_RING_TOKENS + 1;
+}
+
+static void TestRingClose(TestRing* ring)
+{
+    LexerTokenArray_Destroy(ring->expected);
+    if (ring->batch)
+        LexerDestroy(ring->batch);
+    TestSource_Close(&ring->source);
+}
+
+/* The streamed token is the batch token at `index` */
+static bool TestRingSame(const TestRing* ring, LexerToken token, uint32_t index)
+{
+    if (!token || index >= ring->count)
+        return false;
+
+    LexerToken expected = LexerTokenArray_GetToken(ring->expected, index);
+    return token->lexeme == expected->lexeme && token->length == expected->length &&
+        token->flags == expected->flags && token->line == expected->line && token->column == expected->column;
+}
+
+/* Take `count` tokens from the stream, which has to be at `index` */
+static bool TestRingRead(const TestRing* ring, uint32_t index, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        LexerToken token = NULL;
+        if (LexerNextToken(ring->source.lexer, &token) != PARSER_RESULT_SUCCESS ||
+            !TestRingSame(ring, token, index + i))
+            return false;
+    }
+
+    return true;
+}
+
+static uint32_t TestRingCapacity(const TestRing* ring)
+{
+    return ring->source.lexer->ringMask + 1;
+}
+
+/* Without checkpoints the ring keeps its first size however far the stream goes */
+static void TestRingStreaming(void)
+{
+    TestRing ring;
+    bool opened = TestRingOpen(&ring);
+
+    bool read = opened && TestRingRead(&ring, 0, ring.count);
+    uint32_t capacity = opened ? TestRingCapacity(&ring) : 0;
+
+    // The EOF token is returned again
+    LexerToken token = NULL;
+    bool repeated = opened && LexerNextToken(ring.source.lexer, &token) == PARSER_RESULT_SUCCESS &&
+        token->flags == TOKEN_TYPE_EOF && TestRingSame(&ring, token, ring.count - 1);
+
+    TestRingClose(&ring);
+
+    TEST_CHECK(opened);
+    TEST_CHECK(read && repeated);
+    TEST_CHECK(capacity == 16);
+}
+
+/* A checkpoint keeps its tokens while the ring grows past them, rewinding reads them again */
+static void TestRingMarkRewind(void)
+{
+    TestRing ring;
+    TEST_CHECK(TestRingOpen(&ring));
+    Lexer lexer = ring.source.lexer;
+
+    bool same = TestRingRead(&ring, 0, 10);
+    uint32_t before = TestRingCapacity(&ring);
+
+    LexerCheckpoint outer;
+    same = same && LexerMark(lexer, &outer) == PARSER_RESULT_SUCCESS && outer.position == 10;
+    same = same && TestRingRead(&ring, 10, 200);
+
+    LexerCheckpoint inner;
+    same = same && LexerMark(lexer, &inner) == PARSER_RESULT_SUCCESS && inner.position == 210;
+    same = same && TestRingRead(&ring, 210, 1000);
+    uint32_t grown = TestRingCapacity(&ring);
+
+    // Back to the inner checkpoint, then to the outer one which releases the inner
+    same = same && LexerRewind(lexer, &inner) == PARSER_RESULT_SUCCESS && TestRingRead(&ring, 210, 50);
+    same = same && LexerRewind(lexer, &outer) == PARSER_RESULT_SUCCESS && TestRingRead(&ring, 10, 1500);
+
+    ParserResult released = LexerRewind(lexer, &inner);
+    ParserResult again = LexerRewind(lexer, &outer);
+
+    // Without checkpoints the rest of the stream goes on in the grown ring
+    same = same && TestRingRead(&ring, 1510, ring.count - 1510);
+
+    TestRingClose(&ring);
+
+    TEST_CHECK(same);
+    TEST_CHECK(before == 16 && grown >= 1024);
+    TEST_CHECK(released == PARSER_ERROR_INVALID_ARG && again == PARSER_ERROR_INVALID_ARG);
+}
+
+/* Peeking further than the ring holds grows it, the current token does not move */
+static void TestRingPeek(void)
+{
+    TestRing ring;
+    TEST_CHECK(TestRingOpen(&ring));
+    Lexer lexer = ring.source.lexer;
+
+    bool same = TestRingRead(&ring, 0, 5);
+    same = same && TestRingSame(&ring, LexerPeekN(lexer, 0), 5) && TestRingSame(&ring, LexerCurrentToken(lexer), 5);
+    same = same && TestRingSame(&ring, LexerPeekN(lexer, 700), 705);
+    same = same && TestRingSame(&ring, LexerPeekN(lexer, 1), 6);
+
+    LexerToken lookahead = NULL;
+    same = same && LexerLookAheadToken(lexer, &lookahead) == PARSER_RESULT_SUCCESS && TestRingSame(&ring, lookahead, 6);
+
+    // Past the end the EOF token is repeated
+    same = same && TestRingSame(&ring, LexerPeekN(lexer, ring.count * 2), ring.count - 1);
+    same = same && TestRingRead(&ring, 5, ring.count - 5);
+
+    TestRingClose(&ring);
+
+    TEST_CHECK(same);
+}
+
+/* Seeking moves anywhere behind the oldest checkpoint and no further back */
+static void TestRingSeek(void)
+{
+    TestRing ring;
+    TEST_CHECK(TestRingOpen(&ring));
+    Lexer lexer = ring.source.lexer;
+
+    LexerCheckpoint start;
+    bool same = TestRingRead(&ring, 0, 20) && LexerMark(lexer, &start) == PARSER_RESULT_SUCCESS;
+    same = same && TestRingRead(&ring, 20, ring.count - 20);
+
+    ParserResult seekBack = LexerSeek(lexer, 100);
+    same = same && TestRingRead(&ring, 100, 10);
+    ParserResult seekStart = LexerSeek(lexer, 20);
+    same = same && TestRingRead(&ring, 20, 10);
+
+    ParserResult beforeMark = LexerSeek(lexer, 19);
+    ParserResult pastEnd = LexerSeek(lexer, ring.count + 1);
+
+    // The checkpoint is kept by seeking and still rewinds
+    ParserResult rewound = LexerRewind(lexer, &start);
+    same = same && TestRingRead(&ring, 20, 5);
+
+    TestRingClose(&ring);
+
+    TEST_CHECK(same);
+    TEST_CHECK(seekBack == PARSER_RESULT_SUCCESS && seekStart == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(beforeMark == PARSER_ERROR_INVALID_ARG && pastEnd == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(rewound == PARSER_RESULT_SUCCESS);
+}
+
+/* At most LEXER_MAX_CHECKPOINTS nest, releasing one releases those taken after it */
+static void TestRingCheckpointLimit(void)
+{
+    TestRing ring;
+    TEST_CHECK(TestRingOpen(&ring));
+    Lexer lexer = ring.source.lexer;
+
+    LexerCheckpoint marks[LEXER_MAX_CHECKPOINTS + 1];
+    bool marked = true;
+    for (uint32_t i = 0; i < LEXER_MAX_CHECKPOINTS; i++)
+        marked = marked && LexerMark(lexer, &marks[i]) == PARSER_RESULT_SUCCESS && TestRingRead(&ring, i, 1);
+
+    ParserResult full = LexerMark(lexer, &marks[LEXER_MAX_CHECKPOINTS]);
+    ParserResult released = LexerReleaseMark(lexer, &marks[4]);
+    ParserResult later = LexerRewind(lexer, &marks[5]);
+    ParserResult earlier = LexerRewind(lexer, &marks[3]);
+    bool same = TestRingRead(&ring, 3, 100);
+
+    TestRingClose(&ring);
+
+    TEST_CHECK(marked);
+    TEST_CHECK(full == PARSER_ERROR_NO_MEMORY);
+    TEST_CHECK(released == PARSER_RESULT_SUCCESS && later == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(earlier == PARSER_RESULT_SUCCESS && same);
+}
+
+static const TestCase s_Tests[] = {
+    { "Streaming", TestRingStreaming },
+    { "MarkRewind", TestRingMarkRewind },
+    { "Peek", TestRingPeek },
+    { "Seek", TestRingSeek },
+    { "CheckpointLimit", TestRingCheckpointLimit },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteLexerRing = {
+    "LexerRing", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
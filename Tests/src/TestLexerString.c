@@ -0,0 +1,207 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/ParserArena.h"
+#include "parser/lexer/LexerInternal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_STRING_SOURCE              "CompilerTests_LexerString.c"
+#define TEST_STRING_BOUNDARY_PADDING    48u
+
+/* Literal tokens after `s = `, what they decode to in code units, and with which result */
+typedef struct TestString_T {
+    const char* literal;
+    ParserResult result;
+    const char* units;              // Little-endian code units
+    size_t length;                  // In code units
+    uint32_t unitSize;
+    uint32_t tokenCount;
+} TestString;
+
+static const TestString s_Strings[] = {
+    { "\"plain\"", PARSER_RESULT_SUCCESS, "plain", 5, 1, 1 },
+    { "\"\"", PARSER_RESULT_SUCCESS, "", 0, 1, 1 },
+    { "\"a\\nb\\t\\\\\\\"\\'\\?\"", PARSER_RESULT_SUCCESS, "a\nb\t\\\"'?", 8, 1, 1 },
+    { "\"\\a\\b\\f\\r\\v\"", PARSER_RESULT_SUCCESS, "\a\b\f\r\v", 5, 1, 1 },
+    { "\"\\x41\\x4a\\x7F\\xff\"", PARSER_RESULT_SUCCESS, "AJ\x7f\xff", 4, 1, 1 },
+    { "\"\\101\\0\\1234\"", PARSER_RESULT_SUCCESS, "A\0S4", 4, 1, 1 },
+    { "\"\\u00e9\\U0001F600\"", PARSER_RESULT_SUCCESS, "\xc3\xa9\xf0\x9f\x98\x80", 6, 1, 1 },
+    { "\"ab\\\ncd\"", PARSER_RESULT_SUCCESS, "abcd", 4, 1, 1 },
+    { "\"ab\" \"cd\"\n  \"\\x41\"", PARSER_RESULT_SUCCESS, "abcdA", 5, 1, 3 },
+    { "u8\"\\xff\" \"!\"", PARSER_RESULT_SUCCESS, "\xff!", 2, 1, 2 },
+    { "u\"\xc3\xa9\\U0001F600\"", PARSER_RESULT_SUCCESS, "\xe9\x00\x3d\xd8\x00\xde", 3, 2, 1 },
+    { "u\"\\xffff\"", PARSER_RESULT_SUCCESS, "\xff\xff", 1, 2, 1 },
+    { "U\"a\\u00e9\"", PARSER_RESULT_SUCCESS, "a\0\0\0\xe9\0\0\0", 2, 4, 1 },
+    { "\"x\" L\"y\"", PARSER_RESULT_SUCCESS, "x\0\0\0y\0\0\0", 2, 4, 2 },
+    { "'\\n'", PARSER_RESULT_SUCCESS, "\n", 1, 1, 1 },
+    { "'\\''", PARSER_RESULT_SUCCESS, "'", 1, 1, 1 },
+    { "\"\\q\"", PARSER_ERROR_INVALID_ESCAPE_SEQUENCE, NULL, 0, 0, 0 },
+    { "\"\\x\"", PARSER_ERROR_INVALID_ESCAPE_SEQUENCE, NULL, 0, 0, 0 },
+    { "\"\\x100\"", PARSER_ERROR_INVALID_ESCAPE_SEQUENCE, NULL, 0, 0, 0 },
+    { "\"\\777\"", PARSER_ERROR_INVALID_ESCAPE_SEQUENCE, NULL, 0, 0, 0 },
+    { "u\"\\x10000\"", PARSER_ERROR_INVALID_ESCAPE_SEQUENCE, NULL, 0, 0, 0 },
+    { "\"\\ud800\"", PARSER_ERROR_INVALID_ESCAPE_SEQUENCE, NULL, 0, 0, 0 },
+    { "\"\\u12\"", PARSER_ERROR_INVALID_ESCAPE_SEQUENCE, NULL, 0, 0, 0 },
+    { "u\"a\" U\"b\"", PARSER_ERROR_SYNTAX_ERROR, NULL, 0, 0, 0 },
+};
+
+static const LexerLanguageStrategy* const s_StringStrategies[] = {
+    &g_CLexerLanguageStrategy,
+    &g_CLexerGeneratedStrategy,
+};
+
+/* Lex `s = <literal>;` and decode the literal after the `=`, comparing with `expected` */
+static void TestStringDecode(const LexerLanguageStrategy* strategy, const char* literal, const TestString* expected)
+{
+    TestText text = { 0 };
+    TestText_Append(&text, "s = %s;\n", literal);
+
+    TestSource source;
+    LexerCreateConfig config = { strategy, 0 };
+    bool opened = TestSource_Open(&source, TEST_STRING_SOURCE, text.data, &config);
+    TestText_Free(&text);
+
+    LexerTokenArray tokens = NULL;
+    ParserResult lexed = opened ? LexerTokenize(source.lexer, &tokens) : PARSER_ERROR_INVALID_ARG;
+
+    ParserArena arena = NULL;
+    ParserResult created = ParserArena_Create(NULL, &arena);
+
+    LexerStringBytes bytes = { 0 };
+    ParserResult result = created == PARSER_RESULT_SUCCESS && lexed == PARSER_RESULT_SUCCESS ?
+        LexerCDecodeString(tokens, 2, arena, &bytes) : created;
+
+    bool same = result == expected->result;
+    if (same && result == PARSER_RESULT_SUCCESS) {
+        same = bytes.length == expected->length && bytes.unitSize == expected->unitSize &&
+            bytes.tokenCount == expected->tokenCount &&
+            memcmp(bytes.data, expected->units, expected->length * expected->unitSize) == 0;
+    }
+
+    if (!same)
+        printf("    %s: result %d, %zu units\n", literal, (int)result, bytes.length);
+
+    ParserArena_Destroy(arena);
+    LexerTokenArray_Destroy(tokens);
+    TestSource_Close(&source);
+
+    TEST_CHECK(lexed == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(same);
+}
+
+static void TestStringEscapes(void)
+{
+    for (uint32_t s = 0; s < TEST_COUNT(s_StringStrategies); s++) {
+        for (uint32_t i = 0; i < TEST_COUNT(s_Strings); i++)
+            TestStringDecode(s_StringStrategies[s], s_Strings[i].literal, &s_Strings[i]);
+    }
+}
+
+/* Escaped quotes and backslashes at every position around the 16 byte blocks of the scanner */
+static void TestStringBoundaries(void)
+{
+    for (uint32_t s = 0; s < TEST_COUNT(s_StringStrategies); s++) {
+        for (uint32_t padding = 0; padding < TEST_STRING_BOUNDARY_PADDING; padding++) {
+            TestText literal = { 0 };
+            TestText decoded = { 0 };
+
+            // "aaa\"bbb\\c\n" with the first escape moving through the blocks
+            TestText_Append(&literal, "\"");
+            for (uint32_t i = 0; i < padding; i++) {
+                TestText_Append(&literal, "a");
+                TestText_Append(&decoded, "a");
+            }
+            TestText_Append(&literal, "\\\"");
+            TestText_Append(&decoded, "\"");
+            for (uint32_t i = 0; i < padding % 17; i++) {
+                TestText_Append(&literal, "b");
+                TestText_Append(&decoded, "b");
+            }
+            TestText_Append(&literal, "\\\\c\\n\"");
+            TestText_Append(&decoded, "\\c\n");
+
+            TestString expected = { NULL, PARSER_RESULT_SUCCESS, decoded.data, decoded.length, 1, 1 };
+            TestStringDecode(s_StringStrategies[s], literal.data, &expected);
+
+            // Without escapes the literal is used from the file buffer as it is
+            TestText_Reset(&literal);
+            TestText_Reset(&decoded);
+            for (uint32_t i = 0; i < padding; i++)
+                TestText_Append(&decoded, "%c", 'a' + i % 26);
+            TestText_Append(&literal, "\"%s\"", decoded.data);
+
+            expected.units = decoded.data;
+            expected.length = decoded.length;
+            TestStringDecode(s_StringStrategies[s], literal.data, &expected);
+
+            TestText_Free(&literal);
+            TestText_Free(&decoded);
+
+            if (TestFailed()) {
+                printf("    padding %u\n", padding);
+                return;
+            }
+        }
+    }
+}
+
+/* Only literals with escapes are flagged, and only those need an arena */
+static void TestStringFlags(void)
+{
+    TestSource source;
+    TEST_CHECK(TestSource_Open(&source, TEST_STRING_SOURCE,
+        "a = \"0123456789abcdef0123\"; b = \"0123456789abcde\\n\"; c = \"x\" \"y\";\n", NULL));
+
+    LexerTokenArray tokens = NULL;
+    ParserResult lexed = LexerTokenize(source.lexer, &tokens);
+
+    // a = "..." ; b = "..." ; c = "x" "y" ;
+    LexerToken plain = LexerTokenArray_GetToken(tokens, 2);
+    LexerToken escaped = LexerTokenArray_GetToken(tokens, 6);
+
+    LexerStringBytes bytes = { 0 };
+    ParserResult direct = LexerCDecodeString(tokens, 2, NULL, &bytes);
+    bool inBuffer = direct == PARSER_RESULT_SUCCESS && (const char*)bytes.data == plain->lexeme + 1 &&
+        bytes.length == 20;
+
+    ParserResult noArena = LexerCDecodeString(tokens, 6, NULL, &bytes);
+    ParserResult concatenated = LexerCDecodeString(tokens, 10, NULL, &bytes);
+    ParserResult notLiteral = LexerCDecodeString(tokens, 0, NULL, &bytes);
+
+    bool flags = lexed == PARSER_RESULT_SUCCESS && !(plain->value & LEXER_STRING_HAS_ESCAPES) &&
+        (escaped->value & LEXER_STRING_HAS_ESCAPES);
+
+    LexerTokenArray_Destroy(tokens);
+    TestSource_Close(&source);
+
+    TEST_CHECK(flags);
+    TEST_CHECK(inBuffer);
+    TEST_CHECK(noArena == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(concatenated == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(notLiteral == PARSER_ERROR_INVALID_ARG);
+}
+
+static const TestCase s_Tests[] = {
+    { "Escapes", TestStringEscapes },
+    { "Boundaries", TestStringBoundaries },
+    { "Flags", TestStringFlags },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteLexerString = {
+    "LexerString", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,219 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/lexer/LexerInternal.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_TRIVIA_SOURCE              "CompilerTests_LexerTrivia.c"
+#define TEST_TRIVIA_SOURCE_FLAGS        "CompilerTests_LexerTriviaFlags.c"
+
+static const char s_TriviaText[] =
+    "// license\n"
+    "/* block\n"
+    "   comment */  int x;\t// trailing\n"
+    "\n"
+    "int  y = /* inline */ 2;   \n"
+    "/* last */";
+
+static const LexerLanguageStrategy* const s_TriviaStrategies[] = {
+    &g_CLexerLanguageStrategy,
+    &g_CLexerGeneratedStrategy,
+};
+
+/* Tokenize the trivia text with a strategy, `whitespace` and `comments` preserved as asked */
+static ParserResult TestTriviaTokenize(TestSource* source, const char* path, const LexerLanguageStrategy* strategy,
+    bool whitespace, bool comments, LexerTokenArray* tokens)
+{
+    *tokens = NULL;
+
+    LexerCreateConfig config = { strategy, 0 };
+    if (!TestSource_Open(source, path, s_TriviaText, &config))
+        return PARSER_ERROR_INVALID_ARG;
+
+    Lexer_SetPreserveWhitespace(source->lexer, whitespace);
+    Lexer_SetPreserveComments(source->lexer, comments);
+
+    return LexerTokenize(source->lexer, tokens);
+}
+
+/* Offset of the first occurrence of `needle` in the trivia text */
+static uint32_t TestTriviaOffset(const char* needle)
+{
+    return (uint32_t)(strstr(s_TriviaText, needle) - s_TriviaText);
+}
+
+/* Trivia and lexemes laid end to end give back the file byte for byte */
+static void TestTriviaRoundTrip(void)
+{
+    for (uint32_t s = 0; s < TEST_COUNT(s_TriviaStrategies); s++) {
+        TestSource source;
+        LexerTokenArray tokens;
+        ParserResult result =
+            TestTriviaTokenize(&source, TEST_TRIVIA_SOURCE, s_TriviaStrategies[s], true, true, &tokens);
+
+        uint32_t offset = 0;
+        uint32_t count = LexerTokenArray_GetCount(tokens);
+        bool contiguous = result == PARSER_RESULT_SUCCESS && count > 0;
+
+        for (uint32_t i = 0; i < count && contiguous; i++) {
+            uint32_t triviaCount = 0;
+            const LexerTrivia* trivia = LexerTokenArray_GetLeadingTrivia(tokens, i, &triviaCount);
+
+            for (uint32_t t = 0; t < triviaCount && contiguous; t++) {
+                contiguous = trivia[t].offset == offset && trivia[t].tokenIndex == i;
+                offset += trivia[t].length;
+            }
+
+            LexerToken token = LexerTokenArray_GetToken(tokens, i);
+            contiguous = contiguous && offset + token->length <= sizeof(s_TriviaText) - 1 &&
+                memcmp(s_TriviaText + offset, token->lexeme, token->length) == 0;
+            offset += token->length;
+        }
+
+        LexerTokenArray_Destroy(tokens);
+        TestSource_Close(&source);
+
+        TEST_CHECK(contiguous);
+        TEST_CHECK(offset == sizeof(s_TriviaText) - 1);
+    }
+}
+
+/* Comments keep their kind and exact range, and belong to the token after them */
+static void TestTriviaComments(void)
+{
+    for (uint32_t s = 0; s < TEST_COUNT(s_TriviaStrategies); s++) {
+        TestSource source;
+        LexerTokenArray tokens;
+        ParserResult result =
+            TestTriviaTokenize(&source, TEST_TRIVIA_SOURCE, s_TriviaStrategies[s], true, true, &tokens);
+
+        uint32_t count = 0;
+        const LexerTrivia* trivia = LexerTokenArray_GetTrivia(tokens, &count);
+
+        // The text of every comment, in order, with the lexeme of the token it leads
+        static const struct {
+            const char* text;
+            uint32_t kind;
+            const char* next;
+        } comments[] = {
+            { "// license", LEXER_TRIVIA_LINE_COMMENT, "int" },
+            { "/* block\n   comment */", LEXER_TRIVIA_BLOCK_COMMENT, "int" },
+            { "// trailing", LEXER_TRIVIA_LINE_COMMENT, "int" },
+            { "/* inline */", LEXER_TRIVIA_BLOCK_COMMENT, "2" },
+            { "/* last */", LEXER_TRIVIA_BLOCK_COMMENT, "" },
+        };
+
+        uint32_t found = 0;
+        bool matches = result == PARSER_RESULT_SUCCESS;
+        for (uint32_t i = 0; i < count && matches; i++) {
+            if (trivia[i].kind == LEXER_TRIVIA_WHITESPACE)
+                continue;
+
+            matches = found < TEST_COUNT(comments);
+            if (!matches)
+                break;
+
+            LexerToken next = LexerTokenArray_GetToken(tokens, trivia[i].tokenIndex);
+            matches = trivia[i].kind == comments[found].kind &&
+                trivia[i].offset == TestTriviaOffset(comments[found].text) &&
+                trivia[i].length == strlen(comments[found].text) &&
+                next->length == strlen(comments[found].next) &&
+                memcmp(next->lexeme, comments[found].next, next->length) == 0;
+            found++;
+        }
+
+        // Whitespace, the inline comment and whitespace again lead the literal
+        uint32_t literal = 0;
+        for (uint32_t i = 0; i < LexerTokenArray_GetCount(tokens); i++) {
+            if (LexerTokenArray_GetToken(tokens, i)->lexeme[0] == '2')
+                literal = i;
+        }
+
+        uint32_t leadingCount = 0;
+        const LexerTrivia* leading = LexerTokenArray_GetLeadingTrivia(tokens, literal, &leadingCount);
+        bool leads = leading && leadingCount == 3 &&
+            leading[0].kind == LEXER_TRIVIA_WHITESPACE && leading[0].length == 1 &&
+            leading[1].kind == LEXER_TRIVIA_BLOCK_COMMENT &&
+            leading[2].kind == LEXER_TRIVIA_WHITESPACE && leading[2].length == 1;
+
+        LexerTokenArray_Destroy(tokens);
+        TestSource_Close(&source);
+
+        TEST_CHECK(matches && found == TEST_COUNT(comments));
+        TEST_CHECK(leads);
+    }
+}
+
+/* Each flag keeps only its own kind, neither keeps nothing and the tokens do not change */
+static void TestTriviaFlags(void)
+{
+    for (uint32_t s = 0; s < TEST_COUNT(s_TriviaStrategies); s++) {
+        TestSource full, source;
+        LexerTokenArray expected, tokens;
+        ParserResult expectedResult =
+            TestTriviaTokenize(&full, TEST_TRIVIA_SOURCE, s_TriviaStrategies[s], true, true, &expected);
+        uint32_t expectedCount = 0;
+        LexerTokenArray_GetTrivia(expected, &expectedCount);
+
+        uint32_t counts[3] = { 0 };
+        bool same = expectedResult == PARSER_RESULT_SUCCESS && expectedCount > 0;
+
+        for (uint32_t mode = 0; mode < 3 && same; mode++) {
+            bool whitespace = mode == 1;
+            bool comments = mode == 2;
+            ParserResult result = TestTriviaTokenize(&source, TEST_TRIVIA_SOURCE_FLAGS, s_TriviaStrategies[s],
+                whitespace, comments, &tokens);
+
+            const LexerTrivia* trivia = LexerTokenArray_GetTrivia(tokens, &counts[mode]);
+            for (uint32_t i = 0; i < counts[mode]; i++) {
+                if ((trivia[i].kind == LEXER_TRIVIA_WHITESPACE) != whitespace)
+                    same = false;
+            }
+
+            uint32_t count = LexerTokenArray_GetCount(tokens);
+            same = same && result == PARSER_RESULT_SUCCESS && count == LexerTokenArray_GetCount(expected);
+            for (uint32_t i = 0; i < count && same; i++) {
+                LexerToken a = LexerTokenArray_GetToken(expected, i);
+                LexerToken b = LexerTokenArray_GetToken(tokens, i);
+                same = a->length == b->length && a->flags == b->flags && a->kind == b->kind &&
+                    a->line == b->line && a->column == b->column &&
+                    memcmp(a->lexeme, b->lexeme, a->length) == 0;
+            }
+
+            LexerTokenArray_Destroy(tokens);
+            TestSource_Close(&source);
+        }
+
+        LexerTokenArray_Destroy(expected);
+        TestSource_Close(&full);
+
+        TEST_CHECK(same);
+        TEST_CHECK(counts[0] == 0);
+        TEST_CHECK(counts[1] > 0 && counts[2] == 5);
+        TEST_CHECK(counts[1] + counts[2] == expectedCount);
+    }
+}
+
+static const TestCase s_Tests[] = {
+    { "RoundTrip", TestTriviaRoundTrip },
+    { "Comments", TestTriviaComments },
+    { "Flags", TestTriviaFlags },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteLexerTrivia = {
+    "LexerTrivia", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
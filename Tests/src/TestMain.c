@@ -0,0 +1,129 @@
+// ------------------------------------------------------------------------------------------------
+// CompilerTests
+//
+// Runs the test suites of the compiler core, and their benchmarks as well
+// with --bench. A suite name on the command line runs only that suite.
+// Tests write their input files to the working directory and remove them.
+//
+// Usage: CompilerTests [--bench] [suite]
+// ------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+extern const TestSuite g_TestSuiteLexerParallel;
+extern const TestSuite g_TestSuiteLexerGenerated;
+extern const TestSuite g_TestSuiteLexerTrivia;
+extern const TestSuite g_TestSuiteLexerNumber;
+extern const TestSuite g_TestSuiteLexerString;
+extern const TestSuite g_TestSuiteLexerRing;
+extern const TestSuite g_TestSuiteParserArena;
+extern const TestSuite g_TestSuiteParserAST;
+extern const TestSuite g_TestSuiteParserExpression;
+extern const TestSuite g_TestSuiteParserSymbol;
+extern const TestSuite g_TestSuiteParserType;
+extern const TestSuite g_TestSuiteParserLazy;
+extern const TestSuite g_TestSuiteParserConstant;
+extern const TestSuite g_TestSuiteParserImage;
+extern const TestSuite g_TestSuiteParserParallel;
+extern const TestSuite g_TestSuiteParserVisitor;
+extern const TestSuite g_TestSuiteIRLowering;
+extern const TestSuite g_TestSuiteIRText;
+extern const TestSuite g_TestSuiteIRPasses;
+extern const TestSuite g_TestSuiteIRRegAlloc;
+
+static const TestSuite* const s_Suites[] = {
+    &g_TestSuiteLexerParallel,
+    &g_TestSuiteLexerGenerated,
+    &g_TestSuiteLexerTrivia,
+    &g_TestSuiteLexerNumber,
+    &g_TestSuiteLexerString,
+    &g_TestSuiteLexerRing,
+    &g_TestSuiteParserArena,
+    &g_TestSuiteParserAST,
+    &g_TestSuiteParserExpression,
+    &g_TestSuiteParserSymbol,
+    &g_TestSuiteParserType,
+    &g_TestSuiteParserLazy,
+    &g_TestSuiteParserConstant,
+    &g_TestSuiteParserImage,
+    &g_TestSuiteParserParallel,
+    &g_TestSuiteParserVisitor,
+    &g_TestSuiteIRLowering,
+    &g_TestSuiteIRText,
+    &g_TestSuiteIRPasses,
+    &g_TestSuiteIRRegAlloc,
+};
+
+/* Run the cases of a suite, return how many failed */
+static uint32_t TestRunCases(const TestSuite* suite, const TestCase* cases, uint32_t count)
+{
+    uint32_t failed = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        printf("[%s] %s\n", suite->name, cases[i].name);
+        fflush(stdout);
+
+        cases[i].run();
+        if (TestFailed()) {
+            printf("[%s] %s FAILED\n", suite->name, cases[i].name);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    bool benchmarks = false;
+    const char* only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            benchmarks = true;
+        } else if (argv[i][0] != '-' && !only) {
+            only = argv[i];
+        } else {
+            fprintf(stderr, "usage: CompilerTests [--bench] [suite]\n");
+            return 2;
+        }
+    }
+
+    uint32_t failed = 0;
+    uint32_t ran = 0;
+
+    for (uint32_t i = 0; i < TEST_COUNT(s_Suites); i++) {
+        const TestSuite* suite = s_Suites[i];
+        if (only && strcmp(only, suite->name) != 0)
+            continue;
+
+        failed += TestRunCases(suite, suite->tests, suite->testCount);
+        ran += suite->testCount;
+
+        if (benchmarks) {
+            failed += TestRunCases(suite, suite->benchmarks, suite->benchmarkCount);
+            ran += suite->benchmarkCount;
+        }
+    }
+
+    printf("%u of %u passed\n", ran - failed, ran);
+
+    return failed ? 1 : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,229 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_AST_SOURCE                 "CompilerTests_ParserAST.c"
+
+/* The child ids of a node agree between the handle and a view of its arrays */
+static bool TestASTSameChildren(const ASTTree tree, const ASTTreeView* view, ASTNodeId node,
+    const ASTNodeId* children, uint32_t count)
+{
+    if (ASTTree_GetChildCount(tree, node) != count || ASTTreeView_GetChildCount(view, node) != count)
+        return false;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (ASTTree_GetChild(tree, node, i) != children[i] || ASTTreeView_GetChild(view, node, i) != children[i])
+            return false;
+    }
+
+    // Past the last slot there is no child
+    return ASTTree_GetChild(tree, node, count) == AST_NODE_ID_NONE &&
+        ASTTreeView_GetChild(view, node, count) == AST_NODE_ID_NONE;
+}
+
+/* Nodes of every layout get consecutive ids, their children are read back inline or from the extra array */
+static void TestASTLayouts(void)
+{
+    ASTTree tree = NULL;
+    TEST_CHECK(CreateASTTree(4, &tree) == PARSER_RESULT_SUCCESS);
+
+    // if (f(a, b)) x = a * b;
+    ASTNodeId a, b, x, f, call, product, assign, statement, branch;
+    ASTNodeData name = { 7, 0 };
+    bool added = ASTTree_AddNode(tree, AST_NODE_TYPE_IDENTIFIER, 0, 2, name, &f) == PARSER_RESULT_SUCCESS;
+    added = added && ASTTree_AddNode(tree, AST_NODE_TYPE_IDENTIFIER, 0, 4, name, &a) == PARSER_RESULT_SUCCESS;
+    added = added && ASTTree_AddNode(tree, AST_NODE_TYPE_IDENTIFIER, 0, 6, name, &b) == PARSER_RESULT_SUCCESS;
+
+    ASTNodeId arguments[] = { f, a, b };
+    added = added && ASTTree_AddListNode(tree, AST_NODE_TYPE_CALL_EXPR, 0, 3, arguments, 3, &call) ==
+        PARSER_RESULT_SUCCESS;
+
+    added = added && ASTTree_AddNode(tree, AST_NODE_TYPE_IDENTIFIER, 0, 9, name, &x) == PARSER_RESULT_SUCCESS;
+    ASTNodeData operands = { a, b };
+    added = added && ASTTree_AddNode(tree, AST_NODE_TYPE_BINARY_EXPR, C_BINARY_OP_MULTIPLY, 12, operands,
+        &product) == PARSER_RESULT_SUCCESS;
+    ASTNodeData target = { x, product };
+    added = added && ASTTree_AddNode(tree, AST_NODE_TYPE_ASSIGNMENT_EXPR, C_BINARY_OP_ASSIGN, 10, target,
+        &assign) == PARSER_RESULT_SUCCESS;
+    ASTNodeData expression = { assign, 0 };
+    added = added && ASTTree_AddNode(tree, AST_NODE_TYPE_EXPRESSION_STMT, 0, 14, expression, &statement) ==
+        PARSER_RESULT_SUCCESS;
+
+    ASTNodeId parts[] = { call, statement, AST_NODE_ID_NONE };
+    added = added && ASTTree_AddListNode(tree, AST_NODE_TYPE_IF_STMT, 0, 0, parts, 3, &branch) ==
+        PARSER_RESULT_SUCCESS;
+
+    // A fixed layout takes exactly its own number of children, leaves none
+    ASTNodeId wrong = AST_NODE_ID_NONE;
+    ParserResult fixed = ASTTree_AddListNode(tree, AST_NODE_TYPE_IF_STMT, 0, 0, parts, 2, &wrong);
+    ParserResult leaf = ASTTree_AddListNode(tree, AST_NODE_TYPE_IDENTIFIER, 0, 0, parts, 1, &wrong);
+
+    ASTNodeId factors[] = { a, b };
+    ASTTreeView view;
+    ASTTree_GetView(tree, &view);
+
+    // Ids follow the order nodes were added in, 0 is the none node
+    bool ids = added && f == 1 && a == 2 && b == 3 && call == 4 && x == 5 && product == 6 && assign == 7 &&
+        statement == 8 && branch == 9;
+    bool arrays = view.firstNode == 0 && view.nodeCount == 10 && view.extraCount == 6 &&
+        view.types[0] == AST_NODE_TYPE_NONE && view.types[call] == AST_NODE_TYPE_CALL_EXPR &&
+        view.subtypes[product] == C_BINARY_OP_MULTIPLY && view.mainTokens[assign] == 10 &&
+        view.data[product].lhs == a && view.data[product].rhs == b &&
+        view.data[call].rhs == 3 && memcmp(view.extra + view.data[call].lhs, arguments, sizeof(arguments)) == 0 &&
+        ASTTree_GetNodeCount(tree) == 10 && ASTTree_GetNodeType(tree, branch) == AST_NODE_TYPE_IF_STMT;
+
+    bool children = TestASTSameChildren(tree, &view, call, arguments, 3) &&
+        TestASTSameChildren(tree, &view, product, factors, 2) &&
+        TestASTSameChildren(tree, &view, statement, &assign, 1) &&
+        TestASTSameChildren(tree, &view, branch, parts, 3) &&
+        TestASTSameChildren(tree, &view, a, NULL, 0) &&
+        ASTTree_GetChildCount(tree, AST_NODE_ID_NONE) == 0;
+
+    ASTTreeDestroy(tree);
+
+    TEST_CHECK(ids);
+    TEST_CHECK(fixed == PARSER_ERROR_INVALID_ARG && leaf == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(arrays);
+    TEST_CHECK(children);
+}
+
+/* Truncated ids are given out again, replaced children keep the shape of their node */
+static void TestASTEdit(void)
+{
+    ASTTree tree = NULL;
+    TEST_CHECK(CreateASTTree(0, &tree) == PARSER_RESULT_SUCCESS);
+
+    ASTNodeId first, second, folded, list;
+    ASTNodeData none = { 0, 0 };
+    bool added = ASTTree_AddNode(tree, AST_NODE_TYPE_INTEGER_LITERAL, 0, 0, none, &first) == PARSER_RESULT_SUCCESS;
+    added = added && ASTTree_AddNode(tree, AST_NODE_TYPE_INTEGER_LITERAL, 0, 2, none, &second) ==
+        PARSER_RESULT_SUCCESS;
+
+    // Operands folded into a constant go away and the constant takes the first id
+    ParserResult truncated = ASTTree_Truncate(tree, first);
+    added = added && ASTTree_AddNode(tree, AST_NODE_TYPE_INTEGER_LITERAL, 1, 0, none, &folded) ==
+        PARSER_RESULT_SUCCESS;
+    ParserResult noneNode = ASTTree_Truncate(tree, AST_NODE_ID_NONE);
+    ParserResult pastEnd = ASTTree_Truncate(tree, folded + 2);
+
+    ASTNodeId items[] = { folded, AST_NODE_ID_NONE };
+    added = added && ASTTree_AddListNode(tree, AST_NODE_TYPE_COMPOUND_STMT, 0, 0, items, 2, &list) ==
+        PARSER_RESULT_SUCCESS;
+
+    ParserResult set = ASTTree_SetChild(tree, list, 1, folded);
+    ParserResult outside = ASTTree_SetChild(tree, list, 2, folded);
+    ParserResult leaf = ASTTree_SetChild(tree, folded, 0, list);
+
+    ASTTreeView view;
+    ASTTree_GetView(tree, &view);
+    ASTNodeId expected[] = { folded, folded };
+    bool children = TestASTSameChildren(tree, &view, list, expected, 2);
+
+    ASTTree_Reset(tree);
+    bool reset = ASTTree_GetNodeCount(tree) == 1;
+
+    ASTTreeDestroy(tree);
+
+    TEST_CHECK(added && truncated == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(first == 1 && second == 2 && folded == 1 && list == 2);
+    TEST_CHECK(noneNode == PARSER_ERROR_INVALID_ARG && pastEnd == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(set == PARSER_RESULT_SUCCESS && children);
+    TEST_CHECK(outside == PARSER_ERROR_INVALID_ARG && leaf == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(reset);
+}
+
+/* A parsed unit links each node to one parent at most, through children stored in range */
+static void TestASTParsed(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, 40, 3);
+    bool written = TestWriteFile(TEST_AST_SOURCE, source.data, source.length);
+    TestText_Free(&source);
+    TEST_CHECK(written);
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_AST_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+        unit.result == PARSER_RESULT_SUCCESS;
+
+    ASTTreeView view = { 0 };
+    ASTNodeId root = AST_NODE_TO_ID(unit.root);
+    if (parsed)
+        ASTTree_GetView(ASTParser_GetTree(unit.parser), &view);
+
+    uint32_t* parents = calloc(view.nodeCount ? view.nodeCount : 1, sizeof(uint32_t));
+    bool inRange = parents != NULL;
+    bool single = true;
+
+    for (ASTNodeId node = 1; node < view.nodeCount && inRange; node++) {
+        uint32_t count = ASTTreeView_GetChildCount(&view, node);
+        for (uint32_t i = 0; i < count; i++) {
+            ASTNodeId child = ASTTreeView_GetChild(&view, node, i);
+            if (child == AST_NODE_ID_NONE)
+                continue;
+
+            inRange = inRange && child < view.nodeCount && child != root;
+            if (!inRange)
+                break;
+
+            single = single && parents[child] == 0;
+            parents[child] = node;
+        }
+    }
+
+    // Walking the parents up from any function or statement ends at the root, type declarations stand apart
+    uint32_t statements = 0;
+    uint32_t reached = 0;
+    for (ASTNodeId node = 1; node < view.nodeCount && inRange && single; node++) {
+        if (view.types[node] != AST_NODE_TYPE_FUNCTION_DECL &&
+            (view.types[node] < AST_NODE_TYPE_COMPOUND_STMT || view.types[node] > AST_NODE_TYPE_LABEL_STMT))
+            continue;
+
+        ASTNodeId up = node;
+        for (uint32_t steps = 0; parents[up] && steps < view.nodeCount; steps++)
+            up = parents[up];
+
+        statements++;
+        reached += up == root;
+    }
+
+    // The view points into the tree, read it before the unit goes
+    bool rooted = view.nodeCount > 1000 && view.types[root] == AST_NODE_TYPE_TRANSLATION_UNIT;
+
+    free(parents);
+    TestUnit_Destroy(&unit);
+    remove(TEST_AST_SOURCE);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(rooted);
+    TEST_CHECK(inRange && single);
+    TEST_CHECK(statements > 200 && reached == statements);
+}
+
+static const TestCase s_Tests[] = {
+    { "Layouts", TestASTLayouts },
+    { "Edit", TestASTEdit },
+    { "Parsed", TestASTParsed },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserAST = {
+    "ParserAST", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
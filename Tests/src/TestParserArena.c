@@ -0,0 +1,172 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+#include "parser/ParserArena.h"
+
+#include <stdio.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_ARENA_SOURCE               "CompilerTests_ParserArena.c"
+#define TEST_ARENA_BENCH_FUNCTIONS      20000u
+#define TEST_ARENA_BENCH_RUNS           3u
+
+/* Parse the file with `callbacks` installed as the global allocator, NULL for the default heap */
+static bool TestArenaParse(ParserAllocationCallbacks* callbacks, double* elapsed)
+{
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    ParserAllocationCallbacks* previous = g_parser_allocator_callbacks;
+    if (callbacks)
+        g_parser_allocator_callbacks = callbacks;
+
+    double start = TestNow();
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_ARENA_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+        unit.result == PARSER_RESULT_SUCCESS;
+    TestUnit_Destroy(&unit);
+    *elapsed = (TestNow() - start) * 1000.0;
+
+    g_parser_allocator_callbacks = previous;
+
+    return parsed;
+}
+
+static bool TestArenaWriteSource(uint32_t functions)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, functions, 5);
+    bool written = TestWriteFile(TEST_ARENA_SOURCE, source.data, source.length);
+    TestText_Free(&source);
+
+    return written;
+}
+
+/* The heap counters see every parser allocation, an installed arena takes them over */
+static void TestArenaCounters(void)
+{
+    TEST_CHECK(TestArenaWriteSource(300));
+
+    double elapsed;
+    ParserAllocationStats before, after;
+    ParserGetDefaultAllocationStats(&before);
+    bool parsed = TestArenaParse(NULL, &elapsed);
+    ParserGetDefaultAllocationStats(&after);
+
+    ParserArena arena = NULL;
+    ParserAllocationCallbacks callbacks;
+    ParserAllocationStats arenaStats = { 0 };
+    ParserAllocationStats heapBefore, heapAfter;
+    bool arenaParsed = false;
+
+    if (parsed && ParserArena_Create(NULL, &arena) == PARSER_RESULT_SUCCESS) {
+        ParserArena_GetCallbacks(arena, &callbacks);
+
+        ParserGetDefaultAllocationStats(&heapBefore);
+        arenaParsed = TestArenaParse(&callbacks, &elapsed);
+        ParserGetDefaultAllocationStats(&heapAfter);
+
+        ParserArena_GetStats(arena, &arenaStats);
+        ParserArena_Destroy(arena);
+    }
+
+    remove(TEST_ARENA_SOURCE);
+
+    TEST_CHECK(parsed && arena && arenaParsed);
+
+    // Everything the unit allocated is freed with it
+    TEST_CHECK(after.allocations - before.allocations == after.frees - before.frees);
+    TEST_CHECK(after.bytesReserved == before.bytesReserved);
+
+    // Arenas the parser owns take their chunks from the heap callbacks directly
+    int64_t heapAllocations = after.allocations - before.allocations;
+    int64_t heapAllocationsWithArena = heapAfter.allocations - heapBefore.allocations;
+    TEST_CHECK(heapAllocations > 0);
+
+#if defined(PARSER_DEBUG_ALLOCATORS)
+    // Everything else goes through PARSER_MALLOC, which the installed arena takes over
+    TEST_CHECK(arenaStats.allocations > 0);
+    TEST_CHECK(heapAllocationsWithArena < heapAllocations);
+    TEST_CHECK(heapAllocationsWithArena >= arenaStats.chunks);
+#else
+    // PARSER_MALLOC calls malloc directly, the installed arena sees nothing
+    TEST_CHECK(arenaStats.allocations == 0);
+    TEST_CHECK(heapAllocationsWithArena == heapAllocations);
+#endif
+}
+
+/* Parse time and allocation counts of the default heap against an arena */
+static void TestArenaBenchParse(void)
+{
+    TEST_CHECK(TestArenaWriteSource(TEST_ARENA_BENCH_FUNCTIONS));
+
+    bool parsed = true;
+    double heapBest = 0.0;
+    double arenaBest = 0.0;
+    ParserAllocationStats heap = { 0 };
+    ParserAllocationStats arenaStats = { 0 };
+
+    for (uint32_t run = 0; run < TEST_ARENA_BENCH_RUNS && parsed; run++) {
+        double elapsed;
+        ParserAllocationStats before, after;
+
+        ParserGetDefaultAllocationStats(&before);
+        parsed = TestArenaParse(NULL, &elapsed);
+        ParserGetDefaultAllocationStats(&after);
+        if (run == 0 || elapsed < heapBest)
+            heapBest = elapsed;
+
+        heap.allocations = after.allocations - before.allocations;
+        heap.bytesRequested = after.bytesRequested - before.bytesRequested;
+
+        ParserArena arena = NULL;
+        if (!parsed || ParserArena_Create(NULL, &arena) != PARSER_RESULT_SUCCESS) {
+            parsed = false;
+            break;
+        }
+
+        ParserAllocationCallbacks callbacks;
+        ParserArena_GetCallbacks(arena, &callbacks);
+        parsed = TestArenaParse(&callbacks, &elapsed);
+        if (run == 0 || elapsed < arenaBest)
+            arenaBest = elapsed;
+
+        ParserArena_GetStats(arena, &arenaStats);
+        ParserArena_Destroy(arena);
+    }
+
+    remove(TEST_ARENA_SOURCE);
+
+    TEST_CHECK(parsed);
+
+    printf("    %u functions, heap: %.1f ms, %lld allocations, %lld bytes requested\n", TEST_ARENA_BENCH_FUNCTIONS,
+        heapBest, (long long)heap.allocations, (long long)heap.bytesRequested);
+    printf("    arena: %.1f ms, %lld allocations, %lld chunks, %lld bytes peak\n", arenaBest,
+        (long long)arenaStats.allocations, (long long)arenaStats.chunks, (long long)arenaStats.bytesPeak);
+#if !defined(PARSER_DEBUG_ALLOCATORS)
+    printf("    PARSER_DEBUG_ALLOCATORS is not defined, both parses call malloc\n");
+#endif
+}
+
+static const TestCase s_Tests[] = {
+    { "Counters", TestArenaCounters },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchParse", TestArenaBenchParse },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserArena = {
+    "ParserArena", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
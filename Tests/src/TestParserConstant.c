@@ -0,0 +1,241 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_CONSTANT_SOURCE            "CompilerTests_ParserConstant.c"
+#define TEST_CONSTANT_CHAIN             1000u
+
+/* An expression statement and the tree left after folding */
+typedef struct TestConstant_T {
+    const char* source;
+    const char* tree;
+} TestConstant;
+
+static const char s_ConstantDeclarations[] =
+    "enum { A = 1 << 4, B, C = B * 2 };\n"
+    "char buffer[sizeof(int) * 4];\n"
+    "int a;\n"
+    "void t(void)\n"
+    "{\n";
+
+/* Folded values carry the type of the usual arithmetic conversions (LP64), unsigned wraps */
+static const TestConstant s_Folded[] = {
+    { "1 + 2 * 3", "7" },
+    { "1 + 1u", "2u" },
+    { "1 + 1l", "2l" },
+    { "1u + 1l", "2l" },
+    { "1u + 1ll", "2ll" },
+    { "1ul + 1ll", "2ull" },
+    { "4294967295u + 1", "0u" },
+    { "0xffffffff + 1", "0u" },
+    { "0u - 1", "4294967295u" },
+    { "-1 < 1u", "0" },
+    { "-1 < 1l", "1" },
+    { "2147483648", "2147483648l" },
+    { "-2147483647 - 1", "-2147483648" },
+    { "-8 >> 1", "-4" },
+    { "-1 >> 31", "-1" },
+    { "1u << 31", "2147483648u" },
+    { "1 << 30", "1073741824" },
+    { "7 / -2", "-3" },
+    { "-7 % 2", "-1" },
+    { "~0u", "4294967295u" },
+    { "!5 + !0", "1" },
+    { "(unsigned char)300 + 0", "44" },
+    { "(int)4294967295u", "-1" },
+    { "(short)-1 + 0u", "4294967295u" },
+    { "sizeof(int)", "4ul" },
+    { "sizeof buffer", "16ul" },
+    { "'a' + 1", "98" },
+    { "C + 0", "34" },
+    { "(1 + 2) * a", "(* 3 a)" },
+};
+
+/* Operations C leaves undefined keep their operator node, their operands still fold */
+static const TestConstant s_Undefined[] = {
+    { "2147483647 + 1", "(+ 2147483647 1)" },
+    { "-2147483647 - 2", "(- -2147483647 2)" },
+    { "65536 * 65536", "(* 65536 65536)" },
+    { "9223372036854775807l + 1", "(+ 9223372036854775807l 1)" },
+    { "-(-2147483647 - 1)", "(- -2147483648)" },
+    { "1 << 31", "(<< 1 31)" },
+    { "1 << 32", "(<< 1 32)" },
+    { "1u << 32", "(<< 1u 32)" },
+    { "1 >> -1", "(>> 1 -1)" },
+    { "-1 << 1", "(<< -1 1)" },
+    { "1 / 0", "(/ 1 0)" },
+    { "1u % 0u", "(% 1u 0u)" },
+    { "(-2147483647 - 1) / -1", "(/ -2147483648 -1)" },
+    { "(-2147483647 - 1) % -1", "(% -2147483648 -1)" },
+    { "(int)1e10", "(cast type (#39))" },              // Out of the range of int
+};
+
+/* Parse every expression as a statement of one function and compare the folded trees in order */
+static void TestConstantParse(const TestConstant* expressions, uint32_t count)
+{
+    TestText source = { 0 };
+    TestText_Append(&source, "%s", s_ConstantDeclarations);
+    for (uint32_t i = 0; i < count; i++)
+        TestText_Append(&source, "    %s;\n", expressions[i].source);
+    TestText_Append(&source, "}\n");
+
+    bool written = TestWriteFile(TEST_CONSTANT_SOURCE, source.data, source.length);
+    TestText_Free(&source);
+    TEST_CHECK(written);
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_CONSTANT_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+        unit.result == PARSER_RESULT_SUCCESS;
+
+    ASTNodeId statements[32];
+    uint32_t found = parsed ? TestUnit_FindNodes(&unit, AST_NODE_TYPE_EXPRESSION_STMT, statements, 32) : 0;
+
+    bool same = found == count;
+    for (uint32_t i = 0; i < found && same; i++) {
+        TestText tree = { 0 };
+        TestUnit_PrintNode(&unit, ASTTree_GetChild(ASTParser_GetTree(unit.parser), statements[i], 0), &tree);
+
+        same = strcmp(tree.data, expressions[i].tree) == 0;
+        if (!same)
+            printf("    %s: %s, expected %s\n", expressions[i].source, tree.data, expressions[i].tree);
+        TestText_Free(&tree);
+    }
+
+    TestUnit_Destroy(&unit);
+    remove(TEST_CONSTANT_SOURCE);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(same);
+}
+
+static void TestConstantFolded(void)
+{
+    TestConstantParse(s_Folded, TEST_COUNT(s_Folded));
+}
+
+static void TestConstantUndefined(void)
+{
+    TestConstantParse(s_Undefined, TEST_COUNT(s_Undefined));
+}
+
+/* Parse the statement `1 + 2 + ... + count;`, with or without a name in front of the chain */
+static bool TestConstantChain(uint32_t count, bool named, uint32_t* nodes, uint32_t* folded, char* printed,
+    size_t printedSize)
+{
+    TestText source = { 0 };
+    TestText_Append(&source, "int a;\nvoid t(void)\n{\n    %s1", named ? "a + " : "");
+    for (uint32_t i = 2; i <= count; i++)
+        TestText_Append(&source, " + %u", i);
+    TestText_Append(&source, ";\n}\n");
+
+    bool written = TestWriteFile(TEST_CONSTANT_SOURCE, source.data, source.length);
+    TestText_Free(&source);
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    TestUnit unit = { 0 };
+    bool parsed = written && TestUnit_Parse(&unit, TEST_CONSTANT_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+        unit.result == PARSER_RESULT_SUCCESS;
+
+    ASTNodeId statement = AST_NODE_ID_NONE;
+    if (parsed && TestUnit_FindNodes(&unit, AST_NODE_TYPE_EXPRESSION_STMT, &statement, 1) == 1) {
+        ASTParserStats stats = { 0 };
+        ASTParser_GetStats(unit.parser, &stats);
+        *folded = stats.foldedExpressions;
+        *nodes = ASTTree_GetNodeCount(ASTParser_GetTree(unit.parser));
+
+        TestText tree = { 0 };
+        TestUnit_PrintNode(&unit, ASTTree_GetChild(ASTParser_GetTree(unit.parser), statement, 0), &tree);
+        snprintf(printed, printedSize, "%.*s", (int)(printedSize - 1), tree.data ? tree.data : "");
+        TestText_Free(&tree);
+    }
+    else {
+        parsed = false;
+    }
+
+    TestUnit_Destroy(&unit);
+    remove(TEST_CONSTANT_SOURCE);
+
+    return parsed;
+}
+
+/* A constant chain collapses into one literal whose operand nodes are given back, a name in front stops it */
+static void TestConstantReclaim(void)
+{
+    uint32_t shortNodes = 0, longNodes = 0, namedNodes = 0;
+    uint32_t shortFolds = 0, longFolds = 0, namedFolds = 0;
+    char shortTree[64], longTree[64], namedTree[64];
+
+    bool parsed = TestConstantChain(2, false, &shortNodes, &shortFolds, shortTree, sizeof(shortTree)) &&
+        TestConstantChain(TEST_CONSTANT_CHAIN, false, &longNodes, &longFolds, longTree, sizeof(longTree)) &&
+        TestConstantChain(TEST_CONSTANT_CHAIN, true, &namedNodes, &namedFolds, namedTree, sizeof(namedTree));
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(strcmp(shortTree, "3") == 0 && strcmp(longTree, "500500") == 0);
+    TEST_CHECK(shortFolds == 1 && longFolds == TEST_CONSTANT_CHAIN - 1);
+    TEST_CHECK(longNodes == shortNodes);
+
+    // `a + 1 + 2` is `(a + 1) + 2`, no operator has two constant operands
+    TEST_CHECK(namedFolds == 0 && strncmp(namedTree, "(+ (+ (+ ", 9) == 0);
+    TEST_CHECK(namedNodes >= longNodes + 2 * TEST_CONSTANT_CHAIN);
+}
+
+/* A static assertion whose condition folds to zero fails the parse */
+static void TestConstantStaticAssert(void)
+{
+    static const char* const sources[] = {
+        "_Static_assert(sizeof(long) == 8 && (-1 >> 1) == -1, \"lp64\");\n",
+        "_Static_assert(1u - 2 > 0 && 0u - 1 < 0, \"wraps\");\n",
+    };
+
+    ParserResult results[2] = { PARSER_RESULT_SUCCESS, PARSER_RESULT_SUCCESS };
+    bool parsed = true;
+
+    for (uint32_t i = 0; i < 2 && parsed; i++) {
+        parsed = TestWriteFile(TEST_CONSTANT_SOURCE, sources[i], strlen(sources[i]));
+
+        ASTParserCreateConfig config = { 0 };
+        config.strategy = &g_CLanguageStrategy;
+
+        TestUnit unit = { 0 };
+        parsed = parsed && TestUnit_Parse(&unit, TEST_CONSTANT_SOURCE, &config, TEST_BODIES_SKIPPED);
+        results[i] = unit.result;
+
+        TestUnit_Destroy(&unit);
+        remove(TEST_CONSTANT_SOURCE);
+    }
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(results[0] == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(results[1] == PARSER_ERROR_STATIC_ASSERTION);
+}
+
+static const TestCase s_Tests[] = {
+    { "Folded", TestConstantFolded },
+    { "Undefined", TestConstantUndefined },
+    { "Reclaim", TestConstantReclaim },
+    { "StaticAssert", TestConstantStaticAssert },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserConstant = {
+    "ParserConstant", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
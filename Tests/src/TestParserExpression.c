@@ -0,0 +1,130 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_EXPRESSION_SOURCE          "CompilerTests_ParserExpression.c"
+
+/* An expression statement and the tree the parser has to build for it */
+typedef struct TestExpression_T {
+    const char* source;
+    const char* tree;
+} TestExpression;
+
+static const char s_ExpressionDeclarations[] =
+    "int a, b, c, d, e, *p, v[4];\n"
+    "int f(int x, int y);\n"
+    "void t(void)\n"
+    "{\n";
+
+/* Operands are names, constants would be folded into one literal */
+static const TestExpression s_Precedence[] = {
+    { "a * b + c", "(+ (* a b) c)" },
+    { "a + b * c", "(+ a (* b c))" },
+    { "a + b * c - d / e % a", "(- (+ a (* b c)) (% (/ d e) a))" },
+    { "a << b + c < d", "(< (<< a (+ b c)) d)" },
+    { "a < b == c > d", "(== (< a b) (> c d))" },
+    { "a & b ^ c | d", "(| (^ (& a b) c) d)" },
+    { "a | b && c || d && e", "(|| (&& (| a b) c) (&& d e))" },
+    { "a == b & c", "(& (== a b) c)" },
+    { "(a + b) * c", "(* (+ a b) c)" },
+    { "-a * b", "(* (- a) b)" },
+    { "!a && ~b", "(&& (! a) (~ b))" },
+    { "*p++", "(* (x++ p))" },
+    { "-a++ - --b", "(- (- (x++ a)) (--x b))" },
+    { "v[a + 1] * f(a, b + c)", "(* ([] v (+ a 1)) (call f a (+ b c)))" },
+    { "a = b + c * d", "(= a (+ b (* c d)))" },
+};
+
+/* Binary operators group to the left, assignments and conditionals to the right */
+static const TestExpression s_Associativity[] = {
+    { "a - b - c", "(- (- a b) c)" },
+    { "a / b / c", "(/ (/ a b) c)" },
+    { "a << b << c", "(<< (<< a b) c)" },
+    { "a = b = c", "(= a (= b c))" },
+    { "a += b -= c *= d", "(+= a (-= b (*= c d)))" },
+    { "a <<= b |= c", "(<<= a (|= b c))" },
+    { "a ? b : c ? d : e", "(? a b (? c d e))" },
+    { "a ? b ? c : d : e", "(? a (? b c d) e)" },
+    { "a = b ? c : d", "(= a (? b c d))" },
+    { "a || b ? c : d", "(? (|| a b) c d)" },
+    { "a ? b, c : d", "(? a (, b c) d)" },
+    { "a ? b : c = d", "(= (? a b c) d)" },          // The else operand is a conditional in C, not in C++
+    { "a = b, c = d", "(, (= a b) (= c d))" },
+    { "a, b, c", "(, a b c)" },
+};
+
+/* Parse every expression as a statement of one function and compare the trees in order */
+static void TestExpressionParse(const TestExpression* expressions, uint32_t count)
+{
+    TestText source = { 0 };
+    TestText_Append(&source, "%s", s_ExpressionDeclarations);
+    for (uint32_t i = 0; i < count; i++)
+        TestText_Append(&source, "    %s;\n", expressions[i].source);
+    TestText_Append(&source, "}\n");
+
+    bool written = TestWriteFile(TEST_EXPRESSION_SOURCE, source.data, source.length);
+    TestText_Free(&source);
+    TEST_CHECK(written);
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_EXPRESSION_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+        unit.result == PARSER_RESULT_SUCCESS;
+
+    // Statements are built after their expression, in source order
+    ASTNodeId statements[32];
+    uint32_t found = parsed ? TestUnit_FindNodes(&unit, AST_NODE_TYPE_EXPRESSION_STMT, statements, 32) : 0;
+
+    bool same = found == count;
+    for (uint32_t i = 0; i < found && same; i++) {
+        TestText tree = { 0 };
+        TestUnit_PrintNode(&unit, ASTTree_GetChild(ASTParser_GetTree(unit.parser), statements[i], 0), &tree);
+
+        same = strcmp(tree.data, expressions[i].tree) == 0;
+        if (!same)
+            printf("    %s: %s, expected %s\n", expressions[i].source, tree.data, expressions[i].tree);
+        TestText_Free(&tree);
+    }
+
+    TestUnit_Destroy(&unit);
+    remove(TEST_EXPRESSION_SOURCE);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(same);
+}
+
+static void TestExpressionPrecedence(void)
+{
+    TestExpressionParse(s_Precedence, TEST_COUNT(s_Precedence));
+}
+
+static void TestExpressionAssociativity(void)
+{
+    TestExpressionParse(s_Associativity, TEST_COUNT(s_Associativity));
+}
+
+static const TestCase s_Tests[] = {
+    { "Precedence", TestExpressionPrecedence },
+    { "Associativity", TestExpressionAssociativity },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserExpression = {
+    "ParserExpression", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
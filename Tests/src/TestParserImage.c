@@ -0,0 +1,449 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/ParserImage.h"
+#include "parser/lexer/LexerInternal.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_IMAGE_SOURCE               "CompilerTests_ParserImage.c"
+#define TEST_IMAGE_FILE                 "CompilerTests_ParserImage.img"
+#define TEST_IMAGE_BENCH_FUNCTIONS      20000u
+#define TEST_IMAGE_BENCH_RUNS           5u
+
+/* Write a generated C file and parse it, eager with its tokens kept or with lazy bodies parsed after */
+static bool TestImageParse(TestUnit* unit, uint32_t functions, bool lazy)
+{
+    memset(unit, 0, sizeof(TestUnit));
+
+    TestText text = { 0 };
+    TestGenerateC(&text, functions, functions + 1);
+    bool written = TestWriteFile(TEST_IMAGE_SOURCE, text.data, text.length);
+    TestText_Free(&text);
+    if (!written)
+        return false;
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+    config.lazyFunctionBodies = lazy;
+    config.keepTokens = !lazy;
+
+    return TestUnit_Parse(unit, TEST_IMAGE_SOURCE, &config, 2) && unit->result == PARSER_RESULT_SUCCESS;
+}
+
+/* Image of a unit in memory from malloc, aligned enough for AST_IMAGE_ALIGNMENT */
+static void* TestImageWrite(const TestUnit* unit, size_t* size)
+{
+    if (ASTParser_WriteImage(unit->parser, unit->root, NULL, 0, size) != PARSER_RESULT_SUCCESS)
+        return NULL;
+
+    void* buffer = malloc(*size);
+    if (buffer && ASTParser_WriteImage(unit->parser, unit->root, buffer, *size, size) != PARSER_RESULT_SUCCESS) {
+        free(buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+/* Compare an opened image with the unit it was written from */
+static void TestImageCompare(const TestUnit* unit, const ASTImage* image)
+{
+    ASTTree tree = ASTParser_GetTree(unit->parser);
+    uint32_t nodeCount = ASTTree_GetNodeCount(tree);
+    TEST_CHECK(image->tree.nodeCount == nodeCount);
+    TEST_CHECK(image->root == AST_NODE_TO_ID(unit->root));
+
+    for (ASTNodeId node = 1; node < nodeCount; node++) {
+        ParserASTNodeType type = ASTTree_GetNodeType(tree, node);
+        ASTNodeData data = ASTTree_GetData(tree, node);
+        TEST_CHECK(image->tree.types[node] == type);
+        TEST_CHECK(image->tree.subtypes[node] == ASTTree_GetSubtype(tree, node));
+        TEST_CHECK(image->tree.mainTokens[node] == ASTTree_GetMainToken(tree, node));
+        TEST_CHECK(image->tree.data[node].lhs == data.lhs && image->tree.data[node].rhs == data.rhs);
+
+        uint32_t childCount = ASTTree_GetChildCount(tree, node);
+        TEST_CHECK(ASTTreeView_GetChildCount(&image->tree, node) == childCount);
+        for (uint32_t i = 0; i < childCount; i++)
+            TEST_CHECK(ASTTreeView_GetChild(&image->tree, node, i) == ASTTree_GetChild(tree, node, i));
+
+        const struct LexerToken_T* token = LexerRingAt(unit->lexer, ASTTree_GetMainToken(tree, node));
+        ASTImageLocation location = ASTImage_GetLocation(image, node);
+        TEST_CHECK(location.line == token->line && location.column == token->column);
+
+        uint32_t length;
+        const char* spelling = ASTImage_GetSpelling(image, node, &length);
+        if (type == AST_NODE_TYPE_CHAR_LITERAL) {
+            TEST_CHECK(spelling && length == token->length && memcmp(spelling, token->lexeme, length) == 0);
+            TEST_CHECK(spelling[length] == '\0');
+        } else if (type == AST_NODE_TYPE_STRING_LITERAL) {
+            TEST_CHECK(spelling && length >= 2 && spelling[0] == '"' && spelling[length - 1] == '"');
+            TEST_CHECK(spelling[length] == '\0');
+        } else {
+            TEST_CHECK(!spelling);
+        }
+
+        if ((type == AST_NODE_TYPE_INTEGER_LITERAL || type == AST_NODE_TYPE_FLOAT_LITERAL) &&
+            ASTTree_GetSubtype(tree, node) == 0) {
+            const LexerLiteral* literal = ASTImage_GetLiteral(image, data.lhs);
+            TEST_CHECK(literal && memcmp(literal, &unit->lexer->literals.items[data.lhs], sizeof(LexerLiteral)) == 0);
+        }
+    }
+
+    ParserInterner interner = ASTParser_GetInterner(unit->parser);
+    uint32_t identifierCount = ParserInterner_GetCount(interner);
+    for (ParserIdentifierId id = 1; id <= identifierCount; id++) {
+        const ParserIdentifier* identifier = ParserInterner_Get(interner, id);
+        uint32_t length;
+        const char* text = ASTImage_GetIdentifier(image, id, &length);
+        TEST_CHECK(text && length == identifier->length && memcmp(text, identifier->text, length) == 0);
+        TEST_CHECK(text[length] == '\0');
+    }
+    TEST_CHECK(!ASTImage_GetIdentifier(image, PARSER_IDENTIFIER_NONE, NULL));
+    TEST_CHECK(!ASTImage_GetIdentifier(image, identifierCount + 1, NULL));
+
+    ASTSymbolTable symbols = ASTParser_GetSymbolTable(unit->parser);
+    uint32_t symbolCount = ASTSymbolTable_GetSymbolCount(symbols);
+    for (ASTSymbolId id = 1; id <= symbolCount; id++) {
+        const ASTSymbolInfo* symbol = ASTImage_GetSymbol(image, id);
+        TEST_CHECK(symbol && memcmp(symbol, ASTSymbolTable_GetSymbol(symbols, id), sizeof(ASTSymbolInfo)) == 0);
+    }
+    TEST_CHECK(!ASTImage_GetSymbol(image, symbolCount + 1));
+
+    ASTTypeTable types = ASTParser_GetTypeTable(unit->parser);
+    uint32_t typeCount = ASTTypeTable_GetTypeCount(types);
+    for (ASTTypeId id = 1; id <= typeCount; id++) {
+        const ASTTypeInfo* expected = ASTTypeTable_Get(types, id);
+        const ASTTypeInfo* type = ASTImage_GetType(image, id);
+        TEST_CHECK(type && type->kind == expected->kind && type->base == expected->base);
+        TEST_CHECK(type->count == expected->count && type->unqualified == expected->unqualified);
+        TEST_CHECK(type->hash == expected->hash && type->qualifiers == expected->qualifiers);
+        TEST_CHECK(type->flags == expected->flags);
+
+        // The value of a function type is the offset of its parameters, which differs in the image
+        if (type->kind != AST_TYPE_KIND_FUNCTION)
+            TEST_CHECK(type->value == expected->value);
+
+        const ASTTypeId* params = ASTTypeTable_GetParams(types, id);
+        const ASTTypeId* imageParams = ASTImage_GetTypeParams(image, id);
+        TEST_CHECK((!params && !imageParams) ||
+            (params && imageParams && memcmp(params, imageParams, sizeof(ASTTypeId) * type->count) == 0));
+    }
+}
+
+/* Write a unit, reopen its image in memory and compare it with the unit */
+static void TestImageCheckUnit(const TestUnit* unit)
+{
+    size_t size = 0;
+    void* buffer = TestImageWrite(unit, &size);
+    TEST_CHECK(buffer);
+
+    size_t written = 0;
+    bool shortRejected = ASTParser_WriteImage(unit->parser, unit->root, buffer, size - 1, &written) ==
+        PARSER_ERROR_INVALID_ARG;
+
+    ASTImage image;
+    bool opened = ASTImage_Open(buffer, size, &image) == PARSER_RESULT_SUCCESS;
+    if (opened)
+        TestImageCompare(unit, &image);
+
+    free(buffer);
+    TEST_CHECK(shortRejected);
+    TEST_CHECK(opened);
+}
+
+static void TestImageRoundTrip(uint32_t functions, bool lazy)
+{
+    TestUnit unit;
+    if (TestImageParse(&unit, functions, lazy))
+        TestImageCheckUnit(&unit);
+    else
+        TestFail(__FILE__, __LINE__, "TestImageParse(&unit, functions, lazy)");
+
+    TestUnit_Destroy(&unit);
+    remove(TEST_IMAGE_SOURCE);
+}
+
+static void TestImageEmpty(void)
+{
+    TestImageRoundTrip(0, false);
+}
+
+static void TestImageEager(void)
+{
+    TestImageRoundTrip(1, false);
+    TestImageRoundTrip(5, false);
+    TestImageRoundTrip(200, false);
+}
+
+static void TestImageLazy(void)
+{
+    TestImageRoundTrip(1, true);
+    TestImageRoundTrip(5, true);
+    TestImageRoundTrip(200, true);
+}
+
+/* An image saved to a file and mapped back is the same image */
+static void TestImageFile(void)
+{
+    TestUnit unit;
+    bool parsed = TestImageParse(&unit, 40, false);
+    size_t size = 0;
+    void* buffer = parsed ? TestImageWrite(&unit, &size) : NULL;
+    bool saved = buffer && TestWriteFile(TEST_IMAGE_FILE, buffer, size);
+    free(buffer);
+
+    FileBuffer file = NULL;
+    FileBufferConfig config = { 0 };
+    config.fileName = TEST_IMAGE_FILE;
+    config.filePath = TEST_IMAGE_FILE;
+    if (saved && CreateFileBuffer(&config, &file) != PARSER_RESULT_SUCCESS)
+        file = NULL;
+
+    if (file) {
+        const FileBufferCursor* cursor = GetFileBufferCursor(file);
+        ASTImage image;
+        if (ASTImage_Open(cursor->begin, (size_t)(cursor->end - cursor->begin), &image) == PARSER_RESULT_SUCCESS)
+            TestImageCompare(&unit, &image);
+        else
+            TestFail(__FILE__, __LINE__, "ASTImage_Open of the mapped file");
+
+        DestroyFileBuffer(file);
+    } else {
+        TestFail(__FILE__, __LINE__, "parsed && saved && mapped");
+    }
+
+    TestUnit_Destroy(&unit);
+    remove(TEST_IMAGE_FILE);
+    remove(TEST_IMAGE_SOURCE);
+}
+
+/* Truncated, misaligned and damaged images are refused */
+static void TestImageCorrupt(void)
+{
+    TestUnit unit;
+    bool parsed = TestImageParse(&unit, 20, false);
+    size_t size = 0;
+    uint8_t* buffer = parsed ? TestImageWrite(&unit, &size) : NULL;
+    TestUnit_Destroy(&unit);
+    remove(TEST_IMAGE_SOURCE);
+    TEST_CHECK(buffer);
+
+    ASTImage image;
+    ASTImageHeader* header = (ASTImageHeader*)buffer;
+    bool rejected = ASTImage_Open(buffer, size - 1, &image) == PARSER_ERROR_INVALID_FILE &&
+        ASTImage_Open(buffer, sizeof(ASTImageHeader) - 1, &image) == PARSER_ERROR_INVALID_FILE &&
+        ASTImage_Open(buffer + AST_IMAGE_ALIGNMENT, size - AST_IMAGE_ALIGNMENT, &image) == PARSER_ERROR_INVALID_FILE;
+
+    header->sections[AST_IMAGE_SECTION_EXTRA].count += 0x40000000u;
+    rejected = rejected && ASTImage_Open(buffer, size, &image) == PARSER_ERROR_INVALID_FILE;
+    header->sections[AST_IMAGE_SECTION_EXTRA].count -= 0x40000000u;
+
+    header->magic ^= 1u;
+    rejected = rejected && ASTImage_Open(buffer, size, &image) == PARSER_ERROR_INVALID_FILE;
+    header->magic ^= 1u;
+
+    header->version++;
+    rejected = rejected && ASTImage_Open(buffer, size, &image) == PARSER_ERROR_INVALID_FILE;
+    header->version--;
+
+    bool reopened = ASTImage_Open(buffer, size, &image) == PARSER_RESULT_SUCCESS;
+    free(buffer);
+
+    TEST_CHECK(rejected);
+    TEST_CHECK(reopened);
+}
+
+/* Fill the stack below the caller with `pattern`, for what a parse leaves uninitialized to differ */
+static void TestImageDirtyStack(uint8_t pattern)
+{
+    volatile uint8_t stack[64 * 1024];
+    for (size_t i = 0; i < sizeof(stack); i++)
+        stack[i] = pattern;
+}
+
+/* Literals are written as they are, the bytes after their last field must be zero */
+static bool TestImageLiteralPaddingClear(const TestUnit* unit)
+{
+    const size_t used = offsetof(LexerLiteral, base) + sizeof(uint16_t);
+
+    for (uint32_t i = 0; i < unit->lexer->literals.count; i++) {
+        const uint8_t* bytes = (const uint8_t*)&unit->lexer->literals.items[i];
+        for (size_t b = used; b < sizeof(LexerLiteral); b++) {
+            if (bytes[b] != 0)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/* Image of a fresh parse after the stack was dirtied with `pattern`, NULL when a literal carried stack bytes */
+static void* TestImageWriteFresh(uint8_t pattern, size_t* size)
+{
+    TestImageDirtyStack(pattern);
+
+    TestUnit unit;
+    bool parsed = TestImageParse(&unit, 60, false) && TestImageLiteralPaddingClear(&unit);
+    void* buffer = parsed ? TestImageWrite(&unit, size) : NULL;
+    TestUnit_Destroy(&unit);
+    remove(TEST_IMAGE_SOURCE);
+
+    return buffer;
+}
+
+/* Two parses of the same source write the same bytes, padding included */
+static void TestImageDeterministic(void)
+{
+    size_t sizeA = 0;
+    size_t sizeB = 0;
+    void* a = TestImageWriteFresh(0x00, &sizeA);
+    void* b = TestImageWriteFresh(0xA5, &sizeB);
+    bool written = a && b;
+    bool same = written && sizeA == sizeB && memcmp(a, b, sizeA) == 0;
+    free(a);
+    free(b);
+
+    TEST_CHECK(written);
+    TEST_CHECK(same);
+}
+
+/* A parser that dropped its tokens cannot write an image */
+static void TestImageNoTokens(void)
+{
+    TestText text = { 0 };
+    TestGenerateC(&text, 3, 1);
+    bool written = TestWriteFile(TEST_IMAGE_SOURCE, text.data, text.length);
+    TestText_Free(&text);
+    TEST_CHECK(written);
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_IMAGE_SOURCE, &config, 0) && unit.result == PARSER_RESULT_SUCCESS;
+    size_t size = 0;
+    ParserResult result = parsed ? ASTParser_WriteImage(unit.parser, unit.root, NULL, 0, &size) : PARSER_RESULT_SUCCESS;
+    TestUnit_Destroy(&unit);
+    remove(TEST_IMAGE_SOURCE);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(result == PARSER_ERROR_INVALID_ARG);
+}
+
+/* Open an image mapped from disk against parsing its source again, lexing included */
+static void TestImageBenchOpen(void)
+{
+    TestText text = { 0 };
+    TestGenerateC(&text, TEST_IMAGE_BENCH_FUNCTIONS, 7);
+    bool written = TestWriteFile(TEST_IMAGE_SOURCE, text.data, text.length);
+    size_t sourceSize = text.length;
+    TestText_Free(&text);
+    TEST_CHECK(written);
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+    config.keepTokens = true;
+
+    double parseTime = 0.0;
+    size_t size = 0;
+    uint32_t nodeCount = 0;
+    for (uint32_t run = 0; run < TEST_IMAGE_BENCH_RUNS; run++) {
+        TestUnit unit;
+        double start = TestNow();
+        bool parsed = TestUnit_Parse(&unit, TEST_IMAGE_SOURCE, &config, 0) && unit.result == PARSER_RESULT_SUCCESS;
+        double elapsed = TestNow() - start;
+        if (!parsed) {
+            TestUnit_Destroy(&unit);
+            remove(TEST_IMAGE_SOURCE);
+            TEST_CHECK(parsed);
+        }
+
+        if (run == 0 || elapsed < parseTime)
+            parseTime = elapsed;
+
+        if (run == 0) {
+            void* buffer = TestImageWrite(&unit, &size);
+            nodeCount = ASTTree_GetNodeCount(ASTParser_GetTree(unit.parser));
+            written = buffer && TestWriteFile(TEST_IMAGE_FILE, buffer, size);
+            free(buffer);
+        }
+
+        TestUnit_Destroy(&unit);
+    }
+    remove(TEST_IMAGE_SOURCE);
+    TEST_CHECK(written);
+
+    // Mapping is lazy, reading every node once after opening shows the cost of first use as well
+    double openTime = 0.0;
+    double readTime = 0.0;
+    uint64_t checksum = 0;
+    bool opened = true;
+    for (uint32_t run = 0; run < TEST_IMAGE_BENCH_RUNS && opened; run++) {
+        FileBufferConfig fileConfig = { 0 };
+        fileConfig.fileName = TEST_IMAGE_FILE;
+        fileConfig.filePath = TEST_IMAGE_FILE;
+
+        double start = TestNow();
+        FileBuffer file;
+        opened = CreateFileBuffer(&fileConfig, &file) == PARSER_RESULT_SUCCESS;
+        if (!opened)
+            break;
+
+        const FileBufferCursor* cursor = GetFileBufferCursor(file);
+        ASTImage image;
+        opened = ASTImage_Open(cursor->begin, (size_t)(cursor->end - cursor->begin), &image) == PARSER_RESULT_SUCCESS;
+        double elapsed = TestNow() - start;
+
+        for (uint32_t node = 1; opened && node < image.tree.nodeCount; node++)
+            checksum += image.tree.types[node] + image.tree.data[node].lhs + image.tree.mainTokens[node];
+        double read = TestNow() - start;
+        DestroyFileBuffer(file);
+
+        if (run == 0 || elapsed < openTime)
+            openTime = elapsed;
+        if (run == 0 || read < readTime)
+            readTime = read;
+    }
+    remove(TEST_IMAGE_FILE);
+    TEST_CHECK(opened);
+
+    printf("    %u functions, %zu source bytes, %u nodes, %zu image bytes\n", TEST_IMAGE_BENCH_FUNCTIONS,
+        sourceSize, nodeCount, size);
+    printf("    parse %.3f ms, map and open image %.3f ms, and read every node %.3f ms (checksum %llu)\n",
+        parseTime * 1e3, openTime * 1e3, readTime * 1e3, (unsigned long long)checksum);
+}
+
+static const TestCase s_Tests[] = {
+    { "Empty", TestImageEmpty },
+    { "Eager", TestImageEager },
+    { "Lazy", TestImageLazy },
+    { "File", TestImageFile },
+    { "Corrupt", TestImageCorrupt },
+    { "Deterministic", TestImageDeterministic },
+    { "NoTokens", TestImageNoTokens },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchOpen", TestImageBenchOpen },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserImage = {
+    "ParserImage", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
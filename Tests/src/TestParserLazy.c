@@ -0,0 +1,272 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_LAZY_SOURCE                "CompilerTests_ParserLazy.c"
+#define TEST_LAZY_BENCH_FUNCTIONS       20000u
+#define TEST_LAZY_BENCH_RUNS            3u
+
+static const char s_LazySource[] =
+    "int counter;\n"
+    "int twice(int n);\n"
+    "int first(int n)\n"
+    "{\n"
+    "    if (n > 0) { counter += n; return first(n - 1); }\n"
+    "    int int;\n"
+    "    return 0;\n"
+    "}\n"
+    "int second(int n)\n"
+    "{\n"
+    "    int i, sum = 0;\n"
+    "    for (i = 0; i < n; i++) { sum = sum + later * i; }\n"
+    "    return sum ? sum : twice(n);\n"
+    "}\n"
+    "int later;\n"
+    "int twice(int n) { return n * 2; }\n";
+
+/* The last FUNCTION_DECL at file scope named `name`, its definition when it has one */
+static ASTNodeId TestLazyFunction(const TestUnit* unit, const char* name)
+{
+    ASTTree tree = ASTParser_GetTree(unit->parser);
+    ParserInterner interner = ASTParser_GetInterner(unit->parser);
+    ASTSymbolTable symbols = ASTParser_GetSymbolTable(unit->parser);
+    ASTNodeId root = AST_NODE_TO_ID(unit->root);
+    uint32_t childCount = ASTTree_GetChildCount(tree, root);
+
+    ASTNodeId found = AST_NODE_ID_NONE;
+    for (uint32_t i = 0; i < childCount; i++) {
+        ASTNodeId child = ASTTree_GetChild(tree, root, i);
+        if (ASTTree_GetNodeType(tree, child) != AST_NODE_TYPE_FUNCTION_DECL)
+            continue;
+
+        const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(symbols, ASTTree_GetData(tree, child).rhs);
+        if (symbol && strcmp(ParserInterner_Get(interner, symbol->name)->text, name) == 0)
+            found = child;
+    }
+
+    return found;
+}
+
+/* The definitions of the source in order */
+static uint32_t TestLazyDefinitions(const TestUnit* unit, ASTNodeId* functions)
+{
+    static const char* const names[] = { "first", "second", "twice" };
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < TEST_COUNT(names); i++) {
+        functions[i] = TestLazyFunction(unit, names[i]);
+        count += functions[i] != AST_NODE_ID_NONE;
+    }
+
+    return count;
+}
+
+static bool TestLazyParse(TestUnit* unit, bool lazy)
+{
+    if (!TestWriteFile(TEST_LAZY_SOURCE, s_LazySource, sizeof(s_LazySource) - 1))
+        return false;
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+    config.lazyFunctionBodies = lazy;
+
+    bool parsed = TestUnit_Parse(unit, TEST_LAZY_SOURCE, &config, TEST_BODIES_SKIPPED);
+    remove(TEST_LAZY_SOURCE);
+
+    return parsed;
+}
+
+/* Top-level parsing only brace matches the bodies: no statements, and a broken body goes unnoticed */
+static void TestLazyDeferred(void)
+{
+    TestUnit unit;
+    bool parsed = TestLazyParse(&unit, true) && unit.result == PARSER_RESULT_SUCCESS;
+
+    ASTParserStats stats = { 0 };
+    ASTNodeId functions[3];
+    uint32_t count = 0;
+    uint32_t statements = 0;
+    bool bodiesAbsent = parsed;
+
+    if (parsed) {
+        ASTParser_GetStats(unit.parser, &stats);
+        count = TestLazyDefinitions(&unit, functions);
+        statements = TestUnit_FindNodes(&unit, AST_NODE_TYPE_RETURN_STMT, NULL, 0) +
+            TestUnit_FindNodes(&unit, AST_NODE_TYPE_COMPOUND_STMT, NULL, 0);
+
+        for (uint32_t i = 0; i < count; i++)
+            bodiesAbsent = bodiesAbsent && ASTTree_GetChild(ASTParser_GetTree(unit.parser), functions[i], 1) ==
+                AST_NODE_ID_NONE;
+    }
+
+    TestUnit_Destroy(&unit);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(stats.functionDefinitions == 3 && stats.skippedBodies == 3 && stats.parsedBodies == 0);
+    TEST_CHECK(count == 3 && bodiesAbsent);
+    TEST_CHECK(statements == 0);
+}
+
+/* A body asked for is parsed once, as the eager parse builds it, and sees names declared after it */
+static void TestLazyOnDemand(void)
+{
+    TestUnit eager, lazy;
+    bool parsed = TestLazyParse(&lazy, true) && lazy.result == PARSER_RESULT_SUCCESS;
+
+    ASTNodeId functions[3];
+    uint32_t count = parsed ? TestLazyDefinitions(&lazy, functions) : 0;
+
+    ASTNode body = NULL, again = NULL;
+    ParserResult result = count == 3 ? ASTParser_ParseFunctionBody(lazy.parser, AST_NODE_FROM_ID(functions[1]), &body) :
+        PARSER_ERROR_INVALID_ARG;
+    ParserResult repeated = count == 3 ?
+        ASTParser_ParseFunctionBody(lazy.parser, AST_NODE_FROM_ID(functions[1]), &again) : PARSER_ERROR_INVALID_ARG;
+
+    ASTParserStats stats = { 0 };
+    TestText lazyBody = { 0 };
+    bool attached = false;
+    if (result == PARSER_RESULT_SUCCESS) {
+        ASTParser_GetStats(lazy.parser, &stats);
+        TestUnit_PrintNode(&lazy, AST_NODE_TO_ID(body), &lazyBody);
+        attached = ASTTree_GetChild(ASTParser_GetTree(lazy.parser), functions[1], 1) == AST_NODE_TO_ID(body);
+    }
+
+    // `later` is declared after the function, the body still refers to it
+    bool resolved = false;
+    if (result == PARSER_RESULT_SUCCESS) {
+        ASTNodeId names[64];
+        uint32_t nameCount = TestUnit_FindNodes(&lazy, AST_NODE_TYPE_IDENTIFIER, names, 64);
+        ParserInterner interner = ASTParser_GetInterner(lazy.parser);
+        ASTSymbolTable symbols = ASTParser_GetSymbolTable(lazy.parser);
+
+        for (uint32_t i = 0; i < nameCount && i < 64; i++) {
+            ASTNodeData data = ASTTree_GetData(ASTParser_GetTree(lazy.parser), names[i]);
+            const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(symbols, data.rhs);
+            if (strcmp(ParserInterner_Get(interner, data.lhs)->text, "later") == 0)
+                resolved = symbol && symbol->scope == 0 && symbol->kind == AST_SYMBOL_KIND_VARIABLE;
+        }
+    }
+    TestUnit_Destroy(&lazy);
+
+    // The eager parse of the same text stops at the broken body, which comes first
+    bool eagerParsed = TestLazyParse(&eager, false);
+    ParserResult eagerResult = eager.result;
+    TestUnit_Destroy(&eager);
+
+    TestText expected = { 0 };
+    TestText_Append(&expected, "(#13 (#3 _) (#3 0) (#19 (= i 0) (< i n) (x++ i) (#13 (#14 (= sum (+ sum (* later i)))))) "
+        "(#15 (? sum sum (call twice n))))");
+    bool same = lazyBody.length == expected.length && memcmp(lazyBody.data, expected.data, expected.length) == 0;
+    if (!same)
+        printf("    %s\n", lazyBody.data ? lazyBody.data : "");
+
+    TestText_Free(&lazyBody);
+    TestText_Free(&expected);
+
+    TEST_CHECK(parsed && count == 3);
+    TEST_CHECK(result == PARSER_RESULT_SUCCESS && repeated == PARSER_RESULT_SUCCESS && again == body);
+    TEST_CHECK(attached && stats.skippedBodies == 3 && stats.parsedBodies == 1);
+    TEST_CHECK(same);
+    TEST_CHECK(resolved);
+    TEST_CHECK(eagerParsed && eagerResult != PARSER_RESULT_SUCCESS);
+}
+
+/* The error of a broken body comes when the body is asked for, and only for that body */
+static void TestLazyError(void)
+{
+    TestUnit unit;
+    bool parsed = TestLazyParse(&unit, true) && unit.result == PARSER_RESULT_SUCCESS;
+
+    ASTNodeId functions[3];
+    uint32_t count = parsed ? TestLazyDefinitions(&unit, functions) : 0;
+
+    ASTNode body = NULL;
+    ParserResult broken = count == 3 ?
+        ASTParser_ParseFunctionBody(unit.parser, AST_NODE_FROM_ID(functions[0]), &body) : PARSER_RESULT_SUCCESS;
+    ParserResult last = count == 3 ?
+        ASTParser_ParseFunctionBody(unit.parser, AST_NODE_FROM_ID(functions[2]), &body) : PARSER_ERROR_INVALID_ARG;
+
+    // A prototype has no body to parse, the second child of the unit is the one of `twice`
+    ASTNodeId root = AST_NODE_TO_ID(unit.root);
+    ASTNodeId declaration = parsed ? ASTTree_GetChild(ASTParser_GetTree(unit.parser), root, 1) : AST_NODE_ID_NONE;
+    ParserResult prototype = parsed ?
+        ASTParser_ParseFunctionBody(unit.parser, AST_NODE_FROM_ID(declaration), &body) : PARSER_RESULT_SUCCESS;
+
+    TestUnit_Destroy(&unit);
+
+    TEST_CHECK(parsed && count == 3);
+    TEST_CHECK(broken != PARSER_RESULT_SUCCESS && broken != PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(last == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(prototype == PARSER_ERROR_INVALID_ARG);
+}
+
+/* Front-end time of a unit whose bodies are all skipped against parsing them */
+static void TestLazyBenchSkip(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, TEST_LAZY_BENCH_FUNCTIONS, 13);
+    bool written = TestWriteFile(TEST_LAZY_SOURCE, source.data, source.length);
+    TestText_Free(&source);
+    TEST_CHECK(written);
+
+    double best[2] = { 0.0, 0.0 };
+    uint32_t nodes[2] = { 0, 0 };
+    bool parsed = true;
+
+    for (uint32_t run = 0; run < TEST_LAZY_BENCH_RUNS && parsed; run++) {
+        for (uint32_t lazy = 0; lazy < 2 && parsed; lazy++) {
+            ASTParserCreateConfig config = { 0 };
+            config.strategy = &g_CLanguageStrategy;
+            config.lazyFunctionBodies = lazy != 0;
+
+            double start = TestNow();
+            TestUnit unit;
+            parsed = TestUnit_Parse(&unit, TEST_LAZY_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+                unit.result == PARSER_RESULT_SUCCESS;
+            double elapsed = (TestNow() - start) * 1000.0;
+
+            if (parsed)
+                nodes[lazy] = ASTTree_GetNodeCount(ASTParser_GetTree(unit.parser));
+            TestUnit_Destroy(&unit);
+
+            if (run == 0 || elapsed < best[lazy])
+                best[lazy] = elapsed;
+        }
+    }
+
+    remove(TEST_LAZY_SOURCE);
+
+    TEST_CHECK(parsed);
+
+    printf("    %u functions, eager: %.1f ms, %u nodes, lazy: %.1f ms, %u nodes\n", TEST_LAZY_BENCH_FUNCTIONS,
+        best[0], nodes[0], best[1], nodes[1]);
+}
+
+static const TestCase s_Tests[] = {
+    { "Deferred", TestLazyDeferred },
+    { "OnDemand", TestLazyOnDemand },
+    { "Error", TestLazyError },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchSkip", TestLazyBenchSkip },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserLazy = {
+    "ParserLazy", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,276 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_BODIES_SOURCE              "CompilerTests_ParserParallel.c"
+#define TEST_BODIES_BENCH_FUNCTIONS     20000u
+#define TEST_BODIES_BENCH_RUNS          3u
+
+/* Everything the body parse adds to a unit as text: nodes, symbols, types and the error */
+static void TestBodiesDump(const TestUnit* unit, TestText* text)
+{
+    ASTTree tree = ASTParser_GetTree(unit->parser);
+    uint32_t nodeCount = ASTTree_GetNodeCount(tree);
+    TestText_Append(text, "result %d nodes %u\n", (int)unit->result, nodeCount);
+
+    for (ASTNodeId node = 1; node < nodeCount; node++) {
+        ASTNodeData data = ASTTree_GetData(tree, node);
+        TestText_Append(text, "%u: %u.%u @%u %u %u [", node, (uint32_t)ASTTree_GetNodeType(tree, node),
+            (uint32_t)ASTTree_GetSubtype(tree, node), ASTTree_GetMainToken(tree, node), data.lhs, data.rhs);
+
+        uint32_t childCount = ASTTree_GetChildCount(tree, node);
+        for (uint32_t i = 0; i < childCount; i++)
+            TestText_Append(text, " %u", ASTTree_GetChild(tree, node, i));
+        TestText_Append(text, " ]\n");
+    }
+
+    ASTSymbolTable symbols = ASTParser_GetSymbolTable(unit->parser);
+    uint32_t symbolCount = ASTSymbolTable_GetSymbolCount(symbols);
+    for (ASTSymbolId id = 1; id <= symbolCount; id++) {
+        const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(symbols, id);
+        TestText_Append(text, "symbol %u: %u %u %u %u %u %u %u %u\n", id, symbol->name, symbol->node, symbol->type,
+            symbol->owner, symbol->shadowed, symbol->scope, (uint32_t)symbol->space, (uint32_t)symbol->kind);
+    }
+
+    ASTTypeTable types = ASTParser_GetTypeTable(unit->parser);
+    uint32_t typeCount = ASTTypeTable_GetTypeCount(types);
+    for (ASTTypeId id = 1; id <= typeCount; id++) {
+        const ASTTypeInfo* type = ASTTypeTable_Get(types, id);
+        TestText_Append(text, "type %u: %u %u %u %u %u %u %u (", id, (uint32_t)type->kind, (uint32_t)type->qualifiers,
+            (uint32_t)type->flags, type->base, type->value, type->count, type->unqualified);
+
+        const ASTTypeId* params = ASTTypeTable_GetParams(types, id);
+        for (uint32_t i = 0; params && i < type->count; i++)
+            TestText_Append(text, " %u", params[i]);
+        TestText_Append(text, " )\n");
+    }
+
+    if (unit->result != PARSER_RESULT_SUCCESS) {
+        uint32_t token = 0;
+        ASTParser_GetError(unit->parser, &token);
+        TestText_Append(text, "error at token %u\n", token);
+    }
+}
+
+/* Parse the skipped bodies one by one in source order, as ASTParser_ParseFunctionBodies must match */
+static void TestBodiesParseSerial(TestUnit* unit)
+{
+    ASTTree tree = ASTParser_GetTree(unit->parser);
+    ASTNodeId root = AST_NODE_TO_ID(unit->root);
+    uint32_t childCount = ASTTree_GetChildCount(tree, root);
+
+    for (uint32_t i = 0; i < childCount && unit->result == PARSER_RESULT_SUCCESS; i++) {
+        ASTNodeId child = ASTTree_GetChild(tree, root, i);
+        if (ASTTree_GetNodeType(tree, child) != AST_NODE_TYPE_FUNCTION_DECL)
+            continue;
+
+        ASTNode body;
+        ParserResult result = ASTParser_ParseFunctionBody(unit->parser, AST_NODE_FROM_ID(child), &body);
+        if (result != PARSER_ERROR_INVALID_ARG)
+            unit->result = result;
+    }
+}
+
+/* Parse a file with lazy bodies, then its bodies serially or with `threads` threads, and dump it */
+static bool TestBodiesParse(const TestText* source, uint32_t threads, TestText* dump, ASTParserStats* stats)
+{
+    if (!TestWriteFile(TEST_BODIES_SOURCE, source->data, source->length))
+        return false;
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+    config.lazyFunctionBodies = true;
+
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_BODIES_SOURCE, &config, threads);
+    if (parsed && threads == TEST_BODIES_SKIPPED)
+        TestBodiesParseSerial(&unit);
+
+    if (parsed) {
+        TestBodiesDump(&unit, dump);
+        ASTParser_GetStats(unit.parser, stats);
+    }
+
+    TestUnit_Destroy(&unit);
+    remove(TEST_BODIES_SOURCE);
+
+    return parsed;
+}
+
+/* Every thread count builds what the serial body parse builds, ids included */
+static void TestBodiesMatch(const TestText* source, uint32_t expectedParsed)
+{
+    static const uint32_t threads[] = { 1, 2, 3, 4, 8, 16 };
+
+    TestText expected = { 0 };
+    TestText dump = { 0 };
+    ASTParserStats stats;
+
+    bool parsed = TestBodiesParse(source, TEST_BODIES_SKIPPED, &expected, &stats);
+    bool same = parsed && stats.parsedBodies == expectedParsed;
+
+    for (uint32_t i = 0; i < TEST_COUNT(threads) && same; i++) {
+        TestText_Reset(&dump);
+        same = TestBodiesParse(source, threads[i], &dump, &stats) && stats.parsedBodies == expectedParsed &&
+            dump.length == expected.length && memcmp(dump.data, expected.data, dump.length) == 0;
+    }
+
+    TestText_Free(&expected);
+    TestText_Free(&dump);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(same);
+}
+
+/* Units of one function up to more bodies than any thread takes at once */
+static void TestBodiesSizes(void)
+{
+    static const uint32_t functions[] = { 1, 2, 7, 60, 600 };
+
+    for (uint32_t i = 0; i < TEST_COUNT(functions); i++) {
+        TestText source = { 0 };
+        TestGenerateC(&source, functions[i], i + 1);
+        TestBodiesMatch(&source, functions[i]);
+        TestText_Free(&source);
+    }
+}
+
+/* The first body with an error stops the parse, the bodies before it are attached whatever thread had them */
+static void TestBodiesError(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, 41, 3);
+    TestText_Append(&source, "int broken(void) { int int; return 0; }\n");
+    for (uint32_t i = 0; i < 20; i++)
+        TestText_Append(&source, "int after%u(int n) { return n + %u; }\n", i, i);
+
+    TestBodiesMatch(&source, 41);
+    TestText_Free(&source);
+}
+
+/* An arena installed as the global allocator is refused, it would be bumped from every thread */
+static void TestBodiesArenaAllocator(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, 8, 2);
+    bool written = TestWriteFile(TEST_BODIES_SOURCE, source.data, source.length);
+    TestText_Free(&source);
+    TEST_CHECK(written);
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+    config.lazyFunctionBodies = true;
+
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_BODIES_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+        unit.result == PARSER_RESULT_SUCCESS;
+    remove(TEST_BODIES_SOURCE);
+
+    ParserArena arena = NULL;
+    ParserAllocationCallbacks callbacks;
+    ParserResult refused = PARSER_RESULT_SUCCESS;
+    ParserResult result = PARSER_RESULT_SUCCESS;
+
+    if (parsed && ParserArena_Create(NULL, &arena) == PARSER_RESULT_SUCCESS) {
+        ParserArena_GetCallbacks(arena, &callbacks);
+
+        ParserAllocationCallbacks* previous = g_parser_allocator_callbacks;
+        g_parser_allocator_callbacks = &callbacks;
+        refused = ASTParser_ParseFunctionBodies(unit.parser, 2);
+        g_parser_allocator_callbacks = previous;
+
+        result = ASTParser_ParseFunctionBodies(unit.parser, 2);
+        ParserArena_Destroy(arena);
+    }
+
+    TestUnit_Destroy(&unit);
+
+    TEST_CHECK(parsed && arena);
+    TEST_CHECK(refused == PARSER_ERROR_UNSUPPORTED);
+    TEST_CHECK(result == PARSER_RESULT_SUCCESS);
+}
+
+/* Body parse time over thread counts against parsing the bodies one by one */
+static void TestBodiesBenchScaling(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, TEST_BODIES_BENCH_FUNCTIONS, 11);
+    bool written = TestWriteFile(TEST_BODIES_SOURCE, source.data, source.length);
+    TestText_Free(&source);
+    TEST_CHECK(written);
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+    config.lazyFunctionBodies = true;
+
+    static const uint32_t threads[] = { TEST_BODIES_SKIPPED, 1, 2, 4, 8, 16 };
+    double serial = 0.0;
+    bool parsed = true;
+
+    for (uint32_t i = 0; i < TEST_COUNT(threads) && parsed; i++) {
+        double best = 0.0;
+        ASTParserStats stats = { 0 };
+
+        for (uint32_t run = 0; run < TEST_BODIES_BENCH_RUNS && parsed; run++) {
+            TestUnit unit;
+            parsed = TestUnit_Parse(&unit, TEST_BODIES_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+                unit.result == PARSER_RESULT_SUCCESS;
+
+            double start = TestNow();
+            if (parsed && threads[i] == TEST_BODIES_SKIPPED)
+                TestBodiesParseSerial(&unit);
+            else if (parsed)
+                unit.result = ASTParser_ParseFunctionBodies(unit.parser, threads[i]);
+            double elapsed = (TestNow() - start) * 1000.0;
+
+            parsed = parsed && unit.result == PARSER_RESULT_SUCCESS;
+            if (parsed)
+                ASTParser_GetStats(unit.parser, &stats);
+            TestUnit_Destroy(&unit);
+
+            if (run == 0 || elapsed < best)
+                best = elapsed;
+        }
+
+        if (threads[i] == TEST_BODIES_SKIPPED) {
+            serial = best;
+            printf("    %u bodies one by one: %.1f ms\n", stats.parsedBodies, serial);
+        } else {
+            printf("    %2u threads: %.1f ms, %.2fx, %u stolen\n", stats.bodyThreads, best, serial / best,
+                stats.stolenBodies);
+        }
+    }
+
+    remove(TEST_BODIES_SOURCE);
+
+    TEST_CHECK(parsed);
+}
+
+static const TestCase s_Tests[] = {
+    { "Sizes", TestBodiesSizes },
+    { "Error", TestBodiesError },
+    { "ArenaAllocator", TestBodiesArenaAllocator },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchScaling", TestBodiesBenchScaling },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserParallel = {
+    "ParserParallel", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
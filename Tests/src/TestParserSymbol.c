@@ -0,0 +1,428 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/ParserArena.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_SYMBOL_SOURCE              "CompilerTests_ParserSymbol.c"
+#define TEST_SYMBOL_DEPTH               2000u
+#define TEST_SYMBOL_BENCH_DEPTH         200000u
+
+/* Names are plain ids here, the table needs an interner only for typedef bits */
+enum {
+    TEST_NAME_X = 1,
+    TEST_NAME_Y,
+    TEST_NAME_M,
+    TEST_NAME_L,
+    TEST_NAME_UNIQUE,
+};
+
+static ASTSymbolId TestSymbolDeclare(ASTSymbolTable symbols, ASTSymbolNamespace space, ParserIdentifierId name,
+    ASTSymbolKind kind, ASTSymbolId owner, ParserResult* result)
+{
+    ASTSymbolId id = AST_SYMBOL_ID_NONE;
+    ParserResult declared = ASTSymbolTable_Declare(symbols, space, name, kind, owner, 0, &id);
+    if (declared != PARSER_RESULT_SUCCESS && *result == PARSER_RESULT_SUCCESS)
+        *result = declared;
+
+    return id;
+}
+
+/* An inner declaration hides the outer one until its scope is popped, redeclaring in a scope is reported */
+static void TestSymbolShadowing(void)
+{
+    ASTSymbolTable symbols = NULL;
+    TEST_CHECK(CreateASTSymbolTable(NULL, &symbols) == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_FILE, NULL) == PARSER_RESULT_SUCCESS);
+
+    ParserResult result = PARSER_RESULT_SUCCESS;
+    ASTSymbolId file = TestSymbolDeclare(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, AST_SYMBOL_KIND_VARIABLE, 0,
+        &result);
+
+    ASTScope function = NULL, block = NULL;
+    result = result == PARSER_RESULT_SUCCESS ?
+        ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_FUNCTION, &function) : result;
+    ASTSymbolId parameter = TestSymbolDeclare(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X,
+        AST_SYMBOL_KIND_PARAMETER, 0, &result);
+    ASTSymbolId y = TestSymbolDeclare(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_Y, AST_SYMBOL_KIND_VARIABLE, 0,
+        &result);
+
+    result = result == PARSER_RESULT_SUCCESS ? ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_BLOCK, &block) : result;
+    ASTSymbolId local = TestSymbolDeclare(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, AST_SYMBOL_KIND_VARIABLE, 0,
+        &result);
+    bool inner = ASTSymbolTable_GetDepth(symbols) == 2 &&
+        ASTSymbolTable_GetScopeKind(symbols) == AST_SCOPE_KIND_BLOCK &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, 0) == local &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_Y, 0) == y;
+
+    const ASTSymbolInfo* info = ASTSymbolTable_GetSymbol(symbols, local);
+    bool record = info && info->name == TEST_NAME_X && info->shadowed == parameter && info->scope == 2 &&
+        info->kind == AST_SYMBOL_KIND_VARIABLE && info->space == AST_NAMESPACE_ORDINARY;
+
+    // The same name twice in one scope gives back the first symbol
+    ASTSymbolId again = AST_SYMBOL_ID_NONE;
+    ParserResult redeclared = ASTSymbolTable_Declare(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X,
+        AST_SYMBOL_KIND_VARIABLE, 0, 0, &again);
+
+    // Only the innermost scope may be popped
+    ParserResult outOfOrder = ASTSymbolTable_PopScope(symbols, function);
+
+    ParserResult popBlock = ASTSymbolTable_PopScope(symbols, block);
+    bool restored = ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, 0) == parameter;
+
+    ParserResult popFunction = ASTSymbolTable_PopScope(symbols, function);
+    bool outer = ASTSymbolTable_GetDepth(symbols) == 0 &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, 0) == file &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_Y, 0) == AST_SYMBOL_ID_NONE;
+
+    // Popped symbols keep their records
+    bool kept = ASTSymbolTable_GetSymbolCount(symbols) >= 4 &&
+        ASTSymbolTable_GetSymbol(symbols, parameter)->kind == AST_SYMBOL_KIND_PARAMETER;
+
+    ASTSymbolTableDestroy(symbols);
+
+    TEST_CHECK(result == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(inner && record);
+    TEST_CHECK(redeclared == PARSER_ERROR_REDECLARATION && again == local);
+    TEST_CHECK(outOfOrder == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(popBlock == PARSER_RESULT_SUCCESS && restored);
+    TEST_CHECK(popFunction == PARSER_RESULT_SUCCESS && outer && kept);
+}
+
+/* Tags, labels and the members of each struct do not hide ordinary names or each other */
+static void TestSymbolNamespaces(void)
+{
+    ASTSymbolTable symbols = NULL;
+    TEST_CHECK(CreateASTSymbolTable(NULL, &symbols) == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_FILE, NULL) == PARSER_RESULT_SUCCESS);
+
+    // struct X { int m; } X; union Y { int m; };
+    ParserResult result = PARSER_RESULT_SUCCESS;
+    ASTSymbolId tag = TestSymbolDeclare(symbols, AST_NAMESPACE_TAG, TEST_NAME_X, AST_SYMBOL_KIND_STRUCT_TAG, 0,
+        &result);
+    ASTSymbolId object = TestSymbolDeclare(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, AST_SYMBOL_KIND_VARIABLE, 0,
+        &result);
+    ASTSymbolId other = TestSymbolDeclare(symbols, AST_NAMESPACE_TAG, TEST_NAME_Y, AST_SYMBOL_KIND_UNION_TAG, 0,
+        &result);
+    ASTSymbolId member = TestSymbolDeclare(symbols, AST_NAMESPACE_MEMBER, TEST_NAME_M, AST_SYMBOL_KIND_MEMBER, tag,
+        &result);
+    ASTSymbolId otherMember = TestSymbolDeclare(symbols, AST_NAMESPACE_MEMBER, TEST_NAME_M, AST_SYMBOL_KIND_MEMBER,
+        other, &result);
+
+    bool separate = tag != object && member != otherMember &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_TAG, TEST_NAME_X, 0) == tag &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, 0) == object &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_MEMBER, TEST_NAME_M, tag) == member &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_MEMBER, TEST_NAME_M, other) == otherMember &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_M, 0) == AST_SYMBOL_ID_NONE &&
+        ASTSymbolTable_GetSymbol(symbols, member)->owner == tag;
+
+    // Labels need a function and belong to it, whatever block they are declared in
+    ASTSymbolId label = AST_SYMBOL_ID_NONE;
+    ParserResult fileLabel = ASTSymbolTable_Declare(symbols, AST_NAMESPACE_LABEL, TEST_NAME_L, AST_SYMBOL_KIND_LABEL,
+        0, 0, &label);
+
+    ASTScope function = NULL, block = NULL;
+    result = result == PARSER_RESULT_SUCCESS ?
+        ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_FUNCTION, &function) : result;
+    result = result == PARSER_RESULT_SUCCESS ? ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_BLOCK, &block) : result;
+    label = TestSymbolDeclare(symbols, AST_NAMESPACE_LABEL, TEST_NAME_L, AST_SYMBOL_KIND_LABEL, 0, &result);
+    ASTSymbolId shadowTag = TestSymbolDeclare(symbols, AST_NAMESPACE_TAG, TEST_NAME_X, AST_SYMBOL_KIND_ENUM_TAG, 0,
+        &result);
+
+    bool inBlock = ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_TAG, TEST_NAME_X, 0) == shadowTag &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, 0) == object;
+
+    ASTSymbolTable_PopScope(symbols, block);
+    bool afterBlock = ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_LABEL, TEST_NAME_L, 0) == label &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_TAG, TEST_NAME_X, 0) == tag;
+
+    ASTSymbolTable_PopScope(symbols, function);
+    bool afterFunction = ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_LABEL, TEST_NAME_L, 0) == AST_SYMBOL_ID_NONE &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_MEMBER, TEST_NAME_M, tag) == member;
+
+    ASTSymbolTableDestroy(symbols);
+
+    TEST_CHECK(result == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(separate);
+    TEST_CHECK(fileLabel == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(inBlock && afterBlock && afterFunction);
+}
+
+/* Nest `depth` blocks in the file scope, each hiding the same name and adding a name of its own, then pop them all */
+static bool TestSymbolNest(ASTSymbolTable symbols, uint32_t depth, bool check)
+{
+    ASTSymbolId outer = AST_SYMBOL_ID_NONE;
+    if (ASTSymbolTable_Declare(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, AST_SYMBOL_KIND_VARIABLE, 0, 0,
+        &outer) != PARSER_RESULT_SUCCESS)
+        return false;
+
+    bool same = true;
+    for (uint32_t i = 0; i < depth && same; i++) {
+        ASTSymbolId hiding = AST_SYMBOL_ID_NONE, unique = AST_SYMBOL_ID_NONE;
+        same = ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_BLOCK, NULL) == PARSER_RESULT_SUCCESS &&
+            ASTSymbolTable_Declare(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, AST_SYMBOL_KIND_VARIABLE, 0, 0,
+                &hiding) == PARSER_RESULT_SUCCESS &&
+            ASTSymbolTable_Declare(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_UNIQUE + i, AST_SYMBOL_KIND_VARIABLE,
+                0, 0, &unique) == PARSER_RESULT_SUCCESS;
+
+        if (check) {
+            same = same && ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, 0) == hiding &&
+                ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_UNIQUE + i / 2, 0) != 0;
+        }
+    }
+
+    for (uint32_t i = depth; i-- > 0 && same;) {
+        same = ASTSymbolTable_PopScope(symbols, NULL) == PARSER_RESULT_SUCCESS;
+        if (check) {
+            same = same && ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_UNIQUE + i, 0) == 0 &&
+                (i == 0 || ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_UNIQUE + i - 1, 0) != 0);
+        }
+    }
+
+    return same && ASTSymbolTable_GetDepth(symbols) == 0 &&
+        ASTSymbolTable_Lookup(symbols, AST_NAMESPACE_ORDINARY, TEST_NAME_X, 0) == outer;
+}
+
+static void TestSymbolDeepNesting(void)
+{
+    ASTSymbolTable symbols = NULL;
+    TEST_CHECK(CreateASTSymbolTable(NULL, &symbols) == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_FILE, NULL) == PARSER_RESULT_SUCCESS);
+
+    bool same = TestSymbolNest(symbols, TEST_SYMBOL_DEPTH, true);
+    uint32_t count = ASTSymbolTable_GetSymbolCount(symbols);
+
+    ASTSymbolTableDestroy(symbols);
+
+    TEST_CHECK(same);
+    TEST_CHECK(count >= 2 * TEST_SYMBOL_DEPTH + 1);
+}
+
+/* Identifiers of a parsed body refer to the declaration visible where they are used */
+static void TestSymbolParsed(void)
+{
+    static const char source[] =
+        "int x;\n"
+        "int f(int y)\n"
+        "{\n"
+        "    x = y;\n"
+        "    {\n"
+        "        int x;\n"
+        "        x = y;\n"
+        "        { int y; x = y; }\n"
+        "    }\n"
+        "    x = y;\n"
+        "    return x;\n"
+        "}\n";
+    TEST_CHECK(TestWriteFile(TEST_SYMBOL_SOURCE, source, sizeof(source) - 1));
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_SYMBOL_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+        unit.result == PARSER_RESULT_SUCCESS;
+
+    ASTNodeId uses[16];
+    uint32_t count = parsed ? TestUnit_FindNodes(&unit, AST_NODE_TYPE_IDENTIFIER, uses, 16) : 0;
+
+    // Each use as "name:kind@scope"
+    TestText text = { 0 };
+    ASTTree tree = parsed ? ASTParser_GetTree(unit.parser) : NULL;
+    ASTSymbolTable symbols = parsed ? ASTParser_GetSymbolTable(unit.parser) : NULL;
+    for (uint32_t i = 0; i < count && i < 16; i++) {
+        const ASTSymbolInfo* info = ASTSymbolTable_GetSymbol(symbols, ASTTree_GetData(tree, uses[i]).rhs);
+        TestUnit_PrintNode(&unit, uses[i], &text);
+        TestText_Append(&text, info ? ":%u@%u " : ":? ", info ? info->kind : 0, info ? info->scope : 0);
+    }
+
+    static const char expected[] =
+        "x:1@0 y:3@1 x:1@2 y:3@1 x:1@2 y:1@3 x:1@0 y:3@1 x:1@0 ";
+    bool same = text.length == sizeof(expected) - 1 && memcmp(text.data, expected, text.length) == 0;
+    if (!same)
+        printf("    %s\n", text.data ? text.data : "");
+
+    TestText_Free(&text);
+    TestUnit_Destroy(&unit);
+    remove(TEST_SYMBOL_SOURCE);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(same);
+}
+
+/* The typedef bit of a name follows its visible ordinary binding through scopes */
+static void TestSymbolTypedefBits(void)
+{
+    ParserArena arena = NULL;
+    ParserInterner interner = NULL;
+    ASTSymbolTable symbols = NULL;
+    bool created = ParserArena_Create(NULL, &arena) == PARSER_RESULT_SUCCESS &&
+        CreateParserInterner(arena, &interner) == PARSER_RESULT_SUCCESS &&
+        CreateASTSymbolTable(interner, &symbols) == PARSER_RESULT_SUCCESS &&
+        ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_FILE, NULL) == PARSER_RESULT_SUCCESS;
+
+    ParserIdentifierId name = PARSER_IDENTIFIER_NONE;
+    created = created && ParserInterner_Intern(interner, "T", 1, &name) == PARSER_RESULT_SUCCESS;
+
+    // typedef int T; { int T; { typedef int T; } } with the bit read at every step
+    uint32_t bits = 0;
+    ParserResult result = created ? PARSER_RESULT_SUCCESS : PARSER_ERROR_NO_MEMORY;
+    if (created) {
+        bits |= (ParserInterner_Get(interner, name)->flags & PARSER_IDENTIFIER_FLAG_TYPEDEF) << 0;
+        TestSymbolDeclare(symbols, AST_NAMESPACE_ORDINARY, name, AST_SYMBOL_KIND_TYPEDEF, 0, &result);
+        bits |= (ParserInterner_Get(interner, name)->flags & PARSER_IDENTIFIER_FLAG_TYPEDEF) << 1;
+
+        ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_BLOCK, NULL);
+        TestSymbolDeclare(symbols, AST_NAMESPACE_ORDINARY, name, AST_SYMBOL_KIND_VARIABLE, 0, &result);
+        bits |= (ParserInterner_Get(interner, name)->flags & PARSER_IDENTIFIER_FLAG_TYPEDEF) << 2;
+
+        // A tag of the same name is not an ordinary binding
+        TestSymbolDeclare(symbols, AST_NAMESPACE_TAG, name, AST_SYMBOL_KIND_STRUCT_TAG, 0, &result);
+        bits |= (ParserInterner_Get(interner, name)->flags & PARSER_IDENTIFIER_FLAG_TYPEDEF) << 3;
+
+        ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_BLOCK, NULL);
+        TestSymbolDeclare(symbols, AST_NAMESPACE_ORDINARY, name, AST_SYMBOL_KIND_TYPEDEF, 0, &result);
+        bits |= (ParserInterner_Get(interner, name)->flags & PARSER_IDENTIFIER_FLAG_TYPEDEF) << 4;
+
+        ASTSymbolTable_PopScope(symbols, NULL);
+        bits |= (ParserInterner_Get(interner, name)->flags & PARSER_IDENTIFIER_FLAG_TYPEDEF) << 5;
+        ASTSymbolTable_PopScope(symbols, NULL);
+        bits |= (ParserInterner_Get(interner, name)->flags & PARSER_IDENTIFIER_FLAG_TYPEDEF) << 6;
+
+        ASTSymbolTable_Reset(symbols);
+        bits |= (ParserInterner_Get(interner, name)->flags & PARSER_IDENTIFIER_FLAG_TYPEDEF) << 7;
+    }
+
+    ASTSymbolTableDestroy(symbols);
+    ParserInternerDestroy(interner);
+    ParserArena_Destroy(arena);
+
+    TEST_CHECK(created && result == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(bits == 0x52);
+}
+
+/* The same statement is a declaration or an expression by what its first name is bound to */
+static void TestSymbolTypedefNames(void)
+{
+    static const char source[] =
+        "typedef int T;\n"
+        "int a, b;\n"
+        "void f(void)\n"
+        "{\n"
+        "    T * x;\n"
+        "    a * b;\n"
+        "    (T) - a;\n"
+        "    {\n"
+        "        int T;\n"
+        "        T * a;\n"
+        "        (T) - a;\n"
+        "    }\n"
+        "    T * y;\n"
+        "    (T) + a;\n"
+        "}\n";
+    TEST_CHECK(TestWriteFile(TEST_SYMBOL_SOURCE, source, sizeof(source) - 1));
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    TestUnit unit;
+    bool parsed = TestUnit_Parse(&unit, TEST_SYMBOL_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+        unit.result == PARSER_RESULT_SUCCESS;
+
+    ASTNodeId nodes[16];
+    uint32_t statementCount = parsed ? TestUnit_FindNodes(&unit, AST_NODE_TYPE_EXPRESSION_STMT, nodes, 16) : 0;
+
+    TestText text = { 0 };
+    for (uint32_t i = 0; i < statementCount && i < 16; i++) {
+        TestUnit_PrintNode(&unit, ASTTree_GetChild(ASTParser_GetTree(unit.parser), nodes[i], 0), &text);
+        TestText_Append(&text, "; ");
+    }
+
+    // Declared variables by name, x and y are pointers to T
+    uint32_t variableCount = parsed ? TestUnit_FindNodes(&unit, AST_NODE_TYPE_VARIABLE_DECL, nodes, 16) : 0;
+    ASTSymbolTable symbols = parsed ? ASTParser_GetSymbolTable(unit.parser) : NULL;
+    ParserInterner interner = parsed ? ASTParser_GetInterner(unit.parser) : NULL;
+    for (uint32_t i = 0; i < variableCount && i < 16; i++) {
+        const ASTSymbolInfo* info =
+            ASTSymbolTable_GetSymbol(symbols, ASTTree_GetData(ASTParser_GetTree(unit.parser), nodes[i]).rhs);
+        const ParserIdentifier* name = info ? ParserInterner_Get(interner, info->name) : NULL;
+        TestText_Append(&text, "%s ", name ? name->text : "?");
+    }
+
+    // At the end of the unit T is a typedef name again
+    ParserIdentifierId typedefName = parsed ? ParserInterner_Find(interner, "T", 1) : PARSER_IDENTIFIER_NONE;
+    bool flagged = typedefName != PARSER_IDENTIFIER_NONE &&
+        (ParserInterner_Get(interner, typedefName)->flags & PARSER_IDENTIFIER_FLAG_TYPEDEF);
+
+    static const char expected[] =
+        "(* a b); (cast type (- a)); (* T a); (- T a); (cast type (+ a)); a b x T y ";
+    bool same = text.length == sizeof(expected) - 1 && memcmp(text.data, expected, text.length) == 0;
+    if (!same)
+        printf("    %s\n", text.data ? text.data : "");
+
+    TestText_Free(&text);
+    TestUnit_Destroy(&unit);
+    remove(TEST_SYMBOL_SOURCE);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(same);
+    TEST_CHECK(flagged);
+}
+
+/* Push, declare, look up and pop at a depth where anything but constant-time lookups would show */
+static void TestSymbolBenchNesting(void)
+{
+    ASTSymbolTable symbols = NULL;
+    TEST_CHECK(CreateASTSymbolTable(NULL, &symbols) == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_FILE, NULL) == PARSER_RESULT_SUCCESS);
+
+    double start = TestNow();
+    bool same = TestSymbolNest(symbols, TEST_SYMBOL_BENCH_DEPTH / 10, true);
+    double shallow = (TestNow() - start) * 1000.0;
+
+    ASTSymbolTable_Reset(symbols);
+    start = TestNow();
+    same = same && ASTSymbolTable_PushScope(symbols, AST_SCOPE_KIND_FILE, NULL) == PARSER_RESULT_SUCCESS;
+    same = same && TestSymbolNest(symbols, TEST_SYMBOL_BENCH_DEPTH, true);
+    double deep = (TestNow() - start) * 1000.0;
+
+    ASTSymbolTableDestroy(symbols);
+
+    TEST_CHECK(same);
+
+    printf("    %u scopes: %.1f ms, %u scopes: %.1f ms\n", TEST_SYMBOL_BENCH_DEPTH / 10, shallow,
+        TEST_SYMBOL_BENCH_DEPTH, deep);
+}
+
+static const TestCase s_Tests[] = {
+    { "Shadowing", TestSymbolShadowing },
+    { "Namespaces", TestSymbolNamespaces },
+    { "DeepNesting", TestSymbolDeepNesting },
+    { "Parsed", TestSymbolParsed },
+    { "TypedefBits", TestSymbolTypedefBits },
+    { "TypedefNames", TestSymbolTypedefNames },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchNesting", TestSymbolBenchNesting },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserSymbol = {
+    "ParserSymbol", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,209 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include <stdio.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_TYPE_SOURCE                "CompilerTests_ParserType.c"
+
+/* The same request twice gives the same id and the same record */
+static bool TestTypeSame(ASTTypeTable types, ASTTypeId a, ASTTypeId b)
+{
+    return a != AST_TYPE_ID_NONE && a == b && ASTTypeTable_Get(types, a) == ASTTypeTable_Get(types, b);
+}
+
+/* Identical types are stored once, any difference in kind, qualifiers, size or parameters makes a new one */
+static void TestTypeInterning(void)
+{
+    ASTTypeTable types = NULL;
+    TEST_CHECK(CreateASTTypeTable(&types) == PARSER_RESULT_SUCCESS);
+
+    ParserResult result = PARSER_RESULT_SUCCESS;
+#define TEST_TYPE_GET(call) (result = result == PARSER_RESULT_SUCCESS ? (call) : result)
+
+    // int, const unsigned char, const unsigned char*, unsigned char* const
+    ASTTypeId integer[2], byte, constByte[2], toConst[2], constPointer;
+    for (uint32_t i = 0; i < 2; i++) {
+        TEST_TYPE_GET(ASTTypeTable_GetBasic(types, C_BASIC_TYPE_INT, 0, &integer[i]));
+        TEST_TYPE_GET(ASTTypeTable_GetBasic(types, C_BASIC_TYPE_UNSIGNED_CHAR, C_TYPE_QUAL_CONST, &constByte[i]));
+        TEST_TYPE_GET(ASTTypeTable_GetPointer(types, constByte[i], 0, &toConst[i]));
+    }
+    TEST_TYPE_GET(ASTTypeTable_GetBasic(types, C_BASIC_TYPE_UNSIGNED_CHAR, 0, &byte));
+    ASTTypeId bytePointer;
+    TEST_TYPE_GET(ASTTypeTable_GetPointer(types, byte, 0, &bytePointer));
+    TEST_TYPE_GET(ASTTypeTable_GetPointer(types, byte, C_TYPE_QUAL_CONST, &constPointer));
+
+    bool basic = TestTypeSame(types, integer[0], integer[1]) && TestTypeSame(types, constByte[0], constByte[1]) &&
+        TestTypeSame(types, toConst[0], toConst[1]) && constByte[0] != byte &&
+        ASTTypeTable_GetUnqualified(types, constByte[0]) == byte &&
+        toConst[0] != constPointer && toConst[0] != bytePointer &&
+        ASTTypeTable_GetUnqualified(types, constPointer) == bytePointer &&
+        ASTTypeTable_Get(types, toConst[0])->base == constByte[0];
+
+    // int[10] twice, int[11], and const on an array going to its element
+    ASTTypeId array[2], longer, constArray, constIntArray, constInt;
+    for (uint32_t i = 0; i < 2; i++)
+        TEST_TYPE_GET(ASTTypeTable_GetArray(types, integer[0], C_ARRAY_SIZE_FIXED, 10, AST_TYPE_FLAG_SIZED,
+            &array[i]));
+    TEST_TYPE_GET(ASTTypeTable_GetArray(types, integer[0], C_ARRAY_SIZE_FIXED, 11, AST_TYPE_FLAG_SIZED, &longer));
+    TEST_TYPE_GET(ASTTypeTable_GetQualified(types, array[0], C_TYPE_QUAL_CONST, &constArray));
+    TEST_TYPE_GET(ASTTypeTable_GetBasic(types, C_BASIC_TYPE_INT, C_TYPE_QUAL_CONST, &constInt));
+    TEST_TYPE_GET(ASTTypeTable_GetArray(types, constInt, C_ARRAY_SIZE_FIXED, 10, AST_TYPE_FLAG_SIZED,
+        &constIntArray));
+
+    bool arrays = TestTypeSame(types, array[0], array[1]) && array[0] != longer &&
+        TestTypeSame(types, constArray, constIntArray);
+
+    // int (const unsigned char*, int) twice, variadic, and without a prototype
+    ASTTypeId params[] = { toConst[0], integer[0] };
+    ASTTypeId function[2], variadic, unprototyped;
+    for (uint32_t i = 0; i < 2; i++)
+        TEST_TYPE_GET(ASTTypeTable_GetFunction(types, integer[0], params, 2, AST_TYPE_FLAG_PROTOTYPE, &function[i]));
+    TEST_TYPE_GET(ASTTypeTable_GetFunction(types, integer[0], params, 2,
+        AST_TYPE_FLAG_PROTOTYPE | AST_TYPE_FLAG_VARIADIC, &variadic));
+    TEST_TYPE_GET(ASTTypeTable_GetFunction(types, integer[0], NULL, 0, 0, &unprototyped));
+
+    const ASTTypeId* stored = ASTTypeTable_GetParams(types, function[0]);
+    bool functions = TestTypeSame(types, function[0], function[1]) && function[0] != variadic &&
+        function[0] != unprototyped && stored && stored[0] == toConst[0] && stored[1] == integer[0] &&
+        ASTTypeTable_AreCompatible(types, function[0], unprototyped) &&
+        !ASTTypeTable_AreCompatible(types, function[0], variadic);
+
+    // Tagged types are told apart by their tag and kind only
+    ASTTypeId first[2], second, other;
+    for (uint32_t i = 0; i < 2; i++)
+        TEST_TYPE_GET(ASTTypeTable_GetTagged(types, AST_TYPE_KIND_STRUCT, 5, 0, &first[i]));
+    TEST_TYPE_GET(ASTTypeTable_GetTagged(types, AST_TYPE_KIND_STRUCT, 6, 0, &second));
+    TEST_TYPE_GET(ASTTypeTable_GetTagged(types, AST_TYPE_KIND_UNION, 5, 0, &other));
+    ASTTypeId wrongKind = AST_TYPE_ID_NONE;
+    ParserResult notTagged = ASTTypeTable_GetTagged(types, AST_TYPE_KIND_POINTER, 5, 0, &wrongKind);
+
+    bool tagged = TestTypeSame(types, first[0], first[1]) && first[0] != second && first[0] != other &&
+        !ASTTypeTable_AreCompatible(types, first[0], second);
+
+    // Asking for all of them again adds nothing
+    uint32_t count = ASTTypeTable_GetTypeCount(types);
+    ASTTypeId again;
+    TEST_TYPE_GET(ASTTypeTable_GetPointer(types, constByte[0], 0, &again));
+    TEST_TYPE_GET(ASTTypeTable_GetFunction(types, integer[0], params, 2, AST_TYPE_FLAG_PROTOTYPE, &again));
+    TEST_TYPE_GET(ASTTypeTable_GetQualified(types, array[0], C_TYPE_QUAL_CONST, &again));
+    bool constant = ASTTypeTable_GetTypeCount(types) == count;
+
+#undef TEST_TYPE_GET
+
+    ASTTypeTableDestroy(types);
+
+    TEST_CHECK(result == PARSER_RESULT_SUCCESS);
+    TEST_CHECK(basic);
+    TEST_CHECK(arrays);
+    TEST_CHECK(functions);
+    TEST_CHECK(tagged && notTagged == PARSER_ERROR_INVALID_ARG);
+    TEST_CHECK(constant);
+}
+
+/* Parse `count` declarations of `const uint8_t*` spelled in different ways, return the types they got */
+static bool TestTypeParseDeclarations(uint32_t count, uint32_t* declarations, uint32_t* typeCount,
+    uint32_t* distinct)
+{
+    TestText source = { 0 };
+    TestText_Append(&source, "typedef unsigned char uint8_t;\n");
+    for (uint32_t i = 0; i < count; i++) {
+        static const char* const spellings[] = {
+            "const uint8_t*", "uint8_t const*", "const unsigned char*", "unsigned char const *",
+        };
+        TestText_Append(&source, "%s p%u;\n", spellings[i % 4], i);
+    }
+    TestText_Append(&source, "int f(const uint8_t* a, const unsigned char* b);\n");
+
+    bool written = TestWriteFile(TEST_TYPE_SOURCE, source.data, source.length);
+    TestText_Free(&source);
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    TestUnit unit = { 0 };
+    bool parsed = written && TestUnit_Parse(&unit, TEST_TYPE_SOURCE, &config, TEST_BODIES_SKIPPED) &&
+        unit.result == PARSER_RESULT_SUCCESS;
+
+    // Variables and parameters, every one has the type of the first
+    *declarations = 0;
+    *distinct = 0;
+    *typeCount = 0;
+    if (parsed) {
+        ASTTree tree = ASTParser_GetTree(unit.parser);
+        ASTSymbolTable symbols = ASTParser_GetSymbolTable(unit.parser);
+        ASTTypeTable types = ASTParser_GetTypeTable(unit.parser);
+
+        ASTTypeId first = AST_TYPE_ID_NONE;
+        ASTTreeView view;
+        ASTTree_GetView(tree, &view);
+
+        for (ASTNodeId id = 1; id < view.nodeCount; id++) {
+            // Parameters keep their type in the node, variables in their symbol
+            ASTTypeId type = AST_TYPE_ID_NONE;
+            if (view.types[id] == AST_NODE_TYPE_PARAMETER_DECL) {
+                type = view.data[id].lhs;
+            }
+            else if (view.types[id] == AST_NODE_TYPE_VARIABLE_DECL) {
+                const ASTSymbolInfo* symbol = ASTSymbolTable_GetSymbol(symbols, view.data[id].rhs);
+                type = symbol ? symbol->type : AST_TYPE_ID_NONE;
+            }
+            else {
+                continue;
+            }
+
+            if (first == AST_TYPE_ID_NONE)
+                first = type;
+            if (type != first || ASTTypeTable_Get(types, type) != ASTTypeTable_Get(types, first))
+                (*distinct)++;
+            (*declarations)++;
+        }
+
+        const ASTTypeInfo* info = ASTTypeTable_Get(types, first);
+        const ASTTypeInfo* pointee = info ? ASTTypeTable_Get(types, info->base) : NULL;
+        if (!info || info->kind != AST_TYPE_KIND_POINTER || !pointee || pointee->kind != AST_TYPE_KIND_BASIC ||
+            pointee->value != C_BASIC_TYPE_UNSIGNED_CHAR || pointee->qualifiers != C_TYPE_QUAL_CONST)
+            (*distinct)++;
+
+        *typeCount = ASTTypeTable_GetTypeCount(types);
+    }
+
+    TestUnit_Destroy(&unit);
+    remove(TEST_TYPE_SOURCE);
+
+    return parsed;
+}
+
+/* Thousands of declarations of one type share one record, the table does not grow with them */
+static void TestTypeParsed(void)
+{
+    uint32_t few = 0, many = 0, fewTypes = 0, manyTypes = 0, fewDistinct = 0, manyDistinct = 0;
+    bool parsed = TestTypeParseDeclarations(8, &few, &fewTypes, &fewDistinct) &&
+        TestTypeParseDeclarations(4000, &many, &manyTypes, &manyDistinct);
+
+    TEST_CHECK(parsed);
+    TEST_CHECK(few == 8 + 2 && many == 4000 + 2);
+    TEST_CHECK(fewDistinct == 0 && manyDistinct == 0);
+    TEST_CHECK(fewTypes > 0 && manyTypes == fewTypes);
+}
+
+static const TestCase s_Tests[] = {
+    { "Interning", TestTypeInterning },
+    { "Parsed", TestTypeParsed },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserType = {
+    "ParserType", s_Tests, TEST_COUNT(s_Tests), NULL, 0,
+};
+
+// ------------------------------------------------------------------------------------------------
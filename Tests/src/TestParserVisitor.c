@@ -0,0 +1,414 @@
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include "TestCore.h"
+
+#include "parser/ParserVisitor.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define TEST_VISITOR_SOURCE             "CompilerTests_ParserVisitor.c"
+#define TEST_VISITOR_DEEP_BLOCKS        3000u
+#define TEST_VISITOR_BENCH_FUNCTIONS    20000u
+#define TEST_VISITOR_BENCH_PASSES       4u
+#define TEST_VISITOR_BENCH_RUNS         3u
+
+/**
+ * What a pass does and what it saw: it skips the children of one node
+ * type and stops at its `stopAfter`th node, and logs every callback as
+ * "> node parent" or "< node parent".
+ */
+typedef struct TestVisitPolicy_T {
+    uint8_t skipType;           // AST_NODE_TYPE_NONE to skip nothing
+    uint32_t stopAfter;         // 0 to never stop
+    uint32_t entered;
+    bool stopped;
+    TestText log;
+} TestVisitPolicy;
+
+static ASTVisitAction TestVisitAction(TestVisitPolicy* policy, const ASTTreeView* tree, ASTNodeId node)
+{
+    if (++policy->entered == policy->stopAfter)
+        return AST_VISIT_STOP;
+
+    return tree->types[node - tree->firstNode] == policy->skipType ? AST_VISIT_SKIP_CHILDREN : AST_VISIT_CONTINUE;
+}
+
+static ASTVisitAction PARSER_PTR TestVisitEnter(void* userData, const ASTTreeView* tree, ASTNodeId node, ASTNodeId parent)
+{
+    TestVisitPolicy* policy = userData;
+    TestText_Append(&policy->log, "> %u %u\n", node, parent);
+
+    return TestVisitAction(policy, tree, node);
+}
+
+static ASTVisitAction PARSER_PTR TestVisitLeave(void* userData, const ASTTreeView* tree, ASTNodeId node, ASTNodeId parent)
+{
+    (void)tree;
+    TestText_Append(&((TestVisitPolicy*)userData)->log, "< %u %u\n", node, parent);
+
+    return AST_VISIT_CONTINUE;
+}
+
+/* The walk the visitor replaces, recursive, for the log the visitor must produce */
+static void TestVisitReference(const ASTTreeView* tree, ASTNodeId node, ASTNodeId parent, TestVisitPolicy* policy)
+{
+    TestText_Append(&policy->log, "> %u %u\n", node, parent);
+
+    ASTVisitAction action = TestVisitAction(policy, tree, node);
+    if (action == AST_VISIT_STOP) {
+        policy->stopped = true;
+        return;
+    }
+
+    uint32_t childCount = action == AST_VISIT_CONTINUE ? ASTTreeView_GetChildCount(tree, node) : 0;
+    for (uint32_t i = 0; i < childCount && !policy->stopped; i++) {
+        ASTNodeId child = ASTTreeView_GetChild(tree, node, i);
+        if (child != AST_NODE_ID_NONE)
+            TestVisitReference(tree, child, node, policy);
+    }
+
+    if (!policy->stopped)
+        TestText_Append(&policy->log, "< %u %u\n", node, parent);
+}
+
+/* Parse a C file with its bodies, false when it could not be parsed */
+static bool TestVisitParse(const TestText* source, TestUnit* unit)
+{
+    if (!TestWriteFile(TEST_VISITOR_SOURCE, source->data, source->length))
+        return false;
+
+    ASTParserCreateConfig config = { 0 };
+    config.strategy = &g_CLanguageStrategy;
+
+    bool parsed = TestUnit_Parse(unit, TEST_VISITOR_SOURCE, &config, 0);
+    remove(TEST_VISITOR_SOURCE);
+
+    if (parsed && unit->result != PARSER_RESULT_SUCCESS) {
+        TestUnit_Destroy(unit);
+        return false;
+    }
+
+    return parsed;
+}
+
+/* Walk a unit with one pass per policy fused into one walk, each log must match the reference walk */
+static void TestVisitMatch(const TestUnit* unit, const TestVisitPolicy* policies, uint32_t count, uint32_t* maxDepth)
+{
+    TestVisitPolicy passes[4];
+    TestVisitPolicy expected[4];
+    TEST_CHECK(count <= TEST_COUNT(passes));
+
+    ASTTreeView tree;
+    ASTTree_GetView(ASTParser_GetTree(unit->parser), &tree);
+    ASTNodeId root = AST_NODE_TO_ID(unit->root);
+
+    ASTVisitor visitor;
+    TEST_CHECK(CreateASTVisitor(&visitor) == PARSER_RESULT_SUCCESS);
+
+    ASTVisitorPass pass;
+    memset(&pass, 0, sizeof(pass));
+    pass.enterAny = TestVisitEnter;
+    pass.leaveAny = TestVisitLeave;
+
+    for (uint32_t i = 0; i < count; i++) {
+        passes[i] = policies[i];
+        expected[i] = policies[i];
+        memset(&passes[i].log, 0, sizeof(TestText));
+        memset(&expected[i].log, 0, sizeof(TestText));
+
+        pass.userData = &passes[i];
+        ASTVisitor_AddPass(visitor, &pass);
+        TestVisitReference(&tree, root, AST_NODE_ID_NONE, &expected[i]);
+    }
+
+    // Twice, the second walk runs on the work stack the first one grew
+    bool walked = true;
+    bool same = true;
+    for (uint32_t walk = 0; walk < 2 && walked && same; walk++) {
+        for (uint32_t i = 0; i < count; i++) {
+            TestText_Reset(&passes[i].log);
+            passes[i].entered = 0;
+        }
+
+        walked = ASTVisitor_Walk(visitor, &tree, root) == PARSER_RESULT_SUCCESS;
+        for (uint32_t i = 0; i < count && walked; i++) {
+            if (passes[i].log.length != expected[i].log.length ||
+                memcmp(passes[i].log.data, expected[i].log.data, expected[i].log.length) != 0) {
+                fprintf(stderr, "    pass %u of walk %u logged %zu bytes, expected %zu\n", i, walk,
+                    passes[i].log.length, expected[i].log.length);
+                same = false;
+            }
+        }
+    }
+
+    if (maxDepth)
+        *maxDepth = ASTVisitor_GetMaxDepth(visitor);
+
+    for (uint32_t i = 0; i < count; i++) {
+        TestText_Free(&passes[i].log);
+        TestText_Free(&expected[i].log);
+    }
+    ASTVisitorDestroy(visitor);
+
+    TEST_CHECK(walked);
+    TEST_CHECK(same);
+}
+
+/* Pre-order enter and post-order leave, with the parent of every node */
+static void TestVisitOrder(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, 60, 1);
+    TestUnit unit;
+    bool parsed = TestVisitParse(&source, &unit);
+    TestText_Free(&source);
+    TEST_CHECK(parsed);
+
+    TestVisitPolicy policy = { .skipType = AST_NODE_TYPE_NONE, .stopAfter = 0 };
+    TestVisitMatch(&unit, &policy, 1, NULL);
+    TestUnit_Destroy(&unit);
+}
+
+/* Passes that skip or stop at different places share a walk without holding back the others */
+static void TestVisitSkipStop(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, 60, 2);
+    TestUnit unit;
+    bool parsed = TestVisitParse(&source, &unit);
+    TestText_Free(&source);
+    TEST_CHECK(parsed);
+
+    static const TestVisitPolicy policies[] = {
+        { .skipType = AST_NODE_TYPE_COMPOUND_STMT, .stopAfter = 0 },
+        { .skipType = AST_NODE_TYPE_NONE, .stopAfter = 1000 },
+        { .skipType = AST_NODE_TYPE_BINARY_EXPR, .stopAfter = 2500 },
+        { .skipType = AST_NODE_TYPE_TRANSLATION_UNIT, .stopAfter = 0 },
+    };
+
+    TestVisitMatch(&unit, policies, TEST_COUNT(policies), NULL);
+
+    // A pass that stops at the root, on its own and next to one that does not
+    static const TestVisitPolicy root[] = {
+        { .skipType = AST_NODE_TYPE_NONE, .stopAfter = 1 },
+        { .skipType = AST_NODE_TYPE_NONE, .stopAfter = 0 },
+    };
+
+    TestVisitMatch(&unit, root, 1, NULL);
+    TestVisitMatch(&unit, root, TEST_COUNT(root), NULL);
+    TestUnit_Destroy(&unit);
+}
+
+static ASTVisitAction PARSER_PTR TestVisitCountCall(void* userData, const ASTTreeView* tree, ASTNodeId node, ASTNodeId parent)
+{
+    (void)tree;
+    (void)node;
+    (void)parent;
+    ((uint32_t*)userData)[0]++;
+
+    return AST_VISIT_CONTINUE;
+}
+
+static ASTVisitAction PARSER_PTR TestVisitCountAny(void* userData, const ASTTreeView* tree, ASTNodeId node, ASTNodeId parent)
+{
+    (void)tree;
+    (void)node;
+    (void)parent;
+    ((uint32_t*)userData)[1]++;
+
+    return AST_VISIT_CONTINUE;
+}
+
+/* Count the calls and the other nodes under a node with a native recursion, return the total */
+static uint32_t TestVisitRecursive(const ASTTreeView* tree, ASTNodeId node, uint32_t* counts)
+{
+    counts[tree->types[node - tree->firstNode] == AST_NODE_TYPE_CALL_EXPR ? 0 : 1]++;
+
+    uint32_t count = 1;
+    uint32_t childCount = ASTTreeView_GetChildCount(tree, node);
+    for (uint32_t i = 0; i < childCount; i++) {
+        ASTNodeId child = ASTTreeView_GetChild(tree, node, i);
+        if (child != AST_NODE_ID_NONE)
+            count += TestVisitRecursive(tree, child, counts);
+    }
+
+    return count;
+}
+
+/* A callback for a node type replaces the Any callback for that type only */
+static void TestVisitTyped(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, 60, 3);
+    TestUnit unit;
+    bool parsed = TestVisitParse(&source, &unit);
+    TestText_Free(&source);
+    TEST_CHECK(parsed);
+
+    ASTTreeView tree;
+    ASTTree_GetView(ASTParser_GetTree(unit.parser), &tree);
+    ASTNodeId root = AST_NODE_TO_ID(unit.root);
+
+    uint32_t expected[2] = { 0, 0 };
+    TestVisitRecursive(&tree, root, expected);
+
+    uint32_t counts[2] = { 0, 0 };
+    ASTVisitorPass pass;
+    memset(&pass, 0, sizeof(pass));
+    pass.enter[AST_NODE_TYPE_CALL_EXPR] = TestVisitCountCall;
+    pass.enterAny = TestVisitCountAny;
+    pass.userData = counts;
+
+    ASTVisitor visitor;
+    bool walked = false;
+    if (CreateASTVisitor(&visitor) == PARSER_RESULT_SUCCESS) {
+        walked = ASTVisitor_AddPass(visitor, &pass) == PARSER_RESULT_SUCCESS &&
+            ASTVisitor_Walk(visitor, &tree, root) == PARSER_RESULT_SUCCESS;
+        ASTVisitorDestroy(visitor);
+    }
+    TestUnit_Destroy(&unit);
+
+    TEST_CHECK(walked);
+    TEST_CHECK(expected[0] > 0);
+    TEST_CHECK(counts[0] == expected[0] && counts[1] == expected[1]);
+}
+
+/* Nesting deeper than one block of the work stack */
+static void TestVisitDeep(void)
+{
+    TestText source = { 0 };
+    TestText_Append(&source, "int deep(int n)\n{\n");
+    for (uint32_t i = 0; i < TEST_VISITOR_DEEP_BLOCKS; i++)
+        TestText_Append(&source, "{ n = n + %u;\n", i & 7);
+    for (uint32_t i = 0; i < TEST_VISITOR_DEEP_BLOCKS; i++)
+        TestText_Append(&source, "}\n");
+    TestText_Append(&source, "return n;\n}\n");
+
+    TestUnit unit;
+    bool parsed = TestVisitParse(&source, &unit);
+    TestText_Free(&source);
+    TEST_CHECK(parsed);
+
+    static const TestVisitPolicy policies[] = {
+        { .skipType = AST_NODE_TYPE_NONE, .stopAfter = 0 },
+        { .skipType = AST_NODE_TYPE_NONE, .stopAfter = TEST_VISITOR_DEEP_BLOCKS * 3 },
+    };
+
+    uint32_t maxDepth = 0;
+    TestVisitMatch(&unit, policies, TEST_COUNT(policies), &maxDepth);
+    TestUnit_Destroy(&unit);
+
+    TEST_CHECK(maxDepth > TEST_VISITOR_DEEP_BLOCKS && maxDepth > AST_VISITOR_SEGMENT_FRAMES);
+}
+
+/* Best of a few runs in milliseconds of `walks` walks with `passes` passes each */
+static double TestVisitTime(ASTVisitor visitor, const ASTTreeView* tree, ASTNodeId root, uint32_t walks, uint32_t passes,
+    uint32_t* counts)
+{
+    ASTVisitorPass pass;
+    memset(&pass, 0, sizeof(pass));
+    pass.enterAny = TestVisitCountAny;
+
+    ASTVisitor_ClearPasses(visitor);
+    for (uint32_t i = 0; i < passes; i++) {
+        pass.userData = &counts[i * 2];
+        ASTVisitor_AddPass(visitor, &pass);
+    }
+
+    double best = 0.0;
+    for (uint32_t run = 0; run < TEST_VISITOR_BENCH_RUNS; run++) {
+        memset(counts, 0, sizeof(uint32_t) * 2 * passes);
+
+        double start = TestNow();
+        for (uint32_t walk = 0; walk < walks; walk++)
+            ASTVisitor_Walk(visitor, tree, root);
+        double elapsed = (TestNow() - start) * 1000.0;
+
+        if (run == 0 || elapsed < best)
+            best = elapsed;
+    }
+
+    return best;
+}
+
+/* Fused passes against one walk per pass, and a plain recursion */
+static void TestVisitBenchWalk(void)
+{
+    TestText source = { 0 };
+    TestGenerateC(&source, TEST_VISITOR_BENCH_FUNCTIONS, 7);
+    TestUnit unit;
+    bool parsed = TestVisitParse(&source, &unit);
+    TestText_Free(&source);
+    TEST_CHECK(parsed);
+
+    ASTTreeView tree;
+    ASTTree_GetView(ASTParser_GetTree(unit.parser), &tree);
+    ASTNodeId root = AST_NODE_TO_ID(unit.root);
+
+    double recursive = 0.0;
+    uint32_t nodes = 0;
+    for (uint32_t run = 0; run < TEST_VISITOR_BENCH_RUNS; run++) {
+        uint32_t counts[2] = { 0, 0 };
+        double start = TestNow();
+        nodes = 0;
+        for (uint32_t i = 0; i < TEST_VISITOR_BENCH_PASSES; i++)
+            nodes += TestVisitRecursive(&tree, root, counts);
+        double elapsed = (TestNow() - start) * 1000.0;
+
+        if (run == 0 || elapsed < recursive)
+            recursive = elapsed;
+    }
+
+    uint32_t counts[TEST_VISITOR_BENCH_PASSES * 2];
+    double fused = 0.0;
+    double separate = 0.0;
+    bool same = false;
+
+    ASTVisitor visitor;
+    if (CreateASTVisitor(&visitor) == PARSER_RESULT_SUCCESS) {
+        fused = TestVisitTime(visitor, &tree, root, 1, TEST_VISITOR_BENCH_PASSES, counts);
+        same = counts[1] * TEST_VISITOR_BENCH_PASSES == nodes && counts[(TEST_VISITOR_BENCH_PASSES - 1) * 2 + 1] == counts[1];
+
+        separate = TestVisitTime(visitor, &tree, root, TEST_VISITOR_BENCH_PASSES, 1, counts);
+        same = same && counts[1] == nodes;
+
+        ASTVisitorDestroy(visitor);
+    }
+
+    TestUnit_Destroy(&unit);
+
+    double millions = (double)nodes / 1e6;
+    printf("    %u passes over %u nodes: recursion %.1f ms (%.0f M/s), separate walks %.1f ms (%.0f M/s), "
+        "fused %.1f ms (%.0f M/s)\n", TEST_VISITOR_BENCH_PASSES, nodes / TEST_VISITOR_BENCH_PASSES, recursive,
+        millions * 1e3 / recursive, separate, millions * 1e3 / separate, fused, millions * 1e3 / fused);
+
+    TEST_CHECK(same);
+}
+
+static const TestCase s_Tests[] = {
+    { "Order", TestVisitOrder },
+    { "SkipStop", TestVisitSkipStop },
+    { "Typed", TestVisitTyped },
+    { "Deep", TestVisitDeep },
+};
+
+static const TestCase s_Benchmarks[] = {
+    { "BenchWalk", TestVisitBenchWalk },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Public definitions
+// ------------------------------------------------------------------------------------------------
+
+const TestSuite g_TestSuiteParserVisitor = {
+    "ParserVisitor", s_Tests, TEST_COUNT(s_Tests), s_Benchmarks, TEST_COUNT(s_Benchmarks),
+};
+
+// ------------------------------------------------------------------------------------------------
@@ -0,0 +1,12 @@
+include "Dependencies.lua"
+
+project "LexerGen"
+	kind "ConsoleApp"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{SourceDir.LexerGen}" .. "/**.c",
+	}
@@ -0,0 +1,1314 @@
+// ------------------------------------------------------------------------------------------------
+// LexerGen
+//
+// Compiles a declarative lexer description (.lexdesc) into a C source file
+// that implements the static scanner of a LexerLanguageStrategy. The emitted
+// scanner is a direct-threaded state machine: the first byte of every token
+// selects a state through a 256 entry table and control jumps straight to
+// it, with computed goto on GCC/Clang and a switch elsewhere. Keywords and
+// operators become nested switches instead of table walks, and the scanner is
+// emitted twice, once with trivia recording and once without.
+//
+// Usage: LexerGen <input.lexdesc> <output.c>
+// ------------------------------------------------------------------------------------------------
+
+// ------------------------------------------------------------------------------------------------
+// Includes
+// ------------------------------------------------------------------------------------------------
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------------------------------
+// Private definitions
+// ------------------------------------------------------------------------------------------------
+
+#define GEN_MAX_LINE        512
+#define GEN_MAX_NAME        96
+#define GEN_MAX_TEXT        32
+#define GEN_MAX_ENTRIES     256
+#define GEN_MAX_INCLUDES    8
+#define GEN_MAX_PREFIXES    8
+#define GEN_MAX_WORDS       16
+
+// Character class bits, also emitted into the generated table
+#define GEN_CLASS_WHITESPACE    0x01
+#define GEN_CLASS_IDENT_START   0x02
+#define GEN_CLASS_IDENT_CHAR    0x04
+#define GEN_CLASS_DIGIT         0x08
+#define GEN_CLASS_HEX_DIGIT     0x10
+#define GEN_CLASS_OPERATOR      0x20
+#define GEN_CLASS_PUNCTUATION   0x40
+
+// Dispatch states, selected by the first byte of a token
+typedef enum GenState {
+    GEN_STATE_ERROR = 0,
+    GEN_STATE_WHITESPACE,
+    GEN_STATE_COMMENT,
+    GEN_STATE_STRING,
+    GEN_STATE_CHAR,
+    GEN_STATE_NUMBER,
+    GEN_STATE_DOT,
+    GEN_STATE_IDENTIFIER,
+    GEN_STATE_OPERATOR,
+
+    GEN_STATE_COUNT
+} GenState;
+
+static const char* const s_StateLabels[GEN_STATE_COUNT] = {
+    "state_error",
+    "state_whitespace",
+    "state_comment",
+    "state_string",
+    "state_char",
+    "state_number",
+    "state_dot",
+    "state_identifier",
+    "state_operator",
+};
+
+static const char* const s_StateNames[GEN_STATE_COUNT] = {
+    "GEN_STATE_ERROR",
+    "GEN_STATE_WHITESPACE",
+    "GEN_STATE_COMMENT",
+    "GEN_STATE_STRING",
+    "GEN_STATE_CHAR",
+    "GEN_STATE_NUMBER",
+    "GEN_STATE_DOT",
+    "GEN_STATE_IDENTIFIER",
+    "GEN_STATE_OPERATOR",
+};
+
+typedef struct GenKeyword {
+    char text[GEN_MAX_TEXT];
+    size_t length;
+    char value[GEN_MAX_NAME];
+} GenKeyword;
+
+typedef struct GenOperator {
+    char text[GEN_MAX_TEXT];
+    size_t length;
+    char type[GEN_MAX_NAME];    // OPERATOR_TYPE_NONE for punctuation
+    char value[GEN_MAX_NAME];
+    bool punctuation;
+} GenOperator;
+
+typedef struct GenQuoted {
+    bool enabled;
+    uint8_t quote;
+    uint8_t escape;
+} GenQuoted;
+
+typedef struct GenDescription {
+    char language[GEN_MAX_NAME];
+    char prefix[GEN_MAX_NAME];
+    char strategy[GEN_MAX_NAME];
+
+    char includes[GEN_MAX_INCLUDES][GEN_MAX_NAME];
+    uint32_t includeCount;
+
+    uint8_t classes[256];
+
+    char lineComment[GEN_MAX_TEXT];
+    uint8_t lineSplice;             // 0 when a line comment cannot be continued
+    char blockCommentStart[GEN_MAX_TEXT];
+    char blockCommentEnd[GEN_MAX_TEXT];
+
+    GenQuoted string;
+    GenQuoted character;
+    char literalPrefixes[GEN_MAX_PREFIXES][GEN_MAX_TEXT];
+    uint32_t literalPrefixCount;
+
+    bool number;
+    char exponent[GEN_MAX_TEXT];
+    char hexExponent[GEN_MAX_TEXT];
+    char hexPrefixes[GEN_MAX_PREFIXES][GEN_MAX_TEXT];
+    uint32_t hexPrefixCount;
+    bool dotStart;
+    char numberValue[GEN_MAX_NAME];     // Converter producing the literal value, optional
+
+    GenKeyword keywords[GEN_MAX_ENTRIES];
+    uint32_t keywordCount;
+
+    GenOperator operators[GEN_MAX_ENTRIES];
+    uint32_t operatorCount;
+
+    uint8_t states[256];
+} GenDescription;
+
+typedef struct GenContext {
+    const char* path;
+    uint32_t line;
+    FILE* out;
+} GenContext;
+
+static void GenFail(const GenContext* ctx, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "%s(%u): error: ", ctx->path, ctx->line);
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    exit(1);
+}
+
+static void Emit(const GenContext* ctx, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vfprintf(ctx->out, format, args);
+    va_end(args);
+}
+
+static void GenCopy(const GenContext* ctx, char* dst, size_t size, const char* src)
+{
+    if (strlen(src) >= size)
+        GenFail(ctx, "'%s' is too long", src);
+    strcpy(dst, src);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Description parsing
+// ------------------------------------------------------------------------------------------------
+
+/* Split a line into whitespace separated words, returns the word count */
+static uint32_t GenSplit(char* line, char** words)
+{
+    uint32_t count = 0;
+    char* p = line;
+
+    while (*p && count < GEN_MAX_WORDS) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+            p++;
+        if (!*p)
+            break;
+
+        words[count++] = p;
+        while (*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+            p++;
+        if (*p)
+            *p++ = '\0';
+    }
+
+    return count;
+}
+
+/* Decode a character word: a single character or one of \s \t \n \v \f \r \\ */
+static int GenDecodeChar(const char* word, size_t* used)
+{
+    if (word[0] == '\\' && word[1]) {
+        *used = 2;
+        switch (word[1]) {
+        case 's':  return ' ';
+        case 't':  return '\t';
+        case 'n':  return '\n';
+        case 'v':  return '\v';
+        case 'f':  return '\f';
+        case 'r':  return '\r';
+        case '\\': return '\\';
+        default:   return -1;
+        }
+    }
+
+    *used = 1;
+    return (uint8_t)word[0];
+}
+
+static uint8_t GenParseChar(const GenContext* ctx, const char* word)
+{
+    size_t used;
+    int c = GenDecodeChar(word, &used);
+    if (c < 0 || word[used] != '\0')
+        GenFail(ctx, "expected a single character, got '%s'", word);
+    return (uint8_t)c;
+}
+
+static void GenParseClass(const GenContext* ctx, GenDescription* desc, char** words, uint32_t count)
+{
+    uint8_t bit;
+
+    if (strcmp(words[1], "whitespace") == 0)
+        bit = GEN_CLASS_WHITESPACE;
+    else if (strcmp(words[1], "ident_start") == 0)
+        bit = GEN_CLASS_IDENT_START;
+    else if (strcmp(words[1], "ident_char") == 0)
+        bit = GEN_CLASS_IDENT_CHAR;
+    else if (strcmp(words[1], "digit") == 0)
+        bit = GEN_CLASS_DIGIT;
+    else if (strcmp(words[1], "hex_digit") == 0)
+        bit = GEN_CLASS_HEX_DIGIT;
+    else
+        GenFail(ctx, "unknown character class '%s'", words[1]);
+
+    for (uint32_t i = 2; i < count; i++) {
+        size_t used;
+        int first = GenDecodeChar(words[i], &used);
+        int last = first;
+
+        if (first >= 0 && words[i][used] == '-' && words[i][used + 1]) {
+            size_t usedLast;
+            last = GenDecodeChar(words[i] + used + 1, &usedLast);
+            used += 1 + usedLast;
+        }
+
+        if (first < 0 || last < first || words[i][used] != '\0')
+            GenFail(ctx, "bad character range '%s'", words[i]);
+
+        for (int c = first; c <= last; c++)
+            desc->classes[c] |= bit;
+    }
+}
+
+static void GenParseNumber(const GenContext* ctx, GenDescription* desc, char** words, uint32_t count)
+{
+    desc->number = true;
+
+    for (uint32_t i = 1; i < count; i++) {
+        if (strcmp(words[i], "exponent") == 0 && i + 1 < count) {
+            GenCopy(ctx, desc->exponent, sizeof(desc->exponent), words[++i]);
+        }
+        else if (strcmp(words[i], "hex_exponent") == 0 && i + 1 < count) {
+            GenCopy(ctx, desc->hexExponent, sizeof(desc->hexExponent), words[++i]);
+        }
+        else if (strcmp(words[i], "hex_prefix") == 0) {
+            // Every following word that starts with a digit is a prefix
+            while (i + 1 < count && words[i + 1][0] >= '0' && words[i + 1][0] <= '9') {
+                if (desc->hexPrefixCount == GEN_MAX_PREFIXES)
+                    GenFail(ctx, "too many hex prefixes");
+                GenCopy(ctx, desc->hexPrefixes[desc->hexPrefixCount++], GEN_MAX_TEXT, words[++i]);
+            }
+        }
+        else if (strcmp(words[i], "dot_start") == 0) {
+            desc->dotStart = true;
+        }
+        else if (strcmp(words[i], "value") == 0 && i + 1 < count) {
+            GenCopy(ctx, desc->numberValue, sizeof(desc->numberValue), words[++i]);
+        }
+        else {
+            GenFail(ctx, "unknown number option '%s'", words[i]);
+        }
+    }
+}
+
+static void GenParseDirective(const GenContext* ctx, GenDescription* desc, char** words, uint32_t count)
+{
+    const char* directive = words[0];
+
+    if (strcmp(directive, "language") == 0 && count == 2) {
+        GenCopy(ctx, desc->language, sizeof(desc->language), words[1]);
+    }
+    else if (strcmp(directive, "prefix") == 0 && count == 2) {
+        GenCopy(ctx, desc->prefix, sizeof(desc->prefix), words[1]);
+    }
+    else if (strcmp(directive, "strategy") == 0 && count == 2) {
+        GenCopy(ctx, desc->strategy, sizeof(desc->strategy), words[1]);
+    }
+    else if (strcmp(directive, "include") == 0 && count == 2) {
+        if (desc->includeCount == GEN_MAX_INCLUDES)
+            GenFail(ctx, "too many includes");
+        GenCopy(ctx, desc->includes[desc->includeCount++], GEN_MAX_NAME, words[1]);
+    }
+    else if (strcmp(directive, "class") == 0 && count >= 3) {
+        GenParseClass(ctx, desc, words, count);
+    }
+    else if (strcmp(directive, "line_comment") == 0 && (count == 2 || count == 3)) {
+        GenCopy(ctx, desc->lineComment, sizeof(desc->lineComment), words[1]);
+        desc->lineSplice = count == 3 ? GenParseChar(ctx, words[2]) : 0;
+    }
+    else if (strcmp(directive, "block_comment") == 0 && count == 3) {
+        GenCopy(ctx, desc->blockCommentStart, sizeof(desc->blockCommentStart), words[1]);
+        GenCopy(ctx, desc->blockCommentEnd, sizeof(desc->blockCommentEnd), words[2]);
+    }
+    else if ((strcmp(directive, "string") == 0 || strcmp(directive, "char") == 0) && count == 3) {
+        GenQuoted* quoted = directive[0] == 's' ? &desc->string : &desc->character;
+        quoted->enabled = true;
+        quoted->quote = GenParseChar(ctx, words[1]);
+        quoted->escape = GenParseChar(ctx, words[2]);
+    }
+    else if (strcmp(directive, "literal_prefix") == 0 && count >= 2) {
+        for (uint32_t i = 1; i < count; i++) {
+            if (desc->literalPrefixCount == GEN_MAX_PREFIXES)
+                GenFail(ctx, "too many literal prefixes");
+            GenCopy(ctx, desc->literalPrefixes[desc->literalPrefixCount++], GEN_MAX_TEXT, words[i]);
+        }
+    }
+    else if (strcmp(directive, "number") == 0) {
+        GenParseNumber(ctx, desc, words, count);
+    }
+    else if (strcmp(directive, "keyword") == 0 && count == 3) {
+        if (desc->keywordCount == GEN_MAX_ENTRIES)
+            GenFail(ctx, "too many keywords");
+
+        GenKeyword* keyword = &desc->keywords[desc->keywordCount++];
+        GenCopy(ctx, keyword->text, sizeof(keyword->text), words[1]);
+        GenCopy(ctx, keyword->value, sizeof(keyword->value), words[2]);
+        keyword->length = strlen(keyword->text);
+    }
+    else if ((strcmp(directive, "operator") == 0 && count == 4) ||
+             (strcmp(directive, "punctuation") == 0 && count == 3)) {
+        if (desc->operatorCount == GEN_MAX_ENTRIES)
+            GenFail(ctx, "too many operators");
+
+        GenOperator* op = &desc->operators[desc->operatorCount++];
+        op->punctuation = directive[0] == 'p';
+        GenCopy(ctx, op->text, sizeof(op->text), words[1]);
+        GenCopy(ctx, op->type, sizeof(op->type), op->punctuation ? "OPERATOR_TYPE_NONE" : words[2]);
+        GenCopy(ctx, op->value, sizeof(op->value), words[op->punctuation ? 2 : 3]);
+        op->length = strlen(op->text);
+    }
+    else {
+        GenFail(ctx, "unknown or malformed directive '%s'", directive);
+    }
+}
+
+static int GenCompareOperators(const void* a, const void* b)
+{
+    const GenOperator* lhs = (const GenOperator*)a;
+    const GenOperator* rhs = (const GenOperator*)b;
+
+    // Longest first so the first match is the maximal munch, stable otherwise
+    if (lhs->length != rhs->length)
+        return lhs->length > rhs->length ? -1 : 1;
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+/* Derive the operator classes and the dispatch state of every byte */
+static void GenFinish(const GenContext* ctx, GenDescription* desc)
+{
+    if (!desc->prefix[0] || !desc->strategy[0])
+        GenFail(ctx, "'prefix' and 'strategy' are required");
+
+    // qsort is not stable, sort an index-ordered copy instead
+    GenOperator* sorted = malloc(sizeof(GenOperator) * (desc->operatorCount ? desc->operatorCount : 1));
+    if (!sorted)
+        GenFail(ctx, "out of memory");
+    memcpy(sorted, desc->operators, sizeof(GenOperator) * desc->operatorCount);
+    qsort(sorted, desc->operatorCount, sizeof(GenOperator), GenCompareOperators);
+    memcpy(desc->operators, sorted, sizeof(GenOperator) * desc->operatorCount);
+    free(sorted);
+
+    // The operator classes hold single character entries, like the
+    // isOperator/isPunctuation callbacks. Any first byte starts the operator state.
+    bool startsOperator[256] = { false };
+
+    for (uint32_t i = 0; i < desc->operatorCount; i++) {
+        const GenOperator* op = &desc->operators[i];
+        uint8_t first = (uint8_t)op->text[0];
+
+        startsOperator[first] = true;
+        if (op->length == 1)
+            desc->classes[first] |= op->punctuation ? GEN_CLASS_PUNCTUATION : GEN_CLASS_OPERATOR;
+    }
+
+    // Lowest priority first, later rules override. Mirrors the order in which
+    // the callback driven core tests a byte.
+    for (int c = 255; c >= 0; c--) {
+        uint8_t cls = desc->classes[c];
+        uint8_t state = GEN_STATE_ERROR;
+
+        if (startsOperator[c])
+            state = GEN_STATE_OPERATOR;
+        if (c == '.' && desc->dotStart && state == GEN_STATE_OPERATOR)
+            state = GEN_STATE_DOT;
+        if (cls & GEN_CLASS_IDENT_START)
+            state = GEN_STATE_IDENTIFIER;
+        if (desc->number && (cls & GEN_CLASS_DIGIT))
+            state = GEN_STATE_NUMBER;
+        if (desc->character.enabled && c == desc->character.quote)
+            state = GEN_STATE_CHAR;
+        if (desc->string.enabled && c == desc->string.quote)
+            state = GEN_STATE_STRING;
+        if ((desc->lineComment[0] && c == (uint8_t)desc->lineComment[0]) ||
+            (desc->blockCommentStart[0] && c == (uint8_t)desc->blockCommentStart[0]))
+            state = GEN_STATE_COMMENT;
+        if (cls & GEN_CLASS_WHITESPACE)
+            state = GEN_STATE_WHITESPACE;
+
+        desc->states[c] = state;
+    }
+}
+
+static void GenParse(GenContext* ctx, GenDescription* desc)
+{
+    FILE* in = fopen(ctx->path, "rb");
+    if (!in)
+        GenFail(ctx, "cannot open the description");
+
+    char line[GEN_MAX_LINE];
+    char* words[GEN_MAX_WORDS];
+
+    while (fgets(line, sizeof(line), in)) {
+        ctx->line++;
+
+        uint32_t count = GenSplit(line, words);
+        if (count == 0 || words[0][0] == '#')
+            continue;
+
+        GenParseDirective(ctx, desc, words, count);
+    }
+
+    fclose(in);
+    ctx->line = 0;
+
+    GenFinish(ctx, desc);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Emission helpers
+// ------------------------------------------------------------------------------------------------
+
+/* C character literal for a byte */
+static const char* GenChar(uint8_t c)
+{
+    static char buffers[4][8];
+    static uint32_t next;
+    char* buffer = buffers[next++ & 3];
+
+    switch (c) {
+    case '\'': return "'\\''";
+    case '\\': return "'\\\\'";
+    case '\n': return "'\\n'";
+    case '\t': return "'\\t'";
+    case '\r': return "'\\r'";
+    case '\v': return "'\\v'";
+    case '\f': return "'\\f'";
+    default:
+        break;
+    }
+
+    if (c >= 0x20 && c < 0x7F)
+        snprintf(buffer, 8, "'%c'", c);
+    else
+        snprintf(buffer, 8, "0x%02X", c);
+    return buffer;
+}
+
+/* Condition matching `text` at p[offset...], the caller checks the length */
+static void GenEmitMatch(const GenContext* ctx, const char* pointer, const char* text, size_t offset)
+{
+    size_t length = strlen(text);
+
+    if (offset >= length) {
+        Emit(ctx, "1");
+        return;
+    }
+
+    for (size_t i = offset; i < length; i++)
+        Emit(ctx, "%s%s[%zu] == %s", i > offset ? " && " : "", pointer, i, GenChar((uint8_t)text[i]));
+}
+
+static void GenEmitTable(const GenContext* ctx, const char* type, const char* name, const uint8_t* values)
+{
+    Emit(ctx, "static const %s %s[256] = {\n", type, name);
+    for (int row = 0; row < 16; row++) {
+        Emit(ctx, "   ");
+        for (int col = 0; col < 16; col++)
+            Emit(ctx, " 0x%02X,", values[row * 16 + col]);
+        Emit(ctx, "\n");
+    }
+    Emit(ctx, "};\n\n");
+}
+
+// ------------------------------------------------------------------------------------------------
+// Emission
+// ------------------------------------------------------------------------------------------------
+
+static void GenEmitPrologue(const GenContext* ctx, const GenDescription* desc, const char* source)
+{
+    const char* name = strrchr(source, '/');
+    const char* backslash = strrchr(source, '\\');
+    if (backslash && (!name || backslash > name))
+        name = backslash;
+    name = name ? name + 1 : source;
+
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n");
+    Emit(ctx, "// Generated by LexerGen from %s, do not edit\n", name);
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n\n");
+
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n");
+    Emit(ctx, "// Includes\n");
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n\n");
+
+    for (uint32_t i = 0; i < desc->includeCount; i++)
+        Emit(ctx, "#include \"%s\"\n", desc->includes[i]);
+    Emit(ctx, "\n#include <string.h>\n\n");
+
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n");
+    Emit(ctx, "// Private definitions\n");
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n\n");
+
+    Emit(ctx, "#if defined(__GNUC__) || defined(__clang__)\n");
+    Emit(ctx, "#define GEN_COMPUTED_GOTO       1\n");
+    Emit(ctx, "#else\n");
+    Emit(ctx, "#define GEN_COMPUTED_GOTO       0\n");
+    Emit(ctx, "#endif\n\n");
+
+    Emit(ctx, "#define GEN_CLASS_WHITESPACE    0x%02X\n", GEN_CLASS_WHITESPACE);
+    Emit(ctx, "#define GEN_CLASS_IDENT_START   0x%02X\n", GEN_CLASS_IDENT_START);
+    Emit(ctx, "#define GEN_CLASS_IDENT_CHAR    0x%02X\n", GEN_CLASS_IDENT_CHAR);
+    Emit(ctx, "#define GEN_CLASS_DIGIT         0x%02X\n", GEN_CLASS_DIGIT);
+    Emit(ctx, "#define GEN_CLASS_HEX_DIGIT     0x%02X\n", GEN_CLASS_HEX_DIGIT);
+    Emit(ctx, "#define GEN_CLASS_OPERATOR      0x%02X\n", GEN_CLASS_OPERATOR);
+    Emit(ctx, "#define GEN_CLASS_PUNCTUATION   0x%02X\n\n", GEN_CLASS_PUNCTUATION);
+
+    GenEmitTable(ctx, "uint8_t", "s_GenClass", desc->classes);
+
+    Emit(ctx, "#define GEN_IS(c, cls)          ((s_GenClass[(uint8_t)(c)] & (cls)) != 0)\n\n");
+
+    Emit(ctx, "/* Dispatch state of the first byte of a token */\n");
+    Emit(ctx, "enum {\n");
+    for (int i = 0; i < GEN_STATE_COUNT; i++)
+        Emit(ctx, "    %s,\n", s_StateNames[i]);
+    Emit(ctx, "};\n\n");
+
+    GenEmitTable(ctx, "uint8_t", "s_GenState", desc->states);
+
+    // Operator table, only used by the classification callbacks
+    Emit(ctx, "typedef struct GenOperatorEntry {\n");
+    Emit(ctx, "    const char* text;\n");
+    Emit(ctx, "    uint8_t length;\n");
+    Emit(ctx, "    uint32_t code;\n");
+    Emit(ctx, "} GenOperatorEntry;\n\n");
+
+    Emit(ctx, "static const GenOperatorEntry s_GenOperators[] = {\n");
+    for (uint32_t i = 0; i < desc->operatorCount; i++) {
+        const GenOperator* op = &desc->operators[i];
+        Emit(ctx, "    { \"");
+        for (size_t j = 0; j < op->length; j++) {
+            char c = op->text[j];
+            Emit(ctx, (c == '"' || c == '\\') ? "\\%c" : "%c", c);
+        }
+        Emit(ctx, "\", %zu, TOKEN_OPERATOR_CODE(%s, %s) },\n", op->length, op->type, op->value);
+    }
+    Emit(ctx, "};\n\n");
+    Emit(ctx, "#define GEN_OPERATOR_COUNT      (sizeof(s_GenOperators) / sizeof(s_GenOperators[0]))\n\n");
+
+    // Line/column tracking over a multi-line range
+    Emit(ctx, "/* Advance line and column over [from, to) */\n");
+    Emit(ctx, "static inline void %sAdvance(const uint8_t* from, const uint8_t* to, ParserSize* line, ParserSize* column)\n", desc->prefix);
+    Emit(ctx, "{\n");
+    Emit(ctx, "    for (const uint8_t* p = from; p < to; p++) {\n");
+    Emit(ctx, "        if (*p == '\\n') {\n");
+    Emit(ctx, "            (*line)++;\n");
+    Emit(ctx, "            *column = 0;\n");
+    Emit(ctx, "        }\n");
+    Emit(ctx, "        else {\n");
+    Emit(ctx, "            (*column)++;\n");
+    Emit(ctx, "        }\n");
+    Emit(ctx, "    }\n");
+    Emit(ctx, "}\n\n");
+
+    Emit(ctx, "/* Put the erroneous token [start, cursor) into the scan slot and record the error */\n");
+    Emit(ctx, "static void %sError(Lexer lexer, const uint8_t* start, TokenTypeFlags flags, uint16_t kind, ParserResult result, const char* message)\n", desc->prefix);
+    Emit(ctx, "{\n");
+    Emit(ctx, "    const uint8_t* cursor = lexer->cursor.cur;\n");
+    Emit(ctx, "    lexer->cursor.cur = start;\n");
+    Emit(ctx, "    LexerBeginToken(lexer, flags, kind, 0);\n");
+    Emit(ctx, "    lexer->cursor.cur = cursor;\n");
+    Emit(ctx, "    LexerSetError(lexer, result, message);\n");
+    Emit(ctx, "}\n\n");
+}
+
+/* Keyword lookup: switch on the length, then on the first byte */
+static void GenEmitKeywords(const GenContext* ctx, const GenDescription* desc)
+{
+    size_t maxLength = 0;
+    for (uint32_t i = 0; i < desc->keywordCount; i++) {
+        if (desc->keywords[i].length > maxLength)
+            maxLength = desc->keywords[i].length;
+    }
+
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n");
+    Emit(ctx, "// Keywords\n");
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n\n");
+
+    Emit(ctx, "static inline uint32_t %sKeyword(const uint8_t* s, size_t length)\n", desc->prefix);
+    Emit(ctx, "{\n");
+    Emit(ctx, "    switch (length) {\n");
+
+    for (size_t length = 1; length <= maxLength; length++) {
+        bool any = false;
+        for (uint32_t i = 0; i < desc->keywordCount; i++)
+            any |= desc->keywords[i].length == length;
+        if (!any)
+            continue;
+
+        Emit(ctx, "    case %zu:\n", length);
+        Emit(ctx, "        switch (s[0]) {\n");
+
+        for (int first = 0; first < 256; first++) {
+            bool opened = false;
+
+            for (uint32_t i = 0; i < desc->keywordCount; i++) {
+                const GenKeyword* keyword = &desc->keywords[i];
+                if (keyword->length != length || (uint8_t)keyword->text[0] != first)
+                    continue;
+
+                if (!opened) {
+                    Emit(ctx, "        case %s:\n", GenChar((uint8_t)first));
+                    opened = true;
+                }
+
+                if (length == 1)
+                    Emit(ctx, "            return %s;\n", keyword->value);
+                else
+                    Emit(ctx, "            if (memcmp(s + 1, \"%s\", %zu) == 0) return %s;\n",
+                        keyword->text + 1, length - 1, keyword->value);
+            }
+
+            if (opened && length > 1)
+                Emit(ctx, "            break;\n");
+        }
+
+        Emit(ctx, "        }\n");
+        Emit(ctx, "        break;\n");
+    }
+
+    Emit(ctx, "    }\n\n");
+    Emit(ctx, "    return 0;\n");
+    Emit(ctx, "}\n\n");
+}
+
+static void GenEmitTrivia(const GenContext* ctx, const char* flag, const char* kind)
+{
+    Emit(ctx, "    if (lexer->%s) {\n", flag);
+    Emit(ctx, "        LexerPushTrivia(lexer, start, p, %s);\n", kind);
+    Emit(ctx, "        if (lexer->hasError)\n");
+    Emit(ctx, "            goto token_error;\n");
+    Emit(ctx, "    }\n");
+}
+
+static void GenEmitQuoted(const GenContext* ctx, const GenDescription* desc, const GenQuoted* quoted,
+    const char* state, const char* body, const char* literalKind)
+{
+    (void)desc;
+
+    Emit(ctx, "%s:\n", state);
+    Emit(ctx, "    start = p;\n");
+    Emit(ctx, "    tokenLine = line;\n");
+    Emit(ctx, "    tokenColumn = column;\n");
+    Emit(ctx, "    flags = TOKEN_TYPE_LITERAL;\n");
+    Emit(ctx, "    kind = %s;\n", literalKind);
+    Emit(ctx, "%s:\n", body);
+    Emit(ctx, "    p++;\n");
+    Emit(ctx, "    value = LEXER_STRING_NONE;\n");
+    Emit(ctx, "    for (;;) {\n");
+    Emit(ctx, "        p = LexerFindQuotedStop(p, end, %s, %s);\n", GenChar(quoted->quote), GenChar(quoted->escape));
+    Emit(ctx, "        if (p >= end || *p == '\\n')\n");
+    Emit(ctx, "            goto literal_error;\n");
+    Emit(ctx, "        if (*p == %s) {\n", GenChar(quoted->quote));
+    Emit(ctx, "            p++;\n");
+    Emit(ctx, "            if (value)\n");
+    Emit(ctx, "                %sAdvance(start, p, &line, &column);\n", desc->prefix);
+    Emit(ctx, "            else\n");
+    Emit(ctx, "                column += (ParserSize)(p - start);\n");
+    Emit(ctx, "            goto emit;\n");
+    Emit(ctx, "        }\n");
+    Emit(ctx, "        value |= LEXER_STRING_HAS_ESCAPES;\n");
+    Emit(ctx, "        p += 2;\n");
+    Emit(ctx, "    }\n\n");
+}
+
+/* Maximal munch over the operators, one case per first byte, longest candidate first */
+static void GenEmitOperators(const GenContext* ctx, const GenDescription* desc)
+{
+    Emit(ctx, "state_operator:\n");
+    Emit(ctx, "    start = p;\n");
+    Emit(ctx, "    tokenLine = line;\n");
+    Emit(ctx, "    tokenColumn = column;\n");
+    Emit(ctx, "    switch (*p) {\n");
+
+    for (int first = 0; first < 256; first++) {
+        bool opened = false;
+        bool complete = false;
+
+        for (uint32_t i = 0; i < desc->operatorCount; i++) {
+            const GenOperator* op = &desc->operators[i];
+            if ((uint8_t)op->text[0] != first)
+                continue;
+
+            if (!opened) {
+                Emit(ctx, "    case %s:\n", GenChar((uint8_t)first));
+                opened = true;
+            }
+
+            const char* flags = op->punctuation ? "TOKEN_TYPE_PUNCTUATION" : "TOKEN_TYPE_OPERATOR";
+
+            if (op->length == 1) {
+                Emit(ctx, "        GEN_OPERATOR(1, %s, %s, %s);\n", flags, op->type, op->value);
+                complete = true;
+                break;
+            }
+
+            Emit(ctx, "        if (end - p >= %zu && ", op->length);
+            GenEmitMatch(ctx, "p", op->text, 1);
+            Emit(ctx, ")\n");
+            Emit(ctx, "            GEN_OPERATOR(%zu, %s, %s, %s);\n", op->length, flags, op->type, op->value);
+        }
+
+        if (opened && !complete)
+            Emit(ctx, "        break;\n");
+    }
+
+    Emit(ctx, "    default:\n");
+    Emit(ctx, "        break;\n");
+    Emit(ctx, "    }\n");
+    Emit(ctx, "    goto state_error;\n\n");
+
+    Emit(ctx, "operator_done:\n");
+    Emit(ctx, "    column += (ParserSize)(p - start);\n");
+    Emit(ctx, "    goto emit;\n\n");
+}
+
+static void GenEmitLiteralPrefixCheck(const GenContext* ctx, const GenDescription* desc)
+{
+    Emit(ctx, "(");
+    for (uint32_t i = 0; i < desc->literalPrefixCount; i++) {
+        const char* prefix = desc->literalPrefixes[i];
+        Emit(ctx, "%s(p - start == %zu && ", i ? " ||\n         " : "", strlen(prefix));
+        GenEmitMatch(ctx, "start", prefix, 0);
+        Emit(ctx, ")");
+    }
+    Emit(ctx, ")");
+}
+
+static void GenEmitScanner(const GenContext* ctx, const GenDescription* desc, const char* name, bool preserve)
+{
+    Emit(ctx, "static bool PARSER_PTR %s(\n", name);
+    Emit(ctx, "    Lexer lexer,\n");
+    Emit(ctx, "    LexerToken token)\n");
+    Emit(ctx, "{\n");
+
+    Emit(ctx, "#if GEN_COMPUTED_GOTO\n");
+    Emit(ctx, "    static const void* const s_dispatch[] = {\n");
+    for (int i = 0; i < GEN_STATE_COUNT; i++)
+        Emit(ctx, "        &&%s,\n", s_StateLabels[i]);
+    Emit(ctx, "    };\n");
+    Emit(ctx, "#endif\n\n");
+
+    Emit(ctx, "    const uint8_t* p = lexer->cursor.cur;\n");
+    Emit(ctx, "    const uint8_t* const end = lexer->cursor.end;\n");
+    Emit(ctx, "    const uint8_t* const limit = lexer->limit;\n");
+    Emit(ctx, "    const uint8_t* start = p;\n");
+    Emit(ctx, "    ParserSize line = lexer->line;\n");
+    Emit(ctx, "    ParserSize column = lexer->column;\n");
+    Emit(ctx, "    ParserSize tokenLine = line;\n");
+    Emit(ctx, "    ParserSize tokenColumn = column;\n");
+    Emit(ctx, "    uint32_t flags = TOKEN_TYPE_EOF;\n");
+    Emit(ctx, "    uint32_t kind = 0;\n");
+    Emit(ctx, "    uint32_t value = 0;\n\n");
+
+    Emit(ctx, "    if (lexer->hasError)\n");
+    Emit(ctx, "        goto token_error;\n\n");
+
+    // Dispatch on the first byte
+    Emit(ctx, "next:\n");
+    Emit(ctx, "    if (p >= limit)\n");
+    Emit(ctx, "        goto stop;\n");
+    Emit(ctx, "    GEN_DISPATCH(*p);\n\n");
+
+    // Whitespace never crosses the chunk limit
+    Emit(ctx, "state_whitespace:\n");
+    Emit(ctx, "    start = p;\n");
+    Emit(ctx, "    do {\n");
+    Emit(ctx, "        uint8_t c = *p++;\n");
+    Emit(ctx, "        if (c == '\\n') {\n");
+    Emit(ctx, "            line++;\n");
+    Emit(ctx, "            column = 0;\n");
+    Emit(ctx, "        }\n");
+    Emit(ctx, "        else if (c == '\\t') {\n");
+    Emit(ctx, "            column += 4;\n");
+    Emit(ctx, "        }\n");
+    Emit(ctx, "        else {\n");
+    Emit(ctx, "            column++;\n");
+    Emit(ctx, "        }\n");
+    Emit(ctx, "    } while (p < limit && GEN_IS(*p, GEN_CLASS_WHITESPACE));\n");
+    if (preserve)
+        GenEmitTrivia(ctx, "preserveWhitespace", "LEXER_TRIVIA_WHITESPACE");
+    Emit(ctx, "    goto next;\n\n");
+
+    // Comments are consumed whole, even past the chunk limit
+    Emit(ctx, "state_comment:\n");
+    if (desc->lineComment[0]) {
+        Emit(ctx, "    if (end - p >= %zu && ", strlen(desc->lineComment));
+        GenEmitMatch(ctx, "p", desc->lineComment, 1);
+        Emit(ctx, ")\n");
+        Emit(ctx, "        goto line_comment;\n");
+    }
+    if (desc->blockCommentStart[0]) {
+        Emit(ctx, "    if (end - p >= %zu && ", strlen(desc->blockCommentStart));
+        GenEmitMatch(ctx, "p", desc->blockCommentStart, 1);
+        Emit(ctx, ")\n");
+        Emit(ctx, "        goto block_comment;\n");
+    }
+    Emit(ctx, "    goto state_operator;\n\n");
+
+    if (desc->lineComment[0]) {
+        Emit(ctx, "line_comment:\n");
+        Emit(ctx, "    start = p;\n");
+        Emit(ctx, "    p += %zu;\n", strlen(desc->lineComment));
+        if (desc->lineSplice) {
+            Emit(ctx, "    while (p < end && *p != '\\n') {\n");
+            Emit(ctx, "        if (*p == %s && p + 1 < end && p[1] == '\\n')\n", GenChar(desc->lineSplice));
+            Emit(ctx, "            p += 2;\n");
+            Emit(ctx, "        else\n");
+            Emit(ctx, "            p++;\n");
+            Emit(ctx, "    }\n");
+        }
+        else {
+            Emit(ctx, "    {\n");
+            Emit(ctx, "        const uint8_t* newline = memchr(p, '\\n', (size_t)(end - p));\n");
+            Emit(ctx, "        p = newline ? newline : end;\n");
+            Emit(ctx, "    }\n");
+        }
+        Emit(ctx, "    %sAdvance(start, p, &line, &column);\n", desc->prefix);
+        if (preserve)
+            GenEmitTrivia(ctx, "preserveComments", "LEXER_TRIVIA_LINE_COMMENT");
+        Emit(ctx, "    goto next;\n\n");
+    }
+
+    if (desc->blockCommentStart[0]) {
+        const char* close = desc->blockCommentEnd;
+        size_t closeLength = strlen(close);
+
+        Emit(ctx, "block_comment:\n");
+        Emit(ctx, "    start = p;\n");
+        Emit(ctx, "    p += %zu;\n", strlen(desc->blockCommentStart));
+        Emit(ctx, "    for (;;) {\n");
+        Emit(ctx, "        const uint8_t* close = end - p >= %zu ? memchr(p, %s, (size_t)(end - p - %zu)) : NULL;\n",
+            closeLength, GenChar((uint8_t)close[0]), closeLength - 1);
+        Emit(ctx, "        if (!close) {\n");
+        Emit(ctx, "            p = end;\n");
+        Emit(ctx, "            goto comment_error;\n");
+        Emit(ctx, "        }\n");
+        if (closeLength > 1) {
+            Emit(ctx, "        if (");
+            GenEmitMatch(ctx, "close", close, 1);
+            Emit(ctx, ") {\n");
+        }
+        else {
+            Emit(ctx, "        {\n");
+        }
+        Emit(ctx, "            p = close + %zu;\n", closeLength);
+        Emit(ctx, "            break;\n");
+        Emit(ctx, "        }\n");
+        Emit(ctx, "        p = close + 1;\n");
+        Emit(ctx, "    }\n");
+        Emit(ctx, "    %sAdvance(start, p, &line, &column);\n", desc->prefix);
+        if (preserve)
+            GenEmitTrivia(ctx, "preserveComments", "LEXER_TRIVIA_BLOCK_COMMENT");
+        Emit(ctx, "    goto next;\n\n");
+
+        Emit(ctx, "comment_error:\n");
+        Emit(ctx, "    %sAdvance(start, p, &line, &column);\n", desc->prefix);
+        if (preserve)
+            GenEmitTrivia(ctx, "preserveComments", "LEXER_TRIVIA_BLOCK_COMMENT");
+        Emit(ctx, "    GEN_SYNC();\n");
+        Emit(ctx, "    %sError(lexer, start, TOKEN_TYPE_COMMENT, 0, PARSER_ERROR_UNTERMINATED_COMMENT, \"Unterminated comment\");\n", desc->prefix);
+        Emit(ctx, "    goto token_error;\n\n");
+    }
+
+    // Quoted literals
+    if (desc->string.enabled)
+        GenEmitQuoted(ctx, desc, &desc->string, "state_string", "string_body", "LITERAL_TYPE_STRING");
+    else
+        Emit(ctx, "state_string:\n    goto state_error;\n\n");
+
+    if (desc->character.enabled)
+        GenEmitQuoted(ctx, desc, &desc->character, "state_char", "char_body", "LITERAL_TYPE_CHAR");
+    else
+        Emit(ctx, "state_char:\n    goto state_error;\n\n");
+
+    if (desc->string.enabled || desc->character.enabled) {
+        Emit(ctx, "literal_error:\n");
+        Emit(ctx, "    if (p > end)\n");
+        Emit(ctx, "        p = end;\n");
+        Emit(ctx, "    %sAdvance(start, p, &line, &column);\n", desc->prefix);
+        Emit(ctx, "    GEN_SYNC();\n");
+        Emit(ctx, "    %sError(lexer, start, TOKEN_TYPE_LITERAL, (uint16_t)kind, PARSER_ERROR_UNTERMINATED_STRING, \"Unterminated literal\");\n", desc->prefix);
+        Emit(ctx, "    goto token_failed;\n\n");
+    }
+
+    // Numbers
+    Emit(ctx, "state_dot:\n");
+    if (desc->number && desc->dotStart) {
+        Emit(ctx, "    if (end - p >= 2 && GEN_IS(p[1], GEN_CLASS_DIGIT))\n");
+        Emit(ctx, "        goto state_number;\n");
+    }
+    Emit(ctx, "    goto state_operator;\n\n");
+
+    Emit(ctx, "state_number:\n");
+    if (desc->number) {
+        Emit(ctx, "    start = p;\n");
+        Emit(ctx, "    tokenLine = line;\n");
+        Emit(ctx, "    tokenColumn = column;\n");
+        Emit(ctx, "    flags = TOKEN_TYPE_LITERAL;\n");
+        Emit(ctx, "    kind = LITERAL_TYPE_INTEGER;\n");
+        Emit(ctx, "    value = 0;\n");
+        Emit(ctx, "    {\n");
+        Emit(ctx, "        bool hex = ");
+        if (desc->hexPrefixCount == 0)
+            Emit(ctx, "false");
+        for (uint32_t i = 0; i < desc->hexPrefixCount; i++) {
+            const char* prefix = desc->hexPrefixes[i];
+            Emit(ctx, "%s(end - p >= %zu && ", i ? " || " : "", strlen(prefix));
+            GenEmitMatch(ctx, "p", prefix, 0);
+            Emit(ctx, ")");
+        }
+        Emit(ctx, ";\n");
+        Emit(ctx, "        while (p < end) {\n");
+        Emit(ctx, "            uint8_t c = *p;\n");
+        Emit(ctx, "            if (c == '.') {\n");
+        Emit(ctx, "                kind = LITERAL_TYPE_FLOAT;\n");
+        Emit(ctx, "                p++;\n");
+        Emit(ctx, "            }\n");
+        Emit(ctx, "            else if (");
+        Emit(ctx, "(!hex && (0");
+        for (const char* e = desc->exponent; *e; e++)
+            Emit(ctx, " || c == %s", GenChar((uint8_t)*e));
+        Emit(ctx, ")) || (hex && (0");
+        for (const char* e = desc->hexExponent; *e; e++)
+            Emit(ctx, " || c == %s", GenChar((uint8_t)*e));
+        Emit(ctx, "))) {\n");
+        Emit(ctx, "                kind = LITERAL_TYPE_FLOAT;\n");
+        Emit(ctx, "                p++;\n");
+        Emit(ctx, "                if (p < end && (*p == '+' || *p == '-'))\n");
+        Emit(ctx, "                    p++;\n");
+        Emit(ctx, "            }\n");
+        Emit(ctx, "            else if (GEN_IS(c, GEN_CLASS_IDENT_CHAR)) {\n");
+        Emit(ctx, "                p++;\n");
+        Emit(ctx, "            }\n");
+        Emit(ctx, "            else {\n");
+        Emit(ctx, "                break;\n");
+        Emit(ctx, "            }\n");
+        Emit(ctx, "        }\n");
+        Emit(ctx, "    }\n");
+        Emit(ctx, "    column += (ParserSize)(p - start);\n");
+        if (desc->numberValue[0]) {
+            // Convert in the same pass and store the value in the literal table
+            Emit(ctx, "    {\n");
+            Emit(ctx, "        LexerLiteral literal;\n");
+            Emit(ctx, "        memset(&literal, 0, sizeof(literal));\n");
+            Emit(ctx, "        ParserResult result = %s((const char*)start, (size_t)(p - start), &literal);\n", desc->numberValue);
+            Emit(ctx, "        if (result == PARSER_RESULT_SUCCESS)\n");
+            Emit(ctx, "            result = LexerPushLiteral(lexer, &literal, &value);\n");
+            Emit(ctx, "        if (result != PARSER_RESULT_SUCCESS) {\n");
+            Emit(ctx, "            GEN_SYNC();\n");
+            Emit(ctx, "            %sError(lexer, start, TOKEN_TYPE_LITERAL, (uint16_t)kind, result, LexerLiteralErrorMessage(result));\n", desc->prefix);
+            Emit(ctx, "            goto token_failed;\n");
+            Emit(ctx, "        }\n");
+            Emit(ctx, "        kind = literal.type;\n");
+            Emit(ctx, "    }\n");
+        }
+        Emit(ctx, "    goto emit;\n\n");
+    }
+    else {
+        Emit(ctx, "    goto state_error;\n\n");
+    }
+
+    // Identifiers, keywords and prefixed literals
+    Emit(ctx, "state_identifier:\n");
+    Emit(ctx, "    start = p;\n");
+    Emit(ctx, "    tokenLine = line;\n");
+    Emit(ctx, "    tokenColumn = column;\n");
+    Emit(ctx, "    p++;\n");
+    Emit(ctx, "    while (p < end && GEN_IS(*p, GEN_CLASS_IDENT_CHAR))\n");
+    Emit(ctx, "        p++;\n");
+    if (desc->literalPrefixCount > 0 && (desc->string.enabled || desc->character.enabled)) {
+        Emit(ctx, "    if (p < end && ");
+        GenEmitLiteralPrefixCheck(ctx, desc);
+        Emit(ctx, ") {\n");
+        Emit(ctx, "        flags = TOKEN_TYPE_LITERAL;\n");
+        if (desc->string.enabled) {
+            Emit(ctx, "        if (*p == %s) {\n", GenChar(desc->string.quote));
+            Emit(ctx, "            kind = LITERAL_TYPE_STRING;\n");
+            Emit(ctx, "            goto string_body;\n");
+            Emit(ctx, "        }\n");
+        }
+        if (desc->character.enabled) {
+            Emit(ctx, "        if (*p == %s) {\n", GenChar(desc->character.quote));
+            Emit(ctx, "            kind = LITERAL_TYPE_CHAR;\n");
+            Emit(ctx, "            goto char_body;\n");
+            Emit(ctx, "        }\n");
+        }
+        Emit(ctx, "    }\n");
+    }
+    Emit(ctx, "    value = %sKeyword(start, (size_t)(p - start));\n", desc->prefix);
+    Emit(ctx, "    flags = value ? TOKEN_TYPE_KEYWORD : TOKEN_TYPE_IDENTIFIER;\n");
+    Emit(ctx, "    kind = 0;\n");
+    Emit(ctx, "    column += (ParserSize)(p - start);\n");
+    Emit(ctx, "    goto emit;\n\n");
+
+    GenEmitOperators(ctx, desc);
+
+    // Unexpected byte
+    Emit(ctx, "state_error:\n");
+    Emit(ctx, "    start = p;\n");
+    Emit(ctx, "    tokenLine = line;\n");
+    Emit(ctx, "    tokenColumn = column;\n");
+    Emit(ctx, "    p++;\n");
+    Emit(ctx, "    column++;\n");
+    Emit(ctx, "    GEN_SYNC();\n");
+    Emit(ctx, "    %sError(lexer, start, TOKEN_TYPE_ERROR, 0, PARSER_ERROR_UNEXPECTED_TOKEN, \"Unexpected character\");\n", desc->prefix);
+    Emit(ctx, "    goto token_failed;\n\n");
+
+    // End of file or end of chunk
+    Emit(ctx, "stop:\n");
+    Emit(ctx, "    if (p < end) {\n");
+    Emit(ctx, "        GEN_SYNC();\n");
+    Emit(ctx, "        return false;\n");
+    Emit(ctx, "    }\n");
+    Emit(ctx, "    start = p;\n");
+    Emit(ctx, "    tokenLine = line;\n");
+    Emit(ctx, "    tokenColumn = column;\n");
+    Emit(ctx, "    flags = TOKEN_TYPE_EOF;\n");
+    Emit(ctx, "    kind = 0;\n");
+    Emit(ctx, "    value = 0;\n\n");
+
+    Emit(ctx, "emit:\n");
+    Emit(ctx, "    token->lexeme = (const char*)start;\n");
+    Emit(ctx, "    token->length = (uint32_t)(p - start);\n");
+    Emit(ctx, "    token->flags = (uint16_t)flags;\n");
+    Emit(ctx, "    token->kind = (uint16_t)kind;\n");
+    Emit(ctx, "    token->value = value;\n");
+    Emit(ctx, "    token->line = (uint32_t)tokenLine;\n");
+    Emit(ctx, "    token->column = (uint32_t)tokenColumn;\n");
+    Emit(ctx, "    GEN_SYNC();\n");
+    Emit(ctx, "    lexer->scanIndex++;\n");
+    Emit(ctx, "    return true;\n\n");
+
+    // Errors, the erroneous token is in the scan slot
+    Emit(ctx, "token_error:\n");
+    Emit(ctx, "    tokenLine = lexer->line = line;\n");
+    Emit(ctx, "    tokenColumn = lexer->column = column;\n");
+    Emit(ctx, "token_failed:\n");
+    Emit(ctx, "    *token = lexer->scanToken;\n");
+    Emit(ctx, "    token->line = (uint32_t)tokenLine;\n");
+    Emit(ctx, "    token->column = (uint32_t)tokenColumn;\n");
+    Emit(ctx, "    lexer->scanIndex++;\n");
+    Emit(ctx, "    return true;\n");
+    Emit(ctx, "}\n\n");
+}
+
+static void GenEmitScanners(const GenContext* ctx, const GenDescription* desc)
+{
+    char name[GEN_MAX_NAME + 32];
+
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n");
+    Emit(ctx, "// Scanner\n");
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n\n");
+
+    Emit(ctx, "#if GEN_COMPUTED_GOTO\n");
+    Emit(ctx, "#define GEN_DISPATCH(c)         goto *s_dispatch[s_GenState[(c)]]\n");
+    Emit(ctx, "#else\n");
+    Emit(ctx, "#define GEN_DISPATCH(c)                                 \\\n");
+    Emit(ctx, "    switch (s_GenState[(c)]) {                          \\\n");
+    for (int i = 1; i < GEN_STATE_COUNT; i++) {
+        char label[GEN_MAX_NAME];
+        snprintf(label, sizeof(label), "%s:", s_StateNames[i]);
+        Emit(ctx, "    case %-23s goto %s; %*s\\\n", label, s_StateLabels[i], (int)(16 - strlen(s_StateLabels[i])), "");
+    }
+    Emit(ctx, "    %-28s goto %s; %*s\\\n", "default:", "state_error", (int)(16 - strlen("state_error")), "");
+    Emit(ctx, "    }\n");
+    Emit(ctx, "#endif\n\n");
+
+    Emit(ctx, "#define GEN_SYNC()                      \\\n");
+    Emit(ctx, "    do {                                \\\n");
+    Emit(ctx, "        lexer->cursor.cur = p;          \\\n");
+    Emit(ctx, "        lexer->line = line;             \\\n");
+    Emit(ctx, "        lexer->column = column;         \\\n");
+    Emit(ctx, "    } while (0)\n\n");
+
+    Emit(ctx, "#define GEN_OPERATOR(n, f, k, v)        \\\n");
+    Emit(ctx, "    do {                                \\\n");
+    Emit(ctx, "        p += (n);                       \\\n");
+    Emit(ctx, "        flags = (f);                    \\\n");
+    Emit(ctx, "        kind = (k);                     \\\n");
+    Emit(ctx, "        value = (v);                    \\\n");
+    Emit(ctx, "        goto operator_done;             \\\n");
+    Emit(ctx, "    } while (0)\n\n");
+
+    snprintf(name, sizeof(name), "%sScanToken", desc->prefix);
+    GenEmitScanner(ctx, desc, name, false);
+
+    snprintf(name, sizeof(name), "%sScanTokenTrivia", desc->prefix);
+    GenEmitScanner(ctx, desc, name, true);
+
+    Emit(ctx, "#undef GEN_OPERATOR\n");
+    Emit(ctx, "#undef GEN_SYNC\n");
+    Emit(ctx, "#undef GEN_DISPATCH\n\n");
+}
+
+static void GenEmitComparison(const GenContext* ctx, const char* text, const char* var)
+{
+    Emit(ctx, "length >= %zu && ", strlen(text));
+    GenEmitMatch(ctx, var, text, 0);
+}
+
+static void GenEmitClassification(const GenContext* ctx, const GenDescription* desc)
+{
+    const char* pre = desc->prefix;
+
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n");
+    Emit(ctx, "// Character classification\n");
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n\n");
+
+    Emit(ctx, "static bool PARSER_PTR %sIsIdentifierStart(uint8_t c)\n{\n    return GEN_IS(c, GEN_CLASS_IDENT_START);\n}\n\n", pre);
+    Emit(ctx, "static bool PARSER_PTR %sIsIdentifierChar(uint8_t c)\n{\n    return GEN_IS(c, GEN_CLASS_IDENT_CHAR);\n}\n\n", pre);
+    Emit(ctx, "static bool PARSER_PTR %sIsKeyword(const char* lexeme)\n{\n    return %sKeyword((const uint8_t*)lexeme, strlen(lexeme)) != 0;\n}\n\n", pre, pre);
+    Emit(ctx, "static bool PARSER_PTR %sIsWhitespace(uint8_t c)\n{\n    return GEN_IS(c, GEN_CLASS_WHITESPACE);\n}\n\n", pre);
+
+    Emit(ctx, "static bool PARSER_PTR %sIsLineComment(const char* text, size_t length)\n{\n    return ", pre);
+    if (desc->lineComment[0])
+        GenEmitComparison(ctx, desc->lineComment, "text");
+    else
+        Emit(ctx, "(void)text, (void)length, false");
+    Emit(ctx, ";\n}\n\n");
+
+    Emit(ctx, "static bool PARSER_PTR %sIsBlockComment(const char* text, size_t length)\n{\n    return ", pre);
+    if (desc->blockCommentStart[0])
+        GenEmitComparison(ctx, desc->blockCommentStart, "text");
+    else
+        Emit(ctx, "(void)text, (void)length, false");
+    Emit(ctx, ";\n}\n\n");
+
+    Emit(ctx, "static bool PARSER_PTR %sIsStringStart(uint8_t c)\n{\n    return ", pre);
+    if (desc->string.enabled)
+        Emit(ctx, "c == %s", GenChar(desc->string.quote));
+    else
+        Emit(ctx, "(void)c, false");
+    Emit(ctx, ";\n}\n\n");
+
+    Emit(ctx, "static bool PARSER_PTR %sIsCharStart(uint8_t c)\n{\n    return ", pre);
+    if (desc->character.enabled)
+        Emit(ctx, "c == %s", GenChar(desc->character.quote));
+    else
+        Emit(ctx, "(void)c, false");
+    Emit(ctx, ";\n}\n\n");
+
+    Emit(ctx, "static bool PARSER_PTR %sIsNumberStart(uint8_t c)\n{\n    return GEN_IS(c, GEN_CLASS_DIGIT);\n}\n\n", pre);
+
+    Emit(ctx, "static bool PARSER_PTR %sIsNumberChar(uint8_t c, int base)\n", pre);
+    Emit(ctx, "{\n");
+    Emit(ctx, "    switch (base) {\n");
+    Emit(ctx, "    case 2:  return c == '0' || c == '1';\n");
+    Emit(ctx, "    case 8:  return c >= '0' && c <= '7';\n");
+    Emit(ctx, "    case 16: return GEN_IS(c, GEN_CLASS_HEX_DIGIT);\n");
+    Emit(ctx, "    default: return GEN_IS(c, GEN_CLASS_DIGIT);\n");
+    Emit(ctx, "    }\n");
+    Emit(ctx, "}\n\n");
+
+    Emit(ctx, "static bool PARSER_PTR %sIsPunctuation(uint8_t c)\n{\n    return GEN_IS(c, GEN_CLASS_PUNCTUATION);\n}\n\n", pre);
+
+    Emit(ctx, "static bool PARSER_PTR %sIsOperator(const char* lexeme, size_t length)\n", pre);
+    Emit(ctx, "{\n");
+    Emit(ctx, "    if (length == 1)\n");
+    Emit(ctx, "        return GEN_IS(lexeme[0], GEN_CLASS_OPERATOR);\n\n");
+    Emit(ctx, "    for (size_t i = 0; i < GEN_OPERATOR_COUNT; i++) {\n");
+    Emit(ctx, "        const GenOperatorEntry* entry = &s_GenOperators[i];\n");
+    Emit(ctx, "        if (entry->length == length && TOKEN_OPERATOR_CODE_TYPE(entry->code) != OPERATOR_TYPE_NONE &&\n");
+    Emit(ctx, "            memcmp(entry->text, lexeme, length) == 0)\n");
+    Emit(ctx, "            return true;\n");
+    Emit(ctx, "    }\n\n");
+    Emit(ctx, "    return false;\n");
+    Emit(ctx, "}\n\n");
+
+    Emit(ctx, "static uint32_t PARSER_PTR %sGetOperatorType(const char* lexeme, size_t length)\n", pre);
+    Emit(ctx, "{\n");
+    Emit(ctx, "    for (size_t i = 0; i < GEN_OPERATOR_COUNT; i++) {\n");
+    Emit(ctx, "        const GenOperatorEntry* entry = &s_GenOperators[i];\n");
+    Emit(ctx, "        if (entry->length == length && memcmp(entry->text, lexeme, length) == 0)\n");
+    Emit(ctx, "            return entry->code;\n");
+    Emit(ctx, "    }\n\n");
+    Emit(ctx, "    return TOKEN_OPERATOR_CODE(OPERATOR_TYPE_NONE, PUNCTUATION_NONE);\n");
+    Emit(ctx, "}\n\n");
+}
+
+static void GenEmitStrategy(const GenContext* ctx, const GenDescription* desc)
+{
+    const char* pre = desc->prefix;
+
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n");
+    Emit(ctx, "// Strategy\n");
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n\n");
+
+    Emit(ctx, "const LexerLanguageStrategy %s = {\n", desc->strategy);
+    Emit(ctx, "    .languageName = \"%s\",\n\n", desc->language);
+    Emit(ctx, "    .isIdentifierStart = %sIsIdentifierStart,\n", pre);
+    Emit(ctx, "    .isIdentifierChar = %sIsIdentifierChar,\n\n", pre);
+    Emit(ctx, "    .isKeyword = %sIsKeyword,\n\n", pre);
+    Emit(ctx, "    .isWhitespace = %sIsWhitespace,\n\n", pre);
+    Emit(ctx, "    .isLineComment = %sIsLineComment,\n", pre);
+    Emit(ctx, "    .isBlockComment = %sIsBlockComment,\n\n", pre);
+    Emit(ctx, "    .isStringStart = %sIsStringStart,\n", pre);
+    Emit(ctx, "    .isCharStart = %sIsCharStart,\n", pre);
+    Emit(ctx, "    .isNumberStart = %sIsNumberStart,\n", pre);
+    Emit(ctx, "    .isNumberChar = %sIsNumberChar,\n\n", pre);
+    Emit(ctx, "    .isPunctuation = %sIsPunctuation,\n", pre);
+    Emit(ctx, "    .isOperator = %sIsOperator,\n", pre);
+    Emit(ctx, "    .getOperatorType = %sGetOperatorType,\n\n", pre);
+    Emit(ctx, "    .scanToken = %sScanToken,\n", pre);
+    Emit(ctx, "    .scanTokenTrivia = %sScanTokenTrivia,\n\n", pre);
+    Emit(ctx, "    .userData = NULL,\n");
+    Emit(ctx, "};\n\n");
+
+    Emit(ctx, "// ------------------------------------------------------------------------------------------------\n");
+}
+
+// ------------------------------------------------------------------------------------------------
+// Entry point
+// ------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        fprintf(stderr, "usage: LexerGen <input.lexdesc> <output.c>\n");
+        return 2;
+    }
+
+    GenContext ctx = { argv[1], 0, NULL };
+
+    GenDescription* desc = calloc(1, sizeof(GenDescription));
+    if (!desc)
+        GenFail(&ctx, "out of memory");
+
+    GenParse(&ctx, desc);
+
+    // Write to a temporary file first so a failed run never leaves a
+    // truncated source behind
+    char temporary[1024];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", argv[2]);
+
+    ctx.out = fopen(temporary, "wb");
+    if (!ctx.out) {
+        fprintf(stderr, "%s: error: cannot write\n", temporary);
+        return 1;
+    }
+
+    GenEmitPrologue(&ctx, desc, argv[1]);
+    GenEmitKeywords(&ctx, desc);
+    GenEmitScanners(&ctx, desc);
+    GenEmitClassification(&ctx, desc);
+    GenEmitStrategy(&ctx, desc);
+
+    if (fclose(ctx.out) != 0) {
+        fprintf(stderr, "%s: error: cannot write\n", temporary);
+        return 1;
+    }
+
+    remove(argv[2]);
+    if (rename(temporary, argv[2]) != 0) {
+        fprintf(stderr, "%s: error: cannot replace\n", argv[2]);
+        return 1;
+    }
+
+    free(desc);
+    return 0;
+}
+
+// ------------------------------------------------------------------------------------------------
@@ -39,6 +39,11 @@ workspace "Compile Driver"
 			"PLATFORM_LINUX"
 		}
 
+		links
+		{
+			"pthread"
+		}
+
 	filter "system:macos"
 		systemversion "latest"
 		defines
@@ -56,6 +61,10 @@ workspace "Compile Driver"
 			"ML_ENABLE_PROFILING",
 			"ML_ENABLE_TRACING",
 			"ML_DEFAULT_LOG_LEVEL = ML_LOG_LEVEL_DEBUG",
+
+			-- Route PARSER_MALLOC through g_parser_allocator_callbacks so the
+			-- heap counters and an installed arena see every parser allocation
+			"PARSER_DEBUG_ALLOCATORS",
 		}
 
 
@@ -69,6 +78,12 @@ workspace "Compile Driver"
 
 outputdir = "%{wks.location}/bin/%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
+group "Tools"
+	include "Tools/LexerGen"
+
 group "Core"
 	include "Compiler"
+
+group "Tests"
+	include "Tests"
 group ""
\ No newline at end of file